@@ -6,6 +6,7 @@
 package com.doodlelabs.meshriderwave.ptt
 
 import android.content.Context
+import android.media.AudioDeviceInfo
 import android.media.AudioManager
 import androidx.test.core.app.ApplicationProvider
 import androidx.test.ext.junit.runners.AndroidJUnit4
@@ -246,6 +247,451 @@ class PttInstrumentedTest {
         assertTrue("Latency should be >= 0", latency >= 0)
     }
 
+    @Test
+    fun testNetworkImpairmentControls() {
+        // Impairment needs a packetizer
+        assertFalse("Impairment should fail before initialize",
+            audioEngine.setNetworkImpairment(
+                PttNetworkImpairment.Direction.RECEIVE, PttNetworkImpairment.BURSTY_EDGE))
+
+        audioEngine.initialize("239.255.0.1", 15004, true)
+
+        val profile = PttNetworkImpairment.BURSTY_EDGE.copy(seed = 1234)
+        assertTrue("RX impairment should apply",
+            audioEngine.setNetworkImpairment(PttNetworkImpairment.Direction.RECEIVE, profile))
+        assertTrue("TX impairment should apply",
+            audioEngine.setNetworkImpairment(PttNetworkImpairment.Direction.TRANSMIT,
+                PttNetworkImpairment(lossPercent = 5f)))
+
+        // Counters start from zero for a fresh profile
+        val stats = audioEngine.getImpairmentStats(PttNetworkImpairment.Direction.RECEIVE)
+        assertNotNull("Impairment stats should be available", stats)
+        assertEquals(0L, stats!!.packets)
+
+        // Unreadable trace is rejected
+        assertFalse("Missing trace should be rejected",
+            audioEngine.setNetworkImpairment(PttNetworkImpairment.Direction.RECEIVE,
+                PttNetworkImpairment(tracePath = "/nonexistent/trace.txt")))
+
+        // Clearing always succeeds once initialized
+        assertTrue(audioEngine.setNetworkImpairment(PttNetworkImpairment.Direction.RECEIVE, null))
+        assertTrue(audioEngine.setNetworkImpairment(PttNetworkImpairment.Direction.TRANSMIT, null))
+    }
+
+    @Test
+    fun testScanChannels() {
+        assertFalse("Join should fail before initialize",
+            audioEngine.joinChannel(1, "239.255.0.2", 15004))
+
+        audioEngine.initialize("239.255.0.1", 15004, true)
+
+        assertTrue(audioEngine.joinChannel(1, "239.255.0.2", 15004, priority = 5))
+        assertTrue(audioEngine.joinChannel(2, "239.255.0.3", 15006))
+        assertFalse("Duplicate channel id should be rejected",
+            audioEngine.joinChannel(1, "239.255.0.4", 15004))
+        assertFalse("Home channel id is reserved",
+            audioEngine.joinChannel(PttAudioEngine.HOME_CHANNEL, "239.255.0.4", 15004))
+        assertFalse("Unicast address is not a scan group",
+            audioEngine.joinChannel(3, "10.0.0.1", 15004))
+
+        audioEngine.setChannelPriority(PttAudioEngine.HOME_CHANNEL, 3)
+        audioEngine.setDuckingGain(0f)
+        assertTrue("No talkers yet", audioEngine.getActiveChannels().isEmpty())
+
+        assertTrue(audioEngine.leaveChannel(1))
+        assertFalse("Channel already left", audioEngine.leaveChannel(1))
+
+        // Freed id can be joined again without rebuilding the engine
+        assertTrue(audioEngine.joinChannel(1, "239.255.0.2", 15004))
+    }
+
+    @Test
+    fun testTransmitDtx() {
+        audioEngine.initialize("239.255.0.1", 15004, true)
+
+        audioEngine.setTransmitDtx(true, hangoverMs = 400, comfortNoiseIntervalMs = 200)
+        audioEngine.setTransmitDtx(false)
+
+        val telemetry = audioEngine.getTelemetry()
+        assertNotNull(telemetry)
+        assertEquals("Nothing suppressed before capture", 0L, telemetry!!.framesSuppressed)
+        assertEquals(0.0, telemetry.airtimeSavedFraction, 0.0)
+    }
+
+    @Test
+    fun testWarmKeyUp() {
+        assertTrue(audioEngine.initialize("239.255.0.1", 15004, true))
+        audioEngine.setWarmStandby(true)
+
+        // Repeated presses reuse the open stream (used to need a re-initialize)
+        repeat(3) {
+            assertTrue("Key-up ${it + 1} should start capture", audioEngine.startCapture())
+            Thread.sleep(200)
+            audioEngine.stopCapture()
+        }
+
+        // Same network: engine and socket are kept
+        assertTrue(audioEngine.initialize("239.255.0.1", 15004, true))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(200)
+        audioEngine.stopCapture()
+        audioEngine.setWarmStandby(false)
+
+        val telemetry = audioEngine.getTelemetry()
+        assertNotNull(telemetry)
+        assertEquals(4L, telemetry!!.keyUps)
+        assertTrue("TTFF should be recorded", telemetry.lastTtffMicros > 0)
+        assertTrue(telemetry.maxTtffMicros >= telemetry.meanTtffMicros)
+    }
+
+    @Test
+    fun testRtcpLinkQuality() {
+        // Short interval so reports go out within the test
+        audioEngine.setRtcp(minIntervalMs = 200, sessionBandwidthBps = 1_000_000)
+        assertTrue(audioEngine.initialize("239.255.0.1", 15006, true))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(1500)
+        audioEngine.stopCapture()
+
+        val telemetry = audioEngine.getTelemetry()
+        assertNotNull(telemetry)
+        assertTrue("RTCP reports should be sent", telemetry!!.rtcpReportsSent > 0)
+        assertEquals(0L, telemetry.rtcpMalformed)
+
+        // Our own reports loop back and must not list this radio as a peer
+        val links = audioEngine.getLinkQuality()
+        assertTrue(links.all { it.fractionLost in 0f..1f && it.ageMs >= 0 })
+
+        audioEngine.setRtcp(mode = PttLinkQuality.RtcpMode.MUX, minIntervalMs = 200)
+        Thread.sleep(500)
+        audioEngine.setRtcp()
+    }
+
+    @Test
+    fun testAudioDsp() {
+        assertFalse("No engine yet", audioEngine.setAudioDsp(PttAudioDsp.Direction.CAPTURE, PttAudioDsp()))
+        assertTrue(audioEngine.initialize("239.255.0.1", 15004, true))
+        assertTrue(audioEngine.setAudioDsp(PttAudioDsp.Direction.CAPTURE, PttAudioDsp(agcMaxGainDb = 12f)))
+        assertTrue(audioEngine.setAudioDsp(PttAudioDsp.Direction.PLAYBACK, PttAudioDsp.PLAYBACK_DEFAULT))
+
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(500)
+        audioEngine.stopCapture()
+
+        val telemetry = audioEngine.getTelemetry()
+        assertNotNull(telemetry)
+        assertTrue("AGC gain reported once frames were encoded", telemetry!!.captureGainPercent > 0)
+        assertTrue("Gain bounded by agcMaxGainDb", telemetry.captureGainPercent <= 400)
+        assertTrue(telemetry.captureDeviceRate in listOf(16000L, 48000L))
+        assertTrue(telemetry.playbackDeviceRate in listOf(16000L, 48000L))
+    }
+
+    @Test
+    fun testSrtpProtection() {
+        val key = ByteArray(16) { it.toByte() }
+        val salt = ByteArray(12) { (0xA0 + it).toByte() }
+        assertFalse("Salt must be 12 bytes", audioEngine.setSrtpKey(1, key, ByteArray(14)))
+        assertTrue("Key installs before initialize()", audioEngine.setSrtpKey(3, key, salt))
+        assertFalse("Same epoch refused", audioEngine.setSrtpKey(3, key, salt))
+        assertFalse("Older epoch refused", audioEngine.setSrtpKey(2, key, salt))
+
+        assertTrue(audioEngine.initialize("239.255.0.1", 15005, true))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(500)
+        audioEngine.stopCapture()
+
+        val protectedRun = audioEngine.getTelemetry()
+        assertNotNull(protectedRun)
+        assertEquals(3L, protectedRun!!.srtpKeyEpoch)
+        assertTrue("Every packet sent was protected",
+            protectedRun.srtpPacketsProtected >= protectedRun.packetsSent)
+        assertEquals("Own loopback never reaches the verifier", 0L, protectedRun.srtpAuthFailures)
+
+        audioEngine.clearSrtp()
+        assertEquals(0L, audioEngine.getTelemetry()!!.srtpKeyEpoch)
+        assertTrue("Any epoch accepted after clear", audioEngine.setSrtpKey(1, key, salt))
+        audioEngine.clearSrtp()
+    }
+
+    @Test
+    fun testNativeFloorControl() {
+        assertNull("No engine yet", audioEngine.requestFloor())
+        audioEngine.setNativeFloorControl(true)
+        assertTrue(audioEngine.initialize("239.255.0.1", 15006, true))
+
+        // Alone on the group: granted without a round trip, capture running
+        assertEquals(PttFloorEvent.State.GRANTED, audioEngine.requestFloor())
+        assertTrue(audioEngine.isCapturing.value)
+        Thread.sleep(300)
+        val granted = audioEngine.awaitFloorEvents(100)
+        assertEquals(PttFloorEvent.Type.GRANTED, granted.first().type)
+
+        val holding = audioEngine.getTelemetry()
+        assertNotNull(holding)
+        assertEquals(PttFloorEvent.State.GRANTED.ordinal.toLong(), holding!!.floorState)
+        assertEquals(1L, holding.floorGrants)
+        assertTrue("Frames flow while holding", holding.packetsSent > 0)
+
+        audioEngine.releaseFloor()
+        assertFalse(audioEngine.isCapturing.value)
+        val released = audioEngine.getTelemetry()!!
+        assertEquals(PttFloorEvent.State.IDLE.ordinal.toLong(), released.floorState)
+
+        // Without the floor nothing goes out, even with the mic open
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(300)
+        audioEngine.stopCapture()
+        assertEquals(released.packetsSent, audioEngine.getTelemetry()!!.packetsSent)
+        assertTrue("Wait returns on timeout", audioEngine.awaitFloorEvents(50).isEmpty())
+
+        audioEngine.setNativeFloorControl(false)
+    }
+
+    @Test
+    fun testRedundancy() {
+        audioEngine.setRedundancy(PttRedundancy(PttRedundancy.Mode.RED, depth = 2))
+        assertTrue(audioEngine.initialize("239.255.0.1", 15007, true))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(500)
+        audioEngine.stopCapture()
+
+        val red = audioEngine.getTelemetry()
+        assertNotNull(red)
+        assertTrue("At most depth copies per packet", red!!.redundantFramesSent <= 2 * red.packetsSent)
+        if (red.packetsSent > 2) {
+            assertTrue("Packets after the first carry copies", red.redundantFramesSent > 0)
+            assertTrue(red.redundantBytesSent > red.redundantFramesSent * 4)
+        }
+        assertEquals("Own loopback is never split", 0L, red.redundantFramesUsed)
+        assertEquals(0.0, red.redundancyUsedFraction, 0.0)
+
+        audioEngine.setRedundancy(PttRedundancy(PttRedundancy.Mode.DUPLICATE))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(500)
+        audioEngine.stopCapture()
+        val duplicate = audioEngine.getTelemetry()!!
+        assertTrue("One copy per packet at most",
+            duplicate.duplicatesSent <= duplicate.packetsSent - red.packetsSent)
+        assertEquals("RED stays off", red.redundantFramesSent, duplicate.redundantFramesSent)
+
+        audioEngine.setRedundancy(PttRedundancy.OFF)
+    }
+
+    @Test
+    fun testRelay() {
+        assertFalse("Member needs an IPv4 reflector",
+            audioEngine.setRelay(PttRelay(PttRelay.Role.MEMBER, reflectorAddress = "reflector")))
+        assertTrue(audioEngine.setRelay(PttRelay(PttRelay.Role.REFLECTOR)))
+        assertTrue(audioEngine.initialize("239.255.0.1", 15008, true))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(500)
+        audioEngine.stopCapture()
+
+        val reflector = audioEngine.getTelemetry()
+        assertNotNull(reflector)
+        assertEquals(PttRelay.Role.REFLECTOR.ordinal.toLong(), reflector!!.relayRole)
+        assertEquals("No member joined", 0L, reflector.relayMembers)
+        assertEquals("Nothing to forward without members", 0L, reflector.relayPacketsForwarded)
+        assertEquals(0L, reflector.relayViaReflector)
+        assertTrue(audioEngine.getRelayMembers().isEmpty())
+
+        // No reflector answers on loopback: the member keeps its own fan-out
+        assertTrue(audioEngine.setRelay(
+            PttRelay(PttRelay.Role.MEMBER, reflectorAddress = "127.0.0.1", keepaliveMs = 100)))
+        Thread.sleep(300)
+        val member = audioEngine.getTelemetry()!!
+        assertEquals(PttRelay.Role.MEMBER.ordinal.toLong(), member.relayRole)
+        assertEquals(0L, member.relayViaReflector)
+
+        assertTrue(audioEngine.setRelay(PttRelay.OFF))
+    }
+
+    @Test
+    fun testPowerPolicy() {
+        assertTrue(audioEngine.initialize("239.255.0.1", 15009, true))
+        audioEngine.setPowerConfig(PttPower(PttPower.IdlePlayback.STOP, idleAfterMs = 1000))
+        assertTrue(audioEngine.startPlayback())
+
+        // Nothing arrives on the test group: playback parks after a second
+        Thread.sleep(1800)
+        val idle = audioEngine.getTelemetry()
+        assertNotNull(idle)
+        assertTrue("Receive side went idle", idle!!.powerIdleEntries >= 1)
+        assertEquals(1L, idle.powerMode)
+
+        // Capturing is never idle
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(100)
+        assertEquals(0L, audioEngine.getTelemetry()!!.powerMode)
+        audioEngine.stopCapture()
+
+        audioEngine.setPowerConfig(PttPower.DEFAULT)
+        Thread.sleep(100)
+        assertEquals(0L, audioEngine.getTelemetry()!!.powerMode)
+        audioEngine.stopPlayback()
+    }
+
+    @Test
+    fun testRecording() {
+        val directory = java.io.File(context.cacheDir, "ptt-recording").apply {
+            deleteRecursively()
+            mkdirs()
+        }
+        assertFalse("Recording needs an initialized engine",
+            audioEngine.startRecording(PttRecording(directory)))
+        assertTrue(audioEngine.initialize("239.255.0.1", 15010, true))
+        assertFalse(audioEngine.startRecording(PttRecording(java.io.File(directory, "missing"))))
+        assertTrue(audioEngine.startRecording(PttRecording(directory, PttRecording.Sync.FDATASYNC)))
+
+        // Our own transmissions are not received: nothing to store
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(500)
+        audioEngine.stopCapture()
+        audioEngine.stopRecording()
+
+        val telemetry = audioEngine.getTelemetry()
+        assertNotNull(telemetry)
+        assertEquals(0L, telemetry!!.recordingDroppedPackets)
+        assertEquals("One file per burst", telemetry.recordingBursts,
+            directory.listFiles { f -> f.name.endsWith(".opus") }?.size?.toLong() ?: 0L)
+    }
+
+    @Test
+    fun testThreadPolicies() {
+        assertTrue(audioEngine.initialize("239.255.0.1", 15011, true))
+        assertTrue(audioEngine.startCapture())
+        Thread.sleep(300)
+
+        val stats = audioEngine.getThreadStats().associateBy { it.role }
+        assertEquals(PttThreads.Role.values().size, stats.size)
+        val network = stats.getValue(PttThreads.Role.NETWORK)
+        assertTrue("Receive thread registered", network.tid != 0)
+        // FIFO is refused for most app processes; audio priority then
+        assertTrue(network.applied != PttThreads.Sched.DEFAULT)
+        val encoder = stats.getValue(PttThreads.Role.ENCODER)
+        assertEquals(PttThreads.Sched.NICE, encoder.applied)
+        assertEquals(PttThreads.AUDIO_NICE, encoder.nice)
+        assertTrue("Poll sleeps measured", encoder.wakeSamples > 0)
+        assertEquals(encoder.wakeSamples, encoder.histogram.sum())
+
+        // Pinning applies to the running encoder at once
+        val cores = audioEngine.performanceCores()
+        if (cores.isNotEmpty()) {
+            audioEngine.setThreadPolicy(PttThreads.Role.ENCODER, PttThreads(cpus = cores))
+            val pinned = audioEngine.getThreadStats().first { it.role == PttThreads.Role.ENCODER }
+            assertEquals(cores, pinned.cpus)
+        }
+        audioEngine.setThreadPolicy(PttThreads.Role.ENCODER, PttThreads.defaultFor(PttThreads.Role.ENCODER))
+        audioEngine.stopCapture()
+        Thread.sleep(100)
+        assertEquals(0, audioEngine.getThreadStats().first { it.role == PttThreads.Role.ENCODER }.tid)
+    }
+
+    @Test
+    fun testMemoryBudget() {
+        try {
+            // Below one talker: refused, not exceeded
+            audioEngine.setMemoryBudget(16 * 1024)
+            assertFalse(audioEngine.initialize("239.255.0.1", 15012, true))
+
+            audioEngine.setMemoryBudget()
+            assertTrue(audioEngine.initialize("239.255.0.1", 15012, true))
+            assertTrue(audioEngine.startPlayback())
+            Thread.sleep(300)
+
+            val telemetry = audioEngine.getTelemetry()
+            assertNotNull(telemetry)
+            assertEquals(PttAudioEngine.DEFAULT_MEMORY_BUDGET_BYTES, telemetry!!.memoryBudgetBytes)
+            assertEquals(8L, telemetry.memoryStreamSlots)
+            assertTrue(telemetry.memoryReservedBytes in 1..telemetry.memoryBudgetBytes)
+            assertTrue(telemetry.memoryMtuAvailable > 0)
+            assertEquals(0L, telemetry.memoryLateAllocations)
+            audioEngine.stopPlayback()
+        } finally {
+            audioEngine.setMemoryBudget()
+        }
+    }
+
+    @Test
+    fun testAudioRoute() {
+        val audioManager = context.getSystemService(Context.AUDIO_SERVICE) as AudioManager
+        val speaker = PttAudioRoute.forDeviceType(audioManager, AudioDeviceInfo.TYPE_BUILTIN_SPEAKER)
+        try {
+            assertTrue(audioEngine.initialize("239.255.0.1", 15013, true))
+            assertTrue(audioEngine.startPlayback())
+            Thread.sleep(200)
+
+            // Rerouted under the running session, not torn down
+            audioEngine.setAudioRoute(speaker ?: PttAudioRoute(echoCancel = false))
+            Thread.sleep(500)
+            val telemetry = audioEngine.getTelemetry()
+            assertNotNull(telemetry)
+            assertTrue(telemetry!!.streamRouteChanges >= 1)
+            assertEquals(0L, telemetry.streamsRecovering)
+            assertEquals(0L, telemetry.streamRecoveryFailures)
+            assertTrue(telemetry.streamLastRecoveryMicros > 0)
+            if (speaker != null) {
+                assertEquals(speaker.outputDeviceId.toLong(), telemetry.playbackDeviceId)
+            }
+            assertTrue("Playback survives the route change", audioEngine.isPlaying.value)
+            audioEngine.stopPlayback()
+        } finally {
+            audioEngine.setAudioRoute(PttAudioRoute())
+        }
+    }
+
+    @Test
+    fun testReceiveLoopShutdown() {
+        audioEngine.setNativeFloorControl(true)
+        try {
+            // Every teardown joins the receive thread, with a scan socket,
+            // floor timers and RTCP still on its event loop
+            repeat(5) {
+                assertTrue(audioEngine.initialize("239.255.0.1", 15014, true))
+                assertTrue(audioEngine.joinChannel(1, "239.255.0.2", 15016))
+                assertEquals(PttFloorEvent.State.GRANTED, audioEngine.requestFloor())
+                Thread.sleep(100)
+                val started = System.nanoTime()
+                audioEngine.cleanup()
+                val stopMs = (System.nanoTime() - started) / 1_000_000
+                assertTrue("Teardown took $stopMs ms", stopMs < 500)
+            }
+            assertTrue("Port free again after the last join", audioEngine.initialize("239.255.0.1", 15014, true))
+        } finally {
+            audioEngine.setNativeFloorControl(false)
+        }
+    }
+
+    @Test
+    fun testCodecProfiles() {
+        assertTrue(audioEngine.initialize("239.255.0.1", 15018, true))
+        try {
+            PttCodecProfile.values().forEach {
+                assertTrue("Profile $it on the home channel", audioEngine.setCodecProfile(PttAudioEngine.HOME_CHANNEL, it))
+            }
+
+            // One key-up under ROBUST is counted against that profile only
+            assertTrue(audioEngine.setCodecProfile(PttAudioEngine.HOME_CHANNEL, PttCodecProfile.ROBUST))
+            assertTrue(audioEngine.startCapture())
+            Thread.sleep(1000)
+            audioEngine.stopCapture()
+
+            val results = audioEngine.getProfileResults()
+            assertEquals(PttCodecProfile.values().toList(), results.map { it.profile })
+            val robust = results[PttCodecProfile.ROBUST.ordinal]
+            assertEquals(1L, robust.txSessions)
+            assertTrue(robust.txMillis >= 500)
+            assertTrue(robust.txFrames > 0)
+            assertEquals(0L, results[PttCodecProfile.DEFAULT.ordinal].txSessions)
+
+            audioEngine.resetProfileResults()
+            assertTrue(audioEngine.getProfileResults().all { it.txSessions == 0L && it.streamsScored == 0L })
+        } finally {
+            audioEngine.setCodecProfile(PttAudioEngine.HOME_CHANNEL, PttCodecProfile.DEFAULT)
+            audioEngine.cleanup()
+        }
+    }
+
     @Test
     fun testConcurrentOperations() = runBlocking {
         // Initialize
@@ -0,0 +1,1875 @@
+/*
+ * Mesh Rider Wave - PTT Host Benchmark
+ * Hot-path regression harness for the native pipeline, built without the NDK
+ *
+ * Drives OpusEncoder/OpusDecoder, RtpJitterBuffer and RtpPacketizer (over
+ * loopback) with synthetic speech and reports:
+ * - encode / decode / PLC microseconds per frame (mean, p50, p99)
+ * - packets per CPU-second for the send path and the recvmmsg receive loop
+ * - jitter-buffer playout latency, concealment and late drops while
+ *   replaying loss/reorder traces on a virtual clock
+ * - DSP kernels per 10 ms block, scalar vs SIMD, the full capture chain and
+ *   the 48 kHz <-> 16 kHz resamplers
+ * - SRTP protect / unprotect nanoseconds per voice packet, portable AES-GCM
+ *   vs the hardware kernels (ARMv8 CE or AES-NI); first every available
+ *   kernel against the GCM and RFC 7714 known answers and byte for byte
+ *   against portable (any mismatch fails the run)
+ * - floor-control decision cost: press -> grant round and collision
+ * - RED (depth 2): send/receive cost and overhead over loopback, and
+ *   burst-loss playout with the copies filling the holes
+ * - reflector routing: targets and duplicate suppression per received
+ *   datagram, 8 unicast members
+ * - recording tap: receive-thread cost per packet and write() calls per
+ *   recorded minute, 8 channels to Ogg/Opus files
+ * - wakeup latency: socket wait of the loopback receive thread (kernel
+ *   receive stamps) and poll-sleep overshoot under the worker policies
+ * - event loop: timerfd lateness of a 1 ms timer, heap allocations per
+ *   pass, and how long stop() takes to join the thread
+ * - receive memory: bytes reserved for 8 talkers and steady-state
+ *   allocations (heap, arena and pool fallbacks), which must stay at zero
+ * - codec profiles: air rate of each profile's encoder settings, and the
+ *   E-model MOS of its jitter buffer on a clean and an impaired mesh link
+ * - heap allocations per frame on every measured path
+ *
+ * Build (Linux host):
+ *   cmake -S app/src/main/cpp -B build-bench
+ *   cmake --build build-bench --target meshriderptt_bench
+ *
+ * Usage:
+ *   meshriderptt_bench [--seconds N] [--trace FILE]... [--out FILE]
+ *                      [--baseline FILE] [--tolerance PCT] [--verbose]
+ *
+ * Link conditions come from NetworkImpairment (the same seeded model the
+ * packetizer applies on device). --trace replays a recorded trace: one
+ * "seq send_ms arrival_ms" line per received packet (lost packets omitted,
+ * '#' starts a comment). --out saves
+ * the results; --baseline compares against a saved run from the same
+ * machine and exits 1 if any gated metric regressed beyond --tolerance
+ * (default 15%).
+ */
+
+#include "AudioDsp.h"
+#include "CallQuality.h"
+#include "EventLoop.h"
+#include "FloorControl.h"
+#include "OpusCodec.h"
+#include "NetworkImpairment.h"
+#include "PacketPool.h"
+#include "PttLog.h"
+#include "RtpPacketizer.h"
+#include "ReceiveStreams.h"
+#include "RtpRelay.h"
+#include "SrtpSession.h"
+#include "ThreadManager.h"
+#include "VoiceRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace meshrider::ptt;
+
+// ============================================================================
+// Allocation counting (per thread, so the receive thread is measured apart)
+// ============================================================================
+
+namespace {
+thread_local uint64_t t_allocations = 0;
+}
+
+// Out of line: GCC misreads inlined replacement pairs as mismatched new/free
+__attribute__((noinline)) void* operator new(size_t size) {
+    t_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size) {
+    t_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { ::operator delete[](p); }
+
+namespace {
+
+// ============================================================================
+// Results
+// ============================================================================
+
+struct Metric {
+    std::string name;
+    double value;
+    const char* unit;
+    bool higherIsBetter;
+    double slack;       // Absolute allowance on top of the relative tolerance
+};
+
+std::vector<Metric> g_results;
+
+void report(const std::string& name, double value, const char* unit,
+            bool higherIsBetter = false, double slack = 0.0) {
+    g_results.push_back({name, value, unit, higherIsBetter, slack});
+    std::printf("  %-36s %12.3f %s\n", name.c_str(), value, unit);
+}
+
+int64_t nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Sub-microsecond timer for per-frame codec timings
+double elapsedMicros(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+int64_t threadCpuMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Nearest-rank percentile; sorts in place
+double percentile(std::vector<double>& values, double pct) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t rank = static_cast<size_t>(std::ceil(pct / 100.0 * values.size()));
+    return values[rank > 0 ? rank - 1 : 0];
+}
+
+double mean(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return sum / values.size();
+}
+
+void reportTimings(const std::string& prefix, std::vector<double>& micros) {
+    report(prefix + "_mean_us", mean(micros), "us", false, 1.0);
+    report(prefix + "_p50_us", percentile(micros, 50), "us", false, 1.0);
+    report(prefix + "_p99_us", percentile(micros, 99), "us", false, 2.0);
+}
+
+// ============================================================================
+// Synthetic speech
+// ============================================================================
+
+/**
+ * Deterministic speech-like signal at PttAudioFormat::kSampleRate
+ *
+ * Syllables of ~180 ms: mostly voiced (harmonics of a drifting 90-220 Hz
+ * pitch weighted by two formant peaks), some unvoiced (noise), some
+ * pauses, each under a raised-cosine envelope. Exercises Opus SILK/CELT
+ * decisions and DTX-sized pauses the way real talk spurts do.
+ */
+class SpeechSynth {
+public:
+    explicit SpeechSynth(uint32_t seed) : rng_(seed) {}
+
+    std::vector<int16_t> generate(size_t samples) {
+        std::vector<int16_t> pcm(samples);
+        const double rate = PttAudioFormat::kSampleRate;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::normal_distribution<double> noise(0.0, 0.3);
+
+        size_t pos = 0;
+        while (pos < samples) {
+            const size_t length = static_cast<size_t>(rate * (0.12 + 0.12 * unit(rng_)));
+            const double kind = unit(rng_);
+            const double f0 = 90.0 + 130.0 * unit(rng_);
+            const double f0End = f0 * (0.85 + 0.3 * unit(rng_));
+            const double formant1 = 350.0 + 500.0 * unit(rng_);
+            const double formant2 = 1000.0 + 1500.0 * unit(rng_);
+            const double gain = 6000.0 + 6000.0 * unit(rng_);
+
+            for (size_t i = 0; i < length && pos < samples; ++i, ++pos) {
+                const double t = static_cast<double>(i) / length;
+                const double envelope = 0.5 - 0.5 * std::cos(2.0 * M_PI * t);
+                double sample = 0.0;
+                if (kind < 0.7) {
+                    const double pitch = f0 + (f0End - f0) * t;
+                    phase_ += 2.0 * M_PI * pitch / rate;
+                    for (int k = 1; k * pitch < rate / 2 && k <= 40; ++k) {
+                        const double f = k * pitch;
+                        const double w = formantWeight(f, formant1, 90.0) +
+                                         0.5 * formantWeight(f, formant2, 150.0);
+                        sample += w * std::sin(k * phase_) / k;
+                    }
+                } else if (kind < 0.85) {
+                    sample = noise(rng_);
+                }
+                pcm[pos] = static_cast<int16_t>(
+                    std::clamp(gain * envelope * sample, -32767.0, 32767.0));
+            }
+        }
+        return pcm;
+    }
+
+private:
+    static double formantWeight(double f, double center, double bandwidth) {
+        const double x = (f - center) / bandwidth;
+        return 1.0 / (1.0 + x * x);
+    }
+
+    std::mt19937 rng_;
+    double phase_ = 0.0;
+};
+
+// ============================================================================
+// DSP
+// ============================================================================
+
+// Mean nanoseconds per call of fn(blockIndex) over `passes` sweeps of the blocks
+template <typename Fn>
+double nanosPerBlock(size_t blocks, size_t passes, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < blocks; ++i) {
+            fn(i);
+        }
+    }
+    return elapsedMicros(start) * 1000.0 / static_cast<double>(blocks * passes);
+}
+
+// Scalar and SIMD timings of one kernel, plus the speedup
+template <typename ScalarFn, typename SimdFn>
+void reportKernel(const char* name, size_t blocks, size_t passes,
+                  ScalarFn&& scalar, SimdFn&& simd) {
+    const double scalarNs = nanosPerBlock(blocks, passes, scalar);
+    const double simdNs = nanosPerBlock(blocks, passes, simd);
+    report(std::string("dsp_") + name + "_scalar_ns", scalarNs, "ns", false, 50.0);
+    report(std::string("dsp_") + name + "_simd_ns", simdNs, "ns", false, 50.0);
+    report(std::string("dsp_") + name + "_speedup", simdNs > 0 ? scalarNs / simdNs : 0.0,
+           "x", true, 0.2);
+}
+
+// Resample a 48 kHz stream in device-callback-sized pieces; ns per 10 ms of audio
+template <bool Simd>
+double benchDecimator(const std::vector<int16_t>& device, size_t passes) {
+    PolyphaseDecimator<kResampleFactor, kResamplerTapsPerPhase, Simd> decimator;
+    int16_t out[decltype(decimator)::maxOutput(kResamplerChunkSamples)];
+    const size_t chunk = kDspBlockSamples * kResampleFactor;
+    const size_t blocks = device.size() / chunk;
+    return nanosPerBlock(blocks, passes, [&](size_t i) {
+        decimator.process(device.data() + i * chunk, chunk, out);
+    });
+}
+
+template <bool Simd>
+double benchInterpolator(const std::vector<int16_t>& pcm, size_t passes) {
+    PolyphaseInterpolator<kResampleFactor, kResamplerTapsPerPhase, Simd> interpolator;
+    int16_t out[kDspBlockSamples * kResampleFactor];
+    const size_t blocks = pcm.size() / kDspBlockSamples;
+    size_t consumed = 0;
+    return nanosPerBlock(blocks, passes, [&](size_t) {
+        const size_t needed = interpolator.inputNeeded(kDspBlockSamples * kResampleFactor);
+        if (consumed + needed > pcm.size()) {
+            consumed = 0;
+        }
+        interpolator.process(pcm.data() + consumed, needed, out, kDspBlockSamples * kResampleFactor);
+        consumed += needed;
+    });
+}
+
+void benchDsp(const std::vector<int16_t>& speech) {
+    std::printf("Audio DSP (%zu-sample blocks, %s)\n", kDspBlockSamples,
+#if MESHRIDER_PTT_DSP_NEON
+                "NEON"
+#elif MESHRIDER_PTT_DSP_SSE2
+                "SSE2"
+#else
+                "no SIMD"
+#endif
+    );
+
+    // A few seconds of blocks, swept until ~1 M blocks have run per kernel
+    const size_t blocks = std::min<size_t>(speech.size() / kDspBlockSamples, 500);
+    const size_t passes = 2000;
+    std::vector<float> floats(blocks * kDspBlockSamples);
+    std::vector<int16_t> pcm(blocks * kDspBlockSamples);
+    volatile float sink = 0.0f;
+    volatile size_t limitedSink = 0;
+
+    auto floatsAt = [&](size_t i) { return floats.data() + i * kDspBlockSamples; };
+    auto speechAt = [&](size_t i) { return speech.data() + i * kDspBlockSamples; };
+
+    reportKernel("to_float", blocks, passes,
+        [&](size_t i) { pcmToFloatScalar(speechAt(i), floatsAt(i), kDspBlockSamples); },
+        [&](size_t i) { pcmToFloat<kDspBlockSamples>(speechAt(i), floatsAt(i)); });
+    reportKernel("to_pcm", blocks, passes,
+        [&](size_t i) { floatToPcmScalar(floatsAt(i), pcm.data() + i * kDspBlockSamples, kDspBlockSamples); },
+        [&](size_t i) { floatToPcm<kDspBlockSamples>(floatsAt(i), pcm.data() + i * kDspBlockSamples); });
+    reportKernel("sum_squares", blocks, passes,
+        [&](size_t i) { sink = sink + sumOfSquaresScalar(floatsAt(i), kDspBlockSamples); },
+        [&](size_t i) { sink = sink + sumOfSquares<kDspBlockSamples>(floatsAt(i)); });
+    // Unity-ish ramps so repeated passes neither blow up nor decay to zero
+    reportKernel("gain_ramp", blocks, passes,
+        [&](size_t i) { applyGainRampScalar(floatsAt(i), kDspBlockSamples, 0.999f, 1.001f); },
+        [&](size_t i) { applyGainRamp<kDspBlockSamples>(floatsAt(i), 0.999f, 1.001f); });
+    const float threshold = std::pow(10.0f, kDefaultLimiterThresholdDbfs / 20.0f) * 0.25f;
+    reportKernel("soft_limit", blocks, passes,
+        [&](size_t i) { limitedSink = limitedSink + softLimitScalar(floatsAt(i), kDspBlockSamples, threshold); },
+        [&](size_t i) { limitedSink = limitedSink + softLimit<kDspBlockSamples>(floatsAt(i), threshold); });
+
+    // Capture chain (HPF -> AGC -> limiter) at the encoder's frame size
+    AudioDspChain chain{DspConfig{}};
+    std::copy(speech.begin(), speech.begin() + pcm.size(), pcm.begin());
+    const uint64_t allocsBefore = t_allocations;
+    const double chainNs = nanosPerBlock(blocks, passes / 10, [&](size_t i) {
+        limitedSink = limitedSink + chain.process(pcm.data() + i * kDspBlockSamples, kDspBlockSamples);
+    });
+    const uint64_t chainAllocs = t_allocations - allocsBefore;
+    report("dsp_capture_chain_ns", chainNs, "ns", false, 200.0);
+    report("dsp_capture_chain_allocs_per_block",
+           static_cast<double>(chainAllocs) / (blocks * (passes / 10)), "allocs", false, 0.01);
+
+    // Resamplers on a 48 kHz upsample of the speech (sample-and-hold is fine for timing)
+    std::vector<int16_t> device(blocks * kDspBlockSamples * kResampleFactor);
+    for (size_t i = 0; i < device.size(); ++i) {
+        device[i] = speech[i / kResampleFactor];
+    }
+    const double downScalar = benchDecimator<false>(device, passes / 10);
+    const double downSimd = benchDecimator<true>(device, passes / 10);
+    report("dsp_resample_down_scalar_ns", downScalar, "ns", false, 200.0);
+    report("dsp_resample_down_simd_ns", downSimd, "ns", false, 200.0);
+    report("dsp_resample_down_speedup", downSimd > 0 ? downScalar / downSimd : 0.0, "x", true, 0.2);
+    const double upScalar = benchInterpolator<false>(pcm, passes / 10);
+    const double upSimd = benchInterpolator<true>(pcm, passes / 10);
+    report("dsp_resample_up_scalar_ns", upScalar, "ns", false, 200.0);
+    report("dsp_resample_up_simd_ns", upSimd, "ns", false, 200.0);
+    report("dsp_resample_up_speedup", upSimd > 0 ? upScalar / upSimd : 0.0, "x", true, 0.2);
+
+    // SIMD conversions must stay bit-exact with the scalar reference
+    std::vector<int16_t> viaScalar(kDspBlockSamples);
+    std::vector<int16_t> viaSimd(kDspBlockSamples);
+    int maxDiff = 0;
+    for (size_t i = 0; i < blocks; ++i) {
+        alignas(16) float block[kDspBlockSamples];
+        pcmToFloat<kDspBlockSamples>(speechAt(i), block);
+        applyGainRamp<kDspBlockSamples>(block, 1.0f, 4.0f);
+        softLimit<kDspBlockSamples>(block, threshold);
+        floatToPcm<kDspBlockSamples>(block, viaSimd.data());
+        pcmToFloatScalar(speechAt(i), block, kDspBlockSamples);
+        applyGainRampScalar(block, kDspBlockSamples, 1.0f, 4.0f);
+        softLimitScalar(block, kDspBlockSamples, threshold);
+        floatToPcmScalar(block, viaScalar.data(), kDspBlockSamples);
+        for (size_t n = 0; n < kDspBlockSamples; ++n) {
+            maxDiff = std::max(maxDiff, std::abs(viaSimd[n] - viaScalar[n]));
+        }
+    }
+    report("dsp_simd_max_lsb_diff", maxDiff, "LSB", false, 1.0);
+    (void)sink;
+    (void)limitedSink;
+}
+
+// ============================================================================
+// SRTP
+// ============================================================================
+
+std::vector<uint8_t> fromHex(const char* hex) {
+    std::vector<uint8_t> bytes;
+    for (; hex[0] && hex[1]; hex += 2) {
+        const char pair[3] = {hex[0], hex[1], '\0'};
+        bytes.push_back(static_cast<uint8_t>(std::strtoul(pair, nullptr, 16)));
+    }
+    return bytes;
+}
+
+std::vector<CryptoBackend> availableBackends() {
+    std::vector<CryptoBackend> backends;
+    for (CryptoBackend backend : {CryptoBackend::PORTABLE, CryptoBackend::ARMV8_CE,
+                                  CryptoBackend::X86_AESNI}) {
+        AesGcm probe;
+        if (probe.setBackend(backend)) {
+            backends.push_back(backend);
+        }
+    }
+    return backends;
+}
+
+// McGrew & Viega GCM test cases 1-4 and 13-16 (the NIST SP 800-38D
+// validation set), AES-128 and AES-256
+struct GcmVector {
+    const char* key;
+    const char* iv;
+    const char* plaintext;
+    const char* aad;
+    const char* ciphertext;
+    const char* tag;
+};
+
+#define GCM_K3 "feffe9928665731c6d6a8f9467308308"
+#define GCM_IV3 "cafebabefacedbaddecaf888"
+#define GCM_P60 "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72" \
+                "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+#define GCM_A4 "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+#define GCM_C128 "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e" \
+                 "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091"
+#define GCM_C256 "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa" \
+                 "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662"
+#define GCM_Z16 "00000000000000000000000000000000"
+#define GCM_Z12 "000000000000000000000000"
+
+const GcmVector kGcmVectors[] = {
+    { GCM_Z16, GCM_Z12, "", "", "", "58e2fccefa7e3061367f1d57a4e7455a" },
+    { GCM_Z16, GCM_Z12, GCM_Z16, "", "0388dace60b6a392f328c2b971b2fe78",
+      "ab6e47d42cec13bdf53a67b21257bddf" },
+    { GCM_K3, GCM_IV3, GCM_P60 "1aafd255", "", GCM_C128 "473f5985",
+      "4d5c2af327cd64a62cf35abd2ba6fab4" },
+    { GCM_K3, GCM_IV3, GCM_P60, GCM_A4, GCM_C128, "5bc94fbc3221a5db94fae95ae7121a47" },
+    { GCM_Z16 GCM_Z16, GCM_Z12, "", "", "", "530f8afbc74536b9a963b4f1c4cb738b" },
+    { GCM_Z16 GCM_Z16, GCM_Z12, GCM_Z16, "", "cea7403d4d606b6e074ec5d3baf39d18",
+      "d0d1c8a799996bf0265b98b5d48ab919" },
+    { GCM_K3 GCM_K3, GCM_IV3, GCM_P60 "1aafd255", "", GCM_C256 "898015ad",
+      "b094dac5d93471bdec1a502270e3cc6c" },
+    { GCM_K3 GCM_K3, GCM_IV3, GCM_P60, GCM_A4, GCM_C256, "76fc6ece0f4e1768cddf8853bb2d551b" },
+};
+
+// RFC 7714 16: session key and salt (no KDF), one RTP and one SRTCP packet
+// per key size. Protected forms also checked against OpenSSL's AES-GCM.
+struct SrtpVector {
+    const char* key;
+    const char* salt;
+    const char* rtpPlain;       // Header || payload
+    const char* rtpProtected;   // Header || ciphertext || tag
+    const char* rtcpPlain;
+    const char* rtcpProtected;  // Header || ciphertext || tag || E + index (0x5d4)
+};
+
+#define SRTP_SALT "517569642070726f2071756f"
+#define SRTP_RTP "8040f17b8041f8d35501a0b2"
+#define SRTP_RTP_PLAIN SRTP_RTP "47616c6c696120657374206f6d6e69732064697669736120696e20" \
+                                "7061727465732074726573"
+#define SRTP_RTCP "81c8000d4d617273"
+#define SRTP_RTCP_PLAIN SRTP_RTCP "4e5450314e545032525450200000042a0000e9304c756e61" \
+                                  "deadbeefdeadbeefdeadbeefdeadbeefdeadbeefdeadbeef"
+constexpr uint32_t kSrtcpVectorIndex = 0x5d4;
+
+const SrtpVector kSrtpVectors[] = {
+    { "000102030405060708090a0b0c0d0e0f", SRTP_SALT, SRTP_RTP_PLAIN,
+      SRTP_RTP "f24de3a3fb34de6cacba861c9d7e4bcabe633bd50d294e6f42a5f47a51c7d19b36de3adf8833"
+               "899d7f27beb16a9152cf765ee4390cce",
+      SRTP_RTCP_PLAIN,
+      SRTP_RTCP "63e94885dcdab67ca727d7662f6b7e997ff5c0f76c06f32dc676a5f1730d6fda4ce09b46"
+                "86303ded0bb9275b3eb9c6fa6924798e44f3d042ad45aeabbc7d6019800005d4" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", SRTP_SALT,
+      SRTP_RTP_PLAIN,
+      SRTP_RTP "32b1de78a822fe12ef9f78fa332e33aab18012389a58e2f3b50b2a0276ffae0f1ba63799b87b"
+               "7aa3db36dfffd6b0f9bb7878d7a76c13",
+      SRTP_RTCP_PLAIN,
+      SRTP_RTCP "d50ae4d1f5ce5d304ba297e47d470c282c3ece5dbffe0a50a2eaa5c1110555be8415f658"
+                "c61de0476f1b6fade5d987baed4f8777d0d056a2bda4d9438d3a0dc8800005d4" },
+};
+
+// Known answers on one backend; returns the failed checks
+size_t checkKnownAnswers(CryptoBackend backend) {
+    size_t failures = 0;
+    for (const GcmVector& v : kGcmVectors) {
+        const std::vector<uint8_t> key = fromHex(v.key);
+        const std::vector<uint8_t> iv = fromHex(v.iv);
+        const std::vector<uint8_t> plaintext = fromHex(v.plaintext);
+        const std::vector<uint8_t> aad = fromHex(v.aad);
+        const std::vector<uint8_t> ciphertext = fromHex(v.ciphertext);
+        const std::vector<uint8_t> tag = fromHex(v.tag);
+
+        AesGcm gcm;
+        gcm.setBackend(backend);
+        gcm.setKey(key.data(), key.size());
+        std::vector<uint8_t> data = plaintext;
+        uint8_t sealed[kGcmTagBytes];
+        gcm.seal(iv.data(), aad.data(), aad.size(), data.data(), data.size(), sealed);
+        if (data != ciphertext || std::memcmp(sealed, tag.data(), kGcmTagBytes) != 0) {
+            failures++;
+        }
+        if (!gcm.open(iv.data(), aad.data(), aad.size(), data.data(), data.size(), tag.data()) ||
+            data != plaintext) {
+            failures++;
+        }
+        uint8_t forged[kGcmTagBytes];
+        std::memcpy(forged, tag.data(), kGcmTagBytes);
+        forged[0] ^= 1;
+        std::vector<uint8_t> again = ciphertext;
+        if (gcm.open(iv.data(), aad.data(), aad.size(), again.data(), again.size(), forged)) {
+            failures++;
+        }
+    }
+
+    for (const SrtpVector& v : kSrtpVectors) {
+        const std::vector<uint8_t> key = fromHex(v.key);
+        const std::vector<uint8_t> salt = fromHex(v.salt);
+        SrtpSession sender;
+        SrtpSession receiver;
+        sender.setBackend(backend);
+        receiver.setBackend(backend);
+        sender.setSessionKeys(1, key.data(), key.size(), salt.data(), salt.size(), 0);
+        receiver.setSessionKeys(1, key.data(), key.size(), salt.data(), salt.size(), 0);
+
+        const std::vector<uint8_t> rtpPlain = fromHex(v.rtpPlain);
+        const std::vector<uint8_t> rtpProtected = fromHex(v.rtpProtected);
+        std::vector<uint8_t> packet = rtpPlain;
+        packet.resize(rtpPlain.size() + kSrtpOverheadBytes);
+        const size_t protectedBytes = sender.protectRtp(packet.data(), RTP_HEADER_SIZE,
+            rtpPlain.size() - RTP_HEADER_SIZE, packet.size());
+        if (protectedBytes != rtpProtected.size() || packet != rtpProtected) {
+            failures++;
+        }
+        packet = rtpProtected;
+        size_t length = packet.size();
+        if (receiver.unprotectRtp(packet.data(), length, RTP_HEADER_SIZE, 0) != SrtpStatus::OK ||
+            length != rtpPlain.size() ||
+            std::memcmp(packet.data(), rtpPlain.data(), length) != 0) {
+            failures++;
+        }
+
+        // Our SRTCP index counts up from 0: spend indices up to the vector's
+        const std::vector<uint8_t> rtcpPlain = fromHex(v.rtcpPlain);
+        const std::vector<uint8_t> rtcpProtected = fromHex(v.rtcpProtected);
+        std::vector<uint8_t> scratch(rtcpPlain.size() + kSrtcpOverheadBytes);
+        for (uint32_t i = 0; i < kSrtcpVectorIndex; ++i) {
+            std::memcpy(scratch.data(), rtcpPlain.data(), rtcpPlain.size());
+            sender.protectRtcp(scratch.data(), rtcpPlain.size(), scratch.size());
+        }
+        packet = rtcpPlain;
+        packet.resize(rtcpPlain.size() + kSrtcpOverheadBytes);
+        if (sender.protectRtcp(packet.data(), rtcpPlain.size(), packet.size()) !=
+                rtcpProtected.size() || packet != rtcpProtected) {
+            failures++;
+        }
+        packet = rtcpProtected;
+        length = packet.size();
+        if (receiver.unprotectRtcp(packet.data(), length, 0) != SrtpStatus::OK ||
+            length != rtcpPlain.size() ||
+            std::memcmp(packet.data(), rtcpPlain.data(), length) != 0) {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Same inputs through PORTABLE and another backend, byte-compared: block
+// cipher, GCM at every tail length, and full SRTP/SRTCP incl. the KDF.
+// Returns the mismatches.
+size_t compareBackends(CryptoBackend other) {
+    size_t mismatches = 0;
+    std::mt19937 rng(0xAE5);
+    auto fill = [&rng](std::vector<uint8_t>& bytes) {
+        for (uint8_t& b : bytes) {
+            b = static_cast<uint8_t>(rng());
+        }
+    };
+
+    for (size_t keyBytes : {kAes128KeyBytes, kAes256KeyBytes}) {
+        std::vector<uint8_t> key(keyBytes);
+        std::vector<uint8_t> iv(kGcmIvBytes);
+        std::vector<uint8_t> aad(20);
+        fill(key);
+        AesGcm reference;
+        AesGcm candidate;
+        reference.setBackend(CryptoBackend::PORTABLE);
+        candidate.setBackend(other);
+        reference.setKey(key.data(), key.size());
+        candidate.setKey(key.data(), key.size());
+
+        uint8_t block[kAesBlockBytes] = {};
+        uint8_t a[kAesBlockBytes];
+        uint8_t b[kAesBlockBytes];
+        for (int i = 0; i < 64; ++i) {
+            block[i % kAesBlockBytes] ^= static_cast<uint8_t>(rng());
+            reference.encryptBlock(block, a);
+            candidate.encryptBlock(block, b);
+            mismatches += std::memcmp(a, b, sizeof(a)) != 0;
+        }
+
+        for (size_t bytes = 0; bytes <= 300; ++bytes) {
+            std::vector<uint8_t> x(bytes);
+            fill(x);
+            fill(iv);
+            fill(aad);
+            std::vector<uint8_t> y = x;
+            uint8_t tagX[kGcmTagBytes];
+            uint8_t tagY[kGcmTagBytes];
+            const size_t aadBytes = bytes % (aad.size() + 1);
+            reference.seal(iv.data(), aad.data(), aadBytes, x.data(), x.size(), tagX);
+            candidate.seal(iv.data(), aad.data(), aadBytes, y.data(), y.size(), tagY);
+            mismatches += x != y || std::memcmp(tagX, tagY, kGcmTagBytes) != 0;
+        }
+    }
+
+    std::vector<uint8_t> masterKey(kAes128KeyBytes);
+    std::vector<uint8_t> masterSalt(kSrtpMasterSaltBytes);
+    fill(masterKey);
+    fill(masterSalt);
+    SrtpSession reference;
+    SrtpSession candidate;
+    reference.setBackend(CryptoBackend::PORTABLE);
+    candidate.setBackend(other);
+    for (SrtpSession* session : {&reference, &candidate}) {
+        session->setMasterKey(1, masterKey.data(), masterKey.size(),
+                              masterSalt.data(), masterSalt.size(), 0);
+    }
+    for (size_t i = 0; i < 64; ++i) {
+        std::vector<uint8_t> x(RTP_HEADER_SIZE + 1 + i * 3 + kSrtcpOverheadBytes);
+        fill(x);
+        x[0] = 0x80;
+        x[2] = static_cast<uint8_t>(i >> 8);
+        x[3] = static_cast<uint8_t>(i);
+        std::vector<uint8_t> y = x;
+        const size_t bodyBytes = x.size() - kSrtcpOverheadBytes;
+        const size_t payloadBytes = bodyBytes - RTP_HEADER_SIZE;
+        mismatches += reference.protectRtp(x.data(), RTP_HEADER_SIZE, payloadBytes, x.size()) !=
+                      candidate.protectRtp(y.data(), RTP_HEADER_SIZE, payloadBytes, y.size());
+        mismatches += x != y;
+        mismatches += reference.protectRtcp(x.data(), bodyBytes, x.size()) !=
+                      candidate.protectRtcp(y.data(), bodyBytes, y.size());
+        mismatches += x != y;
+    }
+    return mismatches;
+}
+
+// Correctness first: a symmetric bug round-trips between two radios on
+// the same kernel and breaks interop with every other one
+bool checkSrtpKernels() {
+    size_t failures = 0;
+    for (CryptoBackend backend : availableBackends()) {
+        const size_t kat = checkKnownAnswers(backend);
+        if (kat > 0) {
+            std::fprintf(stderr, "%s: %zu known-answer checks failed\n",
+                         cryptoBackendName(backend), kat);
+        }
+        failures += kat;
+        if (backend != CryptoBackend::PORTABLE) {
+            const size_t mismatches = compareBackends(backend);
+            if (mismatches > 0) {
+                std::fprintf(stderr, "%s: %zu outputs differ from portable\n",
+                             cryptoBackendName(backend), mismatches);
+            }
+            failures += mismatches;
+        }
+    }
+    report("srtp_kat_failures", static_cast<double>(failures), "checks", false, 0.0);
+    return failures == 0;
+}
+
+// One backend over a batch of 20 ms voice packets: protect them all, then
+// verify them all on a second session (the receive path incl. replay window)
+void benchSrtpBackend(CryptoBackend backend, const char* label, size_t packetCount) {
+    constexpr size_t kPayloadBytes = 60;     // 24 kbps Opus, 20 ms
+    constexpr size_t kSlotBytes = RTP_HEADER_SIZE + kPayloadBytes + kSrtpOverheadBytes;
+    uint8_t key[kAes128KeyBytes];
+    uint8_t salt[kSrtpMasterSaltBytes];
+    for (size_t i = 0; i < sizeof(key); ++i) {
+        key[i] = static_cast<uint8_t>(0x11 * i);
+    }
+    for (size_t i = 0; i < sizeof(salt); ++i) {
+        salt[i] = static_cast<uint8_t>(0xA5 ^ i);
+    }
+    SrtpSession sender;
+    SrtpSession receiver;
+    sender.setBackend(backend);
+    receiver.setBackend(backend);
+    sender.setMasterKey(1, key, sizeof(key), salt, sizeof(salt), 0);
+    receiver.setMasterKey(1, key, sizeof(key), salt, sizeof(salt), 0);
+
+    std::vector<uint8_t> packets(packetCount * kSlotBytes);
+    for (size_t i = 0; i < packetCount; ++i) {
+        uint8_t* packet = packets.data() + i * kSlotBytes;
+        RtpHeader header{};
+        header.setVersion(RTP_VERSION);
+        header.setPayloadType(RTP_PAYLOAD_OPUS);
+        header.seq = htons(static_cast<uint16_t>(i));
+        header.timestamp = htonl(static_cast<uint32_t>(i * 960));
+        header.ssrc = htonl(0x5EC0DE);
+        std::memcpy(packet, &header, RTP_HEADER_SIZE);
+        for (size_t n = 0; n < kPayloadBytes; ++n) {
+            packet[RTP_HEADER_SIZE + n] = static_cast<uint8_t>(i + n);
+        }
+    }
+
+    const uint64_t allocsBefore = t_allocations;
+    const auto protectStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < packetCount; ++i) {
+        sender.protectRtp(packets.data() + i * kSlotBytes, RTP_HEADER_SIZE, kPayloadBytes,
+                          kSlotBytes);
+    }
+    const double protectNs = elapsedMicros(protectStart) * 1000.0 / packetCount;
+
+    size_t verified = 0;
+    const auto unprotectStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < packetCount; ++i) {
+        size_t length = kSlotBytes;
+        if (receiver.unprotectRtp(packets.data() + i * kSlotBytes, length, RTP_HEADER_SIZE, 0) ==
+            SrtpStatus::OK) {
+            ++verified;
+        }
+    }
+    const double unprotectNs = elapsedMicros(unprotectStart) * 1000.0 / packetCount;
+    const uint64_t allocs = t_allocations - allocsBefore;
+
+    std::printf("  %s: %s\n", label, cryptoBackendName(backend));
+    report(std::string("srtp_") + label + "_protect_ns", protectNs, "ns", false, 50.0);
+    report(std::string("srtp_") + label + "_unprotect_ns", unprotectNs, "ns", false, 50.0);
+    report(std::string("srtp_") + label + "_verify_failures",
+           static_cast<double>(packetCount - verified), "pkts", false, 0.0);
+    report(std::string("srtp_") + label + "_allocs_per_packet",
+           static_cast<double>(allocs) / (2 * packetCount), "allocs", false, 0.01);
+}
+
+bool benchSrtp() {
+    std::printf("SRTP AEAD_AES_128_GCM (60-byte Opus payload)\n");
+    if (!checkSrtpKernels()) {
+        return false;
+    }
+    // Sequence numbers stay below 65536 so no ROC search skews the receive side
+    constexpr size_t kPackets = 60000;
+    benchSrtpBackend(CryptoBackend::PORTABLE, "portable", kPackets);
+    const CryptoBackend best = AesGcm::bestBackend();
+    if (best != CryptoBackend::PORTABLE) {
+        benchSrtpBackend(best, "hw", kPackets);
+    }
+    return true;
+}
+
+// ============================================================================
+// Floor control
+// ============================================================================
+
+// Deliver every message in out to each peer (their answers are discarded)
+void deliverFloor(const FloorOutbox& out, FloorControl* const* peers, size_t peerCount,
+                  int64_t now, FloorOutbox& answers) {
+    for (size_t i = 0; i < out.count; ++i) {
+        for (size_t p = 0; p < peerCount; ++p) {
+            peers[p]->onMessage(out.packets[i].data(), kFloorMessageBytes, now, answers);
+        }
+    }
+}
+
+void benchFloor() {
+    std::printf("Floor control (%zu-byte RTCP APP, in-process)\n", kFloorMessageBytes);
+    constexpr size_t kRounds = 100000;
+    FloorConfig config;
+    config.enabled = true;
+    FloorControl a;
+    FloorControl b;
+    a.setLocalSsrc(0x1000);
+    b.setLocalSsrc(0x2000);
+    a.configure(config);
+    b.configure(config);
+    FloorEvent events[kFloorEventQueueSize];
+
+    // Press on A with B as the only member: REQUEST -> GRANT -> TAKEN, release
+    const uint64_t allocsBefore = t_allocations;
+    int64_t now = 1000000;
+    size_t granted = 0;
+    FloorControl* peerB[] = {&b};
+    FloorControl* peerA[] = {&a};
+    const auto roundStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kRounds; ++i) {
+        now += 1000;
+        b.onPeerHeard(0x1000, now);
+        a.onPeerHeard(0x2000, now);
+        FloorOutbox request;
+        a.request(0, false, now, request);
+        FloorOutbox answer;
+        deliverFloor(request, peerB, 1, now, answer);
+        FloorOutbox taken;
+        deliverFloor(answer, peerA, 1, now, taken);
+        granted += a.getState() == FloorState::GRANTED;
+        FloorOutbox ignored;
+        deliverFloor(taken, peerB, 1, now, ignored);
+        FloorOutbox release;
+        a.release(now, release);
+        deliverFloor(release, peerB, 1, now, ignored);
+        a.waitEvents(events, kFloorEventQueueSize, 0);
+        b.waitEvents(events, kFloorEventQueueSize, 0);
+    }
+    const double roundNs = elapsedMicros(roundStart) * 1000.0 / kRounds;
+
+    // Simultaneous presses: both REQUESTs cross, A (lower SSRC) wins
+    size_t collisionsWon = 0;
+    const auto collisionStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kRounds; ++i) {
+        now += 1000;
+        FloorOutbox requestA;
+        FloorOutbox requestB;
+        a.request(0, false, now, requestA);
+        b.request(0, false, now, requestB);
+        FloorOutbox answersB;
+        FloorOutbox answersA;
+        deliverFloor(requestA, peerB, 1, now, answersB);
+        deliverFloor(requestB, peerA, 1, now, answersA);
+        FloorOutbox ignored;
+        deliverFloor(answersB, peerA, 1, now, ignored);
+        deliverFloor(answersA, peerB, 1, now, ignored);
+        collisionsWon += a.getState() == FloorState::GRANTED && !b.mayTransmit();
+        FloorOutbox release;
+        a.release(now, release);
+        deliverFloor(release, peerB, 1, now, ignored);
+        a.waitEvents(events, kFloorEventQueueSize, 0);
+        b.waitEvents(events, kFloorEventQueueSize, 0);
+    }
+    const double collisionNs = elapsedMicros(collisionStart) * 1000.0 / kRounds;
+    const uint64_t allocs = t_allocations - allocsBefore;
+
+    report("floor_grant_round_ns", roundNs, "ns", false, 200.0);
+    report("floor_collision_round_ns", collisionNs, "ns", false, 200.0);
+    report("floor_decision_failures",
+           static_cast<double>(2 * kRounds - granted - collisionsWon), "rounds", false, 0.0);
+    report("floor_allocs_per_round", static_cast<double>(allocs) / (2 * kRounds), "allocs",
+           false, 0.01);
+}
+
+void benchRelay() {
+    constexpr size_t kMembers = 8;
+    constexpr size_t kSenders = 4;
+    constexpr size_t kDatagrams = 200000;
+    std::printf("Reflector routing (%zu members, in-process)\n", kMembers);
+
+    RelayConfig reflectorConfig;
+    reflectorConfig.role = RelayRole::REFLECTOR;
+    RtpRelay reflector;
+    reflector.setLocalSsrc(0x1000);
+    int64_t now = 1000000;
+    reflector.configure(reflectorConfig, now);
+
+    RelayConfig memberConfig;
+    memberConfig.role = RelayRole::MEMBER;
+    memberConfig.reflectorAddress = htonl(0x0A000001);
+    for (size_t m = 0; m < kMembers; ++m) {
+        RtpRelay member;
+        member.setLocalSsrc(static_cast<uint32_t>(0x2000 + m));
+        member.configure(memberConfig, now);
+        uint8_t join[kRelayMessageBytes];
+        const size_t length = member.buildMessage(RelayMessageType::JOIN, join);
+        reflector.onMessage(join, length, htonl(static_cast<uint32_t>(0x0A000010 + m)), now);
+    }
+
+    struct sockaddr_in group;
+    std::memset(&group, 0, sizeof(group));
+    group.sin_family = AF_INET;
+    group.sin_port = htons(5004);
+    group.sin_addr.s_addr = htonl(0xEFFF0001);
+
+    // Group talkers' packets, each heard twice (multicast then a member's
+    // copy): the second must not be forwarded
+    uint8_t packet[72] = {0x80, RTP_PAYLOAD_OPUS};
+    RelayTarget targets[kMaxRelayTargets];
+    size_t forwarded = 0;
+    size_t escapes = 0;
+    const uint64_t allocsBefore = t_allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kDatagrams; ++i) {
+        now += 5000;
+        const uint32_t ssrc = htonl(static_cast<uint32_t>(0x3000 + i % kSenders));
+        const uint16_t seq = htons(static_cast<uint16_t>(i / kSenders));
+        std::memcpy(packet + 2, &seq, sizeof(seq));
+        std::memcpy(packet + 8, &ssrc, sizeof(ssrc));
+        forwarded += reflector.route(packet, sizeof(packet), true, true, htonl(0x0A000002),
+                                     group.sin_port, &group, now, targets, kMaxRelayTargets);
+        escapes += reflector.route(packet, sizeof(packet), true, true, htonl(0x0A000010),
+                                   group.sin_port, &group, now, targets, kMaxRelayTargets);
+    }
+    const double routeNs = elapsedMicros(start) * 1000.0 / (2 * kDatagrams);
+    const uint64_t allocs = t_allocations - allocsBefore;
+
+    // SRTP on, a fresh SSRC that has not authenticated, from a non-member:
+    // must not be fanned out
+    const uint32_t stranger = htonl(0x4000);
+    std::memcpy(packet + 8, &stranger, sizeof(stranger));
+    const size_t unverified = reflector.route(packet, sizeof(packet), true, false,
+                                              htonl(0x0A000003), group.sin_port, &group, now,
+                                              targets, kMaxRelayTargets);
+
+    report("relay_route_ns", routeNs, "ns", false, 100.0);
+    report("relay_targets_per_datagram", static_cast<double>(forwarded) / kDatagrams, "targets",
+           true, 0.0);
+    report("relay_duplicate_escapes", static_cast<double>(escapes), "datagrams", false, 0.0);
+    report("relay_unverified_escapes", static_cast<double>(unverified), "datagrams", false, 0.0);
+    report("relay_allocs_per_datagram", static_cast<double>(allocs) / (2 * kDatagrams), "allocs",
+           false, 0.01);
+}
+
+// ============================================================================
+// Codec
+// ============================================================================
+
+struct EncodedFrame {
+    std::vector<uint8_t> bytes;
+};
+
+std::vector<EncodedFrame> benchEncode(const std::vector<int16_t>& pcm) {
+    std::printf("Opus encode (%d samples/frame, %d bps, FEC)\n",
+                OPUS_FRAME_SIZE, OPUS_BITRATE);
+
+    auto encoder = OpusCodecFactory::createEncoder(OpusMode::VOIP);
+    std::vector<EncodedFrame> frames;
+    if (!encoder) {
+        std::fprintf(stderr, "encoder init failed\n");
+        return frames;
+    }
+    encoder->setFEC(true);
+
+    const size_t frameCount = pcm.size() / OPUS_FRAME_SIZE;
+    frames.resize(frameCount);
+    for (auto& frame : frames) {
+        frame.bytes.reserve(OPUS_MAX_PACKET_SIZE);
+    }
+
+    std::vector<double> micros;
+    micros.reserve(frameCount);
+    uint8_t output[OPUS_MAX_PACKET_SIZE];
+    size_t totalBytes = 0;
+
+    const uint64_t allocsBefore = t_allocations;
+    for (size_t i = 0; i < frameCount; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        const int bytes = encoder->encode(pcm.data() + i * OPUS_FRAME_SIZE,
+                                          OPUS_FRAME_SIZE, output, sizeof(output));
+        micros.push_back(elapsedMicros(start));
+        if (bytes > 0) {
+            frames[i].bytes.assign(output, output + bytes);
+            totalBytes += static_cast<size_t>(bytes);
+        }
+    }
+    const uint64_t allocs = t_allocations - allocsBefore;
+
+    reportTimings("encode", micros);
+    report("encode_bytes_per_frame", static_cast<double>(totalBytes) / frameCount, "B", false, 2.0);
+    report("encode_allocs_per_frame", static_cast<double>(allocs) / frameCount, "allocs", false, 0.01);
+    return frames;
+}
+
+void benchDecode(const std::vector<EncodedFrame>& frames) {
+    std::printf("Opus decode / PLC\n");
+
+    auto decoder = OpusCodecFactory::createDecoder();
+    if (!decoder || frames.empty()) {
+        std::fprintf(stderr, "decoder init failed\n");
+        return;
+    }
+
+    std::vector<int16_t> pcm(OPUS_MAX_FRAME_SIZE);
+    std::vector<double> decodeMicros;
+    std::vector<double> plcMicros;
+    decodeMicros.reserve(frames.size());
+    plcMicros.reserve(frames.size() / 10 + 1);
+
+    const uint64_t allocsBefore = t_allocations;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const EncodedFrame& frame = frames[i];
+        auto start = std::chrono::steady_clock::now();
+        decoder->decode(frame.bytes.data(), static_cast<int>(frame.bytes.size()),
+                        pcm.data(), OPUS_MAX_FRAME_SIZE);
+        decodeMicros.push_back(elapsedMicros(start));
+
+        if (i % 10 == 9) {
+            start = std::chrono::steady_clock::now();
+            decoder->decodePLC(pcm.data(), OPUS_FRAME_SIZE);
+            plcMicros.push_back(elapsedMicros(start));
+        }
+    }
+    const uint64_t allocs = t_allocations - allocsBefore;
+
+    reportTimings("decode", decodeMicros);
+    reportTimings("plc", plcMicros);
+    report("decode_allocs_per_frame", static_cast<double>(allocs) / frames.size(), "allocs", false, 0.01);
+}
+
+// ============================================================================
+// Packetizer over loopback
+// ============================================================================
+
+constexpr uint16_t kBenchPort = 47130;
+constexpr size_t kRxCpuSampleInterval = 256;    // Thread CPU read every N packets
+
+// prefix names the metrics of a run with redundancy on ("" for the plain run)
+void benchLoopback(const std::vector<EncodedFrame>& frames, size_t packetCount,
+                   const RedundancyConfig& redundancy = {}, const std::string& prefix = "") {
+    std::printf("RTP loopback (127.0.0.1:%u, %zu packets%s)\n", kBenchPort, packetCount,
+                redundancy.mode == RedundancyMode::RED ? ", RED" : "");
+
+    // Both ends share the port; Linux hands unicast to the socket bound last,
+    // so the sender binds first and the receiver takes the traffic
+    RtpPacketizer sender;
+    sender.addUnicastPeer("127.0.0.1");
+    if (!sender.initialize("239.255.0.1", kBenchPort, TransportMode::UNICAST)) {
+        std::fprintf(stderr, "sender init failed\n");
+        return;
+    }
+    sender.setRedundancy(redundancy);
+    sender.start();
+
+    // Threads under the default policies, as on device (nice -16 needs
+    // RLIMIT_NICE on a host; refused settings only log)
+    auto threads = std::make_shared<ThreadManager>();
+    RtpPacketizer receiver;
+    receiver.setThreadManager(threads);
+    if (!receiver.initialize("239.255.0.1", kBenchPort, TransportMode::UNICAST)) {
+        std::fprintf(stderr, "receiver init failed\n");
+        return;
+    }
+
+    // Receive thread state; only the receive thread writes these
+    std::atomic<uint64_t> received{0};
+    int64_t rxCpuFirst = 0;
+    int64_t rxCpuLast = 0;
+    uint64_t rxCpuPackets = 0;
+    uint64_t rxAllocsFirst = 0;
+    uint64_t rxAllocsLast = 0;
+
+    std::atomic<uint64_t> redundantReceived{0};
+    receiver.setAudioCallback([&](PacketPtr, const RtpPacketInfo& info) {
+        if (info.redundant) {
+            redundantReceived.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const uint64_t n = received.fetch_add(1, std::memory_order_relaxed);
+        if (n == 0) {
+            rxCpuFirst = threadCpuMicros();
+            rxAllocsFirst = t_allocations;
+        } else if (n % kRxCpuSampleInterval == 0) {
+            rxCpuLast = threadCpuMicros();
+            rxAllocsLast = t_allocations;
+            rxCpuPackets = n;
+        }
+    });
+    receiver.start();
+    receiver.startReceiveLoop();
+
+    // Bursts the size of a busy talk group, paced so the socket buffer keeps up
+    constexpr size_t kBurst = 64;
+    const uint64_t allocsBefore = t_allocations;
+    int64_t txCpu = 0;
+    for (size_t sent = 0; sent < packetCount; sent += kBurst) {
+        const int64_t cpuStart = threadCpuMicros();
+        for (size_t i = sent; i < std::min(packetCount, sent + kBurst); ++i) {
+            const EncodedFrame& frame = frames[i % frames.size()];
+            sender.sendAudio(frame.bytes.data(), frame.bytes.size());
+        }
+        txCpu += threadCpuMicros() - cpuStart;
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    const uint64_t txAllocs = t_allocations - allocsBefore;
+
+    const int64_t deadline = nowMicros() + 1000000;
+    while (received.load() < packetCount && nowMicros() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    receiver.stop();
+    sender.stop();
+
+    const double delivered = static_cast<double>(received.load());
+    report(prefix + "tx_packets_per_cpu_s", txCpu > 0 ? packetCount * 1e6 / txCpu : 0.0, "pps", true);
+    report(prefix + "tx_allocs_per_packet", static_cast<double>(txAllocs) / packetCount,
+           "allocs", false, 0.01);
+    if (rxCpuPackets > 0 && rxCpuLast > rxCpuFirst) {
+        report(prefix + "rx_packets_per_cpu_s", rxCpuPackets * 1e6 / (rxCpuLast - rxCpuFirst),
+               "pps", true);
+        report(prefix + "rx_allocs_per_packet",
+               static_cast<double>(rxAllocsLast - rxAllocsFirst) / rxCpuPackets, "allocs", false, 0.01);
+    }
+    report(prefix + "loopback_delivered_pct", 100.0 * delivered / packetCount, "%", true, 1.0);
+    if (redundancy.mode == RedundancyMode::RED) {
+        TelemetrySnapshot telemetry;
+        sender.getTelemetry(telemetry);
+        report(prefix + "overhead_bytes_per_packet",
+               static_cast<double>(telemetry.redundancy.bytesSent) / packetCount, "B", false, 1.0);
+        report(prefix + "copies_per_packet",
+               delivered > 0 ? redundantReceived.load() / delivered : 0.0, "copies", true, 0.05);
+    } else {
+        report("rx_batch_avg_packets",
+               receiver.getReceiveBatches() ? delivered / receiver.getReceiveBatches() : 0.0,
+               "pkts", true, 0.5);
+
+        ThreadInfo info[kThreadRoleCount];
+        const size_t count = threads->getThreadInfo(info, kThreadRoleCount);
+        const ThreadInfo& network = info[static_cast<size_t>(ThreadRole::NETWORK)];
+        if (count > static_cast<size_t>(ThreadRole::NETWORK) && network.wakeSamples > 0) {
+            report("rx_wake_mean_us",
+                   static_cast<double>(network.totalMicros) / network.wakeSamples, "us", false, 50.0);
+            report("rx_wake_over_budget_pct",
+                   100.0 * network.overBudget / network.wakeSamples, "%", false, 1.0);
+        }
+    }
+}
+
+// Poll-sleep overshoot of an encoder-style worker (kEncoderPollIntervalMs sleeps)
+void benchWorkerWake() {
+    constexpr uint32_t kSleepMs = 5;
+    constexpr int kSleeps = 200;
+    std::printf("Worker wakeup (%d x %u ms poll sleeps)\n", kSleeps, kSleepMs);
+
+    ThreadManager threads;
+    std::thread worker([&]() {
+        ThreadScope scope(&threads, ThreadRole::ENCODER, "bench-worker");
+        for (int i = 0; i < kSleeps; ++i) {
+            scope.sleepFor(kSleepMs);
+        }
+    });
+    worker.join();
+
+    ThreadInfo info[kThreadRoleCount];
+    threads.getThreadInfo(info, kThreadRoleCount);
+    const ThreadInfo& encoder = info[static_cast<size_t>(ThreadRole::ENCODER)];
+    report("worker_wake_mean_us",
+           encoder.wakeSamples ? static_cast<double>(encoder.totalMicros) / encoder.wakeSamples : 0.0,
+           "us", false, 50.0);
+    report("worker_wake_over_budget_pct",
+           encoder.wakeSamples ? 100.0 * encoder.overBudget / encoder.wakeSamples : 0.0, "%", false, 2.0);
+}
+
+// One timer re-armed every kLoopTimerMicros, as the RTCP/floor/relay services do
+void benchEventLoop() {
+    constexpr int64_t kLoopTimerMicros = 1000;
+    constexpr uint64_t kExpiries = 500;
+    std::printf("Event loop (%d x %d us timers)\n", static_cast<int>(kExpiries),
+                static_cast<int>(kLoopTimerMicros));
+
+    EventLoop loop;
+    if (!loop.initialize()) {
+        std::fprintf(stderr, "event loop init failed\n");
+        return;
+    }
+    std::atomic<uint64_t> fired{0};
+    int64_t due = 0;
+    uint64_t allocsFirst = 0;
+    uint64_t allocsLast = 0;
+    loop.addTimer([&](int64_t nowMicros) -> int64_t {
+        if (due != 0 && nowMicros >= due) {
+            const uint64_t n = fired.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (n == 1) {
+                allocsFirst = t_allocations;
+            }
+            allocsLast = t_allocations;
+            if (n >= kExpiries) {
+                return 0;
+            }
+            due = 0;
+        }
+        if (due == 0) {
+            due = nowMicros + kLoopTimerMicros;
+        }
+        return due;
+    });
+    loop.start(nullptr, ThreadRole::COUNT, "bench-loop");
+
+    const int64_t deadline = nowMicros() + 5000000;
+    while (fired.load() < kExpiries && nowMicros() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const int64_t stopStart = nowMicros();
+    loop.stop();
+    const int64_t stopMicros = nowMicros() - stopStart;
+
+    const EventLoopStats stats = loop.getStats();
+    report("loop_timer_late_mean_us",
+           stats.timerExpiries ? static_cast<double>(stats.totalTimerLateMicros) / stats.timerExpiries : 0.0,
+           "us", false, 50.0);
+    report("loop_timer_late_max_us", static_cast<double>(stats.maxTimerLateMicros), "us", false, 2000.0);
+    report("loop_allocs_per_pass",
+           stats.passes ? static_cast<double>(allocsLast - allocsFirst) / stats.passes : 0.0,
+           "allocs", false, 0.01);
+    report("loop_stop_us", static_cast<double>(stopMicros), "us", false, 1000.0);
+}
+
+// ============================================================================
+// Recording tap
+// ============================================================================
+
+void benchRecorder(const std::vector<EncodedFrame>& frames) {
+    constexpr size_t kChannels = 8;
+    constexpr uint32_t kAudioSeconds = 600;     // Per channel
+    constexpr uint32_t kBurstSeconds = 10;      // Then the next talker keys up
+    std::printf("Recording tap (%zu channels, %u s each)\n", kChannels, kAudioSeconds);
+
+    char dir[] = "/tmp/meshriderptt_rec_XXXXXX";
+    if (!mkdtemp(dir) || frames.empty()) {
+        std::fprintf(stderr, "recording directory failed\n");
+        return;
+    }
+    VoiceRecorder recorder;
+    RecordingConfig config;
+    config.directory = dir;
+    if (!recorder.start(config)) {
+        return;
+    }
+
+    const uint32_t framesPerSecond = 1000 / PttAudioFormat::kFrameDurationMs;
+    const size_t packets = size_t{kAudioSeconds} * framesPerSecond;
+    size_t fed = 0;
+    uint64_t allocs = 0;
+    const int64_t cpuStart = threadCpuMicros();
+    for (size_t i = 0; i < packets; ++i) {
+        const uint32_t talker = static_cast<uint32_t>(i / (size_t{kBurstSeconds} * framesPerSecond));
+        const EncodedFrame& frame = frames[i % frames.size()];
+        if (frame.bytes.empty()) {
+            continue;
+        }
+        for (uint32_t channel = 0; channel < kChannels; ++channel) {
+            RtpPacketInfo info;
+            info.seq = static_cast<uint16_t>(i);
+            info.timestamp = static_cast<uint32_t>(i * PttAudioFormat::kRtpTimestampIncrement);
+            info.ssrc = 0x5000 + channel * 0x100 + talker;
+            info.marker = false;
+            info.channel = channel;
+            const uint64_t before = t_allocations;
+            recorder.onPacket(info, frame.bytes.data(), frame.bytes.size());
+            allocs += t_allocations - before;
+            fed++;
+        }
+        // Storage keeps up with real time on device; pace the producer so
+        // the block pool is not what is being measured
+        if (i % 500 == 499) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    // Receive-thread CPU only (the pacing sleeps and the I/O thread excluded)
+    const double packetNs = (threadCpuMicros() - cpuStart) * 1000.0 / std::max<size_t>(fed, 1);
+    recorder.stop();
+    const RecordingStats stats = recorder.getStats();
+    std::system((std::string("rm -rf ") + dir).c_str());
+
+    const double audioMinutes = kChannels * kAudioSeconds / 60.0;
+    report("recorder_packet_ns", packetNs, "ns", false, 200.0);
+    report("recorder_writes_per_audio_minute", stats.writes / audioMinutes, "writes", false, 0.5);
+    report("recorder_avg_write_kib",
+           stats.writes > 0 ? stats.bytesWritten / 1024.0 / stats.writes : 0.0, "KiB", true, 4.0);
+    report("recorder_dropped_packets", static_cast<double>(stats.droppedPackets), "packets", false, 0.0);
+    report("recorder_allocs_per_packet", static_cast<double>(allocs) / std::max<size_t>(fed, 1),
+           "allocs", false, 0.01);
+}
+
+// ============================================================================
+// Receive memory
+// ============================================================================
+
+// Returns false if steady state allocated anything
+bool benchMemory(const std::vector<EncodedFrame>& frames) {
+    constexpr uint32_t kTalkers = 8;
+    constexpr size_t kWarmupTicks = 250;        // Slots assigned, buffers at target depth
+    constexpr size_t kSteadyTicks = 3000;       // One minute of 8 simultaneous talkers
+    std::printf("Receive memory (%u talkers, default budget)\n", kTalkers);
+
+    ReceiveStreamTable table(PttAudioFormat::kFrameDurationMs);
+    if (!table.initialize() || frames.empty()) {
+        std::fprintf(stderr, "stream table initialize failed\n");
+        return false;
+    }
+    const std::shared_ptr<PacketPool> pool = table.getPacketPool();
+    constexpr size_t kFrameSamples =
+        PttAudioFormat::kSampleRate * PttAudioFormat::kFrameDurationMs / 1000;
+    std::vector<int16_t> output(kFrameSamples);
+
+    uint64_t allocs = 0;
+    MemoryStats before;
+    for (size_t tick = 0; tick < kWarmupTicks + kSteadyTicks; ++tick) {
+        if (tick == kWarmupTicks) {
+            before = table.getMemoryStats();
+        }
+        const uint64_t allocsBefore = t_allocations;
+        const EncodedFrame& frame = frames[tick % frames.size()];
+        for (uint32_t talker = 0; talker < kTalkers && !frame.bytes.empty(); ++talker) {
+            // As the receive loop hands it over: an MTU buffer, payload located
+            PacketPtr packet = pool->acquire();
+            if (!packet) {
+                continue;
+            }
+            std::memcpy(packet->data, frame.bytes.data(), frame.bytes.size());
+            packet->length = static_cast<uint16_t>(frame.bytes.size());
+            packet->payloadOffset = 0;
+            packet->payloadLength = packet->length;
+            RtpPacketInfo info;
+            info.seq = static_cast<uint16_t>(tick);
+            info.timestamp = static_cast<uint32_t>(tick * PttAudioFormat::kRtpTimestampIncrement);
+            info.ssrc = 0x7000 + talker;
+            info.marker = tick == 0;
+            table.enqueue(std::move(packet), info);
+        }
+        table.render(output.data(), output.size());
+        if (tick >= kWarmupTicks) {
+            allocs += t_allocations - allocsBefore;
+        }
+    }
+    const MemoryStats after = table.getMemoryStats();
+
+    uint64_t exhausted = 0;
+    for (size_t c = 0; c < kPacketClassCount; ++c) {
+        exhausted += after.pool.exhausted[c] - before.pool.exhausted[c];
+    }
+    const uint64_t steadyAllocs = allocs + exhausted +
+                                  (after.lateAllocations - before.lateAllocations);
+    const double packets = static_cast<double>(kSteadyTicks) * kTalkers;
+    report("memory_reserved_kib", after.reservedBytes / 1024.0, "KiB", false, 16.0);
+    report("memory_stream_slots", static_cast<double>(after.streamSlots), "slots", true, 0.0);
+    report("memory_compacted_pct", 100.0 * (after.pool.compacted - before.pool.compacted) / packets,
+           "%", true, 1.0);
+    report("memory_steady_allocs", static_cast<double>(steadyAllocs), "allocs", false, 0.0);
+    if (steadyAllocs != 0) {
+        std::fprintf(stderr, "steady state allocated %llu times (heap %llu, pool fallback %llu)\n",
+                     static_cast<unsigned long long>(steadyAllocs),
+                     static_cast<unsigned long long>(allocs),
+                     static_cast<unsigned long long>(exhausted));
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Jitter buffer trace replay
+// ============================================================================
+
+// Synthetic traces have a fixed length so runs with different --seconds compare
+constexpr size_t kSyntheticTraceSeconds = 120;
+
+struct TraceEntry {
+    uint16_t seq;
+    double sendMs;
+    double arrivalMs;
+};
+
+struct Trace {
+    std::string name;
+    std::vector<TraceEntry> entries;    // Received packets only, any order
+    size_t sentCount = 0;
+};
+
+// Run frames packets through an impairment model (the one RtpPacketizer uses)
+Trace makeTrace(const std::string& name, size_t frames, NetworkImpairment& impairment,
+                uint32_t frameMs = PttAudioFormat::kFrameDurationMs) {
+    Trace trace;
+    trace.name = name;
+    trace.sentCount = frames;
+    for (size_t i = 0; i < frames; ++i) {
+        const double sendMs = static_cast<double>(i * frameMs);
+        const ImpairmentDecision decision = impairment.next();
+        if (decision.drop) {
+            continue;
+        }
+        const uint16_t seq = static_cast<uint16_t>(i);
+        trace.entries.push_back({seq, sendMs, sendMs + decision.delayMicros / 1000.0});
+        if (decision.duplicate) {
+            trace.entries.push_back({seq, sendMs, sendMs + decision.duplicateDelayMicros / 1000.0});
+        }
+    }
+    return trace;
+}
+
+Trace makeTrace(const std::string& name, size_t frames, const ImpairmentProfile& profile,
+                uint32_t frameMs = PttAudioFormat::kFrameDurationMs) {
+    NetworkImpairment impairment(profile);
+    return makeTrace(name, frames, impairment, frameMs);
+}
+
+std::vector<Trace> syntheticTraces(size_t frames) {
+    std::vector<Trace> traces;
+
+    ImpairmentProfile clean;
+    clean.seed = 0x5eed;
+    clean.delayMs = 5;
+    clean.jitterMs = 1;
+    traces.push_back(makeTrace("clean", frames, clean));
+
+    // Mesh hop queueing: heavy-tailed jitter, reorders whenever it exceeds a frame
+    ImpairmentProfile jitter = clean;
+    jitter.delayMs = 10;
+    jitter.jitterMs = 20;
+    jitter.jitter = JitterDistribution::NORMAL;
+    traces.push_back(makeTrace("jitter", frames, jitter));
+
+    ImpairmentProfile pareto = jitter;
+    pareto.jitterMs = 15;
+    pareto.jitter = JitterDistribution::PARETO;
+    traces.push_back(makeTrace("pareto", frames, pareto));
+
+    // Gilbert-Elliott bursts (~6% loss in 3-4 packet bursts)
+    ImpairmentProfile burst = clean;
+    burst.delayMs = 8;
+    burst.jitterMs = 2;
+    burst.burstEnterPercent = 3.0f;
+    burst.burstExitPercent = 30.0f;
+    burst.burstLossPercent = 80.0f;
+    traces.push_back(makeTrace("burst_loss", frames, burst));
+
+    // Route flaps: 5% of packets take a path 40 ms longer
+    ImpairmentProfile reorder = burst;
+    reorder.burstEnterPercent = 0.0f;
+    reorder.reorderPercent = 5.0f;
+    reorder.reorderDelayMs = 40;
+    reorder.duplicatePercent = 1.0f;
+    traces.push_back(makeTrace("reorder", frames, reorder));
+    return traces;
+}
+
+/**
+ * Replay one trace: packets enter at their arrival time, playout pulls one
+ * frame per frame period, exactly as the decoder thread does (including
+ * the two-frame RECOVER hand-off). Latency is send -> playout of each frame.
+ */
+void replayTrace(const Trace& trace, uint16_t redDepth = 0) {
+    if (trace.entries.empty()) {
+        return;
+    }
+
+    std::vector<TraceEntry> arrivals = trace.entries;
+    std::stable_sort(arrivals.begin(), arrivals.end(),
+                     [](const TraceEntry& a, const TraceEntry& b) { return a.arrivalMs < b.arrivalMs; });
+
+    std::map<uint16_t, double> sendTimes;
+    for (const TraceEntry& entry : trace.entries) {
+        sendTimes[entry.seq] = entry.sendMs;
+    }
+    for (const TraceEntry& entry : trace.entries) {
+        for (uint16_t d = 1; d <= redDepth && d <= entry.seq; ++d) {
+            sendTimes.emplace(static_cast<uint16_t>(entry.seq - d),
+                              entry.sendMs - d * PttAudioFormat::kFrameDurationMs);
+        }
+    }
+
+    auto pool = std::make_shared<PacketPool>(RtpJitterBuffer::kSlotCount * 2);
+    RtpJitterBuffer jitterBuffer;
+    std::vector<double> latencyMs;
+    latencyMs.reserve(trace.sentCount);
+
+    const double frameMs = PttAudioFormat::kFrameDurationMs;
+    const double startMs = arrivals.front().arrivalMs;
+    const double endMs = arrivals.back().arrivalMs + 20 * frameMs;
+    size_t next = 0;
+    size_t concealed = 0;
+    size_t recovered = 0;
+    size_t rebuffered = 0;      // Underflow mid-stream (after the first frame played)
+    size_t ticks = 0;
+    PacketPtr pending;
+
+    auto seqOf = [](const PacketPtr& packet) {
+        return static_cast<uint16_t>(packet->data[0] | (packet->data[1] << 8));
+    };
+    // framesBack = 1 for the lost frame a RECOVER rebuilds (sent one period earlier)
+    auto played = [&](const PacketPtr& packet, double nowMs, int framesBack) {
+        latencyMs.push_back(nowMs - (sendTimes[seqOf(packet)] - framesBack * frameMs));
+    };
+
+    const uint64_t allocsBefore = t_allocations;
+    for (double nowMs = startMs; nowMs < endMs; nowMs += frameMs, ++ticks) {
+        while (next < arrivals.size() && arrivals[next].arrivalMs <= nowMs) {
+            const TraceEntry& entry = arrivals[next++];
+            PacketPtr packet = pool->acquire();
+            if (!packet) {
+                continue;
+            }
+            packet->data[0] = static_cast<uint8_t>(entry.seq & 0xFF);
+            packet->data[1] = static_cast<uint8_t>(entry.seq >> 8);
+            packet->payloadOffset = 0;
+            packet->payloadLength = 2;
+            const RtpPacketInfo info{entry.seq,
+                                     static_cast<uint32_t>(entry.sendMs * RTP_CLOCK_RATE / 1000.0),
+                                     0x1234, false};
+            jitterBuffer.enqueue(std::move(packet), info,
+                                 static_cast<int64_t>(entry.arrivalMs * 1000.0));
+
+            // RED: the copies of the preceding frames ride in the same datagram
+            for (uint16_t d = 1; d <= redDepth && d <= entry.seq; ++d) {
+                PacketPtr copy = pool->acquire();
+                if (!copy) {
+                    break;
+                }
+                RtpPacketInfo copyInfo = info;
+                copyInfo.seq = static_cast<uint16_t>(entry.seq - d);
+                copyInfo.timestamp -= d * PttAudioFormat::kRtpTimestampIncrement;
+                copyInfo.redundant = true;
+                copy->data[0] = static_cast<uint8_t>(copyInfo.seq & 0xFF);
+                copy->data[1] = static_cast<uint8_t>(copyInfo.seq >> 8);
+                copy->payloadOffset = 0;
+                copy->payloadLength = 2;
+                jitterBuffer.enqueue(std::move(copy), copyInfo,
+                                     static_cast<int64_t>(entry.arrivalMs * 1000.0));
+            }
+        }
+
+        if (pending) {
+            played(pending, nowMs, 0);
+            pending.reset();
+            continue;
+        }
+        PacketPtr packet;
+        switch (jitterBuffer.dequeue(packet)) {
+            case JitterResult::PACKET:
+                played(packet, nowMs, 0);
+                break;
+            case JitterResult::RECOVER:
+                // In-band FEC rebuilds the lost frame now, the packet itself plays next
+                played(packet, nowMs, 1);
+                jitterBuffer.noteRecovery(true);
+                recovered++;
+                pending = std::move(packet);
+                break;
+            case JitterResult::CONCEAL:
+                concealed++;
+                break;
+            case JitterResult::BUFFERING:
+                if (!latencyMs.empty() && next < arrivals.size()) {
+                    rebuffered++;
+                }
+                break;
+        }
+    }
+    const uint64_t allocs = t_allocations - allocsBefore;
+
+    const JitterBufferStats stats = jitterBuffer.getStats();
+    const std::string prefix = "jb_" + trace.name +
+                               (redDepth > 0 ? "_red" + std::to_string(redDepth) : "");
+    const double sent = static_cast<double>(trace.sentCount);
+    report(prefix + "_latency_mean_ms", mean(latencyMs), "ms", false, 2.0);
+    report(prefix + "_latency_p95_ms", percentile(latencyMs, 95), "ms", false, 2.0);
+    report(prefix + "_played_pct", 100.0 * latencyMs.size() / sent, "%", true, 0.5);
+    report(prefix + "_concealed_pct", 100.0 * concealed / sent, "%", false, 0.5);
+    report(prefix + "_fec_recovered_pct", 100.0 * recovered / sent, "%", true, 0.5);
+    report(prefix + "_rebuffer_pct", 100.0 * rebuffered / sent, "%", false, 0.5);
+    report(prefix + "_late_pct", 100.0 * stats.packetsLate / sent, "%", false, 0.5);
+    report(prefix + "_allocs_per_frame", static_cast<double>(allocs) / ticks, "allocs", false, 0.01);
+    if (redDepth > 0) {
+        report(prefix + "_redundant_used_pct", 100.0 * stats.redundantUsed / sent, "%", true, 0.5);
+    }
+}
+
+// ============================================================================
+// Codec profiles
+// ============================================================================
+
+constexpr uint32_t kProfileOverheadBytes = 20 + 8 + RTP_HEADER_SIZE;    // IPv4 + UDP + RTP
+
+// Payload plus headers per second of speech at the profile's fixed settings
+double profileAirKbps(const CodecProfile& profile, const std::vector<int16_t>& speech) {
+    auto encoder = OpusCodecFactory::createEncoder(profile.mode);
+    if (!encoder) {
+        return 0.0;
+    }
+    const EncoderSettings& settings = profile.encoder;
+    encoder->setBitrate(settings.bitrate);
+    encoder->setFEC(settings.fec);
+    encoder->setPacketLossPercent(settings.packetLossPercent);
+    encoder->setComplexity(settings.complexity);
+
+    const size_t frameSamples = PttAudioFormat::kSampleRate / 1000 * settings.frameDurationMs;
+    uint8_t output[OPUS_MAX_PACKET_SIZE];
+    size_t frames = 0;
+    size_t bytes = 0;
+    for (size_t pos = 0; pos + frameSamples <= speech.size(); pos += frameSamples) {
+        const int n = encoder->encode(speech.data() + pos, static_cast<int>(frameSamples),
+                                      output, sizeof(output));
+        if (n > 0) {
+            bytes += static_cast<size_t>(n) + kProfileOverheadBytes;
+            frames++;
+        }
+    }
+    const double seconds = frames * settings.frameDurationMs / 1000.0;
+    return seconds > 0.0 ? 8.0 * bytes / seconds / 1000.0 : 0.0;
+}
+
+/**
+ * One profile on one link: the jitter buffer at the profile's frame size
+ * and delay bounds on a virtual clock, scored by CallQualityMonitor with
+ * the mean send -> playout delay plus one frame of packetization as the
+ * mouth-to-ear input. FEC recovers a loss only if the profile enables it.
+ */
+ProfileQuality replayProfile(size_t index, const ImpairmentProfile& link, size_t seconds) {
+    const CodecProfile& profile = kCodecProfiles[index];
+    const uint32_t frameMs = profile.encoder.frameDurationMs;
+    const Trace trace = makeTrace("", seconds * 1000 / frameMs, link, frameMs);
+
+    std::vector<TraceEntry> arrivals = trace.entries;
+    std::stable_sort(arrivals.begin(), arrivals.end(),
+                     [](const TraceEntry& a, const TraceEntry& b) { return a.arrivalMs < b.arrivalMs; });
+    std::map<uint16_t, double> sendTimes;
+    for (const TraceEntry& entry : trace.entries) {
+        sendTimes[entry.seq] = entry.sendMs;
+    }
+
+    auto pool = std::make_shared<PacketPool>(RtpJitterBuffer::kSlotCount * 2);
+    RtpJitterBuffer jitterBuffer(frameMs);
+    jitterBuffer.setDelayBounds(profile.minDelayMs, profile.maxDelayMs);
+    std::vector<double> latencyMs;
+    latencyMs.reserve(trace.sentCount);
+
+    auto seqOf = [](const PacketPtr& packet) {
+        return static_cast<uint16_t>(packet->data[0] | (packet->data[1] << 8));
+    };
+    auto played = [&](const PacketPtr& packet, double nowMs, int framesBack) {
+        latencyMs.push_back(nowMs - (sendTimes[seqOf(packet)] - framesBack * frameMs) + frameMs);
+    };
+
+    const double endMs = arrivals.empty() ? 0.0 : arrivals.back().arrivalMs + 20 * frameMs;
+    size_t next = 0;
+    PacketPtr pending;
+    for (double nowMs = arrivals.empty() ? 0.0 : arrivals.front().arrivalMs; nowMs < endMs;
+         nowMs += frameMs) {
+        while (next < arrivals.size() && arrivals[next].arrivalMs <= nowMs) {
+            const TraceEntry& entry = arrivals[next++];
+            PacketPtr packet = pool->acquire();
+            if (!packet) {
+                continue;
+            }
+            packet->data[0] = static_cast<uint8_t>(entry.seq & 0xFF);
+            packet->data[1] = static_cast<uint8_t>(entry.seq >> 8);
+            packet->payloadOffset = 0;
+            packet->payloadLength = 2;
+            const RtpPacketInfo info{entry.seq,
+                                     static_cast<uint32_t>(entry.sendMs * RTP_CLOCK_RATE / 1000.0),
+                                     0x1234, false};
+            jitterBuffer.enqueue(std::move(packet), info,
+                                 static_cast<int64_t>(entry.arrivalMs * 1000.0));
+        }
+
+        if (pending) {
+            played(pending, nowMs, 0);
+            pending.reset();
+            continue;
+        }
+        PacketPtr packet;
+        switch (jitterBuffer.dequeue(packet)) {
+            case JitterResult::PACKET:
+                played(packet, nowMs, 0);
+                break;
+            case JitterResult::RECOVER:
+                // Without FEC the lost frame is concealed; the packet plays next either way
+                if (profile.encoder.fec) {
+                    played(packet, nowMs, 1);
+                }
+                jitterBuffer.noteRecovery(profile.encoder.fec);
+                pending = std::move(packet);
+                break;
+            case JitterResult::CONCEAL:
+            case JitterResult::BUFFERING:
+                break;
+        }
+    }
+
+    CallQualityMonitor monitor;
+    monitor.setPathDelay(mean(latencyMs), 0.0, 0.0);
+    monitor.recordStream(index, jitterBuffer.getStats(), frameMs);
+    return monitor.getResults()[index];
+}
+
+void benchProfiles(const std::vector<int16_t>& speech) {
+    std::printf("Codec profiles (E-model, %zu s per link)\n", kSyntheticTraceSeconds);
+
+    ImpairmentProfile clean;
+    clean.seed = 0x5eed;
+    clean.delayMs = 5;
+    clean.jitterMs = 1;
+
+    // Queueing jitter and Gilbert-Elliott bursts together, as on a loaded mesh
+    ImpairmentProfile mesh = clean;
+    mesh.delayMs = 10;
+    mesh.jitterMs = 15;
+    mesh.jitter = JitterDistribution::NORMAL;
+    mesh.burstEnterPercent = 3.0f;
+    mesh.burstExitPercent = 30.0f;
+    mesh.burstLossPercent = 80.0f;
+
+    const std::pair<const char*, const ImpairmentProfile*> links[] = {
+        { "clean", &clean }, { "mesh", &mesh },
+    };
+    for (size_t i = 0; i < kCodecProfileCount; ++i) {
+        std::string prefix = std::string("profile_") + kCodecProfiles[i].name;
+        std::replace(prefix.begin(), prefix.end(), '-', '_');
+        report(prefix + "_air_kbps", profileAirKbps(kCodecProfiles[i], speech), "kbps", false, 1.0);
+        for (const auto& link : links) {
+            const ProfileQuality q = replayProfile(i, *link.second, kSyntheticTraceSeconds);
+            const std::string name = prefix + "_" + link.first;
+            const double lossPct = q.framesScored > 0
+                ? 100.0 * q.framesLost / q.framesScored : 0.0;
+            report(name + "_mos", q.meanMos, "MOS", true, 0.05);
+            report(name + "_delay_ms", q.meanDelayMs, "ms", false, 2.0);
+            report(name + "_loss_pct", lossPct, "%", false, 0.5);
+        }
+    }
+}
+
+// ============================================================================
+// Baseline comparison
+// ============================================================================
+
+bool writeResults(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "# meshriderptt_bench results (metric value)\n";
+    for (const Metric& metric : g_results) {
+        out << metric.name << ' ' << metric.value << '\n';
+    }
+    return true;
+}
+
+// Returns the number of regressed metrics
+int compareBaseline(const std::string& path, double tolerancePct) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "cannot read baseline %s\n", path.c_str());
+        return 1;
+    }
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name;
+        double value;
+        if (fields >> name >> value) {
+            baseline[name] = value;
+        }
+    }
+
+    std::printf("Baseline %s (tolerance %.1f%%)\n", path.c_str(), tolerancePct);
+    const double tolerance = tolerancePct / 100.0;
+    int regressions = 0;
+    for (const Metric& metric : g_results) {
+        auto it = baseline.find(metric.name);
+        if (it == baseline.end()) {
+            continue;
+        }
+        const double base = it->second;
+        const bool regressed = metric.higherIsBetter
+            ? metric.value < base * (1.0 - tolerance) - metric.slack
+            : metric.value > base * (1.0 + tolerance) + metric.slack;
+        if (regressed) {
+            regressions++;
+            std::printf("  REGRESSION %-25s %12.3f -> %12.3f %s\n",
+                        metric.name.c_str(), base, metric.value, metric.unit);
+        }
+    }
+    if (regressions == 0) {
+        std::printf("  no regressions\n");
+    }
+    return regressions;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "usage: %s [--seconds N] [--trace FILE]... [--out FILE]\n"
+        "          [--baseline FILE] [--tolerance PCT] [--verbose]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = 60.0;
+    double tolerancePct = 15.0;
+    std::vector<std::string> tracePaths;
+    std::string outPath;
+    std::string baselinePath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--seconds" && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            tracePaths.emplace_back(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--tolerance" && hasValue) {
+            tolerancePct = std::atof(argv[++i]);
+        } else if (arg == "--verbose") {
+            pttHostLogLevel().store(ANDROID_LOG_INFO);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::printf("meshriderptt_bench: %s, %u ms frames, %.0f s of speech\n",
+                OpusCodecFactory::getVersion(), PttAudioFormat::kFrameDurationMs, seconds);
+
+    SpeechSynth synth(0xC0FFEE);
+    const std::vector<int16_t> speech = synth.generate(
+        static_cast<size_t>(seconds * PttAudioFormat::kSampleRate));
+
+    benchDsp(speech);
+    if (!benchSrtp()) {
+        return 1;
+    }
+    benchFloor();
+    benchRelay();
+    benchWorkerWake();
+    benchEventLoop();
+
+    const std::vector<EncodedFrame> frames = benchEncode(speech);
+    if (frames.empty()) {
+        return 1;
+    }
+    benchDecode(frames);
+    benchRecorder(frames);
+    if (!benchMemory(frames)) {
+        return 1;
+    }
+    benchLoopback(frames, std::max<size_t>(frames.size() * 10, 20000));
+    RedundancyConfig red;
+    red.mode = RedundancyMode::RED;
+    red.depth = 2;
+    benchLoopback(frames, std::max<size_t>(frames.size() * 10, 20000), red, "red2_");
+
+    std::printf("Jitter buffer replay (%u ms frames)\n", PttAudioFormat::kFrameDurationMs);
+    for (const Trace& trace : syntheticTraces(
+             kSyntheticTraceSeconds * 1000 / PttAudioFormat::kFrameDurationMs)) {
+        replayTrace(trace);
+        if (trace.name == "burst_loss") {
+            replayTrace(trace, 2);
+        }
+    }
+    benchProfiles(speech);
+
+    for (const std::string& path : tracePaths) {
+        NetworkImpairment impairment(ImpairmentProfile{});
+        if (!impairment.loadTrace(path.c_str())) {
+            std::fprintf(stderr, "cannot read trace %s\n", path.c_str());
+            return 1;
+        }
+        replayTrace(makeTrace(path.substr(path.find_last_of('/') + 1),
+                              impairment.getTraceLength(), impairment));
+    }
+
+    if (!outPath.empty() && !writeResults(outPath)) {
+        std::fprintf(stderr, "cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    if (!baselinePath.empty() && compareBaseline(baselinePath, tolerancePct) > 0) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,316 @@
+/*
+ * Mesh Rider Wave - AES-GCM: portable kernels and mode logic
+ * Hardware kernels live in AesGcmArmv8.cpp / AesGcmX86.cpp
+ */
+
+#include "AesGcm.h"
+#include <cstring>
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+constexpr uint8_t kSbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+inline uint8_t xtime(uint8_t x) {
+    return static_cast<uint8_t>((x << 1) ^ (0x1B & -(x >> 7)));
+}
+
+inline uint64_t loadBe64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline void storeBe64(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+inline void increment32(uint8_t counter[kAesBlockBytes]) {
+    for (int i = 15; i >= 12; --i) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+// FIPS-197 5.1 on a column-major state
+void portableEncryptBlock(const uint8_t* roundKeys, int rounds,
+                          const uint8_t in[kAesBlockBytes], uint8_t out[kAesBlockBytes]) {
+    uint8_t s[kAesBlockBytes];
+    for (size_t i = 0; i < kAesBlockBytes; ++i) {
+        s[i] = in[i] ^ roundKeys[i];
+    }
+    for (int round = 1; round <= rounds; ++round) {
+        uint8_t t[kAesBlockBytes];
+        // SubBytes + ShiftRows: row r rotates left by r columns
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                t[c * 4 + r] = kSbox[s[((c + r) & 3) * 4 + r]];
+            }
+        }
+        if (round != rounds) {
+            for (int c = 0; c < 4; ++c) {
+                uint8_t* col = t + c * 4;
+                const uint8_t all = col[0] ^ col[1] ^ col[2] ^ col[3];
+                const uint8_t first = col[0];
+                col[0] ^= all ^ xtime(col[0] ^ col[1]);
+                col[1] ^= all ^ xtime(col[1] ^ col[2]);
+                col[2] ^= all ^ xtime(col[2] ^ col[3]);
+                col[3] ^= all ^ xtime(col[3] ^ first);
+            }
+        }
+        const uint8_t* key = roundKeys + round * kAesBlockBytes;
+        for (size_t i = 0; i < kAesBlockBytes; ++i) {
+            s[i] = t[i] ^ key[i];
+        }
+    }
+    std::memcpy(out, s, kAesBlockBytes);
+}
+
+void portableCtr32(const uint8_t* roundKeys, int rounds, const uint8_t counter[kAesBlockBytes],
+                   const uint8_t* in, uint8_t* out, size_t bytes) {
+    uint8_t block[kAesBlockBytes];
+    uint8_t keystream[kAesBlockBytes];
+    std::memcpy(block, counter, kAesBlockBytes);
+    while (bytes > 0) {
+        portableEncryptBlock(roundKeys, rounds, block, keystream);
+        const size_t n = bytes < kAesBlockBytes ? bytes : kAesBlockBytes;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = in[i] ^ keystream[i];
+        }
+        increment32(block);
+        in += n;
+        out += n;
+        bytes -= n;
+    }
+}
+
+// SP 800-38D Algorithm 1, branch-free: the GCM bit order puts x^0 in the
+// MSB of byte 0, so V shifts right and R = 0xE1 || 0^120 folds x^128 back
+void portableGhash(const uint8_t h[kAesBlockBytes], uint8_t state[kAesBlockBytes],
+                   const uint8_t* data, size_t bytes) {
+    const uint64_t hHigh = loadBe64(h);
+    const uint64_t hLow = loadBe64(h + 8);
+    uint64_t yHigh = loadBe64(state);
+    uint64_t yLow = loadBe64(state + 8);
+
+    while (bytes > 0) {
+        uint8_t block[kAesBlockBytes] = {};
+        const size_t n = bytes < kAesBlockBytes ? bytes : kAesBlockBytes;
+        std::memcpy(block, data, n);
+        const uint64_t xHigh = yHigh ^ loadBe64(block);
+        const uint64_t xLow = yLow ^ loadBe64(block + 8);
+
+        uint64_t zHigh = 0;
+        uint64_t zLow = 0;
+        uint64_t vHigh = hHigh;
+        uint64_t vLow = hLow;
+        for (int i = 0; i < 128; ++i) {
+            const uint64_t bit = i < 64 ? (xHigh >> (63 - i)) & 1 : (xLow >> (127 - i)) & 1;
+            const uint64_t take = 0 - bit;
+            zHigh ^= vHigh & take;
+            zLow ^= vLow & take;
+            const uint64_t carry = 0 - (vLow & 1);
+            vLow = (vLow >> 1) | (vHigh << 63);
+            vHigh = (vHigh >> 1) ^ (0xE100000000000000ULL & carry);
+        }
+        yHigh = zHigh;
+        yLow = zLow;
+        data += n;
+        bytes -= n;
+    }
+    storeBe64(state, yHigh);
+    storeBe64(state + 8, yLow);
+}
+
+constexpr detail::GcmKernels kPortableKernels = {
+    CryptoBackend::PORTABLE, portableEncryptBlock, portableCtr32, portableGhash
+};
+
+const detail::GcmKernels* kernelsFor(CryptoBackend backend) {
+    switch (backend) {
+        case CryptoBackend::ARMV8_CE:
+            return detail::armv8GcmKernels();
+        case CryptoBackend::X86_AESNI:
+            return detail::x86GcmKernels();
+        case CryptoBackend::PORTABLE:
+            return &kPortableKernels;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void secureZero(void* p, size_t bytes) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (bytes--) {
+        *v++ = 0;
+    }
+}
+
+const char* cryptoBackendName(CryptoBackend backend) {
+    switch (backend) {
+        case CryptoBackend::ARMV8_CE: return "armv8-ce";
+        case CryptoBackend::X86_AESNI: return "aes-ni";
+        case CryptoBackend::PORTABLE: return "portable";
+    }
+    return "?";
+}
+
+const detail::GcmKernels& detail::portableGcmKernels() {
+    return kPortableKernels;
+}
+
+AesGcm::AesGcm()
+    : kernels_(kernelsFor(bestBackend())) {
+}
+
+CryptoBackend AesGcm::bestBackend() {
+    if (detail::armv8GcmKernels()) {
+        return CryptoBackend::ARMV8_CE;
+    }
+    if (detail::x86GcmKernels()) {
+        return CryptoBackend::X86_AESNI;
+    }
+    return CryptoBackend::PORTABLE;
+}
+
+bool AesGcm::setBackend(CryptoBackend backend) {
+    const detail::GcmKernels* kernels = kernelsFor(backend);
+    if (!kernels) {
+        return false;
+    }
+    kernels_ = kernels;
+    return true;
+}
+
+bool AesGcm::setKey(const uint8_t* key, size_t keyBytes) {
+    clear();
+    if (keyBytes != kAes128KeyBytes && keyBytes != kAes256KeyBytes) {
+        return false;
+    }
+
+    // FIPS-197 5.2 key expansion
+    const size_t nk = keyBytes / 4;
+    const int rounds = static_cast<int>(nk) + 6;
+    const size_t words = 4 * (static_cast<size_t>(rounds) + 1);
+    std::memcpy(roundKeys_, key, keyBytes);
+    uint8_t rcon = 0x01;
+    for (size_t i = nk; i < words; ++i) {
+        uint8_t temp[4];
+        std::memcpy(temp, roundKeys_ + (i - 1) * 4, 4);
+        if (i % nk == 0) {
+            const uint8_t first = temp[0];
+            temp[0] = kSbox[temp[1]] ^ rcon;
+            temp[1] = kSbox[temp[2]];
+            temp[2] = kSbox[temp[3]];
+            temp[3] = kSbox[first];
+            rcon = xtime(rcon);
+        } else if (nk > 6 && i % nk == 4) {
+            for (uint8_t& b : temp) {
+                b = kSbox[b];
+            }
+        }
+        for (size_t b = 0; b < 4; ++b) {
+            roundKeys_[i * 4 + b] = roundKeys_[(i - nk) * 4 + b] ^ temp[b];
+        }
+    }
+    rounds_ = rounds;
+
+    const uint8_t zero[kAesBlockBytes] = {};
+    kernels_->encryptBlock(roundKeys_, rounds_, zero, hashKey_);
+    return true;
+}
+
+void AesGcm::clear() {
+    secureZero(roundKeys_, sizeof(roundKeys_));
+    secureZero(hashKey_, sizeof(hashKey_));
+    rounds_ = 0;
+}
+
+void AesGcm::encryptBlock(const uint8_t in[kAesBlockBytes], uint8_t out[kAesBlockBytes]) const {
+    kernels_->encryptBlock(roundKeys_, rounds_, in, out);
+}
+
+void AesGcm::computeTag(const uint8_t j0[kAesBlockBytes], const uint8_t* aad, size_t aadBytes,
+                        const uint8_t* ciphertext, size_t bytes,
+                        uint8_t tag[kGcmTagBytes]) const {
+    uint8_t state[kAesBlockBytes] = {};
+    kernels_->ghash(hashKey_, state, aad, aadBytes);
+    kernels_->ghash(hashKey_, state, ciphertext, bytes);
+
+    uint8_t lengths[kAesBlockBytes];
+    storeBe64(lengths, static_cast<uint64_t>(aadBytes) * 8);
+    storeBe64(lengths + 8, static_cast<uint64_t>(bytes) * 8);
+    kernels_->ghash(hashKey_, state, lengths, sizeof(lengths));
+
+    uint8_t mask[kAesBlockBytes];
+    kernels_->encryptBlock(roundKeys_, rounds_, j0, mask);
+    for (size_t i = 0; i < kGcmTagBytes; ++i) {
+        tag[i] = state[i] ^ mask[i];
+    }
+}
+
+void AesGcm::seal(const uint8_t iv[kGcmIvBytes], const uint8_t* aad, size_t aadBytes,
+                  uint8_t* data, size_t bytes, uint8_t tag[kGcmTagBytes]) const {
+    // 96-bit IV: J0 = IV || 0^31 || 1, payload starts at inc32(J0)
+    uint8_t j0[kAesBlockBytes] = {};
+    std::memcpy(j0, iv, kGcmIvBytes);
+    j0[15] = 1;
+    uint8_t counter[kAesBlockBytes];
+    std::memcpy(counter, j0, kAesBlockBytes);
+    counter[15] = 2;
+
+    kernels_->ctr32(roundKeys_, rounds_, counter, data, data, bytes);
+    computeTag(j0, aad, aadBytes, data, bytes, tag);
+}
+
+bool AesGcm::open(const uint8_t iv[kGcmIvBytes], const uint8_t* aad, size_t aadBytes,
+                  uint8_t* data, size_t bytes, const uint8_t tag[kGcmTagBytes]) const {
+    uint8_t j0[kAesBlockBytes] = {};
+    std::memcpy(j0, iv, kGcmIvBytes);
+    j0[15] = 1;
+
+    uint8_t expected[kGcmTagBytes];
+    computeTag(j0, aad, aadBytes, data, bytes, expected);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < kGcmTagBytes; ++i) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        return false;
+    }
+
+    uint8_t counter[kAesBlockBytes];
+    std::memcpy(counter, j0, kAesBlockBytes);
+    counter[15] = 2;
+    kernels_->ctr32(roundKeys_, rounds_, counter, data, data, bytes);
+    return true;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,113 @@
+/*
+ * Mesh Rider Wave - AES-GCM for SRTP
+ * In-place AES-128/256-GCM (NIST SP 800-38D) with a 96-bit IV and 128-bit tag
+ *
+ * Three kernel sets, picked once at runtime:
+ *   ARMV8_CE   AESE/AESMC + PMULL (arm64 with the Crypto Extension; Samsung
+ *              S24+ and nearly every arm64 Android device). AesGcmArmv8.cpp,
+ *              built with +crypto.
+ *   X86_AESNI  AES-NI + PCLMULQDQ (x86_64 emulator images, host benchmark)
+ *   PORTABLE   Byte-wise AES and a constant-time bit-serial GHASH, for
+ *              devices without either; correct but ~20x slower
+ *
+ * The tag is verified before anything is decrypted, so a failed open()
+ * leaves the buffer untouched and the caller can retry with another key.
+ * Nothing allocates; an AesGcm is plain storage and may be copied.
+ */
+
+#ifndef MESHRIDER_PTT_AES_GCM_H
+#define MESHRIDER_PTT_AES_GCM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace meshrider {
+namespace ptt {
+
+constexpr size_t kAesBlockBytes = 16;
+constexpr size_t kAes128KeyBytes = 16;
+constexpr size_t kAes256KeyBytes = 32;
+constexpr size_t kGcmIvBytes = 12;
+constexpr size_t kGcmTagBytes = 16;
+
+// 14 rounds (AES-256) + the initial whitening key
+constexpr size_t kAesMaxRoundKeys = 15;
+
+enum class CryptoBackend : uint8_t {
+    PORTABLE,
+    ARMV8_CE,
+    X86_AESNI
+};
+
+const char* cryptoBackendName(CryptoBackend backend);
+
+// Wipe key material; volatile stores the compiler may not elide
+void secureZero(void* p, size_t bytes);
+
+namespace detail {
+
+// One backend's primitives. Round keys are the FIPS-197 expansion in byte
+// order (what AESE and AESENC both consume); GHASH state and H are in the
+// GCM wire byte order.
+struct GcmKernels {
+    CryptoBackend backend;
+    void (*encryptBlock)(const uint8_t* roundKeys, int rounds,
+                         const uint8_t in[kAesBlockBytes], uint8_t out[kAesBlockBytes]);
+    // CTR with a 32-bit big-endian counter in bytes 12..15; in == out allowed
+    void (*ctr32)(const uint8_t* roundKeys, int rounds, const uint8_t counter[kAesBlockBytes],
+                  const uint8_t* in, uint8_t* out, size_t bytes);
+    // state = (state ^ block) * H for each block; a short final block is zero-padded
+    void (*ghash)(const uint8_t h[kAesBlockBytes], uint8_t state[kAesBlockBytes],
+                  const uint8_t* data, size_t bytes);
+};
+
+const GcmKernels& portableGcmKernels();
+const GcmKernels* armv8GcmKernels();    // Null unless built for arm64 and the CPU has AES+PMULL
+const GcmKernels* x86GcmKernels();      // Null unless built for x86 and the CPU has AES-NI+PCLMUL
+
+} // namespace detail
+
+class AesGcm {
+public:
+    AesGcm();
+    ~AesGcm() { clear(); }
+
+    // Pin a backend (benchmark/tests); false if it is not available here
+    bool setBackend(CryptoBackend backend);
+    CryptoBackend getBackend() const { return kernels_->backend; }
+
+    // Fastest backend this device supports
+    static CryptoBackend bestBackend();
+
+    // 16 or 32 byte key; false (and no key) for any other length
+    bool setKey(const uint8_t* key, size_t keyBytes);
+    bool hasKey() const { return rounds_ != 0; }
+
+    // Wipes the key schedule
+    void clear();
+
+    // Encrypt data[0, bytes) in place and write the tag
+    void seal(const uint8_t iv[kGcmIvBytes], const uint8_t* aad, size_t aadBytes,
+              uint8_t* data, size_t bytes, uint8_t tag[kGcmTagBytes]) const;
+
+    // Check the tag, then decrypt in place. On false data is unchanged.
+    bool open(const uint8_t iv[kGcmIvBytes], const uint8_t* aad, size_t aadBytes,
+              uint8_t* data, size_t bytes, const uint8_t tag[kGcmTagBytes]) const;
+
+    // Raw block encryption (SRTP key derivation)
+    void encryptBlock(const uint8_t in[kAesBlockBytes], uint8_t out[kAesBlockBytes]) const;
+
+private:
+    void computeTag(const uint8_t j0[kAesBlockBytes], const uint8_t* aad, size_t aadBytes,
+                    const uint8_t* ciphertext, size_t bytes, uint8_t tag[kGcmTagBytes]) const;
+
+    const detail::GcmKernels* kernels_;
+    int rounds_ = 0;
+    alignas(16) uint8_t roundKeys_[kAesMaxRoundKeys * kAesBlockBytes] = {};
+    alignas(16) uint8_t hashKey_[kAesBlockBytes] = {};     // H = E(K, 0^128)
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_AES_GCM_H
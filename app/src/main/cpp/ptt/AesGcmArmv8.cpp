@@ -0,0 +1,222 @@
+/*
+ * Mesh Rider Wave - AES-GCM kernels: ARMv8 Crypto Extension
+ * AESE/AESMC for the block cipher, PMULL/PMULL2 for GHASH. Built with
+ * -march=armv8-a+crypto for arm64-v8a (CMakeLists.txt) and used only when
+ * HWCAP reports both AES and PMULL, so the rest of the library keeps the
+ * baseline ISA.
+ */
+
+#include "AesGcm.h"
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <cstring>
+#include <sys/auxv.h>
+#define MESHRIDER_PTT_ARMV8_CE 1
+#endif
+
+namespace meshrider {
+namespace ptt {
+namespace detail {
+
+#if defined(MESHRIDER_PTT_ARMV8_CE)
+
+namespace {
+
+inline uint8x16_t encrypt(const uint8_t* roundKeys, int rounds, uint8x16_t block) {
+    // AESE = AddRoundKey + SubBytes + ShiftRows; AESMC = MixColumns
+    for (int round = 0; round < rounds - 1; ++round) {
+        block = vaesmcq_u8(vaeseq_u8(block, vld1q_u8(roundKeys + round * kAesBlockBytes)));
+    }
+    block = vaeseq_u8(block, vld1q_u8(roundKeys + (rounds - 1) * kAesBlockBytes));
+    return veorq_u8(block, vld1q_u8(roundKeys + rounds * kAesBlockBytes));
+}
+
+void armv8EncryptBlock(const uint8_t* roundKeys, int rounds,
+                       const uint8_t in[kAesBlockBytes], uint8_t out[kAesBlockBytes]) {
+    vst1q_u8(out, encrypt(roundKeys, rounds, vld1q_u8(in)));
+}
+
+inline uint8x16_t counterBlock(const uint8_t prefix[kAesBlockBytes], uint32_t counter) {
+    uint8_t block[kAesBlockBytes];
+    std::memcpy(block, prefix, 12);
+    block[12] = static_cast<uint8_t>(counter >> 24);
+    block[13] = static_cast<uint8_t>(counter >> 16);
+    block[14] = static_cast<uint8_t>(counter >> 8);
+    block[15] = static_cast<uint8_t>(counter);
+    return vld1q_u8(block);
+}
+
+void armv8Ctr32(const uint8_t* roundKeys, int rounds, const uint8_t counter[kAesBlockBytes],
+                const uint8_t* in, uint8_t* out, size_t bytes) {
+    uint32_t ctr = (static_cast<uint32_t>(counter[12]) << 24) |
+                   (static_cast<uint32_t>(counter[13]) << 16) |
+                   (static_cast<uint32_t>(counter[14]) << 8) | counter[15];
+
+    // Four independent blocks per pass: AESE/AESMC pairs fuse and pipeline
+    while (bytes >= 4 * kAesBlockBytes) {
+        uint8x16_t b0 = counterBlock(counter, ctr);
+        uint8x16_t b1 = counterBlock(counter, ctr + 1);
+        uint8x16_t b2 = counterBlock(counter, ctr + 2);
+        uint8x16_t b3 = counterBlock(counter, ctr + 3);
+        for (int round = 0; round < rounds - 1; ++round) {
+            const uint8x16_t key = vld1q_u8(roundKeys + round * kAesBlockBytes);
+            b0 = vaesmcq_u8(vaeseq_u8(b0, key));
+            b1 = vaesmcq_u8(vaeseq_u8(b1, key));
+            b2 = vaesmcq_u8(vaeseq_u8(b2, key));
+            b3 = vaesmcq_u8(vaeseq_u8(b3, key));
+        }
+        const uint8x16_t penultimate = vld1q_u8(roundKeys + (rounds - 1) * kAesBlockBytes);
+        const uint8x16_t last = vld1q_u8(roundKeys + rounds * kAesBlockBytes);
+        b0 = veorq_u8(vaeseq_u8(b0, penultimate), last);
+        b1 = veorq_u8(vaeseq_u8(b1, penultimate), last);
+        b2 = veorq_u8(vaeseq_u8(b2, penultimate), last);
+        b3 = veorq_u8(vaeseq_u8(b3, penultimate), last);
+        vst1q_u8(out, veorq_u8(b0, vld1q_u8(in)));
+        vst1q_u8(out + 16, veorq_u8(b1, vld1q_u8(in + 16)));
+        vst1q_u8(out + 32, veorq_u8(b2, vld1q_u8(in + 32)));
+        vst1q_u8(out + 48, veorq_u8(b3, vld1q_u8(in + 48)));
+        ctr += 4;
+        in += 4 * kAesBlockBytes;
+        out += 4 * kAesBlockBytes;
+        bytes -= 4 * kAesBlockBytes;
+    }
+    while (bytes > 0) {
+        uint8_t keystream[kAesBlockBytes];
+        vst1q_u8(keystream, encrypt(roundKeys, rounds, counterBlock(counter, ctr++)));
+        const size_t n = bytes < kAesBlockBytes ? bytes : kAesBlockBytes;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = in[i] ^ keystream[i];
+        }
+        in += n;
+        out += n;
+        bytes -= n;
+    }
+}
+
+// Lane-for-lane port of the PCLMULQDQ reduction in AesGcmX86.cpp (both
+// targets are little-endian, so the byte-reflected layout is identical)
+inline uint8x16_t byteSwap(uint8x16_t v) {
+    const uint8x16_t halves = vrev64q_u8(v);
+    return vextq_u8(halves, halves, 8);
+}
+
+template <int Lane>
+inline poly64_t lane64(uint8x16_t v) {
+    return static_cast<poly64_t>(vgetq_lane_u64(vreinterpretq_u64_u8(v), Lane));
+}
+
+template <int A, int B>
+inline uint8x16_t clmul(uint8x16_t a, uint8x16_t b) {
+    return vreinterpretq_u8_p128(vmull_p64(lane64<A>(a), lane64<B>(b)));
+}
+
+// _mm_slli_si128 / _mm_srli_si128: whole-register byte shifts
+template <int Bytes>
+inline uint8x16_t shiftLeftBytes(uint8x16_t v) {
+    return vextq_u8(vdupq_n_u8(0), v, 16 - Bytes);
+}
+
+template <int Bytes>
+inline uint8x16_t shiftRightBytes(uint8x16_t v) {
+    return vextq_u8(v, vdupq_n_u8(0), Bytes);
+}
+
+// _mm_slli_epi32 / _mm_srli_epi32: per 32-bit lane
+template <int Bits>
+inline uint8x16_t shiftLeft32(uint8x16_t v) {
+    return vreinterpretq_u8_u32(vshlq_n_u32(vreinterpretq_u32_u8(v), Bits));
+}
+
+template <int Bits>
+inline uint8x16_t shiftRight32(uint8x16_t v) {
+    return vreinterpretq_u8_u32(vshrq_n_u32(vreinterpretq_u32_u8(v), Bits));
+}
+
+inline uint8x16_t gfmul(uint8x16_t a, uint8x16_t b) {
+    uint8x16_t t3 = clmul<0, 0>(a, b);
+    uint8x16_t t4 = clmul<0, 1>(a, b);
+    uint8x16_t t5 = clmul<1, 0>(a, b);
+    uint8x16_t t6 = clmul<1, 1>(a, b);
+
+    t4 = veorq_u8(t4, t5);
+    t5 = shiftLeftBytes<8>(t4);
+    t4 = shiftRightBytes<8>(t4);
+    t3 = veorq_u8(t3, t5);
+    t6 = veorq_u8(t6, t4);
+
+    uint8x16_t t7 = shiftRight32<31>(t3);
+    uint8x16_t t8 = shiftRight32<31>(t6);
+    t3 = shiftLeft32<1>(t3);
+    t6 = shiftLeft32<1>(t6);
+    uint8x16_t t9 = shiftRightBytes<12>(t7);
+    t8 = shiftLeftBytes<4>(t8);
+    t7 = shiftLeftBytes<4>(t7);
+    t3 = vorrq_u8(t3, t7);
+    t6 = vorrq_u8(t6, t8);
+    t6 = vorrq_u8(t6, t9);
+
+    t7 = shiftLeft32<31>(t3);
+    t8 = shiftLeft32<30>(t3);
+    t9 = shiftLeft32<25>(t3);
+    t7 = veorq_u8(t7, t8);
+    t7 = veorq_u8(t7, t9);
+    t8 = shiftRightBytes<4>(t7);
+    t7 = shiftLeftBytes<12>(t7);
+    t3 = veorq_u8(t3, t7);
+
+    uint8x16_t t2 = shiftRight32<1>(t3);
+    t4 = shiftRight32<2>(t3);
+    t5 = shiftRight32<7>(t3);
+    t2 = veorq_u8(t2, t4);
+    t2 = veorq_u8(t2, t5);
+    t2 = veorq_u8(t2, t8);
+    t3 = veorq_u8(t3, t2);
+    return veorq_u8(t6, t3);
+}
+
+void armv8Ghash(const uint8_t h[kAesBlockBytes], uint8_t state[kAesBlockBytes],
+                const uint8_t* data, size_t bytes) {
+    const uint8x16_t hr = byteSwap(vld1q_u8(h));
+    uint8x16_t y = byteSwap(vld1q_u8(state));
+    while (bytes >= kAesBlockBytes) {
+        y = gfmul(veorq_u8(y, byteSwap(vld1q_u8(data))), hr);
+        data += kAesBlockBytes;
+        bytes -= kAesBlockBytes;
+    }
+    if (bytes > 0) {
+        uint8_t block[kAesBlockBytes] = {};
+        std::memcpy(block, data, bytes);
+        y = gfmul(veorq_u8(y, byteSwap(vld1q_u8(block))), hr);
+    }
+    vst1q_u8(state, byteSwap(y));
+}
+
+constexpr GcmKernels kArmv8Kernels = {
+    CryptoBackend::ARMV8_CE, armv8EncryptBlock, armv8Ctr32, armv8Ghash
+};
+
+bool cpuHasCryptoExtension() {
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    return (hwcap & HWCAP_AES) && (hwcap & HWCAP_PMULL);
+}
+
+} // namespace
+
+const GcmKernels* armv8GcmKernels() {
+    static const bool supported = cpuHasCryptoExtension();
+    return supported ? &kArmv8Kernels : nullptr;
+}
+
+#else
+
+const GcmKernels* armv8GcmKernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace detail
+} // namespace ptt
+} // namespace meshrider
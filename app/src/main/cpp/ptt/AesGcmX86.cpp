@@ -0,0 +1,195 @@
+/*
+ * Mesh Rider Wave - AES-GCM kernels: AES-NI + PCLMULQDQ
+ * x86 emulator images and the host benchmark. Built with -maes -mpclmul
+ * -mssse3 (CMakeLists.txt); used only when CPUID reports all three.
+ */
+
+#include "AesGcm.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__AES__) && defined(__PCLMUL__) && \
+    defined(__SSSE3__)
+#include <cpuid.h>
+#include <cstring>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define MESHRIDER_PTT_AESNI 1
+#endif
+
+namespace meshrider {
+namespace ptt {
+namespace detail {
+
+#if defined(MESHRIDER_PTT_AESNI)
+
+namespace {
+
+inline __m128i byteSwap(__m128i v) {
+    return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+inline __m128i encrypt(const __m128i* keys, int rounds, __m128i block) {
+    block = _mm_xor_si128(block, _mm_loadu_si128(keys));
+    for (int round = 1; round < rounds; ++round) {
+        block = _mm_aesenc_si128(block, _mm_loadu_si128(keys + round));
+    }
+    return _mm_aesenclast_si128(block, _mm_loadu_si128(keys + rounds));
+}
+
+void aesniEncryptBlock(const uint8_t* roundKeys, int rounds,
+                       const uint8_t in[kAesBlockBytes], uint8_t out[kAesBlockBytes]) {
+    const __m128i* keys = reinterpret_cast<const __m128i*>(roundKeys);
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encrypt(keys, rounds, block));
+}
+
+inline __m128i counterBlock(const uint8_t prefix[kAesBlockBytes], uint32_t counter) {
+    alignas(16) uint8_t block[kAesBlockBytes];
+    std::memcpy(block, prefix, 12);
+    block[12] = static_cast<uint8_t>(counter >> 24);
+    block[13] = static_cast<uint8_t>(counter >> 16);
+    block[14] = static_cast<uint8_t>(counter >> 8);
+    block[15] = static_cast<uint8_t>(counter);
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+}
+
+void aesniCtr32(const uint8_t* roundKeys, int rounds, const uint8_t counter[kAesBlockBytes],
+                const uint8_t* in, uint8_t* out, size_t bytes) {
+    const __m128i* keys = reinterpret_cast<const __m128i*>(roundKeys);
+    uint32_t ctr = (static_cast<uint32_t>(counter[12]) << 24) |
+                   (static_cast<uint32_t>(counter[13]) << 16) |
+                   (static_cast<uint32_t>(counter[14]) << 8) | counter[15];
+
+    // Four independent blocks per pass keep the AES units busy
+    while (bytes >= 4 * kAesBlockBytes) {
+        __m128i b0 = _mm_xor_si128(counterBlock(counter, ctr), _mm_loadu_si128(keys));
+        __m128i b1 = _mm_xor_si128(counterBlock(counter, ctr + 1), _mm_loadu_si128(keys));
+        __m128i b2 = _mm_xor_si128(counterBlock(counter, ctr + 2), _mm_loadu_si128(keys));
+        __m128i b3 = _mm_xor_si128(counterBlock(counter, ctr + 3), _mm_loadu_si128(keys));
+        for (int round = 1; round < rounds; ++round) {
+            const __m128i key = _mm_loadu_si128(keys + round);
+            b0 = _mm_aesenc_si128(b0, key);
+            b1 = _mm_aesenc_si128(b1, key);
+            b2 = _mm_aesenc_si128(b2, key);
+            b3 = _mm_aesenc_si128(b3, key);
+        }
+        const __m128i last = _mm_loadu_si128(keys + rounds);
+        const __m128i* src = reinterpret_cast<const __m128i*>(in);
+        __m128i* dst = reinterpret_cast<__m128i*>(out);
+        _mm_storeu_si128(dst, _mm_xor_si128(_mm_aesenclast_si128(b0, last), _mm_loadu_si128(src)));
+        _mm_storeu_si128(dst + 1, _mm_xor_si128(_mm_aesenclast_si128(b1, last), _mm_loadu_si128(src + 1)));
+        _mm_storeu_si128(dst + 2, _mm_xor_si128(_mm_aesenclast_si128(b2, last), _mm_loadu_si128(src + 2)));
+        _mm_storeu_si128(dst + 3, _mm_xor_si128(_mm_aesenclast_si128(b3, last), _mm_loadu_si128(src + 3)));
+        ctr += 4;
+        in += 4 * kAesBlockBytes;
+        out += 4 * kAesBlockBytes;
+        bytes -= 4 * kAesBlockBytes;
+    }
+    while (bytes > 0) {
+        alignas(16) uint8_t keystream[kAesBlockBytes];
+        _mm_store_si128(reinterpret_cast<__m128i*>(keystream),
+                        encrypt(keys, rounds, counterBlock(counter, ctr++)));
+        const size_t n = bytes < kAesBlockBytes ? bytes : kAesBlockBytes;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = in[i] ^ keystream[i];
+        }
+        in += n;
+        out += n;
+        bytes -= n;
+    }
+}
+
+// Gueron & Kounavis, "Intel Carry-Less Multiplication Instruction and its
+// Usage for Computing the GCM Mode", Fig. 5: byte-reflected operands,
+// 256-bit product shifted left by one, then reduced
+inline __m128i gfmul(__m128i a, __m128i b) {
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t4 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t5 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t6 = _mm_clmulepi64_si128(a, b, 0x11);
+
+    t4 = _mm_xor_si128(t4, t5);
+    t5 = _mm_slli_si128(t4, 8);
+    t4 = _mm_srli_si128(t4, 8);
+    t3 = _mm_xor_si128(t3, t5);
+    t6 = _mm_xor_si128(t6, t4);
+
+    __m128i t7 = _mm_srli_epi32(t3, 31);
+    __m128i t8 = _mm_srli_epi32(t6, 31);
+    t3 = _mm_slli_epi32(t3, 1);
+    t6 = _mm_slli_epi32(t6, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    t3 = _mm_or_si128(t3, t7);
+    t6 = _mm_or_si128(t6, t8);
+    t6 = _mm_or_si128(t6, t9);
+
+    t7 = _mm_slli_epi32(t3, 31);
+    t8 = _mm_slli_epi32(t3, 30);
+    t9 = _mm_slli_epi32(t3, 25);
+    t7 = _mm_xor_si128(t7, t8);
+    t7 = _mm_xor_si128(t7, t9);
+    t8 = _mm_srli_si128(t7, 4);
+    t7 = _mm_slli_si128(t7, 12);
+    t3 = _mm_xor_si128(t3, t7);
+
+    __m128i t2 = _mm_srli_epi32(t3, 1);
+    t4 = _mm_srli_epi32(t3, 2);
+    t5 = _mm_srli_epi32(t3, 7);
+    t2 = _mm_xor_si128(t2, t4);
+    t2 = _mm_xor_si128(t2, t5);
+    t2 = _mm_xor_si128(t2, t8);
+    t3 = _mm_xor_si128(t3, t2);
+    return _mm_xor_si128(t6, t3);
+}
+
+void aesniGhash(const uint8_t h[kAesBlockBytes], uint8_t state[kAesBlockBytes],
+                const uint8_t* data, size_t bytes) {
+    const __m128i hr = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h)));
+    __m128i y = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)));
+    while (bytes >= kAesBlockBytes) {
+        const __m128i x = byteSwap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        y = gfmul(_mm_xor_si128(y, x), hr);
+        data += kAesBlockBytes;
+        bytes -= kAesBlockBytes;
+    }
+    if (bytes > 0) {
+        alignas(16) uint8_t block[kAesBlockBytes] = {};
+        std::memcpy(block, data, bytes);
+        const __m128i x = byteSwap(_mm_load_si128(reinterpret_cast<const __m128i*>(block)));
+        y = gfmul(_mm_xor_si128(y, x), hr);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), byteSwap(y));
+}
+
+constexpr GcmKernels kAesniKernels = {
+    CryptoBackend::X86_AESNI, aesniEncryptBlock, aesniCtr32, aesniGhash
+};
+
+bool cpuHasAesni() {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & bit_AES) && (ecx & bit_PCLMUL) && (ecx & bit_SSSE3);
+}
+
+} // namespace
+
+const GcmKernels* x86GcmKernels() {
+    static const bool supported = cpuHasAesni();
+    return supported ? &kAesniKernels : nullptr;
+}
+
+#else
+
+const GcmKernels* x86GcmKernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace detail
+} // namespace ptt
+} // namespace meshrider
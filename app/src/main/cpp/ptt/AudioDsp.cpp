@@ -0,0 +1,180 @@
+/*
+ * Mesh Rider Wave - PTT Audio DSP Implementation
+ */
+
+#include "AudioDsp.h"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Zeroth-order modified Bessel function (Kaiser window), power series
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    const double quarterSquare = x * x / 4.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= quarterSquare / (static_cast<double>(k) * k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+float dbToLinear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+// One-pole smoothing coefficient reaching 63% in timeMs at blockMs steps
+float smoothingCoefficient(float timeMs, float blockMs) {
+    return timeMs > 0.0f ? 1.0f - std::exp(-blockMs / timeMs) : 1.0f;
+}
+
+} // namespace
+
+void designLowPassFir(float* taps, size_t count, float cutoff, float kaiserBeta, float gain) {
+    const double center = (static_cast<double>(count) - 1.0) / 2.0;
+    const double window0 = besselI0(kaiserBeta);
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const double t = static_cast<double>(i) - center;
+        const double sinc = t == 0.0 ? 2.0 * cutoff :
+                            std::sin(2.0 * kPi * cutoff * t) / (kPi * t);
+        const double ratio = t / center;
+        const double window = besselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) /
+                              window0;
+        taps[i] = static_cast<float>(sinc * window);
+        sum += taps[i];
+    }
+    // Exact DC gain regardless of truncation
+    for (size_t i = 0; i < count; ++i) {
+        taps[i] = static_cast<float>(taps[i] * gain / sum);
+    }
+}
+
+// ============================================================================
+// HighPassFilter
+// ============================================================================
+
+void HighPassFilter::configure(float cutoffHz, float sampleRate) {
+    // RBJ cookbook high-pass, Q = 1/sqrt(2) (Butterworth)
+    const double omega = 2.0 * kPi * std::clamp<double>(cutoffHz, 10.0, sampleRate * 0.45) / sampleRate;
+    const double alpha = std::sin(omega) / (2.0 * 0.7071067811865476);
+    const double cosine = std::cos(omega);
+    const double a0 = 1.0 + alpha;
+    b0_ = static_cast<float>((1.0 + cosine) / 2.0 / a0);
+    b1_ = static_cast<float>(-(1.0 + cosine) / a0);
+    b2_ = b0_;
+    a1_ = static_cast<float>(-2.0 * cosine / a0);
+    a2_ = static_cast<float>((1.0 - alpha) / a0);
+}
+
+// ============================================================================
+// AutomaticGainControl
+// ============================================================================
+
+void AutomaticGainControl::configure(float targetDbfs, float maxGainDb, float minGainDb,
+                                     float blockMs) {
+    targetDbfs_ = targetDbfs;
+    maxGainDb_ = std::max(0.0f, maxGainDb);
+    minGainDb_ = std::min(0.0f, minGainDb);
+    attack_ = smoothingCoefficient(kAgcAttackMs, blockMs);
+    release_ = smoothingCoefficient(kAgcReleaseMs, blockMs);
+    gainDb_ = std::clamp(gainDb_, minGainDb_, maxGainDb_);
+}
+
+// ============================================================================
+// AudioDspChain
+// ============================================================================
+
+AudioDspChain::AudioDspChain(const DspConfig& config)
+    : pendingConfig_(config) {
+    applyPendingConfig();
+}
+
+void AudioDspChain::configure(const DspConfig& config) {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    pendingConfig_ = config;
+    configChanged_.store(true, std::memory_order_release);
+}
+
+DspConfig AudioDspChain::getConfig() const {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    return pendingConfig_;
+}
+
+void AudioDspChain::setNoiseSuppressor(std::shared_ptr<NoiseSuppressor> suppressor) {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    pendingSuppressor_ = std::move(suppressor);
+    configChanged_.store(true, std::memory_order_release);
+}
+
+void AudioDspChain::applyPendingConfig() {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    config_ = pendingConfig_;
+    suppressor_ = pendingSuppressor_;
+
+    if (config_.highPassHz != highPassHz_) {
+        highPassHz_ = config_.highPassHz;
+        highPass_.configure(highPassHz_, static_cast<float>(PttAudioFormat::kSampleRate));
+        highPass_.reset();
+    }
+    agc_.configure(config_.agcTargetDbfs, config_.agcMaxGainDb, kDefaultAgcMinGainDb,
+                   static_cast<float>(kDspBlockMs));
+    limiterThreshold_ = std::clamp(dbToLinear(config_.limiterThresholdDbfs), 0.1f, 0.99f);
+}
+
+void AudioDspChain::reset() {
+    highPass_.reset();
+    if (suppressor_) {
+        suppressor_->reset();
+    }
+}
+
+size_t AudioDspChain::processBlock(float* block) {
+    if (config_.highPass) {
+        highPass_.process<kDspBlockSamples>(block);
+    }
+    if (suppressor_) {
+        suppressor_->process(block, kDspBlockSamples);
+    }
+    if (config_.agc) {
+        agc_.process<kDspBlockSamples>(block);
+    }
+    return config_.limiter ? softLimit<kDspBlockSamples>(block, limiterThreshold_) : 0;
+}
+
+size_t AudioDspChain::process(int16_t* pcm, size_t samples) {
+    if (configChanged_.exchange(false, std::memory_order_acquire)) {
+        applyPendingConfig();
+    }
+    if (!config_.highPass && !config_.agc && !config_.limiter && !suppressor_) {
+        return 0;
+    }
+
+    alignas(16) float block[kDspBlockSamples];
+    size_t limited = 0;
+    size_t offset = 0;
+    for (; offset + kDspBlockSamples <= samples; offset += kDspBlockSamples) {
+        pcmToFloat<kDspBlockSamples>(pcm + offset, block);
+        limited += processBlock(block);
+        floatToPcm<kDspBlockSamples>(block, pcm + offset);
+    }
+
+    const size_t tail = samples - offset;
+    if (tail > 0) {
+        std::fill(block, block + kDspBlockSamples, 0.0f);
+        pcmToFloat(pcm + offset, block, tail);
+        limited += processBlock(block);
+        floatToPcm(block, pcm + offset, tail);
+    }
+    return limited;
+}
+
+} // namespace ptt
+} // namespace meshrider
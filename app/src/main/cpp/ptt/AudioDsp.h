@@ -0,0 +1,697 @@
+/*
+ * Mesh Rider Wave - PTT Audio DSP
+ * Gain staging and device-rate conversion around the Opus codec
+ *
+ *   Capture  (encoder thread, before encode): high-pass -> noise suppressor
+ *            hook -> AGC -> soft limiter
+ *   Playback (decoder thread, after the mix): AGC (off by default) -> soft limiter
+ *   Device   (audio callbacks): 48 kHz <-> 16 kHz polyphase FIR, so the
+ *            streams can open at the native rate on AAudio's fast path
+ *
+ * Processing is float in [-1, 1) on 10 ms blocks (kDspBlockSamples); every
+ * Opus frame the rate controller picks is a whole number of blocks. Kernels
+ * are templated over the block size so each call compiles to a fixed-count
+ * loop, vectorized with NEON on arm64 (Samsung S24+) and SSE2 on x86
+ * emulator/host builds. Each has a Scalar reference the host benchmark
+ * checks and times it against. The high-pass biquad is a serial recurrence
+ * and stays scalar.
+ *
+ * Nothing here allocates or locks after construction except configure(),
+ * which only touches a pending copy picked up on the next block.
+ */
+
+#ifndef MESHRIDER_PTT_AUDIO_DSP_H
+#define MESHRIDER_PTT_AUDIO_DSP_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include "AudioFormat.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MESHRIDER_PTT_DSP_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MESHRIDER_PTT_DSP_SSE2 1
+#endif
+
+namespace meshrider {
+namespace ptt {
+
+// 10 ms at the codec rate: the DSP block, and the decoder's mix chunk
+constexpr size_t kDspBlockSamples = PttAudioFormat::samplesForDuration(10);
+constexpr uint32_t kDspBlockMs = 10;
+
+// Device rate the streams ask for first (native on current Android devices)
+constexpr uint32_t kResampleFactor = 3;
+constexpr uint32_t kDeviceSampleRate = PttAudioFormat::kSampleRate * kResampleFactor;
+static_assert(kDeviceSampleRate == 48000, "resampler is designed for 48 kHz <-> 16 kHz");
+
+// 96-tap Kaiser lowpass at 48 kHz: flat to ~6 kHz, >70 dB down from ~8 kHz
+constexpr size_t kResamplerTapsPerPhase = 32;
+constexpr float kResamplerCutoffHz = 7000.0f;
+constexpr float kResamplerKaiserBeta = 7.0f;
+
+// Device-rate samples handled per pass (20 ms at 48 kHz)
+constexpr size_t kResamplerChunkSamples = 960;
+
+// Stage defaults
+constexpr float kDefaultHighPassHz = 100.0f;            // Handling noise, wind, hum
+constexpr float kDefaultAgcTargetDbfs = -18.0f;         // RMS of active speech
+constexpr float kDefaultAgcMaxGainDb = 18.0f;           // Whispers
+constexpr float kDefaultAgcMinGainDb = -12.0f;          // Shouting into the mic
+constexpr float kDefaultLimiterThresholdDbfs = -3.0f;   // Soft knee starts here
+
+// AGC dynamics: gain falls quickly on loud speech and rises slowly, and
+// holds below the gate so pauses and background are not pumped up
+constexpr float kAgcAttackMs = 20.0f;
+constexpr float kAgcReleaseMs = 800.0f;
+constexpr float kAgcGateDbfs = -50.0f;
+
+constexpr float kPcmToFloat = 1.0f / 32768.0f;
+constexpr float kFloatToPcm = 32768.0f;
+
+// ============================================================================
+// Kernels: runtime-count forms, Scalar references, fixed-N wrappers
+// ============================================================================
+
+namespace detail {
+
+// Round half away from zero after clamping: the SIMD paths do the same
+// (copysign(0.5) then truncate), so conversions match the scalar bit for bit
+inline int16_t floatToPcmSample(float x) {
+    const float scaled = std::clamp(x * kFloatToPcm, -32768.0f, 32767.0f);
+    return static_cast<int16_t>(static_cast<int32_t>(scaled + std::copysign(0.5f, scaled)));
+}
+
+// Soft knee above threshold: slope 1 at the knee, approaches 1.0 asymptotically
+inline float softLimitSample(float x, float threshold, float knee, float inverseKnee) {
+    const float magnitude = std::fabs(x);
+    if (magnitude <= threshold) {
+        return x;
+    }
+    const float excess = (magnitude - threshold) * inverseKnee;
+    return std::copysign(threshold + knee * excess / (1.0f + excess), x);
+}
+
+#if defined(MESHRIDER_PTT_DSP_NEON)
+inline float horizontalSum(float32x4_t v) {
+#if defined(__aarch64__)
+    return vaddvq_f32(v);
+#else
+    const float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+}
+
+inline float32x4_t divide(float32x4_t numerator, float32x4_t denominator) {
+#if defined(__aarch64__)
+    return vdivq_f32(numerator, denominator);
+#else
+    float32x4_t reciprocal = vrecpeq_f32(denominator);
+    reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+    return vmulq_f32(numerator, reciprocal);
+#endif
+}
+
+inline float32x4_t copySign(float32x4_t magnitude, float32x4_t sign) {
+    const uint32x4_t signBit = vdupq_n_u32(0x80000000u);
+    return vreinterpretq_f32_u32(vorrq_u32(
+        vbicq_u32(vreinterpretq_u32_f32(magnitude), signBit),
+        vandq_u32(vreinterpretq_u32_f32(sign), signBit)));
+}
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+inline float horizontalSum(__m128 v) {
+    const __m128 high = _mm_movehl_ps(v, v);
+    const __m128 pair = _mm_add_ps(v, high);
+    return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+
+inline __m128 copySign(__m128 magnitude, __m128 sign) {
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    return _mm_or_ps(_mm_andnot_ps(signBit, magnitude), _mm_and_ps(signBit, sign));
+}
+#endif
+
+} // namespace detail
+
+// out[i] = in[i] / 32768
+inline void pcmToFloatScalar(const int16_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * kPcmToFloat;
+    }
+}
+
+inline void pcmToFloat(const int16_t* in, float* out, size_t count) {
+    size_t i = 0;
+#if defined(MESHRIDER_PTT_DSP_NEON)
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t pcm = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(pcm))), kPcmToFloat));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(pcm))), kPcmToFloat));
+    }
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+    const __m128 scale = _mm_set1_ps(kPcmToFloat);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i pcm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by unpacking into the high half and shifting back down
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(pcm, pcm), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(pcm, pcm), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+#endif
+    pcmToFloatScalar(in + i, out + i, count - i);
+}
+
+// out[i] = round(clamp(in[i] * 32768))
+inline void floatToPcmScalar(const float* in, int16_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = detail::floatToPcmSample(in[i]);
+    }
+}
+
+inline void floatToPcm(const float* in, int16_t* out, size_t count) {
+    size_t i = 0;
+#if defined(MESHRIDER_PTT_DSP_NEON)
+    const float32x4_t lowest = vdupq_n_f32(-32768.0f);
+    const float32x4_t highest = vdupq_n_f32(32767.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(in + i), kFloatToPcm), lowest), highest);
+        float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(in + i + 4), kFloatToPcm), lowest), highest);
+        a = vaddq_f32(a, detail::copySign(half, a));
+        b = vaddq_f32(b, detail::copySign(half, b));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+    }
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+    const __m128 scale = _mm_set1_ps(kFloatToPcm);
+    const __m128 lowest = _mm_set1_ps(-32768.0f);
+    const __m128 highest = _mm_set1_ps(32767.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), lowest), highest);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), lowest), highest);
+        a = _mm_add_ps(a, detail::copySign(half, a));
+        b = _mm_add_ps(b, detail::copySign(half, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+    }
+#endif
+    floatToPcmScalar(in + i, out + i, count - i);
+}
+
+// Sum of x[i]^2 (block energy)
+inline float sumOfSquaresScalar(const float* x, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += x[i] * x[i];
+    }
+    return sum;
+}
+
+inline float sumOfSquares(const float* x, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(MESHRIDER_PTT_DSP_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        const float32x4_t a = vld1q_f32(x + i);
+        const float32x4_t b = vld1q_f32(x + i + 4);
+        acc0 = vmlaq_f32(acc0, a, a);
+        acc1 = vmlaq_f32(acc1, b, b);
+    }
+    sum = detail::horizontalSum(vaddq_f32(acc0, acc1));
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        const __m128 a = _mm_loadu_ps(x + i);
+        const __m128 b = _mm_loadu_ps(x + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+    sum = detail::horizontalSum(_mm_add_ps(acc0, acc1));
+#endif
+    return sum + sumOfSquaresScalar(x + i, count - i);
+}
+
+// x[i] *= gain ramped linearly from `from` (exclusive) to `to` (at the last sample)
+inline void applyGainRampScalar(float* x, size_t count, float from, float to) {
+    const float step = (to - from) / static_cast<float>(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] *= from + step * static_cast<float>(i + 1);
+    }
+}
+
+inline void applyGainRamp(float* x, size_t count, float from, float to) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (to - from) / static_cast<float>(count);
+    [[maybe_unused]] const size_t vectorEnd = count & ~size_t{3};  // Whole lanes
+    size_t i = 0;
+#if defined(MESHRIDER_PTT_DSP_NEON)
+    const float initial[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float32x4_t index = vld1q_f32(initial);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    const float32x4_t base = vdupq_n_f32(from);
+    for (; i < vectorEnd; i += 4) {
+        const float32x4_t gain = vmlaq_n_f32(base, index, step);
+        vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), gain));
+        index = vaddq_f32(index, four);
+    }
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+    __m128 index = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 base = _mm_set1_ps(from);
+    const __m128 stepVector = _mm_set1_ps(step);
+    for (; i < vectorEnd; i += 4) {
+        const __m128 gain = _mm_add_ps(base, _mm_mul_ps(index, stepVector));
+        _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), gain));
+        index = _mm_add_ps(index, four);
+    }
+#endif
+    for (; i < count; ++i) {
+        x[i] *= from + step * static_cast<float>(i + 1);
+    }
+}
+
+// Soft limiter in place; returns samples that were above threshold
+inline size_t softLimitScalar(float* x, size_t count, float threshold) {
+    const float knee = 1.0f - threshold;
+    const float inverseKnee = 1.0f / knee;
+    size_t limited = 0;
+    for (size_t i = 0; i < count; ++i) {
+        limited += std::fabs(x[i]) > threshold ? 1 : 0;
+        x[i] = detail::softLimitSample(x[i], threshold, knee, inverseKnee);
+    }
+    return limited;
+}
+
+inline size_t softLimit(float* x, size_t count, float threshold) {
+    const float knee = 1.0f - threshold;
+    const float inverseKnee = 1.0f / knee;
+    size_t i = 0;
+    size_t limited = 0;
+#if defined(MESHRIDER_PTT_DSP_NEON)
+    const float32x4_t thresholdVector = vdupq_n_f32(threshold);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32x4_t counts = vdupq_n_u32(0);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t v = vld1q_f32(x + i);
+        const float32x4_t magnitude = vabsq_f32(v);
+        const uint32x4_t over = vcgtq_f32(magnitude, thresholdVector);
+        const float32x4_t excess = vmaxq_f32(
+            vmulq_n_f32(vsubq_f32(magnitude, thresholdVector), inverseKnee), zero);
+        const float32x4_t shaped = vmlaq_n_f32(thresholdVector,
+            detail::divide(excess, vaddq_f32(one, excess)), knee);
+        vst1q_f32(x + i, vbslq_f32(over, detail::copySign(shaped, v), v));
+        counts = vsubq_u32(counts, over);   // Mask lanes are all ones (-1)
+    }
+    uint32_t lanes[4];
+    vst1q_u32(lanes, counts);
+    limited = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+    const __m128 thresholdVector = _mm_set1_ps(threshold);
+    const __m128 kneeVector = _mm_set1_ps(knee);
+    const __m128 inverseKneeVector = _mm_set1_ps(inverseKnee);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128i counts = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v = _mm_loadu_ps(x + i);
+        const __m128 magnitude = _mm_and_ps(v, absMask);
+        const __m128 over = _mm_cmpgt_ps(magnitude, thresholdVector);
+        const __m128 excess = _mm_max_ps(
+            _mm_mul_ps(_mm_sub_ps(magnitude, thresholdVector), inverseKneeVector), _mm_setzero_ps());
+        const __m128 shaped = _mm_add_ps(thresholdVector,
+            _mm_mul_ps(kneeVector, _mm_div_ps(excess, _mm_add_ps(one, excess))));
+        const __m128 result = detail::copySign(shaped, v);
+        _mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(over, result), _mm_andnot_ps(over, v)));
+        counts = _mm_sub_epi32(counts, _mm_castps_si128(over));
+    }
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    limited = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    return limited + softLimitScalar(x + i, count - i, threshold);
+}
+
+// sum(a[i] * b[i]) (FIR tap)
+inline float dotProductScalar(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+inline float dotProduct(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(MESHRIDER_PTT_DSP_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    sum = detail::horizontalSum(vaddq_f32(acc0, acc1));
+#elif defined(MESHRIDER_PTT_DSP_SSE2)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    sum = detail::horizontalSum(_mm_add_ps(acc0, acc1));
+#endif
+    return sum + dotProductScalar(a + i, b + i, count - i);
+}
+
+// Fixed-size forms: the count is a constant, so loops carry no tail checks
+template <size_t N> inline void pcmToFloat(const int16_t* in, float* out) { pcmToFloat(in, out, N); }
+template <size_t N> inline void floatToPcm(const float* in, int16_t* out) { floatToPcm(in, out, N); }
+template <size_t N> inline float sumOfSquares(const float* x) { return sumOfSquares(x, N); }
+template <size_t N> inline void applyGainRamp(float* x, float from, float to) { applyGainRamp(x, N, from, to); }
+template <size_t N> inline size_t softLimit(float* x, float threshold) { return softLimit(x, N, threshold); }
+template <size_t N> inline float dotProduct(const float* a, const float* b) { return dotProduct(a, b, N); }
+
+// Windowed-sinc (Kaiser) lowpass: cutoff as a fraction of the sample rate,
+// DC gain `gain`. Symmetric, so the taps read the same in either direction.
+void designLowPassFir(float* taps, size_t count, float cutoff, float kaiserBeta, float gain);
+
+// ============================================================================
+// Stages
+// ============================================================================
+
+/**
+ * Second-order Butterworth high-pass (transposed direct form II)
+ */
+class HighPassFilter {
+public:
+    void configure(float cutoffHz, float sampleRate);
+    void reset() { z1_ = 0.0f; z2_ = 0.0f; }
+
+    template <size_t N>
+    void process(float* x) {
+        for (size_t i = 0; i < N; ++i) {
+            const float in = x[i];
+            const float out = b0_ * in + z1_;
+            z1_ = b1_ * in - a1_ * out + z2_;
+            z2_ = b2_ * in - a2_ * out;
+            x[i] = out;
+        }
+    }
+
+private:
+    float b0_ = 1.0f, b1_ = 0.0f, b2_ = 0.0f, a1_ = 0.0f, a2_ = 0.0f;
+    float z1_ = 0.0f, z2_ = 0.0f;
+};
+
+/**
+ * Block RMS automatic gain control toward a target level
+ *
+ * The gain moves once per block (attack when it must fall, release when it
+ * may rise) and is ramped across the block so changes never step. Blocks
+ * under kAgcGateDbfs hold the gain.
+ */
+class AutomaticGainControl {
+public:
+    void configure(float targetDbfs, float maxGainDb, float minGainDb, float blockMs);
+    float getGainDb() const { return gainDb_; }
+
+    template <size_t N>
+    void process(float* x) {
+        const float meanSquare = sumOfSquares<N>(x) / static_cast<float>(N);
+        const float levelDb = 10.0f * std::log10(meanSquare + 1e-12f);
+        if (levelDb > kAgcGateDbfs) {
+            const float wanted = std::clamp(targetDbfs_ - levelDb, minGainDb_, maxGainDb_);
+            gainDb_ += (wanted - gainDb_) * (wanted < gainDb_ ? attack_ : release_);
+        }
+        const float linear = std::pow(10.0f, gainDb_ / 20.0f);
+        applyGainRamp<N>(x, linearGain_, linear);
+        linearGain_ = linear;
+    }
+
+private:
+    float targetDbfs_ = kDefaultAgcTargetDbfs;
+    float maxGainDb_ = kDefaultAgcMaxGainDb;
+    float minGainDb_ = kDefaultAgcMinGainDb;
+    float attack_ = 1.0f;
+    float release_ = 1.0f;
+    float gainDb_ = 0.0f;
+    float linearGain_ = 1.0f;
+};
+
+/**
+ * Optional noise suppression stage (e.g. an RNNoise or WebRTC NS wrapper)
+ *
+ * Runs on the encoder thread after the high-pass, before AGC, on one 10 ms
+ * block of float samples at the codec rate. Must not block.
+ */
+class NoiseSuppressor {
+public:
+    virtual ~NoiseSuppressor() = default;
+    virtual void process(float* block, size_t samples) = 0;
+    virtual void reset() {}
+};
+
+/**
+ * Chain configuration (AudioEngine::setCaptureDsp / setPlaybackDsp)
+ */
+struct DspConfig {
+    bool highPass = true;
+    float highPassHz = kDefaultHighPassHz;
+    bool agc = true;
+    float agcTargetDbfs = kDefaultAgcTargetDbfs;
+    float agcMaxGainDb = kDefaultAgcMaxGainDb;
+    bool limiter = true;
+    float limiterThresholdDbfs = kDefaultLimiterThresholdDbfs;
+
+    // Decoded audio is already levelled by each talker's capture AGC
+    static DspConfig playbackDefaults() {
+        DspConfig config;
+        config.highPass = false;
+        config.agc = false;
+        return config;
+    }
+};
+
+/**
+ * High-pass -> noise suppressor -> AGC -> limiter at the codec rate
+ *
+ * process() and reset() belong to one worker thread; configure() and
+ * setNoiseSuppressor() may be called from any thread and apply from the
+ * next frame.
+ */
+class AudioDspChain {
+public:
+    explicit AudioDspChain(const DspConfig& config = DspConfig{});
+
+    void configure(const DspConfig& config);
+    DspConfig getConfig() const;
+    void setNoiseSuppressor(std::shared_ptr<NoiseSuppressor> suppressor);
+
+    // Filter state only (new session); the AGC keeps its gain
+    void reset();
+
+    // In place; samples should be a multiple of kDspBlockSamples (a shorter
+    // tail is processed zero-padded). Returns samples the limiter shaped.
+    size_t process(int16_t* pcm, size_t samples);
+
+    float getGainDb() const { return config_.agc ? agc_.getGainDb() : 0.0f; }
+
+private:
+    size_t processBlock(float* block);
+    void applyPendingConfig();
+
+    mutable std::mutex configMutex_;
+    DspConfig pendingConfig_;
+    std::shared_ptr<NoiseSuppressor> pendingSuppressor_;
+    std::atomic<bool> configChanged_{true};
+
+    // Worker thread only
+    DspConfig config_;
+    float limiterThreshold_ = 1.0f;
+    float highPassHz_ = 0.0f;           // Cutoff highPass_ is designed for
+    HighPassFilter highPass_;
+    std::shared_ptr<NoiseSuppressor> suppressor_;
+    AutomaticGainControl agc_;
+};
+
+// ============================================================================
+// Device-rate conversion
+// ============================================================================
+
+/**
+ * Polyphase FIR decimator: Factor device-rate samples in, one out
+ *
+ * Only the kept outputs are computed (Factor x fewer MACs than filtering
+ * then dropping). Simd = false runs the scalar dot product (benchmark).
+ */
+template <size_t Factor, size_t TapsPerPhase, bool Simd = true>
+class PolyphaseDecimator {
+public:
+    static constexpr size_t kTaps = Factor * TapsPerPhase;
+
+    PolyphaseDecimator() {
+        designLowPassFir(taps_.data(), kTaps,
+                         kResamplerCutoffHz / static_cast<float>(kDeviceSampleRate),
+                         kResamplerKaiserBeta, 1.0f);
+        reset();
+    }
+
+    void reset() {
+        history_.fill(0.0f);
+        phase_ = 0;
+    }
+
+    // Largest output for `count` inputs
+    static constexpr size_t maxOutput(size_t count) { return count / Factor + 1; }
+
+    // Returns outputs written to out (room for maxOutput(count))
+    size_t process(const int16_t* in, size_t count, int16_t* out) {
+        size_t written = 0;
+        while (count > 0) {
+            const size_t chunk = std::min(count, kResamplerChunkSamples);
+            float* fresh = history_.data() + kTaps - 1;
+            pcmToFloat(in, fresh, chunk);
+
+            size_t produced = 0;
+            for (size_t j = 0; j < chunk; ++j) {
+                if (++phase_ == Factor) {
+                    phase_ = 0;
+                    // Window ends at input j: buffer[j, j + kTaps)
+                    const float* window = history_.data() + j;
+                    outputs_[produced++] = Simd ? dotProduct<kTaps>(taps_.data(), window)
+                                                : dotProductScalar(taps_.data(), window, kTaps);
+                }
+            }
+            floatToPcm(outputs_.data(), out + written, produced);
+            written += produced;
+
+            std::memmove(history_.data(), history_.data() + chunk, (kTaps - 1) * sizeof(float));
+            in += chunk;
+            count -= chunk;
+        }
+        return written;
+    }
+
+private:
+    std::array<float, kTaps> taps_;
+    std::array<float, kTaps - 1 + kResamplerChunkSamples> history_;
+    std::array<float, kResamplerChunkSamples / Factor + 1> outputs_;
+    size_t phase_ = 0;
+};
+
+/**
+ * Polyphase FIR interpolator: one codec-rate sample in, Factor out
+ *
+ * Output is pulled in whatever size the device asks for; outputs of the
+ * last input that did not fit are kept for the next call.
+ */
+template <size_t Factor, size_t TapsPerPhase, bool Simd = true>
+class PolyphaseInterpolator {
+public:
+    static constexpr size_t kTaps = Factor * TapsPerPhase;
+
+    PolyphaseInterpolator() {
+        float prototype[kTaps];
+        designLowPassFir(prototype, kTaps,
+                         kResamplerCutoffHz / static_cast<float>(kDeviceSampleRate),
+                         kResamplerKaiserBeta, static_cast<float>(Factor));
+        // Phase p, window slot w (oldest first) takes h[p + Factor * (TapsPerPhase - 1 - w)]
+        for (size_t p = 0; p < Factor; ++p) {
+            for (size_t w = 0; w < TapsPerPhase; ++w) {
+                phaseTaps_[p][w] = prototype[p + Factor * (TapsPerPhase - 1 - w)];
+            }
+        }
+        reset();
+    }
+
+    void reset() {
+        history_.fill(0.0f);
+        pendingCount_ = 0;
+        pendingIndex_ = 0;
+    }
+
+    // Codec-rate inputs process() needs to produce `outputs` samples
+    size_t inputNeeded(size_t outputs) const {
+        const size_t pending = pendingCount_ - pendingIndex_;
+        return outputs <= pending ? 0 : (outputs - pending + Factor - 1) / Factor;
+    }
+
+    // Writes exactly `outputs` samples from inputNeeded(outputs) inputs
+    void process(const int16_t* in, size_t inputs, int16_t* out, size_t outputs) {
+        size_t written = 0;
+        while (written < outputs && pendingIndex_ < pendingCount_) {
+            out[written++] = detail::floatToPcmSample(pending_[pendingIndex_++]);
+        }
+
+        while (inputs > 0 && written < outputs) {
+            // Never more input than the request needs, so at most Factor - 1 spill
+            const size_t needed = (outputs - written + Factor - 1) / Factor;
+            const size_t chunk = std::min({inputs, kChunkInputs, needed});
+            float* fresh = history_.data() + TapsPerPhase - 1;
+            pcmToFloat(in, fresh, chunk);
+
+            size_t produced = 0;
+            for (size_t j = 0; j < chunk; ++j) {
+                const float* window = history_.data() + j;
+                for (size_t p = 0; p < Factor; ++p) {
+                    outputs_[produced++] = Simd ?
+                        dotProduct<TapsPerPhase>(phaseTaps_[p].data(), window) :
+                        dotProductScalar(phaseTaps_[p].data(), window, TapsPerPhase);
+                }
+            }
+
+            const size_t take = std::min(produced, outputs - written);
+            floatToPcm(outputs_.data(), out + written, take);
+            written += take;
+
+            // Only the final input's phases can overflow the request
+            pendingCount_ = produced - take;
+            pendingIndex_ = 0;
+            std::copy(outputs_.begin() + take, outputs_.begin() + produced, pending_.begin());
+
+            std::memmove(history_.data(), history_.data() + chunk,
+                         (TapsPerPhase - 1) * sizeof(float));
+            in += chunk;
+            inputs -= chunk;
+        }
+
+        // Too little input (caller bug): silence rather than stale memory
+        std::fill(out + written, out + outputs, int16_t{0});
+    }
+
+private:
+    static constexpr size_t kChunkInputs = kResamplerChunkSamples / Factor;
+
+    std::array<std::array<float, TapsPerPhase>, Factor> phaseTaps_;
+    std::array<float, TapsPerPhase - 1 + kChunkInputs> history_;
+    std::array<float, kResamplerChunkSamples> outputs_;
+    std::array<float, Factor - 1> pending_;
+    size_t pendingCount_ = 0;
+    size_t pendingIndex_ = 0;
+};
+
+// What AudioEngine runs in its callbacks when the device grants 48 kHz
+using CaptureResampler = PolyphaseDecimator<kResampleFactor, kResamplerTapsPerPhase>;
+using PlaybackResampler = PolyphaseInterpolator<kResampleFactor, kResamplerTapsPerPhase>;
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_AUDIO_DSP_H
@@ -8,36 +8,93 @@
  * - Atomic state flags
  * - DSCP QoS marking on RTP packets
  * - Opus codec encoding/decoding (3GPP TS 26.179 MCPTT)
+ * - Capture callback only writes to a lock-free ring; encoding runs on a worker
+ * - Per-SSRC decode and saturating mix so overlapping talkers stay intelligible
+ * - Playback callback only copies from a PCM ring kept filled by a decoder thread
+ * - Frame stamps at capture/encode/send and receive/dequeue/decode/render
+ * - Streams stay open between presses (stop, not close); warm standby keeps
+ *   capture running so key-up is a state flip plus an encoder reset
+ * - High-pass/AGC/limiter before encode and limiter after the mix; streams
+ *   run at 48 kHz where granted, resampled to 16 kHz in the callbacks
+ * - Idle: playback parked after silence, decoder blocked until the next
+ *   packet; thread wakeups metered per power mode
+ * - Receive-path recording tap (Ogg/Opus per talker burst)
+ * - Stream worker reopens streams Oboe closed and applies route changes;
+ *   sessions, codecs, jitter buffers and rings carry over
  */
 
 #include "AudioEngine.h"
-#include <android/log.h>
+#include "PttLog.h"
 #include <aaudio/AAudio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
 #define TAG "MeshRider:PTT-Engine"
 
 namespace meshrider {
 namespace ptt {
 
+namespace {
+
+// Oboe closes a stream itself after onErrorBeforeClose (device change, HAL restart)
+bool isStreamUsable(const std::shared_ptr<oboe::AudioStream>& stream) {
+    if (!stream) {
+        return false;
+    }
+    const oboe::StreamState state = stream->getState();
+    return state != oboe::StreamState::Closing &&
+           state != oboe::StreamState::Closed &&
+           state != oboe::StreamState::Disconnected;
+}
+
+} // namespace
+
 AudioEngine::AudioEngine()
     : captureCallback_(std::make_unique<meshrider::ptt::CaptureCallback>(this))
     , playbackCallback_(std::make_unique<meshrider::ptt::PlaybackCallback>(this))
     , opusEncoder_(nullptr)
-    , opusDecoder_(nullptr) {
-    // Jitter buffer will be created on-demand in PlaybackCallback::enqueueAudio
-    // This avoids allocating resources until they're actually needed
+    , powerMeter_(std::make_shared<PowerMeter>(traceClockMicros())) {
+    // Receive streams (jitter buffers + decoders) are created in initialize()
 }
 
 AudioEngine::~AudioEngine() {
+    // No reopen may race the teardown below
+    stopStreamWorker();
+
     stopCapture();
     stopPlayback();
+    // Stream may have been closed by Oboe (error path) with the workers still up
+    stopEncoderThread();
+    stopDecoderThread();
+
+    // Streams outlive capture/playback sessions; close them with the engine
+    if (captureStream_) {
+        captureStream_->stop();
+        captureStream_->close();
+    }
+    if (playbackStream_) {
+        playbackStream_->stop();
+        playbackStream_->close();
+    }
 }
 
 bool AudioEngine::initialize(AudioEngineCallback* callback) {
     callback_ = callback;
 
+    // PRODUCTION FIX: Re-initialize of a live engine keeps the preallocated
+    // codecs and the open streams instead of rebuilding them
+    if (isInitialized()) {
+        const bool ready = ensureCaptureStream() && ensurePlaybackStream();
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "Audio engine already initialized, reusing codecs and streams (%s)",
+            ready ? "ready" : "stream reopen failed");
+        return ready;
+    }
+
     // Initialize Opus encoder (3GPP TS 26.179 MCPTT mandatory codec)
-    std::lock_guard<std::mutex> codecLock(codecMutex_);
+    std::lock_guard<std::mutex> codecLock(encoderMutex_);
 
     opusEncoder_ = OpusCodecFactory::createEncoder(OpusMode::VOIP);
     if (!opusEncoder_) {
@@ -46,12 +103,19 @@ bool AudioEngine::initialize(AudioEngineCallback* callback) {
         return false;
     }
 
-    opusDecoder_ = OpusCodecFactory::createDecoder();
-    if (!opusDecoder_) {
+    // One decoder per receive stream, all preallocated within the budget
+    receiveStreams_ = std::make_unique<ReceiveStreamTable>(kJitterFrameDurationMs,
+                                                           memoryBudgetBytes_);
+    receiveStreams_->setLatencyTracer(&latencyTracer_);
+    receiveStreams_->setRecorder(&recorder_);
+    receiveStreams_->setQualityMonitor(&qualityMonitor_);
+    qualityMonitor_.setPathDelay(0.0, 0.0, kDecodeAheadMs);
+    if (!receiveStreams_->initialize()) {
         __android_log_print(ANDROID_LOG_ERROR, TAG,
-            "Failed to create Opus decoder");
+            "Failed to create Opus decoders (memory budget %zu bytes)", memoryBudgetBytes_);
         // CRITICAL FIX: Clean up encoder on decoder failure
         opusEncoder_.reset();
+        receiveStreams_.reset();
         return false;
     }
 
@@ -61,19 +125,19 @@ bool AudioEngine::initialize(AudioEngineCallback* callback) {
         opusEncoder_->getBitrate());
 
     // Create capture stream (microphone)
-    auto result = createCaptureStream();
+    auto result = openCaptureStream();
     if (result != oboe::Result::OK) {
         __android_log_print(ANDROID_LOG_ERROR, TAG,
             "Failed to create capture stream: %s",
             oboe::convertToText(result));
         // CRITICAL FIX: Clean up codec resources on stream failure
         opusEncoder_.reset();
-        opusDecoder_.reset();
+        receiveStreams_.reset();
         return false;
     }
 
     // Create playback stream (speaker)
-    result = createPlaybackStream();
+    result = openPlaybackStream();
     if (result != oboe::Result::OK) {
         __android_log_print(ANDROID_LOG_ERROR, TAG,
             "Failed to create playback stream: %s",
@@ -84,15 +148,18 @@ bool AudioEngine::initialize(AudioEngineCallback* callback) {
             captureStream_.reset();
         }
         opusEncoder_.reset();
-        opusDecoder_.reset();
+        receiveStreams_.reset();
         return false;
     }
 
-    // Reset statistics
-    {
-        std::lock_guard<std::mutex> statsLock(statsMutex_);
-        stats_ = CodecStats{};
-    }
+    // Reset statistics (no stream or worker is running yet)
+    captureTelemetry_.reset();
+    encodeTelemetry_.reset();
+    mixTelemetry_.reset();
+    playbackTelemetry_.reset();
+
+    // Kept for the engine's lifetime; reopens whatever Oboe closes from here on
+    startStreamWorker();
 
     __android_log_print(ANDROID_LOG_INFO, TAG,
         "Audio engine initialized: %d Hz, %d ch, Opus mode",
@@ -101,113 +168,599 @@ bool AudioEngine::initialize(AudioEngineCallback* callback) {
     return true;
 }
 
-oboe::Result AudioEngine::createCaptureStream() {
+oboe::Result AudioEngine::createCaptureStream(int32_t sampleRate, bool oboeConversion) {
     oboe::AudioStreamBuilder builder;
 
     // SAMSUNG EXYNOS FIX: Buffer capacity must be multiple of burst size (192)
     // For 16kHz mono low-latency, use 7x burst = 1344 frames (~42ms buffer)
     // This ensures compatibility with Exynos audio HAL alignment requirements
     // Formula: capacity = burst_size * N where N is power of 2
-    constexpr int32_t kCaptureBufferCapacity = kFramesPerBurst * 7;  // 1344 frames
+    // Same durations at 48 kHz (3x the frames, still burst multiples)
+    const int32_t framesPerCallback = kFramesPerBurst * (sampleRate / kSampleRate);
+    const int32_t captureBufferCapacity = framesPerCallback * 7;  // 1344 frames at 16 kHz
+    const AudioRoute route = getRoute();
 
-    // PRODUCTION FIX: Enable AEC with VoiceCommunication preset
+    // PRODUCTION FIX: Enable AEC with VoiceCommunication preset (VoiceRecognition:
+    // no echo processing, for routes without a speaker next to the mic)
     builder.setDirection(oboe::Direction::Input)
            ->setFormat(oboe::AudioFormat::I16)
            ->setChannelCount(kChannelCount)
-           ->setSampleRate(kSampleRate)
-           ->setFramesPerDataCallback(kFramesPerBurst)
+           ->setSampleRate(sampleRate)
+           ->setFramesPerDataCallback(framesPerCallback)
            ->setPerformanceMode(oboe::PerformanceMode::LowLatency)
            ->setSharingMode(oboe::SharingMode::Exclusive)
            ->setUsage(oboe::Usage::VoiceCommunication)  // Enables AEC
            ->setContentType(oboe::ContentType::Speech)
-           ->setInputPreset(oboe::InputPreset::VoiceCommunication)
+           ->setInputPreset(route.echoCancel ? oboe::InputPreset::VoiceCommunication
+                                             : oboe::InputPreset::VoiceRecognition)
+           ->setDeviceId(route.inputDeviceId)
            ->setCallback(captureCallback_.get())
-           ->setBufferCapacityInFrames(kCaptureBufferCapacity);
+           ->setBufferCapacityInFrames(captureBufferCapacity);
+    if (oboeConversion) {
+        builder.setSampleRateConversionQuality(oboe::SampleRateConversionQuality::Medium);
+    }
 
     return builder.openStream(captureStream_);
 }
 
-oboe::Result AudioEngine::createPlaybackStream() {
+oboe::Result AudioEngine::createPlaybackStream(int32_t sampleRate, bool oboeConversion,
+                                               bool powerSaving) {
     oboe::AudioStreamBuilder builder;
 
     // SAMSUNG EXYNOS FIX: Buffer capacity must be multiple of burst size (192)
     // For playback, use larger buffer (12x burst = 2304 frames ~72ms)
     // This accommodates jitter buffer variations and Exynos alignment
     // Formula: capacity = burst_size * N where N is power of 2
-    constexpr int32_t kPlaybackBufferCapacity = kFramesPerBurst * 12;  // 2304 frames
+    const int32_t framesPerCallback = kFramesPerBurst * (sampleRate / kSampleRate);
+    const int32_t playbackBufferCapacity = framesPerCallback * 12;  // 2304 frames at 16 kHz
 
     builder.setDirection(oboe::Direction::Output)
            ->setFormat(oboe::AudioFormat::I16)
            ->setChannelCount(kChannelCount)
-           ->setSampleRate(kSampleRate)
-           ->setFramesPerDataCallback(kFramesPerBurst)
-           ->setPerformanceMode(oboe::PerformanceMode::LowLatency)
-           ->setSharingMode(oboe::SharingMode::Exclusive)
+           ->setSampleRate(sampleRate)
            ->setUsage(oboe::Usage::Media)
            ->setContentType(oboe::ContentType::Speech)
-           ->setCallback(playbackCallback_.get())
-           ->setBufferCapacityInFrames(kPlaybackBufferCapacity);
+           ->setDeviceId(getRoute().outputDeviceId)
+           ->setCallback(playbackCallback_.get());
+    if (powerSaving) {
+        // Idle: the mixer picks large bursts, so the callback wakes rarely
+        builder.setPerformanceMode(oboe::PerformanceMode::PowerSaving)
+               ->setSharingMode(oboe::SharingMode::Shared);
+    } else {
+        builder.setFramesPerDataCallback(framesPerCallback)
+               ->setPerformanceMode(oboe::PerformanceMode::LowLatency)
+               ->setSharingMode(oboe::SharingMode::Exclusive)
+               ->setBufferCapacityInFrames(playbackBufferCapacity);
+    }
+    if (oboeConversion) {
+        builder.setSampleRateConversionQuality(oboe::SampleRateConversionQuality::Medium);
+    }
 
     return builder.openStream(playbackStream_);
 }
 
-bool AudioEngine::startCapture() {
-    if (isCapturing_.load()) {
+oboe::Result AudioEngine::openCaptureStream() {
+    // PRODUCTION FIX: A 16 kHz request keeps AAudio off the MMAP fast path on
+    // devices whose mixer runs at 48 kHz; ask for that and resample ourselves
+    oboe::Result result = createCaptureStream(kDeviceSampleRate, false);
+    if (result == oboe::Result::OK &&
+        captureStream_->getSampleRate() != static_cast<int32_t>(kDeviceSampleRate) &&
+        captureStream_->getSampleRate() != kSampleRate) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Capture granted %d Hz, reopening at %d Hz with Oboe conversion",
+            captureStream_->getSampleRate(), kSampleRate);
+        captureStream_->close();
+        captureStream_.reset();
+        result = createCaptureStream(kSampleRate, true);
+    }
+    if (result == oboe::Result::OK) {
+        captureDeviceRate_.store(captureStream_->getSampleRate());
+        captureDeviceId_.store(captureStream_->getDeviceId());
+        __android_log_print(ANDROID_LOG_INFO, TAG, "Capture stream at %d Hz on device %d%s",
+            captureStream_->getSampleRate(), captureStream_->getDeviceId(),
+            captureStream_->getSampleRate() == kSampleRate ? "" : " (resampled in callback)");
+    }
+    return result;
+}
+
+oboe::Result AudioEngine::openPlaybackStream(bool powerSaving) {
+    oboe::Result result = createPlaybackStream(kDeviceSampleRate, false, powerSaving);
+    if (result == oboe::Result::OK &&
+        playbackStream_->getSampleRate() != static_cast<int32_t>(kDeviceSampleRate) &&
+        playbackStream_->getSampleRate() != kSampleRate) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Playback granted %d Hz, reopening at %d Hz with Oboe conversion",
+            playbackStream_->getSampleRate(), kSampleRate);
+        playbackStream_->close();
+        playbackStream_.reset();
+        result = createPlaybackStream(kSampleRate, true, powerSaving);
+    }
+    if (result == oboe::Result::OK) {
+        playbackDeviceRate_.store(playbackStream_->getSampleRate());
+        playbackDeviceId_.store(playbackStream_->getDeviceId());
+        __android_log_print(ANDROID_LOG_INFO, TAG, "Playback stream at %d Hz on device %d%s%s",
+            playbackStream_->getSampleRate(), playbackStream_->getDeviceId(),
+            playbackStream_->getSampleRate() == kSampleRate ? "" : " (resampled in callback)",
+            powerSaving ? ", power saving" : "");
+    }
+    playbackPowerSaving_ = result == oboe::Result::OK && powerSaving;
+    return result;
+}
+
+bool AudioEngine::ensureCaptureStream() {
+    std::lock_guard<std::mutex> lock(captureStreamMutex_);
+    return ensureCaptureStreamLocked();
+}
+
+bool AudioEngine::ensureCaptureStreamLocked() {
+    if (isStreamUsable(captureStream_)) {
         return true;
     }
+    if (captureStream_) {
+        captureStream_->close();
+        captureStream_.reset();
+    }
 
-    if (!captureStream_) {
+    auto result = openCaptureStream();
+    if (result != oboe::Result::OK) {
         __android_log_print(ANDROID_LOG_ERROR, TAG,
-            "Capture stream not initialized");
+            "Failed to reopen capture stream: %s",
+            oboe::convertToText(result));
+        captureStream_.reset();
         return false;
     }
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Capture stream reopened");
+    return true;
+}
 
-    // Reset encoder state for new transmission
-    std::lock_guard<std::mutex> codecLock(codecMutex_);
-    if (opusEncoder_) {
-        opusEncoder_->reset();
-    }
+bool AudioEngine::ensurePlaybackStream() {
+    std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+    return ensurePlaybackStreamLocked();
+}
 
-    // Clear PCM buffer
-    {
-        std::lock_guard<std::mutex> lock(pcmBufferMutex_);
-        pcmBuffer_.clear();
-        pcmBuffer_.reserve(OPUS_FRAME_SIZE);
+bool AudioEngine::ensurePlaybackStreamLocked() {
+    if (isStreamUsable(playbackStream_) && !playbackPowerSaving_) {
+        return true;
+    }
+    if (playbackStream_) {
+        playbackStream_->close();
+        playbackStream_.reset();
     }
 
-    auto result = captureStream_->requestStart();
+    auto result = openPlaybackStream();
     if (result != oboe::Result::OK) {
         __android_log_print(ANDROID_LOG_ERROR, TAG,
-            "Failed to start capture: %s",
+            "Failed to reopen playback stream: %s",
             oboe::convertToText(result));
-        // CRITICAL FIX: Close stream on start failure to prevent leak
-        // Stream may be in undefined state after failed requestStart()
-        captureStream_->close();
-        captureStream_.reset();
+        playbackStream_.reset();
         return false;
     }
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Playback stream reopened");
+    return true;
+}
+
+bool AudioEngine::startCapture() {
+    if (isCapturing_.load()) {
+        return true;
+    }
+
+    // TTFF is measured from here: everything below is key-up latency
+    const int64_t keyUpMicros = traceClockMicros();
+
+    if (!isInitialized()) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Capture stream not initialized");
+        return false;
+    }
+
+    // Held to the end: the stream worker sees the session either before or after
+    std::lock_guard<std::mutex> streamLock(captureStreamMutex_);
+
+    // Opened once in initialize(); only reopened if Oboe closed it
+    if (!ensureCaptureStreamLocked()) {
+        return false;
+    }
+
+    // Worker may still be running if Oboe closed the stream on error;
+    // it must be quiescent before the ring is reset
+    stopEncoderThread();
+
+    // Reset encoder state for new transmission; the Opus mode of the home
+    // channel's profile can only change here, between sessions
+    sessionProfile_ = txProfile_.load();
+    {
+        std::lock_guard<std::mutex> encoderLock(encoderMutex_);
+        if (opusEncoder_) {
+            opusEncoder_->setMode(kCodecProfiles[sessionProfile_].mode);
+            opusEncoder_->reset();
+        }
+    }
+    sessionStart_ = readTransmitCounters();
+
+    // Clear capture ring (producer is idle until isCapturing_ is set, even
+    // with the stream running in warm standby)
+    captureRing_.reset();
+
+    const bool warm = captureStream_->getState() == oboe::StreamState::Started;
+    if (!warm) {
+        auto result = captureStream_->requestStart();
+        if (result != oboe::Result::OK) {
+            __android_log_print(ANDROID_LOG_ERROR, TAG,
+                "Failed to start capture: %s",
+                oboe::convertToText(result));
+            // CRITICAL FIX: Close stream on start failure to prevent leak
+            // Stream may be in undefined state after failed requestStart()
+            captureStream_->close();
+            captureStream_.reset();
+            return false;
+        }
+    }
 
+    keyUpMicros_.store(keyUpMicros);
+    keyUpWarm_.store(warm);
+    startEncoderThread();
     isCapturing_.store(true);
+    updatePowerMode();
     __android_log_print(ANDROID_LOG_INFO, TAG,
-        "Audio capture started (Opus encoding enabled)");
+        "Audio capture started (Opus encoding enabled, %s stream)",
+        warm ? "warm" : "cold");
     return true;
 }
 
 void AudioEngine::stopCapture() {
     if (!isCapturing_.load()) {
+        // A session dropped after a failed reopen may have left the worker
+        stopEncoderThread();
         return;
     }
 
-    isCapturing_.store(false);
+    {
+        std::lock_guard<std::mutex> streamLock(captureStreamMutex_);
+        isCapturing_.store(false);
+        updatePowerMode();
+
+        if (warmStandby_.load() && isStreamUsable(captureStream_)) {
+            // Stream keeps running for the next key-up; only a callback that saw
+            // isCapturing_ before the store can still be writing the ring
+            while (captureCallbackBusy_.load()) {
+                std::this_thread::yield();
+            }
+        } else if (captureStream_) {
+            // Stopped, not closed: the next press skips the open
+            captureStream_->stop();
+        }
+    }
 
-    if (captureStream_) {
-        captureStream_->stop();
-        captureStream_->close();
-        captureStream_.reset();
+    // Callback can no longer produce; drop any partial frame with the worker
+    stopEncoderThread();
+
+    const TransmitCounters sent = readTransmitCounters();
+    const int64_t keyedMicros = std::max<int64_t>(0, traceClockMicros() - keyUpMicros_.load());
+    qualityMonitor_.recordTransmit(sessionProfile_,
+        sent.frames - sessionStart_.frames, sent.packets - sessionStart_.packets,
+        sent.bytes - sessionStart_.bytes, static_cast<uint64_t>(keyedMicros / 1000));
+
+    const CapturePipelineStats pipeline = getCapturePipelineStats();
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Audio capture stopped (callbacks=%llu, overruns=%llu, dropped=%llu, "
+        "ringHighWater=%llu, maxCallback=%lluus)",
+        static_cast<unsigned long long>(pipeline.callbackCount),
+        static_cast<unsigned long long>(pipeline.callbackOverruns),
+        static_cast<unsigned long long>(pipeline.droppedSamples),
+        static_cast<unsigned long long>(pipeline.ringHighWaterMark),
+        static_cast<unsigned long long>(pipeline.maxCallbackMicros));
+}
+
+void AudioEngine::setWarmStandby(bool enable) {
+    if (warmStandby_.exchange(enable) == enable) {
+        return;
+    }
+
+    // A running session keeps its stream; the new mode applies from its stop
+    std::lock_guard<std::mutex> streamLock(captureStreamMutex_);
+    if (!isCapturing_.load() && isInitialized()) {
+        if (enable) {
+            if (ensureCaptureStreamLocked()) {
+                auto result = captureStream_->requestStart();
+                if (result != oboe::Result::OK) {
+                    __android_log_print(ANDROID_LOG_WARN, TAG,
+                        "Warm standby start failed: %s", oboe::convertToText(result));
+                }
+            }
+        } else if (captureStream_) {
+            captureStream_->stop();
+        }
+    }
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Warm standby %s", enable ? "enabled" : "disabled");
+}
+
+void AudioEngine::startEncoderThread() {
+    std::lock_guard<std::mutex> lock(encoderThreadMutex_);
+    if (encoderRunning_.exchange(true)) {
+        return;
+    }
+    encoderThread_ = std::thread([this]() { encoderLoop(); });
+}
+
+void AudioEngine::stopEncoderThread() {
+    std::lock_guard<std::mutex> lock(encoderThreadMutex_);
+    encoderRunning_.store(false);
+    if (encoderThread_.joinable()) {
+        encoderThread_.join();
+    }
+}
+
+// ============================================================================
+// Encoder Thread - Drains capture ring, encodes to Opus, sends to network
+// ============================================================================
+
+void AudioEngine::encoderLoop() {
+    ThreadScope threadScope(threadManager_.get(), ThreadRole::ENCODER, "ptt-encoder");
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Encoder thread started");
+
+    // Sized for the longest frame the rate controller may pick (60 ms)
+    int16_t frameBuffer[OPUS_MAX_FRAME_SIZE];
+    uint8_t opusBuffer[OPUS_MAX_PACKET_SIZE];
+
+    // Resume with whatever the link supported last time
+    EncoderSettings settings = rateController_.getCurrentSettings();
+    applyEncoderSettings(settings);
+    size_t frameSamples = PttAudioFormat::samplesForDuration(settings.frameDurationMs);
+
+    auto nextEvaluate = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(kRateEvaluateIntervalMs);
+
+    // Each capture session opens a new talkspurt (marker on its first packet)
+    transmitGate_.reset();
+    captureDsp_.reset();
+
+    // Key-up of this session (stored before the thread was started)
+    const int64_t keyUpMicros = keyUpMicros_.load();
+    const bool keyUpWarm = keyUpWarm_.load();
+    bool firstFrame = true;
+
+    while (encoderRunning_.load()) {
+        powerMeter_->wake();
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextEvaluate) {
+            nextEvaluate = now + std::chrono::milliseconds(kRateEvaluateIntervalMs);
+            if (receiveStreams_) {
+                rateController_.onLocalStats(receiveStreams_->getAggregateJitterStats());
+            }
+            const int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                now.time_since_epoch()).count();
+            if (auto updated = rateController_.evaluate(nowMs)) {
+                settings = *updated;
+                applyEncoderSettings(settings);
+                encodeTelemetry_.increment(EncodeField::SETTINGS_CHANGES);
+                frameSamples = PttAudioFormat::samplesForDuration(settings.frameDurationMs);
+            }
+        }
+
+        // Callback never signals (that would be a syscall), so poll the ring
+        if (captureRing_.availableToRead() < frameSamples) {
+            threadScope.sleepFor(kEncoderPollIntervalMs);
+            continue;
+        }
+
+        // Capture time of the frame's first sample: everything queued behind
+        // it arrived since, the newest in the last callback (within one burst)
+        const bool tracing = latencyTracer_.isEnabled();
+        int64_t captureMicros = 0;
+        if (tracing) {
+            captureMicros = traceClockMicros() -
+                static_cast<int64_t>(captureRing_.availableToRead()) * 1000000 / kSampleRate;
+        }
+
+        captureRing_.read(frameBuffer, frameSamples);
+
+        // Gain staging before the codec (and the VAD) see the frame
+        const size_t limitedSamples = captureDsp_.process(frameBuffer, frameSamples);
+
+        int encodedBytes = 0;
+        {
+            std::lock_guard<std::mutex> encoderLock(encoderMutex_);
+            if (!opusEncoder_) {
+                continue;
+            }
+            encodedBytes = opusEncoder_->encode(
+                frameBuffer,
+                static_cast<int>(frameSamples),
+                opusBuffer,
+                sizeof(opusBuffer)
+            );
+        }
+
+        if (encodedBytes > 0) {
+            const int64_t encodeMicros = tracing ? traceClockMicros() : 0;
+            const uint32_t frameTicks =
+                PttAudioFormat::rtpTicksForSamples(static_cast<uint32_t>(frameSamples));
+
+            // DTX: silence past the hangover stays off the shared channel
+            const TransmitDecision decision = transmitGate_.onFrame(
+                frameBuffer, frameSamples, encodedBytes, settings.frameDurationMs);
+
+            int64_t ttffMicros = -1;
+            if (firstFrame) {
+                firstFrame = false;
+                ttffMicros = std::max<int64_t>(0, traceClockMicros() - keyUpMicros);
+            }
+
+            encodeTelemetry_.beginUpdate();
+            if (ttffMicros >= 0) {
+                const uint64_t ttff = static_cast<uint64_t>(ttffMicros);
+                encodeTelemetry_.add(EncodeField::KEY_UPS);
+                if (keyUpWarm) {
+                    encodeTelemetry_.add(EncodeField::WARM_KEY_UPS);
+                }
+                encodeTelemetry_.set(EncodeField::TTFF_LAST_MICROS, ttff);
+                encodeTelemetry_.add(EncodeField::TTFF_TOTAL_MICROS, ttff);
+                encodeTelemetry_.max(EncodeField::TTFF_MAX_MICROS, ttff);
+            }
+            encodeTelemetry_.add(EncodeField::FRAMES_ENCODED);
+            encodeTelemetry_.add(EncodeField::BYTES_ENCODED, static_cast<uint64_t>(encodedBytes));
+            encodeTelemetry_.add(EncodeField::PCM_BYTES, frameSamples * sizeof(int16_t));
+            encodeTelemetry_.set(EncodeField::DSP_GAIN_PERCENT,
+                static_cast<uint64_t>(100.0f * std::pow(10.0f, captureDsp_.getGainDb() / 20.0f) + 0.5f));
+            encodeTelemetry_.add(EncodeField::DSP_LIMITED_SAMPLES, limitedSamples);
+            if (!decision.send) {
+                encodeTelemetry_.add(EncodeField::FRAMES_SUPPRESSED);
+                encodeTelemetry_.add(EncodeField::BYTES_SUPPRESSED,
+                                     static_cast<uint64_t>(encodedBytes) + kPacketOverheadBytes);
+                encodeTelemetry_.add(EncodeField::SUPPRESSED_MS, settings.frameDurationMs);
+            } else if (decision.comfortNoise) {
+                encodeTelemetry_.add(EncodeField::COMFORT_NOISE_FRAMES);
+            } else if (decision.marker) {
+                encodeTelemetry_.add(EncodeField::TALKSPURTS);
+            }
+            encodeTelemetry_.endUpdate();
+
+            // Send encoded Opus data via callback (sendto happens here, not in Oboe)
+            if (callback_) {
+                if (decision.send) {
+                    callback_->onAudioData(opusBuffer, encodedBytes, decision.marker,
+                                           frameTicks, captureMicros);
+                } else {
+                    callback_->onAudioSuppressed(frameTicks);
+                }
+            }
+
+            if (tracing && decision.send) {
+                latencyTracer_.recordTx({captureMicros, encodeMicros, traceClockMicros()});
+            }
+
+            if (ttffMicros >= 0) {
+                __android_log_print(ANDROID_LOG_INFO, TAG,
+                    "First frame %lld us after key-up (%s stream)",
+                    static_cast<long long>(ttffMicros), keyUpWarm ? "warm" : "cold");
+            }
+        } else {
+            encodeTelemetry_.increment(EncodeField::ENCODE_ERRORS);
+            __android_log_print(ANDROID_LOG_WARN, TAG,
+                "Opus encode failed: %d", encodedBytes);
+        }
+    }
+
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Encoder thread stopped");
+}
+
+void AudioEngine::applyEncoderSettings(const EncoderSettings& settings) {
+    {
+        std::lock_guard<std::mutex> encoderLock(encoderMutex_);
+        if (!opusEncoder_) {
+            return;
+        }
+        opusEncoder_->setBitrate(settings.bitrate);
+        opusEncoder_->setFEC(settings.fec);
+        opusEncoder_->setPacketLossPercent(settings.packetLossPercent);
+        opusEncoder_->setComplexity(settings.complexity);
+    }
+
+    if (callback_) {
+        callback_->onEncoderSettingsChanged(settings);
+    }
+}
+
+void AudioEngine::setLatencyTracing(bool enable, bool atrace) {
+    if (enable && !latencyTracer_.isEnabled()) {
+        latencyTracer_.reset();
+    }
+    latencyTracer_.setAtraceEnabled(enable && atrace);
+    latencyTracer_.setEnabled(enable);
+}
+
+AudioEngine::LatencyReport AudioEngine::getLatencyReport() {
+    LatencyReport report;
+    report.pipeline = latencyTracer_.collect();
+    report.inputDeviceMs = 0.0;
+    report.outputDeviceMs = 0.0;
+
+    {
+        std::lock_guard<std::mutex> lock(captureStreamMutex_);
+        if (captureStream_) {
+            auto result = captureStream_->calculateLatencyMillis();
+            if (result) {
+                report.inputDeviceMs = result.value();
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+        if (playbackStream_) {
+            auto result = playbackStream_->calculateLatencyMillis();
+            if (result) {
+                report.outputDeviceMs = result.value();
+            }
+        }
     }
 
+    // Delay the quality scores use from here on
+    const LatencyPercentiles& mouthToEar =
+        report.pipeline.stages[static_cast<size_t>(LatencyStage::MOUTH_TO_EAR)];
+    qualityMonitor_.setPathDelay(
+        mouthToEar.samples > 0 ? mouthToEar.p50Micros / 1000.0 : 0.0,
+        report.inputDeviceMs + report.outputDeviceMs, kDecodeAheadMs);
+    return report;
+}
+
+void AudioEngine::onReceiverReport(uint32_t reporterSsrc, float fractionLost,
+                                   uint32_t jitterMs) {
+    const int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    rateController_.onReceiverReport(reporterSsrc, fractionLost, jitterMs, nowMs);
+}
+
+void AudioEngine::setBitrateCeiling(int bitrate) {
+    // Picked up by the encoder thread at its next evaluation
+    rateController_.setBitrateCeiling(bitrate);
+}
+
+void AudioEngine::setAdaptiveBitrate(bool enable) {
+    rateController_.setEnabled(enable);
     __android_log_print(ANDROID_LOG_INFO, TAG,
-        "Audio capture stopped");
+        "Adaptive bitrate %s", enable ? "enabled" : "disabled");
+}
+
+bool AudioEngine::setCodecProfile(uint32_t channel, size_t profile) {
+    if (!receiveStreams_ || !receiveStreams_->setChannelProfile(channel, profile)) {
+        return false;
+    }
+
+    if (channel == kHomeChannel) {
+        const CodecProfile& config = kCodecProfiles[profile];
+        txProfile_.store(profile);
+        rateController_.pinSettings(config.adaptive
+            ? std::nullopt : std::optional<EncoderSettings>(config.encoder));
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "Transmit codec profile %s (%s)", config.name,
+            config.adaptive ? "adaptive" : "fixed");
+    }
+    return true;
+}
+
+size_t AudioEngine::getCodecProfile(uint32_t channel) const {
+    return receiveStreams_ ? receiveStreams_->getChannelProfile(channel) : kDefaultCodecProfile;
+}
+
+std::array<ProfileQuality, kCodecProfileCount> AudioEngine::getProfileResults() {
+    getLatencyReport();
+    return qualityMonitor_.getResults();
+}
+
+AudioEngine::TransmitCounters AudioEngine::readTransmitCounters() const {
+    using Encode = TelemetryBlock<EncodeField>;
+    const auto encode = encodeTelemetry_.snapshot();
+    const uint64_t suppressed = encode[Encode::index(EncodeField::FRAMES_SUPPRESSED)];
+
+    TransmitCounters counters;
+    counters.frames = encode[Encode::index(EncodeField::FRAMES_ENCODED)];
+    counters.packets = counters.frames - suppressed;
+    // BYTES_SUPPRESSED carries each withheld packet's header overhead
+    counters.bytes = encode[Encode::index(EncodeField::BYTES_ENCODED)] -
+        (encode[Encode::index(EncodeField::BYTES_SUPPRESSED)] - suppressed * kPacketOverheadBytes);
+    return counters;
 }
 
 bool AudioEngine::startPlayback() {
@@ -215,32 +768,46 @@ bool AudioEngine::startPlayback() {
         return true;
     }
 
-    if (!playbackStream_) {
+    if (!isInitialized()) {
         __android_log_print(ANDROID_LOG_ERROR, TAG,
             "Playback stream not initialized");
         return false;
     }
 
-    // Reset decoder state
-    std::lock_guard<std::mutex> codecLock(codecMutex_);
-    if (opusDecoder_) {
-        opusDecoder_->reset();
+    // Worker may still be running if Oboe closed the stream on error;
+    // it must be quiescent before the ring is reset (and may have left
+    // the stream parked)
+    stopDecoderThread();
+
+    // Opened once in initialize(); only reopened if Oboe closed it
+    if (!ensurePlaybackStream()) {
+        return false;
     }
 
-    // CRITICAL FIX: Use public method instead of direct private member access
-    playbackCallback_->resetJitterBuffer();
+    // Drop all talkers; decoders reset lazily on the decoder thread
+    if (receiveStreams_) {
+        receiveStreams_->reset();
+    }
 
-    auto result = playbackStream_->requestStart();
-    if (result != oboe::Result::OK) {
-        __android_log_print(ANDROID_LOG_ERROR, TAG,
-            "Failed to start playback: %s",
-            oboe::convertToText(result));
-        // CRITICAL FIX: Close stream on start failure to prevent leak
-        playbackStream_->close();
-        playbackStream_.reset();
-        return false;
+    // Clear playback ring (consumer is idle until isPlaying_ is set)
+    playbackRing_.reset();
+    underrunRunSamples_ = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+        auto result = playbackStream_->requestStart();
+        if (result != oboe::Result::OK) {
+            __android_log_print(ANDROID_LOG_ERROR, TAG,
+                "Failed to start playback: %s",
+                oboe::convertToText(result));
+            // CRITICAL FIX: Close stream on start failure to prevent leak
+            playbackStream_->close();
+            playbackStream_.reset();
+            return false;
+        }
     }
 
+    startDecoderThread();
     isPlaying_.store(true);
     __android_log_print(ANDROID_LOG_INFO, TAG,
         "Audio playback started (Opus decoding enabled)");
@@ -254,29 +821,250 @@ void AudioEngine::stopPlayback() {
 
     isPlaying_.store(false);
 
-    if (playbackStream_) {
-        playbackStream_->stop();
-        playbackStream_->close();
-        playbackStream_.reset();
+    {
+        std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+        if (playbackStream_) {
+            // Stopped, not closed: restart skips the open
+            playbackStream_->stop();
+        }
     }
 
+    // Callback can no longer consume; stop decoding ahead (or waiting idle)
+    stopDecoderThread();
+
+    const JitterBufferStats jitter = getJitterStats();
+    const PlaybackPipelineStats pipeline = getPlaybackPipelineStats();
     __android_log_print(ANDROID_LOG_INFO, TAG,
-        "Audio playback stopped");
+        "Audio playback stopped (played=%llu, lost=%llu, recovered=%llu, concealed=%llu, "
+        "underruns=%llu/%llu samples, ringHighWater=%llu)",
+        static_cast<unsigned long long>(jitter.framesPlayed),
+        static_cast<unsigned long long>(jitter.packetsLost),
+        static_cast<unsigned long long>(jitter.framesRecovered),
+        static_cast<unsigned long long>(jitter.framesConcealed),
+        static_cast<unsigned long long>(pipeline.underrunEvents),
+        static_cast<unsigned long long>(pipeline.underrunSamples),
+        static_cast<unsigned long long>(pipeline.ringHighWaterMark));
+}
+
+void AudioEngine::startDecoderThread() {
+    if (decoderRunning_.exchange(true)) {
+        return;
+    }
+    decoderThread_ = std::thread([this]() { decoderLoop(); });
+}
+
+void AudioEngine::stopDecoderThread() {
+    decoderRunning_.store(false);
+    wakeDecoder();
+    if (decoderThread_.joinable()) {
+        decoderThread_.join();
+    }
+    playoutActive_.store(false);
+}
+
+// ============================================================================
+// Decoder Thread - Drains jitter buffers, decodes and mixes into playback ring
+// ============================================================================
+
+void AudioEngine::decoderLoop() {
+    ThreadScope threadScope(threadManager_.get(), ThreadRole::DECODER, "ptt-decoder");
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Decoder thread started");
+
+    int16_t mixBuffer[kDecodeChunkSamples];
+    const size_t decodeAheadSamples = PttAudioFormat::samplesForDuration(kDecodeAheadMs);
+
+    // Silence is measured from the last audio mixed or packet received
+    uint64_t packetsSeen = packetsEnqueued_.load();
+    int64_t lastAudioMicros = traceClockMicros();
+
+    while (decoderRunning_.load()) {
+        powerMeter_->wake();
+        bool mixed = false;
+
+        // Top the ring up to the decode-ahead target in 10ms chunks. The jitter
+        // buffers are pulled at the rate the callback drains the ring, so
+        // their pacing is unchanged; the ring only adds kDecodeAheadMs.
+        while (playbackRing_.availableToRead() < decodeAheadSamples &&
+               playbackRing_.availableToWrite() >= kDecodeChunkSamples) {
+            // Queued audio ahead of this chunk plays first
+            const int64_t playoutMicros = latencyTracer_.isEnabled() ?
+                traceClockMicros() + static_cast<int64_t>(playbackRing_.availableToRead()) *
+                                     1000000 / kSampleRate : 0;
+            const size_t talkers = receiveStreams_ ?
+                receiveStreams_->render(mixBuffer, kDecodeChunkSamples, playoutMicros) : 0;
+            if (talkers == 0) {
+                // Between talkspurts (or rebuffering): nothing to queue
+                playoutActive_.store(false, std::memory_order_relaxed);
+                break;
+            }
+
+            const size_t limitedSamples = playbackDsp_.process(mixBuffer, kDecodeChunkSamples);
+
+            playbackRing_.write(mixBuffer, kDecodeChunkSamples);
+            playoutActive_.store(true, std::memory_order_relaxed);
+            mixed = true;
+
+            mixTelemetry_.beginUpdate();
+            mixTelemetry_.add(MixField::CHUNKS_MIXED);
+            mixTelemetry_.set(MixField::DSP_GAIN_PERCENT,
+                static_cast<uint64_t>(100.0f * std::pow(10.0f, playbackDsp_.getGainDb() / 20.0f) + 0.5f));
+            mixTelemetry_.add(MixField::DSP_LIMITED_SAMPLES, limitedSamples);
+            mixTelemetry_.max(MixField::RING_HIGH_WATER, playbackRing_.availableToRead());
+            mixTelemetry_.endUpdate();
+        }
+
+        const int64_t nowMicros = traceClockMicros();
+        const uint64_t packets = packetsEnqueued_.load();
+        const IdlePlayback idlePlayback = idlePlayback_.load();
+        if (mixed || packets != packetsSeen || playbackRing_.availableToRead() > 0) {
+            packetsSeen = packets;
+            lastAudioMicros = nowMicros;
+        } else if (idlePlayback != IdlePlayback::KEEP &&
+                   nowMicros - lastAudioMicros >=
+                       static_cast<int64_t>(idleAfterMs_.load()) * 1000) {
+            // Nothing to play and nothing arriving: stop polling altogether
+            parkPlayback(idlePlayback, packetsSeen);
+            packetsSeen = packetsEnqueued_.load();
+            lastAudioMicros = traceClockMicros();
+            continue;
+        }
+
+        // Callback never signals (that would be a syscall), so poll the ring
+        threadScope.sleepFor(kDecoderPollIntervalMs);
+    }
+
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Decoder thread stopped");
+}
+
+// ============================================================================
+// Worker thread management
+// ============================================================================
+
+void AudioEngine::setThreadManager(std::shared_ptr<ThreadManager> manager) {
+    threadManager_ = std::move(manager);
+    recorder_.setThreadManager(threadManager_.get());
+}
+
+// ============================================================================
+// Idle power policy
+// ============================================================================
+
+void AudioEngine::setPowerConfig(const PowerConfig& config) {
+    idleAfterMs_.store(std::max(config.idleAfterMs, kMinIdleAfterMs));
+    idlePlayback_.store(config.idlePlayback);
+    // A parked decoder re-arms under the new policy
+    wakeDecoder();
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Idle playback %d after %u ms",
+        static_cast<int>(config.idlePlayback), idleAfterMs_.load());
+}
+
+PowerConfig AudioEngine::getPowerConfig() const {
+    PowerConfig config;
+    config.idlePlayback = idlePlayback_.load();
+    config.idleAfterMs = idleAfterMs_.load();
+    return config;
+}
+
+void AudioEngine::parkPlayback(IdlePlayback mode, uint64_t packetsSeen) {
+    {
+        std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+        if (!isPlaying_.load() || !playbackStream_) {
+            return;
+        }
+        playbackStream_->stop();
+        if (mode == IdlePlayback::POWER_SAVING) {
+            playbackStream_->close();
+            playbackStream_.reset();
+            if (openPlaybackStream(true) == oboe::Result::OK) {
+                playbackStream_->requestStart();
+            } else {
+                // Parked without a stream; the re-arm below opens a new one
+                playbackStream_.reset();
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        idleWake_ = false;
+    }
+    // Seq-cst pair with onPacketEnqueued(): either it sees us idle, or we see its packet
+    playbackIdle_.store(true);
+    updatePowerMode();
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Playback idle (%s)",
+        mode == IdlePlayback::STOP ? "stopped" : "power saving");
+
+    {
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idleCv_.wait(lock, [&]() {
+            return idleWake_ || !decoderRunning_.load() || packetsEnqueued_.load() != packetsSeen;
+        });
+    }
+    playbackIdle_.store(false);
+    updatePowerMode();
+    if (!decoderRunning_.load()) {
+        return;     // stopPlayback() owns the stream from here
+    }
+
+    // Re-arm: the jitter buffer holds the packet for its playout delay, so a
+    // stream start fits before the first frame is due
+    std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+    if (!isPlaying_.load()) {
+        return;
+    }
+    oboe::Result result = ensurePlaybackStreamLocked() ? playbackStream_->requestStart()
+                                                       : oboe::Result::ErrorClosed;
+    if (result != oboe::Result::OK) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Failed to re-arm playback: %s", oboe::convertToText(result));
+        if (callback_) {
+            callback_->onAudioError(static_cast<int>(result));
+        }
+        return;
+    }
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Playback re-armed");
+}
+
+void AudioEngine::wakeDecoder() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        idleWake_ = true;
+    }
+    idleCv_.notify_all();
+}
+
+void AudioEngine::onPacketEnqueued() {
+    packetsEnqueued_.fetch_add(1);
+    if (playbackIdle_.load()) {
+        // Taking the lock orders this with the decoder's predicate check
+        { std::lock_guard<std::mutex> lock(idleMutex_); }
+        idleCv_.notify_one();
+    }
+}
+
+void AudioEngine::updatePowerMode() {
+    const bool idle = playbackIdle_.load() && !isCapturing_.load();
+    powerMeter_->setMode(idle ? PowerMode::IDLE : PowerMode::ACTIVE, traceClockMicros());
 }
 
 int32_t AudioEngine::getLatencyMillis() const {
     double latency = 0.0;
     
-    if (captureStream_) {
-        auto result = captureStream_->calculateLatencyMillis();
-        if (result) {
-            latency += result.value();
+    {
+        std::lock_guard<std::mutex> lock(captureStreamMutex_);
+        if (captureStream_) {
+            auto result = captureStream_->calculateLatencyMillis();
+            if (result) {
+                latency += result.value();
+            }
         }
     }
-    if (playbackStream_) {
-        auto result = playbackStream_->calculateLatencyMillis();
-        if (result) {
-            latency += result.value();
+    {
+        std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+        if (playbackStream_) {
+            auto result = playbackStream_->calculateLatencyMillis();
+            if (result) {
+                latency += result.value();
+            }
         }
     }
     
@@ -286,118 +1074,630 @@ int32_t AudioEngine::getLatencyMillis() const {
     return static_cast<int32_t>(latency);
 }
 
+// ============================================================================
+// Stream lifecycle - route changes and recovery of streams Oboe closed
+// ============================================================================
+
+void AudioEngine::setRoute(const AudioRoute& route) {
+    AudioRoute previous;
+    {
+        std::lock_guard<std::mutex> lock(routeMutex_);
+        previous = route_;
+        route_ = route;
+    }
+    uint32_t work = 0;
+    if (route.inputDeviceId != previous.inputDeviceId || route.echoCancel != previous.echoCancel) {
+        work |= kCaptureRoute;
+    }
+    if (route.outputDeviceId != previous.outputDeviceId) {
+        work |= kPlaybackRoute;
+    }
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Route: input device %d, output device %d, AEC %s",
+        route.inputDeviceId, route.outputDeviceId, route.echoCancel ? "on" : "off");
+
+    // Streams not opened yet pick the route up when they are
+    if (work != 0 && isInitialized()) {
+        postStreamWork(work);
+    }
+}
+
+AudioRoute AudioEngine::getRoute() const {
+    std::lock_guard<std::mutex> lock(routeMutex_);
+    return route_;
+}
+
 void AudioEngine::setSpeakerOutput(bool enable) {
-    // Configure output to speaker with AEC
-    aecEnabled_ = enable;
-    __android_log_print(ANDROID_LOG_DEBUG, TAG,
-        "Speaker output: %s, AEC: %s",
-        enable ? "enabled" : "disabled",
-        aecEnabled_ ? "enabled" : "disabled");
+    AudioRoute route = getRoute();
+    route.echoCancel = enable;
+    setRoute(route);
 }
 
-void AudioEngine::setBluetoothOutput(bool enable) {
-    __android_log_print(ANDROID_LOG_DEBUG, TAG,
-        "Bluetooth output: %s", enable ? "enabled" : "disabled");
+void AudioEngine::startStreamWorker() {
+    if (streamThread_.joinable()) {
+        return;
+    }
+    {
+        // Streams were just opened on the current route
+        std::lock_guard<std::mutex> lock(streamWorkMutex_);
+        streamWork_ = 0;
+        streamBusy_ = 0;
+        streamWorkerStop_ = false;
+    }
+    streamsRecovering_.store(0);
+    streamTelemetry_.reset();
+    streamThread_ = std::thread([this]() { streamWorkerLoop(); });
 }
 
-AudioEngine::CodecStats AudioEngine::getStats() const {
-    std::lock_guard<std::mutex> lock(statsMutex_);
-    return stats_;
+void AudioEngine::stopStreamWorker() {
+    {
+        std::lock_guard<std::mutex> lock(streamWorkMutex_);
+        streamWorkerStop_ = true;
+    }
+    streamWorkCv_.notify_all();
+    if (streamThread_.joinable()) {
+        streamThread_.join();
+    }
 }
 
-void AudioEngine::enqueueReceivedAudio(const uint8_t* data, size_t size) {
-    // Forward received audio to PlaybackCallback
-    // The data is Opus-encoded and will be decoded in PlaybackCallback::onAudioReady
-    if (playbackCallback_) {
-        playbackCallback_->enqueueAudio(data, size);
+void AudioEngine::postStreamWork(uint32_t work) {
+    const int64_t nowMicros = traceClockMicros();
+    {
+        std::lock_guard<std::mutex> lock(streamWorkMutex_);
+        // A recovery is timed from its first request, not from later ones it absorbs
+        const uint32_t outstanding = streamWork_ | streamBusy_;
+        if ((work & (kCaptureLost | kCaptureRoute)) &&
+            !(outstanding & (kCaptureLost | kCaptureRoute))) {
+            streamWorkSince_[0] = nowMicros;
+        }
+        if ((work & (kPlaybackLost | kPlaybackRoute)) &&
+            !(outstanding & (kPlaybackLost | kPlaybackRoute))) {
+            streamWorkSince_[1] = nowMicros;
+        }
+        streamWork_ |= work;
     }
+    streamsRecovering_.fetch_or(work & (kCaptureLost | kPlaybackLost));
+    streamWorkCv_.notify_one();
 }
 
-// ============================================================================
-// Capture Callback - Encodes PCM to Opus and sends to network
-// ============================================================================
+void AudioEngine::streamWorkerLoop() {
+    // Named only: occasional control work, not a pipeline role
+    ThreadScope threadScope(nullptr, ThreadRole::COUNT, "ptt-streams");
+
+    struct Direction {
+        const char* name;
+        uint32_t lostBit;
+        uint32_t routeBit;
+        uint32_t pending = 0;           // Work bits being attempted
+        size_t attempts = 0;            // Failed so far
+        int64_t retryAtMicros = 0;
+    };
+    std::array<Direction, 2> directions{{
+        {"Capture", kCaptureLost, kCaptureRoute},
+        {"Playback", kPlaybackLost, kPlaybackRoute}
+    }};
+
+    std::unique_lock<std::mutex> lock(streamWorkMutex_);
+    while (!streamWorkerStop_) {
+        int64_t nextRetryMicros = 0;
+        for (const Direction& direction : directions) {
+            if (direction.pending &&
+                (nextRetryMicros == 0 || direction.retryAtMicros < nextRetryMicros)) {
+                nextRetryMicros = direction.retryAtMicros;
+            }
+        }
+        const auto ready = [this]() { return streamWork_ != 0 || streamWorkerStop_; };
+        if (nextRetryMicros == 0) {
+            streamWorkCv_.wait(lock, ready);
+        } else {
+            const int64_t waitMicros = std::max<int64_t>(0, nextRetryMicros - traceClockMicros());
+            streamWorkCv_.wait_for(lock, std::chrono::microseconds(waitMicros), ready);
+        }
+        if (streamWorkerStop_) {
+            break;
+        }
+        const uint32_t work = streamWork_;
+        streamWork_ = 0;
+        const std::array<int64_t, 2> since = streamWorkSince_;
+        lock.unlock();
+
+        for (size_t i = 0; i < directions.size(); ++i) {
+            Direction& direction = directions[i];
+            const uint32_t fresh = work & (direction.lostBit | direction.routeBit);
+            if (fresh) {
+                direction.pending |= fresh;
+                direction.attempts = 0;
+                direction.retryAtMicros = 0;
+            }
+            if (!direction.pending || direction.retryAtMicros > traceClockMicros()) {
+                continue;
+            }
 
-oboe::DataCallbackResult CaptureCallback::onAudioReady(
-    oboe::AudioStream* stream,
-    void* audioData,
-    int32_t numFrames) {
+            const bool routeChange = direction.pending & direction.routeBit;
+            const bool reopened = i == 0 ? reopenCapture(routeChange) : reopenPlayback(routeChange);
+            if (reopened) {
+                const uint64_t micros = static_cast<uint64_t>(
+                    std::max<int64_t>(0, traceClockMicros() - since[i]));
+                streamTelemetry_.beginUpdate();
+                if (direction.pending & direction.lostBit) {
+                    streamTelemetry_.add(StreamField::RECOVERIES);
+                }
+                if (routeChange) {
+                    streamTelemetry_.add(StreamField::ROUTE_CHANGES);
+                }
+                streamTelemetry_.set(StreamField::LAST_RECOVERY_MICROS, micros);
+                streamTelemetry_.max(StreamField::MAX_RECOVERY_MICROS, micros);
+                streamTelemetry_.add(StreamField::TOTAL_RECOVERY_MICROS, micros);
+                streamTelemetry_.endUpdate();
+                __android_log_print(ANDROID_LOG_INFO, TAG, "%s stream %s in %llu us (attempt %zu)",
+                    direction.name, direction.pending & direction.lostBit ? "recovered" : "rerouted",
+                    static_cast<unsigned long long>(micros), direction.attempts + 1);
+            } else if (++direction.attempts < kStreamRetryDelaysMs.size()) {
+                direction.retryAtMicros = traceClockMicros() +
+                    static_cast<int64_t>(kStreamRetryDelaysMs[direction.attempts]) * 1000;
+                continue;
+            } else {
+                streamTelemetry_.increment(StreamField::RECOVERY_FAILURES);
+                __android_log_print(ANDROID_LOG_ERROR, TAG, "%s stream not reopened after %zu attempts",
+                    direction.name, direction.attempts);
+                dropStreamSession(i == 0);
+            }
+            streamsRecovering_.fetch_and(~direction.lostBit);
+            direction.pending = 0;
+            direction.attempts = 0;
+        }
 
-    if (!engine_->isCapturing_.load()) {
-        std::memset(audioData, 0, numFrames * sizeof(int16_t));
-        return oboe::DataCallbackResult::Continue;
+        lock.lock();
+        streamBusy_ = directions[0].pending | directions[1].pending;
     }
+}
 
-    // CRITICAL FIX: Avoid nested locking to prevent deadlock
-    // Lock ordering: always acquire pcmBufferMutex_ first, then release before acquiring codecMutex_
-    // This prevents deadlock when playback and capture callbacks run concurrently
+bool AudioEngine::reopenCapture(bool routeChange) {
+    std::lock_guard<std::mutex> lock(captureStreamMutex_);
+    const bool usable = isStreamUsable(captureStream_);
+    if (usable && !routeChange) {
+        return true;    // startCapture() got there first
+    }
 
-    bool needEncode = false;
-    int16_t frameBuffer[OPUS_FRAME_SIZE];
+    const bool live = isCapturing_.load() || warmStandby_.load();
+    std::shared_ptr<oboe::AudioStream> previous = std::move(captureStream_);
+    // Onto another device: the old stream keeps running until the new one is open
+    const int32_t deviceId = getRoute().inputDeviceId;
+    const bool makeBeforeBreak = usable && deviceId != kDefaultAudioDevice &&
+                                 deviceId != previous->getDeviceId();
+    if (previous && !makeBeforeBreak) {
+        if (usable) {
+            previous->stop();
+        }
+        previous->close();
+        previous.reset();
+    }
 
-    // Step 1: Add samples to buffer (holds pcmBufferMutex_)
-    {
-        std::lock_guard<std::mutex> lock(engine_->pcmBufferMutex_);
+    oboe::Result result = openCaptureStream();
+    if (result != oboe::Result::OK) {
+        __android_log_print(ANDROID_LOG_WARN, TAG, "Capture reopen failed: %s",
+            oboe::convertToText(result));
+        // Still on the old device if it was kept
+        captureStream_ = std::move(previous);
+        return false;
+    }
+    // One callback at a time feeds the capture ring
+    if (previous) {
+        previous->stop();
+    }
+    if (live) {
+        result = captureStream_->requestStart();
+    }
+    if (previous) {
+        previous->close();
+    }
+    if (result != oboe::Result::OK) {
+        __android_log_print(ANDROID_LOG_WARN, TAG, "Capture restart failed: %s",
+            oboe::convertToText(result));
+        captureStream_->close();
+        captureStream_.reset();
+        return false;
+    }
+    return true;
+}
 
-        const int16_t* input = static_cast<const int16_t*>(audioData);
+bool AudioEngine::reopenPlayback(bool routeChange) {
+    std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+    const bool usable = isStreamUsable(playbackStream_);
+    if (usable && !routeChange) {
+        return true;    // startPlayback() or the idle re-arm got there first
+    }
 
-        // Add samples to buffer
-        for (int32_t i = 0; i < numFrames; ++i) {
-            engine_->pcmBuffer_.push_back(input[i]);
+    // Parked: a PowerSaving stream keeps running, a stopped one stays stopped
+    // (the re-arm starts it)
+    const bool idle = playbackIdle_.load();
+    const bool powerSaving = idle && idlePlayback_.load() == IdlePlayback::POWER_SAVING;
+    const bool live = isPlaying_.load() && (!idle || powerSaving);
+    std::shared_ptr<oboe::AudioStream> previous = std::move(playbackStream_);
+    const int32_t deviceId = getRoute().outputDeviceId;
+    const bool makeBeforeBreak = usable && deviceId != kDefaultAudioDevice &&
+                                 deviceId != previous->getDeviceId();
+    if (previous && !makeBeforeBreak) {
+        if (usable) {
+            previous->stop();
         }
+        previous->close();
+        previous.reset();
+    }
 
-        // Check if we have a complete Opus frame
-        if (engine_->pcmBuffer_.size() >= OPUS_FRAME_SIZE) {
-            // Copy frame data to local buffer
-            std::copy(engine_->pcmBuffer_.begin(),
-                     engine_->pcmBuffer_.begin() + OPUS_FRAME_SIZE,
-                     frameBuffer);
-
-            // Remove processed samples (keep any excess)
-            engine_->pcmBuffer_.erase(
-                engine_->pcmBuffer_.begin(),
-                engine_->pcmBuffer_.begin() + OPUS_FRAME_SIZE
-            );
+    oboe::Result result = openPlaybackStream(powerSaving);
+    if (result != oboe::Result::OK) {
+        __android_log_print(ANDROID_LOG_WARN, TAG, "Playback reopen failed: %s",
+            oboe::convertToText(result));
+        playbackStream_ = std::move(previous);
+        playbackPowerSaving_ = playbackStream_ && powerSaving;
+        return false;
+    }
+    // The ring has one reader: the old callback stops before the new one runs.
+    // Decoded audio queued meanwhile plays on the new device.
+    if (previous) {
+        previous->stop();
+    }
+    if (live) {
+        result = playbackStream_->requestStart();
+    }
+    if (previous) {
+        previous->close();
+    }
+    if (result != oboe::Result::OK) {
+        __android_log_print(ANDROID_LOG_WARN, TAG, "Playback restart failed: %s",
+            oboe::convertToText(result));
+        playbackStream_->close();
+        playbackStream_.reset();
+        return false;
+    }
+    return true;
+}
 
-            needEncode = true;
+void AudioEngine::dropStreamSession(bool capture) {
+    if (capture) {
+        std::lock_guard<std::mutex> lock(captureStreamMutex_);
+        if (isStreamUsable(captureStream_)) {
+            return;     // Route change failed; the old device still works
+        }
+        isCapturing_.store(false);
+        updatePowerMode();
+        // Nothing feeds the ring any more. Joined under the stream lock (the
+        // encoder never takes it), so a startCapture() cannot slip in between
+        // the check above and the join and lose its new worker.
+        stopEncoderThread();
+    } else {
+        std::lock_guard<std::mutex> lock(playbackStreamMutex_);
+        if (isStreamUsable(playbackStream_)) {
+            return;
         }
+        isPlaying_.store(false);
+    }
+    if (callback_) {
+        callback_->onAudioError(static_cast<int>(oboe::Result::ErrorDisconnected));
+    }
+}
+
+AudioEngine::CodecStats AudioEngine::getStats() const {
+    using Encode = TelemetryBlock<EncodeField>;
+    const auto encode = encodeTelemetry_.snapshot();
+
+    CodecStats stats{};
+    stats.framesEncoded = encode[Encode::index(EncodeField::FRAMES_ENCODED)];
+    stats.bytesEncoded = encode[Encode::index(EncodeField::BYTES_ENCODED)];
+    stats.bytesTransmitted = encode[Encode::index(EncodeField::PCM_BYTES)];
+    // Derived on read, not per frame
+    stats.compressionRatio = stats.bytesEncoded > 0 ?
+        static_cast<double>(stats.bytesTransmitted) / static_cast<double>(stats.bytesEncoded) : 0.0;
+
+    // Decode happens per receive stream, counted there
+    if (receiveStreams_) {
+        stats.framesDecoded = receiveStreams_->getDecodeStats().framesDecoded;
     }
+    return stats;
+}
 
-    // Step 2: Encode if we have a complete frame (holds codecMutex_ separately)
-    // NO NESTED LOCKS - prevents deadlock
-    if (needEncode) {
-        std::lock_guard<std::mutex> codecLock(engine_->codecMutex_);
+void AudioEngine::getTelemetry(TelemetrySnapshot& snapshot) const {
+    snapshot.timestampMicros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    const CapturePipelineStats capture = getCapturePipelineStats();
+    snapshot.capture.callbacks = capture.callbackCount;
+    snapshot.capture.overruns = capture.callbackOverruns;
+    snapshot.capture.droppedSamples = capture.droppedSamples;
+    snapshot.capture.ringHighWater = capture.ringHighWaterMark;
+    snapshot.capture.maxCallbackMicros = capture.maxCallbackMicros;
+
+    using Encode = TelemetryBlock<EncodeField>;
+    const auto encode = encodeTelemetry_.snapshot();
+    snapshot.encode.framesEncoded = encode[Encode::index(EncodeField::FRAMES_ENCODED)];
+    snapshot.encode.bytesEncoded = encode[Encode::index(EncodeField::BYTES_ENCODED)];
+    snapshot.encode.pcmBytes = encode[Encode::index(EncodeField::PCM_BYTES)];
+    snapshot.encode.encodeErrors = encode[Encode::index(EncodeField::ENCODE_ERRORS)];
+    snapshot.encode.settingsChanges = encode[Encode::index(EncodeField::SETTINGS_CHANGES)];
+
+    snapshot.dtx.framesSuppressed = encode[Encode::index(EncodeField::FRAMES_SUPPRESSED)];
+    snapshot.dtx.bytesSuppressed = encode[Encode::index(EncodeField::BYTES_SUPPRESSED)];
+    snapshot.dtx.suppressedMs = encode[Encode::index(EncodeField::SUPPRESSED_MS)];
+    snapshot.dtx.talkspurts = encode[Encode::index(EncodeField::TALKSPURTS)];
+    snapshot.dtx.comfortNoiseFrames = encode[Encode::index(EncodeField::COMFORT_NOISE_FRAMES)];
+
+    snapshot.keyUp.keyUps = encode[Encode::index(EncodeField::KEY_UPS)];
+    snapshot.keyUp.warmKeyUps = encode[Encode::index(EncodeField::WARM_KEY_UPS)];
+    snapshot.keyUp.lastTtffMicros = encode[Encode::index(EncodeField::TTFF_LAST_MICROS)];
+    snapshot.keyUp.totalTtffMicros = encode[Encode::index(EncodeField::TTFF_TOTAL_MICROS)];
+    snapshot.keyUp.maxTtffMicros = encode[Encode::index(EncodeField::TTFF_MAX_MICROS)];
+
+    // Jitter buffers are internally locked, but only the receive and decoder
+    // threads contend for them - never an audio callback
+    const JitterBufferStats jitter = getJitterStats();
+    snapshot.jitter.packetsReceived = jitter.packetsReceived;
+    snapshot.jitter.packetsLost = jitter.packetsLost;
+    snapshot.jitter.packetsLate = jitter.packetsLate;
+    snapshot.jitter.packetsDiscarded = jitter.packetsDiscarded;
+    snapshot.jitter.framesPlayed = jitter.framesPlayed;
+    snapshot.jitter.framesConcealed = jitter.framesConcealed;
+    snapshot.jitter.framesRecovered = jitter.framesRecovered;
+    snapshot.jitter.framesStretched = jitter.framesStretched;
+    snapshot.jitter.jitterMs = jitter.jitterMs;
+    snapshot.jitter.targetDelayMs = jitter.targetDelayMs;
+    snapshot.jitter.currentDelayMs = jitter.currentDelayMs;
+    snapshot.jitter.activeTalkers = getActiveTalkerCount();
+    snapshot.redundancy.framesUsed = jitter.redundantUsed;
+    snapshot.redundancy.framesDiscarded = jitter.redundantDiscarded;
+
+    if (receiveStreams_) {
+        const ReceiveStreamTable::DecodeStats decode = receiveStreams_->getDecodeStats();
+        snapshot.decode.framesDecoded = decode.framesDecoded;
+        snapshot.decode.fecFrames = decode.fecFrames;
+        snapshot.decode.plcFrames = decode.plcFrames;
+        snapshot.decode.decodeErrors = decode.decodeErrors;
+    }
+    using Mix = TelemetryBlock<MixField>;
+    const auto mix = mixTelemetry_.snapshot();
+    snapshot.decode.chunksMixed = mix[Mix::index(MixField::CHUNKS_MIXED)];
+    snapshot.decode.ringHighWater = mix[Mix::index(MixField::RING_HIGH_WATER)];
+
+    const PlaybackPipelineStats playback = getPlaybackPipelineStats();
+    snapshot.playback.callbacks = playback.callbackCount;
+    snapshot.playback.underrunEvents = playback.underrunEvents;
+    snapshot.playback.underrunSamples = playback.underrunSamples;
+    snapshot.playback.underrunHistogram = playback.underrunHistogram;
+
+    snapshot.dsp.captureGainPercent = encode[Encode::index(EncodeField::DSP_GAIN_PERCENT)];
+    snapshot.dsp.captureLimitedSamples = encode[Encode::index(EncodeField::DSP_LIMITED_SAMPLES)];
+    snapshot.dsp.playbackGainPercent = mix[Mix::index(MixField::DSP_GAIN_PERCENT)];
+    snapshot.dsp.playbackLimitedSamples = mix[Mix::index(MixField::DSP_LIMITED_SAMPLES)];
+    snapshot.dsp.captureDeviceRate = static_cast<uint64_t>(captureDeviceRate_.load());
+    snapshot.dsp.playbackDeviceRate = static_cast<uint64_t>(playbackDeviceRate_.load());
+
+    const PowerTotals power = powerMeter_->snapshot(traceClockMicros());
+    snapshot.power.mode = static_cast<uint64_t>(power.mode);
+    snapshot.power.activeMs = power.micros[static_cast<size_t>(PowerMode::ACTIVE)] / 1000;
+    snapshot.power.idleMs = power.micros[static_cast<size_t>(PowerMode::IDLE)] / 1000;
+    snapshot.power.activeWakeups = power.wakeups[static_cast<size_t>(PowerMode::ACTIVE)];
+    snapshot.power.idleWakeups = power.wakeups[static_cast<size_t>(PowerMode::IDLE)];
+    snapshot.power.idleEntries = power.idleEntries;
+
+    const RecordingStats recording = recorder_.getStats();
+    snapshot.recording.bursts = recording.bursts;
+    snapshot.recording.packets = recording.packets;
+    snapshot.recording.droppedPackets = recording.droppedPackets;
+    snapshot.recording.bytesWritten = recording.bytesWritten;
+    snapshot.recording.writes = recording.writes;
+
+    const MemoryStats memory = getMemoryStats();
+    snapshot.memory.budgetBytes = memory.budgetBytes;
+    snapshot.memory.reservedBytes = memory.reservedBytes;
+    snapshot.memory.streamSlots = memory.streamSlots;
+    snapshot.memory.smallAvailable = memory.pool.available[static_cast<size_t>(PacketClass::SMALL)];
+    snapshot.memory.mtuAvailable = memory.pool.available[static_cast<size_t>(PacketClass::MTU)];
+    snapshot.memory.poolExhausted = memory.pool.exhausted[static_cast<size_t>(PacketClass::SMALL)] +
+                                    memory.pool.exhausted[static_cast<size_t>(PacketClass::MTU)];
+    snapshot.memory.packetsCompacted = memory.pool.compacted;
+    snapshot.memory.lateAllocations = memory.lateAllocations;
+
+    using Stream = TelemetryBlock<StreamField>;
+    const auto streams = streamTelemetry_.snapshot();
+    snapshot.streams.recoveries = streams[Stream::index(StreamField::RECOVERIES)];
+    snapshot.streams.recoveryFailures = streams[Stream::index(StreamField::RECOVERY_FAILURES)];
+    snapshot.streams.routeChanges = streams[Stream::index(StreamField::ROUTE_CHANGES)];
+    snapshot.streams.lastRecoveryMicros = streams[Stream::index(StreamField::LAST_RECOVERY_MICROS)];
+    snapshot.streams.maxRecoveryMicros = streams[Stream::index(StreamField::MAX_RECOVERY_MICROS)];
+    snapshot.streams.totalRecoveryMicros = streams[Stream::index(StreamField::TOTAL_RECOVERY_MICROS)];
+    snapshot.streams.recovering = streamsRecovering_.load();
+    snapshot.streams.captureDeviceId = static_cast<uint64_t>(captureDeviceId_.load());
+    snapshot.streams.playbackDeviceId = static_cast<uint64_t>(playbackDeviceId_.load());
+}
 
-        if (engine_->opusEncoder_) {
-            uint8_t opusBuffer[OPUS_MAX_PACKET_SIZE];
+AudioEngine::PlaybackPipelineStats AudioEngine::getPlaybackPipelineStats() const {
+    using Playback = TelemetryBlock<PlaybackField>;
+    const auto playback = playbackTelemetry_.snapshot();
+
+    PlaybackPipelineStats stats;
+    stats.callbackCount = playback[Playback::index(PlaybackField::CALLBACKS)];
+    stats.underrunEvents = playback[Playback::index(PlaybackField::UNDERRUN_EVENTS)];
+    stats.underrunSamples = playback[Playback::index(PlaybackField::UNDERRUN_SAMPLES)];
+    stats.ringHighWaterMark = mixTelemetry_.load(MixField::RING_HIGH_WATER);
+    for (size_t i = 0; i < kUnderrunHistogramBuckets; ++i) {
+        stats.underrunHistogram[i] = playback[Playback::index(PlaybackField::UNDERRUN_HISTOGRAM) + i];
+    }
+    return stats;
+}
 
-            int encodedBytes = engine_->opusEncoder_->encode(
-                frameBuffer,
-                OPUS_FRAME_SIZE,
-                opusBuffer,
-                sizeof(opusBuffer)
-            );
+void AudioEngine::recordUnderrun(uint64_t samples) {
+    // Playback callback only, inside a playbackTelemetry_ update
+    const uint64_t durationMs = samples * 1000 / kSampleRate;
+    size_t bucket = 0;
+    while (bucket < kUnderrunBucketLimitsMs.size() && durationMs >= kUnderrunBucketLimitsMs[bucket]) {
+        bucket++;
+    }
+    playbackTelemetry_.add(static_cast<PlaybackField>(
+        TelemetryBlock<PlaybackField>::index(PlaybackField::UNDERRUN_HISTOGRAM) + bucket));
+    playbackTelemetry_.add(PlaybackField::UNDERRUN_EVENTS);
+    playbackTelemetry_.add(PlaybackField::UNDERRUN_SAMPLES, samples);
+}
 
-            if (encodedBytes > 0) {
-                // Send encoded Opus data via callback
-                if (engine_->callback_) {
-                    engine_->callback_->onAudioData(opusBuffer, encodedBytes);
-
-                    // Update statistics (separate mutex)
-                    std::lock_guard<std::mutex> statsLock(engine_->statsMutex_);
-                    engine_->stats_.framesEncoded++;
-                    engine_->stats_.bytesEncoded += encodedBytes;
-                    engine_->stats_.bytesTransmitted += OPUS_FRAME_SIZE * sizeof(int16_t);
-                    engine_->stats_.compressionRatio =
-                        static_cast<double>(engine_->stats_.bytesTransmitted) /
-                        engine_->stats_.bytesEncoded;
-                }
-            } else {
-                __android_log_print(ANDROID_LOG_WARN, TAG,
-                    "Opus encode failed: %d", encodedBytes);
-            }
+AudioEngine::CapturePipelineStats AudioEngine::getCapturePipelineStats() const {
+    using Capture = TelemetryBlock<CaptureField>;
+    const auto capture = captureTelemetry_.snapshot();
+
+    CapturePipelineStats stats;
+    stats.callbackCount = capture[Capture::index(CaptureField::CALLBACKS)];
+    stats.callbackOverruns = capture[Capture::index(CaptureField::OVERRUNS)];
+    stats.droppedSamples = capture[Capture::index(CaptureField::DROPPED_SAMPLES)];
+    stats.ringHighWaterMark = capture[Capture::index(CaptureField::RING_HIGH_WATER)];
+    stats.maxCallbackMicros = capture[Capture::index(CaptureField::MAX_CALLBACK_MICROS)];
+    return stats;
+}
+
+void AudioEngine::enqueueReceivedAudio(const uint8_t* data, size_t size,
+                                       const RtpPacketInfo& info) {
+    // Route to the sender's receive stream (SSRC demux)
+    // The data is Opus-encoded and will be decoded on the decoder thread (AudioEngine::decoderLoop)
+    if (receiveStreams_) {
+        receiveStreams_->enqueue(data, size, info);
+        onPacketEnqueued();
+    }
+}
+
+void AudioEngine::enqueueReceivedAudio(PacketPtr packet, const RtpPacketInfo& info) {
+    if (receiveStreams_) {
+        receiveStreams_->enqueue(std::move(packet), info);
+        onPacketEnqueued();
+    }
+}
+
+std::shared_ptr<PacketPool> AudioEngine::getPacketPool() const {
+    return receiveStreams_ ? receiveStreams_->getPacketPool() : nullptr;
+}
+
+MemoryStats AudioEngine::getMemoryStats() const {
+    if (!receiveStreams_) {
+        MemoryStats stats;
+        stats.budgetBytes = memoryBudgetBytes_;
+        return stats;
+    }
+    return receiveStreams_->getMemoryStats();
+}
+
+void AudioEngine::enqueueReceivedAudio(const uint8_t* data, size_t size) {
+    // No RTP header (custom Kotlin transport): assume in-order arrival and
+    // synthesize sequence/timestamp so the jitter buffer can still pace playout
+    const uint32_t frame = localRxFrames_.fetch_add(1, std::memory_order_relaxed);
+    RtpPacketInfo info;
+    info.seq = static_cast<uint16_t>(frame);
+    info.timestamp = frame * PttAudioFormat::kRtpTimestampIncrement;
+    info.ssrc = 0;
+    info.marker = false;
+
+    enqueueReceivedAudio(data, size, info);
+}
+
+JitterBufferStats AudioEngine::getJitterStats() const {
+    return receiveStreams_ ? receiveStreams_->getAggregateJitterStats() : JitterBufferStats{};
+}
+
+size_t AudioEngine::getActiveTalkerCount() const {
+    return receiveStreams_ ? receiveStreams_->getActiveStreamCount() : 0;
+}
+
+void AudioEngine::setChannelPriority(uint32_t channel, uint8_t priority) {
+    if (receiveStreams_) {
+        receiveStreams_->setChannelPriority(channel, priority);
+    }
+}
+
+void AudioEngine::releaseChannel(uint32_t channel) {
+    if (receiveStreams_) {
+        receiveStreams_->releaseChannel(channel);
+    }
+}
+
+void AudioEngine::setDuckingGain(float gain) {
+    if (receiveStreams_) {
+        receiveStreams_->setDuckingGain(gain);
+    }
+}
+
+size_t AudioEngine::getActiveChannels(uint32_t* channels, size_t maxChannels) const {
+    return receiveStreams_ ? receiveStreams_->getActiveChannels(channels, maxChannels) : 0;
+}
+
+// ============================================================================
+// Capture Callback - Feeds PCM into the lock-free capture ring
+// ============================================================================
+
+oboe::DataCallbackResult CaptureCallback::onAudioReady(
+    oboe::AudioStream* stream,
+    void* audioData,
+    int32_t numFrames) {
+
+    engine_->powerMeter_->wake();
+
+    // Seq-cst pair with stopCapture(): either it sees us busy, or we see the stop
+    engine_->captureCallbackBusy_.store(true);
+    if (!engine_->isCapturing_.load()) {
+        engine_->captureCallbackBusy_.store(false);
+        wasCapturing_ = false;
+        std::memset(audioData, 0, numFrames * sizeof(int16_t));
+        return oboe::DataCallbackResult::Continue;
+    }
+    if (!wasCapturing_) {
+        // New session: no filter history from the previous press
+        wasCapturing_ = true;
+        resampler_.reset();
+    }
+
+    // REAL-TIME SAFE: no locks, no allocation, no syscalls on this thread.
+    // Encoding and sendto() run on the encoder thread (AudioEngine::encoderLoop).
+    // steady_clock is served from the vDSO, so timing does not enter the kernel.
+    const auto callbackStart = std::chrono::steady_clock::now();
+
+    const int16_t* input = static_cast<const int16_t*>(audioData);
+    const int32_t deviceRate = stream->getSampleRate();
+    size_t requested = 0;
+    size_t written = 0;
+    if (deviceRate == kSampleRate) {
+        requested = static_cast<size_t>(numFrames);
+        written = engine_->captureRing_.write(input, requested);
+    } else {
+        // 48 kHz device: decimate on the stack in chunks, counts in codec samples
+        int16_t decimated[CaptureResampler::maxOutput(kResamplerChunkSamples)];
+        for (size_t offset = 0; offset < static_cast<size_t>(numFrames);
+             offset += kResamplerChunkSamples) {
+            const size_t chunk = std::min(kResamplerChunkSamples,
+                                          static_cast<size_t>(numFrames) - offset);
+            const size_t produced = resampler_.process(input + offset, chunk, decimated);
+            requested += produced;
+            written += engine_->captureRing_.write(decimated, produced);
         }
     }
 
+    const uint64_t fill = engine_->captureRing_.capacity() -
+                          engine_->captureRing_.availableToWrite();
+
+    const auto elapsedMicros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - callbackStart).count());
+    const uint64_t budgetMicros =
+        static_cast<uint64_t>(numFrames) * 1000000ULL / static_cast<uint64_t>(deviceRate);
+
+    // Single writer (this callback): plain stores, published as one update
+    TelemetryBlock<CaptureField>& telemetry = engine_->captureTelemetry_;
+    telemetry.beginUpdate();
+    telemetry.add(CaptureField::CALLBACKS);
+    if (written < requested) {
+        telemetry.add(CaptureField::DROPPED_SAMPLES, requested - written);
+    }
+    if (elapsedMicros > budgetMicros) {
+        telemetry.add(CaptureField::OVERRUNS);
+    }
+    telemetry.max(CaptureField::RING_HIGH_WATER, fill);
+    telemetry.max(CaptureField::MAX_CALLBACK_MICROS, elapsedMicros);
+    telemetry.endUpdate();
+
+    engine_->captureCallbackBusy_.store(false);
     return oboe::DataCallbackResult::Continue;
 }
 
@@ -409,18 +1709,22 @@ void CaptureCallback::onErrorBeforeClose(
         "Capture stream error: %s",
         oboe::convertToText(error));
 
-    // CRITICAL FIX: Update atomic state when stream is closed by Oboe
-    // This prevents use-after-free when callback tries to access stream
-    engine_->isCapturing_.store(false);
-
-    // Notify application of error
+    // The session stays up: the stream worker reopens and restarts the
+    // stream once Oboe has closed it (onErrorAfterClose)
     if (engine_->callback_) {
         engine_->callback_->onAudioError(static_cast<int>(error));
     }
 }
 
+void CaptureCallback::onErrorAfterClose(
+    oboe::AudioStream* stream,
+    oboe::Result error) {
+
+    engine_->postStreamWork(AudioEngine::kCaptureLost);
+}
+
 // ============================================================================
-// Playback Callback - Decodes Opus to PCM for playback
+// Playback Callback - Copies decoded PCM out of the playback ring
 // ============================================================================
 
 oboe::DataCallbackResult PlaybackCallback::onAudioReady(
@@ -429,92 +1733,64 @@ oboe::DataCallbackResult PlaybackCallback::onAudioReady(
     int32_t numFrames) {
 
     int16_t* output = static_cast<int16_t*>(audioData);
+    engine_->powerMeter_->wake();
 
     if (!engine_->isPlaying_.load()) {
+        wasPlaying_ = false;
         std::memset(output, 0, numFrames * sizeof(int16_t));
         return oboe::DataCallbackResult::Continue;
     }
+    if (!wasPlaying_) {
+        wasPlaying_ = true;
+        resampler_.reset();
+    }
 
-    std::lock_guard<std::mutex> lock(bufferMutex_);
-
-    // Try to decode more Opus data if buffer is running low
-    if (outputBufferPos_ >= outputBuffer_.size() - numFrames) {
-        // Try to get packet from jitter buffer
-        if (jitterBuffer_) {
-            uint8_t opusPacket[OPUS_MAX_PACKET_SIZE];
-            size_t packetSize = 0;
-
-            if (jitterBuffer_->dequeue(opusPacket, packetSize) && packetSize > 0) {
-                // Decode Opus packet to PCM
-                std::lock_guard<std::mutex> codecLock(engine_->codecMutex_);
-
-                if (engine_->opusDecoder_) {
-                    int16_t pcmBuffer[OPUS_FRAME_SIZE];
-                    int decodedSamples = engine_->opusDecoder_->decode(
-                        opusPacket,
-                        packetSize,
-                        pcmBuffer,
-                        OPUS_FRAME_SIZE
-                    );
-
-                    if (decodedSamples > 0) {
-                        // Add decoded PCM to output buffer
-                        size_t oldSize = outputBuffer_.size();
-                        outputBuffer_.resize(oldSize + decodedSamples);
-                        std::copy(pcmBuffer, pcmBuffer + decodedSamples,
-                                 outputBuffer_.begin() + oldSize);
-
-                        // Update statistics
-                        std::lock_guard<std::mutex> statsLock(engine_->statsMutex_);
-                        engine_->stats_.framesDecoded++;
-                    } else {
-                        // Decode failed, use PLC (Packet Loss Concealment)
-                        decodedSamples = engine_->opusDecoder_->decodePLC(
-                            pcmBuffer, OPUS_FRAME_SIZE);
-
-                        if (decodedSamples > 0) {
-                            size_t oldSize = outputBuffer_.size();
-                            outputBuffer_.resize(oldSize + decodedSamples);
-                            std::copy(pcmBuffer, pcmBuffer + decodedSamples,
-                                     outputBuffer_.begin() + oldSize);
-                        }
-                    }
-                }
-            }
+    // REAL-TIME SAFE: no locks, no allocation, no decode on this thread.
+    // Jitter buffering, Opus decode and mixing run on the decoder thread
+    // (AudioEngine::decoderLoop); this only copies what it queued.
+    size_t requested = 0;
+    size_t copied = 0;
+    if (stream->getSampleRate() == kSampleRate) {
+        requested = static_cast<size_t>(numFrames) * kChannelCount;
+        copied = engine_->playbackRing_.read(output, requested);
+        if (copied < requested) {
+            std::memset(output + copied, 0, (requested - copied) * sizeof(int16_t));
+        }
+    } else {
+        // 48 kHz device: interpolate from the ring; a short ring feeds zeros
+        // so the filter decays instead of clicking. Counts in codec samples.
+        int16_t input[kResamplerChunkSamples / kResampleFactor + 1];
+        size_t offset = 0;
+        while (offset < static_cast<size_t>(numFrames)) {
+            const size_t chunk = std::min(kResamplerChunkSamples,
+                                          static_cast<size_t>(numFrames) - offset);
+            const size_t needed = resampler_.inputNeeded(chunk);
+            const size_t read = engine_->playbackRing_.read(input, needed);
+            std::fill(input + read, input + needed, int16_t{0});
+            resampler_.process(input, needed, output + offset, chunk);
+            requested += needed;
+            copied += read;
+            offset += chunk;
         }
     }
 
-    // Copy PCM data to output
-    size_t samplesWritten = 0;
-
-    if (outputBufferPos_ < outputBuffer_.size()) {
-        size_t toCopy = std::min(
-            static_cast<size_t>(numFrames) - samplesWritten,
-            outputBuffer_.size() - outputBufferPos_
-        );
-
-        std::copy(outputBuffer_.begin() + outputBufferPos_,
-                 outputBuffer_.begin() + outputBufferPos_ + toCopy,
-                 output + samplesWritten);
+    engine_->playbackTelemetry_.beginUpdate();
+    engine_->playbackTelemetry_.add(PlaybackField::CALLBACKS);
 
-        outputBufferPos_ += toCopy;
-        samplesWritten += toCopy;
-    }
-
-    // Fill remaining with silence
-    if (samplesWritten < static_cast<size_t>(numFrames)) {
-        std::memset(output + samplesWritten, 0,
-                   (numFrames - samplesWritten) * sizeof(int16_t));
+    if (copied < requested) {
+        if (engine_->playoutActive_.load(std::memory_order_relaxed)) {
+            // Talker audio expected but the decoder fell behind: extend the run
+            engine_->underrunRunSamples_ += requested - copied;
+        } else if (engine_->underrunRunSamples_ > 0) {
+            engine_->recordUnderrun(engine_->underrunRunSamples_);
+            engine_->underrunRunSamples_ = 0;
+        }
+    } else if (engine_->underrunRunSamples_ > 0) {
+        engine_->recordUnderrun(engine_->underrunRunSamples_);
+        engine_->underrunRunSamples_ = 0;
     }
 
-    // Clean up consumed samples
-    if (outputBufferPos_ >= outputBuffer_.size() / 2) {
-        outputBuffer_.erase(
-            outputBuffer_.begin(),
-            outputBuffer_.begin() + outputBufferPos_
-        );
-        outputBufferPos_ = 0;
-    }
+    engine_->playbackTelemetry_.endUpdate();
 
     return oboe::DataCallbackResult::Continue;
 }
@@ -527,29 +1803,17 @@ void PlaybackCallback::onErrorBeforeClose(
         "Playback stream error: %s",
         oboe::convertToText(error));
 
-    // CRITICAL FIX: Update atomic state when stream is closed by Oboe
-    // This prevents use-after-free when callback tries to access stream
-    engine_->isPlaying_.store(false);
-
-    // Notify application of error
+    // Decoding continues into the ring while the stream worker reopens it
     if (engine_->callback_) {
         engine_->callback_->onAudioError(static_cast<int>(error));
     }
 }
 
-void PlaybackCallback::enqueueAudio(const uint8_t* data, size_t size) {
-    // Add Opus packet to jitter buffer
-    if (!jitterBuffer_) {
-        jitterBuffer_ = std::make_unique<RtpJitterBuffer>();
-    }
-    jitterBuffer_->enqueue(data, size);
-}
+void PlaybackCallback::onErrorAfterClose(
+    oboe::AudioStream* stream,
+    oboe::Result error) {
 
-void PlaybackCallback::resetJitterBuffer() {
-    // Reset jitter buffer state
-    if (jitterBuffer_) {
-        jitterBuffer_->reset();
-    }
+    engine_->postStreamWork(AudioEngine::kPlaybackLost);
 }
 
 } // namespace ptt
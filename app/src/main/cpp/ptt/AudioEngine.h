@@ -9,6 +9,28 @@
  * - Added AEC (Acoustic Echo Cancellation)
  * - Proper timestamp calculation per RFC 3550
  * - Opus codec integration enabled (3GPP TS 26.179 MCPTT)
+ * - Lock-free capture ring + dedicated encoder thread (no locks in callback)
+ * - Per-SSRC receive streams mixed at playback (simultaneous talkers)
+ * - Adaptive Opus bitrate/FEC/frame size from loss and jitter feedback
+ * - Decode-ahead worker feeds a fixed PCM ring; playback callback only copies
+ * - Per-stage lock-free telemetry blocks instead of a stats mutex
+ * - Opt-in per-frame latency tracing (capture -> render, p50/p95/p99)
+ * - Scan channel priority and ducking in the receive mix
+ * - VAD/DTX transmit gate: silence stays off the air, airtime saved counted
+ * - Streams opened once and reused across presses; optional warm standby
+ * - Time-to-first-frame (key-up -> first encoded frame) in telemetry
+ * - AGC / limiter / high-pass around the codec; streams open at 48 kHz with
+ *   a polyphase resampler in the callbacks
+ * - Idle power policy: after silence playback stops (or drops to a
+ *   PowerSaving stream) and the decoder blocks until the next packet
+ * - Encoder, decoder and recorder threads under a ThreadManager (priority,
+ *   affinity, poll-sleep overshoot)
+ * - Receive streams, decoders and packet buffers reserved once from a
+ *   memory budget (MemoryBudget.h)
+ * - Stream worker: streams Oboe loses are reopened and restarted with codec,
+ *   jitter and ring state kept; routes applied by device id and input preset
+ * - Codec profiles per channel (CallQuality.h) with E-model scoring of every
+ *   talker stream and transmit session, aggregated per profile
  */
 
 #ifndef MESHRIDER_PTT_AUDIO_ENGINE_H
@@ -22,19 +44,106 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <array>
 #include "RtpPacketizer.h"
 #include "OpusCodec.h"
+#include "SpscRingBuffer.h"
+#include "ReceiveStreams.h"
+#include "RateController.h"
+#include "PttTelemetry.h"
+#include "LatencyTracer.h"
+#include "VoiceActivity.h"
+#include "AudioDsp.h"
+#include "PowerMeter.h"
+#include "VoiceRecorder.h"
+#include "ThreadManager.h"
+#include "CallQuality.h"
 
 namespace meshrider {
 namespace ptt {
 
 // Following AAudio performance mode guidelines
 // per developer.android.com/ndk/guides/audio/aaudio
-constexpr int32_t kSampleRate = 16000;       // 16kHz for voice
-constexpr int32_t kChannelCount = 1;          // Mono for PTT
+constexpr int32_t kSampleRate = PttAudioFormat::kSampleRate;            // 16kHz for voice
+constexpr int32_t kChannelCount = PttAudioFormat::kChannels;            // Mono for PTT
 constexpr int32_t kFramesPerBurst = 192;      // ~12ms at 16kHz (low latency)
-constexpr int32_t kOpusFrameSize = 320;       // 20ms @ 16kHz (samples)
-constexpr int32_t kPcmFrameSizeBytes = 640;   // 20ms @ 16kHz (bytes, 16-bit)
+constexpr int32_t kOpusFrameSize = PttAudioFormat::kFrameSamples;       // Nominal frame (samples)
+constexpr int32_t kPcmFrameSizeBytes = PttAudioFormat::kFrameBytes;     // Nominal frame (bytes, 16-bit)
+
+// Capture pipeline: callback -> SPSC ring -> encoder thread
+// >= 512ms of audio (8192 samples @ 16kHz), enough to ride out a radio stack stall
+constexpr size_t kCaptureRingCapacity = PttAudioFormat::ringCapacityFor(512);
+constexpr int32_t kEncoderPollIntervalMs = 5;  // Worker sleep when ring lacks a frame
+
+// Playback pipeline: decoder thread -> SPSC PCM ring -> callback
+// >= 256ms of audio (4096 samples @ 16kHz); only kDecodeAheadMs is normally queued
+constexpr size_t kPlaybackRingCapacity = PttAudioFormat::ringCapacityFor(256);
+// Decoded audio kept ready ahead of the callback: one frame plus a 10ms burst margin
+constexpr uint32_t kDecodeAheadMs = PttAudioFormat::kFrameDurationMs + 10;
+constexpr size_t kDecodeChunkSamples = PttAudioFormat::samplesForDuration(10);
+constexpr int32_t kDecoderPollIntervalMs = 5;  // Worker sleep when the ring is full or idle
+
+// Playout period of one decoded Opus frame, used to pace the jitter buffer
+constexpr uint32_t kJitterFrameDurationMs = PttAudioFormat::kFrameDurationMs;
+
+// What playback does once the talkgroup has been silent for idleAfterMs
+enum class IdlePlayback : uint8_t {
+    KEEP,           // Low-latency stream and 5 ms decoder poll stay up
+    POWER_SAVING,   // Shared PowerSaving stream (output route held), decoder blocked
+    STOP            // Stream stopped, decoder blocked
+};
+
+// Either idle mode is left by the first packet that arrives; the stream is
+// back in LowLatency before the jitter buffer releases the first frame
+struct PowerConfig {
+    IdlePlayback idlePlayback = IdlePlayback::KEEP;
+    uint32_t idleAfterMs = 10000;
+};
+
+constexpr uint32_t kMinIdleAfterMs = 1000;
+
+// AudioDeviceInfo ids from Kotlin; the system's choice (which follows a
+// headset connecting by itself) when unset
+constexpr int32_t kDefaultAudioDevice = oboe::kUnspecified;
+
+struct AudioRoute {
+    int32_t inputDeviceId = kDefaultAudioDevice;
+    int32_t outputDeviceId = kDefaultAudioDevice;
+    bool echoCancel = true;             // VoiceCommunication capture preset (platform AEC)
+
+    bool operator==(const AudioRoute& other) const = default;
+};
+
+// Delay before each reopen attempt of a lost stream; after the last the
+// session is dropped and reported (onAudioError)
+constexpr std::array<uint32_t, 5> kStreamRetryDelaysMs = {0, 50, 200, 500, 1000};
+
+// Telemetry fields, one block per writer thread (see PttTelemetry.h)
+enum class CaptureField : size_t {      // Capture callback
+    CALLBACKS, OVERRUNS, DROPPED_SAMPLES, RING_HIGH_WATER, MAX_CALLBACK_MICROS, COUNT
+};
+enum class EncodeField : size_t {       // Encoder thread
+    FRAMES_ENCODED, BYTES_ENCODED, PCM_BYTES, ENCODE_ERRORS, SETTINGS_CHANGES,
+    FRAMES_SUPPRESSED, BYTES_SUPPRESSED, SUPPRESSED_MS, TALKSPURTS, COMFORT_NOISE_FRAMES,
+    KEY_UPS, WARM_KEY_UPS, TTFF_LAST_MICROS, TTFF_TOTAL_MICROS, TTFF_MAX_MICROS,
+    DSP_GAIN_PERCENT, DSP_LIMITED_SAMPLES,
+    COUNT
+};
+
+// Per-packet bytes a suppressed frame would have added on the air (IPv4 + UDP + RTP)
+constexpr uint32_t kPacketOverheadBytes = 20 + 8 + RTP_HEADER_SIZE;
+enum class MixField : size_t {          // Decoder thread (decode counts live in ReceiveStreamTable)
+    CHUNKS_MIXED, RING_HIGH_WATER, DSP_GAIN_PERCENT, DSP_LIMITED_SAMPLES, COUNT
+};
+enum class PlaybackField : size_t {     // Playback callback; histogram occupies the tail
+    CALLBACKS, UNDERRUN_EVENTS, UNDERRUN_SAMPLES, UNDERRUN_HISTOGRAM,
+    COUNT = UNDERRUN_HISTOGRAM + kUnderrunHistogramBuckets
+};
+enum class StreamField : size_t {       // Stream worker; durations from loss (or request) to restart
+    RECOVERIES, RECOVERY_FAILURES, ROUTE_CHANGES,
+    LAST_RECOVERY_MICROS, MAX_RECOVERY_MICROS, TOTAL_RECOVERY_MICROS,
+    COUNT
+};
 
 // Audio state callback
 class AudioEngineCallback {
@@ -42,7 +151,19 @@ public:
     virtual ~AudioEngineCallback() = default;
     virtual void onAudioReady() = 0;
     virtual void onAudioError(int errorCode) = 0;
-    virtual void onAudioData(const uint8_t* data, size_t size) = 0;
+    // One encoded frame; rtpTimestampIncrement is its duration in RTP clock ticks.
+    // marker: first frame after a transmit gap (RTP marker bit).
+    // captureMicros: traceClockMicros() of its first sample while latency
+    // tracing is on, else 0.
+    virtual void onAudioData(const uint8_t* data, size_t size, bool marker,
+                             uint32_t rtpTimestampIncrement, int64_t captureMicros) = 0;
+
+    // Frame withheld by the DTX gate: advance the RTP clock, send nothing
+    virtual void onAudioSuppressed(uint32_t rtpTimestampIncrement) {}
+
+    // Encoder thread, before the first frame encoded with the new settings
+    // (frame duration needs no action: onAudioData carries each frame's ticks)
+    virtual void onEncoderSettingsChanged(const EncoderSettings& settings) {}
 };
 
 // Forward declarations
@@ -66,13 +187,23 @@ public:
     AudioEngine();
     ~AudioEngine();
 
-    // Initialize audio engine with Opus codec
+    // Initialize audio engine with Opus codec. Again on an initialized engine
+    // keeps codecs and open streams, only reopening what Oboe closed.
     bool initialize(AudioEngineCallback* callback);
+    bool isInitialized() const { return opusEncoder_ && receiveStreams_; }
 
     // Start/Stop capture (TX) - now includes Opus encoding
+    // Stop leaves the stream open (stopped, or running in warm standby);
+    // start reopens it only if Oboe closed it on an error or disconnect.
     bool startCapture();
     void stopCapture();
 
+    // Warm standby: keep the capture stream running between presses so key-up
+    // only flips state and resets the encoder. Holds the mic open while idle
+    // (privacy indicator, HAL power); off by default.
+    void setWarmStandby(bool enable);
+    bool isWarmStandby() const { return warmStandby_.load(); }
+
     // Start/Stop playback (RX) - now includes Opus decoding
     bool startPlayback();
     void stopPlayback();
@@ -82,10 +213,15 @@ public:
     bool isPlaying() const { return isPlaying_.load(); }
     int32_t getLatencyMillis() const;
 
-    // Audio routing with AEC
+    // Audio routing. A changed route reopens the affected streams on the
+    // stream worker (the new one opened before the old one stops when the
+    // device changes); sessions, codecs and rings carry over.
+    void setRoute(const AudioRoute& route);
+    AudioRoute getRoute() const;
+
+    // Speakerphone needs the platform AEC; other routes run without it
     void setSpeakerOutput(bool enable);
-    void setBluetoothOutput(bool enable);
-    bool isAecEnabled() const { return aecEnabled_; }
+    bool isAecEnabled() const { return getRoute().echoCancel; }
 
     // Get codec statistics
     struct CodecStats {
@@ -97,10 +233,127 @@ public:
     };
     CodecStats getStats() const;
 
+    // Capture, encode, jitter, decode and playback stages of a TelemetrySnapshot
+    // (send/receive come from RtpPacketizer). Never blocks the audio threads.
+    void getTelemetry(TelemetrySnapshot& snapshot) const;
+
+    // Latency tracing (opt-in): per-stage percentiles plus device latency
+    // (mic/speaker path outside the callbacks) as reported by the streams
+    struct LatencyReport {
+        LatencyStats pipeline;
+        double inputDeviceMs;
+        double outputDeviceMs;
+    };
+    void setLatencyTracing(bool enable, bool atrace);
+    bool isLatencyTracing() const { return latencyTracer_.isEnabled(); }
+    LatencyReport getLatencyReport();
+
+    // Capture pipeline health (written by the real-time callback, lock-free)
+    struct CapturePipelineStats {
+        uint64_t callbackCount;
+        uint64_t callbackOverruns;     // Callback took longer than its burst duration
+        uint64_t droppedSamples;       // Ring full, encoder thread fell behind
+        uint64_t ringHighWaterMark;    // Max ring fill level seen (samples)
+        uint64_t maxCallbackMicros;    // Worst-case callback duration
+    };
+    CapturePipelineStats getCapturePipelineStats() const;
+
+    // Playback pipeline health. An underrun event is one contiguous stretch of
+    // callbacks the ring could not fill while talkers were being decoded;
+    // the histogram buckets events by length (kUnderrunBucketLimitsMs).
+    struct PlaybackPipelineStats {
+        uint64_t callbackCount;
+        uint64_t underrunEvents;
+        uint64_t underrunSamples;      // Zero-filled while audio was expected
+        uint64_t ringHighWaterMark;    // Max ring fill level seen (samples)
+        std::array<uint64_t, kUnderrunHistogramBuckets> underrunHistogram;
+    };
+    PlaybackPipelineStats getPlaybackPipelineStats() const;
+
     // Enqueue received audio data from network (Opus-encoded)
     // This forwards the data to PlaybackCallback for decoding and playback
+    void enqueueReceivedAudio(const uint8_t* data, size_t size, const RtpPacketInfo& info);
+
+    // Zero-copy variant: pooled packet from RtpPacketizer, ownership moves to the stream
+    void enqueueReceivedAudio(PacketPtr packet, const RtpPacketInfo& info);
+
+    // Pool receive buffers must come from for the zero-copy path (null before initialize)
+    std::shared_ptr<PacketPool> getPacketPool() const;
+
+    // Same, for payloads without RTP framing (sequence synthesized locally)
     void enqueueReceivedAudio(const uint8_t* data, size_t size);
 
+    // Jitter buffer statistics aggregated over all talkers
+    JitterBufferStats getJitterStats() const;
+
+    // Talkers currently holding a receive stream
+    size_t getActiveTalkerCount() const;
+
+    // Scan mixing across channels (see ReceiveStreamTable)
+    void setChannelPriority(uint32_t channel, uint8_t priority);
+    void releaseChannel(uint32_t channel);
+    void setDuckingGain(float gain);
+    size_t getActiveChannels(uint32_t* channels, size_t maxChannels) const;
+
+    // Adaptive encoder control
+    // Receiver report from a remote listener (fractionLost in [0,1])
+    void onReceiverReport(uint32_t reporterSsrc, float fractionLost, uint32_t jitterMs);
+    void setBitrateCeiling(int bitrate);      // Manual cap, 0 = none
+    void setAdaptiveBitrate(bool enable);     // false = hold current settings
+    EncoderSettings getEncoderSettings() const { return rateController_.getCurrentSettings(); }
+
+    // Codec profile (index into kCodecProfiles) of a channel. Jitter bounds
+    // apply at once; on kHomeChannel the profile also drives the encoder:
+    // its settings (or the adaptive ladder) from the encoder's next
+    // evaluation, its Opus mode from the next key-up. False before
+    // initialize(), for an unknown profile or a full channel table.
+    bool setCodecProfile(uint32_t channel, size_t profile);
+    size_t getCodecProfile(uint32_t channel) const;
+
+    // Scores so far per profile; refreshes the delay used for later streams
+    std::array<ProfileQuality, kCodecProfileCount> getProfileResults();
+    void resetProfileResults() { qualityMonitor_.reset(); }
+
+    // Transmit suppression of silence (VoiceActivity.h); applies from the next frame
+    void setDtxConfig(const DtxConfig& config) { transmitGate_.configure(config); }
+    DtxConfig getDtxConfig() const { return transmitGate_.getConfig(); }
+
+    // Gain staging (AudioDsp.h): capture before encode, playback after the mix.
+    // Apply from the next frame; kept across re-initialize.
+    void setCaptureDsp(const DspConfig& config) { captureDsp_.configure(config); }
+    DspConfig getCaptureDsp() const { return captureDsp_.getConfig(); }
+    void setPlaybackDsp(const DspConfig& config) { playbackDsp_.configure(config); }
+    DspConfig getPlaybackDsp() const { return playbackDsp_.getConfig(); }
+
+    // Idle power policy (applies from the decoder's next pass; kept across
+    // re-initialize). Wakeups of every pipeline thread are metered per mode.
+    void setPowerConfig(const PowerConfig& config);
+    PowerConfig getPowerConfig() const;
+    std::shared_ptr<PowerMeter> getPowerMeter() const { return powerMeter_; }
+
+    // Received voice to Ogg/Opus files, one per talker burst (VoiceRecorder.h).
+    // Independent of playback; kept across re-initialize.
+    bool startRecording(const RecordingConfig& config) { return recorder_.start(config); }
+    void stopRecording() { recorder_.stop(); }
+    bool isRecording() const { return recorder_.isRecording(); }
+    RecordingStats getRecordingStats() const { return recorder_.getStats(); }
+
+    // Policies for the worker threads; set before initialize() (threads
+    // started earlier keep running unmanaged). Null: named only.
+    void setThreadManager(std::shared_ptr<ThreadManager> manager);
+
+    // Bytes for receive streams and packet buffers, reserved by the first
+    // initialize() (a live engine keeps its reservation). That initialize()
+    // fails if not even one stream fits.
+    void setMemoryBudget(size_t bytes) { memoryBudgetBytes_ = bytes; }
+    size_t getMemoryBudget() const { return memoryBudgetBytes_; }
+    MemoryStats getMemoryStats() const;
+
+    // Optional capture noise suppression stage; null removes it
+    void setNoiseSuppressor(std::shared_ptr<NoiseSuppressor> suppressor) {
+        captureDsp_.setNoiseSuppressor(std::move(suppressor));
+    }
+
 private:
     // Oboe streams
     std::shared_ptr<oboe::AudioStream> captureStream_;
@@ -108,28 +361,175 @@ private:
 
     // State flags (atomic for thread safety)
     std::atomic<bool> isCapturing_{false};
+    std::atomic<bool> warmStandby_{false};
+
+    // Set by CaptureCallback around its isCapturing_ check and ring write, so a
+    // warm-standby stop (stream still running) can wait out an in-flight write
+    std::atomic<bool> captureCallbackBusy_{false};
+
+    // Key-up of the current capture session, read by the encoder thread for TTFF
+    std::atomic<int64_t> keyUpMicros_{0};
+    std::atomic<bool> keyUpWarm_{false};
     std::atomic<bool> isPlaying_{false};
-    std::atomic<bool> aecEnabled_{false};
 
     // Callback
     AudioEngineCallback* callback_ = nullptr;
 
     // Opus codec (3GPP TS 26.179 MCPTT mandatory codec)
+    // Encoder is owned by the encoder thread; each receive stream has its own decoder
     std::unique_ptr<OpusEncoder> opusEncoder_;
-    std::unique_ptr<OpusDecoder> opusDecoder_;
-    std::mutex codecMutex_;
-
-    // Statistics
-    mutable std::mutex statsMutex_;
-    CodecStats stats_;
-
-    // PCM accumulator for 20ms frame alignment
-    std::vector<int16_t> pcmBuffer_;
-    std::mutex pcmBufferMutex_;
-
-    // Stream configuration following Oboe best practices
-    oboe::Result createCaptureStream();
-    oboe::Result createPlaybackStream();
+    std::mutex encoderMutex_;
+
+    // Picks encoder settings from link feedback; applied by the encoder thread
+    RateController rateController_;
+    void applyEncoderSettings(const EncoderSettings& settings);
+
+    // Tapped by receiveStreams_, so declared (and destroyed) around it
+    VoiceRecorder recorder_;
+    CallQualityMonitor qualityMonitor_;
+
+    // Home channel profile (encoder) and the one the running session keyed
+    // up with, with the encoder counters at key-up (control thread)
+    struct TransmitCounters {
+        uint64_t frames = 0;
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+    };
+    std::atomic<size_t> txProfile_{kDefaultCodecProfile};
+    size_t sessionProfile_ = kDefaultCodecProfile;
+    TransmitCounters sessionStart_;
+    TransmitCounters readTransmitCounters() const;
+
+    // Per-SSRC jitter buffers + decoders, mixed by the decoder thread
+    std::unique_ptr<ReceiveStreamTable> receiveStreams_;
+
+    // Encoder thread counters
+    TelemetryBlock<EncodeField> encodeTelemetry_;
+
+    // Send/suppress per encoded frame (encoder thread; reset per capture session)
+    TransmitGate transmitGate_;
+
+    // Gain staging: capture owned by the encoder thread, playback by the decoder
+    AudioDspChain captureDsp_;
+    AudioDspChain playbackDsp_{DspConfig::playbackDefaults()};
+
+    // Rates the streams were granted (kSampleRate: no conversion in the callback)
+    std::atomic<int32_t> captureDeviceRate_{0};
+    std::atomic<int32_t> playbackDeviceRate_{0};
+
+    // Devices the streams were opened on
+    std::atomic<int32_t> captureDeviceId_{kDefaultAudioDevice};
+    std::atomic<int32_t> playbackDeviceId_{kDefaultAudioDevice};
+
+    // TX traces from the encoder thread, RX traces from the decoder thread
+    LatencyTracer latencyTracer_;
+
+    // Capture ring: filled by CaptureCallback, drained by encoder thread
+    SpscRingBuffer<int16_t, kCaptureRingCapacity> captureRing_;
+
+    // Capture pipeline counters (single writer: CaptureCallback)
+    TelemetryBlock<CaptureField> captureTelemetry_;
+
+    // Encoder worker (encode + send off the real-time thread)
+    std::thread encoderThread_;
+    std::atomic<bool> encoderRunning_{false};
+    std::mutex encoderThreadMutex_;     // Start/join from JNI and the stream worker
+    void startEncoderThread();
+    void stopEncoderThread();
+    void encoderLoop();
+
+    // Playback ring: filled by decoder thread, drained by PlaybackCallback
+    SpscRingBuffer<int16_t, kPlaybackRingCapacity> playbackRing_;
+
+    // Set by the decoder while talkers produce audio; a short ring only counts
+    // as an underrun then (silence between talkspurts is expected)
+    std::atomic<bool> playoutActive_{false};
+
+    // Playback pipeline counters (single writers: PlaybackCallback, decoder thread)
+    TelemetryBlock<PlaybackField> playbackTelemetry_;
+    TelemetryBlock<MixField> mixTelemetry_;
+    uint64_t underrunRunSamples_ = 0;   // PlaybackCallback only: current underrun length
+    void recordUnderrun(uint64_t samples);
+
+    // Decoder worker (jitter buffer + Opus decode + mix off the real-time thread)
+    std::thread decoderThread_;
+    std::atomic<bool> decoderRunning_{false};
+    void startDecoderThread();
+    void stopDecoderThread();
+    void decoderLoop();
+
+    // Idle power policy. The decoder parks the playback stream after silence
+    // and blocks on idleCv_ until packetsEnqueued_ moves (receive thread),
+    // the policy changes or playback stops. Stream swaps from the decoder
+    // and the control thread hold playbackStreamMutex_.
+    std::atomic<IdlePlayback> idlePlayback_{IdlePlayback::KEEP};
+    std::atomic<uint32_t> idleAfterMs_{PowerConfig{}.idleAfterMs};
+    std::atomic<bool> playbackIdle_{false};
+    std::atomic<uint64_t> packetsEnqueued_{0};
+    std::mutex idleMutex_;
+    std::condition_variable idleCv_;
+    bool idleWake_ = false;                 // Under idleMutex_
+    mutable std::mutex playbackStreamMutex_;
+    bool playbackPowerSaving_ = false;      // Under playbackStreamMutex_
+    std::shared_ptr<PowerMeter> powerMeter_;
+    std::shared_ptr<ThreadManager> threadManager_;
+    size_t memoryBudgetBytes_ = kDefaultMemoryBudgetBytes;
+    void parkPlayback(IdlePlayback mode, uint64_t packetsSeen);
+    void wakeDecoder();
+    void onPacketEnqueued();
+    void updatePowerMode();
+
+    // Stream configuration following Oboe best practices. open* asks for
+    // kDeviceSampleRate (AAudio fast path) and falls back to the codec rate
+    // with Oboe's resampler if the device grants anything else.
+    oboe::Result createCaptureStream(int32_t sampleRate, bool oboeConversion);
+    oboe::Result createPlaybackStream(int32_t sampleRate, bool oboeConversion,
+                                      bool powerSaving);
+    oboe::Result openCaptureStream();
+    oboe::Result openPlaybackStream(bool powerSaving = false);
+
+    // Reopen a stream that is missing or was closed by Oboe (error/disconnect);
+    // playback also replaces an idle PowerSaving stream
+    bool ensureCaptureStream();
+    bool ensureCaptureStreamLocked();
+    bool ensurePlaybackStream();
+    bool ensurePlaybackStreamLocked();
+
+    // Stream lifecycle. Oboe's error thread (after it closed a stream) and
+    // setRoute() post work bits; the stream worker reopens the stream,
+    // restarts it if its session is live and retries per
+    // kStreamRetryDelaysMs. Capture swaps hold captureStreamMutex_, playback
+    // swaps playbackStreamMutex_; the error callbacks take neither (Oboe
+    // holds the stream's own lock there).
+    enum StreamWork : uint32_t {
+        kCaptureLost = 1u << 0,
+        kPlaybackLost = 1u << 1,
+        kCaptureRoute = 1u << 2,
+        kPlaybackRoute = 1u << 3
+    };
+    mutable std::mutex captureStreamMutex_;
+    mutable std::mutex routeMutex_;
+    AudioRoute route_;                      // Under routeMutex_ (taken last)
+    std::thread streamThread_;
+    std::mutex streamWorkMutex_;
+    std::condition_variable streamWorkCv_;
+    uint32_t streamWork_ = 0;               // Under streamWorkMutex_: posted, not yet taken
+    uint32_t streamBusy_ = 0;               // Under streamWorkMutex_: taken, being retried
+    std::array<int64_t, 2> streamWorkSince_{};  // Under streamWorkMutex_: first request, per direction
+    bool streamWorkerStop_ = false;         // Under streamWorkMutex_
+    std::atomic<uint32_t> streamsRecovering_{0};    // Lost bits not yet recovered
+    TelemetryBlock<StreamField> streamTelemetry_;
+    void startStreamWorker();
+    void stopStreamWorker();
+    void streamWorkerLoop();
+    void postStreamWork(uint32_t work);
+    bool reopenCapture(bool routeChange);
+    bool reopenPlayback(bool routeChange);
+    void dropStreamSession(bool capture);
+
+    // Synthesized RTP state for enqueueReceivedAudio without a header. One
+    // counter for both fields: JNI ingress and the buffer drain can race here.
+    std::atomic<uint32_t> localRxFrames_{0};
 
     // Audio callbacks
     std::unique_ptr<CaptureCallback> captureCallback_;
@@ -142,8 +542,9 @@ private:
 /**
  * Capture callback - runs on high-priority audio thread
  * Following AAudio guidelines for low latency
- * 
- * PRODUCTION FIX: Encodes to Opus before sending to network
+ *
+ * Only copies PCM into AudioEngine::captureRing_; Opus encoding and
+ * network send happen on the encoder thread.
  */
 class CaptureCallback : public oboe::AudioStreamCallback {
 public:
@@ -158,13 +559,24 @@ public:
         oboe::AudioStream* stream,
         oboe::Result error) override;
 
+    // Oboe has closed the stream: hand it to the stream worker
+    void onErrorAfterClose(
+        oboe::AudioStream* stream,
+        oboe::Result error) override;
+
 private:
     AudioEngine* engine_;
+
+    // 48 kHz -> codec rate, this callback's thread only; reset on each session
+    CaptureResampler resampler_;
+    bool wasCapturing_ = false;
 };
 
 /**
- * Playback callback - receives audio data from network
- * Decodes Opus-encoded audio to PCM for playback
+ * Playback callback - runs on high-priority audio thread
+ *
+ * Only copies PCM out of AudioEngine::playbackRing_; jitter buffering,
+ * Opus decoding and mixing happen on the decoder thread.
  */
 class PlaybackCallback : public oboe::AudioStreamCallback {
 public:
@@ -179,23 +591,17 @@ public:
         oboe::AudioStream* stream,
         oboe::Result error) override;
 
-    // Feed audio data from network
-    void enqueueAudio(const uint8_t* data, size_t size);
-
-    // CRITICAL FIX: Public methods for jitter buffer management
-    // AudioEngine needs to reset the buffer on playback start
-    void resetJitterBuffer();
+    // Oboe has closed the stream: hand it to the stream worker
+    void onErrorAfterClose(
+        oboe::AudioStream* stream,
+        oboe::Result error) override;
 
 private:
     AudioEngine* engine_;
 
-    // Jitter buffer for received Opus packets
-    std::unique_ptr<RtpJitterBuffer> jitterBuffer_;
-
-    // PCM output buffer
-    std::vector<int16_t> outputBuffer_;
-    size_t outputBufferPos_ = 0;
-    std::mutex bufferMutex_;
+    // Codec rate -> 48 kHz, this callback's thread only; reset on each session
+    PlaybackResampler resampler_;
+    bool wasPlaying_ = false;
 };
 
 } // namespace ptt
@@ -0,0 +1,108 @@
+/*
+ * Mesh Rider Wave - PTT Audio Format Descriptor
+ * Single compile-time source for sample rate, frame size and RTP clock
+ *
+ * OpusCodec, AudioEngine and RtpPacketizer derive every frame size,
+ * buffer capacity and RTP timestamp increment from PttAudioFormat, so the
+ * capture ring, encoder, packetizer and jitter buffer cannot disagree.
+ *
+ * Build variants: -DMESHRIDER_PTT_FRAME_MS=10 (or 20, the default) selects
+ * the nominal packetization for latency vs. bandwidth comparisons.
+ */
+
+#ifndef MESHRIDER_PTT_AUDIO_FORMAT_H
+#define MESHRIDER_PTT_AUDIO_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef MESHRIDER_PTT_FRAME_MS
+#define MESHRIDER_PTT_FRAME_MS 20
+#endif
+
+namespace meshrider {
+namespace ptt {
+
+// Smallest power of two >= value (ring capacities)
+constexpr size_t nextPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+/**
+ * Compile-time PCM/Opus/RTP format
+ *
+ * SampleRate/Channels: codec PCM format. FrameDurationUs: nominal Opus
+ * frame. RtpClockRate: RTP timestamp clock (48 kHz for Opus per RFC 7587,
+ * regardless of the codec's internal rate).
+ */
+template <uint32_t SampleRate, uint32_t Channels, uint32_t FrameDurationUs,
+          uint32_t RtpClockRate = 48000>
+struct AudioFormat {
+    static_assert(SampleRate == 8000 || SampleRate == 12000 || SampleRate == 16000 ||
+                  SampleRate == 24000 || SampleRate == 48000,
+                  "Opus supports 8/12/16/24/48 kHz");
+    static_assert(Channels == 1 || Channels == 2, "Opus supports mono or stereo");
+    static_assert(FrameDurationUs == 2500 || FrameDurationUs == 5000 ||
+                  FrameDurationUs == 10000 || FrameDurationUs == 20000 ||
+                  FrameDurationUs == 40000 || FrameDurationUs == 60000,
+                  "Opus frames are 2.5, 5, 10, 20, 40 or 60 ms");
+    static_assert(RtpClockRate % 1000 == 0, "RTP clock must be a whole kHz");
+
+    static constexpr uint32_t kSampleRate = SampleRate;
+    static constexpr uint32_t kChannels = Channels;
+    static constexpr uint32_t kRtpClockRate = RtpClockRate;
+
+    // Nominal frame
+    static constexpr uint32_t kFrameDurationUs = FrameDurationUs;
+    static constexpr uint32_t kFrameDurationMs = FrameDurationUs / 1000;
+    static constexpr uint32_t kFrameSamples =
+        static_cast<uint32_t>(uint64_t{SampleRate} * FrameDurationUs / 1000000);
+    static constexpr uint32_t kFrameBytes = kFrameSamples * Channels * sizeof(int16_t);
+    static constexpr uint32_t kRtpTimestampIncrement =
+        static_cast<uint32_t>(uint64_t{RtpClockRate} * FrameDurationUs / 1000000);
+
+    // Largest Opus frame (60 ms): capacity for any adaptive frame size
+    static constexpr uint32_t kMaxFrameDurationMs = 60;
+    static constexpr uint32_t kMaxFrameSamples = SampleRate * kMaxFrameDurationMs / 1000;
+
+    static constexpr uint32_t samplesForDuration(uint32_t durationMs) {
+        return SampleRate * durationMs / 1000;
+    }
+
+    static constexpr uint32_t durationForSamples(uint32_t samples) {
+        return static_cast<uint32_t>(uint64_t{samples} * 1000 / SampleRate);
+    }
+
+    // codec samples -> RTP clock ticks
+    static constexpr uint32_t rtpTicksForSamples(uint32_t samples) {
+        return static_cast<uint32_t>(uint64_t{samples} * RtpClockRate / SampleRate);
+    }
+
+    static constexpr uint32_t rtpTicksForDuration(uint32_t durationMs) {
+        return RtpClockRate / 1000 * durationMs;
+    }
+
+    static constexpr uint32_t durationForRtpTicks(uint32_t ticks) {
+        return ticks / (RtpClockRate / 1000);
+    }
+
+    // Power-of-two sample ring holding at least durationMs of audio
+    static constexpr size_t ringCapacityFor(uint32_t durationMs) {
+        return nextPowerOfTwo(size_t{SampleRate} * Channels * durationMs / 1000);
+    }
+};
+
+// The format this build ships: 16 kHz mono voice (3GPP MCPTT), Opus RTP clock
+using PttAudioFormat = AudioFormat<16000, 1, MESHRIDER_PTT_FRAME_MS * 1000>;
+
+static_assert(PttAudioFormat::kFrameSamples == PttAudioFormat::kSampleRate / 1000 * MESHRIDER_PTT_FRAME_MS,
+              "frame size must follow the configured duration");
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_AUDIO_FORMAT_H
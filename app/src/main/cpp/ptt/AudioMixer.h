@@ -0,0 +1,119 @@
+/*
+ * Mesh Rider Wave - PTT Audio Mixer
+ * Saturating int16 summation of concurrent talkers, optionally scaled
+ * by a Q15 gain (scan channel ducking)
+ *
+ * NEON on arm64 (Samsung S24+), SSE2 on x86 emulator/host builds,
+ * scalar fallback elsewhere. All paths are allocation-free.
+ */
+
+#ifndef MESHRIDER_PTT_AUDIO_MIXER_H
+#define MESHRIDER_PTT_AUDIO_MIXER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MESHRIDER_PTT_MIXER_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MESHRIDER_PTT_MIXER_SSE2 1
+#endif
+
+namespace meshrider {
+namespace ptt {
+
+// dst[i] = clamp(dst[i] + src[i]) over count samples, scalar reference
+inline void mixSaturatingScalar(int16_t* dst, const int16_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const int32_t sum = static_cast<int32_t>(dst[i]) + src[i];
+        dst[i] = static_cast<int16_t>(std::clamp<int32_t>(sum, INT16_MIN, INT16_MAX));
+    }
+}
+
+// dst[i] = clamp(dst[i] + src[i]) over count samples, vectorized 8 lanes
+inline void mixSaturating(int16_t* dst, const int16_t* src, size_t count) {
+    size_t i = 0;
+
+#if defined(MESHRIDER_PTT_MIXER_NEON)
+    for (; i + 8 <= count; i += 8) {
+        vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), vld1q_s16(src + i)));
+    }
+#elif defined(MESHRIDER_PTT_MIXER_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epi16(a, b));
+    }
+#endif
+
+    mixSaturatingScalar(dst + i, src + i, count - i);
+}
+
+// Q15 gain: kUnityGainQ15 passes samples through unchanged
+constexpr int32_t kUnityGainQ15 = 32768;
+
+// dst[i] = clamp(dst[i] + src[i] * gain), gain ramped linearly from
+// fromQ15 to toQ15 across count samples to avoid a step (click). Scalar:
+// only runs on the pass where a channel is ducked or restored.
+inline void mixSaturatingRamp(int16_t* dst, const int16_t* src, size_t count,
+                              int32_t fromQ15, int32_t toQ15) {
+    if (count == 0) {
+        return;
+    }
+    const int64_t step = (static_cast<int64_t>(toQ15 - fromQ15) << 16) / static_cast<int64_t>(count);
+    int64_t gain = static_cast<int64_t>(fromQ15) << 16;
+    for (size_t i = 0; i < count; ++i) {
+        gain += step;
+        const int32_t scaled = static_cast<int32_t>((src[i] * (gain >> 16) + (1 << 14)) >> 15);
+        dst[i] = static_cast<int16_t>(std::clamp<int32_t>(dst[i] + scaled, INT16_MIN, INT16_MAX));
+    }
+}
+
+// dst[i] = clamp(dst[i] + src[i] * gainQ15), gainQ15 in [0, kUnityGainQ15]
+inline void mixSaturatingGain(int16_t* dst, const int16_t* src, size_t count, int32_t gainQ15) {
+    if (gainQ15 >= kUnityGainQ15) {
+        mixSaturating(dst, src, count);
+        return;
+    }
+    if (gainQ15 <= 0) {
+        return;
+    }
+
+    size_t i = 0;
+
+#if defined(MESHRIDER_PTT_MIXER_NEON)
+    const int16_t gain = static_cast<int16_t>(gainQ15);
+    for (; i + 8 <= count; i += 8) {
+        // vqrdmulh: rounded (src * gain) >> 15
+        const int16x8_t scaled = vqrdmulhq_n_s16(vld1q_s16(src + i), gain);
+        vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), scaled));
+    }
+#elif defined(MESHRIDER_PTT_MIXER_SSE2)
+    // No 16-bit rounding multiply in SSE2: widen the product, shift, repack
+    const __m128i gain = _mm_set1_epi16(static_cast<int16_t>(gainQ15));
+    const __m128i round = _mm_set1_epi32(1 << 14);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_mullo_epi16(b, gain);
+        const __m128i hi = _mm_mulhi_epi16(b, gain);
+        const __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+        const __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_adds_epi16(a, _mm_packs_epi32(p0, p1)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const int32_t scaled = (src[i] * gainQ15 + (1 << 14)) >> 15;
+        dst[i] = static_cast<int16_t>(std::clamp<int32_t>(dst[i] + scaled, INT16_MIN, INT16_MAX));
+    }
+}
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_AUDIO_MIXER_H
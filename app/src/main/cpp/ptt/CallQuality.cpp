@@ -0,0 +1,188 @@
+/*
+ * Mesh Rider Wave - Codec Profiles and Call Quality Scoring Implementation
+ */
+
+#include "CallQuality.h"
+#include "PttLog.h"
+#include <algorithm>
+
+#define TAG "MeshRider:PTT-Quality"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// G.107 default R with no impairment other than the basic signal-to-noise
+constexpr double kBaseRFactor = 93.2;
+
+// Id knee: one-way delay beyond this costs conversational interactivity
+constexpr double kDelayKneeMs = 177.3;
+
+// Opus equipment impairment by bitrate, interpolated between points
+struct IePoint {
+    int bitrate;
+    double ie;
+};
+constexpr std::array<IePoint, 5> kOpusIe = {{
+    {  6000, 30.0 },
+    {  8000, 20.0 },
+    { 12000, 11.0 },
+    { 16000,  6.0 },
+    { 24000,  2.0 },
+}};
+
+// Packet-loss robustness of Opus PLC; random loss (BurstR = 1) assumed
+constexpr double kOpusBpl = 20.0;
+constexpr double kBurstRatio = 1.0;
+
+double equipmentImpairment(int bitrate) {
+    if (bitrate <= kOpusIe.front().bitrate) {
+        return kOpusIe.front().ie;
+    }
+    for (size_t i = 1; i < kOpusIe.size(); ++i) {
+        if (bitrate <= kOpusIe[i].bitrate) {
+            const IePoint& lo = kOpusIe[i - 1];
+            const IePoint& hi = kOpusIe[i];
+            const double t = static_cast<double>(bitrate - lo.bitrate) /
+                             static_cast<double>(hi.bitrate - lo.bitrate);
+            return lo.ie + t * (hi.ie - lo.ie);
+        }
+    }
+    return kOpusIe.back().ie;
+}
+
+} // namespace
+
+double estimateRFactor(const QualitySample& sample) {
+    const double d = std::max(0.0, sample.delayMs);
+    double id = 0.024 * d;
+    if (d > kDelayKneeMs) {
+        id += 0.11 * (d - kDelayKneeMs);
+    }
+
+    const double ie = equipmentImpairment(sample.bitrate);
+    const double ppl = std::clamp(sample.lossRatio, 0.0, 1.0) * 100.0;
+    const double ieEff = ie + (95.0 - ie) * ppl / (ppl / kBurstRatio + kOpusBpl);
+
+    return std::clamp(kBaseRFactor - id - ieEff, 0.0, 100.0);
+}
+
+double rFactorToMos(double r) {
+    if (r <= 0.0) {
+        return 1.0;
+    }
+    if (r >= 100.0) {
+        return 4.5;
+    }
+    const double mos = 1.0 + 0.035 * r + r * (r - 60.0) * (100.0 - r) * 7e-6;
+    return std::clamp(mos, 1.0, 4.5);
+}
+
+void CallQualityMonitor::setPathDelay(double mouthToEarMs, double deviceMs,
+                                      double playoutQueueMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mouthToEarMs_ = std::max(0.0, mouthToEarMs);
+    deviceMs_ = std::max(0.0, deviceMs);
+    playoutQueueMs_ = std::max(0.0, playoutQueueMs);
+}
+
+void CallQualityMonitor::recordStream(size_t profile, const JitterBufferStats& stats,
+                                      uint32_t frameDurationMs) {
+    if (profile >= kCodecProfileCount) {
+        return;
+    }
+
+    // Playout slots: packets played, frames FEC rebuilt, frames concealed.
+    // Stretches are concealment the buffer chose, not loss.
+    const uint64_t lost = stats.framesConcealed > stats.framesStretched
+        ? stats.framesConcealed - stats.framesStretched : 0;
+    const uint64_t frames = stats.framesPlayed + stats.framesRecovered + lost;
+    if (frames < kMinScoredFrames) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const bool measured = mouthToEarMs_ > 0.0;
+    const double delayMs = measured
+        ? mouthToEarMs_ + deviceMs_
+        : static_cast<double>(stats.targetDelayMs) + frameDurationMs +
+          playoutQueueMs_ + deviceMs_;
+
+    QualitySample sample;
+    sample.lossRatio = static_cast<double>(lost) / static_cast<double>(frames);
+    sample.delayMs = delayMs;
+    sample.bitrate = kCodecProfiles[profile].encoder.bitrate;
+    const double r = estimateRFactor(sample);
+    const double mos = rFactorToMos(r);
+
+    Totals& t = totals_[profile];
+    t.minMos = t.streams == 0 ? mos : std::min(t.minMos, mos);
+    t.streams++;
+    t.frames += frames;
+    t.lost += lost;
+    t.recovered += stats.framesRecovered;
+    t.mosFrames += mos * static_cast<double>(frames);
+    t.rFrames += r * static_cast<double>(frames);
+    t.delayFrames += delayMs * static_cast<double>(frames);
+    if (measured) {
+        t.measured++;
+    }
+
+    __android_log_print(ANDROID_LOG_DEBUG, TAG,
+        "Stream scored (%s): %llu frames, loss=%.1f%%, delay=%.0f ms%s, R=%.1f, MOS=%.2f",
+        kCodecProfiles[profile].name, static_cast<unsigned long long>(frames),
+        sample.lossRatio * 100.0, delayMs, measured ? "" : " (est)", r, mos);
+}
+
+void CallQualityMonitor::recordTransmit(size_t profile, uint64_t frames, uint64_t packets,
+                                        uint64_t bytes, uint64_t millis) {
+    if (profile >= kCodecProfileCount) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Totals& t = totals_[profile];
+    t.txSessions++;
+    t.txFrames += frames;
+    t.txPackets += packets;
+    t.txBytes += bytes;
+    t.txMillis += millis;
+}
+
+std::array<ProfileQuality, kCodecProfileCount> CallQualityMonitor::getResults() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::array<ProfileQuality, kCodecProfileCount> results{};
+    for (size_t i = 0; i < kCodecProfileCount; ++i) {
+        const Totals& t = totals_[i];
+        ProfileQuality& q = results[i];
+        q.streamsScored = t.streams;
+        q.framesScored = t.frames;
+        q.framesLost = t.lost;
+        q.framesRecovered = t.recovered;
+        if (t.frames > 0) {
+            const double frames = static_cast<double>(t.frames);
+            q.meanMos = t.mosFrames / frames;
+            q.meanRFactor = t.rFrames / frames;
+            q.meanDelayMs = t.delayFrames / frames;
+        }
+        q.minMos = t.minMos;
+        q.measuredStreams = t.measured;
+        q.txSessions = t.txSessions;
+        q.txFrames = t.txFrames;
+        q.txPackets = t.txPackets;
+        q.txBytes = t.txBytes;
+        q.txMillis = t.txMillis;
+    }
+    return results;
+}
+
+void CallQualityMonitor::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals_ = {};
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,144 @@
+/*
+ * Mesh Rider Wave - Codec Profiles and Call Quality Scoring
+ * Named codec/transport settings per talkgroup, each scored on the device
+ *
+ * - CodecProfile: Opus mode, encoder settings (or the adaptive ladder) and
+ *   jitter-buffer delay bounds, picked by index per channel at runtime. The
+ *   home channel's profile drives the encoder; every channel's profile sets
+ *   the jitter bounds of its talkers.
+ * - Scoring: ITU-T G.107 E-model, R = 93.2 - Id - Ie,eff, mapped to MOS
+ *   (G.107 Annex B). Id from one-way delay (the simplified Cole/Rosenbluth
+ *   fit); Ie,eff from the frames left concealed after FEC/RED repair, with
+ *   an equipment impairment Ie by Opus bitrate (no G.113 entry exists for
+ *   Opus; the table is a wideband-voice estimate) and Bpl for Opus PLC.
+ * - One score per talker stream, from assignment to release, weighted by
+ *   its frames; streams shorter than kMinScoredFrames are not scored.
+ *
+ * Delay is measured mouth-to-ear (p50, latency tracing on, sender stamps)
+ * plus both device latencies when available; otherwise it is estimated
+ * from the stream's jitter target, one frame of packetization, the
+ * decode-ahead and the device latencies.
+ */
+
+#ifndef MESHRIDER_PTT_CALL_QUALITY_H
+#define MESHRIDER_PTT_CALL_QUALITY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "OpusCodec.h"
+#include "RateController.h"
+
+namespace meshrider {
+namespace ptt {
+
+struct CodecProfile {
+    const char* name;
+    OpusMode mode;
+    EncoderSettings encoder;    // Fixed settings; unused while adaptive
+    bool adaptive;              // RateController ladder instead of encoder
+    uint32_t minDelayMs;        // Jitter buffer bounds for the channel's talkers
+    uint32_t maxDelayMs;
+};
+
+constexpr size_t kCodecProfileCount = 4;
+constexpr size_t kDefaultCodecProfile = 0;
+
+// "default" is the behaviour without a profile. FEC is pointless in
+// LOW_DELAY (CELT only, no LBRR), so that profile spends the bits on rate.
+constexpr std::array<CodecProfile, kCodecProfileCount> kCodecProfiles = {{
+    { "default",   OpusMode::VOIP,      kTierProfiles[1].settings, true,
+      kDefaultMinDelayMs, kDefaultMaxDelayMs },
+    { "low-delay", OpusMode::LOW_DELAY, { 16000, false,  1, 7, 10 }, false,  10, 120 },
+    { "robust",    OpusMode::VOIP,      { 12000, true,  20, 5, 40 }, false,  60, 400 },
+    { "low-rate",  OpusMode::VOIP,      {  8000, true,  25, 3, 60 }, false,  60, 400 },
+}};
+
+// Shorter streams (key clicks, a lost tail) say nothing about the call
+constexpr uint64_t kMinScoredFrames = 50;
+
+// E-model inputs of one talker stream
+struct QualitySample {
+    double lossRatio;           // Playout slots concealed after repair, [0, 1]
+    double delayMs;             // One-way, mouth to ear
+    int bitrate;                // Sender bitrate (bps), for Ie
+};
+
+double estimateRFactor(const QualitySample& sample);
+double rFactorToMos(double r);
+
+// What getResults() reports per profile
+struct ProfileQuality {
+    // Receive: talker streams heard on channels using the profile
+    uint64_t streamsScored = 0;
+    uint64_t framesScored = 0;          // Playout slots of the scored streams
+    uint64_t framesLost = 0;            // Concealed after FEC/RED repair
+    uint64_t framesRecovered = 0;       // Rebuilt from FEC
+    double meanMos = 0.0;               // Frame-weighted
+    double minMos = 0.0;                // Worst stream
+    double meanRFactor = 0.0;
+    double meanDelayMs = 0.0;
+    uint32_t measuredStreams = 0;       // Delay from traced mouth-to-ear, not estimated
+
+    // Transmit: key-ups while the home channel used the profile
+    uint64_t txSessions = 0;
+    uint64_t txFrames = 0;              // Encoded
+    uint64_t txPackets = 0;             // Sent: encoded less DTX-suppressed
+    uint64_t txBytes = 0;               // Payload of the sent packets (RED copies not counted)
+    uint64_t txMillis = 0;              // Keyed time
+};
+
+/**
+ * Per-profile score aggregation (THREAD-SAFE)
+ *
+ * Streams are scored on the receive thread as they are released; delay
+ * inputs and transmit sessions come from the control thread.
+ */
+class CallQualityMonitor {
+public:
+    // Traced mouth-to-ear p50 (0: none), input + output device latency and
+    // the decoded audio queued ahead of playback; used for every stream
+    // scored until the next update
+    void setPathDelay(double mouthToEarMs, double deviceMs, double playoutQueueMs);
+
+    // One released talker stream; its jitter stats cover exactly that stream
+    void recordStream(size_t profile, const JitterBufferStats& stats,
+                      uint32_t frameDurationMs);
+
+    // One capture session (key-up to release) and what it put on the air
+    void recordTransmit(size_t profile, uint64_t frames, uint64_t packets,
+                        uint64_t bytes, uint64_t millis);
+
+    std::array<ProfileQuality, kCodecProfileCount> getResults() const;
+    void reset();
+
+private:
+    struct Totals {
+        uint64_t streams = 0;
+        uint64_t frames = 0;
+        uint64_t lost = 0;
+        uint64_t recovered = 0;
+        double mosFrames = 0.0;         // Sum of MOS x frames
+        double rFrames = 0.0;
+        double delayFrames = 0.0;
+        double minMos = 0.0;
+        uint32_t measured = 0;
+        uint64_t txSessions = 0;
+        uint64_t txFrames = 0;
+        uint64_t txPackets = 0;
+        uint64_t txBytes = 0;
+        uint64_t txMillis = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::array<Totals, kCodecProfileCount> totals_{};
+    double mouthToEarMs_ = 0.0;
+    double deviceMs_ = 0.0;
+    double playoutQueueMs_ = 0.0;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_CALL_QUALITY_H
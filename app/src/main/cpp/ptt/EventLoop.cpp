@@ -0,0 +1,299 @@
+/*
+ * Mesh Rider Wave - Native Event Loop Implementation
+ */
+
+#include "EventLoop.h"
+#include "LatencyTracer.h"
+#include "PttLog.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#define TAG "MeshRider:PTT-Loop"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// epoll tokens past the source slots
+constexpr uint32_t kWakeToken = UINT32_MAX;
+constexpr uint32_t kTimerToken = UINT32_MAX - 1;
+
+// Source::fd while unwatch() waits out the loop: not free, not dispatched
+constexpr int kRetiredFd = -2;
+
+constexpr int kMaxEvents = static_cast<int>(kMaxEventSources) + 2;
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool addToEpoll(int epollFd, int fd, uint32_t token) {
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = token;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+void drainCounter(int fd) {
+    uint64_t count;
+    read(fd, &count, sizeof(count));
+}
+
+} // namespace
+
+EventLoop::~EventLoop() {
+    release();
+}
+
+bool EventLoop::initialize() {
+    if (epollFd_ >= 0) {
+        return true;
+    }
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    // traceClockMicros() is steady_clock, CLOCK_MONOTONIC on Linux
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0 || timerFd_ < 0 ||
+        !addToEpoll(epollFd_, wakeFd_, kWakeToken) ||
+        !addToEpoll(epollFd_, timerFd_, kTimerToken)) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Failed to create event loop: %s", strerror(errno));
+        closeFd(timerFd_);
+        closeFd(wakeFd_);
+        closeFd(epollFd_);
+        return false;
+    }
+    armedMicros_ = 0;
+    return true;
+}
+
+void EventLoop::release() {
+    stop();
+
+    std::lock_guard<std::mutex> lock(sourceMutex_);
+    for (auto& source : sources_) {
+        source.fd.store(-1);
+        source.handler = nullptr;
+    }
+    for (size_t i = 0; i < timerCount_; ++i) {
+        timers_[i] = nullptr;
+    }
+    timerCount_ = 0;
+    armedMicros_ = 0;
+
+    closeFd(timerFd_);
+    closeFd(wakeFd_);
+    closeFd(epollFd_);
+}
+
+bool EventLoop::watch(int fd, Handler handler) {
+    if (fd < 0 || epollFd_ < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sourceMutex_);
+    for (size_t slot = 0; slot < sources_.size(); ++slot) {
+        Source& source = sources_[slot];
+        if (source.fd.load() != -1) {
+            continue;
+        }
+        // Handler first: the loop calls it once it sees the descriptor
+        source.handler = std::move(handler);
+        source.fd.store(fd);
+        if (!addToEpoll(epollFd_, fd, static_cast<uint32_t>(slot))) {
+            __android_log_print(ANDROID_LOG_ERROR, TAG,
+                "Failed to watch fd %d: %s", fd, strerror(errno));
+            source.fd.store(-1);
+            return false;
+        }
+        return true;
+    }
+
+    __android_log_print(ANDROID_LOG_WARN, TAG,
+        "Event loop full (%zu sources), cannot watch fd %d", sources_.size(), fd);
+    return false;
+}
+
+bool EventLoop::unwatch(int fd) {
+    if (fd < 0) {
+        return false;
+    }
+
+    Source* retired = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        for (auto& source : sources_) {
+            if (source.fd.load() == fd) {
+                source.fd.store(kRetiredFd);
+                retired = &source;
+                break;
+            }
+        }
+        if (!retired) {
+            return false;
+        }
+        if (epollFd_ >= 0) {
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        }
+    }
+
+    // The loop may have loaded fd just before the store; once it drops
+    // dispatching_ it can only see kRetiredFd. Unlocked, so a handler
+    // calling watch() meanwhile does not deadlock.
+    while (dispatching_.load()) {
+        std::this_thread::yield();
+    }
+
+    std::lock_guard<std::mutex> lock(sourceMutex_);
+    retired->handler = nullptr;
+    retired->fd.store(-1);
+    return true;
+}
+
+bool EventLoop::addTimer(TimerService service) {
+    if (running_ || timerCount_ >= timers_.size()) {
+        return false;
+    }
+    timers_[timerCount_++] = std::move(service);
+    return true;
+}
+
+bool EventLoop::start(ThreadManager* threads, ThreadRole role, const char* name) {
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    if (running_) {
+        return true;
+    }
+    if (epollFd_ < 0) {
+        return false;
+    }
+
+    stopRequested_ = false;
+    running_ = true;
+    thread_ = std::thread([this, threads, role, name]() {
+        ThreadScope threadScope(threads, role, name);
+        __android_log_print(ANDROID_LOG_INFO, TAG, "%s loop started", name);
+        run();
+        __android_log_print(ANDROID_LOG_INFO, TAG, "%s loop stopped", name);
+    });
+    return true;
+}
+
+void EventLoop::stop() {
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    stopRequested_ = true;
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    running_ = false;
+}
+
+void EventLoop::wake() {
+    if (wakeFd_ >= 0) {
+        const uint64_t one = 1;
+        write(wakeFd_, &one, sizeof(one));
+    }
+}
+
+EventLoopStats EventLoop::getStats() const {
+    EventLoopStats stats;
+    stats.passes = passes_.load(std::memory_order_relaxed);
+    stats.wakes = wakes_.load(std::memory_order_relaxed);
+    stats.timerExpiries = timerExpiries_.load(std::memory_order_relaxed);
+    stats.maxTimerLateMicros = maxTimerLateMicros_.load(std::memory_order_relaxed);
+    stats.totalTimerLateMicros = totalTimerLateMicros_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EventLoop::run() {
+    struct epoll_event events[kMaxEvents];
+
+    while (!stopRequested_.load()) {
+        runTimers();
+
+        const int count = epoll_wait(epollFd_, events, kMaxEvents, -1);
+        passes_.fetch_add(1, std::memory_order_relaxed);
+        if (powerMeter_) {
+            powerMeter_->wake();
+        }
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            __android_log_print(ANDROID_LOG_ERROR, TAG, "epoll_wait: %s", strerror(errno));
+            break;
+        }
+
+        dispatching_.store(true);
+        for (int i = 0; i < count; ++i) {
+            const uint32_t token = events[i].data.u32;
+            if (token == kWakeToken) {
+                drainCounter(wakeFd_);
+                wakes_.fetch_add(1, std::memory_order_relaxed);
+            } else if (token == kTimerToken) {
+                drainCounter(timerFd_);
+                const int64_t late = armedMicros_ ? traceClockMicros() - armedMicros_ : 0;
+                const uint64_t lateMicros = late > 0 ? static_cast<uint64_t>(late) : 0;
+                timerExpiries_.fetch_add(1, std::memory_order_relaxed);
+                totalTimerLateMicros_.fetch_add(lateMicros, std::memory_order_relaxed);
+                if (lateMicros > maxTimerLateMicros_.load(std::memory_order_relaxed)) {
+                    maxTimerLateMicros_.store(lateMicros, std::memory_order_relaxed);
+                }
+                armedMicros_ = 0;
+            } else {
+                dispatch(token);
+            }
+        }
+        dispatching_.store(false);
+    }
+}
+
+void EventLoop::dispatch(uint32_t token) {
+    if (token >= sources_.size()) {
+        return;
+    }
+    Source& source = sources_[token];
+    if (source.fd.load() >= 0) {
+        source.handler();
+    }
+}
+
+void EventLoop::runTimers() {
+    const int64_t nowMicros = traceClockMicros();
+    int64_t earliest = 0;
+    for (size_t i = 0; i < timerCount_; ++i) {
+        const int64_t due = timers_[i](nowMicros);
+        if (due != 0 && (earliest == 0 || due < earliest)) {
+            earliest = due;
+        }
+    }
+    armTimer(earliest);
+}
+
+void EventLoop::armTimer(int64_t dueMicros) {
+    if (dueMicros == armedMicros_) {
+        return;
+    }
+    // Absolute: a deadline already past fires at once. All zero disarms.
+    struct itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    if (dueMicros > 0) {
+        spec.it_value.tv_sec = static_cast<time_t>(dueMicros / 1000000);
+        spec.it_value.tv_nsec = static_cast<long>(dueMicros % 1000000) * 1000;
+    }
+    timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    armedMicros_ = dueMicros > 0 ? dueMicros : 0;
+}
+
+} // namespace ptt
+} // namespace meshrider
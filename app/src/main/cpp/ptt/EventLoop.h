@@ -0,0 +1,143 @@
+/*
+ * Mesh Rider Wave - Native Event Loop
+ * One epoll reactor thread for every socket and timer of a session
+ *
+ * - Sources: a descriptor and the handler run on the loop thread when it
+ *   is readable. watch()/unwatch() from any thread; unwatch() returns once
+ *   the loop can no longer be inside that handler, so the caller may close
+ *   the descriptor straight away.
+ * - Timers: a service run at the top of every pass with the current time.
+ *   It does whatever is due and returns its next deadline (0: none); the
+ *   earliest deadline arms one timerfd (absolute CLOCK_MONOTONIC), so a
+ *   timer fires to the microsecond rather than on epoll's millisecond
+ *   timeout.
+ * - wake(): another thread moved a deadline; the loop re-runs its timers.
+ * - stop(): the pass in progress finishes, then the thread is joined.
+ *   Handlers and services never block, so the join is bounded and nothing
+ *   is detached.
+ *
+ * No idle poll: between events the thread sleeps in epoll_wait() with no
+ * timeout.
+ */
+
+#ifndef MESHRIDER_PTT_EVENT_LOOP_H
+#define MESHRIDER_PTT_EVENT_LOOP_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "PowerMeter.h"
+#include "ThreadManager.h"
+
+namespace meshrider {
+namespace ptt {
+
+// Home socket, RTCP socket and one per scan channel, with room to spare
+constexpr size_t kMaxEventSources = 16;
+
+// Delay line, RTCP, floor and relay
+constexpr size_t kMaxEventTimers = 8;
+
+struct EventLoopStats {
+    uint64_t passes = 0;            // epoll_wait() returns
+    uint64_t wakes = 0;             // wake() / stop() seen by the loop
+    uint64_t timerExpiries = 0;     // timerfd fired
+    uint64_t maxTimerLateMicros = 0;
+    uint64_t totalTimerLateMicros = 0;
+};
+
+/**
+ * epoll + eventfd + timerfd reactor (THREAD-SAFE where noted)
+ *
+ * Lifecycle: initialize() -> addTimer() / watch() -> start() ... stop()
+ * -> release(). start() and stop() may repeat; timers stay registered.
+ */
+class EventLoop {
+public:
+    using Handler = std::function<void()>;
+    using TimerService = std::function<int64_t(int64_t nowMicros)>;
+
+    EventLoop() = default;
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // epoll, wake eventfd and timerfd; false (nothing left open) if any fails
+    bool initialize();
+
+    // Close everything and forget sources and timers. Loop stopped.
+    void release();
+
+    // Thread-safe. False when the table is full or epoll refuses the fd.
+    bool watch(int fd, Handler handler);
+    // Thread-safe, not from a handler. False if fd is not watched.
+    bool unwatch(int fd);
+
+    // While stopped. Services run in registration order.
+    bool addTimer(TimerService service);
+
+    // Loop thread under the ThreadManager policy for role (threads may be null)
+    bool start(ThreadManager* threads, ThreadRole role, const char* name);
+    // Thread-safe, not from a handler: returns with the thread joined
+    void stop();
+
+    // Thread-safe: re-run the timer services now
+    void wake();
+
+    bool isRunning() const { return running_.load(); }
+    bool isInitialized() const { return epollFd_ >= 0; }
+
+    // Counted on every return from epoll_wait(). While stopped.
+    void setPowerMeter(std::shared_ptr<PowerMeter> meter) { powerMeter_ = std::move(meter); }
+
+    EventLoopStats getStats() const;
+
+private:
+    struct Source {
+        std::atomic<int> fd{-1};
+        Handler handler;
+    };
+
+    void run();
+    void runTimers();
+    void armTimer(int64_t dueMicros);
+    void dispatch(uint32_t token);
+
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    int timerFd_ = -1;
+
+    // Slot index is the epoll token. Slots change under sourceMutex_;
+    // dispatching_ is held while the loop runs handlers (unwatch waits it out).
+    // A slot being unwatched holds kRetiredFd until then, so it is not reused.
+    std::array<Source, kMaxEventSources> sources_;
+    std::mutex sourceMutex_;
+    std::atomic<bool> dispatching_{false};
+
+    std::array<TimerService, kMaxEventTimers> timers_;
+    size_t timerCount_ = 0;
+    int64_t armedMicros_ = 0;       // Loop thread only; 0 = disarmed
+
+    std::thread thread_;
+    std::mutex threadMutex_;        // start() / stop()
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopRequested_{false};
+    std::shared_ptr<PowerMeter> powerMeter_;
+
+    std::atomic<uint64_t> passes_{0};
+    std::atomic<uint64_t> wakes_{0};
+    std::atomic<uint64_t> timerExpiries_{0};
+    std::atomic<uint64_t> maxTimerLateMicros_{0};
+    std::atomic<uint64_t> totalTimerLateMicros_{0};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_EVENT_LOOP_H
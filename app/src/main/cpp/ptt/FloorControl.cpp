@@ -0,0 +1,524 @@
+/*
+ * Mesh Rider Wave - Native Floor Control Implementation
+ */
+
+#include "FloorControl.h"
+#include "RtcpSession.h"
+#include <algorithm>
+#include <chrono>
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+constexpr uint8_t kEmergencyFlag = 0x80;
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v >> 8);
+    p[1] = static_cast<uint8_t>(v);
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+int64_t millisToMicros(uint32_t ms) {
+    return static_cast<int64_t>(ms) * 1000;
+}
+
+} // namespace
+
+void FloorControl::setLocalSsrc(uint32_t ssrc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    localSsrc_ = ssrc;
+}
+
+void FloorControl::configure(const FloorConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    config_.retryIntervalMs = std::max<uint32_t>(config_.retryIntervalMs, 5);
+    config_.requestTimeoutMs = std::max(config_.requestTimeoutMs, config_.retryIntervalMs);
+    config_.takenRefreshMs = std::max<uint32_t>(config_.takenRefreshMs, 100);
+    if (!config_.enabled) {
+        holderSsrc_ = 0;
+        emergencyRepeats_ = 0;
+    }
+    setStateLocked(config_.enabled && holderSsrc_ != 0 ? FloorState::TAKEN : FloorState::IDLE);
+}
+
+FloorConfig FloorControl::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+// ============================================================================
+// Local press / release
+// ============================================================================
+
+FloorState FloorControl::request(uint8_t priority, bool emergency, int64_t nowMicros,
+                                 FloorOutbox& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return FloorState::GRANTED;
+    }
+    if (state_ == FloorState::GRANTED) {
+        return state_;
+    }
+
+    ++stats_.requests;
+    localRank_ = rankOf(priority, emergency);
+    ++requestId_;
+    requestMicros_ = nowMicros;
+    for (Member& member : members_) {
+        member.granted = false;
+    }
+
+    // Emergency: talk now, tell the holder to stop, repeat the request
+    if (emergency) {
+        if (holderSsrc_ != 0) {
+            queueLocked(out, FloorMessageType::REVOKE, localRank_, requestId_, holderSsrc_, 0);
+            const uint32_t preempted = holderSsrc_;
+            holderSsrc_ = 0;
+            emitLocked(FloorEventType::IDLE, preempted, holderRank_, nowMicros);
+        }
+        queueLocked(out, FloorMessageType::REQUEST, localRank_, requestId_, 0, 0);
+        emergencyRepeats_ = 2;
+        grantLocked(nowMicros, out);
+        return state_;
+    }
+
+    // A holder we know of outranks us: no round trip needed
+    if (holderSsrc_ != 0 && localRank_ <= holderRank_) {
+        denyLocked(holderSsrc_, holderRank_, nowMicros);
+        return state_;
+    }
+
+    // Nobody heard recently: announce and talk (a hidden holder answers
+    // TAKEN with REVOKE if it outranks us)
+    if (allMembersGrantedLocked(nowMicros)) {
+        grantLocked(nowMicros, out);
+        return state_;
+    }
+
+    queueLocked(out, FloorMessageType::REQUEST, localRank_, requestId_, 0, 0);
+    requestDeadlineMicros_ = nowMicros + millisToMicros(config_.requestTimeoutMs);
+    nextSendMicros_ = nowMicros + millisToMicros(config_.retryIntervalMs);
+    setStateLocked(FloorState::PENDING);
+    return state_;
+}
+
+void FloorControl::release(int64_t nowMicros, FloorOutbox& out) {
+    (void)nowMicros;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return;
+    }
+    if (state_ == FloorState::GRANTED) {
+        queueLocked(out, FloorMessageType::RELEASE, localRank_, requestId_, 0, 0);
+    }
+    emergencyRepeats_ = 0;
+    if (state_ == FloorState::GRANTED || state_ == FloorState::PENDING) {
+        setStateLocked(holderSsrc_ != 0 ? FloorState::TAKEN : FloorState::IDLE);
+    }
+}
+
+FloorState FloorControl::awaitDecision(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t generation = wakeGeneration_;
+    changed_.wait_for(lock, std::chrono::milliseconds(std::max(0, timeoutMs)), [&] {
+        return state_ != FloorState::PENDING || wakeGeneration_ != generation;
+    });
+    return state_;
+}
+
+// ============================================================================
+// Received messages
+// ============================================================================
+
+bool FloorControl::isFloorMessage(const uint8_t* data, size_t length) {
+    return length >= 12 && (data[0] >> 6) == 2 && data[1] == kRtcpApplication &&
+           get32(data + 8) == kFloorAppName;
+}
+
+void FloorControl::onMessage(const uint8_t* data, size_t length, int64_t nowMicros,
+                             FloorOutbox& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (length < kFloorMessageBytes) {
+        ++stats_.malformed;
+        return;
+    }
+    const size_t declared = (static_cast<size_t>(get16(data + 2)) + 1) * 4;
+    const uint8_t subtype = data[0] & 0x1F;
+    if (declared < kFloorMessageBytes || declared > length ||
+        subtype < static_cast<uint8_t>(FloorMessageType::REQUEST) ||
+        subtype > static_cast<uint8_t>(FloorMessageType::REVOKE)) {
+        ++stats_.malformed;
+        return;
+    }
+
+    Message message;
+    message.type = static_cast<FloorMessageType>(subtype);
+    message.sender = get32(data + 4);
+    message.rank = (data[13] & kEmergencyFlag) ? kFloorEmergencyRank : data[12];
+    message.requestId = get16(data + 14);
+    message.target = get32(data + 16);
+    message.holder = get32(data + 20);
+
+    // Our own message looped back by the multicast group
+    if (message.sender == localSsrc_) {
+        return;
+    }
+    ++stats_.messagesReceived;
+    if (!config_.enabled) {
+        return;
+    }
+
+    Member* member = touchMemberLocked(message.sender, nowMicros);
+    if (message.sender == holderSsrc_) {
+        holderHeardMicros_ = nowMicros;
+    }
+
+    const bool answersUs = message.target == localSsrc_ && message.requestId == requestId_;
+    switch (message.type) {
+        case FloorMessageType::REQUEST:
+            onRequestLocked(message, nowMicros, out);
+            break;
+
+        case FloorMessageType::GRANT:
+            if (answersUs && state_ == FloorState::PENDING) {
+                if (member) {
+                    member->granted = true;
+                }
+                if (allMembersGrantedLocked(nowMicros)) {
+                    grantLocked(nowMicros, out);
+                }
+            }
+            break;
+
+        case FloorMessageType::DENY:
+            if (answersUs && state_ == FloorState::PENDING) {
+                const uint32_t winner = message.holder != 0 ? message.holder : message.sender;
+                denyLocked(winner, message.rank, nowMicros);
+                if (message.holder != 0 && message.holder != localSsrc_) {
+                    setHolderLocked(message.holder, message.rank, nowMicros);
+                }
+            }
+            break;
+
+        case FloorMessageType::RELEASE:
+            if (message.sender == holderSsrc_) {
+                clearHolderLocked(nowMicros);
+            }
+            break;
+
+        case FloorMessageType::TAKEN:
+            if (state_ == FloorState::GRANTED) {
+                // Two holders (simultaneous grant or healed partition)
+                if (outranks(message.rank, message.sender, localRank_, localSsrc_)) {
+                    revokeLocked(message.sender, message.rank, nowMicros);
+                    setHolderLocked(message.sender, message.rank, nowMicros);
+                } else {
+                    queueLocked(out, FloorMessageType::REVOKE, localRank_, requestId_,
+                                message.sender, 0);
+                }
+            } else if (state_ == FloorState::PENDING && localRank_ <= message.rank) {
+                denyLocked(message.sender, message.rank, nowMicros);
+                setHolderLocked(message.sender, message.rank, nowMicros);
+            } else {
+                // Pending and outranking it: our retransmits preempt the holder
+                setHolderLocked(message.sender, message.rank, nowMicros);
+            }
+            break;
+
+        case FloorMessageType::REVOKE:
+            if (message.target == localSsrc_ && state_ == FloorState::GRANTED &&
+                outranks(message.rank, message.sender, localRank_, localSsrc_)) {
+                revokeLocked(message.sender, message.rank, nowMicros);
+            }
+            break;
+    }
+}
+
+void FloorControl::onRequestLocked(const Message& message, int64_t nowMicros, FloorOutbox& out) {
+    switch (state_) {
+        case FloorState::GRANTED:
+            // Incumbent keeps the floor against equal rank
+            if (message.rank > localRank_) {
+                revokeLocked(message.sender, message.rank, nowMicros);
+                queueLocked(out, FloorMessageType::GRANT, 0, message.requestId, message.sender, 0);
+            } else {
+                queueLocked(out, FloorMessageType::DENY, localRank_, message.requestId,
+                            message.sender, localSsrc_);
+            }
+            break;
+
+        case FloorState::PENDING:
+            // Collision: higher rank, then lower SSRC
+            if (outranks(message.rank, message.sender, localRank_, localSsrc_)) {
+                denyLocked(message.sender, message.rank, nowMicros);
+                queueLocked(out, FloorMessageType::GRANT, 0, message.requestId, message.sender, 0);
+            } else {
+                queueLocked(out, FloorMessageType::DENY, localRank_, message.requestId,
+                            message.sender, 0);
+            }
+            break;
+
+        case FloorState::IDLE:
+        case FloorState::TAKEN:
+            // Deny on the holder's behalf too, in case its own answer is lost
+            if (holderSsrc_ != 0 && holderSsrc_ != message.sender && message.rank <= holderRank_) {
+                queueLocked(out, FloorMessageType::DENY, holderRank_, message.requestId,
+                            message.sender, holderSsrc_);
+            } else {
+                queueLocked(out, FloorMessageType::GRANT, 0, message.requestId, message.sender, 0);
+            }
+            break;
+    }
+}
+
+void FloorControl::onPeerHeard(uint32_t ssrc, int64_t nowMicros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled || ssrc == localSsrc_) {
+        return;
+    }
+    touchMemberLocked(ssrc, nowMicros);
+    if (ssrc == holderSsrc_) {
+        holderHeardMicros_ = nowMicros;
+    }
+}
+
+// ============================================================================
+// Timers
+// ============================================================================
+
+void FloorControl::service(int64_t nowMicros, FloorOutbox& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return;
+    }
+
+    if (state_ == FloorState::PENDING) {
+        if (nowMicros >= requestDeadlineMicros_) {
+            // Nobody objected in time (lost answers, partition): talk
+            grantLocked(nowMicros, out);
+        } else if (nowMicros >= nextSendMicros_) {
+            queueLocked(out, FloorMessageType::REQUEST, localRank_, requestId_, 0, 0);
+            nextSendMicros_ = nowMicros + millisToMicros(config_.retryIntervalMs);
+        }
+    } else if (state_ == FloorState::GRANTED && nowMicros >= nextSendMicros_) {
+        if (emergencyRepeats_ > 0) {
+            --emergencyRepeats_;
+            queueLocked(out, FloorMessageType::REQUEST, localRank_, requestId_, 0, 0);
+        }
+        queueLocked(out, FloorMessageType::TAKEN, localRank_, requestId_, 0, 0);
+        nextSendMicros_ = nowMicros + millisToMicros(
+            emergencyRepeats_ > 0 ? config_.retryIntervalMs : config_.takenRefreshMs);
+    }
+
+    if (holderSsrc_ != 0 &&
+        nowMicros - holderHeardMicros_ > millisToMicros(config_.holderTimeoutMs)) {
+        clearHolderLocked(nowMicros);
+    }
+}
+
+int64_t FloorControl::nextDeadlineMicros() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return 0;
+    }
+    int64_t next = 0;
+    auto consider = [&next](int64_t due) {
+        if (next == 0 || due < next) {
+            next = due;
+        }
+    };
+    if (state_ == FloorState::PENDING) {
+        consider(std::min(nextSendMicros_, requestDeadlineMicros_));
+    } else if (state_ == FloorState::GRANTED) {
+        consider(nextSendMicros_);
+    }
+    if (holderSsrc_ != 0) {
+        consider(holderHeardMicros_ + millisToMicros(config_.holderTimeoutMs) + 1);
+    }
+    return next;
+}
+
+// ============================================================================
+// Queries and events
+// ============================================================================
+
+FloorState FloorControl::getState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+uint32_t FloorControl::getHolder() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_ == FloorState::GRANTED ? localSsrc_ : holderSsrc_;
+}
+
+size_t FloorControl::waitEvents(FloorEvent* out, size_t maxEvents, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t generation = wakeGeneration_;
+    changed_.wait_for(lock, std::chrono::milliseconds(std::max(0, timeoutMs)), [&] {
+        return eventCount_ > 0 || wakeGeneration_ != generation;
+    });
+    const size_t count = std::min(maxEvents, eventCount_);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = events_[eventHead_];
+        eventHead_ = (eventHead_ + 1) % kFloorEventQueueSize;
+    }
+    eventCount_ -= count;
+    return count;
+}
+
+void FloorControl::wakeWaiters() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++wakeGeneration_;
+    }
+    changed_.notify_all();
+}
+
+FloorStats FloorControl::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// ============================================================================
+// Helpers (mutex_ held)
+// ============================================================================
+
+void FloorControl::queueLocked(FloorOutbox& out, FloorMessageType type, uint32_t rank,
+                               uint16_t requestId, uint32_t target, uint32_t holder) const {
+    if (out.count >= out.packets.size()) {
+        return;
+    }
+    uint8_t* p = out.packets[out.count++].data();
+    p[0] = static_cast<uint8_t>(0x80 | static_cast<uint8_t>(type));
+    p[1] = kRtcpApplication;
+    put16(p + 2, kFloorMessageBytes / 4 - 1);
+    put32(p + 4, localSsrc_);
+    put32(p + 8, kFloorAppName);
+    p[12] = static_cast<uint8_t>(std::min<uint32_t>(rank, 255));
+    p[13] = rank >= kFloorEmergencyRank ? kEmergencyFlag : 0;
+    put16(p + 14, requestId);
+    put32(p + 16, target);
+    put32(p + 20, holder);
+}
+
+void FloorControl::emitLocked(FloorEventType type, uint32_t ssrc, uint32_t rank,
+                              int64_t nowMicros) {
+    FloorEvent event;
+    event.type = type;
+    event.ssrc = ssrc;
+    event.priority = static_cast<uint8_t>(std::min<uint32_t>(rank, 255));
+    event.emergency = rank >= kFloorEmergencyRank;
+    event.timeMicros = nowMicros;
+
+    if (eventCount_ == kFloorEventQueueSize) {
+        eventHead_ = (eventHead_ + 1) % kFloorEventQueueSize;
+        --eventCount_;
+    }
+    events_[(eventHead_ + eventCount_) % kFloorEventQueueSize] = event;
+    ++eventCount_;
+    changed_.notify_all();
+}
+
+void FloorControl::setStateLocked(FloorState state) {
+    state_ = state;
+    mayTransmit_.store(!config_.enabled || state == FloorState::GRANTED,
+                       std::memory_order_release);
+    changed_.notify_all();
+}
+
+void FloorControl::grantLocked(int64_t nowMicros, FloorOutbox& out) {
+    ++stats_.grants;
+    stats_.lastGrantMicros = static_cast<uint64_t>(std::max<int64_t>(0, nowMicros - requestMicros_));
+    holderSsrc_ = 0;
+    setStateLocked(FloorState::GRANTED);
+    emitLocked(FloorEventType::GRANTED, localSsrc_, localRank_, nowMicros);
+    queueLocked(out, FloorMessageType::TAKEN, localRank_, requestId_, 0, 0);
+    nextSendMicros_ = nowMicros + millisToMicros(
+        emergencyRepeats_ > 0 ? config_.retryIntervalMs : config_.takenRefreshMs);
+}
+
+void FloorControl::denyLocked(uint32_t winner, uint32_t winnerRank, int64_t nowMicros) {
+    ++stats_.denials;
+    setStateLocked(holderSsrc_ != 0 ? FloorState::TAKEN : FloorState::IDLE);
+    emitLocked(FloorEventType::DENIED, winner, winnerRank, nowMicros);
+}
+
+void FloorControl::revokeLocked(uint32_t preemptor, uint32_t preemptorRank, int64_t nowMicros) {
+    ++stats_.revocations;
+    emergencyRepeats_ = 0;
+    setStateLocked(holderSsrc_ != 0 ? FloorState::TAKEN : FloorState::IDLE);
+    emitLocked(FloorEventType::REVOKED, preemptor, preemptorRank, nowMicros);
+}
+
+void FloorControl::setHolderLocked(uint32_t ssrc, uint32_t rank, int64_t nowMicros) {
+    const bool changed = holderSsrc_ != ssrc;
+    holderSsrc_ = ssrc;
+    holderRank_ = rank;
+    holderHeardMicros_ = nowMicros;
+    if (state_ == FloorState::IDLE) {
+        setStateLocked(FloorState::TAKEN);
+    }
+    if (changed) {
+        emitLocked(FloorEventType::TAKEN, ssrc, rank, nowMicros);
+    }
+}
+
+void FloorControl::clearHolderLocked(int64_t nowMicros) {
+    const uint32_t former = holderSsrc_;
+    holderSsrc_ = 0;
+    if (state_ == FloorState::TAKEN) {
+        setStateLocked(FloorState::IDLE);
+    }
+    emitLocked(FloorEventType::IDLE, former, holderRank_, nowMicros);
+}
+
+FloorControl::Member* FloorControl::touchMemberLocked(uint32_t ssrc, int64_t nowMicros) {
+    Member* slot = nullptr;
+    for (Member& member : members_) {
+        if (member.ssrc == ssrc) {
+            member.lastHeardMicros = nowMicros;
+            return &member;
+        }
+        // Free slot first, else the member heard least recently
+        if (!slot || (slot->ssrc != 0 &&
+                      (member.ssrc == 0 || member.lastHeardMicros < slot->lastHeardMicros))) {
+            slot = &member;
+        }
+    }
+    slot->ssrc = ssrc;
+    slot->lastHeardMicros = nowMicros;
+    slot->granted = false;
+    return slot;
+}
+
+bool FloorControl::allMembersGrantedLocked(int64_t nowMicros) const {
+    const int64_t horizon = nowMicros - millisToMicros(config_.memberTimeoutMs);
+    for (const Member& member : members_) {
+        if (member.ssrc != 0 && member.lastHeardMicros >= horizon && !member.granted) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,255 @@
+/*
+ * Mesh Rider Wave - Native Floor Control (MCPTT-style, distributed)
+ * Talk arbitration decided on the RTP receive thread, next to the voice
+ *
+ * Messages are reduced-size RTCP APP packets (RFC 3550 6.7, RFC 5506),
+ * name "MRFC", sent on the RTP socket and demultiplexed by type (RFC 5761),
+ * so they share the voice path, its SRTCP protection and its QoS marking:
+ *
+ *      0                   1                   2                   3
+ *     |V=2|P| subtype |   PT=204      |          length = 5           |
+ *     |                         sender SSRC                           |
+ *     |                          "MRFC"                               |
+ *     |   priority    |E|  reserved   |          request id           |
+ *     |                   target SSRC (answers, revoke)               |
+ *     |                   holder SSRC (deny hint)                     |
+ *
+ * Arbitration follows FloorControlProtocol.kt, without the Kotlin hops:
+ * - REQUEST: every member answers GRANT or DENY; the holder, and anyone
+ *   who knows the holder, denies unless the requester outranks it.
+ * - The floor is ours once every member heard recently has granted, or the
+ *   request window passes with no DENY (partition: talk rather than block).
+ * - Two simultaneous requests: higher rank wins, then the lower SSRC.
+ * - Emergency (E flag) outranks every priority and is granted at once; the
+ *   holder it hits is revoked.
+ * - TAKEN announces and refreshes a hold; RELEASE ends it; a holder silent
+ *   for holderTimeoutMs is presumed gone. Two holders (partition heal):
+ *   the loser of the rank comparison gets REVOKE and stops.
+ *
+ * While enabled, mayTransmit() gates RtpPacketizer::sendAudio, so a deny or
+ * revoke silences this radio the moment it is decided. Decisions are also
+ * queued as events for Kotlin, which waits on them from its own thread.
+ */
+
+#ifndef MESHRIDER_PTT_FLOOR_CONTROL_H
+#define MESHRIDER_PTT_FLOOR_CONTROL_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace meshrider {
+namespace ptt {
+
+constexpr uint32_t kFloorAppName = 0x4D524643;     // "MRFC"
+constexpr size_t kFloorMessageBytes = 24;
+
+// Members whose grants a request waits for (heard within memberTimeoutMs)
+constexpr size_t kMaxFloorMembers = 32;
+
+// Decisions buffered for Kotlin; the oldest is dropped when full
+constexpr size_t kFloorEventQueueSize = 32;
+
+// Messages one call can produce (answer + TAKEN + REVOKE, with headroom)
+constexpr size_t kFloorOutboxSize = 4;
+
+// Emergency outranks every priority (0..255)
+constexpr uint32_t kFloorEmergencyRank = 256;
+
+enum class FloorMessageType : uint8_t {
+    REQUEST = 1,
+    GRANT = 2,
+    DENY = 3,
+    RELEASE = 4,
+    TAKEN = 5,
+    REVOKE = 6
+};
+
+enum class FloorState : uint8_t {
+    IDLE,       // Nobody known to hold the floor
+    PENDING,    // Our request is out
+    GRANTED,    // We hold the floor
+    TAKEN       // A peer holds it
+};
+
+// Order mirrors PttFloorEvent.Type in Kotlin
+enum class FloorEventType : uint8_t {
+    GRANTED,    // We hold the floor (ssrc = us)
+    DENIED,     // Our request lost (ssrc = holder or winning requester)
+    REVOKED,    // Our hold was preempted (ssrc = preemptor)
+    TAKEN,      // A peer started holding (ssrc = holder)
+    IDLE        // The floor is free again (ssrc = former holder)
+};
+
+struct FloorEvent {
+    FloorEventType type;
+    uint32_t ssrc;
+    uint8_t priority;
+    bool emergency;
+    int64_t timeMicros;         // traceClockMicros()
+};
+
+struct FloorConfig {
+    bool enabled = false;               // Off: mayTransmit() is always true
+    uint32_t requestTimeoutMs = 120;    // No DENY by then: granted
+    uint32_t retryIntervalMs = 40;      // REQUEST retransmit while pending
+    uint32_t takenRefreshMs = 1000;     // TAKEN repeat while holding
+    uint32_t holderTimeoutMs = 3000;    // Holder silent (no TAKEN, no voice): gone
+    uint32_t memberTimeoutMs = 30000;   // Member not heard: not waited for
+};
+
+struct FloorStats {
+    uint64_t requests;
+    uint64_t grants;
+    uint64_t denials;
+    uint64_t revocations;
+    uint64_t lastGrantMicros;           // Request -> grant of the latest grant
+    uint64_t messagesReceived;
+    uint64_t malformed;
+};
+
+// Messages to send after the call returns (callers send outside the lock)
+struct FloorOutbox {
+    std::array<std::array<uint8_t, kFloorMessageBytes>, kFloorOutboxSize> packets;
+    size_t count = 0;
+};
+
+/**
+ * Floor state for one radio on its home talkgroup (THREAD-SAFE)
+ *
+ * request()/release() run on JNI threads, onMessage()/onPeerHeard()/
+ * service() on the receive thread; one short mutex covers the state.
+ * Nothing allocates after construction.
+ */
+class FloorControl {
+public:
+    FloorControl() = default;
+
+    FloorControl(const FloorControl&) = delete;
+    FloorControl& operator=(const FloorControl&) = delete;
+
+    void setLocalSsrc(uint32_t ssrc);
+
+    // Disabling drops any hold or pending request without telling peers
+    void configure(const FloorConfig& config);
+    FloorConfig getConfig() const;
+
+    // Local PTT press. Returns the state right after: GRANTED (no members
+    // heard, or emergency), PENDING, or TAKEN when a known holder outranks
+    // us (denied without a round trip).
+    FloorState request(uint8_t priority, bool emergency, int64_t nowMicros, FloorOutbox& out);
+
+    // Local PTT release (or cancel of a pending request)
+    void release(int64_t nowMicros, FloorOutbox& out);
+
+    // Block until a pending request is decided or timeoutMs passes
+    FloorState awaitDecision(int timeoutMs);
+
+    // RTCP APP packet with our name (single packet or first in a compound)
+    static bool isFloorMessage(const uint8_t* data, size_t length);
+
+    void onMessage(const uint8_t* data, size_t length, int64_t nowMicros, FloorOutbox& out);
+
+    // Any RTP or RTCP from a member: keeps it in the grant set and, for the
+    // holder, keeps the hold alive
+    void onPeerHeard(uint32_t ssrc, int64_t nowMicros);
+
+    // Retransmits, request window, TAKEN refresh, holder timeout
+    void service(int64_t nowMicros, FloorOutbox& out);
+
+    // When service() next has work, 0 if nothing is scheduled
+    int64_t nextDeadlineMicros() const;
+
+    // False while enabled and we do not hold the floor (lock-free)
+    bool mayTransmit() const { return mayTransmit_.load(std::memory_order_acquire); }
+
+    FloorState getState() const;
+    uint32_t getHolder() const;
+
+    // Wait up to timeoutMs for events; returns how many were copied
+    size_t waitEvents(FloorEvent* out, size_t maxEvents, int timeoutMs);
+
+    // Release every waitEvents()/awaitDecision() caller (shutdown)
+    void wakeWaiters();
+
+    FloorStats getStats() const;
+
+private:
+    struct Member {
+        uint32_t ssrc = 0;
+        int64_t lastHeardMicros = 0;
+        bool granted = false;           // Answered the current request
+    };
+
+    struct Message {
+        FloorMessageType type;
+        uint32_t sender;
+        uint32_t rank;
+        uint16_t requestId;
+        uint32_t target;
+        uint32_t holder;
+    };
+
+    static uint32_t rankOf(uint8_t priority, bool emergency) {
+        return emergency ? kFloorEmergencyRank : priority;
+    }
+
+    // a beats b: higher rank, then lower SSRC
+    static bool outranks(uint32_t rankA, uint32_t ssrcA, uint32_t rankB, uint32_t ssrcB) {
+        return rankA > rankB || (rankA == rankB && ssrcA < ssrcB);
+    }
+
+    void queueLocked(FloorOutbox& out, FloorMessageType type, uint32_t rank,
+                     uint16_t requestId, uint32_t target, uint32_t holder) const;
+    void emitLocked(FloorEventType type, uint32_t ssrc, uint32_t rank, int64_t nowMicros);
+    void setStateLocked(FloorState state);
+
+    void grantLocked(int64_t nowMicros, FloorOutbox& out);
+    void denyLocked(uint32_t winner, uint32_t winnerRank, int64_t nowMicros);
+    void revokeLocked(uint32_t preemptor, uint32_t preemptorRank, int64_t nowMicros);
+    void setHolderLocked(uint32_t ssrc, uint32_t rank, int64_t nowMicros);
+    void clearHolderLocked(int64_t nowMicros);
+
+    Member* touchMemberLocked(uint32_t ssrc, int64_t nowMicros);
+    bool allMembersGrantedLocked(int64_t nowMicros) const;
+
+    void onRequestLocked(const Message& message, int64_t nowMicros, FloorOutbox& out);
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;   // State decided or event queued
+    std::atomic<bool> mayTransmit_{true};
+
+    FloorConfig config_;
+    uint32_t localSsrc_ = 0;
+    FloorState state_ = FloorState::IDLE;
+
+    // Our request / hold
+    uint32_t localRank_ = 0;
+    uint16_t requestId_ = 0;
+    int64_t requestMicros_ = 0;
+    int64_t requestDeadlineMicros_ = 0;
+    int64_t nextSendMicros_ = 0;        // Next REQUEST retransmit or TAKEN refresh
+    uint32_t emergencyRepeats_ = 0;     // REQUEST(E) copies still to send while holding
+
+    // A peer's hold (state_ == TAKEN, or known while we are PENDING)
+    uint32_t holderSsrc_ = 0;
+    uint32_t holderRank_ = 0;
+    int64_t holderHeardMicros_ = 0;
+
+    std::array<Member, kMaxFloorMembers> members_{};
+
+    std::array<FloorEvent, kFloorEventQueueSize> events_{};
+    size_t eventHead_ = 0;
+    size_t eventCount_ = 0;
+    uint64_t wakeGeneration_ = 0;
+
+    FloorStats stats_{};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_FLOOR_CONTROL_H
@@ -8,15 +8,45 @@
  * - Added unicast peer management
  * - Fixed memory leaks
  * - Added comprehensive error handling
+ * - Direct ByteBuffer batch ingress/egress, off g_engineMutex
+ * - One-call lock-free telemetry snapshot for 1 Hz dashboards
+ * - Opt-in latency tracing with per-stage percentile export
+ * - Seeded network impairment controls for lab and instrumented-test runs
+ * - Scan channels: join/leave talkgroups on the running engine
+ * - DTX transmit gate control; marker bit on talkspurt starts
+ * - Re-initialize keeps the engine (codecs, streams); socket rebuilt only
+ *   when the group/port/fallback change. Warm standby control.
+ * - RTCP reports feed the rate controller; per-peer link quality export
+ * - Capture/playback DSP (high-pass, AGC, limiter) control
+ * - SRTP keys pushed from MLS epochs; one session outlives packetizer rebuilds
+ * - Native floor control: a grant starts capture, a revoke stops it
+ * - Relay role (reflector / member) control and reflector member export
+ * - Idle playback power policy; wakeups per power mode in telemetry
+ * - Received voice recording (Ogg/Opus per talker burst) control
+ * - Worker thread policies (priority, affinity) and wakeup latency export
+ * - Receive memory budget control; pool and arena usage in telemetry
+ * - Audio route (device ids, AEC) control; stream recoveries in telemetry
+ * - Codec profile per channel; per-profile call quality (E-model) export
  */
 
 #include "AudioEngine.h"
 #include "RtpPacketizer.h"
-#include <android/log.h>
+#include "SrtpSession.h"
+#include "FloorControl.h"
+#include "ThreadManager.h"
+#include "LatencyTracer.h"
+#include "SpscRingBuffer.h"
+#include "PttTelemetry.h"
+#include "PttLog.h"
 #include <jni.h>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <arpa/inet.h>
 
 #define TAG "MeshRider:PTT-JNI"
 
@@ -28,6 +58,288 @@ static std::unique_ptr<AudioEngine> g_audioEngine;
 static std::unique_ptr<RtpPacketizer> g_packetizer;
 static std::mutex g_engineMutex;
 
+// Network configuration g_packetizer was built with (under g_engineMutex)
+struct TransportConfig {
+    std::string group;
+    uint16_t port = 0;
+    bool unicastFallback = false;
+
+    bool operator==(const TransportConfig& other) const {
+        return group == other.group && port == other.port &&
+               unicastFallback == other.unicastFallback;
+    }
+};
+static TransportConfig g_transportConfig;
+
+// RTCP settings, reapplied whenever the packetizer is rebuilt (under g_engineMutex)
+static RtcpConfig g_rtcpConfig;
+
+// Redundant transmission, likewise reapplied on rebuild (under g_engineMutex)
+static RedundancyConfig g_redundancyConfig;
+
+// Receive memory budget, given to each new engine (under g_engineMutex)
+static size_t g_memoryBudgetBytes = kDefaultMemoryBudgetBytes;
+
+// Audio route, likewise given to each new engine (under g_engineMutex)
+static AudioRoute g_audioRoute;
+
+// Relay role and reflector, likewise reapplied on rebuild (under g_engineMutex)
+static RelayConfig g_relayConfig;
+
+// SRTP keys and per-sender replay state. Shared with every packetizer built,
+// so a socket rebuild neither drops the key nor resets replay windows.
+// Thread-safe on its own; not under g_engineMutex.
+static const std::shared_ptr<SrtpSession> g_srtpSession = std::make_shared<SrtpSession>();
+
+// Floor state, likewise shared with every packetizer so a rebuild keeps the
+// hold. Thread-safe on its own: JNI threads block in it without
+// g_engineMutex (the receive thread needs neither to decide).
+static const std::shared_ptr<FloorControl> g_floorControl = std::make_shared<FloorControl>();
+
+// Worker thread policies and wakeup latency, likewise shared so restarted
+// threads keep their policy. Thread-safe on its own; not under g_engineMutex.
+static const std::shared_ptr<ThreadManager> g_threadManager = std::make_shared<ThreadManager>();
+
+// ============================================================================
+// Hot-path access (audio ingress/egress never takes g_engineMutex)
+// ============================================================================
+
+// Frame record in the direct buffers: uint16 length (native order) + payload
+constexpr size_t kAudioRecordHeaderBytes = sizeof(uint16_t);
+
+// Encoded frames waiting for Kotlin to drain (~2 s of 20 ms Opus at 24 kbps)
+constexpr size_t kEgressRingBytes = 16384;
+
+// Engine/packetizer as seen by hot-path calls. Lifecycle calls (under
+// g_engineMutex) clear them and wait for in-flight users before destroying.
+static std::atomic<AudioEngine*> g_hotEngine{nullptr};
+static std::atomic<RtpPacketizer*> g_hotPacketizer{nullptr};
+static std::atomic<uint32_t> g_hotPathUsers{0};
+
+class HotPathGuard {
+public:
+    HotPathGuard() {
+        g_hotPathUsers.fetch_add(1);
+        engine_ = g_hotEngine.load();
+        packetizer_ = g_hotPacketizer.load();
+    }
+    ~HotPathGuard() { g_hotPathUsers.fetch_sub(1); }
+
+    HotPathGuard(const HotPathGuard&) = delete;
+    HotPathGuard& operator=(const HotPathGuard&) = delete;
+
+    AudioEngine* engine() const { return engine_; }
+    RtpPacketizer* packetizer() const { return packetizer_; }
+
+private:
+    AudioEngine* engine_;
+    RtpPacketizer* packetizer_;
+};
+
+// Caller holds g_engineMutex
+static void retireHotEngine() {
+    g_hotEngine.store(nullptr);
+    g_hotPacketizer.store(nullptr);
+    while (g_hotPathUsers.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+// Caller holds g_engineMutex
+static void publishHotEngine() {
+    g_hotPacketizer.store(g_packetizer.get());
+    g_hotEngine.store(g_audioEngine.get());
+}
+
+// nativeGetTelemetry layout: a flat long[] so one call copies everything.
+// Bump the version when fields move; append new fields at the end.
+constexpr jlong kTelemetryLayoutVersion = 1;
+constexpr size_t kTelemetryValueCount = 2 + 5 + 5 + 3 + 4 + 12 + 6 + 3 + kUnderrunHistogramBuckets + 5 + 5 + 4 + 6 + 6 + 7 + 5 + 6 + 6 + 5 + 8 + 9;
+
+// nativeGetLatencyStats layout: header, then per LatencyStage
+// {samples, p50, p95, p99, max} in microseconds
+constexpr jlong kLatencyLayoutVersion = 1;
+constexpr size_t kLatencyHeaderValues = 6;
+constexpr size_t kLatencyValuesPerStage = 5;
+constexpr size_t kLatencyValueCount = kLatencyHeaderValues + kLatencyStageCount * kLatencyValuesPerStage;
+
+static size_t flattenTelemetry(const TelemetrySnapshot& t, jlong* out) {
+    size_t i = 0;
+    auto put = [&](uint64_t value) { out[i++] = static_cast<jlong>(value); };
+
+    put(static_cast<uint64_t>(kTelemetryLayoutVersion));
+    put(t.timestampMicros);
+
+    put(t.capture.callbacks);
+    put(t.capture.overruns);
+    put(t.capture.droppedSamples);
+    put(t.capture.ringHighWater);
+    put(t.capture.maxCallbackMicros);
+
+    put(t.encode.framesEncoded);
+    put(t.encode.bytesEncoded);
+    put(t.encode.pcmBytes);
+    put(t.encode.encodeErrors);
+    put(t.encode.settingsChanges);
+
+    put(t.send.packetsSent);
+    put(t.send.bytesSent);
+    put(t.send.sendFailures);
+
+    put(t.receive.packetsReceived);
+    put(t.receive.bytesReceived);
+    put(t.receive.receiveBatches);
+    put(t.receive.poolDrops);
+
+    put(t.jitter.packetsReceived);
+    put(t.jitter.packetsLost);
+    put(t.jitter.packetsLate);
+    put(t.jitter.packetsDiscarded);
+    put(t.jitter.framesPlayed);
+    put(t.jitter.framesConcealed);
+    put(t.jitter.framesRecovered);
+    put(t.jitter.framesStretched);
+    put(t.jitter.jitterMs);
+    put(t.jitter.targetDelayMs);
+    put(t.jitter.currentDelayMs);
+    put(t.jitter.activeTalkers);
+
+    put(t.decode.framesDecoded);
+    put(t.decode.fecFrames);
+    put(t.decode.plcFrames);
+    put(t.decode.decodeErrors);
+    put(t.decode.chunksMixed);
+    put(t.decode.ringHighWater);
+
+    put(t.playback.callbacks);
+    put(t.playback.underrunEvents);
+    put(t.playback.underrunSamples);
+    for (uint64_t bucket : t.playback.underrunHistogram) {
+        put(bucket);
+    }
+
+    put(t.dtx.framesSuppressed);
+    put(t.dtx.bytesSuppressed);
+    put(t.dtx.suppressedMs);
+    put(t.dtx.talkspurts);
+    put(t.dtx.comfortNoiseFrames);
+    put(t.keyUp.keyUps);
+    put(t.keyUp.warmKeyUps);
+    put(t.keyUp.lastTtffMicros);
+    put(t.keyUp.totalTtffMicros);
+    put(t.keyUp.maxTtffMicros);
+    put(t.rtcp.reportsSent);
+    put(t.rtcp.bytesSent);
+    put(t.rtcp.reportsReceived);
+    put(t.rtcp.malformed);
+    put(t.dsp.captureGainPercent);
+    put(t.dsp.captureLimitedSamples);
+    put(t.dsp.playbackGainPercent);
+    put(t.dsp.playbackLimitedSamples);
+    put(t.dsp.captureDeviceRate);
+    put(t.dsp.playbackDeviceRate);
+    put(t.srtp.keyEpoch);
+    put(t.srtp.rtpProtected);
+    put(t.srtp.rtpVerified);
+    put(t.srtp.authFailures);
+    put(t.srtp.replayDrops);
+    put(t.srtp.previousEpochPackets);
+    put(t.floor.state);
+    put(t.floor.holderSsrc);
+    put(t.floor.requests);
+    put(t.floor.grants);
+    put(t.floor.denials);
+    put(t.floor.revocations);
+    put(t.floor.lastGrantMicros);
+    put(t.redundancy.framesSent);
+    put(t.redundancy.bytesSent);
+    put(t.redundancy.duplicatesSent);
+    put(t.redundancy.framesUsed);
+    put(t.redundancy.framesDiscarded);
+    put(t.relay.role);
+    put(t.relay.members);
+    put(t.relay.packetsForwarded);
+    put(t.relay.bytesForwarded);
+    put(t.relay.duplicatesDropped);
+    put(t.relay.viaReflector);
+    put(t.power.mode);
+    put(t.power.activeMs);
+    put(t.power.idleMs);
+    put(t.power.activeWakeups);
+    put(t.power.idleWakeups);
+    put(t.power.idleEntries);
+    put(t.recording.bursts);
+    put(t.recording.packets);
+    put(t.recording.droppedPackets);
+    put(t.recording.bytesWritten);
+    put(t.recording.writes);
+    put(t.memory.budgetBytes);
+    put(t.memory.reservedBytes);
+    put(t.memory.streamSlots);
+    put(t.memory.smallAvailable);
+    put(t.memory.mtuAvailable);
+    put(t.memory.poolExhausted);
+    put(t.memory.packetsCompacted);
+    put(t.memory.lateAllocations);
+    put(t.streams.recoveries);
+    put(t.streams.recoveryFailures);
+    put(t.streams.routeChanges);
+    put(t.streams.lastRecoveryMicros);
+    put(t.streams.maxRecoveryMicros);
+    put(t.streams.totalRecoveryMicros);
+    put(t.streams.recovering);
+    put(t.streams.captureDeviceId);
+    put(t.streams.playbackDeviceId);
+
+    return i;
+}
+
+// Direct ByteBuffers registered by Kotlin once per initialize (global refs keep
+// them alive). Only changed under g_engineMutex with the hot engine retired.
+struct DirectAudioBuffers {
+    jobject ingressRef = nullptr;
+    uint8_t* ingress = nullptr;
+    size_t ingressCapacity = 0;
+    jobject egressRef = nullptr;
+    uint8_t* egress = nullptr;
+    size_t egressCapacity = 0;
+};
+static DirectAudioBuffers g_directBuffers;
+
+// Encoder thread produces, the Kotlin drain thread consumes
+static SpscRingBuffer<uint8_t, kEgressRingBytes> g_egressRing;
+static std::atomic<bool> g_egressEnabled{false};
+static std::atomic<uint64_t> g_egressDropped{0};
+
+static void releaseDirectBuffers(JNIEnv* env) {
+    if (g_directBuffers.ingressRef) {
+        env->DeleteGlobalRef(g_directBuffers.ingressRef);
+    }
+    if (g_directBuffers.egressRef) {
+        env->DeleteGlobalRef(g_directBuffers.egressRef);
+    }
+    g_directBuffers = DirectAudioBuffers{};
+}
+
+static void pushEgressFrame(const uint8_t* data, size_t size) {
+    if (size == 0 || size > OPUS_MAX_PACKET_SIZE) {
+        return;
+    }
+
+    // Header + payload in one write so the consumer never sees half a record
+    uint8_t record[kAudioRecordHeaderBytes + OPUS_MAX_PACKET_SIZE];
+    const uint16_t length = static_cast<uint16_t>(size);
+    std::memcpy(record, &length, kAudioRecordHeaderBytes);
+    std::memcpy(record + kAudioRecordHeaderBytes, data, size);
+
+    const size_t recordSize = kAudioRecordHeaderBytes + size;
+    if (g_egressRing.availableToWrite() < recordSize) {
+        g_egressDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    g_egressRing.write(record, recordSize);
+}
+
 // Audio callback that bridges to RTP
 class PttAudioCallback : public AudioEngineCallback {
 public:
@@ -36,10 +348,27 @@ public:
         __android_log_print(ANDROID_LOG_ERROR, TAG,
             "Audio engine error: %d", errorCode);
     }
-    void onAudioData(const uint8_t* data, size_t size) override {
-        // Send encoded Opus data via RTP
-        if (g_packetizer) {
-            g_packetizer->sendAudio(data, size, false);
+    void onAudioData(const uint8_t* data, size_t size, bool marker,
+                     uint32_t rtpTimestampIncrement, int64_t captureMicros) override {
+        // Send encoded Opus data via RTP (encoder thread, not under g_engineMutex)
+        {
+            HotPathGuard guard;
+            if (auto* packetizer = guard.packetizer()) {
+                packetizer->sendAudio(data, size, marker, rtpTimestampIncrement, captureMicros);
+            }
+        }
+
+        // Kotlin-side transports pull the same frames from the egress ring
+        if (g_egressEnabled.load(std::memory_order_relaxed)) {
+            pushEgressFrame(data, size);
+        }
+    }
+
+    void onAudioSuppressed(uint32_t rtpTimestampIncrement) override {
+        // Timestamp keeps running so the receiver sees a gap, not loss
+        HotPathGuard guard;
+        if (auto* packetizer = guard.packetizer()) {
+            packetizer->skipAudio(rtpTimestampIncrement);
         }
     }
 };
@@ -75,60 +404,111 @@ Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeInitialize(
     };
 
     try {
-        // Cleanup any existing instances
+        group = env->GetStringUTFChars(multicastGroup, nullptr);
+        if (!group) {
+            __android_log_print(ANDROID_LOG_ERROR, TAG,
+                "Failed to get multicast group string");
+            return JNI_FALSE;
+        }
+
+        TransportConfig config;
+        config.group = group;
+        config.port = static_cast<uint16_t>(port);
+        config.unicastFallback = enableUnicastFallback == JNI_TRUE;
+
+        // CRITICAL FIX: Always release string, even on exception
+        stringReleaser();
+        group = nullptr;
+
+        retireHotEngine();
+
+        // PRODUCTION FIX: Re-initialize with the same network keeps everything
+        // warm; only streams Oboe closed on error are reopened
+        if (g_audioEngine && g_packetizer && config == g_transportConfig) {
+            const bool ready = g_audioEngine->initialize(&g_audioCallback);
+            publishHotEngine();
+            __android_log_print(ANDROID_LOG_INFO, TAG,
+                "PTT audio engine already initialized for %s:%u, reused",
+                config.group.c_str(), config.port);
+            return ready ? JNI_TRUE : JNI_FALSE;
+        }
+
+        // Network changed: the encoder thread sends through g_packetizer
         if (g_audioEngine) {
-            g_audioEngine.reset();
+            g_audioEngine->stopCapture();
         }
         if (g_packetizer) {
             g_packetizer.reset();
         }
-
-        // Create audio engine
-        g_audioEngine = std::make_unique<AudioEngine>();
+        g_transportConfig = TransportConfig{};
+
+        // Codecs and streams are preallocated once and survive network changes
+        if (!g_audioEngine) {
+            g_audioEngine = std::make_unique<AudioEngine>();
+            g_audioEngine->setThreadManager(g_threadManager);
+            g_audioEngine->setMemoryBudget(g_memoryBudgetBytes);
+            g_audioEngine->setRoute(g_audioRoute);
+        }
         if (!g_audioEngine->initialize(&g_audioCallback)) {
             __android_log_print(ANDROID_LOG_ERROR, TAG,
                 "Failed to initialize audio engine");
+            g_audioEngine.reset();
             return JNI_FALSE;
         }
 
         // Create packetizer
-        group = env->GetStringUTFChars(multicastGroup, nullptr);
-        if (!group) {
-            __android_log_print(ANDROID_LOG_ERROR, TAG,
-                "Failed to get multicast group string");
-            return JNI_FALSE;
-        }
-
-        TransportMode mode = enableUnicastFallback ?
+        TransportMode mode = config.unicastFallback ?
             TransportMode::AUTO : TransportMode::MULTICAST;
 
         g_packetizer = std::make_unique<RtpPacketizer>();
-        bool initialized = g_packetizer->initialize(group, static_cast<uint16_t>(port), mode);
-
-        // CRITICAL FIX: Always release string, even on exception
-        stringReleaser();
-        group = nullptr;
+        bool initialized = g_packetizer->initialize(config.group.c_str(), config.port, mode);
 
         if (!initialized) {
             __android_log_print(ANDROID_LOG_ERROR, TAG,
                 "Failed to initialize RTP packetizer");
+            g_packetizer.reset();
             g_audioEngine.reset();
             return JNI_FALSE;
         }
 
         // Set up receive callback - bridge RTP received audio to playback
-        g_packetizer->setAudioCallback([](const uint8_t* data, size_t size, uint32_t ssrc) {
+        // Receive straight into the stream table's pool so packets move, not copy
+        g_packetizer->setPacketPool(g_audioEngine->getPacketPool());
+        g_packetizer->setPowerMeter(g_audioEngine->getPowerMeter());
+        g_packetizer->setSrtpSession(g_srtpSession);
+        g_packetizer->setFloorControl(g_floorControl);
+        g_packetizer->setThreadManager(g_threadManager);
+        // Both callbacks run on the receive loop: engine only through the
+        // hot-path publication, so lifecycle calls can retire it under them
+        g_packetizer->setAudioCallback([](PacketPtr packet, const RtpPacketInfo& info) {
             // Received Opus-encoded audio data from network
-            // Forward to AudioEngine's PlaybackCallback for decoding and playback
-            if (g_audioEngine && g_audioEngine->isPlaying()) {
-                g_audioEngine->enqueueReceivedAudio(data, size);
+            // Forward to AudioEngine's PlaybackCallback for jitter buffering and playback
+            HotPathGuard guard;
+            AudioEngine* engine = guard.engine();
+            if (engine && engine->isPlaying()) {
+                engine->enqueueReceivedAudio(std::move(packet), info);
             }
         });
 
+        // Receiver reports about our stream drive the encoder bitrate
+        g_packetizer->setRtcpConfig(g_rtcpConfig);
+        g_packetizer->setRedundancy(g_redundancyConfig);
+        g_packetizer->setRelayConfig(g_relayConfig);
+        g_packetizer->setReceiverReportCallback(
+            [](uint32_t reporterSsrc, float fractionLost, uint32_t jitterMs) {
+                HotPathGuard guard;
+                if (AudioEngine* engine = guard.engine()) {
+                    engine->onReceiverReport(reporterSsrc, fractionLost, jitterMs);
+                }
+            });
+
         // Start packetizer
         g_packetizer->start();
         g_packetizer->startReceiveLoop();
 
+        g_transportConfig = config;
+        publishHotEngine();
+
         __android_log_print(ANDROID_LOG_INFO, TAG,
             "PTT audio engine initialized successfully (mode=%s)",
             g_packetizer->getTransportMode() == TransportMode::MULTICAST ?
@@ -210,6 +590,20 @@ Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeStopPlayback(
     }
 }
 
+// Keep the capture stream running between presses (key-up without a stream start)
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetWarmStandby(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enable) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (g_audioEngine) {
+        g_audioEngine->setWarmStandby(enable == JNI_TRUE);
+    }
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeIsCapturing(
     JNIEnv* env,
@@ -258,16 +652,24 @@ Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeCleanup(
 
     __android_log_print(ANDROID_LOG_INFO, TAG, "Cleaning up native resources");
 
+    retireHotEngine();
+    g_egressEnabled.store(false);
+    releaseDirectBuffers(env);
+    g_floorControl->wakeWaiters();
+
     if (g_audioEngine) {
         g_audioEngine->stopCapture();
         g_audioEngine->stopPlayback();
-        g_audioEngine.reset();
     }
 
+    // Packetizer first: stop() joins the receive loop, whose callbacks and
+    // pool/power meter reach into the engine
     if (g_packetizer) {
         g_packetizer->stop();
         g_packetizer.reset();
     }
+    g_audioEngine.reset();
+    g_transportConfig = TransportConfig{};
 }
 
 // ============================================================================
@@ -293,148 +695,1341 @@ Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeAddUnicastPeer(
 }
 
 JNIEXPORT void JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeClearUnicastPeers(
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeRemoveUnicastPeer(
     JNIEnv* env,
-    jobject /* this */) {
+    jobject /* this */,
+    jstring peerAddress) {
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
 
-    if (g_packetizer) {
-        g_packetizer->clearUnicastPeers();
+    if (g_packetizer && peerAddress) {
+        const char* addr = env->GetStringUTFChars(peerAddress, nullptr);
+        if (addr) {
+            g_packetizer->removeUnicastPeer(addr);
+            env->ReleaseStringUTFChars(peerAddress, addr);
+        }
     }
 }
 
 JNIEXPORT jint JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetPacketsSent(
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativePruneUnicastPeers(
     JNIEnv* env,
-    jobject /* this */) {
+    jobject /* this */,
+    jint minConsecutiveFailures) {
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
 
     if (g_packetizer) {
-        return static_cast<jint>(g_packetizer->getPacketsSent());
+        const uint32_t threshold = minConsecutiveFailures > 0 ?
+            static_cast<uint32_t>(minConsecutiveFailures) : kPeerPruneFailureThreshold;
+        return static_cast<jint>(g_packetizer->pruneUnicastPeers(threshold));
     }
     return 0;
 }
 
-JNIEXPORT jint JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetPacketsReceived(
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeClearUnicastPeers(
     JNIEnv* env,
     jobject /* this */) {
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
 
     if (g_packetizer) {
-        return static_cast<jint>(g_packetizer->getPacketsReceived());
+        g_packetizer->clearUnicastPeers();
     }
-    return 0;
 }
 
+// ============================================================================
+// Scan Channel JNI Methods
+// ============================================================================
+
+// Receive another talkgroup on the running engine (no AudioEngine rebuild).
+// channelId is the caller's non-zero talkgroup id; priority orders the mix.
 JNIEXPORT jboolean JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeIsUsingMulticast(
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeJoinChannel(
     JNIEnv* env,
-    jobject /* this */) {
+    jobject /* this */,
+    jint channelId,
+    jstring multicastGroup,
+    jint port,
+    jint priority) {
+
+    if (channelId <= 0 || !multicastGroup || port <= 0 || port > 0xFFFF) {
+        return JNI_FALSE;
+    }
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (!g_packetizer || !g_audioEngine) {
+        return JNI_FALSE;
+    }
 
-    if (g_packetizer) {
-        return g_packetizer->getTransportMode() == TransportMode::MULTICAST ?
-            JNI_TRUE : JNI_FALSE;
+    const char* group = env->GetStringUTFChars(multicastGroup, nullptr);
+    if (!group) {
+        return JNI_FALSE;
     }
-    return JNI_FALSE;
-}
+    const uint32_t channel = static_cast<uint32_t>(channelId);
 
-// ============================================================================
-// Codec Configuration JNI Methods (NEW)
-// ============================================================================
+    // Priority first so the channel's first talker is mixed at the right level
+    g_audioEngine->setChannelPriority(channel, static_cast<uint8_t>(std::clamp(priority, 0, 255)));
+    const bool joined = g_packetizer->joinChannel(channel, group, static_cast<uint16_t>(port));
+    env->ReleaseStringUTFChars(multicastGroup, group);
 
-JNIEXPORT void JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetBitrate(
+    if (!joined) {
+        g_audioEngine->releaseChannel(channel);
+    }
+    return joined ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeLeaveChannel(
     JNIEnv* env,
     jobject /* this */,
-    jint bitrate) {
+    jint channelId) {
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (!g_packetizer || !g_audioEngine) {
+        return JNI_FALSE;
+    }
+
+    const uint32_t channel = static_cast<uint32_t>(channelId);
+    const bool left = g_packetizer->leaveChannel(channel);
 
-    // Bitrate will be applied on next encoder creation
-    __android_log_print(ANDROID_LOG_DEBUG, TAG,
-        "Setting bitrate to %d bps (will apply on next init)", bitrate);
+    // Talkers still in the jitter buffers stop at once
+    g_audioEngine->releaseChannel(channel);
+    return left ? JNI_TRUE : JNI_FALSE;
 }
 
+// Channel 0 is the home channel passed to nativeInitialize()
 JNIEXPORT void JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeEnableAEC(
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetChannelPriority(
     JNIEnv* env,
     jobject /* this */,
-    jboolean enable) {
+    jint channelId,
+    jint priority) {
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (g_audioEngine && channelId >= 0) {
+        g_audioEngine->setChannelPriority(static_cast<uint32_t>(channelId),
+                                          static_cast<uint8_t>(std::clamp(priority, 0, 255)));
+    }
+}
+
+// Linear gain for lower-priority channels while a higher one talks; 0 mutes them
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetDuckingGain(
+    JNIEnv* env,
+    jobject /* this */,
+    jfloat gain) {
 
+    std::lock_guard<std::mutex> lock(g_engineMutex);
     if (g_audioEngine) {
-        g_audioEngine->setSpeakerOutput(enable);
+        g_audioEngine->setDuckingGain(gain);
     }
 }
 
-// ============================================================================
-// Audio Receive JNI Methods (NEW)
-// ============================================================================
+// Channels with a talker right now (scan indicator). Returns the count written.
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetActiveChannels(
+    JNIEnv* env,
+    jobject /* this */,
+    jintArray out) {
+
+    if (!out) {
+        return 0;
+    }
+
+    uint32_t channels[kMaxReceiveStreams];
+    size_t count = 0;
+    {
+        HotPathGuard guard;
+        AudioEngine* engine = guard.engine();
+        if (!engine) {
+            return 0;
+        }
+        count = engine->getActiveChannels(channels, kMaxReceiveStreams);
+    }
+
+    count = std::min(count, static_cast<size_t>(env->GetArrayLength(out)));
+    jint values[kMaxReceiveStreams];
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<jint>(channels[i]);
+    }
+    env->SetIntArrayRegion(out, 0, static_cast<jsize>(count), values);
+    return static_cast<jint>(count);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetPacketsSent(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    HotPathGuard guard;
+    if (RtpPacketizer* packetizer = guard.packetizer()) {
+        return static_cast<jint>(packetizer->getPacketsSent());
+    }
+    return 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetPacketsReceived(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    HotPathGuard guard;
+    if (RtpPacketizer* packetizer = guard.packetizer()) {
+        return static_cast<jint>(packetizer->getPacketsReceived());
+    }
+    return 0;
+}
 
-/**
- * Enqueue received audio data from the network
- * This is called when RTP audio is received and needs to be played
- *
- * @param data Opus-encoded audio data (or PCM if Opus is disabled)
- * @param size Size of the audio data in bytes
- *
- * CRITICAL FIX: Added RAII for array release to prevent leak on exception
- */
 JNIEXPORT void JNICALL
-Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeEnqueueAudio(
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetLatencyTracing(
     JNIEnv* env,
     jobject /* this */,
-    jbyteArray data) {
+    jboolean enable,
+    jboolean atrace,
+    jboolean rtpExtension) {
 
     std::lock_guard<std::mutex> lock(g_engineMutex);
 
+    if (g_audioEngine) {
+        g_audioEngine->setLatencyTracing(enable == JNI_TRUE, atrace == JNI_TRUE);
+    }
+    // Sender stamps let the far end measure transit and mouth-to-ear
+    if (g_packetizer) {
+        g_packetizer->setLatencyExtension(enable == JNI_TRUE && rtpExtension == JNI_TRUE);
+    }
+}
+
+// Per-stage latency percentiles over the most recent traced frames.
+// Layout: version, txFrames, rxFrames, droppedTraces, inputDeviceUs,
+// outputDeviceUs, then kLatencyValuesPerStage values per LatencyStage.
+// Returns the number of values written, 0 when not initialized or out is too small.
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetLatencyStats(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out) {
+
+    if (!out || env->GetArrayLength(out) < static_cast<jsize>(kLatencyValueCount)) {
+        return 0;
+    }
+
+    // Device latency queries the streams; lifecycle lock, never held by audio threads
+    std::lock_guard<std::mutex> lock(g_engineMutex);
     if (!g_audioEngine) {
-        __android_log_print(ANDROID_LOG_WARN, TAG,
-            "Audio engine not initialized, cannot enqueue audio");
-        return;
+        return 0;
+    }
+    const AudioEngine::LatencyReport report = g_audioEngine->getLatencyReport();
+
+    jlong values[kLatencyValueCount];
+    size_t i = 0;
+    values[i++] = kLatencyLayoutVersion;
+    values[i++] = static_cast<jlong>(report.pipeline.txFrames);
+    values[i++] = static_cast<jlong>(report.pipeline.rxFrames);
+    values[i++] = static_cast<jlong>(report.pipeline.droppedTraces);
+    values[i++] = static_cast<jlong>(report.inputDeviceMs * 1000.0);
+    values[i++] = static_cast<jlong>(report.outputDeviceMs * 1000.0);
+    for (const LatencyPercentiles& stage : report.pipeline.stages) {
+        values[i++] = stage.samples;
+        values[i++] = stage.p50Micros;
+        values[i++] = stage.p95Micros;
+        values[i++] = stage.p99Micros;
+        values[i++] = stage.maxMicros;
     }
 
-    if (!data) {
-        __android_log_print(ANDROID_LOG_WARN, TAG, "Null audio data received");
-        return;
+    env->SetLongArrayRegion(out, 0, static_cast<jsize>(i), values);
+    return static_cast<jint>(i);
+}
+
+// Lab network impairment (NetworkImpairment.h); direction 0 = transmit,
+// 1 = receive. tracePath (nullable) replays a recorded link trace instead
+// of the loss/delay models. An all-zero profile without a trace clears it.
+// Returns false when not initialized or the trace cannot be loaded.
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetNetworkImpairment(
+    JNIEnv* env,
+    jobject /* this */,
+    jint direction,
+    jlong seed,
+    jfloat lossPercent,
+    jfloat burstEnterPercent,
+    jfloat burstExitPercent,
+    jfloat burstLossPercent,
+    jfloat duplicatePercent,
+    jfloat reorderPercent,
+    jint reorderDelayMs,
+    jint delayMs,
+    jint jitterMs,
+    jint jitterDistribution,
+    jstring tracePath) {
+
+    ImpairmentProfile profile;
+    profile.seed = static_cast<uint64_t>(seed);
+    profile.lossPercent = lossPercent;
+    profile.burstEnterPercent = burstEnterPercent;
+    profile.burstExitPercent = burstExitPercent;
+    profile.burstLossPercent = burstLossPercent;
+    profile.duplicatePercent = duplicatePercent;
+    profile.reorderPercent = reorderPercent;
+    profile.reorderDelayMs = static_cast<uint32_t>(std::max(0, reorderDelayMs));
+    profile.delayMs = static_cast<uint32_t>(std::max(0, delayMs));
+    profile.jitterMs = static_cast<uint32_t>(std::max(0, jitterMs));
+    profile.jitter = static_cast<JitterDistribution>(
+        std::clamp(jitterDistribution, 0, static_cast<jint>(JitterDistribution::PARETO)));
+
+    // Trace file is read before taking the lifecycle lock
+    auto impairment = std::make_unique<NetworkImpairment>(profile);
+    if (tracePath) {
+        const char* path = env->GetStringUTFChars(tracePath, nullptr);
+        if (!path) {
+            return JNI_FALSE;
+        }
+        const bool loaded = impairment->loadTrace(path);
+        env->ReleaseStringUTFChars(tracePath, path);
+        if (!loaded) {
+            return JNI_FALSE;
+        }
     }
 
-    jsize size = env->GetArrayLength(data);
-    if (size <= 0) {
-        return;
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (!g_packetizer) {
+        return JNI_FALSE;
     }
+    g_packetizer->setImpairment(direction == 0 ? ImpairmentDirection::TRANSMIT
+                                               : ImpairmentDirection::RECEIVE,
+                                std::move(impairment));
+    return JNI_TRUE;
+}
 
-    // CRITICAL FIX: Use RAII to ensure array is always released
-    jbyte* dataPtr = env->GetByteArrayElements(data, nullptr);
-    if (!dataPtr) {
-        __android_log_print(ANDROID_LOG_ERROR, TAG, "Failed to get audio data pointer");
-        return;
+// Impairment counters since the profile was set.
+// Layout: packets, dropped, duplicated, delayed, reordered, overflows.
+// Returns the number of values written, 0 when not initialized or out is too small.
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetImpairmentStats(
+    JNIEnv* env,
+    jobject /* this */,
+    jint direction,
+    jlongArray out) {
+
+    constexpr jsize kImpairmentValueCount = 6;
+    if (!out || env->GetArrayLength(out) < kImpairmentValueCount) {
+        return 0;
     }
 
-    // RAII wrapper to release array on scope exit
-    auto arrayReleaser = [env, data, &dataPtr]() {
-        if (dataPtr) {
-            env->ReleaseByteArrayElements(data, dataPtr, JNI_ABORT);
-        }
+    HotPathGuard guard;
+    RtpPacketizer* packetizer = guard.packetizer();
+    if (!packetizer) {
+        return 0;
+    }
+    const ImpairmentStats stats = packetizer->getImpairmentStats(
+        direction == 0 ? ImpairmentDirection::TRANSMIT : ImpairmentDirection::RECEIVE);
+
+    const jlong values[kImpairmentValueCount] = {
+        static_cast<jlong>(stats.packets),
+        static_cast<jlong>(stats.dropped),
+        static_cast<jlong>(stats.duplicated),
+        static_cast<jlong>(stats.delayed),
+        static_cast<jlong>(stats.reordered),
+        static_cast<jlong>(stats.overflows),
     };
+    env->SetLongArrayRegion(out, 0, kImpairmentValueCount, values);
+    return kImpairmentValueCount;
+}
+
+// RTCP mode (RtcpMode order: 0 off, 1 port + 1, 2 muxed), session bandwidth
+// for the report interval, minimum interval and XR RTT blocks. Kept across
+// re-initialize; applies immediately when running.
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetRtcp(
+    JNIEnv* env,
+    jobject /* this */,
+    jint mode,
+    jint sessionBandwidthBps,
+    jint minIntervalMs,
+    jboolean extendedReports) {
+
+    RtcpConfig config;
+    config.mode = static_cast<RtcpMode>(
+        std::clamp(mode, 0, static_cast<jint>(RtcpMode::MUX)));
+    config.sessionBandwidthBps = static_cast<uint32_t>(std::max(1, sessionBandwidthBps));
+    config.minIntervalMs = static_cast<uint32_t>(
+        std::max(static_cast<jint>(kRtcpMinIntervalFloorMs), minIntervalMs));
+    config.extendedReports = extendedReports == JNI_TRUE;
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    g_rtcpConfig = config;
+    if (g_packetizer) {
+        g_packetizer->setRtcpConfig(config);
+    }
+}
 
-    // Enqueue the audio data
-    g_audioEngine->enqueueReceivedAudio(
-        reinterpret_cast<const uint8_t*>(dataPtr),
-        static_cast<size_t>(size)
-    );
+// Redundant transmission (RedundancyMode order: 0 off, 1 RED, 2 delayed
+// duplicate), RED depth and largest frame repeated. Kept across
+// re-initialize; applies from the next frame when running.
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetRedundancy(
+    JNIEnv* env,
+    jobject /* this */,
+    jint mode,
+    jint depth,
+    jint maxFrameBytes) {
+
+    RedundancyConfig config;
+    config.mode = static_cast<RedundancyMode>(
+        std::clamp(mode, 0, static_cast<jint>(RedundancyMode::DUPLICATE)));
+    config.depth = static_cast<uint32_t>(
+        std::clamp(depth, 1, static_cast<jint>(kMaxRedundancyDepth)));
+    config.maxFrameBytes = static_cast<uint32_t>(
+        std::clamp(maxFrameBytes, 1, static_cast<jint>(kMaxRedundantFrameBytes)));
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    g_redundancyConfig = config;
+    if (g_packetizer) {
+        g_packetizer->setRedundancy(config);
+    }
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Redundancy mode %d, depth %u, max frame %u bytes",
+        static_cast<int>(config.mode), config.depth, config.maxFrameBytes);
+}
+
+// Multicast <-> unicast relay (RelayRole order: 0 off, 1 reflector, 2
+// member). reflectorAddress is the reflector's IPv4 address, used by a
+// member only. Kept across re-initialize. Returns false if a member's
+// reflector address does not parse.
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetRelay(
+    JNIEnv* env,
+    jobject /* this */,
+    jint role,
+    jstring reflectorAddress,
+    jint keepaliveMs,
+    jint memberTimeoutMs) {
+
+    RelayConfig config;
+    config.role = static_cast<RelayRole>(
+        std::clamp(role, 0, static_cast<jint>(RelayRole::MEMBER)));
+    config.keepaliveMs = static_cast<uint32_t>(std::max(keepaliveMs, 1));
+    config.memberTimeoutMs = static_cast<uint32_t>(std::max(memberTimeoutMs, 1));
+
+    if (config.role == RelayRole::MEMBER) {
+        const char* addr = reflectorAddress ? env->GetStringUTFChars(reflectorAddress, nullptr)
+                                            : nullptr;
+        if (!addr) {
+            return JNI_FALSE;
+        }
+        struct in_addr parsed;
+        const bool valid = inet_pton(AF_INET, addr, &parsed) == 1;
+        env->ReleaseStringUTFChars(reflectorAddress, addr);
+        if (!valid || parsed.s_addr == 0) {
+            __android_log_print(ANDROID_LOG_ERROR, TAG, "Invalid reflector address");
+            return JNI_FALSE;
+        }
+        config.reflectorAddress = parsed.s_addr;
+    }
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    g_relayConfig = config;
+    if (g_packetizer) {
+        g_packetizer->setRelayConfig(config);
+    }
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Relay role %d, keepalive %u ms, timeout %u ms",
+        static_cast<int>(config.role), config.keepaliveMs, config.memberTimeoutMs);
+    return JNI_TRUE;
+}
+
+// Reflector member table.
+// Layout: version, count, then per member: IPv4 (network order), ssrc,
+// datagrams in, datagrams forwarded, bytes forwarded, send failures, age ms.
+// Returns values written, 0 when not initialized.
+constexpr jsize kRelayMembersLayoutVersion = 1;
+constexpr jsize kRelayMemberEntryValues = 7;
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetRelayMembers(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out) {
+
+    const jsize capacity = out ? env->GetArrayLength(out) : 0;
+    if (capacity < 2) {
+        return 0;
+    }
+
+    HotPathGuard guard;
+    RtpPacketizer* packetizer = guard.packetizer();
+    if (!packetizer) {
+        return 0;
+    }
+
+    RelayMemberInfo members[kMaxRelayMembers];
+    const size_t maxEntries = std::min<size_t>(kMaxRelayMembers,
+        static_cast<size_t>(capacity - 2) / kRelayMemberEntryValues);
+    const size_t count = packetizer->getRelayMembers(members, maxEntries);
+
+    jlong values[2 + kMaxRelayMembers * kRelayMemberEntryValues];
+    jsize n = 0;
+    values[n++] = kRelayMembersLayoutVersion;
+    values[n++] = static_cast<jlong>(count);
+    for (size_t i = 0; i < count; ++i) {
+        const RelayMemberInfo& member = members[i];
+        values[n++] = static_cast<jlong>(member.address);
+        values[n++] = static_cast<jlong>(member.ssrc);
+        values[n++] = static_cast<jlong>(member.packetsIn);
+        values[n++] = static_cast<jlong>(member.packetsForwarded);
+        values[n++] = static_cast<jlong>(member.bytesForwarded);
+        values[n++] = static_cast<jlong>(member.sendFailures);
+        values[n++] = member.ageMs;
+    }
+    env->SetLongArrayRegion(out, 0, n, values);
+    return n;
+}
+
+// Per-peer link quality from RTCP.
+// Layout: version, count, then per member: ssrc, IPv4 (network order, 0 if
+// unknown), packets received, cumulative lost, fraction lost (ppm), jitter ms,
+// remote fraction lost (ppm, -1 without a report), remote jitter ms (-1),
+// RTT ms (-1), age ms. Returns values written, 0 when not initialized.
+constexpr jsize kLinkQualityLayoutVersion = 1;
+constexpr jsize kLinkQualityEntryValues = 10;
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetLinkQuality(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out) {
+
+    const jsize capacity = out ? env->GetArrayLength(out) : 0;
+    if (capacity < 2) {
+        return 0;
+    }
+
+    HotPathGuard guard;
+    RtpPacketizer* packetizer = guard.packetizer();
+    if (!packetizer) {
+        return 0;
+    }
+
+    LinkQuality links[kMaxRtcpSources];
+    const size_t maxEntries = std::min<size_t>(kMaxRtcpSources,
+        static_cast<size_t>(capacity - 2) / kLinkQualityEntryValues);
+    const size_t count = packetizer->getLinkQuality(links, maxEntries);
+
+    jlong values[2 + kMaxRtcpSources * kLinkQualityEntryValues];
+    jsize n = 0;
+    values[n++] = kLinkQualityLayoutVersion;
+    values[n++] = static_cast<jlong>(count);
+    for (size_t i = 0; i < count; ++i) {
+        const LinkQuality& link = links[i];
+        values[n++] = static_cast<jlong>(link.ssrc);
+        values[n++] = static_cast<jlong>(link.address);
+        values[n++] = static_cast<jlong>(link.packetsReceived);
+        values[n++] = link.cumulativeLost;
+        values[n++] = static_cast<jlong>(link.fractionLost * 1e6f);
+        values[n++] = link.jitterMs;
+        values[n++] = link.hasRemoteReport ? static_cast<jlong>(link.remoteFractionLost * 1e6f) : -1;
+        values[n++] = link.hasRemoteReport ? static_cast<jlong>(link.remoteJitterMs) : -1;
+        values[n++] = link.rttMs;
+        values[n++] = link.ageMs;
+    }
+    env->SetLongArrayRegion(out, 0, n, values);
+    return n;
+}
+
+// Whole-pipeline counters in one call (layout: flattenTelemetry).
+// Lock-free: safe to poll at 1 Hz without touching the audio threads.
+// Returns the number of values written, 0 when not initialized or out is too small.
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetTelemetry(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out) {
+
+    if (!out || env->GetArrayLength(out) < static_cast<jsize>(kTelemetryValueCount)) {
+        return 0;
+    }
+
+    TelemetrySnapshot snapshot;
+    {
+        HotPathGuard guard;
+        AudioEngine* engine = guard.engine();
+        RtpPacketizer* packetizer = guard.packetizer();
+        if (!engine || !packetizer) {
+            return 0;
+        }
+        engine->getTelemetry(snapshot);
+        packetizer->getTelemetry(snapshot);
+    }
+
+    jlong values[kTelemetryValueCount];
+    const size_t count = flattenTelemetry(snapshot, values);
+    env->SetLongArrayRegion(out, 0, static_cast<jsize>(count), values);
+    return static_cast<jint>(count);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeIsUsingMulticast(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (g_packetizer) {
+        return g_packetizer->getTransportMode() == TransportMode::MULTICAST ?
+            JNI_TRUE : JNI_FALSE;
+    }
+    return JNI_FALSE;
+}
+
+// ============================================================================
+// Codec Configuration JNI Methods (NEW)
+// ============================================================================
+
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetBitrate(
+    JNIEnv* env,
+    jobject /* this */,
+    jint bitrate) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    // Manual knob caps the adaptive controller rather than fixing the rate
+    if (g_audioEngine) {
+        g_audioEngine->setBitrateCeiling(bitrate);
+        __android_log_print(ANDROID_LOG_DEBUG, TAG,
+            "Bitrate ceiling set to %d bps", bitrate);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetAdaptiveBitrate(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enable) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (g_audioEngine) {
+        g_audioEngine->setAdaptiveBitrate(enable == JNI_TRUE);
+    }
+}
+
+// Silence suppression on transmit; comfortNoiseIntervalMs 0 sends nothing in silence
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetDtx(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enable,
+    jint hangoverMs,
+    jint comfortNoiseIntervalMs,
+    jfloat thresholdDb) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (g_audioEngine) {
+        DtxConfig config;
+        config.enabled = enable == JNI_TRUE;
+        config.hangoverMs = static_cast<uint32_t>(std::max(0, hangoverMs));
+        config.comfortNoiseIntervalMs = static_cast<uint32_t>(std::max(0, comfortNoiseIntervalMs));
+        config.thresholdDb = thresholdDb;
+        g_audioEngine->setDtxConfig(config);
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "DTX gate %s (hangover %u ms, comfort noise every %u ms, threshold %.1f dB)",
+            config.enabled ? "on" : "off", config.hangoverMs,
+            config.comfortNoiseIntervalMs, config.thresholdDb);
+    }
+}
+
+// Playback after idleAfterMs of silence: 0 = keep, 1 = power-saving stream, 2 = stop
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetPowerConfig(
+    JNIEnv* env,
+    jobject /* this */,
+    jint idlePlayback,
+    jint idleAfterMs) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (g_audioEngine) {
+        PowerConfig config;
+        config.idlePlayback = static_cast<IdlePlayback>(
+            std::clamp(idlePlayback, 0, static_cast<jint>(IdlePlayback::STOP)));
+        config.idleAfterMs = static_cast<uint32_t>(std::max(0, idleAfterMs));
+        g_audioEngine->setPowerConfig(config);
+    }
+}
+
+// sync: 0 = none, 1 = fdatasync per burst, 2 = O_DIRECT + fdatasync
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeStartRecording(
+    JNIEnv* env,
+    jobject /* this */,
+    jstring directory,
+    jint sync,
+    jint burstGapMs) {
+
+    const char* dir = directory ? env->GetStringUTFChars(directory, nullptr) : nullptr;
+    if (!dir) {
+        return JNI_FALSE;
+    }
+    RecordingConfig config;
+    config.directory = dir;
+    env->ReleaseStringUTFChars(directory, dir);
+    config.sync = static_cast<RecordingSync>(
+        std::clamp(sync, 0, static_cast<jint>(RecordingSync::DIRECT)));
+    config.burstGapMs = static_cast<uint32_t>(std::max(burstGapMs, 0));
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (!g_audioEngine) {
+        return JNI_FALSE;
+    }
+    return g_audioEngine->startRecording(config) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeStopRecording(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (g_audioEngine) {
+        g_audioEngine->stopRecording();
+    }
+}
+
+// role: ThreadRole; sched: 0 = default, 1 = nice, 2 = SCHED_FIFO (else nice).
+// cpuMask bit n pins to CPU n, 0 unpins. Applies to a running thread at once.
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetThreadPolicy(
+    JNIEnv* env,
+    jobject /* this */,
+    jint role,
+    jint sched,
+    jint nice,
+    jint fifoPriority,
+    jlong cpuMask) {
+
+    if (role < 0 || role >= static_cast<jint>(kThreadRoleCount)) {
+        return;
+    }
+    ThreadPolicy policy;
+    policy.sched = static_cast<ThreadSched>(
+        std::clamp(sched, 0, static_cast<jint>(ThreadSched::FIFO)));
+    policy.nice = std::clamp(nice, -20, 19);
+    policy.fifoPriority = std::clamp(fifoPriority, 1, 99);
+    policy.cpuMask = static_cast<uint64_t>(cpuMask);
+    g_threadManager->setPolicy(static_cast<ThreadRole>(role), policy);
+}
+
+// Cores above the little cluster (all on a uniform SoC), 0 if unknown
+JNIEXPORT jlong JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativePerformanceCoreMask(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    return static_cast<jlong>(ThreadManager::performanceCoreMask());
+}
+
+// Worker threads.
+// Layout: version, count, then per role: role, tid (0 = not running),
+// applied sched, nice, fifo priority, cpu mask, wake samples, over budget,
+// max us, total us, histogram (kWakeLatencyBuckets).
+// Returns values written, 0 if out is too small for the header.
+constexpr jsize kThreadStatsLayoutVersion = 1;
+constexpr jsize kThreadEntryValues = 10 + static_cast<jsize>(kWakeLatencyBuckets);
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetThreadStats(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out) {
+
+    const jsize capacity = out ? env->GetArrayLength(out) : 0;
+    if (capacity < 2) {
+        return 0;
+    }
+
+    ThreadInfo threads[kThreadRoleCount];
+    const size_t maxEntries = std::min<size_t>(kThreadRoleCount,
+        static_cast<size_t>(capacity - 2) / kThreadEntryValues);
+    const size_t count = g_threadManager->getThreadInfo(threads, maxEntries);
+
+    jlong values[2 + kThreadRoleCount * kThreadEntryValues];
+    jsize n = 0;
+    values[n++] = kThreadStatsLayoutVersion;
+    values[n++] = static_cast<jlong>(count);
+    for (size_t i = 0; i < count; ++i) {
+        const ThreadInfo& thread = threads[i];
+        values[n++] = static_cast<jlong>(thread.role);
+        values[n++] = thread.tid;
+        values[n++] = static_cast<jlong>(thread.applied);
+        values[n++] = thread.nice;
+        values[n++] = thread.fifoPriority;
+        values[n++] = static_cast<jlong>(thread.cpuMask);
+        values[n++] = static_cast<jlong>(thread.wakeSamples);
+        values[n++] = static_cast<jlong>(thread.overBudget);
+        values[n++] = static_cast<jlong>(thread.maxMicros);
+        values[n++] = static_cast<jlong>(thread.totalMicros);
+        for (size_t b = 0; b < kWakeLatencyBuckets; ++b) {
+            values[n++] = static_cast<jlong>(thread.histogram[b]);
+        }
+    }
+    env->SetLongArrayRegion(out, 0, n, values);
+    return n;
+}
+
+// Bytes for receive streams, decoders and packet buffers, reserved once when
+// the engine is created; a running engine keeps its reservation until
+// cleanup. A budget below one stream makes that initialize fail.
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetMemoryBudget(
+    JNIEnv* env,
+    jobject /* this */,
+    jlong bytes) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    g_memoryBudgetBytes = static_cast<size_t>(std::max<jlong>(0, bytes));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetAudioDsp(
+    JNIEnv* env,
+    jobject /* this */,
+    jint direction,
+    jboolean highPass,
+    jfloat highPassHz,
+    jboolean agc,
+    jfloat agcTargetDbfs,
+    jfloat agcMaxGainDb,
+    jboolean limiter,
+    jfloat limiterThresholdDbfs) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (!g_audioEngine) {
+        return JNI_FALSE;
+    }
+
+    DspConfig config;
+    config.highPass = highPass == JNI_TRUE;
+    config.highPassHz = highPassHz;
+    config.agc = agc == JNI_TRUE;
+    config.agcTargetDbfs = agcTargetDbfs;
+    config.agcMaxGainDb = agcMaxGainDb;
+    config.limiter = limiter == JNI_TRUE;
+    config.limiterThresholdDbfs = limiterThresholdDbfs;
+
+    // 0 = capture (before encode), 1 = playback (after the mix)
+    if (direction == 0) {
+        g_audioEngine->setCaptureDsp(config);
+    } else {
+        g_audioEngine->setPlaybackDsp(config);
+    }
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "%s DSP: high-pass %s (%.0f Hz), AGC %s (%.1f dBFS, +%.1f dB max), limiter %s (%.1f dBFS)",
+        direction == 0 ? "Capture" : "Playback",
+        config.highPass ? "on" : "off", config.highPassHz,
+        config.agc ? "on" : "off", config.agcTargetDbfs, config.agcMaxGainDb,
+        config.limiter ? "on" : "off", config.limiterThresholdDbfs);
+    return JNI_TRUE;
+}
+
+/**
+ * Install the SRTP master key/salt exported from an MLS epoch. Works with or
+ * without a running engine; an epoch at or below the installed one is
+ * refused. The JNI copies are wiped before returning.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetSrtpKey(
+    JNIEnv* env,
+    jobject /* this */,
+    jlong epoch,
+    jbyteArray masterKey,
+    jbyteArray masterSalt) {
+
+    if (!masterKey || !masterSalt || epoch < 0) {
+        return JNI_FALSE;
+    }
+    const jsize keyBytes = env->GetArrayLength(masterKey);
+    const jsize saltBytes = env->GetArrayLength(masterSalt);
+    if ((keyBytes != static_cast<jsize>(kAes128KeyBytes) &&
+         keyBytes != static_cast<jsize>(kAes256KeyBytes)) ||
+        saltBytes != static_cast<jsize>(kSrtpMasterSaltBytes)) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "SRTP key rejected: %d-byte key, %d-byte salt", keyBytes, saltBytes);
+        return JNI_FALSE;
+    }
+
+    uint8_t key[kAes256KeyBytes];
+    uint8_t salt[kSrtpMasterSaltBytes];
+    env->GetByteArrayRegion(masterKey, 0, keyBytes, reinterpret_cast<jbyte*>(key));
+    env->GetByteArrayRegion(masterSalt, 0, saltBytes, reinterpret_cast<jbyte*>(salt));
+
+    const bool installed = g_srtpSession->setMasterKey(
+        static_cast<uint64_t>(epoch), key, static_cast<size_t>(keyBytes),
+        salt, sizeof(salt), traceClockMicros());
+
+    secureZero(key, sizeof(key));
+    secureZero(salt, sizeof(salt));
+    return installed ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeClearSrtp(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    g_srtpSession->clear();
+}
+
+// ============================================================================
+// Floor Control JNI Methods
+// ============================================================================
+
+// Enable native arbitration (FloorControl.h). While enabled nothing is sent
+// without the floor; disabled, capture is never gated. Kept across
+// re-initialize.
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetFloorControl(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enabled,
+    jint requestTimeoutMs,
+    jint retryIntervalMs,
+    jint takenRefreshMs,
+    jint holderTimeoutMs) {
+
+    FloorConfig config;
+    config.enabled = enabled == JNI_TRUE;
+    config.requestTimeoutMs = static_cast<uint32_t>(std::max(0, requestTimeoutMs));
+    config.retryIntervalMs = static_cast<uint32_t>(std::max(0, retryIntervalMs));
+    config.takenRefreshMs = static_cast<uint32_t>(std::max(0, takenRefreshMs));
+    config.holderTimeoutMs = static_cast<uint32_t>(
+        std::max(holderTimeoutMs, takenRefreshMs * 2));
+    g_floorControl->configure(config);
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Floor control %s (request window %u ms, retry %u ms, holder timeout %u ms)",
+        config.enabled ? "on" : "off", config.requestTimeoutMs,
+        config.retryIntervalMs, config.holderTimeoutMs);
+}
+
+// PTT press: arbitrate, then start capture on a grant. Blocks (without
+// g_engineMutex) up to timeoutMs for a pending request; one still pending
+// then is cancelled. Returns the FloorState (2 = granted and capturing),
+// -1 when not initialized or capture failed.
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeRequestFloor(
+    JNIEnv* env,
+    jobject /* this */,
+    jint priority,
+    jboolean emergency,
+    jint timeoutMs) {
+
+    FloorState state;
+    {
+        std::lock_guard<std::mutex> lock(g_engineMutex);
+        if (!g_audioEngine || !g_packetizer) {
+            return -1;
+        }
+        state = g_packetizer->requestFloor(static_cast<uint8_t>(std::clamp(priority, 0, 255)),
+                                           emergency == JNI_TRUE);
+    }
+
+    if (state == FloorState::PENDING) {
+        state = g_floorControl->awaitDecision(timeoutMs);
+    }
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (!g_audioEngine || !g_packetizer) {
+        return -1;
+    }
+    if (state == FloorState::PENDING) {
+        g_packetizer->releaseFloor();
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Floor request still pending after %d ms, cancelled", timeoutMs);
+        return static_cast<jint>(g_floorControl->getState());
+    }
+    if (state != FloorState::GRANTED) {
+        return static_cast<jint>(state);
+    }
+
+    // Revoked between the decision and here: mayTransmit() already false
+    if (!g_floorControl->mayTransmit()) {
+        return static_cast<jint>(g_floorControl->getState());
+    }
+    if (!g_audioEngine->startCapture()) {
+        g_packetizer->releaseFloor();
+        return -1;
+    }
+    return static_cast<jint>(FloorState::GRANTED);
+}
+
+// PTT release: stop capture (flushing the tail while we still hold the
+// floor), then release it
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeReleaseFloor(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (g_audioEngine) {
+        g_audioEngine->stopCapture();
+    }
+    if (g_packetizer) {
+        g_packetizer->releaseFloor();
+    }
+}
+
+// Floor decisions for Kotlin. Blocks up to timeoutMs (returns early on
+// cleanup); each event is kFloorEventValues longs: FloorEventType, ssrc,
+// priority | emergency << 8, traceClockMicros(). A revoke stops capture
+// here, on the caller's thread. Returns the number of events written.
+constexpr jsize kFloorEventValues = 4;
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeAwaitFloorEvents(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out,
+    jint timeoutMs) {
+
+    const jsize capacity = out ? env->GetArrayLength(out) / kFloorEventValues : 0;
+    if (capacity <= 0) {
+        return 0;
+    }
+
+    FloorEvent events[kFloorEventQueueSize];
+    const size_t count = g_floorControl->waitEvents(
+        events, std::min<size_t>(kFloorEventQueueSize, static_cast<size_t>(capacity)), timeoutMs);
+
+    jlong values[kFloorEventQueueSize * kFloorEventValues];
+    bool revoked = false;
+    for (size_t i = 0; i < count; ++i) {
+        const FloorEvent& event = events[i];
+        values[i * kFloorEventValues] = static_cast<jlong>(event.type);
+        values[i * kFloorEventValues + 1] = static_cast<jlong>(event.ssrc);
+        values[i * kFloorEventValues + 2] = event.priority | (event.emergency ? 0x100 : 0);
+        values[i * kFloorEventValues + 3] = event.timeMicros;
+        revoked |= event.type == FloorEventType::REVOKED;
+    }
+
+    // Preempted: frames are already dropped by the packetizer gate
+    if (revoked) {
+        std::lock_guard<std::mutex> lock(g_engineMutex);
+        if (g_audioEngine && !g_floorControl->mayTransmit()) {
+            g_audioEngine->stopCapture();
+            __android_log_print(ANDROID_LOG_INFO, TAG, "Floor revoked, capture stopped");
+        }
+    }
+
+    env->SetLongArrayRegion(out, 0, static_cast<jsize>(count * kFloorEventValues), values);
+    return static_cast<jint>(count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeEnableAEC(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enable) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    g_audioRoute.echoCancel = enable == JNI_TRUE;
+    if (g_audioEngine) {
+        g_audioEngine->setSpeakerOutput(enable);
+    }
+}
+
+// AudioDeviceInfo ids (0 = the system's choice) and capture AEC. Kept across
+// re-initialize; a running engine reopens the affected streams on its
+// stream worker, sessions intact.
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetAudioRoute(
+    JNIEnv* env,
+    jobject /* this */,
+    jint inputDeviceId,
+    jint outputDeviceId,
+    jboolean echoCancel) {
+
+    AudioRoute route;
+    route.inputDeviceId = std::max(0, inputDeviceId);
+    route.outputDeviceId = std::max(0, outputDeviceId);
+    route.echoCancel = echoCancel == JNI_TRUE;
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    g_audioRoute = route;
+    if (g_audioEngine) {
+        g_audioEngine->setRoute(route);
+    }
+}
+
+// Codec profile (kCodecProfiles index) of a joined channel or kHomeChannel.
+// Switchable at runtime; forgotten when the channel is left or the engine
+// cleaned up. False before initialize or for an unknown profile.
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetCodecProfile(
+    JNIEnv* env,
+    jobject /* this */,
+    jint channelId,
+    jint profile) {
+
+    if (channelId < 0 || profile < 0) {
+        return JNI_FALSE;
+    }
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (!g_audioEngine) {
+        return JNI_FALSE;
+    }
+    return g_audioEngine->setCodecProfile(static_cast<uint32_t>(channelId),
+                                          static_cast<size_t>(profile)) ? JNI_TRUE : JNI_FALSE;
+}
+
+// Call quality per codec profile, in kCodecProfiles order.
+// Layout: version, count, then per profile: streams scored, frames scored,
+// frames lost, frames recovered, mean MOS x1000, min MOS x1000,
+// mean R x1000, mean delay us, streams with measured delay, tx sessions,
+// tx frames, tx packets, tx bytes, tx ms.
+// Returns values written, 0 when not initialized or out is too small.
+constexpr jsize kProfileResultsLayoutVersion = 1;
+constexpr jsize kProfileEntryValues = 14;
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetProfileResults(
+    JNIEnv* env,
+    jobject /* this */,
+    jlongArray out) {
+
+    const jsize capacity = out ? env->GetArrayLength(out) : 0;
+    if (capacity < 2) {
+        return 0;
+    }
+
+    std::array<ProfileQuality, kCodecProfileCount> results;
+    {
+        std::lock_guard<std::mutex> lock(g_engineMutex);
+        if (!g_audioEngine) {
+            return 0;
+        }
+        results = g_audioEngine->getProfileResults();
+    }
+
+    const size_t count = std::min<size_t>(kCodecProfileCount,
+        static_cast<size_t>(capacity - 2) / kProfileEntryValues);
+
+    jlong values[2 + kCodecProfileCount * kProfileEntryValues];
+    jsize n = 0;
+    values[n++] = kProfileResultsLayoutVersion;
+    values[n++] = static_cast<jlong>(count);
+    for (size_t i = 0; i < count; ++i) {
+        const ProfileQuality& q = results[i];
+        values[n++] = static_cast<jlong>(q.streamsScored);
+        values[n++] = static_cast<jlong>(q.framesScored);
+        values[n++] = static_cast<jlong>(q.framesLost);
+        values[n++] = static_cast<jlong>(q.framesRecovered);
+        values[n++] = static_cast<jlong>(q.meanMos * 1000.0 + 0.5);
+        values[n++] = static_cast<jlong>(q.minMos * 1000.0 + 0.5);
+        values[n++] = static_cast<jlong>(q.meanRFactor * 1000.0 + 0.5);
+        values[n++] = static_cast<jlong>(q.meanDelayMs * 1000.0 + 0.5);
+        values[n++] = static_cast<jlong>(q.measuredStreams);
+        values[n++] = static_cast<jlong>(q.txSessions);
+        values[n++] = static_cast<jlong>(q.txFrames);
+        values[n++] = static_cast<jlong>(q.txPackets);
+        values[n++] = static_cast<jlong>(q.txBytes);
+        values[n++] = static_cast<jlong>(q.txMillis);
+    }
+    env->SetLongArrayRegion(out, 0, n, values);
+    return n;
+}
+
+// Clear the per-profile results (start of an A/B run)
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeResetProfileResults(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+    if (g_audioEngine) {
+        g_audioEngine->resetProfileResults();
+    }
+}
+
+// ============================================================================
+// Audio Receive JNI Methods (NEW)
+// ============================================================================
+
+/**
+ * Enqueue received audio data from the network
+ * This is called when RTP audio is received and needs to be played
+ *
+ * @param data Opus-encoded audio data (or PCM if Opus is disabled)
+ * @param size Size of the audio data in bytes
+ *
+ * CRITICAL FIX: Added RAII for array release to prevent leak on exception
+ */
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeEnqueueAudio(
+    JNIEnv* env,
+    jobject /* this */,
+    jbyteArray data) {
+
+    HotPathGuard guard;
+    AudioEngine* engine = guard.engine();
+
+    if (!engine) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Audio engine not initialized, cannot enqueue audio");
+        return;
+    }
+
+    if (!data) {
+        __android_log_print(ANDROID_LOG_WARN, TAG, "Null audio data received");
+        return;
+    }
+
+    jsize size = env->GetArrayLength(data);
+    if (size <= 0 || static_cast<size_t>(size) > kPooledPacketCapacity) {
+        return;
+    }
+
+    // Bounded region copy: no pinning, nothing to release on any path
+    uint8_t payload[kPooledPacketCapacity];
+    env->GetByteArrayRegion(data, 0, size, reinterpret_cast<jbyte*>(payload));
+
+    engine->enqueueReceivedAudio(payload, static_cast<size_t>(size));
+}
+
+// ============================================================================
+// Direct ByteBuffer Batch Audio Path
+// ============================================================================
+
+JNIEXPORT jboolean JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeRegisterAudioBuffers(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject ingressBuffer,
+    jobject egressBuffer) {
+
+    std::lock_guard<std::mutex> lock(g_engineMutex);
+
+    if (!g_audioEngine) {
+        return JNI_FALSE;
+    }
+
+    void* ingress = ingressBuffer ? env->GetDirectBufferAddress(ingressBuffer) : nullptr;
+    void* egress = egressBuffer ? env->GetDirectBufferAddress(egressBuffer) : nullptr;
+    if (!ingress || !egress) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Audio buffers must be direct ByteBuffers");
+        return JNI_FALSE;
+    }
+
+    // The drain copies whole records, so egress must hold the largest one
+    constexpr size_t kMinEgressBytes = kAudioRecordHeaderBytes + OPUS_MAX_PACKET_SIZE;
+    const jlong egressBytes = env->GetDirectBufferCapacity(egressBuffer);
+    if (egressBytes < static_cast<jlong>(kMinEgressBytes)) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Egress buffer too small: %lld < %zu bytes",
+            static_cast<long long>(egressBytes), kMinEgressBytes);
+        return JNI_FALSE;
+    }
+
+    // Swap buffers with no hot-path call in flight
+    retireHotEngine();
+    releaseDirectBuffers(env);
+
+    g_directBuffers.ingressRef = env->NewGlobalRef(ingressBuffer);
+    g_directBuffers.ingress = static_cast<uint8_t*>(ingress);
+    g_directBuffers.ingressCapacity = static_cast<size_t>(env->GetDirectBufferCapacity(ingressBuffer));
+    g_directBuffers.egressRef = env->NewGlobalRef(egressBuffer);
+    g_directBuffers.egress = static_cast<uint8_t*>(egress);
+    g_directBuffers.egressCapacity = static_cast<size_t>(egressBytes);
+
+    publishHotEngine();
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Direct audio buffers registered: ingress=%zu egress=%zu bytes",
+        g_directBuffers.ingressCapacity, g_directBuffers.egressCapacity);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSubmitIngress(
+    JNIEnv* env,
+    jobject /* this */,
+    jint byteCount) {
+
+    HotPathGuard guard;
+    AudioEngine* engine = guard.engine();
+    if (!engine || !g_directBuffers.ingress || byteCount <= 0) {
+        return 0;
+    }
+
+    const uint8_t* cursor = g_directBuffers.ingress;
+    const uint8_t* end = cursor + std::min(static_cast<size_t>(byteCount),
+                                           g_directBuffers.ingressCapacity);
+    jint accepted = 0;
+
+    while (static_cast<size_t>(end - cursor) >= kAudioRecordHeaderBytes) {
+        uint16_t length;
+        std::memcpy(&length, cursor, kAudioRecordHeaderBytes);
+        cursor += kAudioRecordHeaderBytes;
+
+        if (length == 0 || length > static_cast<size_t>(end - cursor)) {
+            break;  // Truncated or corrupt batch
+        }
+
+        engine->enqueueReceivedAudio(cursor, length);
+        cursor += length;
+        accepted++;
+    }
+
+    return accepted;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeDrainEgress(
+    JNIEnv* env,
+    jobject /* this */) {
+
+    HotPathGuard guard;
+    if (!guard.engine() || !g_directBuffers.egress) {
+        return 0;
+    }
+
+    // Copy whole records only; a record that doesn't fit waits for the next drain
+    size_t written = 0;
+    while (g_egressRing.availableToRead() >= kAudioRecordHeaderBytes) {
+        uint16_t length;
+        g_egressRing.peek(reinterpret_cast<uint8_t*>(&length), kAudioRecordHeaderBytes);
+
+        const size_t recordSize = kAudioRecordHeaderBytes + length;
+        if (written + recordSize > g_directBuffers.egressCapacity) {
+            break;
+        }
+        written += g_egressRing.read(g_directBuffers.egress + written, recordSize);
+    }
+
+    return static_cast<jint>(written);
+}
+
+JNIEXPORT void JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeSetEgressEnabled(
+    JNIEnv* env,
+    jobject /* this */,
+    jboolean enabled) {
+
+    g_egressEnabled.store(enabled == JNI_TRUE);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_doodlelabs_meshriderwave_ptt_PttAudioEngine_nativeGetEgressDropped(
+    JNIEnv* env,
+    jobject /* this */) {
 
-    // CRITICAL FIX: Array will be released automatically when lambda goes out of scope
-    // But we release explicitly here for clarity
-    arrayReleaser();
-    dataPtr = nullptr;
+    return static_cast<jlong>(g_egressDropped.load(std::memory_order_relaxed));
 }
 
 } // extern "C"
@@ -0,0 +1,183 @@
+/*
+ * Mesh Rider Wave - End-to-End Latency Tracer Implementation
+ */
+
+#include "LatencyTracer.h"
+#include "PttLog.h"
+#include <dlfcn.h>
+#include <algorithm>
+
+#define TAG "MeshRider:PTT-Latency"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// ATrace_setCounter is API 29; minSdk is 26, so resolve it at runtime
+using ATraceIsEnabledFn = bool (*)();
+using ATraceSetCounterFn = void (*)(const char*, int64_t);
+
+struct ATraceApi {
+    ATraceIsEnabledFn isEnabled = nullptr;
+    ATraceSetCounterFn setCounter = nullptr;
+};
+
+const ATraceApi& atraceApi() {
+    static const ATraceApi api = []() {
+        ATraceApi resolved;
+        if (void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL)) {
+            resolved.isEnabled = reinterpret_cast<ATraceIsEnabledFn>(dlsym(lib, "ATrace_isEnabled"));
+            resolved.setCounter = reinterpret_cast<ATraceSetCounterFn>(dlsym(lib, "ATrace_setCounter"));
+        }
+        return resolved;
+    }();
+    return api;
+}
+
+constexpr std::array<const char*, kLatencyStageCount> kStageCounterNames = {
+    "ptt.latency.capture_to_encode_us",
+    "ptt.latency.encode_to_send_us",
+    "ptt.latency.network_transit_us",
+    "ptt.latency.jitter_buffer_us",
+    "ptt.latency.decode_us",
+    "ptt.latency.playout_queue_us",
+    "ptt.latency.mouth_to_ear_us",
+};
+
+// Nearest-rank percentile of an ascending sorted window
+uint32_t percentile(const uint32_t* sorted, size_t count, uint32_t pct) {
+    const size_t rank = (count * pct + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+} // namespace
+
+LatencyTracer::LatencyTracer() = default;
+
+void LatencyTracer::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Latency tracing %s", enabled ? "enabled" : "disabled");
+}
+
+void LatencyTracer::setAtraceEnabled(bool enabled) {
+    if (enabled && !atraceApi().setCounter) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "ATrace counters unavailable (API < 29)");
+        enabled = false;
+    }
+    atraceEnabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyTracer::recordTx(const TxFrameTrace& trace) {
+    if (txRing_.write(&trace, 1) == 0) {
+        droppedTraces_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (atraceEnabled_.load(std::memory_order_relaxed)) {
+        emitCounter(LatencyStage::CAPTURE_TO_ENCODE, trace.encodeMicros - trace.captureMicros);
+        emitCounter(LatencyStage::ENCODE_TO_SEND, trace.sendMicros - trace.encodeMicros);
+    }
+}
+
+void LatencyTracer::recordRx(const RxFrameTrace& trace) {
+    if (rxRing_.write(&trace, 1) == 0) {
+        droppedTraces_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (atraceEnabled_.load(std::memory_order_relaxed)) {
+        emitCounter(LatencyStage::JITTER_BUFFER, trace.dequeueMicros - trace.receiveMicros);
+        emitCounter(LatencyStage::DECODE, trace.decodeMicros - trace.dequeueMicros);
+        emitCounter(LatencyStage::PLAYOUT_QUEUE, trace.renderMicros - trace.decodeMicros);
+        if (trace.hasSenderStamps) {
+            emitCounter(LatencyStage::NETWORK_TRANSIT, trace.transitMicros);
+            emitCounter(LatencyStage::MOUTH_TO_EAR,
+                        static_cast<int64_t>(trace.senderCaptureToSendMicros) +
+                        trace.transitMicros + (trace.renderMicros - trace.receiveMicros));
+        }
+    }
+}
+
+void LatencyTracer::emitCounter(LatencyStage stage, int64_t micros) const {
+    const ATraceApi& api = atraceApi();
+    if (api.setCounter && (!api.isEnabled || api.isEnabled())) {
+        api.setCounter(kStageCounterNames[static_cast<size_t>(stage)], micros);
+    }
+}
+
+void LatencyTracer::addSample(LatencyStage stage, int64_t micros) {
+    // Negative spans only come from unsynchronized wall clocks; keep them out
+    if (micros < 0) {
+        return;
+    }
+    Window& window = windows_[static_cast<size_t>(stage)];
+    window.samples[window.next] = static_cast<uint32_t>(std::min<int64_t>(micros, UINT32_MAX));
+    window.next = (window.next + 1) % kLatencyWindowSamples;
+    window.count = std::min(window.count + 1, kLatencyWindowSamples);
+}
+
+LatencyStats LatencyTracer::collect() {
+    std::lock_guard<std::mutex> lock(collectMutex_);
+
+    TxFrameTrace tx;
+    while (txRing_.read(&tx, 1) == 1) {
+        txFrames_++;
+        addSample(LatencyStage::CAPTURE_TO_ENCODE, tx.encodeMicros - tx.captureMicros);
+        addSample(LatencyStage::ENCODE_TO_SEND, tx.sendMicros - tx.encodeMicros);
+    }
+
+    RxFrameTrace rx;
+    while (rxRing_.read(&rx, 1) == 1) {
+        rxFrames_++;
+        addSample(LatencyStage::JITTER_BUFFER, rx.dequeueMicros - rx.receiveMicros);
+        addSample(LatencyStage::DECODE, rx.decodeMicros - rx.dequeueMicros);
+        addSample(LatencyStage::PLAYOUT_QUEUE, rx.renderMicros - rx.decodeMicros);
+        if (rx.hasSenderStamps) {
+            addSample(LatencyStage::NETWORK_TRANSIT, rx.transitMicros);
+            if (rx.transitMicros >= 0) {
+                addSample(LatencyStage::MOUTH_TO_EAR,
+                          static_cast<int64_t>(rx.senderCaptureToSendMicros) +
+                          rx.transitMicros + (rx.renderMicros - rx.receiveMicros));
+            }
+        }
+    }
+
+    LatencyStats stats{};
+    stats.txFrames = txFrames_;
+    stats.rxFrames = rxFrames_;
+    stats.droppedTraces = droppedTraces_.load(std::memory_order_relaxed);
+
+    std::array<uint32_t, kLatencyWindowSamples> sorted;
+    for (size_t i = 0; i < kLatencyStageCount; ++i) {
+        const Window& window = windows_[i];
+        LatencyPercentiles& out = stats.stages[i];
+        out.samples = static_cast<uint32_t>(window.count);
+        if (window.count == 0) {
+            continue;
+        }
+        std::copy_n(window.samples.begin(), window.count, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + window.count);
+        out.p50Micros = percentile(sorted.data(), window.count, 50);
+        out.p95Micros = percentile(sorted.data(), window.count, 95);
+        out.p99Micros = percentile(sorted.data(), window.count, 99);
+        out.maxMicros = sorted[window.count - 1];
+    }
+    return stats;
+}
+
+void LatencyTracer::reset() {
+    std::lock_guard<std::mutex> lock(collectMutex_);
+
+    // Consumer side: drain rather than reset, producers may still be live
+    TxFrameTrace tx;
+    while (txRing_.read(&tx, 1) == 1) {}
+    RxFrameTrace rx;
+    while (rxRing_.read(&rx, 1) == 1) {}
+
+    windows_ = {};
+    txFrames_ = 0;
+    rxFrames_ = 0;
+    droppedTraces_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace ptt
+} // namespace meshrider
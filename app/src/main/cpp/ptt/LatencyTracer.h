@@ -0,0 +1,161 @@
+/*
+ * Mesh Rider Wave - End-to-End Latency Tracer
+ * Opt-in per-frame timestamps through every pipeline stage
+ *
+ * TX frames are stamped at capture, encode and send (encoder thread); RX
+ * frames at receive (receive thread), jitter-buffer dequeue, decode and
+ * render (decoder thread). Traces go into lock-free SPSC rings; collect()
+ * drains them off the audio path and reports p50/p95/p99 per stage over
+ * a sliding window. With ATrace enabled each stage is also emitted as a
+ * Perfetto counter track.
+ *
+ * Cross-device: the sender can add an RTP header extension (RFC 8285
+ * one-byte form) carrying its wall-clock send time and capture->send
+ * delay, so the receiver reports network transit and mouth-to-ear.
+ * Transit is only meaningful when both radios' wall clocks are
+ * synchronized (GPS / PTP on the mesh); the capture->send part always is.
+ *
+ * "Capture" is when the frame's first sample reached the capture callback
+ * and "render" is when it reaches the playback callback; device latency
+ * (mic/speaker path) is reported separately by AudioEngine.
+ */
+
+#ifndef MESHRIDER_PTT_LATENCY_TRACER_H
+#define MESHRIDER_PTT_LATENCY_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <time.h>
+#include "SpscRingBuffer.h"
+
+namespace meshrider {
+namespace ptt {
+
+// RFC 8285 one-byte header extension carrying sender stamps (id agreed out of band)
+constexpr uint16_t kRtpOneByteExtensionProfile = 0xBEDE;
+constexpr uint8_t kLatencyExtensionId = 7;
+constexpr size_t kLatencyExtensionDataBytes = 7;    // u32 send wall us + u24 capture->send us
+constexpr size_t kLatencyExtensionBlockBytes = 12;  // 4-byte block header + 8 (element, padded)
+
+// Traces queued per direction between collect() calls (~5 s of 20 ms frames)
+constexpr size_t kLatencyTraceRingCapacity = 256;
+
+// Samples per stage the percentiles are computed over
+constexpr size_t kLatencyWindowSamples = 512;
+
+enum class LatencyStage : size_t {
+    CAPTURE_TO_ENCODE,   // Capture ring + Opus encode
+    ENCODE_TO_SEND,      // Packetize + sendmmsg()
+    NETWORK_TRANSIT,     // Sender send -> local receive (needs extension + synced clocks)
+    JITTER_BUFFER,       // Receive -> dequeue
+    DECODE,              // Dequeue -> decoded PCM
+    PLAYOUT_QUEUE,       // Decoded -> playback callback (playback ring)
+    MOUTH_TO_EAR,        // Sender capture -> local render (needs extension)
+    COUNT
+};
+
+constexpr size_t kLatencyStageCount = static_cast<size_t>(LatencyStage::COUNT);
+
+// Steady clock used for every local stamp
+inline int64_t traceClockMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Wall clock (CLOCK_REALTIME) in microseconds, modulo 2^32 (~71 min wrap)
+inline uint32_t traceWallMicros32() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint32_t>(static_cast<uint64_t>(ts.tv_sec) * 1000000ULL +
+                                 static_cast<uint64_t>(ts.tv_nsec) / 1000ULL);
+}
+
+// One transmitted frame (encoder thread)
+struct TxFrameTrace {
+    int64_t captureMicros;
+    int64_t encodeMicros;
+    int64_t sendMicros;
+};
+
+// One received frame (decoder thread)
+struct RxFrameTrace {
+    int64_t receiveMicros;
+    int64_t dequeueMicros;
+    int64_t decodeMicros;
+    int64_t renderMicros;
+    int32_t transitMicros;              // Valid when hasSenderStamps
+    uint32_t senderCaptureToSendMicros;
+    bool hasSenderStamps;
+};
+
+struct LatencyPercentiles {
+    uint32_t samples;
+    uint32_t p50Micros;
+    uint32_t p95Micros;
+    uint32_t p99Micros;
+    uint32_t maxMicros;
+};
+
+struct LatencyStats {
+    std::array<LatencyPercentiles, kLatencyStageCount> stages;
+    uint64_t txFrames;          // Traced since enable
+    uint64_t rxFrames;
+    uint64_t droppedTraces;     // Trace ring full (collect() not called often enough)
+};
+
+/**
+ * Per-stage latency collector
+ *
+ * recordTx() has one producer (encoder thread), recordRx() one producer
+ * (decoder thread); both are wait-free. collect()/reset() run on a
+ * control thread.
+ */
+class LatencyTracer {
+public:
+    LatencyTracer();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Mirror each trace to ATrace counters (visible in Perfetto/systrace)
+    void setAtraceEnabled(bool enabled);
+
+    void recordTx(const TxFrameTrace& trace);
+    void recordRx(const RxFrameTrace& trace);
+
+    // Drain pending traces into the windows and compute percentiles
+    LatencyStats collect();
+
+    // Clear windows and counters (call with producers idle or tracing disabled)
+    void reset();
+
+private:
+    void addSample(LatencyStage stage, int64_t micros);
+    void emitCounter(LatencyStage stage, int64_t micros) const;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> atraceEnabled_{false};
+
+    SpscRingBuffer<TxFrameTrace, kLatencyTraceRingCapacity> txRing_;
+    SpscRingBuffer<RxFrameTrace, kLatencyTraceRingCapacity> rxRing_;
+    std::atomic<uint64_t> droppedTraces_{0};
+
+    // Collector side (guarded by collectMutex_)
+    struct Window {
+        std::array<uint32_t, kLatencyWindowSamples> samples{};
+        size_t next = 0;
+        size_t count = 0;
+    };
+    std::mutex collectMutex_;
+    std::array<Window, kLatencyStageCount> windows_{};
+    uint64_t txFrames_ = 0;
+    uint64_t rxFrames_ = 0;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_LATENCY_TRACER_H
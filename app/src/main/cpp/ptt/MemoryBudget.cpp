@@ -0,0 +1,73 @@
+/*
+ * Mesh Rider Wave - Native Memory Budget Implementation
+ */
+
+#include "MemoryBudget.h"
+#include "PttLog.h"
+#include <algorithm>
+
+#define TAG "MeshRider:PTT-Memory"
+
+namespace meshrider {
+namespace ptt {
+
+MemoryPlan planMemory(size_t budgetBytes, const MemoryDemand& demand) {
+    MemoryPlan plan;
+    plan.budgetBytes = budgetBytes;
+
+    const size_t smallBytes = PacketPool::bytesFor(PacketPoolConfig{1, 0});
+    const size_t mtuBytes = PacketPool::bytesFor(PacketPoolConfig{0, 1});
+    const size_t slotBytes = MemoryArena::align(demand.bytesPerStream) +
+                             demand.packetsPerStream * smallBytes;
+
+    const size_t baseBytes = kMinMtuPackets * mtuBytes;
+    if (slotBytes == 0 || budgetBytes < baseBytes + slotBytes) {
+        return plan;
+    }
+
+    plan.streams = std::min(demand.maxStreams, (budgetBytes - baseBytes) / slotBytes);
+    size_t remaining = budgetBytes - baseBytes - plan.streams * slotBytes;
+
+    const size_t extraMtu = std::min(kDefaultMtuPackets - kMinMtuPackets, remaining / mtuBytes);
+    remaining -= extraMtu * mtuBytes;
+    const size_t extraSmall = std::min(kSmallHeadroomPackets, remaining / smallBytes);
+
+    plan.pool.mtuPackets = kMinMtuPackets + extraMtu;
+    plan.pool.smallPackets = plan.streams * demand.packetsPerStream + extraSmall;
+    plan.arenaBytes = plan.streams * MemoryArena::align(demand.bytesPerStream);
+    plan.totalBytes = PacketPool::bytesFor(plan.pool) + plan.arenaBytes;
+    return plan;
+}
+
+bool MemoryArena::reserve(size_t bytes) {
+    if (block_ || bytes == 0) {
+        return false;
+    }
+    bytes = align(bytes);
+    block_.reset(static_cast<uint8_t*>(
+        ::operator new[](bytes, std::align_val_t(kArenaAlignment), std::nothrow)));
+    if (!block_) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG, "Arena reservation of %zu bytes failed", bytes);
+        return false;
+    }
+    capacity_ = bytes;
+    used_ = 0;
+    return true;
+}
+
+void* MemoryArena::allocate(size_t bytes, size_t alignment) {
+    if (sealed_) {
+        lateAllocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    const size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+    if (!block_ || offset + bytes > capacity_) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Arena exhausted: %zu bytes requested, %zu of %zu used", bytes, used_, capacity_);
+        return nullptr;
+    }
+    used_ = offset + bytes;
+    return block_.get() + offset;
+}
+
+} // namespace ptt
+} // namespace meshrider
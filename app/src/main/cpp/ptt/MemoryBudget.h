@@ -0,0 +1,127 @@
+/*
+ * Mesh Rider Wave - Native Memory Budget
+ * Receive-side memory reserved once, from a configured budget
+ *
+ * Everything the receive path holds per packet or per talker is taken at
+ * initialize(), and nothing is allocated afterwards:
+ * - PacketPool: SMALL buffers for parked voice, MTU buffers for receive
+ *   batches (PacketPool.h)
+ * - MemoryArena: one block carved into the receive stream slots, each slot
+ *   with its Opus decoder state next to it. Slots are recycled LRU by the
+ *   stream table, never freed.
+ * planMemory() turns a byte budget into slot and buffer counts: the fewest
+ * MTU buffers the receive loop needs, then as many stream slots (each with
+ * a full jitter buffer of SMALL buffers) as fit, then headroom. A budget
+ * below one slot is refused rather than exceeded.
+ *
+ * The arena counts what is asked of it after seal(); with the pool's
+ * exhaustion counters that is the steady-state allocation figure the
+ * benchmark holds at zero.
+ */
+
+#ifndef MESHRIDER_PTT_MEMORY_BUDGET_H
+#define MESHRIDER_PTT_MEMORY_BUDGET_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include "PacketPool.h"
+
+namespace meshrider {
+namespace ptt {
+
+// Eight talkers with full jitter buffers, with room to spare
+constexpr size_t kDefaultMemoryBudgetBytes = 512 * 1024;
+
+// Two receive batches (RtpPacketizer::kRecvBatchSize) in flight
+constexpr size_t kMinMtuPackets = 32;
+
+// SMALL buffers beyond the jitter slots: recorder, RED copies, hand-off
+constexpr size_t kSmallHeadroomPackets = 64;
+
+// Arena blocks start on a cache line
+constexpr size_t kArenaAlignment = 64;
+
+// What the stream table needs per slot
+struct MemoryDemand {
+    size_t maxStreams = 0;
+    size_t bytesPerStream = 0;          // Arena bytes of one slot
+    size_t packetsPerStream = 0;        // SMALL buffers one slot can park
+};
+
+struct MemoryPlan {
+    size_t budgetBytes = 0;
+    size_t streams = 0;                 // 0: budget below one slot
+    PacketPoolConfig pool{0, 0};
+    size_t arenaBytes = 0;
+    size_t totalBytes = 0;              // Pool + arena, never above the budget
+};
+
+MemoryPlan planMemory(size_t budgetBytes, const MemoryDemand& demand);
+
+struct MemoryStats {
+    size_t budgetBytes = 0;
+    size_t reservedBytes = 0;           // Pool + arena
+    size_t streamSlots = 0;
+    PacketPoolStats pool;
+    uint64_t lateAllocations = 0;       // Arena requests after seal()
+};
+
+/**
+ * Bump allocator over one reservation (NOT THREAD-SAFE)
+ *
+ * Set up by one thread during initialize(). Objects placed with create()
+ * are not destroyed by the arena; their owner runs the destructors.
+ */
+class MemoryArena {
+public:
+    MemoryArena() = default;
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    // The one allocation; false if it fails. Only before the first allocate().
+    bool reserve(size_t bytes);
+
+    // Null when the reservation is used up
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T) > kArenaAlignment ? alignof(T) : kArenaAlignment);
+        return memory ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    // Setup done: every later request is counted
+    void seal() { sealed_ = true; }
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+    uint64_t lateAllocations() const { return lateAllocations_.load(std::memory_order_relaxed); }
+
+    // Rounded up so consecutive slots keep kArenaAlignment
+    static constexpr size_t align(size_t bytes) {
+        return (bytes + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+    }
+
+private:
+    struct Free {
+        void operator()(uint8_t* block) const {
+            ::operator delete[](block, std::align_val_t(kArenaAlignment));
+        }
+    };
+
+    std::unique_ptr<uint8_t[], Free> block_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    bool sealed_ = false;
+    std::atomic<uint64_t> lateAllocations_{0};     // Read by telemetry
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_MEMORY_BUDGET_H
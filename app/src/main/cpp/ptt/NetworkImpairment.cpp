@@ -0,0 +1,202 @@
+/*
+ * Mesh Rider Wave - Network Impairment Emulator Implementation
+ */
+
+#include "NetworkImpairment.h"
+#include "PttLog.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+
+#define TAG "MeshRider:PTT-Impair"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+constexpr double kParetoAlpha = 2.5;
+
+uint32_t millisToMicros(double ms) {
+    return static_cast<uint32_t>(std::clamp(ms, 0.0, static_cast<double>(kMaxImpairmentJitterMs)) * 1000.0);
+}
+
+} // namespace
+
+// ============================================================================
+// NetworkImpairment
+// ============================================================================
+
+NetworkImpairment::NetworkImpairment(const ImpairmentProfile& profile)
+    : profile_(profile)
+    , state_(profile.seed) {
+}
+
+bool NetworkImpairment::loadTrace(const char* path) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG, "Cannot open trace %s", path);
+        return false;
+    }
+
+    // seq -> one-way delay (ms); first arrival wins, later copies are duplicates
+    std::map<uint32_t, double> delays;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned seq;
+        double sendMs;
+        double arrivalMs;
+        if (line[0] != '#' && std::sscanf(line, "%u %lf %lf", &seq, &sendMs, &arrivalMs) == 3) {
+            delays.emplace(seq, arrivalMs - sendMs);
+        }
+    }
+    std::fclose(file);
+
+    if (delays.empty()) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG, "Trace %s has no packets", path);
+        return false;
+    }
+
+    // Radios' clocks may be offset: keep only the variation above the fastest packet
+    double minDelayMs = delays.begin()->second;
+    for (const auto& entry : delays) {
+        minDelayMs = std::min(minDelayMs, entry.second);
+    }
+
+    trace_.clear();
+    trace_.reserve(delays.rbegin()->first - delays.begin()->first + 1);
+    uint32_t expected = delays.begin()->first;
+    for (const auto& [seq, delayMs] : delays) {
+        for (; expected < seq; ++expected) {
+            trace_.push_back({true, 0});
+        }
+        trace_.push_back({false, static_cast<uint32_t>((delayMs - minDelayMs) * 1000.0)});
+        expected = seq + 1;
+    }
+    traceIndex_ = 0;
+
+    const size_t lost = static_cast<size_t>(
+        std::count_if(trace_.begin(), trace_.end(), [](const TraceStep& s) { return s.lost; }));
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Loaded trace %s: %zu packets, %zu lost (%.1f%%)",
+        path, trace_.size(), lost, 100.0 * lost / trace_.size());
+    return true;
+}
+
+uint64_t NetworkImpairment::nextBits() {
+    // SplitMix64: tiny state, identical output on every platform
+    uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double NetworkImpairment::nextUnit() {
+    return static_cast<double>(nextBits() >> 11) * 0x1.0p-53;
+}
+
+uint32_t NetworkImpairment::jitterMicros() {
+    const double mean = profile_.jitterMs;
+    if (mean <= 0.0) {
+        return 0;
+    }
+    switch (profile_.jitter) {
+        case JitterDistribution::UNIFORM:
+            return millisToMicros(2.0 * mean * nextUnit());
+        case JitterDistribution::NORMAL: {
+            // Box-Muller; |N(0, sigma)| has mean sigma * sqrt(2 / pi)
+            const double u1 = 1.0 - nextUnit();
+            const double u2 = nextUnit();
+            const double gaussian = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+            return millisToMicros(std::abs(gaussian) * mean * std::sqrt(M_PI / 2.0));
+        }
+        case JitterDistribution::PARETO: {
+            // Excess over the scale: mean = scale / (alpha - 1)
+            const double scale = mean * (kParetoAlpha - 1.0);
+            const double u = 1.0 - nextUnit();
+            return millisToMicros(scale * (std::pow(u, -1.0 / kParetoAlpha) - 1.0));
+        }
+    }
+    return 0;
+}
+
+ImpairmentDecision NetworkImpairment::next() {
+    ImpairmentDecision decision;
+    const uint32_t baseDelayMicros = profile_.delayMs * 1000;
+
+    if (!trace_.empty()) {
+        const TraceStep& step = trace_[traceIndex_];
+        traceIndex_ = (traceIndex_ + 1) % trace_.size();
+        if (step.lost) {
+            decision.drop = true;
+            return decision;
+        }
+        decision.delayMicros = baseDelayMicros + step.delayMicros;
+    } else {
+        // Gilbert-Elliott: transition, then lose with the new state's probability
+        inBurst_ = inBurst_ ? !chance(profile_.burstExitPercent)
+                            : chance(profile_.burstEnterPercent);
+        if (chance(inBurst_ ? profile_.burstLossPercent : profile_.lossPercent)) {
+            decision.drop = true;
+            return decision;
+        }
+        decision.delayMicros = baseDelayMicros + jitterMicros();
+    }
+
+    if (profile_.reorderPercent > 0.0f && chance(profile_.reorderPercent)) {
+        decision.reordered = true;
+        decision.delayMicros += profile_.reorderDelayMs * 1000;
+    }
+
+    if (profile_.duplicatePercent > 0.0f && chance(profile_.duplicatePercent)) {
+        // The copy takes its own path through the jitter model
+        decision.duplicate = true;
+        decision.duplicateDelayMicros = baseDelayMicros + jitterMicros();
+    }
+    return decision;
+}
+
+// ============================================================================
+// ImpairmentDelayLine
+// ============================================================================
+
+bool ImpairmentDelayLine::push(int64_t dueMicros, PacketPtr& packet, size_t length,
+                               uint32_t channel) {
+    if (count_ == entries_.size()) {
+        return false;
+    }
+
+    // Insertion sort from the back: equal due times keep arrival order
+    size_t position = count_;
+    while (position > 0 && entries_[position - 1].dueMicros > dueMicros) {
+        entries_[position] = std::move(entries_[position - 1]);
+        --position;
+    }
+    entries_[position].dueMicros = dueMicros;
+    entries_[position].packet = std::move(packet);
+    entries_[position].length = static_cast<uint16_t>(length);
+    entries_[position].channel = channel;
+    count_++;
+    return true;
+}
+
+bool ImpairmentDelayLine::popDue(int64_t nowMicros, Entry& out) {
+    if (count_ == 0 || entries_[0].dueMicros > nowMicros) {
+        return false;
+    }
+    out = std::move(entries_[0]);
+    std::move(entries_.begin() + 1, entries_.begin() + count_, entries_.begin());
+    count_--;
+    return true;
+}
+
+void ImpairmentDelayLine::clear() {
+    for (size_t i = 0; i < count_; ++i) {
+        entries_[i].packet.reset();
+    }
+    count_ = 0;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,177 @@
+/*
+ * Mesh Rider Wave - Network Impairment Emulator
+ * Deterministic loss / burst / reorder / duplicate / delay for lab tuning
+ *
+ * Sits under RtpPacketizer so the jitter buffer, FEC recovery and rate
+ * controller can be tuned against reproducible link conditions instead of
+ * drive tests. Every per-packet decision comes from a seeded SplitMix64
+ * stream with hand-rolled distributions, so the same seed yields the same
+ * packet fates on device (libc++) and in the host benchmark (libstdc++).
+ *
+ * Loss is a Gilbert-Elliott chain (Bernoulli when burstEnterPercent is 0).
+ * Delay is delayMs plus a jitter draw (uniform, half-normal or Pareto
+ * with mean jitterMs); reordered packets get reorderDelayMs extra so later
+ * ones overtake them. A trace recorded from a MeshRider link (pcap-derived
+ * "seq send_ms arrival_ms" lines, lost packets omitted) replaces the loss
+ * and delay models and is replayed in sequence order, wrapping at the end.
+ *
+ * Transmit side applies loss and duplication only; delay, jitter and
+ * reorder are applied on receive, where the receive loop owns the timer.
+ */
+
+#ifndef MESHRIDER_PTT_NETWORK_IMPAIRMENT_H
+#define MESHRIDER_PTT_NETWORK_IMPAIRMENT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PacketPool.h"
+
+namespace meshrider {
+namespace ptt {
+
+// Packets the receive side can hold back at once (well under the pool size)
+constexpr size_t kImpairmentDelayLineCapacity = 128;
+
+// Cap on any single jitter draw (Pareto tail)
+constexpr uint32_t kMaxImpairmentJitterMs = 2000;
+
+enum class ImpairmentDirection : uint8_t {
+    TRANSMIT,   // Under sendToAll(): what every other radio hears from us
+    RECEIVE     // Under receiveLoop(): what this radio hears from everyone
+};
+
+enum class JitterDistribution : uint8_t {
+    UNIFORM,    // [0, 2 * jitterMs)
+    NORMAL,     // |N(0, sigma)|, mean jitterMs
+    PARETO      // Heavy tail (alpha 2.5), mean jitterMs - queueing bursts on busy hops
+};
+
+/**
+ * Link model; all-zero (the default) passes packets through untouched
+ */
+struct ImpairmentProfile {
+    uint64_t seed = 1;
+
+    // Gilbert-Elliott loss
+    float lossPercent = 0.0f;           // Loss probability in the good state
+    float burstEnterPercent = 0.0f;     // Good -> bad per packet
+    float burstExitPercent = 100.0f;    // Bad -> good per packet
+    float burstLossPercent = 0.0f;      // Loss probability in the bad state
+
+    float duplicatePercent = 0.0f;
+    float reorderPercent = 0.0f;
+    uint32_t reorderDelayMs = 0;        // Extra hold for reordered packets
+
+    uint32_t delayMs = 0;               // Fixed one-way delay
+    uint32_t jitterMs = 0;              // Mean of the jitter draw
+    JitterDistribution jitter = JitterDistribution::UNIFORM;
+
+    bool isActive() const {
+        return lossPercent > 0.0f || burstEnterPercent > 0.0f ||
+               duplicatePercent > 0.0f || reorderPercent > 0.0f ||
+               delayMs > 0 || jitterMs > 0;
+    }
+};
+
+/**
+ * Fate of one packet
+ */
+struct ImpairmentDecision {
+    bool drop = false;
+    bool duplicate = false;
+    bool reordered = false;
+    uint32_t delayMicros = 0;
+    uint32_t duplicateDelayMicros = 0;
+};
+
+// Per-direction counters (TelemetryBlock fields in RtpPacketizer)
+enum class ImpairmentField : size_t {
+    PACKETS, DROPPED, DUPLICATED, DELAYED, REORDERED, OVERFLOWS, COUNT
+};
+
+struct ImpairmentStats {
+    uint64_t packets;
+    uint64_t dropped;
+    uint64_t duplicated;
+    uint64_t delayed;
+    uint64_t reordered;
+    uint64_t overflows;     // Delay line full: delivered early
+};
+
+/**
+ * Seeded per-packet decision engine (NOT thread-safe; one owner at a time)
+ */
+class NetworkImpairment {
+public:
+    explicit NetworkImpairment(const ImpairmentProfile& profile);
+
+    // Replace the loss/delay models with a recorded trace; false if unreadable/empty
+    bool loadTrace(const char* path);
+    size_t getTraceLength() const { return trace_.size(); }
+
+    const ImpairmentProfile& getProfile() const { return profile_; }
+    bool isActive() const { return profile_.isActive() || !trace_.empty(); }
+
+    // Decide the next packet's fate (advances the random stream / trace)
+    ImpairmentDecision next();
+
+private:
+    struct TraceStep {
+        bool lost;
+        uint32_t delayMicros;   // Relative to the fastest packet in the trace
+    };
+
+    uint64_t nextBits();
+    double nextUnit();          // [0, 1)
+    bool chance(float percent) { return nextUnit() * 100.0 < percent; }
+    uint32_t jitterMicros();
+
+    ImpairmentProfile profile_;
+    uint64_t state_;
+    bool inBurst_ = false;
+
+    std::vector<TraceStep> trace_;
+    size_t traceIndex_ = 0;
+};
+
+/**
+ * Receive-side hold queue, ordered by release time
+ *
+ * Fixed capacity, owned by the receive thread; holding a packet keeps its
+ * pool buffer, so capacity stays far below kDefaultPoolPackets.
+ */
+class ImpairmentDelayLine {
+public:
+    struct Entry {
+        int64_t dueMicros = 0;
+        PacketPtr packet;
+        uint16_t length = 0;
+        uint32_t channel = 0;   // RtpPacketInfo::channel it arrived on
+    };
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+
+    // Takes the packet; false (packet left with the caller) when full
+    bool push(int64_t dueMicros, PacketPtr& packet, size_t length, uint32_t channel);
+
+    // Pop the earliest entry if it is due at nowMicros
+    bool popDue(int64_t nowMicros, Entry& out);
+
+    // Release time of the earliest entry, 0 if empty
+    int64_t nextDueMicros() const { return count_ ? entries_[0].dueMicros : 0; }
+
+    // Drop everything held (buffers return to the pool)
+    void clear();
+
+private:
+    std::array<Entry, kImpairmentDelayLineCapacity> entries_;  // Sorted by dueMicros
+    size_t count_ = 0;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_NETWORK_IMPAIRMENT_H
@@ -4,8 +4,9 @@
  */
 
 #include "OpusCodec.h"
-#include <android/log.h>
+#include "PttLog.h"
 #include <cstring>
+#include <algorithm>
 
 #define LOG_TAG "MeshRider:OpusCodec"
 
@@ -18,9 +19,11 @@ namespace ptt {
 
 OpusEncoder::OpusEncoder()
     : encoder_(nullptr)
+    , mode_(OpusMode::VOIP)
     , bitrate_(OPUS_BITRATE)
     , fecEnabled_(false)
     , complexity_(5)  // Medium complexity
+    , packetLossPercent_(5)  // Assume 5% packet loss until feedback arrives
 {
 }
 
@@ -46,20 +49,52 @@ bool OpusEncoder::initialize(OpusMode mode) {
             "Failed to create Opus encoder: %s", opus_strerror(error));
         return false;
     }
+    mode_ = mode;
 
+    configure();
+
+    __android_log_print(ANDROID_LOG_INFO, LOG_TAG,
+        "Opus encoder initialized: %d Hz, %d ch, %d bps",
+        OPUS_SAMPLE_RATE, OPUS_CHANNELS, bitrate_);
+
+    return true;
+}
+
+void OpusEncoder::configure() {
     // Configure encoder
     opus_encoder_ctl(encoder_, OPUS_SET_BITRATE(bitrate_));
     opus_encoder_ctl(encoder_, OPUS_SET_COMPLEXITY(complexity_));
     opus_encoder_ctl(encoder_, OPUS_SET_INBAND_FEC(fecEnabled_ ? 1 : 0));
-    opus_encoder_ctl(encoder_, OPUS_SET_PACKET_LOSS_PERC(5));  // Assume 5% packet loss
+    opus_encoder_ctl(encoder_, OPUS_SET_PACKET_LOSS_PERC(packetLossPercent_));
 
     // Set expected packet loss for PLC
     opus_encoder_ctl(encoder_, OPUS_SET_DTX(1));  // Discontinuous transmission
+}
 
-    __android_log_print(ANDROID_LOG_INFO, LOG_TAG,
-        "Opus encoder initialized: %d Hz, %d ch, %d bps",
-        OPUS_SAMPLE_RATE, OPUS_CHANNELS, bitrate_);
+bool OpusEncoder::setMode(OpusMode mode) {
+    if (!encoder_) {
+        return false;
+    }
+    if (mode == mode_) {
+        return true;
+    }
+
+    // Same size for every mode: re-init in place
+    const int error = opus_encoder_init(encoder_, OPUS_SAMPLE_RATE, OPUS_CHANNELS,
+                                        static_cast<int>(mode));
+    if (error != OPUS_OK) {
+        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+            "Failed to switch Opus mode: %s", opus_strerror(error));
+        // State is undefined now: fall back to the previous mode
+        opus_encoder_init(encoder_, OPUS_SAMPLE_RATE, OPUS_CHANNELS, static_cast<int>(mode_));
+        configure();
+        return false;
+    }
+    mode_ = mode;
+    configure();
 
+    __android_log_print(ANDROID_LOG_INFO, LOG_TAG,
+        "Opus encoder mode %d", static_cast<int>(mode));
     return true;
 }
 
@@ -70,9 +105,9 @@ int OpusEncoder::encode(const int16_t* pcm, int frameSize,
         return -1;
     }
 
-    if (frameSize != OPUS_FRAME_SIZE) {
+    if (!isValidFrameSize(frameSize)) {
         __android_log_print(ANDROID_LOG_WARN, LOG_TAG,
-            "Frame size mismatch: expected %d, got %d", OPUS_FRAME_SIZE, frameSize);
+            "Invalid Opus frame size: %d samples", frameSize);
     }
 
     const opus_int16* pcmData = reinterpret_cast<const opus_int16*>(pcm);
@@ -132,6 +167,27 @@ void OpusEncoder::setComplexity(int complexity) {
     }
 }
 
+void OpusEncoder::setPacketLossPercent(int percent) {
+    percent = std::max(0, std::min(100, percent));
+    packetLossPercent_ = percent;
+    if (encoder_) {
+        opus_encoder_ctl(encoder_, OPUS_SET_PACKET_LOSS_PERC(percent));
+    }
+}
+
+bool OpusEncoder::isValidFrameSize(int frameSize) {
+    // 2.5 ms granularity: 400 * frameSize / rate in {1, 2, 4, 8, 16, 24}
+    const int units = frameSize * 400;
+    if (frameSize <= 0 || units % OPUS_SAMPLE_RATE != 0) {
+        return false;
+    }
+    switch (units / OPUS_SAMPLE_RATE) {
+        case 1: case 2: case 4: case 8: case 16: case 24:
+            return true;
+        default:
+            return false;
+    }
+}
 
 // ============================================================================
 // OpusDecoder Implementation
@@ -139,15 +195,20 @@ void OpusEncoder::setComplexity(int complexity) {
 
 OpusDecoder::OpusDecoder()
     : decoder_(nullptr)
+    , ownsState_(false)
     , lastError_(OPUS_OK)
 {
 }
 
 OpusDecoder::~OpusDecoder() {
-    if (decoder_) {
+    if (decoder_ && ownsState_) {
         opus_decoder_destroy(decoder_);
-        decoder_ = nullptr;
     }
+    decoder_ = nullptr;
+}
+
+size_t OpusDecoder::stateSize() {
+    return static_cast<size_t>(opus_decoder_get_size(OPUS_CHANNELS));
 }
 
 bool OpusDecoder::initialize() {
@@ -157,11 +218,28 @@ bool OpusDecoder::initialize() {
         OPUS_CHANNELS,
         &error
     );
+    ownsState_ = true;
+    return configure(error);
+}
+
+bool OpusDecoder::initialize(void* state) {
+    if (!state) {
+        return false;
+    }
+    decoder_ = static_cast<::OpusDecoder*>(state);
+    ownsState_ = false;
+    return configure(opus_decoder_init(decoder_, OPUS_SAMPLE_RATE, OPUS_CHANNELS));
+}
 
+bool OpusDecoder::configure(int error) {
     if (error != OPUS_OK || !decoder_) {
         __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
             "Failed to create Opus decoder: %s", opus_strerror(error));
         lastError_ = error;
+        if (ownsState_ && decoder_) {
+            opus_decoder_destroy(decoder_);
+        }
+        decoder_ = nullptr;
         return false;
     }
 
@@ -217,7 +295,7 @@ int OpusDecoder::decodePLC(int16_t* output, int frameSize) {
         0,         // Zero length
         pcmData,
         frameSize,
-        1  // Use FEC to reconstruct
+        0  // FEC needs the next packet's data; see decodeFEC()
     );
 
     if (decodedSamples < 0) {
@@ -229,6 +307,41 @@ int OpusDecoder::decodePLC(int16_t* output, int frameSize) {
     return decodedSamples;
 }
 
+int OpusDecoder::decodeFEC(const uint8_t* nextPacket, int nextPacketSize,
+                           int16_t* output, int frameSize) {
+    if (!decoder_ || !nextPacket || nextPacketSize <= 0) {
+        return -1;
+    }
+
+    // LBRR covers exactly one frame of the next packet's duration
+    const int lostSamples = opus_packet_get_nb_samples(nextPacket, nextPacketSize,
+                                                       OPUS_SAMPLE_RATE);
+    if (lostSamples <= 0 || lostSamples > frameSize) {
+        return -1;
+    }
+
+    int decodedSamples = opus_decode(
+        decoder_,
+        nextPacket,
+        nextPacketSize,
+        reinterpret_cast<opus_int16*>(output),
+        lostSamples,
+        1  // Decode the in-band FEC (LBRR) copy of the previous frame
+    );
+
+    if (decodedSamples < 0) {
+        __android_log_print(ANDROID_LOG_WARN, LOG_TAG,
+            "Opus FEC decode failed: %s", opus_strerror(decodedSamples));
+        lastError_ = decodedSamples;
+    }
+
+    return decodedSamples;
+}
+
+bool OpusDecoder::hasFEC(const uint8_t* packet, int packetSize) {
+    return packet && packetSize > 0 && opus_packet_has_lbrr(packet, packetSize) == 1;
+}
+
 void OpusDecoder::reset() {
     if (decoder_) {
         opus_decoder_ctl(decoder_, OPUS_RESET_STATE);
@@ -4,7 +4,7 @@
  * Following xiph.org/libopus guidelines
  *
  * Performance: 6-24 kbps (vs 256 kbps PCM) = 10-40x bandwidth reduction
- * Latency: 20ms frame size for low-latency PTT
+ * Latency: 20ms nominal frame (10ms build variant), 40/60ms under heavy loss
  */
 
 #ifndef MESHRIDER_PTT_OPUS_CODEC_H
@@ -14,14 +14,16 @@
 #include <vector>
 #include <memory>
 #include "opus.h"
+#include "AudioFormat.h"
 
 namespace meshrider {
 namespace ptt {
 
-// Opus configuration per 3GPP MCPTT
-constexpr int OPUS_SAMPLE_RATE = 16000;     // 16 kHz for voice
-constexpr int OPUS_CHANNELS = 1;            // Mono for PTT
-constexpr int OPUS_FRAME_SIZE = 960;        // 20ms @ 16kHz (16 * 20)
+// Opus configuration per 3GPP MCPTT (all derived from PttAudioFormat)
+constexpr int OPUS_SAMPLE_RATE = PttAudioFormat::kSampleRate;           // 16 kHz for voice
+constexpr int OPUS_CHANNELS = PttAudioFormat::kChannels;                // Mono for PTT
+constexpr int OPUS_FRAME_SIZE = PttAudioFormat::kFrameSamples;          // Nominal frame (320 = 20ms @ 16kHz)
+constexpr int OPUS_MAX_FRAME_SIZE = PttAudioFormat::kMaxFrameSamples;   // 60 ms: PCM buffer capacity
 constexpr int OPUS_BITRATE = 12000;         // 12 kbps (MCPTT standard)
 constexpr int OPUS_MAX_PACKET_SIZE = 4000;  // Max encoded frame size
 
@@ -51,6 +53,12 @@ public:
     // Reset encoder state
     void reset();
 
+    // Re-initialize the same state for another application mode, keeping
+    // bitrate, FEC, complexity and loss hint (libopus fixes the mode after
+    // the first frame). Between transmissions; no-op when unchanged.
+    bool setMode(OpusMode mode);
+    OpusMode getMode() const { return mode_; }
+
     // Get/Set bitrate (bps)
     void setBitrate(int bitrate);  // 6000-24000 bps
     int getBitrate() const { return bitrate_; }
@@ -63,11 +71,23 @@ public:
     void setComplexity(int complexity);
     int getComplexity() const { return complexity_; }
 
+    // Expected packet loss (0-100%); steers how much FEC redundancy is spent
+    void setPacketLossPercent(int percent);
+    int getPacketLossPercent() const { return packetLossPercent_; }
+
+    // Frame sizes Opus accepts at OPUS_SAMPLE_RATE: 2.5/5/10/20/40/60 ms
+    static bool isValidFrameSize(int frameSize);
+
 private:
+    // Push the cached settings into a fresh state
+    void configure();
+
     ::OpusEncoder* encoder_;  // Opus library type
+    OpusMode mode_;
     int bitrate_;
     bool fecEnabled_;
     int complexity_;
+    int packetLossPercent_;
 };
 
 /**
@@ -82,6 +102,11 @@ public:
     // Initialize decoder
     bool initialize();
 
+    // Same, with the state in caller memory of stateSize() bytes (kept
+    // until this decoder is destroyed; not freed by it)
+    bool initialize(void* state);
+    static size_t stateSize();
+
     // Decode Opus frame to PCM
     // Returns: number of samples decoded, or negative on error
     int decode(const uint8_t* input, int inputSize, int16_t* output, int frameSize);
@@ -89,6 +114,14 @@ public:
     // Decode with PLC (Packet Loss Concealment) when packet is lost
     int decodePLC(int16_t* output, int frameSize);
 
+    // Recover a lost frame from the in-band FEC carried by the packet after it.
+    // frameSize is the output capacity; returns samples or negative on error.
+    int decodeFEC(const uint8_t* nextPacket, int nextPacketSize,
+                  int16_t* output, int frameSize);
+
+    // True if the packet carries LBRR data for its predecessor
+    static bool hasFEC(const uint8_t* packet, int packetSize);
+
     // Reset decoder state
     void reset();
 
@@ -96,7 +129,10 @@ public:
     int getLastError() const { return lastError_; }
 
 private:
+    bool configure(int error);
+
     ::OpusDecoder* decoder_;  // Opus library type
+    bool ownsState_;
     int lastError_;
 };
 
@@ -0,0 +1,198 @@
+/*
+ * Mesh Rider Wave - Fixed RTP Packet Pool Implementation (SMALL / MTU classes)
+ */
+
+#include "PacketPool.h"
+#include "PttLog.h"
+#include <cstring>
+
+#define TAG "MeshRider:PTT-Pool"
+
+namespace meshrider {
+namespace ptt {
+
+void PacketDeleter::operator()(PooledPacket* packet) const {
+    if (packet) {
+        packet->pool_->release(packet);
+    }
+}
+
+namespace {
+
+constexpr size_t classCapacity(PacketClass packetClass) {
+    return packetClass == PacketClass::SMALL ? kSmallPacketCapacity : kPooledPacketCapacity;
+}
+
+} // namespace
+
+PacketPool::PacketPool(size_t mtuPackets)
+    : PacketPool(PacketPoolConfig{0, mtuPackets}) {
+}
+
+PacketPool::PacketPool(const PacketPoolConfig& config)
+    : count_(config.smallPackets + config.mtuPackets)
+    , packets_(std::make_unique<PooledPacket[]>(count_))
+    , buffers_(std::make_unique<uint8_t[]>(config.smallPackets * kSmallPacketCapacity +
+                                           config.mtuPackets * kPooledPacketCapacity)) {
+
+    // Thread each class onto its free list in index order
+    uint8_t* buffer = buffers_.get();
+    size_t first = 0;
+    for (size_t c = 0; c < kPacketClassCount; ++c) {
+        const PacketClass packetClass = static_cast<PacketClass>(c);
+        FreeList& list = freeLists_[c];
+        list.count = packetClass == PacketClass::SMALL ? config.smallPackets : config.mtuPackets;
+        for (size_t i = first; i < first + list.count; ++i) {
+            PooledPacket& packet = packets_[i];
+            packet.data = buffer;
+            packet.capacity = static_cast<uint16_t>(classCapacity(packetClass));
+            packet.pool_ = this;
+            packet.index_ = static_cast<uint32_t>(i);
+            packet.class_ = packetClass;
+            packet.next_.store(i + 1 < first + list.count ? static_cast<uint32_t>(i + 1) : kNil,
+                               std::memory_order_relaxed);
+            buffer += classCapacity(packetClass);
+        }
+        if (list.count > 0) {
+            list.head.store(pack(0, static_cast<uint32_t>(first)), std::memory_order_release);
+        }
+        list.available.store(list.count, std::memory_order_relaxed);
+        first += list.count;
+    }
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Packet pool ready: %zu x %zu + %zu x %zu bytes",
+        config.smallPackets, kSmallPacketCapacity, config.mtuPackets, kPooledPacketCapacity);
+}
+
+PacketPool::~PacketPool() {
+    if (available() != count_) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Packet pool destroyed with %zu buffers outstanding",
+            count_ - available());
+    }
+}
+
+size_t PacketPool::bytesFor(const PacketPoolConfig& config) {
+    return config.smallPackets * (sizeof(PooledPacket) + kSmallPacketCapacity) +
+           config.mtuPackets * (sizeof(PooledPacket) + kPooledPacketCapacity);
+}
+
+PacketPtr PacketPool::acquire() {
+    return pop(PacketClass::MTU, true);
+}
+
+PacketPtr PacketPool::acquire(size_t length) {
+    if (length > kPooledPacketCapacity) {
+        return PacketPtr();
+    }
+    if (length <= kSmallPacketCapacity) {
+        if (PacketPtr packet = pop(PacketClass::SMALL, true)) {
+            return packet;
+        }
+    }
+    return pop(PacketClass::MTU, true);
+}
+
+PacketPtr PacketPool::compact(PacketPtr packet) {
+    if (!packet || packet->pool_ != this || packet->class_ != PacketClass::MTU ||
+        packet->length > kSmallPacketCapacity) {
+        return packet;
+    }
+    // An empty SMALL class is not a drop: the packet keeps its MTU buffer
+    PacketPtr small = pop(PacketClass::SMALL, false);
+    if (!small) {
+        return packet;
+    }
+    std::memcpy(small->data, packet->data, packet->length);
+    small->length = packet->length;
+    small->payloadOffset = packet->payloadOffset;
+    small->payloadLength = packet->payloadLength;
+    small->timestamps = packet->timestamps;
+    compacted_.fetch_add(1, std::memory_order_relaxed);
+    return small;
+}
+
+PacketPtr PacketPool::pop(PacketClass packetClass, bool countExhausted) {
+    FreeList& list = freeList(packetClass);
+    uint64_t head = list.head.load(std::memory_order_acquire);
+
+    for (;;) {
+        const uint32_t index = static_cast<uint32_t>(head);
+        if (index == kNil) {
+            if (countExhausted) {
+                list.exhausted.fetch_add(1, std::memory_order_relaxed);
+            }
+            return PacketPtr();
+        }
+
+        const uint32_t next = packets_[index].next_.load(std::memory_order_relaxed);
+        const uint64_t newHead = pack(static_cast<uint32_t>(head >> 32) + 1, next);
+
+        if (list.head.compare_exchange_weak(head, newHead,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            list.available.fetch_sub(1, std::memory_order_relaxed);
+            PooledPacket* packet = &packets_[index];
+            packet->length = 0;
+            packet->payloadOffset = 0;
+            packet->payloadLength = 0;
+            return PacketPtr(packet);
+        }
+    }
+}
+
+void PacketPool::release(PooledPacket* packet) {
+    FreeList& list = freeList(packet->class_);
+    uint64_t head = list.head.load(std::memory_order_relaxed);
+
+    for (;;) {
+        packet->next_.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        const uint64_t newHead = pack(static_cast<uint32_t>(head >> 32) + 1, packet->index_);
+
+        if (list.head.compare_exchange_weak(head, newHead,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+            list.available.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+size_t PacketPool::capacity() const {
+    return count_;
+}
+
+size_t PacketPool::available() const {
+    size_t total = 0;
+    for (const FreeList& list : freeLists_) {
+        total += list.available.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t PacketPool::getExhaustedCount() const {
+    uint64_t total = 0;
+    for (const FreeList& list : freeLists_) {
+        total += list.exhausted.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+PacketPoolStats PacketPool::getStats() const {
+    PacketPoolStats stats;
+    PacketPoolConfig config;
+    for (size_t c = 0; c < kPacketClassCount; ++c) {
+        stats.capacity[c] = freeLists_[c].count;
+        stats.available[c] = freeLists_[c].available.load(std::memory_order_relaxed);
+        stats.exhausted[c] = freeLists_[c].exhausted.load(std::memory_order_relaxed);
+    }
+    config.smallPackets = stats.capacity[static_cast<size_t>(PacketClass::SMALL)];
+    config.mtuPackets = stats.capacity[static_cast<size_t>(PacketClass::MTU)];
+    stats.compacted = compacted_.load(std::memory_order_relaxed);
+    stats.bytes = bytesFor(config);
+    return stats;
+}
+
+} // namespace ptt
+} // namespace meshrider
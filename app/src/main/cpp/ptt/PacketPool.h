@@ -0,0 +1,174 @@
+/*
+ * Mesh Rider Wave - Fixed RTP Packet Pool
+ * Preallocated datagram buffers passed by ownership, not by memcpy
+ *
+ * The receive thread fills a pooled buffer straight from recvmmsg() and
+ * hands the PacketPtr to the talker's jitter buffer; the playback side
+ * decodes from it and the buffer returns to the pool when the PacketPtr
+ * goes out of scope. Acquire/release are lock-free (tagged Treiber stack),
+ * so release is safe from the audio callback.
+ *
+ * Two size classes share one allocation. MTU buffers take datagrams of
+ * unknown size (recvmmsg); SMALL buffers hold what waits in the jitter
+ * buffers. A voice packet is well under kSmallPacketCapacity, so
+ * compact() moves it to a SMALL buffer when it is parked and the MTU
+ * buffer goes straight back to the receive batch: a few MTU buffers serve
+ * every stream, and parked audio costs a sixth of the memory.
+ */
+
+#ifndef MESHRIDER_PTT_PACKET_POOL_H
+#define MESHRIDER_PTT_PACKET_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace meshrider {
+namespace ptt {
+
+// One Ethernet MTU worth of datagram (MTU class)
+constexpr size_t kPooledPacketCapacity = 1500;
+
+// Voice up to 64 kbps x 20 ms plus RTP, extension and SRTP tag (SMALL class)
+constexpr size_t kSmallPacketCapacity = 256;
+
+enum class PacketClass : uint8_t {
+    SMALL,
+    MTU,
+    COUNT
+};
+
+constexpr size_t kPacketClassCount = static_cast<size_t>(PacketClass::COUNT);
+
+// Receive batches and datagrams on their way to a jitter buffer
+constexpr size_t kDefaultMtuPackets = 64;
+
+// Every jitter slot of every receive stream plus headroom
+constexpr size_t kDefaultSmallPackets = 320;
+
+struct PacketPoolConfig {
+    size_t smallPackets = kDefaultSmallPackets;
+    size_t mtuPackets = kDefaultMtuPackets;
+};
+
+struct PacketPoolStats {
+    std::array<size_t, kPacketClassCount> capacity{};
+    std::array<size_t, kPacketClassCount> available{};
+    std::array<uint64_t, kPacketClassCount> exhausted{};
+    uint64_t compacted = 0;             // MTU buffers swapped for SMALL ones
+    size_t bytes = 0;                   // Headers and buffers, both classes
+};
+
+class PacketPool;
+
+// Latency trace stamps (LatencyTracer); set by whoever fills the buffer
+struct PacketTimestamps {
+    int64_t receiveMicros = 0;              // traceClockMicros() at receive
+    int32_t transitMicros = 0;              // Sender send -> receive (wall clocks)
+    uint32_t senderCaptureToSendMicros = 0;
+    bool hasSenderStamps = false;           // RTP latency extension present
+};
+
+/**
+ * One pooled datagram buffer
+ * payloadOffset/payloadLength locate the RTP payload after parsing.
+ */
+struct PooledPacket {
+    uint8_t* data = nullptr;                // capacity bytes owned by the pool
+    uint16_t capacity = 0;
+    uint16_t length = 0;
+    uint16_t payloadOffset = 0;
+    uint16_t payloadLength = 0;
+    PacketTimestamps timestamps;
+
+    const uint8_t* payload() const { return data + payloadOffset; }
+
+private:
+    friend class PacketPool;
+    friend struct PacketDeleter;
+    PacketPool* pool_ = nullptr;
+    uint32_t index_ = 0;
+    PacketClass class_ = PacketClass::MTU;
+    std::atomic<uint32_t> next_{0};   // Free-list link
+};
+
+// Returns the buffer to its pool
+struct PacketDeleter {
+    void operator()(PooledPacket* packet) const;
+};
+
+using PacketPtr = std::unique_ptr<PooledPacket, PacketDeleter>;
+
+/**
+ * Fixed-capacity pool of PooledPacket buffers in two size classes
+ *
+ * Must outlive every PacketPtr it hands out; share it with shared_ptr
+ * between producer (RtpPacketizer) and consumers (receive streams).
+ */
+class PacketPool {
+public:
+    explicit PacketPool(const PacketPoolConfig& config = PacketPoolConfig{});
+
+    // MTU buffers only (benchmark jitter replay)
+    explicit PacketPool(size_t mtuPackets);
+    ~PacketPool();
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    // An MTU buffer for a datagram of unknown size; null PacketPtr when
+    // exhausted (caller drops the datagram)
+    PacketPtr acquire();
+
+    // Smallest class that holds length bytes, the larger one if it is out
+    PacketPtr acquire(size_t length);
+
+    // A SMALL copy of an MTU packet that fits (bytes and metadata), or the
+    // packet unchanged. Any thread; the MTU buffer returns to the pool.
+    PacketPtr compact(PacketPtr packet);
+
+    // Memory both classes take for a configuration
+    static size_t bytesFor(const PacketPoolConfig& config);
+
+    // Statistics
+    size_t capacity() const;
+    size_t available() const;
+    uint64_t getExhaustedCount() const;
+    PacketPoolStats getStats() const;
+
+private:
+    friend struct PacketDeleter;
+    void release(PooledPacket* packet);
+    PacketPtr pop(PacketClass packetClass, bool countExhausted);
+
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+
+    // Head packs {tag:32, index:32}; the tag defeats ABA on pop
+    static uint64_t pack(uint32_t tag, uint32_t index) {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+
+    struct FreeList {
+        size_t count = 0;
+        std::atomic<uint64_t> head{pack(0, kNil)};
+        std::atomic<size_t> available{0};
+        std::atomic<uint64_t> exhausted{0};
+    };
+
+    FreeList& freeList(PacketClass packetClass) {
+        return freeLists_[static_cast<size_t>(packetClass)];
+    }
+
+    const size_t count_;
+    std::unique_ptr<PooledPacket[]> packets_;   // SMALL first, then MTU
+    std::unique_ptr<uint8_t[]> buffers_;
+    std::array<FreeList, kPacketClassCount> freeLists_;
+    std::atomic<uint64_t> compacted_{0};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_PACKET_POOL_H
@@ -0,0 +1,95 @@
+/*
+ * Mesh Rider Wave - PTT Power Meter
+ * CPU wakeups of the pipeline threads, split by power mode
+ *
+ * Every thread the pipeline owns (receive loop, decoder and encoder
+ * workers, both audio callbacks) counts one wakeup each time the kernel
+ * runs it. The count goes to the mode the engine is in at that moment, so
+ * an all-day deployment can compare wakeups per minute while a talkgroup
+ * is active against the idle floor. wake() is one relaxed increment and
+ * safe from the audio callbacks; mode changes are rare and locked.
+ */
+
+#ifndef MESHRIDER_PTT_POWER_METER_H
+#define MESHRIDER_PTT_POWER_METER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace meshrider {
+namespace ptt {
+
+enum class PowerMode : uint8_t {
+    ACTIVE,     // Playback armed (or transmitting)
+    IDLE        // Receive side parked after silence; nothing transmitting
+};
+
+constexpr size_t kPowerModeCount = 2;
+
+struct PowerTotals {
+    PowerMode mode = PowerMode::ACTIVE;
+    std::array<uint64_t, kPowerModeCount> micros{};     // Time spent per mode
+    std::array<uint64_t, kPowerModeCount> wakeups{};
+    uint64_t idleEntries = 0;
+};
+
+class PowerMeter {
+public:
+    explicit PowerMeter(int64_t nowMicros) : modeSinceMicros_(nowMicros) {}
+
+    PowerMeter(const PowerMeter&) = delete;
+    PowerMeter& operator=(const PowerMeter&) = delete;
+
+    // One thread wakeup (any thread, real-time safe)
+    void wake() {
+        wakeups_[static_cast<size_t>(mode_.load(std::memory_order_relaxed))]
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PowerMode mode() const { return mode_.load(std::memory_order_relaxed); }
+
+    void setMode(PowerMode mode, int64_t nowMicros) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const PowerMode current = mode_.load(std::memory_order_relaxed);
+        if (mode == current) {
+            return;
+        }
+        micros_[static_cast<size_t>(current)] += static_cast<uint64_t>(nowMicros - modeSinceMicros_);
+        modeSinceMicros_ = nowMicros;
+        if (mode == PowerMode::IDLE) {
+            ++idleEntries_;
+        }
+        mode_.store(mode, std::memory_order_relaxed);
+    }
+
+    PowerTotals snapshot(int64_t nowMicros) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PowerTotals totals;
+        totals.mode = mode_.load(std::memory_order_relaxed);
+        totals.micros = micros_;
+        totals.micros[static_cast<size_t>(totals.mode)] +=
+            static_cast<uint64_t>(nowMicros - modeSinceMicros_);
+        for (size_t i = 0; i < kPowerModeCount; ++i) {
+            totals.wakeups[i] = wakeups_[i].load(std::memory_order_relaxed);
+        }
+        totals.idleEntries = idleEntries_;
+        return totals;
+    }
+
+private:
+    std::atomic<PowerMode> mode_{PowerMode::ACTIVE};
+    std::array<std::atomic<uint64_t>, kPowerModeCount> wakeups_{};
+
+    mutable std::mutex mutex_;
+    int64_t modeSinceMicros_;
+    std::array<uint64_t, kPowerModeCount> micros_{};
+    uint64_t idleEntries_ = 0;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_POWER_METER_H
@@ -0,0 +1,59 @@
+/*
+ * Mesh Rider Wave - PTT Logging Shim
+ * Android logcat on device, stderr on host builds (benchmark harness)
+ *
+ * Pipeline sources include this instead of <android/log.h> so the codec,
+ * jitter buffer and packetizer compile off-device unchanged. The host sink
+ * keeps the __android_log_print() call shape and drops anything below
+ * pttHostLogLevel() (WARN by default) so benchmark output stays readable.
+ */
+
+#ifndef MESHRIDER_PTT_LOG_H
+#define MESHRIDER_PTT_LOG_H
+
+#if defined(__ANDROID__)
+
+#include <android/log.h>
+
+#else
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+enum {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT
+};
+
+// Minimum priority printed by host builds
+inline std::atomic<int>& pttHostLogLevel() {
+    static std::atomic<int> level{ANDROID_LOG_WARN};
+    return level;
+}
+
+__attribute__((format(printf, 3, 4)))
+inline int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    if (prio < pttHostLogLevel().load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    static constexpr char kPriorityLetters[] = "??VDIWEFS";
+    std::fprintf(stderr, "%c/%s: ", kPriorityLetters[prio & 7], tag);
+    va_list args;
+    va_start(args, fmt);
+    const int written = std::vfprintf(stderr, fmt, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+    return written;
+}
+
+#endif // __ANDROID__
+
+#endif // MESHRIDER_PTT_LOG_H
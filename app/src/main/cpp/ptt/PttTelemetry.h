@@ -0,0 +1,305 @@
+/*
+ * Mesh Rider Wave - PTT Pipeline Telemetry
+ * Lock-free counters for every pipeline stage, snapshotted for the app
+ *
+ * Each stage has one writer thread (capture callback, encoder, receive,
+ * decoder, playback callback). Its counters live in a TelemetryBlock on
+ * cache lines of their own, so stages never false-share and writers use
+ * plain relaxed stores - no lock, no locked read-modify-write. A per-block
+ * sequence number (seqlock) lets a reader copy a block as one consistent
+ * set: readers retry, writers never wait.
+ *
+ * Counters bumped from more than one thread use PaddedCounter instead.
+ */
+
+#ifndef MESHRIDER_PTT_TELEMETRY_H
+#define MESHRIDER_PTT_TELEMETRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include "SpscRingBuffer.h"   // kCacheLineSize
+
+namespace meshrider {
+namespace ptt {
+
+// Underrun histogram: upper bound (ms of missing audio) of each bucket; last is open-ended
+constexpr std::array<uint32_t, 5> kUnderrunBucketLimitsMs = {5, 10, 20, 40, 80};
+constexpr size_t kUnderrunHistogramBuckets = kUnderrunBucketLimitsMs.size() + 1;
+
+/**
+ * Multi-writer counter on its own cache line
+ */
+struct alignas(kCacheLineSize) PaddedCounter {
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t load() const { return value.load(std::memory_order_relaxed); }
+    void reset() { value.store(0, std::memory_order_relaxed); }
+};
+
+/**
+ * Single-writer counter group, published with a seqlock
+ *
+ * Field is an enum class whose last enumerator is COUNT. The writer
+ * brackets related updates with beginUpdate()/endUpdate() (or uses
+ * increment() for one field); snapshot() may be called from any thread.
+ */
+template <typename Field>
+class alignas(kCacheLineSize) TelemetryBlock {
+public:
+    static constexpr size_t kFieldCount = static_cast<size_t>(Field::COUNT);
+
+    // Writer thread only
+    void beginUpdate() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endUpdate() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void add(Field field, uint64_t n = 1) {
+        std::atomic<uint64_t>& value = values_[index(field)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void max(Field field, uint64_t candidate) {
+        std::atomic<uint64_t>& value = values_[index(field)];
+        if (candidate > value.load(std::memory_order_relaxed)) {
+            value.store(candidate, std::memory_order_relaxed);
+        }
+    }
+
+    void set(Field field, uint64_t value) {
+        values_[index(field)].store(value, std::memory_order_relaxed);
+    }
+
+    void increment(Field field, uint64_t n = 1) {
+        beginUpdate();
+        add(field, n);
+        endUpdate();
+    }
+
+    // Any thread; one field needs no seqlock
+    uint64_t load(Field field) const {
+        return values_[index(field)].load(std::memory_order_relaxed);
+    }
+
+    // Any thread: consistent copy of every field (retries while the writer is mid-update)
+    std::array<uint64_t, kFieldCount> snapshot() const {
+        std::array<uint64_t, kFieldCount> out{};
+        for (;;) {
+            const uint32_t before = seq_.load(std::memory_order_acquire);
+            if ((before & 1u) == 0) {
+                for (size_t i = 0; i < kFieldCount; ++i) {
+                    out[i] = values_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == before) {
+                    return out;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Only while the writer is quiescent (initialize / stream restart)
+    void reset() {
+        for (auto& value : values_) {
+            value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static constexpr size_t index(Field field) { return static_cast<size_t>(field); }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    std::array<std::atomic<uint64_t>, kFieldCount> values_{};
+};
+
+/**
+ * Whole-pipeline snapshot handed to the app
+ *
+ * Each stage is internally consistent; stages are sampled back to back,
+ * which at 1 Hz polling is well within one audio frame.
+ */
+struct TelemetrySnapshot {
+    uint64_t timestampMicros = 0;       // steady_clock when taken
+
+    struct {
+        uint64_t callbacks = 0;
+        uint64_t overruns = 0;          // Callback took longer than its burst
+        uint64_t droppedSamples = 0;    // Ring full, encoder fell behind
+        uint64_t ringHighWater = 0;     // samples
+        uint64_t maxCallbackMicros = 0;
+    } capture;
+
+    struct {
+        uint64_t framesEncoded = 0;
+        uint64_t bytesEncoded = 0;      // Opus output
+        uint64_t pcmBytes = 0;          // PCM input
+        uint64_t encodeErrors = 0;
+        uint64_t settingsChanges = 0;   // Rate controller retunes applied
+    } encode;
+
+    struct {
+        uint64_t packetsSent = 0;
+        uint64_t bytesSent = 0;         // RTP bytes, once per packet (not per destination)
+        uint64_t sendFailures = 0;      // Per destination
+    } send;
+
+    struct {
+        uint64_t packetsReceived = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t receiveBatches = 0;    // recvmmsg calls that returned data
+        uint64_t poolDrops = 0;
+    } receive;
+
+    struct {
+        uint64_t packetsReceived = 0;
+        uint64_t packetsLost = 0;
+        uint64_t packetsLate = 0;
+        uint64_t packetsDiscarded = 0;
+        uint64_t framesPlayed = 0;
+        uint64_t framesConcealed = 0;
+        uint64_t framesRecovered = 0;
+        uint64_t framesStretched = 0;
+        uint64_t jitterMs = 0;          // Worst active talker
+        uint64_t targetDelayMs = 0;
+        uint64_t currentDelayMs = 0;
+        uint64_t activeTalkers = 0;
+    } jitter;
+
+    struct {
+        uint64_t framesDecoded = 0;
+        uint64_t fecFrames = 0;         // Rebuilt from in-band FEC
+        uint64_t plcFrames = 0;
+        uint64_t decodeErrors = 0;
+        uint64_t chunksMixed = 0;       // Decode-ahead chunks queued to the ring
+        uint64_t ringHighWater = 0;     // samples
+    } decode;
+
+    struct {
+        uint64_t callbacks = 0;
+        uint64_t underrunEvents = 0;
+        uint64_t underrunSamples = 0;
+        std::array<uint64_t, kUnderrunHistogramBuckets> underrunHistogram{};
+    } playback;
+
+    struct {
+        uint64_t framesSuppressed = 0;  // Encoded but kept off the air
+        uint64_t bytesSuppressed = 0;   // Their wire size (payload + IP/UDP/RTP)
+        uint64_t suppressedMs = 0;      // Audio time not transmitted
+        uint64_t talkspurts = 0;        // Marker packets opening speech
+        uint64_t comfortNoiseFrames = 0;
+    } dtx;
+
+    struct {
+        uint64_t keyUps = 0;            // Capture sessions that produced a frame
+        uint64_t warmKeyUps = 0;        // Of those, capture stream already running
+        uint64_t lastTtffMicros = 0;    // startCapture() -> first encoded frame
+        uint64_t totalTtffMicros = 0;   // Sum, for the mean
+        uint64_t maxTtffMicros = 0;
+    } keyUp;
+
+    struct {
+        uint64_t reportsSent = 0;
+        uint64_t bytesSent = 0;         // Per report, not per destination
+        uint64_t reportsReceived = 0;
+        uint64_t malformed = 0;
+    } rtcp;
+
+    struct {
+        uint64_t captureGainPercent = 0;    // AGC linear gain, 100 = unity (0 before a frame)
+        uint64_t captureLimitedSamples = 0;
+        uint64_t playbackGainPercent = 0;
+        uint64_t playbackLimitedSamples = 0;
+        uint64_t captureDeviceRate = 0;     // Hz granted; != 16000 means resampled in the callback
+        uint64_t playbackDeviceRate = 0;
+    } dsp;
+
+    struct {
+        uint64_t keyEpoch = 0;              // MLS epoch of the installed key (0 also when off)
+        uint64_t rtpProtected = 0;
+        uint64_t rtpVerified = 0;
+        uint64_t authFailures = 0;          // RTP + RTCP that no installed key authenticates
+        uint64_t replayDrops = 0;
+        uint64_t previousEpochPackets = 0;  // Accepted under the previous epoch's keys
+    } srtp;
+
+    struct {
+        uint64_t state = 0;                 // FloorState: 0 idle, 1 pending, 2 granted, 3 taken
+        uint64_t holderSsrc = 0;            // Us while granted, 0 when free or off
+        uint64_t requests = 0;
+        uint64_t grants = 0;
+        uint64_t denials = 0;
+        uint64_t revocations = 0;
+        uint64_t lastGrantMicros = 0;       // Press -> grant of the latest grant
+    } floor;
+
+    struct {
+        uint64_t framesSent = 0;            // RED: earlier frames repeated
+        uint64_t bytesSent = 0;             // RED overhead: block headers + repeats
+        uint64_t duplicatesSent = 0;        // DUPLICATE: delayed second copies
+        uint64_t framesUsed = 0;            // RED copies that replaced a lost packet
+        uint64_t framesDiscarded = 0;       // RED copies not needed
+    } redundancy;
+
+    struct {
+        uint64_t role = 0;                  // RelayRole
+        uint64_t members = 0;               // Reflector: unicast-only members served
+        uint64_t packetsForwarded = 0;      // Per destination
+        uint64_t bytesForwarded = 0;
+        uint64_t duplicatesDropped = 0;     // RTP already forwarded via another path
+        uint64_t viaReflector = 0;          // Member: 1 while sending through a live reflector
+    } relay;
+
+    struct {
+        uint64_t mode = 0;                  // PowerMode
+        uint64_t activeMs = 0;              // Time spent per mode
+        uint64_t idleMs = 0;
+        uint64_t activeWakeups = 0;         // Pipeline thread wakeups per mode
+        uint64_t idleWakeups = 0;
+        uint64_t idleEntries = 0;
+    } power;
+
+    struct {
+        uint64_t bursts = 0;                // Ogg/Opus files opened
+        uint64_t packets = 0;               // Opus packets stored
+        uint64_t droppedPackets = 0;        // Block pool exhausted
+        uint64_t bytesWritten = 0;
+        uint64_t writes = 0;                // write() calls (large blocks)
+    } recording;
+
+    struct {
+        uint64_t budgetBytes = 0;
+        uint64_t reservedBytes = 0;         // Packet pool + stream arena
+        uint64_t streamSlots = 0;
+        uint64_t smallAvailable = 0;        // Free pool buffers per size class
+        uint64_t mtuAvailable = 0;
+        uint64_t poolExhausted = 0;         // acquire() found its class empty
+        uint64_t packetsCompacted = 0;      // Parked in SMALL buffers
+        uint64_t lateAllocations = 0;       // Arena requests after initialize
+    } memory;
+
+    struct {
+        uint64_t recoveries = 0;            // Streams reopened after Oboe closed them
+        uint64_t recoveryFailures = 0;      // Retries exhausted, session dropped
+        uint64_t routeChanges = 0;
+        uint64_t lastRecoveryMicros = 0;    // Loss (or route request) to restart
+        uint64_t maxRecoveryMicros = 0;
+        uint64_t totalRecoveryMicros = 0;
+        uint64_t recovering = 0;            // Bit 0 capture, bit 1 playback
+        uint64_t captureDeviceId = 0;       // AudioDeviceInfo ids the streams run on
+        uint64_t playbackDeviceId = 0;
+    } streams;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_TELEMETRY_H
@@ -0,0 +1,212 @@
+/*
+ * Mesh Rider Wave - Adaptive Opus Rate Controller Implementation
+ */
+
+#include "RateController.h"
+#include "PttLog.h"
+#include <algorithm>
+
+#define TAG "MeshRider:PTT-Rate"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// EWMA weight of each new loss observation
+constexpr float kLossSmoothing = 0.3f;
+
+// Fewer packets than this in an interval says nothing about the link
+constexpr uint64_t kMinLocalSamples = 10;
+
+// Opus accepts 6 kbps and up
+constexpr int kMinBitrate = 6000;
+
+} // namespace
+
+RateController::RateController() = default;
+
+void RateController::onReceiverReport(uint32_t reporterSsrc, float fractionLost,
+                                      uint32_t jitterMs, int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Same reporter, else an empty or the oldest slot
+    ReportState* slot = &reports_[0];
+    for (auto& report : reports_) {
+        if (report.receivedMs != 0 && report.ssrc == reporterSsrc) {
+            slot = &report;
+            break;
+        }
+        if (report.receivedMs < slot->receivedMs) {
+            slot = &report;
+        }
+    }
+
+    slot->ssrc = reporterSsrc;
+    slot->fractionLost = std::clamp(fractionLost, 0.0f, 1.0f);
+    slot->jitterMs = jitterMs;
+    slot->receivedMs = nowMs;
+}
+
+void RateController::onLocalStats(const JitterBufferStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Engine re-initialized: counters restarted
+    if (stats.packetsReceived < lastReceived_ || stats.packetsLost < lastLost_) {
+        lastReceived_ = stats.packetsReceived;
+        lastLost_ = stats.packetsLost;
+        haveLocal_ = false;
+        return;
+    }
+
+    const uint64_t received = stats.packetsReceived - lastReceived_;
+    const uint64_t lost = stats.packetsLost - lastLost_;
+
+    if (received + lost < kMinLocalSamples) {
+        // Nobody talking: no verdict, keep accumulating
+        haveLocal_ = false;
+        return;
+    }
+
+    lastReceived_ = stats.packetsReceived;
+    lastLost_ = stats.packetsLost;
+    localLoss_ = static_cast<float>(lost) / static_cast<float>(received + lost);
+    localJitterMs_ = stats.jitterMs;
+    haveLocal_ = true;
+}
+
+LinkTier RateController::tierForLink(float loss, uint32_t jitterMs, float margin) const {
+    for (size_t i = 0; i < kLinkTierCount; ++i) {
+        const TierProfile& profile = kTierProfiles[i];
+        if (loss <= profile.maxLoss * margin &&
+            static_cast<double>(jitterMs) <= static_cast<double>(profile.maxJitterMs) * margin) {
+            return static_cast<LinkTier>(i);
+        }
+    }
+    return LinkTier::SURVIVAL;
+}
+
+EncoderSettings RateController::settingsFor(LinkTier tier) const {
+    EncoderSettings settings = kTierProfiles[static_cast<size_t>(tier)].settings;
+    if (pinned_) {
+        settings = *pinned_;
+    }
+    if (bitrateCeiling_ > 0) {
+        settings.bitrate = std::max(kMinBitrate, std::min(settings.bitrate, bitrateCeiling_));
+    }
+    return settings;
+}
+
+std::optional<EncoderSettings> RateController::evaluate(int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const LinkTier previous = tier_;
+
+    // Pinned settings still track the link (tier, smoothed loss); only the
+    // step to the tier's settings is skipped
+    if (enabled_) {
+        // Worst of local observation and every fresh remote report
+        bool haveSample = haveLocal_;
+        float loss = haveLocal_ ? localLoss_ : 0.0f;
+        uint32_t jitterMs = haveLocal_ ? localJitterMs_ : 0;
+        for (const auto& report : reports_) {
+            if (report.receivedMs != 0 && nowMs - report.receivedMs <= kReceiverReportMaxAgeMs) {
+                haveSample = true;
+                loss = std::max(loss, report.fractionLost);
+                jitterMs = std::max(jitterMs, report.jitterMs);
+            }
+        }
+        haveLocal_ = false;
+
+        if (haveSample) {
+            smoothedLoss_ += kLossSmoothing * (loss - smoothedLoss_);
+
+            const LinkTier wanted = tierForLink(smoothedLoss_, jitterMs, 1.0f);
+
+            if (wanted > tier_) {
+                upgradeSinceMs_ = -1;
+                if (++degradeVotes_ >= kDegradeConfirmEvaluations) {
+                    tier_ = wanted;
+                    degradeVotes_ = 0;
+                }
+            } else {
+                degradeVotes_ = 0;
+                const LinkTier better = tierForLink(smoothedLoss_, jitterMs, kUpgradeMargin);
+                if (better < tier_) {
+                    if (upgradeSinceMs_ < 0) {
+                        upgradeSinceMs_ = nowMs;
+                    } else if (nowMs - upgradeSinceMs_ >= kUpgradeHoldMs) {
+                        // One rung at a time; the hold restarts for the next
+                        tier_ = static_cast<LinkTier>(static_cast<uint8_t>(tier_) - 1);
+                        upgradeSinceMs_ = nowMs;
+                    }
+                } else {
+                    upgradeSinceMs_ = -1;
+                }
+            }
+        }
+    }
+
+    const bool tierChanged = tier_ != previous && !pinned_;
+    if (!tierChanged && !settingsChanged_) {
+        return std::nullopt;
+    }
+    settingsChanged_ = false;
+
+    const EncoderSettings settings = settingsFor(tier_);
+    if (tierChanged) {
+        tierChanges_++;
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "Link tier %s -> %s (loss=%.1f%%): %d bps, fec=%d, loss=%d%%, cx=%d, %u ms",
+            kTierProfiles[static_cast<size_t>(previous)].name,
+            kTierProfiles[static_cast<size_t>(tier_)].name,
+            smoothedLoss_ * 100.0f, settings.bitrate, settings.fec ? 1 : 0,
+            settings.packetLossPercent, settings.complexity, settings.frameDurationMs);
+    }
+    return settings;
+}
+
+void RateController::setBitrateCeiling(int bitrate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bitrateCeiling_ = bitrate > 0 ? bitrate : 0;
+    settingsChanged_ = true;
+}
+
+void RateController::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = enabled;
+    degradeVotes_ = 0;
+    upgradeSinceMs_ = -1;
+}
+
+void RateController::pinSettings(const std::optional<EncoderSettings>& settings) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pinned_ == settings) {
+        return;
+    }
+    pinned_ = settings;
+    settingsChanged_ = true;
+}
+
+EncoderSettings RateController::getCurrentSettings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return settingsFor(tier_);
+}
+
+LinkTier RateController::getCurrentTier() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tier_;
+}
+
+float RateController::getSmoothedLoss() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return smoothedLoss_;
+}
+
+uint32_t RateController::getTierChanges() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tierChanges_;
+}
+
+} // namespace ptt
+} // namespace meshrider
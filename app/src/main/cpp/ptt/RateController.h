@@ -0,0 +1,166 @@
+/*
+ * Mesh Rider Wave - Adaptive Opus Rate Controller
+ * Retunes the encoder from receiver feedback as mesh link quality changes
+ *
+ * Inputs are loss/jitter observations: the local jitter buffers (inbound
+ * link, a proxy for the symmetric mesh path) and RTCP-style receiver
+ * reports from remote talkers. Output is one of a small ladder of encoder
+ * settings (bitrate, in-band FEC, expected loss, complexity, frame size).
+ *
+ * Hysteresis: degrading needs kDegradeConfirmEvaluations consecutive worse
+ * verdicts; recovering needs the link to stay clean for kUpgradeHoldMs and
+ * climbs one step at a time, against stricter "up" thresholds.
+ */
+
+#ifndef MESHRIDER_PTT_RATE_CONTROLLER_H
+#define MESHRIDER_PTT_RATE_CONTROLLER_H
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include "RtpPacketizer.h"
+
+namespace meshrider {
+namespace ptt {
+
+// How often the encoder thread lets the controller decide
+constexpr int64_t kRateEvaluateIntervalMs = 1000;
+
+// Consecutive worse verdicts before stepping down the ladder
+constexpr uint32_t kDegradeConfirmEvaluations = 2;
+
+// Link must stay better than the current tier this long before stepping up
+constexpr int64_t kUpgradeHoldMs = 5000;
+
+// Reports older than this no longer influence the decision
+constexpr int64_t kReceiverReportMaxAgeMs = 10000;
+
+/**
+ * Encoder settings applied as a unit
+ */
+struct EncoderSettings {
+    int bitrate;                // bps
+    bool fec;                   // Opus in-band FEC (LBRR)
+    int packetLossPercent;      // OPUS_SET_PACKET_LOSS_PERC hint
+    int complexity;             // 0-10
+    uint32_t frameDurationMs;   // 10, 20, 40 or 60
+
+    bool operator==(const EncoderSettings& other) const {
+        return bitrate == other.bitrate && fec == other.fec &&
+               packetLossPercent == other.packetLossPercent &&
+               complexity == other.complexity &&
+               frameDurationMs == other.frameDurationMs;
+    }
+    bool operator!=(const EncoderSettings& other) const { return !(*this == other); }
+};
+
+/**
+ * Link quality tiers, best first
+ * Longer frames under heavy loss/jitter cut packet rate (and header
+ * overhead / channel contention on the mesh) at the cost of latency.
+ */
+enum class LinkTier : uint8_t {
+    CLEAN = 0,
+    NOMINAL,
+    LOSSY,
+    DEGRADED,
+    SURVIVAL,
+};
+
+constexpr size_t kLinkTierCount = 5;
+
+struct TierProfile {
+    const char* name;
+    EncoderSettings settings;
+    float maxLoss;          // Enter this tier (or better) only while loss <= maxLoss
+    uint32_t maxJitterMs;   // ... and jitter <= maxJitterMs
+};
+
+// Stepping up requires loss/jitter below this fraction of the tier limits
+constexpr float kUpgradeMargin = 0.5f;
+
+constexpr std::array<TierProfile, kLinkTierCount> kTierProfiles = {{
+    { "clean",    { 16000, false,  1, 7, PttAudioFormat::kFrameDurationMs }, 0.01f,  20 },
+    { "nominal",  { 12000, true,   5, 5, PttAudioFormat::kFrameDurationMs }, 0.04f,  40 },
+    { "lossy",    { 12000, true,  15, 5, PttAudioFormat::kFrameDurationMs }, 0.10f,  60 },
+    { "degraded", { 10000, true,  25, 4, 40 }, 0.20f, 120 },
+    { "survival", {  8000, true,  40, 3, 60 }, 1.00f, UINT32_MAX },
+}};
+
+/**
+ * Loss/jitter driven encoder tuning
+ *
+ * Feedback may arrive from any thread; evaluate() is called periodically
+ * by the encoder thread, which applies the returned settings.
+ */
+class RateController {
+public:
+    RateController();
+
+    // Receiver report from a remote listener (RTCP RR semantics:
+    // fractionLost in [0,1] over its last interval, interarrival jitter in ms)
+    void onReceiverReport(uint32_t reporterSsrc, float fractionLost,
+                          uint32_t jitterMs, int64_t nowMs);
+
+    // Cumulative local jitter-buffer stats; the controller differences them
+    void onLocalStats(const JitterBufferStats& stats);
+
+    // Decide; returns new settings when the tier, ceiling or pin changed
+    std::optional<EncoderSettings> evaluate(int64_t nowMs);
+
+    // Manual cap from the app (nativeSetBitrate); 0 = no cap
+    void setBitrateCeiling(int bitrate);
+
+    // Disabled: hold the current tier, ignore feedback
+    void setEnabled(bool enabled);
+
+    // Fixed settings (codec profile) instead of the ladder, still under the
+    // bitrate ceiling; nullopt returns to the current tier. Picked up by the
+    // next evaluate().
+    void pinSettings(const std::optional<EncoderSettings>& settings);
+
+    EncoderSettings getCurrentSettings() const;
+    LinkTier getCurrentTier() const;
+    float getSmoothedLoss() const;
+    uint32_t getTierChanges() const;
+
+private:
+    EncoderSettings settingsFor(LinkTier tier) const;
+    LinkTier tierForLink(float loss, uint32_t jitterMs, float margin) const;
+
+    // Worst recent remote report (stale ones expire)
+    struct ReportState {
+        uint32_t ssrc = 0;
+        float fractionLost = 0.0f;
+        uint32_t jitterMs = 0;
+        int64_t receivedMs = 0;
+    };
+    static constexpr size_t kMaxReporters = 16;
+
+    mutable std::mutex mutex_;
+
+    std::array<ReportState, kMaxReporters> reports_{};
+
+    // Local stats deltas
+    uint64_t lastReceived_ = 0;
+    uint64_t lastLost_ = 0;
+    float localLoss_ = 0.0f;
+    uint32_t localJitterMs_ = 0;
+    bool haveLocal_ = false;
+
+    float smoothedLoss_ = 0.0f;
+    LinkTier tier_ = LinkTier::NOMINAL;
+    uint32_t degradeVotes_ = 0;
+    int64_t upgradeSinceMs_ = -1;
+    int bitrateCeiling_ = 0;
+    bool enabled_ = true;
+    std::optional<EncoderSettings> pinned_;
+    bool settingsChanged_ = false;      // Ceiling or pin moved since the last evaluate()
+    uint32_t tierChanges_ = 0;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_RATE_CONTROLLER_H
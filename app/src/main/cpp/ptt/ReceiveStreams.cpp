@@ -0,0 +1,617 @@
+/*
+ * Mesh Rider Wave - Per-SSRC Receive Streams Implementation
+ * Demux by SSRC, per-talker decode, saturating mix
+ * Loss recovery: FEC from the next packet when it is buffered, else PLC
+ * Scan channels: per-channel priority, lower channels ducked while a
+ * higher one is talking
+ * Recording tap: each routed payload is offered to the VoiceRecorder
+ * Quality: each released talker stream is scored against its channel's profile
+ */
+
+#include "ReceiveStreams.h"
+#include "VoiceRecorder.h"
+#include "PttLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#define TAG "MeshRider:PTT-Streams"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+int64_t monotonicMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t samplesToMicros(size_t samples) {
+    return static_cast<int64_t>(samples) * 1000000 / PttAudioFormat::kSampleRate;
+}
+
+constexpr uint64_t kDuckHangSamples =
+    static_cast<uint64_t>(kDuckHangMs) * PttAudioFormat::kSampleRate / 1000;
+
+int32_t gainToQ15(float gain) {
+    return static_cast<int32_t>(std::clamp(gain, 0.0f, 1.0f) * kUnityGainQ15 + 0.5f);
+}
+
+} // namespace
+
+ReceiveStreamTable::ReceiveStreamTable(uint32_t frameDurationMs, size_t memoryBudgetBytes)
+    : frameDurationMs_(frameDurationMs),
+      memoryBudgetBytes_(memoryBudgetBytes),
+      duckGainQ15_(gainToQ15(kDefaultDuckGain)) {
+}
+
+ReceiveStreamTable::~ReceiveStreamTable() {
+    // Slots live in the arena: run their destructors (queued packets go
+    // back to the pool) before it is released
+    for (ReceiveStream* stream : slots()) {
+        stream->~ReceiveStream();
+    }
+}
+
+size_t ReceiveStreamTable::streamSlotBytes() {
+    return MemoryArena::align(sizeof(ReceiveStream)) + MemoryArena::align(OpusDecoder::stateSize());
+}
+
+bool ReceiveStreamTable::initialize() {
+    if (pool_) {
+        return true;
+    }
+
+    MemoryDemand demand;
+    demand.maxStreams = kMaxReceiveStreams;
+    demand.bytesPerStream = streamSlotBytes();
+    demand.packetsPerStream = RtpJitterBuffer::kSlotCount;
+    const MemoryPlan plan = planMemory(memoryBudgetBytes_, demand);
+    if (plan.streams == 0) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Memory budget %zu bytes holds no receive stream", memoryBudgetBytes_);
+        return false;
+    }
+
+    // Every slot and decoder up front: assigning a new talker must not allocate
+    if (!arena_.reserve(plan.arenaBytes)) {
+        return false;
+    }
+    for (size_t i = 0; i < plan.streams; ++i) {
+        ReceiveStream* stream = arena_.create<ReceiveStream>(frameDurationMs_);
+        void* state = arena_.allocate(OpusDecoder::stateSize(), kArenaAlignment);
+        if (!stream) {
+            return false;
+        }
+        streams_[i] = stream;
+        streamCount_ = i + 1;
+        if (!stream->decoder.initialize(state)) {
+            __android_log_print(ANDROID_LOG_ERROR, TAG,
+                "Failed to create decoder for receive stream");
+            return false;
+        }
+    }
+    arena_.seal();
+    pool_ = std::make_shared<PacketPool>(plan.pool);
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Receive stream table ready: %zu streams, %zu of %zu KiB budget, idle timeout %lld ms",
+        streamCount_, plan.totalBytes / 1024, memoryBudgetBytes_ / 1024,
+        static_cast<long long>(kStreamIdleTimeoutMs));
+    return true;
+}
+
+MemoryStats ReceiveStreamTable::getMemoryStats() const {
+    MemoryStats stats;
+    stats.budgetBytes = memoryBudgetBytes_;
+    stats.streamSlots = streamCount_;
+    stats.lateAllocations = arena_.lateAllocations();
+    if (pool_) {
+        stats.pool = pool_->getStats();
+    }
+    stats.reservedBytes = stats.pool.bytes + arena_.capacity();
+    return stats;
+}
+
+// ============================================================================
+// Receive side (network thread)
+// ============================================================================
+
+void ReceiveStreamTable::enqueue(PacketPtr packet, const RtpPacketInfo& info) {
+    if (!pool_) {
+        return;  // Not initialized
+    }
+    const int64_t now = monotonicMicros();
+
+    if (recorder_) {
+        recorder_->onPacket(info, packet->payload(), packet->payloadLength);
+    }
+
+    // Parked for up to the playout delay: give the MTU buffer back
+    packet = pool_->compact(std::move(packet));
+
+    std::lock_guard<std::mutex> lock(assignMutex_);
+    evictIdle(now);
+
+    ReceiveStream* stream = findOrAssign(info.ssrc, info.channel, now);
+    stream->lastActivityMicros.store(now, std::memory_order_relaxed);
+    if (!info.redundant) {
+        trackFrameDuration(*stream, info);  // A RED copy's step is not the frame size
+    }
+    stream->jitterBuffer.enqueue(std::move(packet), info);
+}
+
+void ReceiveStreamTable::trackFrameDuration(ReceiveStream& stream, const RtpPacketInfo& info) {
+    // Consecutive sequence numbers: timestamp step is exactly one frame,
+    // unless the marker says the sender suppressed frames in between (DTX)
+    if (stream.haveLastPacket && !info.marker &&
+        static_cast<uint16_t>(info.seq - stream.lastSeq) == 1) {
+        const uint32_t stepMs =
+            PttAudioFormat::durationForRtpTicks(info.timestamp - stream.lastTimestamp);
+        if (stepMs != stream.frameDurationMs &&
+            (stepMs == 10 || stepMs == 20 || stepMs == 40 || stepMs == 60)) {
+            __android_log_print(ANDROID_LOG_DEBUG, TAG,
+                "SSRC 0x%08x frame duration %u -> %u ms",
+                info.ssrc, stream.frameDurationMs, stepMs);
+            stream.frameDurationMs = stepMs;
+            stream.jitterBuffer.setFrameDuration(stepMs);
+        }
+    }
+    stream.haveLastPacket = true;
+    stream.lastSeq = info.seq;
+    stream.lastTimestamp = info.timestamp;
+}
+
+void ReceiveStreamTable::enqueue(const uint8_t* payload, size_t size,
+                                 const RtpPacketInfo& info) {
+    if (size == 0 || size > kPooledPacketCapacity || !pool_) {
+        return;
+    }
+
+    PacketPtr packet = pool_->acquire(size);
+    if (!packet) {
+        return;  // Counted by the pool's exhausted counter
+    }
+
+    std::memcpy(packet->data, payload, size);
+    packet->length = static_cast<uint16_t>(size);
+    packet->payloadOffset = 0;
+    packet->payloadLength = static_cast<uint16_t>(size);
+    packet->timestamps = PacketTimestamps{};
+    packet->timestamps.receiveMicros = traceClockMicros();
+
+    enqueue(std::move(packet), info);
+}
+
+ReceiveStream* ReceiveStreamTable::findOrAssign(uint32_t ssrc, uint32_t channel,
+                                                int64_t nowMicros) {
+    ReceiveStream* freeSlot = nullptr;
+    ReceiveStream* lruSlot = nullptr;
+
+    for (ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed)) {
+            if (stream->ssrc.load(std::memory_order_relaxed) == ssrc &&
+                stream->channel.load(std::memory_order_relaxed) == channel) {
+                return stream;
+            }
+            if (!lruSlot || stream->lastActivityMicros.load(std::memory_order_relaxed) <
+                            lruSlot->lastActivityMicros.load(std::memory_order_relaxed)) {
+                lruSlot = stream;
+            }
+        } else if (!freeSlot) {
+            freeSlot = stream;
+        }
+    }
+
+    ReceiveStream* slot = freeSlot;
+    if (!slot) {
+        // Table full: recycle the least recently heard talker
+        slot = lruSlot;
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "Stream table full, evicting SSRC 0x%08x for 0x%08x",
+            slot->ssrc.load(std::memory_order_relaxed), ssrc);
+        release(*slot);
+        streamsEvicted_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    slot->ssrc.store(ssrc, std::memory_order_relaxed);
+    slot->channel.store(channel, std::memory_order_relaxed);
+    const ChannelConfig& config = channelConfigLocked(channel);
+    const CodecProfile& profile = kCodecProfiles[config.profile];
+    slot->priority.store(config.priority, std::memory_order_relaxed);
+    slot->jitterBuffer.setDelayBounds(profile.minDelayMs, profile.maxDelayMs);
+    slot->lastActivityMicros.store(nowMicros, std::memory_order_relaxed);
+    slot->generation.fetch_add(1, std::memory_order_release);
+    slot->active.store(true, std::memory_order_release);
+
+    __android_log_print(ANDROID_LOG_DEBUG, TAG,
+        "New receive stream: SSRC 0x%08x on channel %u", ssrc, channel);
+    return slot;
+}
+
+const ReceiveStreamTable::ChannelConfig&
+ReceiveStreamTable::channelConfigLocked(uint32_t channel) const {
+    static const ChannelConfig kDefaults{};
+    for (const auto& entry : channelConfigs_) {
+        if (entry.used && entry.channel == channel) {
+            return entry;
+        }
+    }
+    return kDefaults;
+}
+
+ReceiveStreamTable::ChannelConfig* ReceiveStreamTable::claimChannelLocked(uint32_t channel) {
+    ChannelConfig* entry = nullptr;
+    for (auto& candidate : channelConfigs_) {
+        if (candidate.used && candidate.channel == channel) {
+            return &candidate;
+        }
+        if (!candidate.used && !entry) {
+            entry = &candidate;
+        }
+    }
+    if (entry) {
+        *entry = ChannelConfig{};
+        entry->channel = channel;
+        entry->used = true;
+    }
+    return entry;
+}
+
+void ReceiveStreamTable::evictIdle(int64_t nowMicros) {
+    const int64_t timeoutMicros = kStreamIdleTimeoutMs * 1000;
+
+    for (ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed) &&
+            nowMicros - stream->lastActivityMicros.load(std::memory_order_relaxed) > timeoutMicros) {
+            release(*stream);
+            streamsEvicted_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ReceiveStreamTable::release(ReceiveStream& stream) {
+    stream.active.store(false, std::memory_order_release);
+
+    if (qualityMonitor_) {
+        const uint32_t channel = stream.channel.load(std::memory_order_relaxed);
+        qualityMonitor_->recordStream(channelConfigLocked(channel).profile,
+                                      stream.jitterBuffer.getStats(), stream.frameDurationMs);
+    }
+
+    // Published counters outlive the reset, so the aggregate keeps the departed talker
+    stream.jitterBuffer.reset();
+    stream.haveLastPacket = false;
+    // Decoder thread resets the decoder when it sees the new generation
+    stream.generation.fetch_add(1, std::memory_order_release);
+}
+
+void ReceiveStreamTable::reset() {
+    std::lock_guard<std::mutex> lock(assignMutex_);
+    for (ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed)) {
+            release(*stream);
+        }
+    }
+}
+
+// ============================================================================
+// Scan channels
+// ============================================================================
+
+void ReceiveStreamTable::setChannelPriority(uint32_t channel, uint8_t priority) {
+    std::lock_guard<std::mutex> lock(assignMutex_);
+
+    ChannelConfig* entry = claimChannelLocked(channel);
+    if (!entry) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Channel table full, channel %u keeps the default priority", channel);
+        return;
+    }
+    entry->priority = priority;
+
+    for (ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed) &&
+            stream->channel.load(std::memory_order_relaxed) == channel) {
+            stream->priority.store(priority, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ReceiveStreamTable::releaseChannel(uint32_t channel) {
+    std::lock_guard<std::mutex> lock(assignMutex_);
+
+    // Talkers first: each is scored against the profile still in place
+    for (ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed) &&
+            stream->channel.load(std::memory_order_relaxed) == channel) {
+            release(*stream);
+        }
+    }
+    for (auto& entry : channelConfigs_) {
+        if (entry.used && entry.channel == channel) {
+            entry = ChannelConfig{};
+        }
+    }
+}
+
+bool ReceiveStreamTable::setChannelProfile(uint32_t channel, size_t profile) {
+    if (profile >= kCodecProfileCount) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(assignMutex_);
+
+    ChannelConfig* entry = claimChannelLocked(channel);
+    if (!entry) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Channel table full, channel %u keeps the default profile", channel);
+        return false;
+    }
+    if (entry->profile == profile) {
+        return true;
+    }
+
+    // Live talkers are scored against the old profile and restart under the
+    // new bounds with their next packet, so no score mixes two profiles
+    for (ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed) &&
+            stream->channel.load(std::memory_order_relaxed) == channel) {
+            release(*stream);
+        }
+    }
+    entry->profile = profile;
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Channel %u codec profile %s", channel, kCodecProfiles[profile].name);
+    return true;
+}
+
+size_t ReceiveStreamTable::getChannelProfile(uint32_t channel) const {
+    std::lock_guard<std::mutex> lock(assignMutex_);
+    return channelConfigLocked(channel).profile;
+}
+
+void ReceiveStreamTable::setDuckingGain(float gain) {
+    duckGainQ15_.store(gainToQ15(gain), std::memory_order_relaxed);
+}
+
+size_t ReceiveStreamTable::getActiveChannels(uint32_t* channels, size_t maxChannels) const {
+    std::lock_guard<std::mutex> lock(assignMutex_);
+
+    size_t count = 0;
+    for (const ReceiveStream* stream : slots()) {
+        if (!stream->active.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        const uint32_t channel = stream->channel.load(std::memory_order_relaxed);
+        if (std::find(channels, channels + count, channel) == channels + count &&
+            count < maxChannels) {
+            channels[count++] = channel;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Decode side (decoder thread)
+// ============================================================================
+
+size_t ReceiveStreamTable::renderStream(ReceiveStream& stream, int16_t* out,
+                                        size_t numFrames, DecodeStats& tally,
+                                        int64_t playoutMicros) {
+    const bool tracing = playoutMicros > 0 && tracer_ && tracer_->isEnabled();
+
+    // Slot was reassigned or released since we last decoded from it
+    const uint32_t generation = stream.generation.load(std::memory_order_acquire);
+    if (generation != stream.playbackGeneration) {
+        stream.decoder.reset();
+        stream.pcmPos = 0;
+        stream.pcmLen = 0;
+        stream.lastFrameSamples = 0;
+        stream.pendingPacket.reset();
+        stream.mixGainQ15 = kUnityGainQ15;
+        stream.audible = false;
+        stream.playbackGeneration = generation;
+    }
+
+    size_t written = 0;
+    while (written < numFrames) {
+        if (stream.pcmPos == stream.pcmLen) {
+            PacketPtr packet;
+            JitterResult result;
+            if (stream.pendingPacket) {
+                // Second half of a RECOVER: the packet whose FEC was just used
+                packet = std::move(stream.pendingPacket);
+                result = JitterResult::PACKET;
+            } else {
+                result = stream.jitterBuffer.dequeue(packet);
+            }
+            if (result == JitterResult::BUFFERING) {
+                break;
+            }
+
+            int decoded = -1;
+            if (result == JitterResult::RECOVER) {
+                // Lost frame N, packet N+1 in hand: rebuild N from N+1's LBRR
+                const int size = static_cast<int>(packet->payloadLength);
+                if (OpusDecoder::hasFEC(packet->payload(), size)) {
+                    decoded = stream.decoder.decodeFEC(packet->payload(), size,
+                                                        stream.pcm.data(), OPUS_MAX_FRAME_SIZE);
+                }
+                stream.jitterBuffer.noteRecovery(decoded > 0);
+                if (decoded > 0) {
+                    tally.fecFrames++;
+                }
+                stream.pendingPacket = std::move(packet);
+            } else if (result == JitterResult::PACKET) {
+                const int64_t dequeueMicros = tracing ? traceClockMicros() : 0;
+                decoded = stream.decoder.decode(packet->payload(),
+                                                 static_cast<int>(packet->payloadLength),
+                                                 stream.pcm.data(), OPUS_MAX_FRAME_SIZE);
+                if (decoded > 0) {
+                    tally.framesDecoded++;
+                    if (tracing) {
+                        RxFrameTrace trace;
+                        trace.receiveMicros = packet->timestamps.receiveMicros;
+                        trace.dequeueMicros = dequeueMicros;
+                        trace.decodeMicros = traceClockMicros();
+                        trace.renderMicros = playoutMicros + samplesToMicros(written);
+                        trace.transitMicros = packet->timestamps.transitMicros;
+                        trace.senderCaptureToSendMicros = packet->timestamps.senderCaptureToSendMicros;
+                        trace.hasSenderStamps = packet->timestamps.hasSenderStamps;
+                        tracer_->recordRx(trace);
+                    }
+                } else {
+                    tally.decodeErrors++;
+                }
+            }
+            if (decoded <= 0) {
+                // Lost slot without FEC, stretch frame, or decode error: PLC one sender frame
+                const int plcSamples = stream.lastFrameSamples > 0 ?
+                    static_cast<int>(stream.lastFrameSamples) : OPUS_FRAME_SIZE;
+                decoded = stream.decoder.decodePLC(stream.pcm.data(), plcSamples);
+                if (decoded > 0) {
+                    tally.plcFrames++;
+                }
+            } else {
+                stream.lastFrameSamples = static_cast<size_t>(decoded);
+            }
+            if (decoded <= 0) {
+                break;
+            }
+            stream.pcmPos = 0;
+            stream.pcmLen = static_cast<size_t>(decoded);
+        }
+
+        const size_t n = std::min(numFrames - written, stream.pcmLen - stream.pcmPos);
+        std::memcpy(out + written, stream.pcm.data() + stream.pcmPos, n * sizeof(int16_t));
+        stream.pcmPos += n;
+        written += n;
+    }
+
+    return written;
+}
+
+size_t ReceiveStreamTable::render(int16_t* output, size_t numFrames, int64_t playoutMicros) {
+    std::memset(output, 0, numFrames * sizeof(int16_t));
+
+    int16_t scratch[kMaxRenderFrames];
+    uint32_t contributedMask = 0;
+    DecodeStats tally;
+
+    // Highest priority heard within the hang time; everything below is ducked.
+    // Decided from earlier passes so each talker is decoded straight into the mix.
+    uint8_t floorPriority = 0;
+    for (const ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_acquire) && stream->audible &&
+            renderedSamples_ - stream->lastAudibleSample <= kDuckHangSamples) {
+            floorPriority = std::max(floorPriority,
+                                     stream->priority.load(std::memory_order_relaxed));
+        }
+    }
+    const int32_t duckGainQ15 = duckGainQ15_.load(std::memory_order_relaxed);
+
+    for (size_t offset = 0; offset < numFrames; offset += kMaxRenderFrames) {
+        const size_t chunk = std::min(kMaxRenderFrames, numFrames - offset);
+
+        for (size_t i = 0; i < streamCount_; ++i) {
+            ReceiveStream& stream = *streams_[i];
+            if (!stream.active.load(std::memory_order_acquire)) {
+                continue;
+            }
+
+            const size_t n = renderStream(stream, scratch, chunk, tally,
+                playoutMicros > 0 ? playoutMicros + samplesToMicros(offset) : 0);
+            if (n > 0) {
+                // Sum into the mix; a stream that ran dry contributes silence after n
+                const int32_t gainQ15 =
+                    stream.priority.load(std::memory_order_relaxed) < floorPriority ?
+                    duckGainQ15 : kUnityGainQ15;
+                if (!stream.audible) {
+                    stream.mixGainQ15 = gainQ15;    // New talker starts at its level
+                }
+                if (gainQ15 == stream.mixGainQ15) {
+                    mixSaturatingGain(output + offset, scratch, n, gainQ15);
+                } else {
+                    mixSaturatingRamp(output + offset, scratch, n, stream.mixGainQ15, gainQ15);
+                    stream.mixGainQ15 = gainQ15;
+                }
+                stream.audible = true;
+                stream.lastAudibleSample = renderedSamples_ + offset + n;
+                contributedMask |= 1u << i;
+            }
+        }
+    }
+    renderedSamples_ += numFrames;
+
+    // One seqlock update per pass, not per frame
+    if (tally.framesDecoded | tally.fecFrames | tally.plcFrames | tally.decodeErrors) {
+        decodeTelemetry_.beginUpdate();
+        decodeTelemetry_.add(DecodeField::FRAMES_DECODED, tally.framesDecoded);
+        decodeTelemetry_.add(DecodeField::FEC_FRAMES, tally.fecFrames);
+        decodeTelemetry_.add(DecodeField::PLC_FRAMES, tally.plcFrames);
+        decodeTelemetry_.add(DecodeField::DECODE_ERRORS, tally.decodeErrors);
+        decodeTelemetry_.endUpdate();
+    }
+
+    return static_cast<size_t>(__builtin_popcount(contributedMask));
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+ReceiveStreamTable::DecodeStats ReceiveStreamTable::getDecodeStats() const {
+    using Decode = TelemetryBlock<DecodeField>;
+    const auto decode = decodeTelemetry_.snapshot();
+
+    DecodeStats stats;
+    stats.framesDecoded = decode[Decode::index(DecodeField::FRAMES_DECODED)];
+    stats.fecFrames = decode[Decode::index(DecodeField::FEC_FRAMES)];
+    stats.plcFrames = decode[Decode::index(DecodeField::PLC_FRAMES)];
+    stats.decodeErrors = decode[Decode::index(DecodeField::DECODE_ERRORS)];
+    return stats;
+}
+
+JitterBufferStats ReceiveStreamTable::getAggregateJitterStats() const {
+    // Lock-free: each slot's seqlocked counters, never assignMutex_ or a
+    // jitter buffer's mutex, so pollers do not stall receive or decode
+    JitterBufferStats total{};
+    for (const ReceiveStream* stream : slots()) {
+        const JitterBufferStats s = stream->jitterBuffer.getPublishedStats();
+        total.packetsReceived += s.packetsReceived;
+        total.packetsLost += s.packetsLost;
+        total.packetsLate += s.packetsLate;
+        total.packetsDiscarded += s.packetsDiscarded;
+        total.framesPlayed += s.framesPlayed;
+        total.framesConcealed += s.framesConcealed;
+        total.framesRecovered += s.framesRecovered;
+        total.framesStretched += s.framesStretched;
+        total.redundantUsed += s.redundantUsed;
+        total.redundantDiscarded += s.redundantDiscarded;
+
+        // Delay/jitter: report the worst active talker
+        if (stream->active.load(std::memory_order_relaxed)) {
+            total.jitterMs = std::max(total.jitterMs, s.jitterMs);
+            total.targetDelayMs = std::max(total.targetDelayMs, s.targetDelayMs);
+            total.currentDelayMs = std::max(total.currentDelayMs, s.currentDelayMs);
+        }
+    }
+
+    return total;
+}
+
+size_t ReceiveStreamTable::getActiveStreamCount() const {
+    size_t count = 0;
+    for (const ReceiveStream* stream : slots()) {
+        if (stream->active.load(std::memory_order_relaxed)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,242 @@
+/*
+ * Mesh Rider Wave - Per-SSRC Receive Streams
+ * One jitter buffer + Opus decoder per talker, mixed at playback
+ *
+ * When two radios key up together (late floor release, emergency override)
+ * each SSRC keeps its own decoder state instead of interleaving two Opus
+ * streams into one decoder.
+ *
+ * Memory is bounded: stream slots and the packet pool are reserved at
+ * initialize() from the memory budget (MemoryBudget.h), each slot with its
+ * decoder state in one arena. Idle slots time out; when all slots are busy
+ * the least recently used one is recycled for the new talker.
+ *
+ * Packets arrive as pooled buffers and are owned by the jitter buffer until
+ * the decoder thread decodes them; the table owns the shared PacketPool.
+ * Voice packets are moved to SMALL buffers as they are parked.
+ *
+ * Streams are keyed by (channel, SSRC) so scan channels mix into the same
+ * output. Each channel has a priority: while a higher-priority channel has
+ * been heard within kDuckHangMs, lower-priority talkers are ducked to the
+ * ducking gain (0 = strict priority scan, muted) with a one-pass ramp.
+ *
+ * An optional VoiceRecorder sees every packet as it is routed, keyed the same way.
+ *
+ * Each channel also has a codec profile (CallQuality.h): its jitter delay
+ * bounds apply to the channel's talkers, and each talker stream is scored
+ * against it by the CallQualityMonitor when the stream is released.
+ */
+
+#ifndef MESHRIDER_PTT_RECEIVE_STREAMS_H
+#define MESHRIDER_PTT_RECEIVE_STREAMS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include "AudioMixer.h"
+#include "RtpPacketizer.h"
+#include "OpusCodec.h"
+#include "PacketPool.h"
+#include "MemoryBudget.h"
+#include "PttTelemetry.h"
+#include "LatencyTracer.h"
+#include "CallQuality.h"
+
+namespace meshrider {
+namespace ptt {
+
+class VoiceRecorder;
+
+// Concurrent talkers kept decoded; 50+ member groups rarely exceed a few
+constexpr size_t kMaxReceiveStreams = 8;
+
+// Stream released after this long without packets
+constexpr int64_t kStreamIdleTimeoutMs = 3000;
+
+// Channel priority when none was set; higher wins the mix
+constexpr uint8_t kDefaultChannelPriority = 1;
+
+// Ducking holds this long after the higher-priority talker was last heard,
+// so a pause between overs does not let the lower channels blare through
+constexpr int64_t kDuckHangMs = 600;
+
+// Lower-priority channels while ducked: -12 dB
+constexpr float kDefaultDuckGain = 0.25f;
+
+// Largest render request handled in one pass (larger requests are chunked)
+constexpr size_t kMaxRenderFrames = 1024;
+
+// Decoder-thread telemetry (published once per render pass)
+enum class DecodeField : size_t {
+    FRAMES_DECODED, FEC_FRAMES, PLC_FRAMES, DECODE_ERRORS, COUNT
+};
+
+/**
+ * State for one remote talker (SSRC)
+ *
+ * Receive-thread fields are atomics; the decoder and PCM staging buffer are
+ * touched only by the decoder thread.
+ */
+struct ReceiveStream {
+    explicit ReceiveStream(uint32_t initialFrameDurationMs)
+        : jitterBuffer(initialFrameDurationMs), frameDurationMs(initialFrameDurationMs) {}
+
+    // Written by receive thread
+    std::atomic<bool> active{false};
+    std::atomic<uint32_t> ssrc{0};
+    std::atomic<uint32_t> channel{kHomeChannel};
+    std::atomic<uint8_t> priority{kDefaultChannelPriority};
+    std::atomic<int64_t> lastActivityMicros{0};
+    std::atomic<uint32_t> generation{0};    // Bumped each time the slot is reassigned
+
+    RtpJitterBuffer jitterBuffer;           // Internally locked
+
+    // Receive thread only: sender frame size, inferred from RTP timestamp steps
+    uint32_t frameDurationMs;
+    bool haveLastPacket = false;
+    uint16_t lastSeq = 0;
+    uint32_t lastTimestamp = 0;
+
+    // Decoder thread only (state in the table's arena)
+    OpusDecoder decoder;
+    uint32_t playbackGeneration = 0;
+    std::array<int16_t, OPUS_MAX_FRAME_SIZE> pcm{};
+    size_t pcmPos = 0;
+    size_t pcmLen = 0;
+    size_t lastFrameSamples = 0;            // PLC length follows the sender's frame size
+    PacketPtr pendingPacket;                // After a RECOVER: decoded on the next refill
+    int32_t mixGainQ15 = kUnityGainQ15;     // Gain applied last pass
+    bool audible = false;                   // Produced audio since assigned
+    uint64_t lastAudibleSample = 0;         // Table render clock at its last audio
+};
+
+/**
+ * Fixed-size (channel, SSRC) -> ReceiveStream table with LRU/timeout eviction
+ */
+class ReceiveStreamTable {
+public:
+    explicit ReceiveStreamTable(uint32_t frameDurationMs,
+                                size_t memoryBudgetBytes = kDefaultMemoryBudgetBytes);
+    ~ReceiveStreamTable();
+
+    // Reserve the pool and every stream slot with its decoder; false if the
+    // budget holds no slot or a reservation fails. Nothing is allocated after.
+    bool initialize();
+
+    // Arena bytes of one stream slot (ReceiveStream + decoder state)
+    static size_t streamSlotBytes();
+
+    // Receive thread: route packet (payload located) to its talker's jitter buffer
+    void enqueue(PacketPtr packet, const RtpPacketInfo& info);
+
+    // Copying ingress for callers without a pooled buffer (Kotlin socket path).
+    // Drops the payload if the pool is exhausted.
+    void enqueue(const uint8_t* payload, size_t size, const RtpPacketInfo& info);
+
+    // Pool backing all queued packets; hand to RtpPacketizer for zero-copy
+    // receive. Null before initialize().
+    std::shared_ptr<PacketPool> getPacketPool() const { return pool_; }
+
+    // Decoder thread: decode every active stream and mix into output.
+    // Returns the number of streams that contributed audio. playoutMicros is
+    // the traceClockMicros() at which output[0] reaches the playback callback
+    // (0 = unknown; frames are then not traced).
+    size_t render(int16_t* output, size_t numFrames, int64_t playoutMicros = 0);
+
+    // Receives RX frame traces while tracing is enabled; set before rendering starts
+    void setLatencyTracer(LatencyTracer* tracer) { tracer_ = tracer; }
+
+    // Receives every routed payload (it checks its own enabled state); set
+    // before receiving starts, must outlive the table
+    void setRecorder(VoiceRecorder* recorder) { recorder_ = recorder; }
+
+    // Scores each talker stream as it is released; set before receiving
+    // starts, must outlive the table
+    void setQualityMonitor(CallQualityMonitor* monitor) { qualityMonitor_ = monitor; }
+
+    // Release all streams (e.g. on playback start)
+    void reset();
+
+    // Scan mixing. Priority applies to current and future talkers on the
+    // channel; releaseChannel() drops its talkers and forgets the priority
+    // and profile. Gain is linear, clamped to [0, 1].
+    void setChannelPriority(uint32_t channel, uint8_t priority);
+    void releaseChannel(uint32_t channel);
+
+    // Index into kCodecProfiles; its delay bounds apply to the channel's
+    // talkers (live ones are released and restart under it). False if out
+    // of range or the channel table is full.
+    bool setChannelProfile(uint32_t channel, size_t profile);
+    size_t getChannelProfile(uint32_t channel) const;
+    void setDuckingGain(float gain);
+
+    // Distinct channels with an active talker; returns the count written
+    size_t getActiveChannels(uint32_t* channels, size_t maxChannels) const;
+
+    // Statistics (lock-free; counters include released streams)
+    JitterBufferStats getAggregateJitterStats() const;
+    size_t getActiveStreamCount() const;
+    struct DecodeStats {
+        uint64_t framesDecoded = 0;
+        uint64_t fecFrames = 0;        // Lost frames rebuilt from the next packet's FEC
+        uint64_t plcFrames = 0;        // Concealment frames synthesized
+        uint64_t decodeErrors = 0;
+    };
+    DecodeStats getDecodeStats() const;
+    uint64_t getStreamsEvicted() const { return streamsEvicted_.load(std::memory_order_relaxed); }
+    MemoryStats getMemoryStats() const;
+
+private:
+    ReceiveStream* findOrAssign(uint32_t ssrc, uint32_t channel, int64_t nowMicros);
+    struct ChannelConfig;
+    const ChannelConfig& channelConfigLocked(uint32_t channel) const;
+    ChannelConfig* claimChannelLocked(uint32_t channel);
+    void evictIdle(int64_t nowMicros);
+    void release(ReceiveStream& stream);
+    void trackFrameDuration(ReceiveStream& stream, const RtpPacketInfo& info);
+
+    // Pull from one stream into out until numFrames or the stream runs dry
+    size_t renderStream(ReceiveStream& stream, int16_t* out, size_t numFrames,
+                        DecodeStats& tally, int64_t playoutMicros);
+
+    // Slots reserved at initialize()
+    std::span<ReceiveStream* const> slots() const { return {streams_.data(), streamCount_}; }
+
+    const uint32_t frameDurationMs_;
+    const size_t memoryBudgetBytes_;
+
+    // Declared before the arena so it is destroyed after every queued packet
+    std::shared_ptr<PacketPool> pool_;
+    MemoryArena arena_;
+    std::array<ReceiveStream*, kMaxReceiveStreams> streams_{};   // In arena_
+    size_t streamCount_ = 0;
+
+    // Serializes slot assignment (receive thread vs reset); never taken by the decoder
+    mutable std::mutex assignMutex_;
+
+    // Channels with a non-default priority or profile (guarded by assignMutex_)
+    struct ChannelConfig {
+        uint32_t channel = 0;
+        uint8_t priority = kDefaultChannelPriority;
+        size_t profile = kDefaultCodecProfile;
+        bool used = false;
+    };
+    std::array<ChannelConfig, kMaxChannels> channelConfigs_{};
+
+    std::atomic<int32_t> duckGainQ15_;
+    uint64_t renderedSamples_ = 0;          // Decoder thread: ducking hang clock
+
+    TelemetryBlock<DecodeField> decodeTelemetry_;
+    LatencyTracer* tracer_ = nullptr;
+    VoiceRecorder* recorder_ = nullptr;
+    CallQualityMonitor* qualityMonitor_ = nullptr;
+    std::atomic<uint64_t> streamsEvicted_{0};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_RECEIVE_STREAMS_H
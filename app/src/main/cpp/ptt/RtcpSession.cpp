@@ -0,0 +1,669 @@
+/*
+ * Mesh Rider Wave - RTCP Session Implementation
+ */
+
+#include "RtcpSession.h"
+#include "RtpPacketizer.h"
+#include "LatencyTracer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// RFC 3550 A.1 sequence validation
+constexpr uint32_t kMaxDropout = 3000;
+constexpr uint32_t kMaxMisorder = 100;
+constexpr uint32_t kSeqMod = 1u << 16;
+
+// RFC 3550 6.3.1: compensates the randomization's bias toward short intervals
+constexpr float kRandomizationCompensation = 1.21828f;
+
+// Seconds between 1900 (NTP epoch) and 1970 (Unix epoch)
+constexpr uint32_t kNtpUnixOffsetSeconds = 2208988800u;
+
+constexpr size_t kReportBlockBytes = 24;
+constexpr size_t kSenderInfoBytes = 20;
+constexpr size_t kDlrrSubBlockBytes = 12;
+
+// Report blocks about our SSRC in one compound packet (one per part at most)
+constexpr size_t kMaxPendingReports = 4;
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v >> 8);
+    p[1] = static_cast<uint8_t>(v);
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+struct NtpTime {
+    uint32_t seconds;
+    uint32_t fraction;
+
+    // LSR / LRR / "A" in RFC 3550 6.4.1
+    uint32_t middle() const { return (seconds << 16) | (fraction >> 16); }
+};
+
+NtpTime ntpNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    NtpTime ntp;
+    ntp.seconds = static_cast<uint32_t>(ts.tv_sec) + kNtpUnixOffsetSeconds;
+    ntp.fraction = static_cast<uint32_t>((static_cast<uint64_t>(ts.tv_nsec) << 32) / 1000000000ULL);
+    return ntp;
+}
+
+// Microseconds -> 1/65536 s (DLSR / DLRR units)
+uint32_t toNtpShort(int64_t micros) {
+    return static_cast<uint32_t>(std::max<int64_t>(0, micros) * 65536 / 1000000);
+}
+
+// RFC 3550 6.4.1 round trip; -1 if the echo is unusable
+int32_t roundTripMs(uint32_t nowNtp, uint32_t lastNtp, uint32_t delayNtp) {
+    if (lastNtp == 0) {
+        return -1;
+    }
+    const int32_t rtt = static_cast<int32_t>(nowNtp - lastNtp - delayNtp);
+    if (rtt < 0) {
+        return -1;
+    }
+    return static_cast<int32_t>(static_cast<int64_t>(rtt) * 1000 / 65536);
+}
+
+uint32_t jitterUnitsToMs(uint32_t units) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(units) * 1000 / RTP_CLOCK_RATE);
+}
+
+} // namespace
+
+RtcpSession::RtcpSession() = default;
+
+void RtcpSession::setLocalSsrc(uint32_t ssrc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    localSsrc_ = ssrc;
+    random_ = ssrc ? ssrc : 0x9E3779B9u;
+}
+
+void RtcpSession::configure(const RtcpConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    config_.minIntervalMs = std::max(config_.minIntervalMs, kRtcpMinIntervalFloorMs);
+    config_.sessionBandwidthBps = std::max<uint32_t>(config_.sessionBandwidthBps, 1000);
+
+    // New rules start with a fresh (half) initial interval
+    initial_ = true;
+    nextReportMicros_ = 0;
+}
+
+RtcpConfig RtcpSession::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+bool RtcpSession::isRtcp(const uint8_t* data, size_t length) {
+    if (length < 8 || (data[0] >> 6) != 2) {
+        return false;
+    }
+    return data[1] >= 192 && data[1] <= 223;
+}
+
+// ============================================================================
+// Sender / receiver statistics
+// ============================================================================
+
+void RtcpSession::onRtpSent(size_t payloadBytes, uint32_t rtpTimestamp, int64_t nowMicros) {
+    senderPackets_.fetch_add(1, std::memory_order_relaxed);
+    senderOctets_.fetch_add(static_cast<uint32_t>(payloadBytes), std::memory_order_relaxed);
+    lastRtpTimestamp_.store(rtpTimestamp, std::memory_order_relaxed);
+    lastSendMicros_.store(nowMicros, std::memory_order_relaxed);
+}
+
+RtcpSession::Source* RtcpSession::findSource(uint32_t ssrc) {
+    for (auto& source : sources_) {
+        if (source.active && source.ssrc == ssrc) {
+            return &source;
+        }
+    }
+    return nullptr;
+}
+
+RtcpSession::Source* RtcpSession::findOrAddSource(uint32_t ssrc, int64_t nowMicros) {
+    if (Source* source = findSource(ssrc)) {
+        return source;
+    }
+    Source* slot = nullptr;
+    for (auto& source : sources_) {
+        if (!source.active) {
+            slot = &source;
+            break;
+        }
+        // Table full: replace whoever has been quiet longest
+        if (!slot || source.lastHeardMicros < slot->lastHeardMicros) {
+            slot = &source;
+        }
+    }
+    *slot = Source{};
+    slot->ssrc = ssrc;
+    slot->active = true;
+    slot->lastHeardMicros = nowMicros;
+    return slot;
+}
+
+void RtcpSession::removeSource(uint32_t ssrc) {
+    if (Source* source = findSource(ssrc)) {
+        *source = Source{};
+    }
+}
+
+void RtcpSession::updateSequence(Source& source, uint16_t seq) {
+    auto init = [&source](uint16_t s) {
+        source.baseSeq = s;
+        source.maxSeq = s;
+        source.badSeq = kSeqMod + 1;
+        source.cycles = 0;
+        source.received = 0;
+        source.receivedPrior = 0;
+        source.expectedPrior = 0;
+    };
+
+    if (!source.haveRtp) {
+        source.haveRtp = true;
+        init(seq);
+    } else {
+        const uint16_t delta = static_cast<uint16_t>(seq - source.maxSeq);
+        if (delta < kMaxDropout) {
+            if (seq < source.maxSeq) {
+                source.cycles += kSeqMod;   // Wrapped
+            }
+            source.maxSeq = seq;
+        } else if (delta <= kSeqMod - kMaxMisorder) {
+            // Big jump: a restarted sender if the next packet follows it
+            if (seq == source.badSeq) {
+                init(seq);
+            } else {
+                source.badSeq = (seq + 1u) & (kSeqMod - 1);
+                return;
+            }
+        }
+        // Else duplicate or reordered: counted, max unchanged
+    }
+    source.received++;
+}
+
+void RtcpSession::onRtpReceived(const RtpPacketInfo& info, int64_t arrivalMicros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Source* source = findOrAddSource(info.ssrc, arrivalMicros);
+    source->lastHeardMicros = arrivalMicros;
+    source->lastRtpMicros = arrivalMicros;
+    updateSequence(*source, info.seq);
+
+    // Interarrival jitter within a talkspurt; a key-up after idle restarts it
+    const uint32_t arrival = static_cast<uint32_t>(
+        arrivalMicros * static_cast<int64_t>(RTP_CLOCK_RATE) / 1000000);
+    const uint32_t transit = arrival - info.timestamp;
+    if (source->haveTransit && !info.marker) {
+        const int32_t d = static_cast<int32_t>(transit - source->lastTransit);
+        const int64_t magnitude = d < 0 ? -static_cast<int64_t>(d) : d;
+        source->jitterQ4 += magnitude - ((source->jitterQ4 + 8) >> 4);
+    }
+    source->haveTransit = true;
+    source->lastTransit = transit;
+}
+
+// ============================================================================
+// Receive
+// ============================================================================
+
+void RtcpSession::onReportBlock(const uint8_t* block, uint32_t reporterSsrc, uint32_t nowNtp,
+                                PendingReport* pending, size_t& pendingCount) {
+    if (get32(block) != localSsrc_) {
+        return;     // About some other sender
+    }
+    Source* reporter = findSource(reporterSsrc);
+    if (!reporter) {
+        return;
+    }
+
+    reporter->hasRemoteReport = true;
+    reporter->remoteFractionLost = block[4] / 256.0f;
+    reporter->remoteJitterMs = jitterUnitsToMs(get32(block + 12));
+    const int32_t rtt = roundTripMs(nowNtp, get32(block + 16), get32(block + 20));
+    if (rtt >= 0) {
+        reporter->rttMs = rtt;
+    }
+
+    if (pendingCount < kMaxPendingReports) {
+        pending[pendingCount++] = {reporterSsrc, reporter->remoteFractionLost,
+                                   reporter->remoteJitterMs};
+    }
+}
+
+void RtcpSession::parseExtendedReport(const uint8_t* body, size_t length, uint32_t reporterSsrc,
+                                      uint32_t nowNtp, int64_t nowMicros) {
+    Source* reporter = findSource(reporterSsrc);
+    size_t pos = 0;
+    while (reporter && pos + 4 <= length) {
+        const uint8_t blockType = body[pos];
+        const size_t blockBytes = 4 + static_cast<size_t>(get16(body + pos + 2)) * 4;
+        if (pos + blockBytes > length) {
+            return;
+        }
+        const uint8_t* block = body + pos;
+
+        if (blockType == 4 && blockBytes == 12) {
+            // Receiver Reference Time: echo it in our DLRR
+            reporter->lastRrtrNtp = (get32(block + 4) << 16) | (get32(block + 8) >> 16);
+            reporter->lastRrtrMicros = nowMicros;
+        } else if (blockType == 5) {
+            // DLRR: replies to the RRTR we sent
+            for (size_t sub = 4; sub + kDlrrSubBlockBytes <= blockBytes; sub += kDlrrSubBlockBytes) {
+                if (get32(block + sub) != localSsrc_) {
+                    continue;
+                }
+                const int32_t rtt = roundTripMs(nowNtp, get32(block + sub + 4),
+                                                get32(block + sub + 8));
+                if (rtt >= 0) {
+                    reporter->rttMs = rtt;
+                }
+            }
+        }
+        pos += blockBytes;
+    }
+}
+
+bool RtcpSession::onRtcpReceived(const uint8_t* data, size_t length, uint32_t fromAddress,
+                                 int64_t nowMicros) {
+    PendingReport pending[kMaxPendingReports];
+    size_t pendingCount = 0;
+    bool valid = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Our own compound packet looped back by the multicast group
+        if (length >= 8 && get32(data + 4) == localSsrc_) {
+            return true;
+        }
+        const uint32_t nowNtp = ntpNow().middle();
+
+        size_t pos = 0;
+        while (pos + 4 <= length) {
+            const uint8_t* header = data + pos;
+            if ((header[0] >> 6) != 2) {
+                valid = false;
+                break;
+            }
+            const size_t count = header[0] & 0x1F;
+            const uint8_t type = header[1];
+            const size_t packetBytes = (static_cast<size_t>(get16(header + 2)) + 1) * 4;
+            if (pos + packetBytes > length) {
+                valid = false;
+                break;
+            }
+
+            const uint32_t sender = packetBytes >= 8 ? get32(header + 4) : 0;
+            const bool fromUs = sender == localSsrc_;   // Multicast loopback
+
+            if (type == kRtcpSenderReport || type == kRtcpReceiverReport) {
+                const size_t fixed = type == kRtcpSenderReport ? 8 + kSenderInfoBytes : 8;
+                if (fixed + count * kReportBlockBytes > packetBytes) {
+                    valid = false;
+                    break;
+                }
+                if (!fromUs) {
+                    Source* source = findOrAddSource(sender, nowMicros);
+                    source->lastHeardMicros = nowMicros;
+                    source->address = fromAddress;
+                    if (type == kRtcpSenderReport) {
+                        source->lastSrNtp = (get32(header + 8) << 16) | (get32(header + 12) >> 16);
+                        source->lastSrMicros = nowMicros;
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        onReportBlock(header + fixed + i * kReportBlockBytes, sender, nowNtp,
+                                      pending, pendingCount);
+                    }
+                }
+            } else if (type == kRtcpBye) {
+                for (size_t i = 0; i < count && 8 + i * 4 <= packetBytes; ++i) {
+                    const uint32_t leaving = get32(header + 4 + i * 4);
+                    if (leaving != localSsrc_) {
+                        removeSource(leaving);
+                    }
+                }
+            } else if (type == kRtcpExtendedReport && packetBytes >= 8 && !fromUs) {
+                Source* source = findOrAddSource(sender, nowMicros);
+                source->lastHeardMicros = nowMicros;
+                source->address = fromAddress;
+                parseExtendedReport(header + 8, packetBytes - 8, sender, nowNtp, nowMicros);
+            }
+            // SDES and APP carry nothing the table needs
+
+            pos += packetBytes;
+        }
+
+        if (valid) {
+            reportsReceived_++;
+            avgRtcpSize_ += (static_cast<float>(length + kRtcpTransportOverheadBytes) -
+                             avgRtcpSize_) / 16.0f;
+        } else {
+            malformed_++;
+        }
+    }
+
+    if (reportCallback_) {
+        for (size_t i = 0; i < pendingCount; ++i) {
+            reportCallback_(pending[i].ssrc, pending[i].fractionLost, pending[i].jitterMs);
+        }
+    }
+    return valid;
+}
+
+// ============================================================================
+// Transmit
+// ============================================================================
+
+uint32_t RtcpSession::nextRandom() {
+    // xorshift32: scheduling jitter only, seeded per SSRC so members desynchronize
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 17;
+    random_ ^= random_ << 5;
+    return random_;
+}
+
+uint32_t RtcpSession::deterministicIntervalMsLocked(int64_t nowMicros) const {
+    size_t members = 1;
+    size_t senders = weSent_ ? 1 : 0;
+    const int64_t senderWindowMicros = 2 * static_cast<int64_t>(config_.minIntervalMs) * 1000;
+    for (const auto& source : sources_) {
+        if (!source.active) {
+            continue;
+        }
+        members++;
+        if (source.lastRtpMicros > 0 && nowMicros - source.lastRtpMicros < senderWindowMicros) {
+            senders++;
+        }
+    }
+
+    // RFC 3550 6.3.1: bytes per second for RTCP, split between senders and receivers
+    float bandwidth = config_.sessionBandwidthBps / 8.0f * kRtcpBandwidthFraction;
+    float sharing = static_cast<float>(members);
+    if (senders > 0 && senders <= members * kRtcpSenderBandwidthFraction) {
+        if (weSent_) {
+            bandwidth *= kRtcpSenderBandwidthFraction;
+            sharing = static_cast<float>(senders);
+        } else {
+            bandwidth *= 1.0f - kRtcpSenderBandwidthFraction;
+            sharing = static_cast<float>(members - senders);
+        }
+    }
+
+    const uint32_t minimumMs = initial_ ? config_.minIntervalMs / 2 : config_.minIntervalMs;
+    const float intervalMs = avgRtcpSize_ * sharing / bandwidth * 1000.0f;
+    return std::max(minimumMs, static_cast<uint32_t>(intervalMs));
+}
+
+void RtcpSession::scheduleNextLocked(int64_t nowMicros) {
+    const float spread = 0.5f + static_cast<float>(nextRandom() % 1000) / 1000.0f;
+    const float intervalMs = deterministicIntervalMsLocked(nowMicros) * spread / kRandomizationCompensation;
+    nextReportMicros_ = nowMicros + static_cast<int64_t>(intervalMs * 1000.0f);
+}
+
+int64_t RtcpSession::nextReportMicros() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nextReportMicros_;
+}
+
+void RtcpSession::expireSourcesLocked(int64_t nowMicros) {
+    const int64_t timeoutMicros = static_cast<int64_t>(kRtcpSourceTimeoutIntervals) *
+        std::max(deterministicIntervalMsLocked(nowMicros), config_.minIntervalMs) * 1000;
+    for (auto& source : sources_) {
+        if (source.active && nowMicros - source.lastHeardMicros > timeoutMicros) {
+            source = Source{};
+        }
+    }
+}
+
+size_t RtcpSession::writeReportLocked(uint8_t* out, size_t capacity, int64_t nowMicros, bool bye) {
+    const NtpTime ntp = ntpNow();
+    const uint32_t packets = senderPackets_.load(std::memory_order_relaxed);
+    weSent_ = packets != senderPacketsAtReport_;
+    senderPacketsAtReport_ = packets;
+
+    // Report blocks for every source whose RTP we are receiving
+    std::array<Source*, kMaxRtcpReportBlocks> reported{};
+    size_t blockCount = 0;
+    for (auto& source : sources_) {
+        if (source.active && source.haveRtp && blockCount < kMaxRtcpReportBlocks) {
+            reported[blockCount++] = &source;
+        }
+    }
+
+    const bool senderReport = weSent_ && !bye;
+    const size_t reportBytes = 8 + (senderReport ? kSenderInfoBytes : 0) +
+                               blockCount * kReportBlockBytes;
+    constexpr size_t kSdesBytes = 24;   // Header, SSRC, CNAME "mrw-xxxxxxxx", END + pad
+    if (reportBytes + kSdesBytes + 8 > capacity) {
+        return 0;
+    }
+
+    // SR or RR
+    uint8_t* p = out;
+    p[0] = static_cast<uint8_t>(0x80 | blockCount);
+    p[1] = senderReport ? kRtcpSenderReport : kRtcpReceiverReport;
+    put16(p + 2, static_cast<uint16_t>(reportBytes / 4 - 1));
+    put32(p + 4, localSsrc_);
+    size_t pos = 8;
+    if (senderReport) {
+        // RTP time of "now" extrapolated from the last packet sent
+        const int64_t sinceSend = nowMicros - lastSendMicros_.load(std::memory_order_relaxed);
+        const uint32_t rtpNow = lastRtpTimestamp_.load(std::memory_order_relaxed) +
+            static_cast<uint32_t>(std::max<int64_t>(0, sinceSend) *
+                                  static_cast<int64_t>(RTP_CLOCK_RATE) / 1000000);
+        put32(p + pos, ntp.seconds);
+        put32(p + pos + 4, ntp.fraction);
+        put32(p + pos + 8, rtpNow);
+        put32(p + pos + 12, packets);
+        put32(p + pos + 16, senderOctets_.load(std::memory_order_relaxed));
+        pos += kSenderInfoBytes;
+    }
+
+    for (size_t i = 0; i < blockCount; ++i) {
+        Source& source = *reported[i];
+        const uint32_t extendedMax = source.cycles + source.maxSeq;
+        const uint32_t expected = extendedMax - source.baseSeq + 1;
+        const int64_t lost = std::clamp<int64_t>(
+            static_cast<int64_t>(expected) - static_cast<int64_t>(source.received),
+            -0x800000, 0x7FFFFF);
+        const uint32_t expectedInterval = expected - source.expectedPrior;
+        const int64_t receivedInterval = static_cast<int64_t>(source.received - source.receivedPrior);
+        const int64_t lostInterval = static_cast<int64_t>(expectedInterval) - receivedInterval;
+        source.expectedPrior = expected;
+        source.receivedPrior = source.received;
+        source.fractionQ8 = (expectedInterval == 0 || lostInterval <= 0) ? 0 :
+            static_cast<uint8_t>(std::min<int64_t>(255, (lostInterval << 8) / expectedInterval));
+        source.cumulativeLost = static_cast<int32_t>(lost);
+
+        uint8_t* block = p + pos;
+        put32(block, source.ssrc);
+        put32(block + 4, (static_cast<uint32_t>(source.fractionQ8) << 24) |
+                         (static_cast<uint32_t>(lost) & 0xFFFFFF));
+        put32(block + 8, extendedMax);
+        put32(block + 12, static_cast<uint32_t>(source.jitterQ4 >> 4));
+        put32(block + 16, source.lastSrNtp);
+        put32(block + 20, source.lastSrNtp ? toNtpShort(nowMicros - source.lastSrMicros) : 0);
+        pos += kReportBlockBytes;
+    }
+
+    // SDES CNAME (RFC 3550 6.1: every compound packet carries one)
+    uint8_t* sdes = p + pos;
+    std::memset(sdes, 0, kSdesBytes);
+    sdes[0] = 0x81;
+    sdes[1] = kRtcpSourceDescription;
+    put16(sdes + 2, kSdesBytes / 4 - 1);
+    put32(sdes + 4, localSsrc_);
+    sdes[8] = 1;    // CNAME
+    sdes[9] = 12;
+    char cname[13];
+    std::snprintf(cname, sizeof(cname), "mrw-%08x", localSsrc_);
+    std::memcpy(sdes + 10, cname, 12);
+    pos += kSdesBytes;
+
+    if (bye) {
+        uint8_t* goodbye = p + pos;
+        goodbye[0] = 0x81;
+        goodbye[1] = kRtcpBye;
+        put16(goodbye + 2, 1);
+        put32(goodbye + 4, localSsrc_);
+        return pos + 8;
+    }
+
+    // XR: our reference time, plus DLRR replies to everyone's
+    if (config_.extendedReports) {
+        size_t replies = 0;
+        for (const auto& source : sources_) {
+            if (source.active && source.lastRrtrNtp) {
+                replies++;
+            }
+        }
+        const size_t dlrrBytes = replies ? 4 + replies * kDlrrSubBlockBytes : 0;
+        const size_t xrBytes = 8 + 12 + dlrrBytes;
+        if (pos + xrBytes <= capacity) {
+            uint8_t* xr = p + pos;
+            xr[0] = 0x80;
+            xr[1] = kRtcpExtendedReport;
+            put16(xr + 2, static_cast<uint16_t>(xrBytes / 4 - 1));
+            put32(xr + 4, localSsrc_);
+
+            uint8_t* rrtr = xr + 8;
+            rrtr[0] = 4;
+            rrtr[1] = 0;
+            put16(rrtr + 2, 2);
+            put32(rrtr + 4, ntp.seconds);
+            put32(rrtr + 8, ntp.fraction);
+
+            if (replies) {
+                uint8_t* dlrr = rrtr + 12;
+                dlrr[0] = 5;
+                dlrr[1] = 0;
+                put16(dlrr + 2, static_cast<uint16_t>(replies * 3));
+                size_t sub = 4;
+                for (const auto& source : sources_) {
+                    if (!source.active || !source.lastRrtrNtp) {
+                        continue;
+                    }
+                    put32(dlrr + sub, source.ssrc);
+                    put32(dlrr + sub + 4, source.lastRrtrNtp);
+                    put32(dlrr + sub + 8, toNtpShort(nowMicros - source.lastRrtrMicros));
+                    sub += kDlrrSubBlockBytes;
+                }
+            }
+            pos += xrBytes;
+        }
+    }
+    return pos;
+}
+
+size_t RtcpSession::buildReport(uint8_t* out, size_t capacity, int64_t nowMicros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nextReportMicros_ == 0) {
+        // First call only schedules: the initial report waits half an interval
+        scheduleNextLocked(nowMicros);
+        return 0;
+    }
+    if (nowMicros < nextReportMicros_) {
+        return 0;
+    }
+
+    expireSourcesLocked(nowMicros);
+    const size_t length = writeReportLocked(out, capacity, nowMicros, false);
+    if (length > 0) {
+        reportsSent_++;
+        bytesSent_ += length;
+        avgRtcpSize_ += (static_cast<float>(length + kRtcpTransportOverheadBytes) -
+                         avgRtcpSize_) / 16.0f;
+    }
+    initial_ = false;
+    scheduleNextLocked(nowMicros);
+    return length;
+}
+
+size_t RtcpSession::buildBye(uint8_t* out, size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t nowMicros = traceClockMicros();
+    const size_t length = writeReportLocked(out, capacity, nowMicros, true);
+    if (length > 0) {
+        reportsSent_++;
+        bytesSent_ += length;
+    }
+    return length;
+}
+
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+size_t RtcpSession::getLinkQuality(LinkQuality* out, size_t maxEntries, int64_t nowMicros) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& source : sources_) {
+        if (!source.active || count >= maxEntries) {
+            continue;
+        }
+        LinkQuality& link = out[count++];
+        link.ssrc = source.ssrc;
+        link.address = source.address;
+        link.packetsReceived = source.received;
+
+        // Cumulative loss is live; the fraction is the last report interval's
+        const int64_t expected = source.haveRtp ?
+            static_cast<int64_t>(source.cycles + source.maxSeq - source.baseSeq + 1) : 0;
+        link.cumulativeLost = static_cast<int32_t>(std::clamp<int64_t>(
+            expected - static_cast<int64_t>(source.received), -0x800000, 0x7FFFFF));
+        link.fractionLost = source.fractionQ8 / 256.0f;
+        link.jitterMs = jitterUnitsToMs(static_cast<uint32_t>(source.jitterQ4 >> 4));
+
+        link.hasRemoteReport = source.hasRemoteReport;
+        link.remoteFractionLost = source.remoteFractionLost;
+        link.remoteJitterMs = source.remoteJitterMs;
+        link.rttMs = source.rttMs;
+        link.ageMs = static_cast<uint32_t>(
+            std::max<int64_t>(0, nowMicros - source.lastHeardMicros) / 1000);
+    }
+    return count;
+}
+
+RtcpStats RtcpSession::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RtcpStats stats;
+    stats.reportsSent = reportsSent_;
+    stats.bytesSent = bytesSent_;
+    stats.reportsReceived = reportsReceived_;
+    stats.malformed = malformed_;
+    stats.intervalMs = deterministicIntervalMsLocked(traceClockMicros());
+    stats.members = 1;
+    for (const auto& source : sources_) {
+        if (source.active) {
+            stats.members++;
+        }
+    }
+    return stats;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,260 @@
+/*
+ * Mesh Rider Wave - RTCP Session (RFC 3550 SR/RR, RFC 3611 XR)
+ * Receiver feedback and per-peer link quality for the PTT RTP session
+ *
+ * Every radio reports what it hears from each talker (loss fraction,
+ * cumulative loss, interarrival jitter) in sender/receiver reports, and
+ * learns from the reports it receives how its own stream arrives elsewhere
+ * plus the round-trip time to each reporter:
+ *
+ *     RTT = A - LSR - DLSR    (RFC 3550 6.4.1, 1/65536 s units)
+ *
+ * Listeners rarely send SRs in PTT, so an optional XR part carries a
+ * Receiver Reference Time block and DLRR replies (RFC 3611 4.4/4.5), which
+ * give RTT between any two members, talking or not.
+ *
+ * Report interval follows RFC 3550 6.3: RTCP gets 5% of the session
+ * bandwidth, a quarter of that shared by senders when they are few,
+ * randomized over [0.5, 1.5] x the deterministic interval and never below
+ * the configured minimum (5 s by default). Members that go quiet for
+ * kRtcpSourceTimeoutIntervals intervals, or send BYE, leave the table.
+ *
+ * The table is fixed-size (kMaxRtcpSources) and never allocates; the
+ * receive thread updates it per packet under a mutex that readers (JNI
+ * snapshots) hold only to copy.
+ */
+
+#ifndef MESHRIDER_PTT_RTCP_SESSION_H
+#define MESHRIDER_PTT_RTCP_SESSION_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace meshrider {
+namespace ptt {
+
+struct RtpPacketInfo;
+
+// RTCP packet types (RFC 3550 12.1, RFC 3611)
+constexpr uint8_t kRtcpSenderReport = 200;
+constexpr uint8_t kRtcpReceiverReport = 201;
+constexpr uint8_t kRtcpSourceDescription = 202;
+constexpr uint8_t kRtcpBye = 203;
+constexpr uint8_t kRtcpApplication = 204;
+constexpr uint8_t kRtcpExtendedReport = 207;
+
+// Remote sources tracked at once (talkers plus listeners on the home group)
+constexpr size_t kMaxRtcpSources = 32;
+
+// RC is a 5-bit field
+constexpr size_t kMaxRtcpReportBlocks = 31;
+
+// RFC 3550 6.2: 5% of the session bandwidth, senders' share when few
+constexpr float kRtcpBandwidthFraction = 0.05f;
+constexpr float kRtcpSenderBandwidthFraction = 0.25f;
+
+// 24 kbps Opus at 50 pps plus IP/UDP/RTP headers (~16 kbps)
+constexpr uint32_t kDefaultSessionBandwidthBps = 40000;
+
+// RFC 3550 recommended minimum; the first report goes out after half of it
+constexpr uint32_t kDefaultRtcpMinIntervalMs = 5000;
+constexpr uint32_t kRtcpMinIntervalFloorMs = 100;     // Lab runs only
+
+// Members silent for this many report intervals are timed out (RFC 3550 6.3.5)
+constexpr uint32_t kRtcpSourceTimeoutIntervals = 5;
+
+// IPv4 + UDP, counted in the average RTCP packet size
+constexpr uint32_t kRtcpTransportOverheadBytes = 28;
+
+enum class RtcpMode : uint8_t {
+    OFF,            // No reports sent; received ones are still read
+    SEPARATE_PORT,  // RTP port + 1 (RFC 3550 11)
+    MUX             // Same port as RTP, demultiplexed by type (RFC 5761)
+};
+
+struct RtcpConfig {
+    RtcpMode mode = RtcpMode::SEPARATE_PORT;
+    uint32_t sessionBandwidthBps = kDefaultSessionBandwidthBps;
+    uint32_t minIntervalMs = kDefaultRtcpMinIntervalMs;
+    bool extendedReports = true;        // XR RRTR + DLRR (RTT for listeners)
+};
+
+/**
+ * One remote member as seen from this radio
+ */
+struct LinkQuality {
+    uint32_t ssrc;
+    uint32_t address;               // IPv4 (network order) of its last RTCP, 0 if none yet
+
+    // Inbound: what we receive from it
+    uint64_t packetsReceived;
+    int32_t cumulativeLost;
+    float fractionLost;             // Over the last report interval
+    uint32_t jitterMs;
+
+    // Outbound: what it reports receiving from us
+    bool hasRemoteReport;
+    float remoteFractionLost;
+    uint32_t remoteJitterMs;
+
+    int32_t rttMs;                  // -1 until an SR or RRTR round trip completes
+    uint32_t ageMs;                 // Since anything was last heard from it
+};
+
+struct RtcpStats {
+    uint64_t reportsSent;
+    uint64_t bytesSent;             // RTCP payload bytes (per report, not per destination)
+    uint64_t reportsReceived;
+    uint64_t malformed;
+    uint32_t intervalMs;            // Current deterministic interval
+    uint32_t members;               // Including this radio
+};
+
+/**
+ * RTCP state for one RTP session (THREAD-SAFE)
+ *
+ * onRtpReceived/onRtcpReceived/buildReport run on the receive thread,
+ * onRtpSent on the sending thread, the getters anywhere.
+ */
+class RtcpSession {
+public:
+    RtcpSession();
+
+    void setLocalSsrc(uint32_t ssrc);
+
+    void configure(const RtcpConfig& config);
+    RtcpConfig getConfig() const;
+
+    // Report block about our stream: reporter, its loss fraction [0,1], jitter.
+    // Called on the receive thread without the session lock held.
+    using ReportCallback = std::function<void(uint32_t reporterSsrc, float fractionLost,
+                                              uint32_t jitterMs)>;
+    void setReportCallback(ReportCallback callback) { reportCallback_ = std::move(callback); }
+
+    // Sender side: every RTP packet that left
+    void onRtpSent(size_t payloadBytes, uint32_t rtpTimestamp, int64_t nowMicros);
+
+    // Receiver side: every RTP packet from the home group (after own-SSRC filtering)
+    void onRtpReceived(const RtpPacketInfo& info, int64_t arrivalMicros);
+
+    // Parse one compound RTCP packet; false if malformed
+    bool onRtcpReceived(const uint8_t* data, size_t length, uint32_t fromAddress,
+                        int64_t nowMicros);
+
+    // Next report is due at this time (traceClockMicros() base)
+    int64_t nextReportMicros() const;
+
+    // Build the compound report (SR or RR, SDES CNAME, optional XR) and
+    // schedule the next one. Returns bytes written, 0 if nothing to send.
+    size_t buildReport(uint8_t* out, size_t capacity, int64_t nowMicros);
+
+    // RR + SDES + BYE, for leaving the session
+    size_t buildBye(uint8_t* out, size_t capacity);
+
+    // Members heard within the timeout; returns entries written
+    size_t getLinkQuality(LinkQuality* out, size_t maxEntries, int64_t nowMicros) const;
+
+    RtcpStats getStats() const;
+
+    // RFC 5761 demultiplexing: RTCP types occupy 192-223 in the second octet
+    static bool isRtcp(const uint8_t* data, size_t length);
+
+private:
+    struct Source {
+        uint32_t ssrc = 0;
+        bool active = false;
+        uint32_t address = 0;
+        int64_t lastHeardMicros = 0;
+
+        // RFC 3550 A.1 sequence tracking
+        bool haveRtp = false;
+        uint16_t maxSeq = 0;
+        uint32_t cycles = 0;
+        uint32_t baseSeq = 0;
+        uint32_t badSeq = 0;
+        uint64_t received = 0;
+        uint32_t expectedPrior = 0;
+        uint64_t receivedPrior = 0;
+        int64_t lastRtpMicros = 0;
+
+        // RFC 3550 A.8 interarrival jitter (RTP units, Q4)
+        bool haveTransit = false;
+        uint32_t lastTransit = 0;
+        int64_t jitterQ4 = 0;
+
+        // Last computed at report time
+        uint8_t fractionQ8 = 0;
+        int32_t cumulativeLost = 0;
+
+        // Its last SR / RRTR (NTP middle 32 bits) and when it arrived
+        uint32_t lastSrNtp = 0;
+        int64_t lastSrMicros = 0;
+        uint32_t lastRrtrNtp = 0;
+        int64_t lastRrtrMicros = 0;
+
+        // Its view of our stream
+        bool hasRemoteReport = false;
+        float remoteFractionLost = 0.0f;
+        uint32_t remoteJitterMs = 0;
+        int32_t rttMs = -1;
+    };
+
+    // Report block / DLRR about us, gathered under the lock, delivered after
+    struct PendingReport {
+        uint32_t ssrc;
+        float fractionLost;
+        uint32_t jitterMs;
+    };
+
+    Source* findSource(uint32_t ssrc);
+    Source* findOrAddSource(uint32_t ssrc, int64_t nowMicros);
+    void removeSource(uint32_t ssrc);
+    void expireSourcesLocked(int64_t nowMicros);
+
+    void updateSequence(Source& source, uint16_t seq);
+    void onReportBlock(const uint8_t* block, uint32_t reporterSsrc, uint32_t nowNtp,
+                       PendingReport* pending, size_t& pendingCount);
+    void parseExtendedReport(const uint8_t* body, size_t length, uint32_t reporterSsrc,
+                             uint32_t nowNtp, int64_t nowMicros);
+
+    size_t writeReportLocked(uint8_t* out, size_t capacity, int64_t nowMicros, bool bye);
+    uint32_t deterministicIntervalMsLocked(int64_t nowMicros) const;
+    void scheduleNextLocked(int64_t nowMicros);
+    uint32_t nextRandom();
+
+    mutable std::mutex mutex_;
+    RtcpConfig config_;
+    uint32_t localSsrc_ = 0;
+    std::array<Source, kMaxRtcpSources> sources_{};
+
+    // Sender state (sending thread, lock-free)
+    std::atomic<uint32_t> senderPackets_{0};
+    std::atomic<uint32_t> senderOctets_{0};
+    std::atomic<uint32_t> lastRtpTimestamp_{0};
+    std::atomic<int64_t> lastSendMicros_{0};
+    uint32_t senderPacketsAtReport_ = 0;    // Under mutex_: did we send since the last report
+    bool weSent_ = false;
+
+    // Scheduling (under mutex_)
+    bool initial_ = true;
+    int64_t nextReportMicros_ = 0;
+    float avgRtcpSize_ = 128.0f;            // Bytes incl. IP/UDP, RFC 3550 6.3.3
+    uint32_t random_ = 0x9E3779B9u;
+
+    // Statistics
+    uint64_t reportsSent_ = 0;
+    uint64_t bytesSent_ = 0;
+    uint64_t reportsReceived_ = 0;
+    uint64_t malformed_ = 0;
+
+    ReportCallback reportCallback_;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_RTCP_SESSION_H
@@ -3,16 +3,33 @@
  * Multicast RTP for PTT audio
  * 
  * FIXED (Feb 2026):
- * - Fixed jitter buffer race conditions (atomic head/tail)
+ * - Jitter buffer indexed by RTP sequence with adaptive playout delay
  * - Added unicast fallback when multicast fails
- * - Non-blocking socket with pipe for clean shutdown
+ * - Non-blocking socket with eventfd for clean shutdown
+ * - epoll wait + recvmmsg batch ingest, packets passed by pool ownership
+ * - sendmmsg fan-out to pre-resolved, copy-on-write unicast peer list
  * - Proper RTP timestamp (48kHz per RFC 7587)
  * - SSRC collision detection
+ * - Optional RFC 8285 latency extension (sender wall time + capture->send)
+ * - Seeded network impairment (loss/burst/reorder/duplicate/delay) for lab runs
+ * - Scan channels: extra group sockets multiplexed on the one receive epoll
+ * - DTX: suppressed frames advance the RTP clock; marker packets never feed FEC
+ * - RTCP SR/RR/XR on port + 1 or muxed (RFC 5761), RFC 3550 report timing
+ * - SRTP/SRTCP (AES-GCM) in place on send; replay + tag check before parsing
+ * - RED (RFC 2198) pack/split and delayed duplicates; copies only fill holes
+ * - Relay: reflector re-forwards receive batches undecoded with sendmmsg
+ * - No idle poll: epoll_wait() blocks until data, a due timer or a wake
+ * - Receive thread under the ThreadManager; socket wait measured from
+ *   SO_TIMESTAMPNS stamps
+ * - Receive thread is an EventLoop: sockets watched by handler, timers on
+ *   one timerfd, stopReceiveLoop() joins instead of detaching on a timeout
  */
 
 #include "RtpPacketizer.h"
-#include <android/log.h>
+#include "LatencyTracer.h"
+#include "PttLog.h"
 #include <cstring>
+#include <ctime>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -20,7 +37,8 @@
 #include <fcntl.h>
 #include <random>
 #include <algorithm>
-#include <future>
+#include <chrono>
+#include <cstdlib>
 
 #define TAG "MeshRider:PTT-RTP"
 
@@ -31,150 +49,514 @@ namespace ptt {
 // RtpJitterBuffer Implementation (THREAD-SAFE)
 // ============================================================================
 
-RtpJitterBuffer::RtpJitterBuffer()
-    : head_(0), tail_(0), isEmpty_(true),
-      packetsReceived_(0), packetsLost_(0), lastSeq_(0) {
-    for (auto& packet : buffer_) {
-        packet.valid = false;
-        packet.size = 0;
-        packet.seq = 0;
+namespace {
+
+// Sequence jump treated as a sender restart rather than loss/reorder
+constexpr int kSeqResyncThreshold = 1000;
+
+// Target delay = frame + kJitterMultiplier * RFC 3550 jitter
+constexpr uint32_t kJitterMultiplier = 3;
+
+// Depth must leave [target - 1, target + 2] before we stretch/shrink
+constexpr uint32_t kStretchHysteresisFrames = 1;
+constexpr uint32_t kShrinkHysteresisFrames = 2;
+
+// Minimum playout frames between two stretch/shrink actions
+constexpr uint32_t kAdaptIntervalFrames = 4;
+
+// Home and scan sockets plus the RTCP socket, on the one event loop
+static_assert(kMaxChannels + 1 <= kMaxEventSources, "event loop cannot watch every channel");
+
+// Longest compound RTCP packet we build (31 report blocks, SDES, XR with DLRR)
+constexpr size_t kRtcpBufferBytes = MAX_PACKET_SIZE;
+
+// RFC 2198: 4-byte header per repeated block (F | PT, 14-bit timestamp
+// offset, 10-bit length), 1 byte for the primary
+constexpr size_t kRedBlockHeaderBytes = 4;
+constexpr uint32_t kRedMaxTimestampOffset = 0x3FFF;   // ~341 ms at 48 kHz
+
+// Blocks accepted in one received RED payload (senders may repeat more
+// than we do)
+constexpr size_t kMaxRedBlocks = 8;
+
+// DUPLICATE: a held copy older than one longest frame is stale (the
+// sender paused in DTX), so it is dropped rather than sent late
+constexpr uint32_t kMaxDuplicateHoldTicks = 60 * RTP_CLOCK_RATE / 1000;
+
+// Reflector forwards queued per sendmmsg(); room for one datagram to every
+// member on top of a nearly full queue
+constexpr size_t kRelayQueueSize = 64;
+static_assert(kRelayQueueSize >= kMaxRelayTargets, "relay queue must take one full fan-out");
+
+// Receive each group only on the socket that joined it. Linux otherwise
+// delivers every joined group on the port to all sockets bound to INADDR_ANY,
+// which would play scan channels as home channel traffic.
+void restrictMulticastToJoined(int fd) {
+#ifdef IP_MULTICAST_ALL
+    int all = 0;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
+#endif
+}
+
+// Kernel receive stamp on every datagram (SCM_TIMESTAMPNS): how long a
+// packet sat in the socket before the receive thread ran
+constexpr int64_t kMaxReceiveStampAgeMicros = 10 * 1000000;
+
+void enableReceiveTimestamps(int fd) {
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+}
+
+int64_t monotonicMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Walk RFC 8285 one-byte elements for the latency extension's sender stamps
+void parseLatencyExtension(const uint8_t* data, const uint8_t* end,
+                           PacketTimestamps& timestamps) {
+    while (data < end) {
+        const uint8_t element = *data++;
+        if (element == 0) {
+            continue;  // Padding
+        }
+        const uint8_t id = element >> 4;
+        const size_t length = (element & 0x0F) + 1u;
+        if (id == 15 || data + length > end) {
+            return;    // Reserved id ends parsing (RFC 8285 4.2)
+        }
+        if (id == kLatencyExtensionId && length == kLatencyExtensionDataBytes) {
+            const uint32_t sendWall = (static_cast<uint32_t>(data[0]) << 24) |
+                                      (static_cast<uint32_t>(data[1]) << 16) |
+                                      (static_cast<uint32_t>(data[2]) << 8) | data[3];
+            timestamps.senderCaptureToSendMicros = (static_cast<uint32_t>(data[4]) << 16) |
+                                                   (static_cast<uint32_t>(data[5]) << 8) | data[6];
+            timestamps.transitMicros = static_cast<int32_t>(traceWallMicros32() - sendWall);
+            timestamps.hasSenderStamps = true;
+        }
+        data += length;
     }
 }
 
+} // namespace
+
+RtpJitterBuffer::RtpJitterBuffer(uint32_t frameDurationMs, uint32_t clockRate)
+    : frameDurationMs_(frameDurationMs > 0 ? frameDurationMs : PttAudioFormat::kFrameDurationMs),
+      clockRate_(clockRate) {
+    setDelayBounds(kDefaultMinDelayMs, kDefaultMaxDelayMs);
+}
+
 RtpJitterBuffer::~RtpJitterBuffer() {
     reset();
 }
 
-void RtpJitterBuffer::enqueue(const uint8_t* data, size_t size) {
-    if (size < RTP_HEADER_SIZE || size > MAX_PACKET_SIZE) {
+void RtpJitterBuffer::setDelayBounds(uint32_t minDelayMs, uint32_t maxDelayMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    minDelayMs_ = minDelayMs;
+    maxDelayMs_ = maxDelayMs;
+    applyDelayBoundsLocked();
+}
+
+void RtpJitterBuffer::setFrameDuration(uint32_t frameDurationMs) {
+    if (frameDurationMs == 0) {
         return;
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
+    if (frameDurationMs == frameDurationMs_) {
+        return;
+    }
 
-    // Extract sequence number from RTP header
-    RtpHeader header;
-    std::memcpy(&header, data, RTP_HEADER_SIZE);
-    uint16_t seq = ntohs(header.seq);
-
-    // Check for packet loss
-    if (packetsReceived_.load() > 0 && lastSeq_.load() != 0) {
-        uint16_t expected = (lastSeq_.load() + 1) & 0xFFFF;
-        if (seq != expected) {
-            uint16_t lost = (seq - expected) & 0xFFFF;
-            if (lost < 100) {  // Sanity check
-                packetsLost_ += lost;
+    // Keep the same delay in ms across the change
+    const uint32_t targetMs = targetFrames_ * frameDurationMs_;
+    frameDurationMs_ = frameDurationMs;
+    targetFrames_ = (targetMs + frameDurationMs_ - 1) / frameDurationMs_;
+    applyDelayBoundsLocked();
+    stats_.targetDelayMs = targetFrames_ * frameDurationMs_;
+    publishLocked();
+}
+
+void RtpJitterBuffer::applyDelayBoundsLocked() {
+    // Bounds in whole frames; max must fit inside the slot window
+    minDelayFrames_ = std::max<uint32_t>(1,
+        (minDelayMs_ + frameDurationMs_ - 1) / frameDurationMs_);
+    maxDelayFrames_ = std::clamp<uint32_t>(
+        maxDelayMs_ / frameDurationMs_, minDelayFrames_, kSlotCount - 4);
+    targetFrames_ = std::clamp(targetFrames_, minDelayFrames_, maxDelayFrames_);
+}
+
+bool RtpJitterBuffer::enqueue(PacketPtr packet, const RtpPacketInfo& info) {
+    return enqueue(std::move(packet), info, monotonicMicros());
+}
+
+bool RtpJitterBuffer::enqueue(PacketPtr packet, const RtpPacketInfo& info,
+                              int64_t arrivalMicros) {
+    if (!packet || packet->payloadLength == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool queued = enqueueLocked(std::move(packet), info, arrivalMicros);
+    publishLocked();
+    return queued;
+}
+
+bool RtpJitterBuffer::enqueueLocked(PacketPtr packet, const RtpPacketInfo& info,
+                                    int64_t arrivalMicros) {
+    const uint16_t seq = info.seq;
+
+    if (info.redundant) {
+        // Only a hole already behind the newest packet: a copy carries no
+        // new timing, so it must not move the window or the delay target
+        Slot& slot = slots_[seq & (kSlotCount - 1)];
+        if (!haveHighest_ || seqDiff(seq, playoutSeq_) < 0 ||
+            seqDiff(seq, highestSeq_) >= 0 || slot.packet) {
+            stats_.redundantDiscarded++;
+            return false;
+        }
+        slot.packet = std::move(packet);
+        slot.seq = seq;
+        slot.marker = false;
+        bufferedCount_++;
+        stats_.redundantUsed++;
+        return true;
+    }
+
+    stats_.packetsReceived++;
+
+    // Sender restarted or a new talker reused the stream: start over
+    if (haveHighest_ && std::abs(seqDiff(seq, highestSeq_)) > kSeqResyncThreshold) {
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "Jitter buffer resync: seq %u -> %u", highestSeq_, seq);
+        resetLocked();
+    }
+
+    if (!haveHighest_) {
+        haveHighest_ = true;
+        highestSeq_ = seq;
+        playoutSeq_ = seq;
+    }
+
+    const int16_t offset = seqDiff(seq, playoutSeq_);
+
+    if (offset < 0) {
+        if (started_) {
+            // Its slot has already been played or concealed
+            stats_.packetsLate++;
+            return false;
+        }
+        // Still prebuffering: reordered head of the stream, extend backwards
+        if (seqDiff(highestSeq_, seq) >= static_cast<int>(kSlotCount)) {
+            stats_.packetsDiscarded++;
+            return false;
+        }
+        playoutSeq_ = seq;
+    } else if (offset >= static_cast<int>(kSlotCount)) {
+        // Too far ahead of playout: slide the window, dropping what falls out
+        const uint16_t newPlayout = static_cast<uint16_t>(seq - kSlotCount + 1);
+        while (playoutSeq_ != newPlayout) {
+            Slot& old = slots_[playoutSeq_ & (kSlotCount - 1)];
+            if (old.holds(playoutSeq_)) {
+                old.packet.reset();
+                bufferedCount_--;
+                stats_.packetsDiscarded++;
             }
+            playoutSeq_++;
         }
     }
 
-    lastSeq_.store(seq);
-    packetsReceived_++;
+    Slot& slot = slots_[seq & (kSlotCount - 1)];
+    if (slot.holds(seq)) {
+        stats_.packetsDiscarded++;  // Duplicate
+        return false;
+    }
+    if (!slot.packet) {
+        bufferedCount_++;
+    }
+
+    // Ownership moves into the slot; no payload copy
+    slot.packet = std::move(packet);
+    slot.seq = seq;
+    slot.marker = info.marker;
 
-    // Calculate next position
-    size_t currentTail = tail_.load();
-    size_t next = (currentTail + 1) % BUFFER_SIZE;
-    
-    if (next == head_.load()) {
-        // Buffer full, drop oldest
-        head_.store((head_.load() + 1) % BUFFER_SIZE);
-        packetsLost_++;
+    if (seqDiff(seq, highestSeq_) > 0) {
+        highestSeq_ = seq;
     }
 
-    // Store packet
-    buffer_[currentTail].size = size;
-    buffer_[currentTail].seq = seq;
-    buffer_[currentTail].valid = true;
-    std::memcpy(buffer_[currentTail].data.data(), data, size);
-    
-    tail_.store(next);
-    isEmpty_.store(false);
+    updateJitter(info.timestamp, arrivalMicros);
+    updateTargetDelay();
+    return true;
+}
+
+void RtpJitterBuffer::updateJitter(uint32_t rtpTimestamp, int64_t arrivalMicros) {
+    // RFC 3550 A.8: transit = arrival (RTP units) - timestamp, J += (|D| - J) / 16
+    const uint32_t arrival = static_cast<uint32_t>(
+        (arrivalMicros * static_cast<int64_t>(clockRate_)) / 1000000);
+    const uint32_t transit = arrival - rtpTimestamp;
+
+    if (haveTransit_) {
+        const int32_t d = static_cast<int32_t>(transit - lastTransit_);
+        const int64_t absD = d < 0 ? -static_cast<int64_t>(d) : d;
+        jitterQ4_ += absD - ((jitterQ4_ + 8) >> 4);
+    }
+    lastTransit_ = transit;
+    haveTransit_ = true;
+}
+
+void RtpJitterBuffer::updateTargetDelay() {
+    const uint32_t jitterMs = static_cast<uint32_t>(
+        ((jitterQ4_ >> 4) * 1000) / clockRate_);
+    const uint32_t targetMs = frameDurationMs_ + kJitterMultiplier * jitterMs;
+    const uint32_t frames = (targetMs + frameDurationMs_ - 1) / frameDurationMs_;
+
+    targetFrames_ = std::clamp(frames, minDelayFrames_, maxDelayFrames_);
+    stats_.jitterMs = jitterMs;
+    stats_.targetDelayMs = targetFrames_ * frameDurationMs_;
 }
 
-bool RtpJitterBuffer::dequeue(uint8_t* buffer, size_t& size) {
+uint32_t RtpJitterBuffer::depthFrames() const {
+    if (!haveHighest_ || bufferedCount_ == 0) {
+        return 0;
+    }
+    const int16_t span = seqDiff(highestSeq_, playoutSeq_);
+    return span < 0 ? 0 : static_cast<uint32_t>(span) + 1;
+}
+
+void RtpJitterBuffer::noteRecovery(bool recovered) {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (recovered) {
+        stats_.framesRecovered++;
+    } else {
+        stats_.framesConcealed++;
+    }
+    publishLocked();
+}
 
-    if (isEmpty_.load()) {
-        size = 0;
-        return false;
+JitterResult RtpJitterBuffer::dequeue(PacketPtr& packet) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const JitterResult result = dequeueLocked(packet);
+    publishLocked();
+    return result;
+}
+
+JitterResult RtpJitterBuffer::dequeueLocked(PacketPtr& packet) {
+    packet.reset();
+
+    if (bufferedCount_ == 0) {
+        // Underflow (end of talkspurt or network stall): rebuffer to target
+        started_ = false;
+        stats_.currentDelayMs = 0;
+        return JitterResult::BUFFERING;
     }
 
-    size_t currentHead = head_.load();
-    if (currentHead == tail_.load()) {
-        isEmpty_.store(true);
-        size = 0;
-        return false;
+    if (!started_) {
+        // Skip leading holes so playout begins at the oldest packet we hold
+        for (size_t i = 0; i < kSlotCount; ++i) {
+            const Slot& head = slots_[playoutSeq_ & (kSlotCount - 1)];
+            if (head.holds(playoutSeq_)) {
+                break;
+            }
+            playoutSeq_++;
+        }
+        if (depthFrames() < targetFrames_) {
+            stats_.currentDelayMs = depthFrames() * frameDurationMs_;
+            return JitterResult::BUFFERING;
+        }
+        started_ = true;
+        framesSinceAdapt_ = 0;
     }
 
-    if (!buffer_[currentHead].valid) {
-        size = 0;
-        return false;
+    uint32_t depth = depthFrames();
+    framesSinceAdapt_++;
+
+    if (framesSinceAdapt_ >= kAdaptIntervalFrames) {
+        if (depth > targetFrames_ + kShrinkHysteresisFrames) {
+            // Shrink: drop the oldest frame to pull latency back to target
+            Slot& oldest = slots_[playoutSeq_ & (kSlotCount - 1)];
+            if (oldest.holds(playoutSeq_)) {
+                oldest.packet.reset();
+                bufferedCount_--;
+                stats_.packetsDiscarded++;
+            }
+            playoutSeq_++;
+            framesSinceAdapt_ = 0;
+            depth--;
+
+            if (bufferedCount_ == 0) {
+                started_ = false;
+                stats_.currentDelayMs = 0;
+                return JitterResult::BUFFERING;
+            }
+        } else if (depth + kStretchHysteresisFrames < targetFrames_) {
+            // Stretch: emit one concealment frame without consuming a packet
+            framesSinceAdapt_ = 0;
+            stats_.framesStretched++;
+            stats_.framesConcealed++;
+            stats_.currentDelayMs = depth * frameDurationMs_;
+            return JitterResult::CONCEAL;
+        }
     }
 
-    size = buffer_[currentHead].size;
-    std::memcpy(buffer, buffer_[currentHead].data.data(), size);
-    buffer_[currentHead].valid = false;
-    
-    head_.store((currentHead + 1) % BUFFER_SIZE);
+    stats_.currentDelayMs = depth * frameDurationMs_;
+
+    Slot& slot = slots_[playoutSeq_ & (kSlotCount - 1)];
+    const bool present = slot.holds(playoutSeq_);
+    playoutSeq_++;
+
+    if (!present) {
+        // Packet for this slot never arrived
+        stats_.packetsLost++;
+
+        // Its successor may carry an FEC copy: hand it over now, consuming both
+        // slots. Not across a DTX gap: a talkspurt's first packet carries FEC
+        // for the silence before it, not for the lost frame.
+        Slot& next = slots_[playoutSeq_ & (kSlotCount - 1)];
+        if (next.holds(playoutSeq_) && !next.marker) {
+            playoutSeq_++;
+            packet = std::move(next.packet);
+            bufferedCount_--;
+            stats_.framesPlayed++;
+            return JitterResult::RECOVER;
+        }
 
-    return true;
+        stats_.framesConcealed++;
+        return JitterResult::CONCEAL;
+    }
+
+    packet = std::move(slot.packet);
+    bufferedCount_--;
+    stats_.framesPlayed++;
+    return JitterResult::PACKET;
+}
+
+void RtpJitterBuffer::resetLocked() {
+    for (auto& slot : slots_) {
+        slot.packet.reset();
+    }
+    started_ = false;
+    haveHighest_ = false;
+    playoutSeq_ = 0;
+    highestSeq_ = 0;
+    bufferedCount_ = 0;
+    haveTransit_ = false;
+    lastTransit_ = 0;
+    framesSinceAdapt_ = 0;
 }
 
 void RtpJitterBuffer::reset() {
     std::lock_guard<std::mutex> lock(mutex_);
-    head_.store(0);
-    tail_.store(0);
-    isEmpty_.store(true);
-    packetsReceived_.store(0);
-    packetsLost_.store(0);
-    lastSeq_.store(0);
-    
-    for (auto& packet : buffer_) {
-        packet.valid = false;
-    }
+    resetLocked();
+    jitterQ4_ = 0;
+    targetFrames_ = minDelayFrames_;
+    // Counters already published stay; only the gauges start over
+    stats_ = JitterBufferStats{};
+    published_ = JitterBufferStats{};
+    publishLocked();
+}
+
+void RtpJitterBuffer::publishLocked() {
+    using Field = JitterField;
+    telemetry_.beginUpdate();
+    telemetry_.add(Field::PACKETS_RECEIVED, stats_.packetsReceived - published_.packetsReceived);
+    telemetry_.add(Field::PACKETS_LOST, stats_.packetsLost - published_.packetsLost);
+    telemetry_.add(Field::PACKETS_LATE, stats_.packetsLate - published_.packetsLate);
+    telemetry_.add(Field::PACKETS_DISCARDED, stats_.packetsDiscarded - published_.packetsDiscarded);
+    telemetry_.add(Field::FRAMES_PLAYED, stats_.framesPlayed - published_.framesPlayed);
+    telemetry_.add(Field::FRAMES_CONCEALED, stats_.framesConcealed - published_.framesConcealed);
+    telemetry_.add(Field::FRAMES_RECOVERED, stats_.framesRecovered - published_.framesRecovered);
+    telemetry_.add(Field::FRAMES_STRETCHED, stats_.framesStretched - published_.framesStretched);
+    telemetry_.add(Field::REDUNDANT_USED, stats_.redundantUsed - published_.redundantUsed);
+    telemetry_.add(Field::REDUNDANT_DISCARDED,
+                   stats_.redundantDiscarded - published_.redundantDiscarded);
+    telemetry_.set(Field::JITTER_MS, stats_.jitterMs);
+    telemetry_.set(Field::TARGET_DELAY_MS, stats_.targetDelayMs);
+    telemetry_.set(Field::CURRENT_DELAY_MS, stats_.currentDelayMs);
+    telemetry_.endUpdate();
+    published_ = stats_;
+}
+
+JitterBufferStats RtpJitterBuffer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+JitterBufferStats RtpJitterBuffer::getPublishedStats() const {
+    using Block = TelemetryBlock<JitterField>;
+    const auto values = telemetry_.snapshot();
+
+    JitterBufferStats stats;
+    stats.packetsReceived = values[Block::index(JitterField::PACKETS_RECEIVED)];
+    stats.packetsLost = values[Block::index(JitterField::PACKETS_LOST)];
+    stats.packetsLate = values[Block::index(JitterField::PACKETS_LATE)];
+    stats.packetsDiscarded = values[Block::index(JitterField::PACKETS_DISCARDED)];
+    stats.framesPlayed = values[Block::index(JitterField::FRAMES_PLAYED)];
+    stats.framesConcealed = values[Block::index(JitterField::FRAMES_CONCEALED)];
+    stats.framesRecovered = values[Block::index(JitterField::FRAMES_RECOVERED)];
+    stats.framesStretched = values[Block::index(JitterField::FRAMES_STRETCHED)];
+    stats.redundantUsed = values[Block::index(JitterField::REDUNDANT_USED)];
+    stats.redundantDiscarded = values[Block::index(JitterField::REDUNDANT_DISCARDED)];
+    stats.jitterMs = static_cast<uint32_t>(values[Block::index(JitterField::JITTER_MS)]);
+    stats.targetDelayMs = static_cast<uint32_t>(values[Block::index(JitterField::TARGET_DELAY_MS)]);
+    stats.currentDelayMs = static_cast<uint32_t>(values[Block::index(JitterField::CURRENT_DELAY_MS)]);
+    return stats;
+}
+
+size_t RtpJitterBuffer::getPacketsLost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.packetsLost;
+}
+
+size_t RtpJitterBuffer::getPacketsReceived() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.packetsReceived;
 }
 
 size_t RtpJitterBuffer::getCurrentSize() const {
-    if (isEmpty_.load()) return 0;
-    
-    size_t head = head_.load();
-    size_t tail = tail_.load();
-    
-    if (tail >= head) {
-        return tail - head;
-    } else {
-        return BUFFER_SIZE - head + tail;
-    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bufferedCount_;
 }
 
 // ============================================================================
 // RtpPacketizer Implementation (PRODUCTION-READY)
 // ============================================================================
 
+// Per-batch recvmmsg() bookkeeping, allocated once by startReceiveLoop()
+struct RtpPacketizer::ReceiveBatch {
+    std::array<PacketPtr, kRecvBatchSize> packets;
+    struct mmsghdr msgs[kRecvBatchSize];
+    struct iovec iovecs[kRecvBatchSize];
+    struct sockaddr_in fromAddrs[kRecvBatchSize];
+
+    // Kernel receive stamp of the first datagram (oldest in the batch)
+    alignas(struct cmsghdr) uint8_t control[CMSG_SPACE(sizeof(struct timespec))];
+
+    // Landing zone when the pool is exhausted: datagram is read and dropped
+    uint8_t discard[kPooledPacketCapacity];
+};
+
 RtpPacketizer::RtpPacketizer()
     : socket_(-1), isRunning_(false),
       sequence_(0), timestamp_(0),
       port_(5004), transportMode_(TransportMode::AUTO),
       multicastJoined_(false),
-      receiveRunning_(false),
-      packetsSent_(0), packetsReceived_(0),
-      samplesPerFrame_(960) {  // 20ms @ 48kHz (RFC 7587)
-
-    shutdownPipe_[0] = -1;
-    shutdownPipe_[1] = -1;
+      unicastPeers_(new PeerList()) {
 
     // Generate random SSRC
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<uint32_t> dis(1, 0xFFFFFFFF);
     ssrc_ = dis(gen);
+    rtcp_.setLocalSsrc(ssrc_);
+    relay_.setLocalSsrc(ssrc_);
 
     std::memset(multicastGroup_, 0, sizeof(multicastGroup_));
+    std::memset(&multicastAddr_, 0, sizeof(multicastAddr_));
 }
 
 RtpPacketizer::~RtpPacketizer() {
     stop();
     closeSocket();
+    delete unicastPeers_.load();
 }
 
 bool RtpPacketizer::initialize(const char* multicastGroup, uint16_t port,
@@ -183,6 +565,20 @@ bool RtpPacketizer::initialize(const char* multicastGroup, uint16_t port,
     port_ = port;
     transportMode_ = mode;
 
+    // Resolve once; the send path reuses it every frame
+    std::memset(&multicastAddr_, 0, sizeof(multicastAddr_));
+    multicastAddr_.sin_family = AF_INET;
+    multicastAddr_.sin_addr.s_addr = inet_addr(multicastGroup_);
+    multicastAddr_.sin_port = htons(port_);
+
+    // Peers added before initialize() were resolved against the old port
+    {
+        std::lock_guard<std::mutex> lock(unicastMutex_);
+        for (const auto& peer : *unicastPeers_.load()) {
+            peer->addr.sin_port = htons(port_);
+        }
+    }
+
     return createSocket();
 }
 
@@ -204,13 +600,22 @@ bool RtpPacketizer::createSocket() {
         socket_ = -1;
         return false;
     }
+    if (threadManager_) {
+        enableReceiveTimestamps(socket_);
+    }
 
-    // PRODUCTION FIX: Create shutdown pipe for clean thread termination
-    if (pipe(shutdownPipe_) < 0) {
-        __android_log_print(ANDROID_LOG_WARN, TAG,
-            "Failed to create shutdown pipe: %s", strerror(errno));
-        // Not fatal, but shutdown may hang
+    // PRODUCTION FIX: the receive thread sleeps in the event loop until
+    // data, a due timer, or a wake (shutdown, moved timer) from another thread
+    loop_.release();
+    if (!loop_.initialize()) {
+        close(socket_);
+        socket_ = -1;
+        return false;
     }
+    registerLoop();
+
+    restrictMulticastToJoined(socket_);
+    applyMulticastLoop(socket_);
 
     // PRODUCTION FIX: Set non-blocking mode for clean shutdown
     int flags = fcntl(socket_, F_GETFL, 0);
@@ -266,6 +671,10 @@ bool RtpPacketizer::createSocket() {
         transportMode_ == TransportMode::UNICAST ? "unicast" : "auto",
         DSCP::EF);
 
+    if (rtcp_.getConfig().mode == RtcpMode::SEPARATE_PORT) {
+        openRtcpSocket();
+    }
+
     return true;
 }
 
@@ -315,20 +724,42 @@ void RtpPacketizer::leaveMulticastGroup() {
 
 void RtpPacketizer::closeSocket() {
     leaveMulticastGroup();
-    
+
+    // Receive loop is stopped by now; scan sockets go with the home socket
+    {
+        std::lock_guard<std::mutex> lock(channelMutex_);
+        for (auto& channel : channels_) {
+            const int fd = channel.socket.exchange(-1);
+            if (fd >= 0) {
+                close(fd);
+            }
+            channel.id = 0;
+        }
+    }
+
+
     if (socket_ >= 0) {
         close(socket_);
         socket_ = -1;
     }
-    
-    if (shutdownPipe_[0] >= 0) {
-        close(shutdownPipe_[0]);
-        shutdownPipe_[0] = -1;
-    }
-    if (shutdownPipe_[1] >= 0) {
-        close(shutdownPipe_[1]);
-        shutdownPipe_[1] = -1;
+
+    const int rtcpFd = rtcpSocket_.exchange(-1);
+    if (rtcpFd >= 0) {
+        close(rtcpFd);
     }
+
+    loop_.release();
+}
+
+void RtpPacketizer::registerLoop() {
+    // Run every pass in this order: held datagrams, then the control timers
+    loop_.addTimer([this](int64_t nowMicros) { return releaseDueDatagrams(delayLine_, nowMicros); });
+    loop_.addTimer([this](int64_t nowMicros) { return serviceRtcp(nowMicros); });
+    loop_.addTimer([this](int64_t nowMicros) { return serviceFloor(nowMicros); });
+    loop_.addTimer([this](int64_t nowMicros) { return serviceRelay(nowMicros); });
+
+    const int fd = socket_;
+    loop_.watch(fd, [this, fd]() { drainSocket(fd, kHomeChannel, *receiveBatch_, delayLine_); });
 }
 
 bool RtpPacketizer::start() {
@@ -337,21 +768,42 @@ bool RtpPacketizer::start() {
     }
 
     isRunning_ = true;
+    // RTCP and relay timers start with the session
+    wakeReceiveLoop();
     __android_log_print(ANDROID_LOG_INFO, TAG,
         "RTP packetizer started");
     return true;
 }
 
 void RtpPacketizer::stop() {
+    // Leave the session politely so peers drop us from their tables now
+    if (isRunning_ && rtcp_.getConfig().mode != RtcpMode::OFF) {
+        uint8_t bye[kRtcpBufferBytes];
+        const size_t length = rtcp_.buildBye(bye, sizeof(bye));
+        if (length > 0) {
+            sendRtcp(bye, length);
+        }
+    }
+    const in_addr_t reflector = reflectorAddress_.load();
+    if (isRunning_ && reflector != 0) {
+        sendRelayMessage(RelayMessageType::LEAVE, reflector);
+    }
+
     isRunning_ = false;
     stopReceiveLoop();
 }
 
-bool RtpPacketizer::sendAudio(const uint8_t* opusData, size_t opusSize, bool isMarker) {
+bool RtpPacketizer::sendAudio(const uint8_t* opusData, size_t opusSize, bool isMarker,
+                              uint32_t rtpTimestampIncrement, int64_t captureMicros) {
     if (!isRunning_ || socket_ < 0) {
         return false;
     }
 
+    // Floor denied or revoked: silent before a sequence number is spent
+    if (floor_ && !floor_->mayTransmit()) {
+        return false;
+    }
+
     // Create RTP packet
     uint8_t packet[MAX_PACKET_SIZE];
     RtpHeader* header = reinterpret_cast<RtpHeader*>(packet);
@@ -359,209 +811,1508 @@ bool RtpPacketizer::sendAudio(const uint8_t* opusData, size_t opusSize, bool isM
     header->setVersion(RTP_VERSION);
     header->setMarker(isMarker);
     header->setPayloadType(RTP_PAYLOAD_OPUS);
-    header->seq = htons(sequence_.fetch_add(1) & 0xFFFF);
+    const uint16_t seq = static_cast<uint16_t>(sequence_.fetch_add(1) & 0xFFFF);
+    header->seq = htons(seq);
     
     // PRODUCTION FIX: RFC 7587 - Opus uses 48kHz clock
-    header->timestamp = htonl(timestamp_.load());
+    const uint32_t rtpTimestamp = timestamp_.load();
+    header->timestamp = htonl(rtpTimestamp);
     header->ssrc = htonl(ssrc_);
 
-    // Copy Opus payload
-    if (opusSize > MAX_PACKET_SIZE - RTP_HEADER_SIZE) {
-        opusSize = MAX_PACKET_SIZE - RTP_HEADER_SIZE;
+    size_t headerSize = RTP_HEADER_SIZE;
+
+    // Latency extension (RFC 8285 one-byte form): wall-clock send time and
+    // capture->send delay, so the receiver can measure across devices
+    if (captureMicros > 0 && latencyExtension_.load(std::memory_order_relaxed)) {
+        const uint32_t sendWall = traceWallMicros32();
+        const int64_t captureToSend = std::clamp<int64_t>(
+            traceClockMicros() - captureMicros, 0, 0xFFFFFF);
+
+        uint8_t* ext = packet + RTP_HEADER_SIZE;
+        ext[0] = kRtpOneByteExtensionProfile >> 8;
+        ext[1] = kRtpOneByteExtensionProfile & 0xFF;
+        ext[2] = 0;
+        ext[3] = (kLatencyExtensionBlockBytes - 4) / 4;         // Length in words
+        ext[4] = (kLatencyExtensionId << 4) | (kLatencyExtensionDataBytes - 1);
+        ext[5] = sendWall >> 24;
+        ext[6] = (sendWall >> 16) & 0xFF;
+        ext[7] = (sendWall >> 8) & 0xFF;
+        ext[8] = sendWall & 0xFF;
+        ext[9] = (captureToSend >> 16) & 0xFF;
+        ext[10] = (captureToSend >> 8) & 0xFF;
+        ext[11] = captureToSend & 0xFF;
+
+        header->vpxcc |= 0x10;  // X bit
+        headerSize += kLatencyExtensionBlockBytes;
+    }
+
+    // Copy Opus payload (room left for the SRTP tag when protecting)
+    const bool protect = srtp_ && srtp_->isActive();
+    const size_t payloadCapacity = MAX_PACKET_SIZE - headerSize - (protect ? kSrtpTagBytes : 0);
+    if (opusSize > payloadCapacity) {
+        opusSize = payloadCapacity;
+    }
+    const RedundancyMode redundancy = redundancyMode_.load(std::memory_order_acquire);
+    size_t payloadSize = opusSize;
+    if (redundancy == RedundancyMode::RED) {
+        size_t redundantFrames = 0;
+        payloadSize = packRedundant(packet + headerSize, payloadCapacity, opusData, opusSize,
+                                    seq, rtpTimestamp, redundantFrames);
+        if (redundantFrames > 0) {
+            header->setPayloadType(RTP_PAYLOAD_RED);
+        }
+    } else {
+        std::memcpy(packet + headerSize, opusData, opusSize);
+    }
+
+    // CRITICAL FIX: encrypt in place; fail closed if the key went away
+    // between the check and here rather than send the frame in clear
+    size_t length = headerSize + payloadSize;
+    if (protect) {
+        length = srtp_->protectRtp(packet, headerSize, payloadSize, sizeof(packet));
+        if (length == 0) {
+            sendFailures_.add();
+            return false;
+        }
     }
-    std::memcpy(packet + RTP_HEADER_SIZE, opusData, opusSize);
 
     // Send to all destinations
-    bool sent = sendToAll(packet, RTP_HEADER_SIZE + opusSize);
+    bool sent = sendToAll(packet, length);
 
     if (sent) {
         // Advance timestamp (48kHz clock for Opus)
-        timestamp_.fetch_add(samplesPerFrame_);
-        packetsSent_++;
+        timestamp_.fetch_add(rtpTimestampIncrement);
+        packetsSent_.add();
+        bytesSent_.add(length);
+        rtcp_.onRtpSent(payloadSize, rtpTimestamp, traceClockMicros());
+    }
+
+    if (redundancy == RedundancyMode::DUPLICATE) {
+        sendDuplicate(packet, length, seq, rtpTimestamp);
     }
 
     return sent;
 }
 
-bool RtpPacketizer::sendToAll(const uint8_t* data, size_t size) {
-    bool anySent = false;
-
-    // Send via multicast if available
-    if (multicastJoined_ && (transportMode_ == TransportMode::MULTICAST ||
-                             transportMode_ == TransportMode::AUTO)) {
-        struct sockaddr_in addr;
-        std::memset(&addr, 0, sizeof(addr));
-        addr.sin_family = AF_INET;
-        addr.sin_addr.s_addr = inet_addr(multicastGroup_);
-        addr.sin_port = htons(port_);
-
-        ssize_t sent = sendto(socket_, data, size, 0,
-                              (struct sockaddr*)&addr, sizeof(addr));
-        
-        if (sent > 0) {
-            anySent = true;
-        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            __android_log_print(ANDROID_LOG_WARN, TAG,
-                "Multicast send failed: %s", strerror(errno));
+size_t RtpPacketizer::packRedundant(uint8_t* out, size_t capacity, const uint8_t* frame,
+                                    size_t frameSize, uint16_t seq, uint32_t timestamp,
+                                    size_t& redundantFrames) {
+    std::lock_guard<std::mutex> lock(redundancyMutex_);
+
+    // i = 1 is the previous frame
+    auto previous = [this](size_t i) -> const SentFrame& {
+        return history_[(historyHead_ + kMaxRedundancyDepth - i) % kMaxRedundancyDepth];
+    };
+
+    // Newest run that directly precedes this frame: the receiver derives
+    // each copy's sequence number from its distance to the primary
+    size_t count = 0;
+    size_t bytes = 1 + frameSize;
+    const size_t depth = std::min<size_t>(redundancy_.depth, historyCount_);
+    while (count < depth) {
+        const SentFrame& sent = previous(count + 1);
+        const size_t blockBytes = kRedBlockHeaderBytes + sent.size;
+        if (sent.size == 0 || sent.seq != static_cast<uint16_t>(seq - count - 1) ||
+            timestamp - sent.timestamp > kRedMaxTimestampOffset ||
+            bytes + blockBytes > capacity) {
+            break;
         }
+        bytes += blockBytes;
+        count++;
     }
 
-    // Send to unicast peers (fallback mode)
-    {
-        std::lock_guard<std::mutex> lock(unicastMutex_);
-        for (const auto& peer : unicastPeers_) {
-            struct sockaddr_in addr;
-            std::memset(&addr, 0, sizeof(addr));
-            addr.sin_family = AF_INET;
-            addr.sin_addr.s_addr = inet_addr(peer.c_str());
-            addr.sin_port = htons(port_);
-
-            ssize_t sent = sendto(socket_, data, size, 0,
-                                  (struct sockaddr*)&addr, sizeof(addr));
-            
-            if (sent > 0) {
-                anySent = true;
-            }
+    uint8_t* p = out;
+    if (count > 0) {
+        // Headers then data, oldest first, primary last
+        for (size_t i = count; i > 0; --i) {
+            const SentFrame& sent = previous(i);
+            const uint32_t offset = timestamp - sent.timestamp;
+            p[0] = 0x80 | RTP_PAYLOAD_OPUS;
+            p[1] = static_cast<uint8_t>(offset >> 6);
+            p[2] = static_cast<uint8_t>(((offset & 0x3F) << 2) | (sent.size >> 8));
+            p[3] = static_cast<uint8_t>(sent.size & 0xFF);
+            p += kRedBlockHeaderBytes;
         }
+        *p++ = RTP_PAYLOAD_OPUS;
+        for (size_t i = count; i > 0; --i) {
+            const SentFrame& sent = previous(i);
+            std::memcpy(p, sent.data.data(), sent.size);
+            p += sent.size;
+        }
+        redundantFramesSent_.add(count);
+        redundantBytesSent_.add(bytes - frameSize);
+    }
+    std::memcpy(p, frame, frameSize);
+    p += frameSize;
+
+    // This frame becomes history for the next packets
+    SentFrame& slot = history_[historyHead_];
+    slot.size = frameSize <= redundancy_.maxFrameBytes ? static_cast<uint16_t>(frameSize) : 0;
+    slot.seq = seq;
+    slot.timestamp = timestamp;
+    if (slot.size > 0) {
+        std::memcpy(slot.data.data(), frame, slot.size);
     }
+    historyHead_ = (historyHead_ + 1) % kMaxRedundancyDepth;
+    historyCount_ = std::min(historyCount_ + 1, kMaxRedundancyDepth);
 
-    return anySent;
+    redundantFrames = count;
+    return static_cast<size_t>(p - out);
 }
 
-void RtpPacketizer::addUnicastPeer(const char* ipAddress) {
-    std::lock_guard<std::mutex> lock(unicastMutex_);
-    
-    // Check if already exists
-    if (std::find(unicastPeers_.begin(), unicastPeers_.end(), ipAddress) 
-        == unicastPeers_.end()) {
-        unicastPeers_.push_back(ipAddress);
-        __android_log_print(ANDROID_LOG_INFO, TAG,
-            "Added unicast peer: %s", ipAddress);
+void RtpPacketizer::sendDuplicate(const uint8_t* packet, size_t length, uint16_t seq,
+                                  uint32_t timestamp) {
+    std::lock_guard<std::mutex> lock(redundancyMutex_);
+
+    // Byte-identical copy: under SRTP the receiver's replay window drops it
+    // when the original made it, and accepts it when the original was lost
+    if (heldLength_ > 0 && heldSeq_ == static_cast<uint16_t>(seq - 1) &&
+        timestamp - heldTimestamp_ <= kMaxDuplicateHoldTicks) {
+        if (sendToAll(heldPacket_.data(), heldLength_)) {
+            duplicatesSent_.add();
+        }
     }
-}
 
-void RtpPacketizer::clearUnicastPeers() {
-    std::lock_guard<std::mutex> lock(unicastMutex_);
-    unicastPeers_.clear();
+    std::memcpy(heldPacket_.data(), packet, length);
+    heldLength_ = length;
+    heldSeq_ = seq;
+    heldTimestamp_ = timestamp;
 }
 
-// ============================================================================
-// Receive Loop (PRODUCTION FIX: Non-blocking with timeout)
-// ============================================================================
+void RtpPacketizer::setRedundancy(RedundancyConfig config) {
+    config.depth = std::clamp<uint32_t>(config.depth, 1, kMaxRedundancyDepth);
+    config.maxFrameBytes = std::clamp<uint32_t>(config.maxFrameBytes, 1, kMaxRedundantFrameBytes);
 
-void RtpPacketizer::startReceiveLoop() {
-    if (receiveRunning_) {
-        return;
-    }
+    std::lock_guard<std::mutex> lock(redundancyMutex_);
+    redundancy_ = config;
+    historyHead_ = 0;
+    historyCount_ = 0;
+    heldLength_ = 0;
+    redundancyMode_.store(config.mode, std::memory_order_release);
+}
 
-    receiveRunning_ = true;
-    receiveThread_ = std::thread([this]() { receiveLoop(); });
+RedundancyConfig RtpPacketizer::getRedundancy() const {
+    std::lock_guard<std::mutex> lock(redundancyMutex_);
+    return redundancy_;
 }
 
-void RtpPacketizer::stopReceiveLoop() {
-    receiveRunning_ = false;
-    
-    // PRODUCTION FIX: Signal shutdown via pipe to unblock recvfrom()
-    if (shutdownPipe_[1] >= 0) {
-        char dummy = 1;
-        write(shutdownPipe_[1], &dummy, 1);
-    }
-    
-    if (receiveThread_.joinable()) {
-        // Wait up to 500ms for clean shutdown
-        auto future = std::async(std::launch::async, [this]() {
-            receiveThread_.join();
-        });
-        
-        if (future.wait_for(std::chrono::milliseconds(500)) == 
-            std::future_status::timeout) {
-            __android_log_print(ANDROID_LOG_WARN, TAG,
-                "Receive thread did not stop cleanly, detaching");
-            receiveThread_.detach();
+bool RtpPacketizer::sendToAll(const uint8_t* data, size_t size) {
+    size_t copies = 1;
+    if (impairments_[static_cast<size_t>(ImpairmentDirection::TRANSMIT)].active.load(
+            std::memory_order_acquire)) {
+        const ImpairmentDecision decision = impair(ImpairmentDirection::TRANSMIT);
+        if (decision.drop) {
+            return true;  // Lost on the air: the sender never knows
         }
+        copies = decision.duplicate ? 2 : 1;
     }
-}
 
-bool RtpPacketizer::waitForData(int timeoutMs) {
-    fd_set readfds;
-    FD_ZERO(&readfds);
-    FD_SET(socket_, &readfds);
-    
-    int maxFd = socket_;
-    
-    // Also watch shutdown pipe
-    if (shutdownPipe_[0] >= 0) {
-        FD_SET(shutdownPipe_[0], &readfds);
-        if (shutdownPipe_[0] > maxFd) {
-            maxFd = shutdownPipe_[0];
-        }
+    bool sent = false;
+    for (size_t i = 0; i < copies; ++i) {
+        sent = fanOut(data, size) || sent;
     }
+    return sent;
+}
 
-    struct timeval tv;
-    tv.tv_sec = timeoutMs / 1000;
-    tv.tv_usec = (timeoutMs % 1000) * 1000;
+bool RtpPacketizer::fanOut(const uint8_t* data, size_t size) {
+    // One iovec shared by every destination: same datagram, different address
+    struct iovec iov;
+    iov.iov_base = const_cast<uint8_t*>(data);
+    iov.iov_len = size;
 
-    int result = select(maxFd + 1, &readfds, nullptr, nullptr, &tv);
-    
-    if (result > 0) {
-        // Check if shutdown was signaled
-        if (shutdownPipe_[0] >= 0 && FD_ISSET(shutdownPipe_[0], &readfds)) {
-            char dummy;
-            read(shutdownPipe_[0], &dummy, 1);
-            return false;  // Shutdown requested
+    struct mmsghdr msgs[kSendBatchSize];
+    UnicastPeer* targets[kSendBatchSize];  // nullptr = multicast group or relay target
+    size_t count = 0;
+    bool anySent = false;
+
+    auto addTarget = [&](struct sockaddr_in* addr, UnicastPeer* peer) {
+        std::memset(&msgs[count], 0, sizeof(msgs[count]));
+        msgs[count].msg_hdr.msg_name = addr;
+        msgs[count].msg_hdr.msg_namelen = sizeof(*addr);
+        msgs[count].msg_hdr.msg_iov = &iov;
+        msgs[count].msg_hdr.msg_iovlen = 1;
+        targets[count] = peer;
+        count++;
+    };
+
+    auto onResult = [&](size_t i, bool ok) {
+        UnicastPeer* peer = targets[i];
+        if (ok) {
+            anySent = true;
+            if (peer) {
+                peer->consecutiveFailures.store(0, std::memory_order_relaxed);
+                peer->packetsSent.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+        sendFailures_.add();
+        if (peer) {
+            peer->consecutiveFailures.fetch_add(1, std::memory_order_relaxed);
+            peer->sendFailures.fetch_add(1, std::memory_order_relaxed);
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            __android_log_print(ANDROID_LOG_WARN, TAG,
+                "Multicast send failed: %s", strerror(errno));
+        }
+    };
+
+    // sendmmsg stops at the first failing destination; record it and resume after
+    auto flush = [&]() {
+        size_t i = 0;
+        while (i < count) {
+            int sent = sendmmsg(socket_, msgs + i, static_cast<unsigned int>(count - i), 0);
+            if (sent <= 0) {
+                onResult(i, false);
+                i++;
+                continue;
+            }
+            for (int k = 0; k < sent; ++k) {
+                onResult(i + k, true);
+            }
+            i += static_cast<size_t>(sent);
         }
-        return FD_ISSET(socket_, &readfds);
+        count = 0;
+    };
+
+    // Relay member: the reflector alone carries our packets to everyone
+    if (relay_.sendViaReflector()) {
+        struct sockaddr_in reflector;
+        std::memset(&reflector, 0, sizeof(reflector));
+        reflector.sin_family = AF_INET;
+        reflector.sin_port = htons(port_);
+        reflector.sin_addr.s_addr = reflectorAddress_.load(std::memory_order_relaxed);
+        addTarget(&reflector, nullptr);
+        flush();
+        return anySent;
     }
-    
-    return false;
-}
 
-void RtpPacketizer::receiveLoop() {
-    __android_log_print(ANDROID_LOG_INFO, TAG,
-        "RTP receive loop started");
+    // Send via multicast if available
+    if (multicastJoined_ && (transportMode_ == TransportMode::MULTICAST ||
+                             transportMode_ == TransportMode::AUTO)) {
+        addTarget(&multicastAddr_, nullptr);
+    }
 
-    uint8_t buffer[MAX_PACKET_SIZE];
-    struct sockaddr_in fromAddr;
-    socklen_t fromLen = sizeof(fromAddr);
+    // Reflector: our own voice reaches the unicast-only members directly
+    RelayTarget members[kMaxRelayMembers];
+    const size_t memberCount = relay_.role() == RelayRole::REFLECTOR
+        ? relay_.copyMembers(members, kMaxRelayMembers, htons(port_)) : 0;
+    for (size_t i = 0; i < memberCount; ++i) {
+        addTarget(&members[i].addr, nullptr);
+        if (count == kSendBatchSize) {
+            flush();
+        }
+    }
 
-    while (receiveRunning_) {
-        // PRODUCTION FIX: Wait for data with timeout (allows clean shutdown)
-        if (!waitForData(100)) {  // 100ms timeout
-            continue;
+    // Send to unicast peers (fallback mode) - lock-free read of the current list
+    peerReaders_.fetch_add(1);
+    const PeerList* peers = unicastPeers_.load();
+    for (const auto& peer : *peers) {
+        addTarget(&peer->addr, peer.get());
+        if (count == kSendBatchSize) {
+            flush();
         }
+    }
+    flush();
+    peerReaders_.fetch_sub(1);
 
-        ssize_t received = recvfrom(socket_, buffer, sizeof(buffer), 0,
-                                    (struct sockaddr*)&fromAddr, &fromLen);
+    return anySent;
+}
 
-        if (received > RTP_HEADER_SIZE) {
-            // Parse RTP header
-            RtpHeader* header = reinterpret_cast<RtpHeader*>(buffer);
-            uint32_t ssrc = ntohl(header->ssrc);
-            
-            // Ignore our own packets (loopback)
-            if (ssrc == ssrc_) {
-                continue;
-            }
+void RtpPacketizer::publishPeers(PeerList* peers) {
+    const PeerList* old = unicastPeers_.exchange(peers);
 
-            // Add to jitter buffer
-            jitterBuffer_.enqueue(buffer, received);
+    // A sender that incremented peerReaders_ before the exchange may still be
+    // walking the old list; later senders are guaranteed to see the new one.
+    while (peerReaders_.load() != 0) {
+        std::this_thread::yield();
+    }
+    delete old;
+}
 
-            // Notify callback with Opus payload
-            if (audioCallback_) {
-                audioCallback_(buffer + RTP_HEADER_SIZE,
-                              received - RTP_HEADER_SIZE,
-                              ssrc);
-            }
+bool RtpPacketizer::addUnicastPeer(const char* ipAddress) {
+    auto peer = std::make_shared<UnicastPeer>();
+    std::memset(&peer->addr, 0, sizeof(peer->addr));
+    peer->addr.sin_family = AF_INET;
+    peer->addr.sin_port = htons(port_);
+    if (inet_pton(AF_INET, ipAddress, &peer->addr.sin_addr) != 1) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Ignoring invalid unicast peer: %s", ipAddress);
+        return false;
+    }
+    std::strncpy(peer->address, ipAddress, sizeof(peer->address) - 1);
+    peer->address[sizeof(peer->address) - 1] = '\0';
 
-            packetsReceived_++;
-        } else if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
-            __android_log_print(ANDROID_LOG_ERROR, TAG,
-                "recvfrom error: %s", strerror(errno));
+    std::lock_guard<std::mutex> lock(unicastMutex_);
+    const PeerList* current = unicastPeers_.load();
+
+    // Check if already exists
+    for (const auto& existing : *current) {
+        if (existing->addr.sin_addr.s_addr == peer->addr.sin_addr.s_addr) {
+            return true;
         }
     }
 
+    auto* next = new PeerList(*current);
+    next->push_back(std::move(peer));
+    publishPeers(next);
+
     __android_log_print(ANDROID_LOG_INFO, TAG,
-        "RTP receive loop stopped");
+        "Added unicast peer: %s (%zu total)", ipAddress, next->size());
+    return true;
+}
+
+void RtpPacketizer::removeUnicastPeer(const char* ipAddress) {
+    struct in_addr target;
+    if (inet_pton(AF_INET, ipAddress, &target) != 1) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(unicastMutex_);
+    const PeerList* current = unicastPeers_.load();
+
+    auto* next = new PeerList();
+    next->reserve(current->size());
+    for (const auto& peer : *current) {
+        if (peer->addr.sin_addr.s_addr != target.s_addr) {
+            next->push_back(peer);
+        }
+    }
+    publishPeers(next);
+}
+
+void RtpPacketizer::clearUnicastPeers() {
+    std::lock_guard<std::mutex> lock(unicastMutex_);
+    publishPeers(new PeerList());
+}
+
+size_t RtpPacketizer::pruneUnicastPeers(uint32_t minConsecutiveFailures) {
+    std::lock_guard<std::mutex> lock(unicastMutex_);
+    const PeerList* current = unicastPeers_.load();
+
+    auto* next = new PeerList();
+    next->reserve(current->size());
+    for (const auto& peer : *current) {
+        const uint32_t failures = peer->consecutiveFailures.load(std::memory_order_relaxed);
+        if (failures >= minConsecutiveFailures) {
+            __android_log_print(ANDROID_LOG_INFO, TAG,
+                "Pruning unicast peer %s (%u consecutive send failures)",
+                peer->address, failures);
+        } else {
+            next->push_back(peer);
+        }
+    }
+
+    const size_t removed = current->size() - next->size();
+    if (removed == 0) {
+        delete next;
+        return 0;
+    }
+    publishPeers(next);
+    return removed;
+}
+
+size_t RtpPacketizer::getUnicastPeerCount() const {
+    std::lock_guard<std::mutex> lock(unicastMutex_);
+    return unicastPeers_.load()->size();
+}
+
+// ============================================================================
+// Scan channels
+// ============================================================================
+
+int RtpPacketizer::openChannelSocket(const char* multicastGroup, uint16_t port) {
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, multicastGroup, &addr.sin_addr) != 1 ||
+        !IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Scan channel needs an IPv4 multicast group: %s", multicastGroup);
+        return -1;
+    }
+
+    const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Failed to create scan socket: %s", strerror(errno));
+        return -1;
+    }
+
+    // Shares the port with the home socket and other scan channels
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    restrictMulticastToJoined(fd);
+    if (threadManager_) {
+        enableReceiveTimestamps(fd);
+    }
+
+    // Bound to the group address: unicast and other groups never reach it
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG,
+            "Failed to bind scan socket %s:%u: %s", multicastGroup, port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr = addr.sin_addr;
+    mreq.imr_interface.s_addr = INADDR_ANY;
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Failed to join scan group %s: %s", multicastGroup, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool RtpPacketizer::joinChannel(uint32_t channelId, const char* multicastGroup, uint16_t port) {
+    if (channelId == kHomeChannel || !loop_.isInitialized()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(channelMutex_);
+    ScanChannel* freeSlot = nullptr;
+    for (auto& channel : channels_) {
+        if (channel.socket.load() < 0) {
+            if (!freeSlot) {
+                freeSlot = &channel;
+            }
+        } else if (channel.id == channelId) {
+            __android_log_print(ANDROID_LOG_WARN, TAG,
+                "Scan channel %u already joined (%s:%u)", channelId, channel.group, channel.port);
+            return false;
+        }
+    }
+    if (!freeSlot) {
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "Scan table full (%zu channels), cannot join %u", channels_.size(), channelId);
+        return false;
+    }
+
+    const int fd = openChannelSocket(multicastGroup, port);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (!loop_.watch(fd, [this, fd, channelId]() {
+            drainSocket(fd, channelId, *receiveBatch_, delayLine_);
+        })) {
+        close(fd);
+        return false;
+    }
+    freeSlot->id = channelId;
+    std::strncpy(freeSlot->group, multicastGroup, sizeof(freeSlot->group) - 1);
+    freeSlot->port = port;
+    freeSlot->socket.store(fd);
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Joined scan channel %u: %s:%u", channelId, multicastGroup, port);
+    return true;
+}
+
+bool RtpPacketizer::leaveChannel(uint32_t channelId) {
+    std::lock_guard<std::mutex> lock(channelMutex_);
+    for (auto& channel : channels_) {
+        if (channel.socket.load() < 0 || channel.id != channelId) {
+            continue;
+        }
+
+        // Returns once no drain of fd is in progress
+        const int fd = channel.socket.exchange(-1);
+        loop_.unwatch(fd);
+        close(fd);  // Also drops the group membership
+
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "Left scan channel %u: %s:%u", channelId, channel.group, channel.port);
+        channel.id = 0;
+        return true;
+    }
+    return false;
+}
+
+size_t RtpPacketizer::getChannelCount() const {
+    std::lock_guard<std::mutex> lock(channelMutex_);
+    return static_cast<size_t>(std::count_if(channels_.begin(), channels_.end(),
+        [](const ScanChannel& channel) { return channel.socket.load() >= 0; }));
+}
+
+void RtpPacketizer::getTelemetry(TelemetrySnapshot& snapshot) const {
+    snapshot.send.packetsSent = packetsSent_.load();
+    snapshot.send.bytesSent = bytesSent_.load();
+    snapshot.send.sendFailures = sendFailures_.load();
+
+    using Receive = TelemetryBlock<ReceiveField>;
+    const auto receive = receiveTelemetry_.snapshot();
+    snapshot.receive.packetsReceived = receive[Receive::index(ReceiveField::PACKETS)];
+    snapshot.receive.bytesReceived = receive[Receive::index(ReceiveField::BYTES)];
+    snapshot.receive.receiveBatches = receive[Receive::index(ReceiveField::BATCHES)];
+    snapshot.receive.poolDrops = receive[Receive::index(ReceiveField::POOL_DROPS)];
+
+    const RtcpStats rtcp = rtcp_.getStats();
+    snapshot.rtcp.reportsSent = rtcp.reportsSent;
+    snapshot.rtcp.bytesSent = rtcp.bytesSent;
+    snapshot.rtcp.reportsReceived = rtcp.reportsReceived;
+    snapshot.rtcp.malformed = rtcp.malformed;
+
+    if (srtp_) {
+        const SrtpStats srtp = srtp_->getStats();
+        snapshot.srtp.keyEpoch = srtp_->isActive() ? srtp.keyEpoch : 0;
+        snapshot.srtp.rtpProtected = srtp.rtpProtected;
+        snapshot.srtp.rtpVerified = srtp.rtpVerified;
+        snapshot.srtp.authFailures = srtp.authFailures;
+        snapshot.srtp.replayDrops = srtp.replayDrops;
+        snapshot.srtp.previousEpochPackets = srtp.previousEpochPackets;
+    }
+
+    if (floor_) {
+        const FloorStats floor = floor_->getStats();
+        snapshot.floor.state = static_cast<uint64_t>(floor_->getState());
+        snapshot.floor.holderSsrc = floor_->getHolder();
+        snapshot.floor.requests = floor.requests;
+        snapshot.floor.grants = floor.grants;
+        snapshot.floor.denials = floor.denials;
+        snapshot.floor.revocations = floor.revocations;
+        snapshot.floor.lastGrantMicros = floor.lastGrantMicros;
+    }
+
+    snapshot.redundancy.framesSent = redundantFramesSent_.load();
+    snapshot.redundancy.bytesSent = redundantBytesSent_.load();
+    snapshot.redundancy.duplicatesSent = duplicatesSent_.load();
+
+    const RelayStats relay = relay_.getStats();
+    snapshot.relay.role = static_cast<uint64_t>(relay_.role());
+    snapshot.relay.members = relay.members;
+    snapshot.relay.packetsForwarded = relay.packetsForwarded;
+    snapshot.relay.bytesForwarded = relay.bytesForwarded;
+    snapshot.relay.duplicatesDropped = relay.duplicatesDropped;
+    snapshot.relay.viaReflector = relay_.sendViaReflector() ? 1 : 0;
+}
+
+// ============================================================================
+// RTCP transport
+// ============================================================================
+
+void RtpPacketizer::setRtcpConfig(const RtcpConfig& config) {
+    rtcp_.configure(config);
+    if (config.mode == RtcpMode::SEPARATE_PORT && socket_ >= 0) {
+        openRtcpSocket();
+    }
+    // Report schedule restarts: the receive thread re-arms its timeout
+    wakeReceiveLoop();
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "RTCP %s (session %u bps, min interval %u ms, XR %s)",
+        config.mode == RtcpMode::OFF ? "off" :
+        config.mode == RtcpMode::MUX ? "muxed" : "on port + 1",
+        config.sessionBandwidthBps, config.minIntervalMs,
+        config.extendedReports ? "on" : "off");
+}
+
+bool RtpPacketizer::openRtcpSocket() {
+    std::lock_guard<std::mutex> lock(rtcpMutex_);
+    if (rtcpSocket_.load() >= 0) {
+        return true;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    restrictMulticastToJoined(fd);
+    applyMulticastLoop(fd);
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(static_cast<uint16_t>(port_ + 1));
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        // Another app holds port + 1: mux rather than run without feedback
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "RTCP port %u unavailable (%s), multiplexing RTCP on the RTP port",
+            port_ + 1, strerror(errno));
+        close(fd);
+        RtcpConfig config = rtcp_.getConfig();
+        config.mode = RtcpMode::MUX;
+        rtcp_.configure(config);
+        return false;
+    }
+
+    if (multicastJoined_) {
+        struct ip_mreq mreq;
+        mreq.imr_multiaddr.s_addr = inet_addr(multicastGroup_);
+        mreq.imr_interface.s_addr = INADDR_ANY;
+        setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+    }
+
+    rtcpSocket_.store(fd);
+    loop_.watch(fd, [this]() { drainRtcpSocket(); });
+    __android_log_print(ANDROID_LOG_INFO, TAG, "RTCP socket bound to port %u", port_ + 1);
+    return true;
+}
+
+void RtpPacketizer::sendRtcp(const uint8_t* data, size_t size) {
+    const RtcpMode mode = rtcp_.getConfig().mode;
+    if (mode == RtcpMode::OFF) {
+        return;
+    }
+    sendControl(data, size, mode != RtcpMode::SEPARATE_PORT);
+}
+
+void RtpPacketizer::sendControl(const uint8_t* data, size_t size, bool muxed) {
+    const int fd = muxed ? socket_ : rtcpSocket_.load();
+    if (fd < 0) {
+        return;
+    }
+    const uint16_t port = htons(muxed ? port_ : static_cast<uint16_t>(port_ + 1));
+
+    // SRTCP: encrypt a copy (callers pass const report buffers)
+    uint8_t protectedReport[kRtcpBufferBytes + kSrtcpOverheadBytes];
+    if (srtp_ && srtp_->isActive()) {
+        if (size > kRtcpBufferBytes) {
+            return;
+        }
+        std::memcpy(protectedReport, data, size);
+        size = srtp_->protectRtcp(protectedReport, size, sizeof(protectedReport));
+        if (size == 0) {
+            return;
+        }
+        data = protectedReport;
+    }
+
+    // A few hundred bytes every few seconds: plain sendto() per destination
+    auto sendTo = [&](struct sockaddr_in addr) {
+        addr.sin_port = port;
+        sendto(fd, data, size, 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    };
+
+    if (relay_.sendViaReflector()) {
+        struct sockaddr_in reflector;
+        std::memset(&reflector, 0, sizeof(reflector));
+        reflector.sin_family = AF_INET;
+        reflector.sin_addr.s_addr = reflectorAddress_.load(std::memory_order_relaxed);
+        sendTo(reflector);
+        return;
+    }
+    if (multicastJoined_) {
+        sendTo(multicastAddr_);
+    }
+    RelayTarget members[kMaxRelayMembers];
+    const size_t memberCount = relay_.role() == RelayRole::REFLECTOR
+        ? relay_.copyMembers(members, kMaxRelayMembers, port) : 0;
+    for (size_t i = 0; i < memberCount; ++i) {
+        sendTo(members[i].addr);
+    }
+    peerReaders_.fetch_add(1);
+    for (const auto& peer : *unicastPeers_.load()) {
+        sendTo(peer->addr);
+    }
+    peerReaders_.fetch_sub(1);
+}
+
+int64_t RtpPacketizer::serviceRtcp(int64_t nowMicros) {
+    if (!isRunning_ || rtcp_.getConfig().mode == RtcpMode::OFF) {
+        return 0;
+    }
+    uint8_t report[kRtcpBufferBytes];
+    const size_t length = rtcp_.buildReport(report, sizeof(report), nowMicros);
+    if (length > 0) {
+        sendRtcp(report, length);
+    }
+    return rtcp_.nextReportMicros();
+}
+
+void RtpPacketizer::drainRtcpSocket() {
+    const int fd = rtcpSocket_.load();
+    if (fd < 0) {
+        return;
+    }
+    uint8_t buffer[kRtcpBufferBytes + kSrtcpOverheadBytes];
+    for (;;) {
+        struct sockaddr_in from;
+        socklen_t fromLength = sizeof(from);
+        const ssize_t length = recvfrom(fd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                        reinterpret_cast<struct sockaddr*>(&from), &fromLength);
+        if (length <= 0) {
+            break;
+        }
+        if (RtcpSession::isRtcp(buffer, static_cast<size_t>(length))) {
+            receiveControl(fd, htons(static_cast<uint16_t>(port_ + 1)), buffer,
+                           static_cast<size_t>(length), from.sin_addr.s_addr,
+                           traceClockMicros());
+        }
+    }
+}
+
+void RtpPacketizer::receiveControl(int fd, uint16_t port, uint8_t* data, size_t length,
+                                   in_addr_t fromAddress, int64_t receiveMicros) {
+    // Reflector: keep the bytes as they came, SRTCP unprotect works in place
+    uint8_t original[kRtcpBufferBytes + kSrtcpOverheadBytes];
+    const bool reflector = relay_.role() == RelayRole::REFLECTOR && length <= sizeof(original);
+    if (reflector) {
+        std::memcpy(original, data, length);
+    }
+    const size_t originalLength = length;
+    // Only what authenticates is forwarded: a stranger cannot use us to amplify
+    if (!unprotectRtcp(data, length, receiveMicros)) {
+        return;
+    }
+    if (reflector && !RtpRelay::isRelayMessage(data, length)) {
+        relayControl(fd, port, original, originalLength, fromAddress, receiveMicros);
+    }
+    onControlReceived(data, length, fromAddress, receiveMicros);
+}
+
+void RtpPacketizer::onControlReceived(uint8_t* data, size_t length, uint32_t fromAddress,
+                                      int64_t receiveMicros) {
+    if (RtpRelay::isRelayMessage(data, length)) {
+        if (relay_.onMessage(data, length, fromAddress, receiveMicros)) {
+            sendRelayMessage(RelayMessageType::ACK, fromAddress);
+        }
+        return;
+    }
+    if (floor_) {
+        if (FloorControl::isFloorMessage(data, length)) {
+            FloorOutbox out;
+            floor_->onMessage(data, length, receiveMicros, out);
+            sendFloorMessages(out);
+            return;
+        }
+        uint32_t sender;
+        std::memcpy(&sender, data + 4, sizeof(sender));
+        floor_->onPeerHeard(ntohl(sender), receiveMicros);
+    }
+    rtcp_.onRtcpReceived(data, length, fromAddress, receiveMicros);
+}
+
+// ============================================================================
+// Floor control transport
+// ============================================================================
+
+void RtpPacketizer::setFloorControl(std::shared_ptr<FloorControl> floor) {
+    floor_ = std::move(floor);
+    if (floor_) {
+        floor_->setLocalSsrc(ssrc_);
+    }
+}
+
+FloorState RtpPacketizer::requestFloor(uint8_t priority, bool emergency) {
+    if (!floor_) {
+        return FloorState::GRANTED;
+    }
+    FloorOutbox out;
+    const FloorState state = floor_->request(priority, emergency, traceClockMicros(), out);
+    sendFloorMessages(out);
+
+    // New retransmit/refresh deadlines: wake the receive thread to re-arm
+    wakeReceiveLoop();
+    return state;
+}
+
+void RtpPacketizer::wakeReceiveLoop() {
+    if (loop_.isRunning()) {
+        loop_.wake();
+    }
+}
+
+void RtpPacketizer::releaseFloor() {
+    if (!floor_) {
+        return;
+    }
+    FloorOutbox out;
+    floor_->release(traceClockMicros(), out);
+    sendFloorMessages(out);
+    wakeReceiveLoop();
+}
+
+void RtpPacketizer::sendFloorMessages(const FloorOutbox& out) {
+    for (size_t i = 0; i < out.count; ++i) {
+        sendControl(out.packets[i].data(), kFloorMessageBytes, true);
+    }
+}
+
+int64_t RtpPacketizer::serviceFloor(int64_t nowMicros) {
+    if (!floor_) {
+        return 0;
+    }
+    FloorOutbox out;
+    floor_->service(nowMicros, out);
+    sendFloorMessages(out);
+    return floor_->nextDeadlineMicros();
+}
+
+// ============================================================================
+// Relay transport
+// ============================================================================
+
+void RtpPacketizer::setRelayConfig(const RelayConfig& config) {
+    const RelayConfig previous = relay_.getConfig();
+    const in_addr_t oldReflector = reflectorAddress_.load();
+    const in_addr_t newReflector = config.role == RelayRole::MEMBER ? config.reflectorAddress : 0;
+
+    // Tell the old reflector we are gone rather than wait for its timeout
+    if (isRunning_ && oldReflector != 0 && oldReflector != newReflector) {
+        sendRelayMessage(RelayMessageType::LEAVE, oldReflector);
+    }
+
+    relay_.configure(config, traceClockMicros());
+    reflectorAddress_.store(newReflector);
+
+    // CRITICAL FIX: a reflector must not hear its own group forwards, or it
+    // would hand members their own packets back
+    if (previous.role != config.role) {
+        applyMulticastLoop(socket_);
+        applyMulticastLoop(rtcpSocket_.load());
+    }
+
+    // A member's first JOIN is due now
+    wakeReceiveLoop();
+
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Relay role %u", static_cast<unsigned>(config.role));
+}
+
+size_t RtpPacketizer::getRelayMembers(RelayMemberInfo* out, size_t maxEntries) const {
+    return relay_.getMembers(out, maxEntries, traceClockMicros());
+}
+
+void RtpPacketizer::applyMulticastLoop(int fd) {
+    if (fd < 0) {
+        return;
+    }
+    const unsigned char loop = relay_.role() == RelayRole::REFLECTOR ? 0 : 1;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+}
+
+void RtpPacketizer::sendRelayMessage(RelayMessageType type, in_addr_t to) {
+    if (socket_ < 0 || to == 0) {
+        return;
+    }
+    uint8_t message[kRelayMessageBytes + kSrtcpOverheadBytes];
+    size_t length = relay_.buildMessage(type, message);
+    if (srtp_ && srtp_->isActive()) {
+        length = srtp_->protectRtcp(message, length, sizeof(message));
+        if (length == 0) {
+            return;
+        }
+    }
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    addr.sin_addr.s_addr = to;
+    sendto(socket_, message, length, 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+}
+
+int64_t RtpPacketizer::serviceRelay(int64_t nowMicros) {
+    if (!isRunning_) {
+        return 0;
+    }
+    if (relay_.role() != RelayRole::OFF) {
+        bool sendJoin = false;
+        relay_.service(nowMicros, sendJoin);
+        if (sendJoin) {
+            sendRelayMessage(RelayMessageType::JOIN, reflectorAddress_.load());
+        }
+    }
+    return relay_.nextDeadlineMicros();
+}
+
+// Forwards of one receive batch, sent in as few sendmmsg() calls as fit
+struct RtpPacketizer::RelayQueue {
+    struct mmsghdr msgs[kRelayQueueSize];
+    struct iovec iovecs[kRelayQueueSize];
+    RelayTarget targets[kRelayQueueSize];
+    bool sent[kRelayQueueSize];
+    size_t bytes[kRelayQueueSize];
+    size_t count = 0;
+};
+
+void RtpPacketizer::flushRelayed(int fd, RelayQueue& queue) {
+    // sendmmsg stops at the first failing destination; record it and resume after
+    size_t i = 0;
+    while (i < queue.count) {
+        const int sent = sendmmsg(fd, queue.msgs + i, static_cast<unsigned int>(queue.count - i), 0);
+        if (sent <= 0) {
+            queue.sent[i++] = false;
+            continue;
+        }
+        for (int k = 0; k < sent; ++k) {
+            queue.sent[i + k] = true;
+        }
+        i += static_cast<size_t>(sent);
+    }
+    if (queue.count > 0) {
+        relay_.recordForwards(queue.targets, queue.sent, queue.bytes, queue.count);
+    }
+    queue.count = 0;
+}
+
+void RtpPacketizer::relayControl(int fd, uint16_t port, const uint8_t* data, size_t length,
+                                 in_addr_t fromAddress, int64_t receiveMicros) {
+    struct sockaddr_in group = multicastAddr_;
+    group.sin_port = port;
+    RelayTarget targets[kMaxRelayTargets];
+    const size_t count = relay_.route(data, length, false, true, fromAddress, port,
+                                      multicastJoined_ ? &group : nullptr, receiveMicros,
+                                      targets, kMaxRelayTargets);
+    // A few packets a second per member: plain sendto() per destination
+    bool sent[kMaxRelayTargets];
+    size_t bytes[kMaxRelayTargets];
+    for (size_t i = 0; i < count; ++i) {
+        sent[i] = sendto(fd, data, length, 0, reinterpret_cast<const struct sockaddr*>(&targets[i].addr),
+                         sizeof(targets[i].addr)) >= 0;
+        bytes[i] = length;
+    }
+    if (count > 0) {
+        relay_.recordForwards(targets, sent, bytes, count);
+    }
+}
+
+bool RtpPacketizer::unprotectRtcp(uint8_t* data, size_t& length, int64_t receiveMicros) {
+    if (!srtp_ || !srtp_->isActive()) {
+        return true;
+    }
+    // Our own compound packet looped back: RtcpSession ignores it anyway,
+    // so skip the crypto (and keep our SSRC out of the sender table)
+    uint32_t sender;
+    std::memcpy(&sender, data + 4, sizeof(sender));
+    if (ntohl(sender) == ssrc_) {
+        return false;
+    }
+    const SrtpStatus status = srtp_->unprotectRtcp(data, length, receiveMicros);
+    return status == SrtpStatus::OK || status == SrtpStatus::NO_KEY;
+}
+
+size_t RtpPacketizer::getLinkQuality(LinkQuality* out, size_t maxEntries) const {
+    return rtcp_.getLinkQuality(out, maxEntries, traceClockMicros());
+}
+
+void RtpPacketizer::setImpairment(ImpairmentDirection direction,
+                                  std::unique_ptr<NetworkImpairment> impairment) {
+    ImpairmentStage& stage = impairments_[static_cast<size_t>(direction)];
+    const bool active = impairment && impairment->isActive();
+    const char* name = direction == ImpairmentDirection::TRANSMIT ? "TX" : "RX";
+
+    if (active) {
+        const ImpairmentProfile& p = impairment->getProfile();
+        __android_log_print(ANDROID_LOG_WARN, TAG,
+            "%s impairment ON (seed=%llu): loss=%.1f%% burst=%.1f/%.1f/%.1f%% dup=%.1f%% "
+            "reorder=%.1f%%+%ums delay=%ums jitter=%ums/%d trace=%zu",
+            name, static_cast<unsigned long long>(p.seed), p.lossPercent,
+            p.burstEnterPercent, p.burstExitPercent, p.burstLossPercent,
+            p.duplicatePercent, p.reorderPercent, p.reorderDelayMs,
+            p.delayMs, p.jitterMs, static_cast<int>(p.jitter),
+            impairment->getTraceLength());
+    } else {
+        __android_log_print(ANDROID_LOG_INFO, TAG, "%s impairment off", name);
+    }
+
+    std::unique_ptr<NetworkImpairment> old;  // Freed after the lock is released
+    {
+        std::lock_guard<std::mutex> lock(stage.mutex);
+        old = std::move(stage.engine);
+        stage.engine = active ? std::move(impairment) : nullptr;
+        stage.telemetry.reset();
+        stage.active.store(active, std::memory_order_release);
+    }
+}
+
+ImpairmentStats RtpPacketizer::getImpairmentStats(ImpairmentDirection direction) const {
+    using Block = TelemetryBlock<ImpairmentField>;
+    const auto values = impairments_[static_cast<size_t>(direction)].telemetry.snapshot();
+    ImpairmentStats stats;
+    stats.packets = values[Block::index(ImpairmentField::PACKETS)];
+    stats.dropped = values[Block::index(ImpairmentField::DROPPED)];
+    stats.duplicated = values[Block::index(ImpairmentField::DUPLICATED)];
+    stats.delayed = values[Block::index(ImpairmentField::DELAYED)];
+    stats.reordered = values[Block::index(ImpairmentField::REORDERED)];
+    stats.overflows = values[Block::index(ImpairmentField::OVERFLOWS)];
+    return stats;
+}
+
+ImpairmentDecision RtpPacketizer::impair(ImpairmentDirection direction) {
+    ImpairmentStage& stage = impairments_[static_cast<size_t>(direction)];
+    std::lock_guard<std::mutex> lock(stage.mutex);
+    if (!stage.engine) {
+        return ImpairmentDecision{};  // Cleared between the flag check and the lock
+    }
+
+    const ImpairmentDecision decision = stage.engine->next();
+    stage.telemetry.beginUpdate();
+    stage.telemetry.add(ImpairmentField::PACKETS);
+    if (decision.drop) {
+        stage.telemetry.add(ImpairmentField::DROPPED);
+    }
+    if (decision.duplicate) {
+        stage.telemetry.add(ImpairmentField::DUPLICATED);
+    }
+    if (decision.reordered) {
+        stage.telemetry.add(ImpairmentField::REORDERED);
+    }
+    if (!decision.drop && decision.delayMicros > 0 && direction == ImpairmentDirection::RECEIVE) {
+        stage.telemetry.add(ImpairmentField::DELAYED);
+    }
+    stage.telemetry.endUpdate();
+    return decision;
+}
+
+// ============================================================================
+// Receive Loop (PRODUCTION FIX: Non-blocking with timeout)
+// ============================================================================
+
+size_t RtpPacketizer::rtpHeaderLength(const uint8_t* packet, size_t length) {
+    if (length < static_cast<size_t>(RTP_HEADER_SIZE) || (packet[0] >> 6) != RTP_VERSION) {
+        return 0;
+    }
+    size_t offset = RTP_HEADER_SIZE + 4 * (packet[0] & 0x0F);
+    if (packet[0] & 0x10) {
+        if (offset + 4 > length) {
+            return 0;
+        }
+        const size_t extWords = (static_cast<size_t>(packet[offset + 2]) << 8) |
+                                packet[offset + 3];
+        offset += 4 + extWords * 4;
+    }
+    return offset <= length ? offset : 0;
+}
+
+bool RtpPacketizer::parseRtpPacket(const uint8_t* packet, size_t length,
+                                   RtpPacketInfo& info,
+                                   size_t& payloadOffset, size_t& payloadSize,
+                                   PacketTimestamps* timestamps) {
+    if (length <= static_cast<size_t>(RTP_HEADER_SIZE)) {
+        return false;
+    }
+
+    const uint8_t vpxcc = packet[0];
+    if ((vpxcc >> 6) != RTP_VERSION) {
+        return false;
+    }
+
+    // Fixed header + CSRC list
+    size_t offset = RTP_HEADER_SIZE + 4 * (vpxcc & 0x0F);
+
+    // Header extension (RFC 3550 5.3.1): 16-bit profile, 16-bit length in words
+    if (vpxcc & 0x10) {
+        if (offset + 4 > length) {
+            return false;
+        }
+        const uint16_t profile = static_cast<uint16_t>((packet[offset] << 8) | packet[offset + 1]);
+        const size_t extWords = (static_cast<size_t>(packet[offset + 2]) << 8) |
+                                packet[offset + 3];
+        const size_t extEnd = offset + 4 + extWords * 4;
+        if (timestamps && profile == kRtpOneByteExtensionProfile && extEnd <= length) {
+            parseLatencyExtension(packet + offset + 4, packet + extEnd, *timestamps);
+        }
+        offset = extEnd;
+    }
+
+    size_t end = length;
+    if (vpxcc & 0x20) {
+        // Padding: last octet is the pad count
+        const uint8_t pad = packet[length - 1];
+        if (pad == 0 || pad > length - offset) {
+            return false;
+        }
+        end -= pad;
+    }
+
+    if (offset >= end) {
+        return false;
+    }
+
+    RtpHeader header;
+    std::memcpy(&header, packet, RTP_HEADER_SIZE);
+    info.seq = ntohs(header.seq);
+    info.timestamp = ntohl(header.timestamp);
+    info.ssrc = ntohl(header.ssrc);
+    info.marker = (header.mpt & 0x80) != 0;
+
+    payloadOffset = offset;
+    payloadSize = end - offset;
+    return true;
+}
+
+void RtpPacketizer::startReceiveLoop() {
+    if (loop_.isRunning()) {
+        return;
+    }
+
+    if (!packetPool_) {
+        packetPool_ = std::make_shared<PacketPool>();
+    }
+    // All per-batch bookkeeping is allocated once, up front
+    receiveBatch_ = std::make_unique<ReceiveBatch>();
+
+    if (loop_.start(threadManager_.get(), ThreadRole::NETWORK, "ptt-receive")) {
+        __android_log_print(ANDROID_LOG_INFO, TAG,
+            "RTP receive loop started (batch=%zu)", kRecvBatchSize);
+    }
+}
+
+void RtpPacketizer::stopReceiveLoop() {
+    // PRODUCTION FIX: handlers never block, so the join is bounded; the
+    // thread is never detached with this object about to be destroyed
+    loop_.stop();
+
+    // Receive thread is gone: its buffers go back to the pool now, while
+    // the pool is certain to be alive
+    delayLine_.clear();
+    receiveBatch_.reset();
+}
+
+void RtpPacketizer::handleDatagram(PacketPtr packet, size_t length, int64_t receiveMicros,
+                                   uint32_t channel) {
+    if (length <= static_cast<size_t>(RTP_HEADER_SIZE)) {
+        return;
+    }
+
+    // SRTP: drop loopback before spending crypto on it, then verify (replay
+    // window, tag) and decrypt in place. Padding is inside the ciphertext,
+    // so parsing waits until after.
+    if (srtp_ && srtp_->isActive()) {
+        const size_t headerLength = rtpHeaderLength(packet->data, length);
+        if (headerLength == 0) {
+            return;
+        }
+        uint32_t sender;
+        std::memcpy(&sender, packet->data + 8, sizeof(sender));
+        if (ntohl(sender) == ssrc_) {
+            return;
+        }
+        const SrtpStatus status = srtp_->unprotectRtp(packet->data, length, headerLength,
+                                                      receiveMicros);
+        if (status != SrtpStatus::OK && status != SrtpStatus::NO_KEY) {
+            return;
+        }
+    }
+
+    RtpPacketInfo info;
+    size_t payloadOffset = 0;
+    size_t payloadSize = 0;
+    packet->timestamps = PacketTimestamps{};
+    packet->timestamps.receiveMicros = receiveMicros;
+    if (!parseRtpPacket(packet->data, length, info, payloadOffset, payloadSize,
+                        &packet->timestamps)) {
+        return;
+    }
+    info.channel = channel;
+
+    // Ignore our own packets (loopback)
+    if (info.ssrc == ssrc_) {
+        return;
+    }
+
+    // Reception statistics for our receiver reports (home talkgroup only)
+    if (channel == kHomeChannel) {
+        rtcp_.onRtpReceived(info, receiveMicros);
+        if (floor_) {
+            floor_->onPeerHeard(info.ssrc, receiveMicros);
+        }
+    }
+
+    // RED: copy the repeated frames out before the primary moves on (the
+    // decoder may release it at once), deliver them after it
+    std::array<PacketPtr, kMaxRedundancyDepth> redundantFrames;
+    std::array<RtpPacketInfo, kMaxRedundancyDepth> redundantInfos;
+    size_t redundantCount = 0;
+    if ((packet->data[1] & 0x7F) == RTP_PAYLOAD_RED &&
+        !splitRedundant(packet, info, payloadOffset, payloadSize,
+                        redundantFrames, redundantInfos, redundantCount)) {
+        return;
+    }
+
+    packet->length = static_cast<uint16_t>(length);
+    packet->payloadOffset = static_cast<uint16_t>(payloadOffset);
+    packet->payloadLength = static_cast<uint16_t>(payloadSize);
+
+    receiveTelemetry_.beginUpdate();
+    receiveTelemetry_.add(ReceiveField::PACKETS);
+    receiveTelemetry_.add(ReceiveField::BYTES, length);
+    receiveTelemetry_.endUpdate();
+
+    // Ownership passes downstream; jitter buffering happens in the receive streams
+    if (audioCallback_) {
+        audioCallback_(std::move(packet), info);
+        for (size_t i = 0; i < redundantCount; ++i) {
+            audioCallback_(std::move(redundantFrames[i]), redundantInfos[i]);
+        }
+    }
+}
+
+bool RtpPacketizer::splitRedundant(const PacketPtr& packet, const RtpPacketInfo& info,
+                                   size_t& payloadOffset, size_t& payloadSize,
+                                   std::array<PacketPtr, kMaxRedundancyDepth>& frames,
+                                   std::array<RtpPacketInfo, kMaxRedundancyDepth>& infos,
+                                   size_t& frameCount) {
+    const uint8_t* payload = packet->data + payloadOffset;
+    const size_t size = payloadSize;
+
+    // Block headers up to the primary's (F = 0)
+    struct Block {
+        uint32_t timestampOffset;
+        size_t length;
+        uint8_t payloadType;
+    };
+    std::array<Block, kMaxRedBlocks> blocks;
+    size_t blockCount = 0;
+    size_t pos = 0;
+    size_t dataBytes = 0;
+    while (true) {
+        if (pos >= size) {
+            return false;
+        }
+        if ((payload[pos] & 0x80) == 0) {
+            pos++;
+            break;
+        }
+        if (pos + kRedBlockHeaderBytes > size || blockCount == kMaxRedBlocks) {
+            return false;
+        }
+        Block& block = blocks[blockCount++];
+        block.payloadType = payload[pos] & 0x7F;
+        block.timestampOffset = (static_cast<uint32_t>(payload[pos + 1]) << 6) |
+                                (payload[pos + 2] >> 2);
+        block.length = (static_cast<size_t>(payload[pos + 2] & 0x03) << 8) | payload[pos + 3];
+        dataBytes += block.length;
+        pos += kRedBlockHeaderBytes;
+    }
+    if (pos + dataBytes >= size) {
+        return false;   // No room left for the primary
+    }
+
+    // Only the newest copies we can hold are worth a pooled buffer; their
+    // sequence numbers count back from the primary (senders repeat a
+    // contiguous run)
+    frameCount = 0;
+    size_t dataOffset = pos;
+    const size_t firstKept = blockCount > kMaxRedundancyDepth ? blockCount - kMaxRedundancyDepth : 0;
+    for (size_t i = 0; i < blockCount; ++i) {
+        const Block& block = blocks[i];
+        const size_t offset = dataOffset;
+        dataOffset += block.length;
+        if (i < firstKept || block.length == 0 || block.payloadType != RTP_PAYLOAD_OPUS) {
+            continue;
+        }
+        PacketPtr copy = packetPool_->acquire(block.length);
+        if (!copy) {
+            receiveTelemetry_.increment(ReceiveField::POOL_DROPS);
+            continue;
+        }
+        std::memcpy(copy->data, payload + offset, block.length);
+        copy->length = static_cast<uint16_t>(block.length);
+        copy->payloadOffset = 0;
+        copy->payloadLength = static_cast<uint16_t>(block.length);
+        copy->timestamps = PacketTimestamps{};
+        copy->timestamps.receiveMicros = packet->timestamps.receiveMicros;
+
+        RtpPacketInfo& copyInfo = infos[frameCount];
+        copyInfo = info;
+        copyInfo.seq = static_cast<uint16_t>(info.seq - (blockCount - i));
+        copyInfo.timestamp = info.timestamp - block.timestampOffset;
+        copyInfo.marker = false;
+        copyInfo.redundant = true;
+        frames[frameCount++] = std::move(copy);
+    }
+
+    payloadOffset += dataOffset;
+    payloadSize = size - dataOffset;
+    return true;
+}
+
+void RtpPacketizer::ingestDatagram(PacketPtr packet, size_t length, int64_t receiveMicros,
+                                   uint32_t channel, ImpairmentDelayLine& delayLine) {
+    if (!impairments_[static_cast<size_t>(ImpairmentDirection::RECEIVE)].active.load(
+            std::memory_order_acquire)) {
+        handleDatagram(std::move(packet), length, receiveMicros, channel);
+        return;
+    }
+
+    const ImpairmentDecision decision = impair(ImpairmentDirection::RECEIVE);
+    if (decision.drop) {
+        return;
+    }
+    if (decision.duplicate) {
+        if (PacketPtr copy = packetPool_->acquire(length)) {
+            std::memcpy(copy->data, packet->data, length);
+            holdDatagram(std::move(copy), length,
+                         receiveMicros + decision.duplicateDelayMicros, channel, delayLine);
+        }
+    }
+    holdDatagram(std::move(packet), length, receiveMicros + decision.delayMicros,
+                 channel, delayLine);
+}
+
+void RtpPacketizer::holdDatagram(PacketPtr packet, size_t length, int64_t dueMicros,
+                                 uint32_t channel, ImpairmentDelayLine& delayLine) {
+    if (dueMicros <= traceClockMicros()) {
+        handleDatagram(std::move(packet), length, dueMicros, channel);
+        return;
+    }
+    if (!delayLine.push(dueMicros, packet, length, channel)) {
+        // Hold queue full: deliver early rather than add loss nobody asked for
+        ImpairmentStage& stage = impairments_[static_cast<size_t>(ImpairmentDirection::RECEIVE)];
+        {
+            std::lock_guard<std::mutex> lock(stage.mutex);
+            stage.telemetry.increment(ImpairmentField::OVERFLOWS);
+        }
+        handleDatagram(std::move(packet), length, traceClockMicros(), channel);
+    }
+}
+
+int64_t RtpPacketizer::releaseDueDatagrams(ImpairmentDelayLine& delayLine, int64_t nowMicros) {
+    ImpairmentDelayLine::Entry entry;
+    while (delayLine.popDue(nowMicros, entry)) {
+        // Stamped at its emulated arrival, as if the network had delivered it then
+        handleDatagram(std::move(entry.packet), entry.length, entry.dueMicros, entry.channel);
+    }
+    return delayLine.nextDueMicros();
+}
+
+void RtpPacketizer::relayBatch(ReceiveBatch& batch, size_t received, int64_t receiveMicros) {
+    const struct sockaddr_in* group = multicastJoined_ ? &multicastAddr_ : nullptr;
+    const uint16_t port = htons(port_);
+    RelayQueue queue;
+    // Ciphertext is forwarded before it is opened: with SRTP on, only a
+    // sender that has authenticated before (or a member) gets fanned out
+    const bool keyed = srtp_ && srtp_->isActive();
+
+    for (size_t i = 0; i < received; ++i) {
+        if (!batch.packets[i]) {
+            continue;
+        }
+        uint8_t* data = batch.packets[i]->data;
+        const size_t length = batch.msgs[i].msg_len;
+        // Control is forwarded after it verifies (receiveControl)
+        if (RtcpSession::isRtcp(data, length)) {
+            continue;
+        }
+        if (queue.count + kMaxRelayTargets > kRelayQueueSize) {
+            flushRelayed(socket_, queue);
+        }
+        bool verified = !keyed;
+        if (keyed && length >= 12) {
+            uint32_t ssrc;
+            std::memcpy(&ssrc, data + 8, sizeof(ssrc));
+            verified = srtp_->isKnownSource(ntohl(ssrc));
+        }
+        const size_t first = queue.count;
+        const size_t routed = relay_.route(data, length, true, verified,
+                                           batch.fromAddrs[i].sin_addr.s_addr, port, group,
+                                           receiveMicros, queue.targets + first, kMaxRelayTargets);
+        for (size_t k = first; k < first + routed; ++k) {
+            queue.iovecs[k].iov_base = data;
+            queue.iovecs[k].iov_len = length;
+            std::memset(&queue.msgs[k], 0, sizeof(queue.msgs[k]));
+            queue.msgs[k].msg_hdr.msg_name = &queue.targets[k].addr;
+            queue.msgs[k].msg_hdr.msg_namelen = sizeof(queue.targets[k].addr);
+            queue.msgs[k].msg_hdr.msg_iov = &queue.iovecs[k];
+            queue.msgs[k].msg_hdr.msg_iovlen = 1;
+            queue.bytes[k] = length;
+        }
+        queue.count += routed;
+    }
+    flushRelayed(socket_, queue);
+}
+
+void RtpPacketizer::recordReceiveLatency(const struct msghdr& msg) {
+    auto* header = const_cast<struct msghdr*>(&msg);
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(header); cmsg; cmsg = CMSG_NXTHDR(header, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS) {
+            continue;
+        }
+        struct timespec stamp;
+        std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        const int64_t waitedMicros =
+            (static_cast<int64_t>(now.tv_sec) - stamp.tv_sec) * 1000000 +
+            (static_cast<int64_t>(now.tv_nsec) - stamp.tv_nsec) / 1000;
+        // The stamp is wall time: a clock step in between is not a sample
+        if (waitedMicros >= 0 && waitedMicros < kMaxReceiveStampAgeMicros) {
+            threadManager_->recordWakeLatency(ThreadRole::NETWORK, waitedMicros);
+        }
+        return;
+    }
+}
+
+void RtpPacketizer::drainSocket(int fd, uint32_t channel, ReceiveBatch& batch,
+                                ImpairmentDelayLine& delayLine) {
+    // Drain the socket, kRecvBatchSize datagrams per syscall
+    for (;;) {
+        std::memset(batch.msgs, 0, sizeof(batch.msgs));
+        for (size_t i = 0; i < kRecvBatchSize; ++i) {
+            if (!batch.packets[i]) {
+                batch.packets[i] = packetPool_->acquire();
+            }
+            batch.iovecs[i].iov_base = batch.packets[i] ? batch.packets[i]->data : batch.discard;
+            batch.iovecs[i].iov_len = kPooledPacketCapacity;
+            batch.msgs[i].msg_hdr.msg_name = &batch.fromAddrs[i];
+            batch.msgs[i].msg_hdr.msg_namelen = sizeof(batch.fromAddrs[i]);
+            batch.msgs[i].msg_hdr.msg_iov = &batch.iovecs[i];
+            batch.msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        if (threadManager_) {
+            batch.msgs[0].msg_hdr.msg_control = batch.control;
+            batch.msgs[0].msg_hdr.msg_controllen = sizeof(batch.control);
+        }
+
+        int received = recvmmsg(fd, batch.msgs, kRecvBatchSize, MSG_DONTWAIT, nullptr);
+
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                __android_log_print(ANDROID_LOG_ERROR, TAG,
+                    "recvmmsg error: %s", strerror(errno));
+            }
+            break;
+        }
+        if (received == 0) {
+            break;
+        }
+
+        receiveTelemetry_.increment(ReceiveField::BATCHES);
+        const int64_t receiveMicros = traceClockMicros();
+        if (threadManager_) {
+            recordReceiveLatency(batch.msgs[0].msg_hdr);
+        }
+
+        // Reflector: forward what came off the wire before anything is
+        // decrypted or impaired in place
+        if (channel == kHomeChannel && relay_.role() == RelayRole::REFLECTOR) {
+            relayBatch(batch, static_cast<size_t>(received), receiveMicros);
+        }
+
+        for (int i = 0; i < received; ++i) {
+            if (!batch.packets[i]) {
+                receiveTelemetry_.increment(ReceiveField::POOL_DROPS);
+                continue;
+            }
+            // Muxed RTCP (RFC 5761) never reaches the audio path; the buffer
+            // stays in the batch for the next read. Not impaired: the
+            // emulator models the media path.
+            if (RtcpSession::isRtcp(batch.packets[i]->data, batch.msgs[i].msg_len)) {
+                if (channel == kHomeChannel) {
+                    receiveControl(fd, htons(port_), batch.packets[i]->data,
+                                   batch.msgs[i].msg_len, batch.fromAddrs[i].sin_addr.s_addr,
+                                   receiveMicros);
+                }
+                continue;
+            }
+            ingestDatagram(std::move(batch.packets[i]), batch.msgs[i].msg_len, receiveMicros,
+                           channel, delayLine);
+        }
+
+        if (received < static_cast<int>(kRecvBatchSize)) {
+            break;
+        }
+    }
 }
 
 } // namespace ptt
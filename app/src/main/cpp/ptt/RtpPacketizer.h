@@ -3,11 +3,19 @@
  * RFC 3550 RTP implementation for PTT multicast
  * 
  * FIXED (Feb 2026):
- * - Fixed race conditions with atomic head/tail
+ * - Jitter buffer ordered by RTP sequence, not arrival
+ * - DTX gaps (marker bit, timestamp jump) are not treated as loss
  * - Added unicast fallback when multicast fails
  * - Non-blocking socket with timeout for clean shutdown
  * - Proper RTP timestamp (48kHz per RFC 7587)
  * - Duplicate SSRC detection
+ * - RTCP SR/RR (+ XR RTT) with a per-peer link quality table
+ * - SRTP/SRTCP AES-GCM payload protection keyed from MLS epochs
+ * - Native floor control (RTCP APP on the RTP socket) gates transmission
+ * - RFC 2198 redundant frames / delayed duplicates for lossy meshes
+ * - Multicast <-> unicast reflector for unicast-only members (RtpRelay.h)
+ * - Receive thread sleeps until a datagram or its next timer (eventfd wake)
+ * - Sockets and timers served by one EventLoop (epoll + timerfd); stop joins
  */
 
 #ifndef MESHRIDER_PTT_RTP_PACKETIZER_H
@@ -22,6 +30,21 @@
 #include <functional>
 #include <array>
 #include <optional>
+#include <string>
+#include <memory>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "PacketPool.h"
+#include "PowerMeter.h"
+#include "EventLoop.h"
+#include "ThreadManager.h"
+#include "AudioFormat.h"
+#include "PttTelemetry.h"
+#include "NetworkImpairment.h"
+#include "RtcpSession.h"
+#include "SrtpSession.h"
+#include "FloorControl.h"
+#include "RtpRelay.h"
 
 namespace meshrider {
 namespace ptt {
@@ -50,60 +73,209 @@ struct RtpHeader {
 // RTP configuration
 constexpr int RTP_VERSION = 2;
 constexpr int RTP_PAYLOAD_OPUS = 111;  // Dynamic PT for Opus
+constexpr int RTP_PAYLOAD_RED = 112;   // Dynamic PT for RFC 2198 redundant Opus
 constexpr int RTP_HEADER_SIZE = 12;
 constexpr int MAX_PACKET_SIZE = 1400;  // MTU-safe
 
 // RFC 7587: Opus uses 48kHz clock regardless of actual sample rate
-constexpr uint32_t RTP_CLOCK_RATE = 48000;
+constexpr uint32_t RTP_CLOCK_RATE = PttAudioFormat::kRtpClockRate;
+
+// Talkgroups received at once: the home channel (socket_, also used to
+// transmit) plus up to kMaxChannels - 1 receive-only scan channels
+constexpr size_t kMaxChannels = 8;
+constexpr uint32_t kHomeChannel = 0;
+
+// RTP header fields the receive path needs after parsing
+struct RtpPacketInfo {
+    uint16_t seq;
+    uint32_t timestamp;
+    uint32_t ssrc;
+    bool marker;
+    uint32_t channel = kHomeChannel;    // Talkgroup the datagram arrived on
+    bool redundant = false;             // Older frame repeated in a RED packet
+};
 
 /**
- * Jitter buffer for incoming RTP packets (THREAD-SAFE)
- * Handles packet reordering and loss concealment
- * 
- * FIXED: Atomic head/tail indices, proper memory ordering
+ * Loss protection on top of Opus in-band FEC (which only covers one lost
+ * packet, and only at the encoder's loss-tuned quality)
+ *
+ * RED: each packet repeats the previous depth frames as encoded (RFC 2198,
+ * PT RTP_PAYLOAD_RED), so a burst of up to depth losses plays bit-exact.
+ * Only a contiguous run of the newest frames is repeated, which lets the
+ * receiver rebuild their sequence numbers. DUPLICATE: each packet is sent
+ * again after the next frame, spreading the two copies one frame apart in
+ * time (fan-out already spreads them across multicast and unicast paths).
+ * Every member of the talkgroup must understand RED before it is enabled.
+ */
+enum class RedundancyMode : uint8_t {
+    OFF,
+    RED,
+    DUPLICATE
+};
+
+constexpr size_t kMaxRedundancyDepth = 3;
+constexpr size_t kMaxRedundantFrameBytes = 160;     // 64 kbps at 20 ms
+
+struct RedundancyConfig {
+    RedundancyMode mode = RedundancyMode::OFF;
+    uint32_t depth = 2;                 // RED: previous frames per packet (1..kMaxRedundancyDepth)
+    uint32_t maxFrameBytes = 80;        // RED: larger frames are not repeated
+};
+
+// Jitter buffer delay bounds unless the channel's codec profile sets others
+constexpr uint32_t kDefaultMinDelayMs = 20;
+constexpr uint32_t kDefaultMaxDelayMs = 300;
+
+/**
+ * Jitter buffer statistics (snapshot)
+ * Jitter is the RFC 3550 interarrival estimate converted to milliseconds.
+ */
+struct JitterBufferStats {
+    uint64_t packetsReceived;
+    uint64_t packetsLost;       // Sequence gaps that were never filled
+    uint64_t packetsLate;       // Arrived after their playout slot
+    uint64_t packetsDiscarded;  // Duplicates, overflow, or dropped to shrink delay
+    uint64_t framesPlayed;
+    uint64_t framesConcealed;   // Playout slot with no packet (PLC needed)
+    uint64_t framesRecovered;   // Lost frames rebuilt from the next packet's FEC
+    uint64_t framesStretched;   // Extra PLC frames inserted to grow delay
+    uint64_t redundantUsed;     // RED copies that filled a missing slot
+    uint64_t redundantDiscarded;    // RED copies of frames held or already played
+    uint32_t jitterMs;
+    uint32_t targetDelayMs;
+    uint32_t currentDelayMs;
+};
+
+// JitterBufferStats as published for lock-free readers
+enum class JitterField : size_t {
+    PACKETS_RECEIVED, PACKETS_LOST, PACKETS_LATE, PACKETS_DISCARDED,
+    FRAMES_PLAYED, FRAMES_CONCEALED, FRAMES_RECOVERED, FRAMES_STRETCHED,
+    REDUNDANT_USED, REDUNDANT_DISCARDED,
+    JITTER_MS, TARGET_DELAY_MS, CURRENT_DELAY_MS, COUNT
+};
+
+/**
+ * Result of a playout request, one call per frame period
+ */
+enum class JitterResult {
+    PACKET,     // Packet for this slot returned
+    RECOVER,    // Slot lost but the next arrived: packet is the NEXT one; decode
+                // its FEC for the lost frame, then the packet itself
+    CONCEAL,    // Slot missing (lost) or stretched: run PLC for one frame
+    BUFFERING   // Not started or underflowed: output silence
+};
+
+/**
+ * Sequence-ordered adaptive jitter buffer for incoming RTP (THREAD-SAFE)
+ *
+ * Packets are held as PacketPtr (pool ownership, no copy) in slots
+ * indexed by RTP sequence number, so reordered arrivals are
+ * played in order. Target playout delay follows the RFC 3550 interarrival
+ * jitter estimate: when the buffered depth exceeds the target the oldest
+ * frame is dropped (shrink), and when it falls short a concealment frame is
+ * inserted without consuming a packet (stretch).
  */
 class RtpJitterBuffer {
 public:
-    RtpJitterBuffer();
+    explicit RtpJitterBuffer(uint32_t frameDurationMs = PttAudioFormat::kFrameDurationMs,
+                             uint32_t clockRate = RTP_CLOCK_RATE);
     ~RtpJitterBuffer();
 
-    // Add packet to buffer (thread-safe)
-    void enqueue(const uint8_t* data, size_t size);
+    // Take ownership of a parsed packet (thread-safe).
+    // Returns false if dropped as late/duplicate (buffer goes back to its pool).
+    // A redundant packet only fills an empty slot behind the newest one: it
+    // never starts, extends or resyncs the stream, nor feeds the jitter estimate.
+    bool enqueue(PacketPtr packet, const RtpPacketInfo& info);
 
-    // Get next packet (returns true if data available)
-    bool dequeue(uint8_t* buffer, size_t& size);
+    // Same, with an explicit arrival time (traceClockMicros() base); lets the
+    // benchmark replay recorded loss/reorder traces on a virtual clock
+    bool enqueue(PacketPtr packet, const RtpPacketInfo& info, int64_t arrivalMicros);
+
+    // Pull the packet for the next playout slot; packet is set for PACKET/RECOVER
+    JitterResult dequeue(PacketPtr& packet);
+
+    // Outcome of a RECOVER: FEC rebuilt the frame, or it fell back to PLC
+    void noteRecovery(bool recovered);
 
     // Reset buffer
     void reset();
 
-    // Get statistics
-    size_t getPacketsLost() const { return packetsLost_.load(); }
-    size_t getPacketsReceived() const { return packetsReceived_.load(); }
+    // Delay bounds for the adaptive target
+    void setDelayBounds(uint32_t minDelayMs, uint32_t maxDelayMs);
+
+    // Sender changed packetization (adaptive frame size); delay math is per frame
+    void setFrameDuration(uint32_t frameDurationMs);
+
+    // Get statistics (since the last reset)
+    JitterBufferStats getStats() const;
+
+    // Lock-free: counters since construction (they survive reset()), delay
+    // and jitter of the current stream. For pollers that must not contend
+    // with the receive and decoder threads.
+    JitterBufferStats getPublishedStats() const;
+    size_t getPacketsLost() const;
+    size_t getPacketsReceived() const;
     size_t getCurrentSize() const;
 
+    static constexpr size_t kSlotCount = 32;           // Power of two
+
 private:
-    static constexpr size_t BUFFER_SIZE = 50;
-    static constexpr size_t MAX_PACKET_SIZE = 1500;
-
-    struct Packet {
-        std::array<uint8_t, MAX_PACKET_SIZE> data;
-        size_t size;
-        uint16_t seq;
-        bool valid;
+    struct Slot {
+        PacketPtr packet;   // Null when empty
+        uint16_t seq = 0;
+        bool marker = false;    // Talkspurt start: the sender was silent before it
+
+        bool holds(uint16_t s) const { return packet && seq == s; }
     };
 
-    // FIXED: Atomic indices for thread safety
-    std::atomic<size_t> head_{0};
-    std::atomic<size_t> tail_{0};
-    std::atomic<bool> isEmpty_{true};
-    
-    std::array<Packet, BUFFER_SIZE> buffer_;
-    std::mutex mutex_;
+    // Signed distance a - b in RTP sequence space (handles wrap)
+    static int16_t seqDiff(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b));
+    }
+
+    bool enqueueLocked(PacketPtr packet, const RtpPacketInfo& info, int64_t arrivalMicros);
+    JitterResult dequeueLocked(PacketPtr& packet);
+    void publishLocked();
+    void updateJitter(uint32_t rtpTimestamp, int64_t arrivalMicros);
+    void updateTargetDelay();
+    uint32_t depthFrames() const;     // playoutSeq_..highestSeq_ inclusive
+    void resetLocked();
+    void applyDelayBoundsLocked();
+
+    uint32_t frameDurationMs_;
+    const uint32_t clockRate_;
+    uint32_t minDelayMs_ = 0;
+    uint32_t maxDelayMs_ = 0;
+
+    std::array<Slot, kSlotCount> slots_;
+    mutable std::mutex mutex_;
+
+    // Playout state
+    bool started_ = false;
+    bool haveHighest_ = false;
+    uint16_t playoutSeq_ = 0;
+    uint16_t highestSeq_ = 0;
+    uint32_t bufferedCount_ = 0;
+
+    // RFC 3550 interarrival jitter (RTP timestamp units, Q4 fixed point)
+    bool haveTransit_ = false;
+    uint32_t lastTransit_ = 0;
+    int64_t jitterQ4_ = 0;
+
+    // Adaptive target (frames)
+    uint32_t minDelayFrames_ = 1;
+    uint32_t maxDelayFrames_ = 10;
+    uint32_t targetFrames_ = 2;
+    uint32_t framesSinceAdapt_ = 0;
 
-    // Statistics (atomic for thread safety)
-    std::atomic<size_t> packetsReceived_{0};
-    std::atomic<size_t> packetsLost_{0};
-    std::atomic<uint16_t> lastSeq_{0};
+    // Statistics
+    JitterBufferStats stats_{};
+
+    // stats_ copied out after every change, under mutex_ (so one writer at
+    // a time: the receive or the decoder thread). published_ is stats_ as
+    // of the last copy, for the counter deltas.
+    TelemetryBlock<JitterField> telemetry_;
+    JitterBufferStats published_{};
 };
 
 /**
@@ -130,14 +302,48 @@ enum class TransportMode {
     AUTO          // Try multicast, fall back to unicast
 };
 
+/**
+ * Unicast destination, resolved once when added
+ *
+ * Shared between successive copies of the peer list so the per-peer
+ * counters survive add/remove of other peers.
+ */
+struct UnicastPeer {
+    struct sockaddr_in addr;
+    char address[INET_ADDRSTRLEN];
+
+    // Updated by the send path only
+    std::atomic<uint32_t> consecutiveFailures{0};
+    std::atomic<uint64_t> sendFailures{0};
+    std::atomic<uint64_t> packetsSent{0};
+};
+
+// Consecutive failed sends after which prunePeers() drops a peer
+constexpr uint32_t kPeerPruneFailureThreshold = 50;  // ~1 s of frames
+
 /**
  * RTP Packetizer for PTT audio (PRODUCTION-READY)
  * 
  * FIXED:
  * - Non-blocking receive with timeout for clean shutdown
+ * - Batched receive (epoll + recvmmsg) into a preallocated packet pool
  * - Unicast fallback when multicast fails
+ * - Fan-out transmit: one sendmmsg() for multicast + all unicast peers,
+ *   addresses pre-resolved, copy-on-write peer list read without locking
  * - Proper 48kHz timestamp per RFC 7587
  * - SSRC collision detection
+ * - Optional seeded impairment under send and receive (lab tuning)
+ * - Receive-only scan channels served by the same epoll receive thread
+ * - RTCP reports sent and parsed on the receive thread (port + 1 or muxed)
+ * - SRTP: payload encrypted in place before fan-out, verified (replay
+ *   window + tag) on the receive thread before parsing
+ * - Optional RED / delayed-duplicate transmission (RedundancyConfig); RED
+ *   packets are split back into frames before the audio callback
+ * - Relay: as reflector, received datagrams are re-forwarded undecoded to
+ *   unicast-only members (sendmmsg per batch); as member, packets go to the
+ *   reflector alone while it answers
+ * - Home, scan and RTCP sockets plus the delay line, RTCP, floor and relay
+ *   timers share one EventLoop thread; stopReceiveLoop() always joins it
  */
 class RtpPacketizer {
 public:
@@ -152,17 +358,73 @@ public:
     bool start();
     void stop();
 
-    // Send Opus-encoded audio data
-    bool sendAudio(const uint8_t* opusData, size_t opusSize, bool isMarker = false);
+    // Send Opus-encoded audio data. rtpTimestampIncrement is the frame's
+    // duration in RTP ticks, so the timestamp tracks what the encoder produced.
+    // captureMicros (traceClockMicros() of the frame's first sample, 0 if
+    // unknown) feeds the latency extension when it is enabled.
+    bool sendAudio(const uint8_t* opusData, size_t opusSize, bool isMarker = false,
+                   uint32_t rtpTimestampIncrement = PttAudioFormat::kRtpTimestampIncrement,
+                   int64_t captureMicros = 0);
+
+    // Frame withheld by DTX: advance the timestamp without sending, so the
+    // next packet (sent with isMarker) shows the gap as a timestamp jump
+    // over contiguous sequence numbers rather than as loss
+    void skipAudio(uint32_t rtpTimestampIncrement) { timestamp_.fetch_add(rtpTimestampIncrement); }
+
+    // Carry sender latency stamps in an RTP header extension (LatencyTracer.h)
+    void setLatencyExtension(bool enable) { latencyExtension_.store(enable); }
 
-    // Receive loop (runs in background thread)
+    // Receive loop (runs in background thread). Stop returns with the
+    // thread joined.
     void startReceiveLoop();
     void stopReceiveLoop();
 
-    // Set callback for received audio (Opus encoded)
-    using AudioCallback = std::function<void(const uint8_t*, size_t, uint32_t ssrc)>;
+    // Set callback for received audio: pooled buffer (payload located) + parsed header.
+    // The callback takes ownership; dropping the PacketPtr returns it to the pool.
+    using AudioCallback = std::function<void(PacketPtr packet, const RtpPacketInfo& info)>;
     void setAudioCallback(AudioCallback callback) { audioCallback_ = callback; }
 
+    // Pool that receive buffers come from. Share it with whoever holds packets
+    // (receive streams) so it outlives them. Call before startReceiveLoop();
+    // a private pool is created if none is set.
+    void setPacketPool(std::shared_ptr<PacketPool> pool) { packetPool_ = std::move(pool); }
+
+    // Receive-thread wakeups are counted here (shared with the audio engine).
+    // Call before startReceiveLoop().
+    void setPowerMeter(std::shared_ptr<PowerMeter> meter) { loop_.setPowerMeter(std::move(meter)); }
+
+    // Policy for the receive thread, and its wakeup latency from kernel
+    // receive stamps. Call before start() (sockets are stamped from then on).
+    void setThreadManager(std::shared_ptr<ThreadManager> manager) { threadManager_ = std::move(manager); }
+
+    // SRTP context shared across socket rebuilds (keys live in it, not here).
+    // Call before start(); protection follows the session's isActive().
+    void setSrtpSession(std::shared_ptr<SrtpSession> session) { srtp_ = std::move(session); }
+
+    // Floor arbitration (FloorControl.h) shared across socket rebuilds. Call
+    // before start(); while the floor is withheld sendAudio() drops frames
+    // without counting a send failure.
+    void setFloorControl(std::shared_ptr<FloorControl> floor);
+
+    // Local PTT press/release: sends the messages and re-arms the receive
+    // thread's floor timers. requestFloor() returns the immediate state;
+    // wait on FloorControl::awaitDecision() for a PENDING one.
+    FloorState requestFloor(uint8_t priority, bool emergency);
+    void releaseFloor();
+
+    // Redundant transmission (RedundancyConfig). Safe while running; a change
+    // clears the frame history, so the next packet goes out without copies.
+    void setRedundancy(RedundancyConfig config);
+    RedundancyConfig getRedundancy() const;
+
+    // Multicast <-> unicast relay (RtpRelay.h). Safe while running; a
+    // member leaving its reflector tells it so. A reflector stops looping
+    // back its own multicast, so its forwards never come back to it.
+    void setRelayConfig(const RelayConfig& config);
+    RelayConfig getRelayConfig() const { return relay_.getConfig(); }
+    RelayStats getRelayStats() const { return relay_.getStats(); }
+    size_t getRelayMembers(RelayMemberInfo* out, size_t maxEntries) const;
+
     // Get SSRC
     uint32_t getSSRC() const { return ssrc_; }
 
@@ -171,15 +433,60 @@ public:
 
     // Statistics
     size_t getPacketsSent() const { return packetsSent_.load(); }
-    size_t getPacketsReceived() const { return packetsReceived_.load(); }
+    size_t getPacketsReceived() const { return receiveTelemetry_.load(ReceiveField::PACKETS); }
+    size_t getReceiveBatches() const { return receiveTelemetry_.load(ReceiveField::BATCHES); }
+    size_t getPoolDrops() const { return receiveTelemetry_.load(ReceiveField::POOL_DROPS); }
+    EventLoopStats getEventLoopStats() const { return loop_.getStats(); }
+
+    // Send/receive stages of a TelemetrySnapshot (lock-free)
+    void getTelemetry(TelemetrySnapshot& snapshot) const;
 
     // Set DSCP QoS marking for RTP packets
     bool setDscp(uint8_t dscpValue);
 
-    // Add unicast peer (for fallback mode)
-    void addUnicastPeer(const char* ipAddress);
+    // Add unicast peer (for fallback mode); false if the address is not IPv4
+    bool addUnicastPeer(const char* ipAddress);
+    void removeUnicastPeer(const char* ipAddress);
     void clearUnicastPeers();
 
+    // Drop peers that failed at least minConsecutiveFailures sends in a row.
+    // Returns the number of peers removed.
+    size_t pruneUnicastPeers(uint32_t minConsecutiveFailures = kPeerPruneFailureThreshold);
+
+    size_t getUnicastPeerCount() const;
+    size_t getSendFailures() const { return sendFailures_.load(); }
+
+    // Scan channels: extra multicast groups received alongside the home
+    // channel, without transmitting on them. channelId is the caller's
+    // talkgroup id (non-zero; kHomeChannel is the initialize() group) and is
+    // reported in RtpPacketInfo::channel. Safe while the receive loop runs.
+    // joinChannel() fails if the id is taken, the table is full, or the
+    // group cannot be joined.
+    bool joinChannel(uint32_t channelId, const char* multicastGroup, uint16_t port);
+    bool leaveChannel(uint32_t channelId);
+    size_t getChannelCount() const;    // Scan channels joined (home not counted)
+
+    // Deterministic network impairment for lab tuning and regression runs
+    // (NetworkImpairment.h). Replaces the direction's current model and resets
+    // its counters; null or an inactive model turns impairment off.
+    void setImpairment(ImpairmentDirection direction, std::unique_ptr<NetworkImpairment> impairment);
+    ImpairmentStats getImpairmentStats(ImpairmentDirection direction) const;
+
+    // RTCP (RtcpSession.h), SEPARATE_PORT by default. Safe while running;
+    // switching to SEPARATE_PORT opens the port + 1 socket if needed. Reports
+    // go to the multicast group and every unicast peer.
+    void setRtcpConfig(const RtcpConfig& config);
+    RtcpConfig getRtcpConfig() const { return rtcp_.getConfig(); }
+    RtcpStats getRtcpStats() const { return rtcp_.getStats(); }
+
+    // Remote members heard on the home channel; returns entries written
+    size_t getLinkQuality(LinkQuality* out, size_t maxEntries) const;
+
+    // Report blocks about our stream, on the receive thread. Set before startReceiveLoop().
+    void setReceiverReportCallback(RtcpSession::ReportCallback callback) {
+        rtcp_.setReportCallback(std::move(callback));
+    }
+
 private:
     // Socket
     int socket_;
@@ -189,7 +496,6 @@ private:
     std::atomic<uint16_t> sequence_;
     std::atomic<uint32_t> timestamp_;
     uint32_t ssrc_;
-    uint32_t samplesPerFrame_;  // For timestamp calculation
 
     // Multicast group
     char multicastGroup_[16];
@@ -197,37 +503,220 @@ private:
     TransportMode transportMode_;
     bool multicastJoined_;
 
-    // Unicast fallback
-    std::vector<std::string> unicastPeers_;
-    std::mutex unicastMutex_;
+    struct sockaddr_in multicastAddr_;  // Resolved in initialize()
+
+    // Unicast fallback: copy-on-write list. Writers (under unicastMutex_)
+    // publish a new list, then wait for in-flight senders before freeing the
+    // old one; the send path only bumps peerReaders_.
+    using PeerList = std::vector<std::shared_ptr<UnicastPeer>>;
+    std::atomic<const PeerList*> unicastPeers_;
+    std::atomic<uint32_t> peerReaders_{0};
+    mutable std::mutex unicastMutex_;
+
+    // Destinations per sendmmsg() call (larger fan-outs take several calls)
+    static constexpr size_t kSendBatchSize = 32;
+
+    // Receive thread: the event loop. Sockets are watched from createSocket()
+    // (scan channels from joinChannel()); the timers are the delay line,
+    // RTCP, floor and relay services, registered once per socket setup.
+    EventLoop loop_;
+    std::shared_ptr<ThreadManager> threadManager_;
+
+    // Receive thread state, from startReceiveLoop() to stopReceiveLoop()
+    struct ReceiveBatch;
+    std::unique_ptr<ReceiveBatch> receiveBatch_;
+    ImpairmentDelayLine delayLine_;    // Datagrams held back by the receive impairment
+
+    // Scan channel sockets, watched by loop_. Slots change under
+    // channelMutex_; leaveChannel() unwatches the socket, which waits out a
+    // drain in progress, before closing it, so a recvmmsg() never lands on a
+    // recycled descriptor.
+    struct ScanChannel {
+        std::atomic<int> socket{-1};
+        uint32_t id = 0;
+        char group[INET_ADDRSTRLEN] = {};
+        uint16_t port = 0;
+    };
+    std::array<ScanChannel, kMaxChannels - 1> channels_;
+    mutable std::mutex channelMutex_;
+
+    // RTCP: reports built and parsed on the receive thread. The port + 1
+    // socket is opened at most once (under rtcpMutex_) and lives until
+    // closeSocket(), so the receive thread never sees it close.
+    RtcpSession rtcp_;
+    std::atomic<int> rtcpSocket_{-1};
+    std::mutex rtcpMutex_;
+
+    // Batched ingest: up to kRecvBatchSize datagrams per recvmmsg() into pooled buffers
+    static constexpr size_t kRecvBatchSize = 16;
+    std::shared_ptr<PacketPool> packetPool_;
 
-    // Receive thread (PRODUCTION FIX: Non-blocking with timeout)
-    std::thread receiveThread_;
-    std::atomic<bool> receiveRunning_;
-    int shutdownPipe_[2];  // For interrupting recvfrom()
+    // Relay role and tables; reflectorAddress_ (network order, 0 unless a
+    // member) is what the send path targets while sendViaReflector()
+    RtpRelay relay_;
+    std::atomic<in_addr_t> reflectorAddress_{0};
 
-    // Jitter buffer
-    RtpJitterBuffer jitterBuffer_;
+    // Set before start(), read by the send and receive threads
+    std::shared_ptr<SrtpSession> srtp_;
+    std::shared_ptr<FloorControl> floor_;
 
     // Callback
     AudioCallback audioCallback_;
 
-    // Statistics
-    std::atomic<size_t> packetsSent_;
-    std::atomic<size_t> packetsReceived_;
+    std::atomic<bool> latencyExtension_{false};
+
+    // Redundancy: the hot path checks mode and only then takes the mutex,
+    // which guards the config, the RED frame history and the held duplicate
+    struct SentFrame {
+        std::array<uint8_t, kMaxRedundantFrameBytes> data;
+        uint16_t size = 0;              // 0: too large to repeat, ends the run
+        uint16_t seq = 0;
+        uint32_t timestamp = 0;
+    };
+    std::atomic<RedundancyMode> redundancyMode_{RedundancyMode::OFF};
+    mutable std::mutex redundancyMutex_;
+    RedundancyConfig redundancy_;
+    std::array<SentFrame, kMaxRedundancyDepth> history_;   // Ring, newest at historyHead_ - 1
+    size_t historyHead_ = 0;
+    size_t historyCount_ = 0;
+    std::array<uint8_t, MAX_PACKET_SIZE> heldPacket_;      // DUPLICATE: protected copy
+    size_t heldLength_ = 0;
+    uint16_t heldSeq_ = 0;
+    uint32_t heldTimestamp_ = 0;
+
+    // Impairment per direction; the hot path checks `active` and only then
+    // takes the mutex (which serializes next() against setImpairment()).
+    struct ImpairmentStage {
+        std::atomic<bool> active{false};
+        std::mutex mutex;
+        std::unique_ptr<NetworkImpairment> engine;
+        TelemetryBlock<ImpairmentField> telemetry;   // Written under mutex
+    };
+    std::array<ImpairmentStage, 2> impairments_;     // Indexed by ImpairmentDirection
+
+    // Statistics. Send may be called from several threads, so each counter
+    // gets its own cache line; receive has a single writer (receiveLoop).
+    PaddedCounter packetsSent_;
+    PaddedCounter bytesSent_;
+    PaddedCounter sendFailures_;
+    PaddedCounter redundantFramesSent_;
+    PaddedCounter redundantBytesSent_;     // RED headers + repeated frames
+    PaddedCounter duplicatesSent_;
+    enum class ReceiveField : size_t { PACKETS, BYTES, BATCHES, POOL_DROPS, COUNT };
+    TelemetryBlock<ReceiveField> receiveTelemetry_;
 
     // Helper methods
     bool createSocket();
     void closeSocket();
     bool joinMulticastGroup();
     void leaveMulticastGroup();
-    void receiveLoop();
-    
-    // PRODUCTION FIX: Non-blocking receive with timeout
-    bool waitForData(int timeoutMs);
+    // Event loop timer services and sources, registered by createSocket()
+    void registerLoop();
+
+    // Scan channel socket bound to the group itself, so it only sees that group
+    int openChannelSocket(const char* multicastGroup, uint16_t port);
+
+    // RTCP transport: port + 1 socket, report timer, fan-out and receive
+    bool openRtcpSocket();
+    int64_t serviceRtcp(int64_t nowMicros);      // Next report due (0: none)
+    void sendRtcp(const uint8_t* data, size_t size);
+    void drainRtcpSocket();
+
+    // SRTCP-protect and fan out a control packet, muxed on socket_ or on
+    // the port + 1 socket
+    void sendControl(const uint8_t* data, size_t size, bool muxed);
+
+    // Floor control transport: messages always ride socket_ (RFC 5761 mux),
+    // whatever the RTCP mode, so they follow the voice path
+    void sendFloorMessages(const FloorOutbox& out);
+    int64_t serviceFloor(int64_t nowMicros);
+
+    // Relay transport: membership messages on socket_, JOIN timer, and the
+    // reflector's re-forwarding of a receive batch (RTP) or one control
+    // packet (as received, before SRTCP) to the targets route() picks
+    void sendRelayMessage(RelayMessageType type, in_addr_t to);
+    int64_t serviceRelay(int64_t nowMicros);
+    struct RelayQueue;
+    void relayControl(int fd, uint16_t port, const uint8_t* data, size_t length,
+                      in_addr_t fromAddress, int64_t receiveMicros);
+    void flushRelayed(int fd, RelayQueue& queue);
+    void applyMulticastLoop(int fd);
+
+    // One control datagram off fd (port in network order): verify,
+    // dispatch and, on a reflector, forward the original bytes
+    void receiveControl(int fd, uint16_t port, uint8_t* data, size_t length,
+                        in_addr_t fromAddress, int64_t receiveMicros);
+
+    // Have the loop re-run its timer services (new deadlines)
+    void wakeReceiveLoop();
+
+    // A verified compound packet: relay or floor message, or report
+    void onControlReceived(uint8_t* data, size_t length, uint32_t fromAddress,
+                           int64_t receiveMicros);
+
+    // recvmmsg() loop over one ready socket
+    void relayBatch(ReceiveBatch& batch, size_t received, int64_t receiveMicros);
+    void recordReceiveLatency(const struct msghdr& msg);
+    void drainSocket(int fd, uint32_t channel, ReceiveBatch& batch,
+                     ImpairmentDelayLine& delayLine);
+
+    // Parse one datagram in place and hand it to the audio callback
+    void handleDatagram(PacketPtr packet, size_t length, int64_t receiveMicros,
+                        uint32_t channel);
+
+    // Receive-side impairment in front of handleDatagram(): drop, duplicate,
+    // or hold in delayLine until due. Receive thread only.
+    void ingestDatagram(PacketPtr packet, size_t length, int64_t receiveMicros,
+                        uint32_t channel, ImpairmentDelayLine& delayLine);
+    void holdDatagram(PacketPtr packet, size_t length, int64_t dueMicros,
+                      uint32_t channel, ImpairmentDelayLine& delayLine);
+    // Hand over what is due; the next release time (0: empty)
+    int64_t releaseDueDatagrams(ImpairmentDelayLine& delayLine, int64_t nowMicros);
+
+    // Next decision for a direction (counts it); caller checked `active`
+    ImpairmentDecision impair(ImpairmentDirection direction);
+
+    // Validate RTP header and locate the payload (skips CSRCs, extension, padding).
+    // timestamps, if given, receives the sender stamps from the latency extension.
+    static bool parseRtpPacket(const uint8_t* packet, size_t length,
+                               RtpPacketInfo& info,
+                               size_t& payloadOffset, size_t& payloadSize,
+                               PacketTimestamps* timestamps = nullptr);
     
-    // Send to all destinations (multicast + unicast peers)
+    // Clear RTP header length (fixed + CSRCs + extension), 0 if malformed.
+    // SRTP authenticates but does not encrypt these octets.
+    static size_t rtpHeaderLength(const uint8_t* packet, size_t length);
+
+    // SRTCP-verify a received compound packet in place (no-op with
+    // protection off); false if it must be dropped
+    bool unprotectRtcp(uint8_t* data, size_t& length, int64_t receiveMicros);
+
+    // RED payload for one frame: the preceding run of history frames that
+    // fits capacity, then the frame, which joins the history. Returns the
+    // payload size; redundantFrames = 0 means a plain Opus payload.
+    size_t packRedundant(uint8_t* out, size_t capacity, const uint8_t* frame, size_t frameSize,
+                         uint16_t seq, uint32_t timestamp, size_t& redundantFrames);
+
+    // DUPLICATE: resend the held previous packet if it directly precedes
+    // seq, then hold this one
+    void sendDuplicate(const uint8_t* packet, size_t length, uint16_t seq, uint32_t timestamp);
+
+    // Split a RED payload: deliver the repeated frames as redundant packets,
+    // leave payloadOffset/payloadSize on the primary. False if malformed.
+    bool splitRedundant(const PacketPtr& packet, const RtpPacketInfo& info,
+                        size_t& payloadOffset, size_t& payloadSize,
+                        std::array<PacketPtr, kMaxRedundancyDepth>& frames,
+                        std::array<RtpPacketInfo, kMaxRedundancyDepth>& infos,
+                        size_t& frameCount);
+
+    // Send to all destinations (multicast + unicast peers), through the
+    // transmit impairment when one is set
     bool sendToAll(const uint8_t* data, size_t size);
+    bool fanOut(const uint8_t* data, size_t size);
+
+    // Swap in a new peer list and free the old one once no sender holds it.
+    // Caller holds unicastMutex_.
+    void publishPeers(PeerList* peers);
 };
 
 } // namespace ptt
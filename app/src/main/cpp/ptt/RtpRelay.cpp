@@ -0,0 +1,409 @@
+/*
+ * Mesh Rider Wave - Multicast <-> Unicast Relay Implementation
+ */
+
+#include "RtpRelay.h"
+#include "RtcpSession.h"
+#include "PttLog.h"
+#include <algorithm>
+#include <cstring>
+#include <arpa/inet.h>
+
+#define TAG "MeshRider:PTT-Relay"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// Sequence jump treated as a sender restart rather than an old duplicate
+constexpr int kRelayResyncThreshold = 1000;
+
+constexpr uint32_t kRelayWindowPackets = 64;
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v >> 8);
+    p[1] = static_cast<uint8_t>(v);
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+int64_t millisToMicros(uint32_t ms) {
+    return static_cast<int64_t>(ms) * 1000;
+}
+
+const char* addressString(in_addr_t address, char* buffer) {
+    struct in_addr addr;
+    addr.s_addr = address;
+    return inet_ntop(AF_INET, &addr, buffer, INET_ADDRSTRLEN) ? buffer : "?";
+}
+
+} // namespace
+
+void RtpRelay::setLocalSsrc(uint32_t ssrc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    localSsrc_ = ssrc;
+}
+
+void RtpRelay::configure(const RelayConfig& config, int64_t nowMicros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool reset = config.role != config_.role ||
+                       config.reflectorAddress != config_.reflectorAddress;
+    config_ = config;
+    config_.keepaliveMs = std::max<uint32_t>(config_.keepaliveMs, 100);
+    config_.memberTimeoutMs = std::max(config_.memberTimeoutMs, 2 * config_.keepaliveMs);
+
+    if (reset) {
+        members_ = {};
+        flows_ = {};
+        memberCount_ = 0;
+        nextExpiryMicros_ = 0;
+        lastAckMicros_ = 0;
+        reflectorAlive_.store(false, std::memory_order_release);
+    }
+    // Member: JOIN at once rather than a keepalive from now
+    nextJoinMicros_ = config_.role == RelayRole::MEMBER ? nowMicros : 0;
+    role_.store(config_.role, std::memory_order_release);
+}
+
+RelayConfig RtpRelay::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+// ============================================================================
+// Membership messages
+// ============================================================================
+
+bool RtpRelay::isRelayMessage(const uint8_t* data, size_t length) {
+    return length >= kRelayMessageBytes && (data[0] >> 6) == 2 &&
+           data[1] == kRtcpApplication && get32(data + 8) == kRelayAppName;
+}
+
+size_t RtpRelay::buildMessage(RelayMessageType type, uint8_t* out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out[0] = static_cast<uint8_t>(0x80 | static_cast<uint8_t>(type));
+    out[1] = kRtcpApplication;
+    put16(out + 2, kRelayMessageBytes / 4 - 1);
+    put32(out + 4, localSsrc_);
+    put32(out + 8, kRelayAppName);
+    return kRelayMessageBytes;
+}
+
+bool RtpRelay::onMessage(const uint8_t* data, size_t length, in_addr_t fromAddress,
+                         int64_t nowMicros) {
+    if (length < kRelayMessageBytes) {
+        return false;
+    }
+    const size_t declared = (static_cast<size_t>(get16(data + 2)) + 1) * 4;
+    if (declared < kRelayMessageBytes || declared > length) {
+        return false;
+    }
+    const auto type = static_cast<RelayMessageType>(data[0] & 0x1F);
+    const uint32_t ssrc = get32(data + 4);
+    char address[INET_ADDRSTRLEN];
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.role == RelayRole::MEMBER) {
+        if (type != RelayMessageType::ACK || fromAddress != config_.reflectorAddress) {
+            return false;
+        }
+        lastAckMicros_ = nowMicros;
+        if (!reflectorAlive_.exchange(true, std::memory_order_acq_rel)) {
+            __android_log_print(ANDROID_LOG_INFO, TAG, "Reflector %s reachable, sending via it",
+                                addressString(fromAddress, address));
+        }
+        return false;
+    }
+    if (config_.role != RelayRole::REFLECTOR) {
+        return false;
+    }
+
+    Member* member = findMemberLocked(fromAddress);
+    if (type == RelayMessageType::LEAVE) {
+        if (member) {
+            *member = Member{};
+            memberCount_--;
+            __android_log_print(ANDROID_LOG_INFO, TAG, "Relay member %s left (%zu members)",
+                                addressString(fromAddress, address), memberCount_);
+        }
+        return false;
+    }
+    if (type != RelayMessageType::JOIN) {
+        return false;
+    }
+
+    if (!member) {
+        for (Member& slot : members_) {
+            if (slot.address == 0) {
+                member = &slot;
+                break;
+            }
+        }
+        if (!member) {
+            ++stats_.rejected;
+            return false;
+        }
+        *member = Member{};
+        member->address = fromAddress;
+        memberCount_++;
+        ++stats_.joins;
+        __android_log_print(ANDROID_LOG_INFO, TAG, "Relay member %s joined (SSRC 0x%08x, %zu members)",
+                            addressString(fromAddress, address), ssrc, memberCount_);
+    }
+    member->ssrc = ssrc;
+    member->lastHeardMicros = nowMicros;
+    if (nextExpiryMicros_ == 0) {
+        nextExpiryMicros_ = nowMicros + millisToMicros(config_.memberTimeoutMs);
+    }
+    return true;
+}
+
+// ============================================================================
+// Forwarding (reflector, receive thread)
+// ============================================================================
+
+RtpRelay::Member* RtpRelay::findMemberLocked(in_addr_t address) {
+    for (Member& member : members_) {
+        if (member.address != 0 && member.address == address) {
+            return &member;
+        }
+    }
+    return nullptr;
+}
+
+bool RtpRelay::admitLocked(uint32_t ssrc, uint16_t seq, int64_t nowMicros) {
+    Flow* flow = nullptr;
+    Flow* oldest = &flows_[0];
+    for (Flow& candidate : flows_) {
+        if (candidate.active && candidate.ssrc == ssrc) {
+            flow = &candidate;
+            break;
+        }
+        if (!candidate.active ||
+            (oldest->active && candidate.lastSeenMicros < oldest->lastSeenMicros)) {
+            oldest = &candidate;
+        }
+    }
+
+    if (!flow) {
+        // New sender (or one evicted as least recently heard)
+        *oldest = Flow{ssrc, true, seq, 1, nowMicros};
+        return true;
+    }
+    flow->lastSeenMicros = nowMicros;
+
+    const int16_t ahead = static_cast<int16_t>(static_cast<uint16_t>(seq - flow->highestSeq));
+    if (ahead > 0) {
+        flow->window = static_cast<uint32_t>(ahead) >= kRelayWindowPackets
+            ? 1 : (flow->window << ahead) | 1;
+        flow->highestSeq = seq;
+        return true;
+    }
+    const uint32_t behind = static_cast<uint32_t>(-static_cast<int32_t>(ahead));
+    if (behind >= kRelayWindowPackets) {
+        if (behind > static_cast<uint32_t>(kRelayResyncThreshold)) {
+            *flow = Flow{ssrc, true, seq, 1, nowMicros};   // Sender restarted
+            return true;
+        }
+        return false;   // Older than the window: its first copy went long ago
+    }
+    const uint64_t bit = uint64_t{1} << behind;
+    if (flow->window & bit) {
+        return false;
+    }
+    flow->window |= bit;
+    return true;
+}
+
+size_t RtpRelay::route(const uint8_t* data, size_t length, bool rtp, bool verified,
+                       in_addr_t fromAddress, uint16_t port, const struct sockaddr_in* group,
+                       int64_t nowMicros, RelayTarget* out, size_t maxTargets) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.role != RelayRole::REFLECTOR) {
+        return 0;
+    }
+
+    Member* sender = findMemberLocked(fromAddress);
+    if (sender) {
+        sender->lastHeardMicros = nowMicros;
+        sender->packetsIn++;
+    } else if (!verified) {
+        ++stats_.unverifiedDropped;
+        return 0;
+    }
+
+    if (rtp) {
+        if (length < 12 || get32(data + 8) == localSsrc_) {
+            return 0;
+        }
+        if (!admitLocked(get32(data + 8), get16(data + 2), nowMicros)) {
+            ++stats_.duplicatesDropped;
+            return 0;
+        }
+    }
+
+    if (memberCount_ == 0) {
+        return 0;
+    }
+
+    // Group traffic goes to the members; a member's goes to the group too,
+    // never back to it
+    size_t count = 0;
+    if (sender && group && count < maxTargets) {
+        out[count].addr = *group;
+        out[count].member = kRelayGroupTarget;
+        count++;
+    }
+    for (size_t i = 0; i < members_.size() && count < maxTargets; ++i) {
+        const Member& member = members_[i];
+        if (member.address == 0 || &member == sender) {
+            continue;
+        }
+        std::memset(&out[count].addr, 0, sizeof(out[count].addr));
+        out[count].addr.sin_family = AF_INET;
+        out[count].addr.sin_port = port;
+        out[count].addr.sin_addr.s_addr = member.address;
+        out[count].member = static_cast<uint8_t>(i);
+        count++;
+    }
+    return count;
+}
+
+size_t RtpRelay::copyMembers(RelayTarget* out, size_t maxTargets, uint16_t port) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.role != RelayRole::REFLECTOR) {
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < members_.size() && count < maxTargets; ++i) {
+        if (members_[i].address == 0) {
+            continue;
+        }
+        std::memset(&out[count].addr, 0, sizeof(out[count].addr));
+        out[count].addr.sin_family = AF_INET;
+        out[count].addr.sin_port = port;
+        out[count].addr.sin_addr.s_addr = members_[i].address;
+        out[count].member = static_cast<uint8_t>(i);
+        count++;
+    }
+    return count;
+}
+
+void RtpRelay::recordForwards(const RelayTarget* targets, const bool* sent, const size_t* bytes,
+                              size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        Member* member = targets[i].member < members_.size() ? &members_[targets[i].member] : nullptr;
+        if (!sent[i]) {
+            ++stats_.sendFailures;
+            if (member && member->address != 0) {
+                member->sendFailures++;
+            }
+            continue;
+        }
+        ++stats_.packetsForwarded;
+        stats_.bytesForwarded += bytes[i];
+        if (member && member->address != 0) {
+            member->packetsForwarded++;
+            member->bytesForwarded += bytes[i];
+        }
+    }
+}
+
+// ============================================================================
+// Timers
+// ============================================================================
+
+void RtpRelay::service(int64_t nowMicros, bool& sendJoin) {
+    sendJoin = false;
+    char address[INET_ADDRSTRLEN];
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t timeoutMicros = millisToMicros(config_.memberTimeoutMs);
+
+    if (config_.role == RelayRole::MEMBER) {
+        if (nowMicros >= nextJoinMicros_) {
+            sendJoin = true;
+            nextJoinMicros_ = nowMicros + millisToMicros(config_.keepaliveMs);
+        }
+        if (lastAckMicros_ != 0 && nowMicros - lastAckMicros_ > timeoutMicros) {
+            lastAckMicros_ = 0;
+            reflectorAlive_.store(false, std::memory_order_release);
+            __android_log_print(ANDROID_LOG_WARN, TAG,
+                "Reflector %s silent for %u ms, sending to each peer",
+                addressString(config_.reflectorAddress, address), config_.memberTimeoutMs);
+        }
+        return;
+    }
+
+    if (config_.role != RelayRole::REFLECTOR || nextExpiryMicros_ == 0 ||
+        nowMicros < nextExpiryMicros_) {
+        return;
+    }
+    nextExpiryMicros_ = 0;
+    for (Member& member : members_) {
+        if (member.address == 0) {
+            continue;
+        }
+        const int64_t expires = member.lastHeardMicros + timeoutMicros;
+        if (nowMicros >= expires) {
+            __android_log_print(ANDROID_LOG_INFO, TAG, "Relay member %s timed out",
+                                addressString(member.address, address));
+            member = Member{};
+            memberCount_--;
+            ++stats_.expiries;
+        } else if (nextExpiryMicros_ == 0 || expires < nextExpiryMicros_) {
+            nextExpiryMicros_ = expires;
+        }
+    }
+}
+
+int64_t RtpRelay::nextDeadlineMicros() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.role == RelayRole::MEMBER) {
+        const int64_t silence = lastAckMicros_ != 0
+            ? lastAckMicros_ + millisToMicros(config_.memberTimeoutMs) + 1 : 0;
+        return silence != 0 ? std::min(nextJoinMicros_, silence) : nextJoinMicros_;
+    }
+    return config_.role == RelayRole::REFLECTOR ? nextExpiryMicros_ : 0;
+}
+
+size_t RtpRelay::getMembers(RelayMemberInfo* out, size_t maxEntries, int64_t nowMicros) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const Member& member : members_) {
+        if (member.address == 0 || count == maxEntries) {
+            continue;
+        }
+        out[count++] = RelayMemberInfo{member.address, member.ssrc, member.packetsIn,
+                                       member.packetsForwarded, member.bytesForwarded,
+                                       member.sendFailures,
+                                       (nowMicros - member.lastHeardMicros) / 1000};
+    }
+    return count;
+}
+
+RelayStats RtpRelay::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RelayStats stats = stats_;
+    stats.members = memberCount_;
+    return stats;
+}
+
+} // namespace ptt
+} // namespace meshrider
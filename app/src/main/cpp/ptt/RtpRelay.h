@@ -0,0 +1,221 @@
+/*
+ * Mesh Rider Wave - Multicast <-> Unicast Relay (reflector)
+ * One well-connected radio carries its talkgroup to unicast-only members
+ *
+ * Without a relay, a radio that cannot join the group (AUTO fell back to
+ * UNICAST) must be listed as a unicast peer by every sender, and sends to
+ * every member itself: N^2 packets across the mesh. With a reflector:
+ * - Members send each packet once, to the reflector, and get everything
+ *   back from it.
+ * - The reflector re-forwards received datagrams as they came off the
+ *   wire (SRTP ciphertext included, nothing decoded): group traffic to
+ *   every member, a member's traffic to the group and the other members.
+ *   Each batch of forwards goes out in sendmmsg() calls.
+ * - RTP is forwarded once per (SSRC, sequence), whichever path brought it;
+ *   control packets (RTCP, floor) are forwarded as they come.
+ * - With SRTP on, control is forwarded only once it verifies, and RTP only
+ *   from a member or an SSRC that has already authenticated here. The
+ *   check is on clear header fields (source address, SSRC), so a spoofer
+ *   can still get datagrams through that members then reject; it cannot
+ *   use an unkeyed reflector as an open amplifier.
+ *
+ * Membership is soft state refreshed by reduced-size RTCP APP packets,
+ * name "MRRL", on the RTP socket (SRTCP-protected like all control):
+ *
+ *      0                   1                   2                   3
+ *     |V=2|P| subtype |   PT=204      |          length = 2           |
+ *     |                         sender SSRC                           |
+ *     |                          "MRRL"                               |
+ *
+ * subtype JOIN (member, every keepaliveMs), LEAVE, ACK (reflector's answer
+ * to each JOIN). A member that hears no ACK for memberTimeoutMs falls back
+ * to sending to each unicast peer itself; the reflector drops a member not
+ * heard for memberTimeoutMs.
+ */
+
+#ifndef MESHRIDER_PTT_RTP_RELAY_H
+#define MESHRIDER_PTT_RTP_RELAY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <netinet/in.h>
+
+namespace meshrider {
+namespace ptt {
+
+constexpr uint32_t kRelayAppName = 0x4D52524C;     // "MRRL"
+constexpr size_t kRelayMessageBytes = 12;
+
+// Unicast-only members one reflector serves
+constexpr size_t kMaxRelayMembers = 32;
+
+// Senders whose sequence numbers are tracked for duplicate suppression
+constexpr size_t kMaxRelayFlows = 64;
+
+// Destinations of one forwarded datagram: every member but the sender, plus
+// the group
+constexpr size_t kMaxRelayTargets = kMaxRelayMembers + 1;
+
+// RelayTarget::member for the multicast group
+constexpr uint8_t kRelayGroupTarget = 0xFF;
+
+enum class RelayRole : uint8_t {
+    OFF,
+    REFLECTOR,  // Joined the group; serves unicast-only members
+    MEMBER      // Unicast-only; sends to and hears from one reflector
+};
+
+enum class RelayMessageType : uint8_t {
+    JOIN = 1,
+    LEAVE = 2,
+    ACK = 3
+};
+
+struct RelayConfig {
+    RelayRole role = RelayRole::OFF;
+    in_addr_t reflectorAddress = 0;     // MEMBER: network order
+    uint32_t keepaliveMs = 1000;        // MEMBER: JOIN interval
+    uint32_t memberTimeoutMs = 5000;    // Silence after which a member (or the reflector) is gone
+};
+
+struct RelayTarget {
+    struct sockaddr_in addr;
+    uint8_t member;                     // Table index, kRelayGroupTarget for the group
+};
+
+// Reflector view of one member
+struct RelayMemberInfo {
+    in_addr_t address;                  // Network order
+    uint32_t ssrc;                      // From its JOINs
+    uint64_t packetsIn;                 // Datagrams it sent us
+    uint64_t packetsForwarded;          // Datagrams sent to it
+    uint64_t bytesForwarded;
+    uint64_t sendFailures;
+    int64_t ageMs;                      // Since last heard
+};
+
+struct RelayStats {
+    uint64_t members;                   // Reflector: current members
+    uint64_t packetsForwarded;          // Per destination
+    uint64_t bytesForwarded;
+    uint64_t duplicatesDropped;         // RTP already forwarded via another path
+    uint64_t joins;                     // Members added
+    uint64_t expiries;                  // Members dropped on timeout
+    uint64_t rejected;                  // JOINs refused, table full
+    uint64_t unverifiedDropped;         // Not forwarded: neither a member nor authenticated
+    uint64_t sendFailures;
+};
+
+/**
+ * Relay state for one home talkgroup (THREAD-SAFE)
+ *
+ * The receive thread routes, answers JOINs and expires members; send
+ * paths read the member list and, on a member, sendViaReflector(). One
+ * short mutex covers the tables; nothing allocates after construction.
+ */
+class RtpRelay {
+public:
+    RtpRelay() = default;
+
+    RtpRelay(const RtpRelay&) = delete;
+    RtpRelay& operator=(const RtpRelay&) = delete;
+
+    void setLocalSsrc(uint32_t ssrc);
+
+    // A role change forgets members, flows and the reflector's liveness
+    void configure(const RelayConfig& config, int64_t nowMicros);
+    RelayConfig getConfig() const;
+
+    RelayRole role() const { return role_.load(std::memory_order_acquire); }
+
+    // MEMBER with a live reflector: send to it alone (lock-free)
+    bool sendViaReflector() const { return reflectorAlive_.load(std::memory_order_acquire); }
+
+    // RTCP APP packet with our name (single packet or first in a compound)
+    static bool isRelayMessage(const uint8_t* data, size_t length);
+
+    // Message for the wire; returns kRelayMessageBytes
+    size_t buildMessage(RelayMessageType type, uint8_t* out) const;
+
+    // A verified relay message from fromAddress. Returns true when the
+    // reflector must answer with an ACK.
+    bool onMessage(const uint8_t* data, size_t length, in_addr_t fromAddress, int64_t nowMicros);
+
+    // Reflector: where a received datagram goes (port in network order;
+    // group null when not joined). rtp enables duplicate suppression
+    // (sequence number from the clear header). An unverified datagram goes
+    // out only if a member sent it. Returns the targets written.
+    size_t route(const uint8_t* data, size_t length, bool rtp, bool verified,
+                 in_addr_t fromAddress, uint16_t port, const struct sockaddr_in* group,
+                 int64_t nowMicros, RelayTarget* out, size_t maxTargets);
+
+    // Reflector: current members as send destinations (our own voice and
+    // control). Returns the number written.
+    size_t copyMembers(RelayTarget* out, size_t maxTargets, uint16_t port) const;
+
+    // Outcome of forwards to route() targets
+    void recordForwards(const RelayTarget* targets, const bool* sent, const size_t* bytes,
+                        size_t count);
+
+    // Member expiry (reflector), JOIN timer and reflector liveness (member).
+    // sendJoin is set when a JOIN is due.
+    void service(int64_t nowMicros, bool& sendJoin);
+
+    // When service() next has work, 0 if nothing is scheduled
+    int64_t nextDeadlineMicros() const;
+
+    size_t getMembers(RelayMemberInfo* out, size_t maxEntries, int64_t nowMicros) const;
+    RelayStats getStats() const;
+
+private:
+    struct Member {
+        in_addr_t address = 0;          // 0: free slot
+        uint32_t ssrc = 0;
+        int64_t lastHeardMicros = 0;
+        uint64_t packetsIn = 0;
+        uint64_t packetsForwarded = 0;
+        uint64_t bytesForwarded = 0;
+        uint64_t sendFailures = 0;
+    };
+
+    // Sequence window per sender, like an SRTP replay window
+    struct Flow {
+        uint32_t ssrc = 0;
+        bool active = false;
+        uint16_t highestSeq = 0;
+        uint64_t window = 0;            // Bit n: highestSeq - n already forwarded
+        int64_t lastSeenMicros = 0;
+    };
+
+    Member* findMemberLocked(in_addr_t address);
+
+    // False if (ssrc, seq) was already forwarded
+    bool admitLocked(uint32_t ssrc, uint16_t seq, int64_t nowMicros);
+
+    mutable std::mutex mutex_;
+    std::atomic<RelayRole> role_{RelayRole::OFF};
+    std::atomic<bool> reflectorAlive_{false};
+
+    RelayConfig config_;
+    uint32_t localSsrc_ = 0;
+
+    // Member: reflector liveness and JOIN timer
+    int64_t lastAckMicros_ = 0;
+    int64_t nextJoinMicros_ = 0;
+
+    // Reflector
+    std::array<Member, kMaxRelayMembers> members_{};
+    std::array<Flow, kMaxRelayFlows> flows_{};
+    size_t memberCount_ = 0;
+    int64_t nextExpiryMicros_ = 0;
+
+    RelayStats stats_{};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_RTP_RELAY_H
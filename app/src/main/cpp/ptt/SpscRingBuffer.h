@@ -0,0 +1,118 @@
+/*
+ * Mesh Rider Wave - Lock-free SPSC Ring Buffer
+ * Single-producer/single-consumer FIFO for real-time audio threads
+ *
+ * Safe to use from an Oboe callback: no locks, no allocation, no syscalls.
+ * Both read() and write() are wait-free and complete in bounded time.
+ */
+
+#ifndef MESHRIDER_PTT_SPSC_RING_BUFFER_H
+#define MESHRIDER_PTT_SPSC_RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+namespace meshrider {
+namespace ptt {
+
+// Keep producer and consumer indices on separate cache lines
+constexpr size_t kCacheLineSize = 64;
+
+/**
+ * Wait-free ring buffer with storage preallocated inline.
+ * Exactly one thread may call write() and exactly one thread may call read().
+ *
+ * Capacity must be a power of two so index wrap is a mask, not a modulo.
+ * Indices are free-running; (write - read) is the fill level.
+ */
+template <typename T, size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRingBuffer capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SpscRingBuffer elements must be trivially copyable");
+
+public:
+    SpscRingBuffer() = default;
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side: copy up to count elements in, returns number written
+    size_t write(const T* data, size_t count) {
+        const size_t w = writeIndex_.load(std::memory_order_relaxed);
+        const size_t r = readIndex_.load(std::memory_order_acquire);
+        const size_t toWrite = std::min(count, Capacity - (w - r));
+
+        const size_t start = w & kMask;
+        const size_t first = std::min(toWrite, Capacity - start);
+        std::copy(data, data + first, buffer_.begin() + start);
+        std::copy(data + first, data + toWrite, buffer_.begin());
+
+        writeIndex_.store(w + toWrite, std::memory_order_release);
+        return toWrite;
+    }
+
+    // Consumer side: copy up to count elements out, returns number read
+    size_t read(T* out, size_t count) {
+        const size_t r = readIndex_.load(std::memory_order_relaxed);
+        const size_t w = writeIndex_.load(std::memory_order_acquire);
+        const size_t toRead = std::min(count, w - r);
+
+        const size_t start = r & kMask;
+        const size_t first = std::min(toRead, Capacity - start);
+        std::copy(buffer_.begin() + start, buffer_.begin() + start + first, out);
+        std::copy(buffer_.begin(), buffer_.begin() + (toRead - first), out + first);
+
+        readIndex_.store(r + toRead, std::memory_order_release);
+        return toRead;
+    }
+
+    // Consumer side: copy up to count elements out without consuming them
+    size_t peek(T* out, size_t count) const {
+        const size_t r = readIndex_.load(std::memory_order_relaxed);
+        const size_t w = writeIndex_.load(std::memory_order_acquire);
+        const size_t toRead = std::min(count, w - r);
+
+        const size_t start = r & kMask;
+        const size_t first = std::min(toRead, Capacity - start);
+        std::copy(buffer_.begin() + start, buffer_.begin() + start + first, out);
+        std::copy(buffer_.begin(), buffer_.begin() + (toRead - first), out + first);
+        return toRead;
+    }
+
+    // Fill level as seen by the consumer
+    size_t availableToRead() const {
+        return writeIndex_.load(std::memory_order_acquire) -
+               readIndex_.load(std::memory_order_relaxed);
+    }
+
+    // Free space as seen by the producer
+    size_t availableToWrite() const {
+        return Capacity - (writeIndex_.load(std::memory_order_relaxed) -
+                           readIndex_.load(std::memory_order_acquire));
+    }
+
+    // Discard contents. Only valid while neither side is running.
+    void reset() {
+        writeIndex_.store(0, std::memory_order_relaxed);
+        readIndex_.store(0, std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+
+    alignas(kCacheLineSize) std::atomic<size_t> writeIndex_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> readIndex_{0};
+    alignas(kCacheLineSize) std::array<T, Capacity> buffer_{};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_SPSC_RING_BUFFER_H
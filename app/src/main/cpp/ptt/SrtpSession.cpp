@@ -0,0 +1,501 @@
+/*
+ * Mesh Rider Wave - SRTP/SRTCP AES-GCM Implementation
+ */
+
+#include "SrtpSession.h"
+#include <algorithm>
+#include <cstring>
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// RFC 3711 4.3.1 key derivation labels
+constexpr uint8_t kLabelRtpEncryption = 0x00;
+constexpr uint8_t kLabelRtpSalt = 0x02;
+constexpr uint8_t kLabelRtcpEncryption = 0x03;
+constexpr uint8_t kLabelRtcpSalt = 0x05;
+
+constexpr uint32_t kSrtcpEncryptedFlag = 0x80000000u;
+constexpr uint32_t kSrtcpIndexMask = 0x7FFFFFFFu;
+
+inline uint32_t loadBe32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline void storeBe32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+// RFC 3711 4.3.3 AES-CM PRF: x = (label << 48) XOR salt, keystream from
+// E(master, x || counter16). The 96-bit GCM salt is zero-extended to 112 bits.
+void deriveSessionBytes(const AesGcm& master, const uint8_t* masterSalt, uint8_t label,
+                        uint8_t* out, size_t bytes) {
+    uint8_t block[kAesBlockBytes] = {};
+    std::memcpy(block, masterSalt, kSrtpMasterSaltBytes);
+    block[7] ^= label;
+    uint16_t counter = 0;
+    while (bytes > 0) {
+        block[14] = static_cast<uint8_t>(counter >> 8);
+        block[15] = static_cast<uint8_t>(counter);
+        uint8_t keystream[kAesBlockBytes];
+        master.encryptBlock(block, keystream);
+        const size_t n = std::min(bytes, kAesBlockBytes);
+        std::memcpy(out, keystream, n);
+        out += n;
+        bytes -= n;
+        ++counter;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Replay window
+// ============================================================================
+
+bool SrtpSession::ReplayWindow::check(uint64_t index) const {
+    if (!started || index > highest) {
+        return true;
+    }
+    const uint64_t delta = highest - index;
+    if (delta >= kSrtpReplayWindow) {
+        return false;
+    }
+    return ((seen[delta / 64] >> (delta % 64)) & 1) == 0;
+}
+
+void SrtpSession::ReplayWindow::accept(uint64_t index) {
+    if (!started || index > highest) {
+        const uint64_t shift = started ? index - highest : kSrtpReplayWindow;
+        if (shift >= kSrtpReplayWindow) {
+            seen.fill(0);
+        } else {
+            // Multi-word left shift: bit n moves to n + shift
+            const size_t words = static_cast<size_t>(shift / 64);
+            const unsigned bits = static_cast<unsigned>(shift % 64);
+            for (size_t i = seen.size(); i-- > 0;) {
+                uint64_t value = i >= words ? seen[i - words] << bits : 0;
+                if (bits != 0 && i >= words + 1) {
+                    value |= seen[i - words - 1] >> (64 - bits);
+                }
+                seen[i] = value;
+            }
+        }
+        started = true;
+        highest = index;
+        seen[0] |= 1;
+        return;
+    }
+    const uint64_t delta = highest - index;
+    seen[delta / 64] |= uint64_t{1} << (delta % 64);
+}
+
+// ============================================================================
+// SrtpSession
+// ============================================================================
+
+SrtpSession::SrtpSession() {
+    stats_.backend = AesGcm::bestBackend();
+}
+
+SrtpSession::~SrtpSession() {
+    clear();
+}
+
+bool SrtpSession::setBackend(CryptoBackend backend) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Keys* all[] = {&current_, &previous_};
+    for (Keys* keys : all) {
+        if (!keys->rtp.setBackend(backend) || !keys->rtcp.setBackend(backend)) {
+            return false;
+        }
+    }
+    stats_.backend = backend;
+    return true;
+}
+
+void SrtpSession::deriveKeys(Keys& keys, const uint8_t* masterKey, size_t keyBytes,
+                             const uint8_t* masterSalt) {
+    AesGcm master;
+    master.setBackend(keys.rtp.getBackend());
+    master.setKey(masterKey, keyBytes);
+
+    uint8_t sessionKey[kAes256KeyBytes];
+    deriveSessionBytes(master, masterSalt, kLabelRtpEncryption, sessionKey, keyBytes);
+    keys.rtp.setKey(sessionKey, keyBytes);
+    deriveSessionBytes(master, masterSalt, kLabelRtpSalt, keys.rtpSalt, kSrtpMasterSaltBytes);
+    deriveSessionBytes(master, masterSalt, kLabelRtcpEncryption, sessionKey, keyBytes);
+    keys.rtcp.setKey(sessionKey, keyBytes);
+    deriveSessionBytes(master, masterSalt, kLabelRtcpSalt, keys.rtcpSalt, kSrtpMasterSaltBytes);
+    secureZero(sessionKey, sizeof(sessionKey));
+}
+
+bool SrtpSession::setMasterKey(uint64_t epoch, const uint8_t* key, size_t keyBytes,
+                               const uint8_t* salt, size_t saltBytes, int64_t nowMicros) {
+    return installKeys(epoch, key, keyBytes, salt, saltBytes, nowMicros, true);
+}
+
+bool SrtpSession::setSessionKeys(uint64_t epoch, const uint8_t* key, size_t keyBytes,
+                                 const uint8_t* salt, size_t saltBytes, int64_t nowMicros) {
+    return installKeys(epoch, key, keyBytes, salt, saltBytes, nowMicros, false);
+}
+
+bool SrtpSession::installKeys(uint64_t epoch, const uint8_t* key, size_t keyBytes,
+                              const uint8_t* salt, size_t saltBytes, int64_t nowMicros,
+                              bool derive) {
+    if (!key || (keyBytes != kAes128KeyBytes && keyBytes != kAes256KeyBytes) ||
+        !salt || saltBytes != kSrtpMasterSaltBytes) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_.valid && epoch <= current_.epoch) {
+        return false;
+    }
+
+    if (current_.valid) {
+        previous_ = current_;
+        previous_.expiresMicros = nowMicros +
+            static_cast<int64_t>(kSrtpPreviousEpochGraceMs) * 1000;
+    }
+    current_.rtp.clear();
+    current_.rtcp.clear();
+    if (derive) {
+        deriveKeys(current_, key, keyBytes, salt);
+    } else {
+        current_.rtp.setKey(key, keyBytes);
+        current_.rtcp.setKey(key, keyBytes);
+        std::memcpy(current_.rtpSalt, salt, kSrtpMasterSaltBytes);
+        std::memcpy(current_.rtcpSalt, salt, kSrtpMasterSaltBytes);
+    }
+    current_.epoch = epoch;
+    current_.valid = true;
+    current_.expiresMicros = 0;
+
+    stats_.keyEpoch = epoch;
+    active_.store(true, std::memory_order_release);
+    return true;
+}
+
+void SrtpSession::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_.store(false, std::memory_order_release);
+    Keys* all[] = {&current_, &previous_};
+    for (Keys* keys : all) {
+        keys->rtp.clear();
+        keys->rtcp.clear();
+        secureZero(keys->rtpSalt, sizeof(keys->rtpSalt));
+        secureZero(keys->rtcpSalt, sizeof(keys->rtcpSalt));
+        keys->valid = false;
+        keys->epoch = 0;
+    }
+    sources_.fill(Source{});
+    txStarted_ = false;
+    txRoc_ = 0;
+    txRtcpIndex_ = 0;
+    stats_.keyEpoch = 0;
+}
+
+void SrtpSession::rtpIv(const uint8_t salt[kSrtpMasterSaltBytes], uint32_t ssrc, uint32_t roc,
+                        uint16_t seq, uint8_t iv[kGcmIvBytes]) {
+    iv[0] = 0;
+    iv[1] = 0;
+    storeBe32(iv + 2, ssrc);
+    storeBe32(iv + 6, roc);
+    iv[10] = static_cast<uint8_t>(seq >> 8);
+    iv[11] = static_cast<uint8_t>(seq);
+    for (size_t i = 0; i < kGcmIvBytes; ++i) {
+        iv[i] ^= salt[i];
+    }
+}
+
+void SrtpSession::rtcpIv(const uint8_t salt[kSrtpMasterSaltBytes], uint32_t ssrc,
+                         uint32_t index, uint8_t iv[kGcmIvBytes]) {
+    iv[0] = 0;
+    iv[1] = 0;
+    storeBe32(iv + 2, ssrc);
+    iv[6] = 0;
+    iv[7] = 0;
+    storeBe32(iv + 8, index & kSrtcpIndexMask);
+    for (size_t i = 0; i < kGcmIvBytes; ++i) {
+        iv[i] ^= salt[i];
+    }
+}
+
+void SrtpSession::expirePreviousLocked(int64_t nowMicros) {
+    if (previous_.valid && previous_.expiresMicros != 0 && nowMicros >= previous_.expiresMicros) {
+        previous_.rtp.clear();
+        previous_.rtcp.clear();
+        secureZero(previous_.rtpSalt, sizeof(previous_.rtpSalt));
+        secureZero(previous_.rtcpSalt, sizeof(previous_.rtcpSalt));
+        previous_.valid = false;
+    }
+}
+
+bool SrtpSession::isKnownSource(uint32_t ssrc) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Source& source : sources_) {
+        if (source.active && source.ssrc == ssrc) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SrtpSession::Source* SrtpSession::findSourceLocked(uint32_t ssrc) {
+    for (Source& source : sources_) {
+        if (source.active && source.ssrc == ssrc) {
+            return &source;
+        }
+    }
+    return nullptr;
+}
+
+SrtpSession::Source* SrtpSession::addSourceLocked(uint32_t ssrc, int64_t nowMicros) {
+    Source* freeSlot = nullptr;
+    Source* oldest = nullptr;
+    for (Source& source : sources_) {
+        if (!source.active) {
+            if (!freeSlot) {
+                freeSlot = &source;
+            }
+        } else if (!oldest || source.lastHeardMicros < oldest->lastHeardMicros) {
+            oldest = &source;
+        }
+    }
+    // Table full: the longest-silent sender gives way
+    Source* slot = freeSlot ? freeSlot : oldest;
+    *slot = Source{};
+    slot->ssrc = ssrc;
+    slot->active = true;
+    slot->lastHeardMicros = nowMicros;
+    return slot;
+}
+
+size_t SrtpSession::protectRtp(uint8_t* packet, size_t headerBytes, size_t payloadBytes,
+                               size_t capacity) {
+    if (!isActive() || headerBytes + payloadBytes + kSrtpTagBytes > capacity) {
+        return 0;
+    }
+    const uint32_t ssrc = loadBe32(packet + 8);
+    const uint16_t seq = static_cast<uint16_t>((packet[2] << 8) | packet[3]);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_.valid) {
+        return 0;
+    }
+
+    // ROC counts sequence wraps of our own stream (RFC 3711 3.3.1)
+    if (!txStarted_ || ssrc != txSsrc_) {
+        txStarted_ = true;
+        txSsrc_ = ssrc;
+        txRoc_ = 0;
+    } else if (seq < txLastSeq_ && txLastSeq_ - seq > 0x8000) {
+        ++txRoc_;
+    }
+    txLastSeq_ = seq;
+
+    uint8_t iv[kGcmIvBytes];
+    rtpIv(current_.rtpSalt, ssrc, txRoc_, seq, iv);
+    current_.rtp.seal(iv, packet, headerBytes, packet + headerBytes, payloadBytes,
+                      packet + headerBytes + payloadBytes);
+    ++stats_.rtpProtected;
+    return headerBytes + payloadBytes + kSrtpTagBytes;
+}
+
+const SrtpSession::Keys* SrtpSession::openRtpLocked(uint8_t* packet, size_t headerBytes,
+                                                    size_t payloadBytes, uint32_t ssrc,
+                                                    uint32_t roc, uint16_t seq,
+                                                    int64_t nowMicros) {
+    expirePreviousLocked(nowMicros);
+    const Keys* candidates[] = {&current_, &previous_};
+    for (const Keys* keys : candidates) {
+        if (!keys->valid) {
+            continue;
+        }
+        uint8_t iv[kGcmIvBytes];
+        rtpIv(keys->rtpSalt, ssrc, roc, seq, iv);
+        if (keys->rtp.open(iv, packet, headerBytes, packet + headerBytes, payloadBytes,
+                           packet + headerBytes + payloadBytes)) {
+            return keys;
+        }
+    }
+    return nullptr;
+}
+
+SrtpStatus SrtpSession::unprotectRtp(uint8_t* packet, size_t& length, size_t headerBytes,
+                                     int64_t nowMicros) {
+    if (!isActive()) {
+        return SrtpStatus::NO_KEY;
+    }
+    if (headerBytes < 12 || length < headerBytes + kSrtpTagBytes) {
+        return SrtpStatus::MALFORMED;
+    }
+    const uint32_t ssrc = loadBe32(packet + 8);
+    const uint16_t seq = static_cast<uint16_t>((packet[2] << 8) | packet[3]);
+    const size_t payloadBytes = length - headerBytes - kSrtpTagBytes;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Source* source = findSourceLocked(ssrc);
+    const Keys* keys = nullptr;
+    uint32_t roc = 0;
+
+    if (!source || !source->rtpWindow.started) {
+        // Unknown sender: it may have wrapped its sequence before we joined
+        for (uint32_t guess = 0; guess < kSrtpRocSearchLimit && !keys; ++guess) {
+            keys = openRtpLocked(packet, headerBytes, payloadBytes, ssrc, guess, seq, nowMicros);
+            roc = guess;
+        }
+        if (!keys) {
+            ++stats_.authFailures;
+            return SrtpStatus::AUTH_FAILED;
+        }
+        if (!source) {
+            source = addSourceLocked(ssrc, nowMicros);
+        }
+        source->roc = roc;
+        source->highestSeq = seq;
+    } else {
+        // RFC 3711 3.3.1 index estimate around the highest sequence seen
+        int64_t guess = source->roc;
+        if (source->highestSeq < 0x8000) {
+            if (seq > source->highestSeq && seq - source->highestSeq > 0x8000) {
+                --guess;
+            }
+        } else if (seq < source->highestSeq && source->highestSeq - 0x8000 > seq) {
+            ++guess;
+        }
+        if (guess < 0) {
+            ++stats_.replayDrops;
+            return SrtpStatus::REPLAYED;
+        }
+        roc = static_cast<uint32_t>(guess);
+        const uint64_t index = (static_cast<uint64_t>(roc) << 16) | seq;
+        if (!source->rtpWindow.check(index)) {
+            ++stats_.replayDrops;
+            return SrtpStatus::REPLAYED;
+        }
+        keys = openRtpLocked(packet, headerBytes, payloadBytes, ssrc, roc, seq, nowMicros);
+        if (!keys) {
+            ++stats_.authFailures;
+            return SrtpStatus::AUTH_FAILED;
+        }
+        if (roc > source->roc) {
+            source->roc = roc;
+            source->highestSeq = seq;
+        } else if (roc == source->roc && seq > source->highestSeq) {
+            source->highestSeq = seq;
+        }
+    }
+
+    source->rtpWindow.accept((static_cast<uint64_t>(roc) << 16) | seq);
+    source->lastHeardMicros = nowMicros;
+    ++stats_.rtpVerified;
+    if (keys == &previous_) {
+        ++stats_.previousEpochPackets;
+    }
+    length -= kSrtpTagBytes;
+    return SrtpStatus::OK;
+}
+
+size_t SrtpSession::protectRtcp(uint8_t* packet, size_t length, size_t capacity) {
+    if (!isActive() || length < kSrtcpHeaderBytes ||
+        length + kSrtcpOverheadBytes > capacity) {
+        return 0;
+    }
+    const uint32_t ssrc = loadBe32(packet + 4);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_.valid) {
+        return 0;
+    }
+    const uint32_t index = txRtcpIndex_;
+    txRtcpIndex_ = (txRtcpIndex_ + 1) & kSrtcpIndexMask;
+
+    // AAD: clear header and SSRC, then E || index (which also trails the packet)
+    uint8_t aad[kSrtcpHeaderBytes + kSrtcpTrailerBytes];
+    std::memcpy(aad, packet, kSrtcpHeaderBytes);
+    storeBe32(aad + kSrtcpHeaderBytes, kSrtcpEncryptedFlag | index);
+
+    uint8_t iv[kGcmIvBytes];
+    rtcpIv(current_.rtcpSalt, ssrc, index, iv);
+    const size_t encryptedBytes = length - kSrtcpHeaderBytes;
+    current_.rtcp.seal(iv, aad, sizeof(aad), packet + kSrtcpHeaderBytes, encryptedBytes,
+                       packet + length);
+    std::memcpy(packet + length + kSrtpTagBytes, aad + kSrtcpHeaderBytes, kSrtcpTrailerBytes);
+    ++stats_.rtcpProtected;
+    return length + kSrtcpOverheadBytes;
+}
+
+SrtpStatus SrtpSession::unprotectRtcp(uint8_t* packet, size_t& length, int64_t nowMicros) {
+    if (!isActive()) {
+        return SrtpStatus::NO_KEY;
+    }
+    if (length < kSrtcpHeaderBytes + kSrtcpOverheadBytes) {
+        return SrtpStatus::MALFORMED;
+    }
+    const uint32_t ssrc = loadBe32(packet + 4);
+    const uint32_t trailer = loadBe32(packet + length - kSrtcpTrailerBytes);
+    if ((trailer & kSrtcpEncryptedFlag) == 0) {
+        return SrtpStatus::MALFORMED;   // Authentication-only SRTCP is not accepted
+    }
+    const uint32_t index = trailer & kSrtcpIndexMask;
+    const size_t encryptedBytes = length - kSrtcpHeaderBytes - kSrtcpOverheadBytes;
+
+    uint8_t aad[kSrtcpHeaderBytes + kSrtcpTrailerBytes];
+    std::memcpy(aad, packet, kSrtcpHeaderBytes);
+    storeBe32(aad + kSrtcpHeaderBytes, trailer);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Source* source = findSourceLocked(ssrc);
+    if (source && !source->rtcpWindow.check(index)) {
+        ++stats_.replayDrops;
+        return SrtpStatus::REPLAYED;
+    }
+
+    expirePreviousLocked(nowMicros);
+    const Keys* candidates[] = {&current_, &previous_};
+    const Keys* matched = nullptr;
+    for (const Keys* keys : candidates) {
+        if (!keys->valid) {
+            continue;
+        }
+        uint8_t iv[kGcmIvBytes];
+        rtcpIv(keys->rtcpSalt, ssrc, index, iv);
+        if (keys->rtcp.open(iv, aad, sizeof(aad), packet + kSrtcpHeaderBytes, encryptedBytes,
+                            packet + kSrtcpHeaderBytes + encryptedBytes)) {
+            matched = keys;
+            break;
+        }
+    }
+    if (!matched) {
+        ++stats_.authFailures;
+        return SrtpStatus::AUTH_FAILED;
+    }
+
+    if (!source) {
+        source = addSourceLocked(ssrc, nowMicros);
+    }
+    source->rtcpWindow.accept(index);
+    source->lastHeardMicros = nowMicros;
+    ++stats_.rtcpVerified;
+    if (matched == &previous_) {
+        ++stats_.previousEpochPackets;
+    }
+    length -= kSrtcpOverheadBytes;
+    return SrtpStatus::OK;
+}
+
+SrtpStats SrtpSession::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace ptt
+} // namespace meshrider
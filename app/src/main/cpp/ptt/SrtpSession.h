@@ -0,0 +1,206 @@
+/*
+ * Mesh Rider Wave - SRTP/SRTCP with AES-GCM (RFC 3711, RFC 7714)
+ * Payload protection inside the native RTP path, keyed from MLS epochs
+ *
+ * RTP: header (with CSRCs and extensions) stays clear and is authenticated
+ * as AAD; payload is encrypted in place and a 16-byte tag appended:
+ *
+ *     IV = (00 00 || SSRC || ROC || SEQ) XOR session salt      (RFC 7714 8.1)
+ *
+ * RTCP: the first 8 octets and a trailing E || 31-bit SRTCP index are AAD,
+ * the rest of the compound packet is encrypted (RFC 7714 9).
+ *
+ * Session keys and salts come from the master key and salt with the
+ * RFC 3711 4.3 AES-CM KDF (key derivation rate 0), as libsrtp does for the
+ * AEAD_AES_128_GCM / AEAD_AES_256_GCM profiles. Kotlin exports the master
+ * key/salt from the MLS epoch and pushes them over JNI; each epoch change
+ * installs new keys and keeps the previous epoch for
+ * kSrtpPreviousEpochGraceMs, so packets encrypted just before a commit
+ * still play.
+ *
+ * Receivers estimate the packet index (ROC || SEQ, RFC 3711 3.3.1) per
+ * sender and reject anything older than the kSrtpReplayWindow most recent
+ * indices or already seen, before decrypting. Sources are a fixed table;
+ * nothing allocates after construction.
+ */
+
+#ifndef MESHRIDER_PTT_SRTP_SESSION_H
+#define MESHRIDER_PTT_SRTP_SESSION_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "AesGcm.h"
+
+namespace meshrider {
+namespace ptt {
+
+constexpr size_t kSrtpMasterSaltBytes = 12;         // RFC 7714 12 (96-bit salt)
+constexpr size_t kSrtpTagBytes = kGcmTagBytes;
+constexpr size_t kSrtcpTrailerBytes = 4;            // E flag + SRTCP index
+constexpr size_t kSrtcpHeaderBytes = 8;             // Clear: V/P/RC, PT, length, SSRC
+
+// Per-packet growth when protection is on
+constexpr size_t kSrtpOverheadBytes = kSrtpTagBytes;
+constexpr size_t kSrtcpOverheadBytes = kSrtpTagBytes + kSrtcpTrailerBytes;
+
+// Replay window in packets (RFC 3711 requires >= 64)
+constexpr uint32_t kSrtpReplayWindow = 128;
+
+// Senders tracked at once (one per talker heard, home and scan channels)
+constexpr size_t kMaxSrtpSources = 32;
+
+// Old epoch keys kept after a rekey for packets already in flight
+constexpr uint32_t kSrtpPreviousEpochGraceMs = 10000;
+
+// First packet from an unknown sender: ROC values tried (each covers 65536
+// packets, ~22 min of continuous 20 ms frames), for radios joining mid-session
+constexpr uint32_t kSrtpRocSearchLimit = 8;
+
+enum class SrtpStatus : uint8_t {
+    OK,
+    NO_KEY,         // Protection off: packet passed through unchanged
+    MALFORMED,
+    REPLAYED,       // Seen before or older than the replay window
+    AUTH_FAILED     // No installed key authenticates it
+};
+
+struct SrtpStats {
+    uint64_t keyEpoch;              // Current epoch, 0 before the first key
+    uint64_t rtpProtected;
+    uint64_t rtpVerified;
+    uint64_t rtcpProtected;
+    uint64_t rtcpVerified;
+    uint64_t authFailures;          // RTP + RTCP
+    uint64_t replayDrops;
+    uint64_t previousEpochPackets;  // Authenticated with the previous epoch's keys
+    CryptoBackend backend;
+};
+
+/**
+ * SRTP context for one radio: its own send stream plus every sender it
+ * hears (THREAD-SAFE)
+ *
+ * protect*() run on the sending threads, unprotect*() on the receive
+ * thread, setMasterKey()/clear() from JNI. All take one short mutex; the
+ * crypto inside it costs about a microsecond per voice packet with the
+ * ARMv8 Crypto Extension.
+ */
+class SrtpSession {
+public:
+    SrtpSession();
+    ~SrtpSession();
+
+    SrtpSession(const SrtpSession&) = delete;
+    SrtpSession& operator=(const SrtpSession&) = delete;
+
+    // Install an epoch's master key (16 or 32 bytes) and salt (12 bytes).
+    // An epoch at or below the current one is refused (replayed commit).
+    bool setMasterKey(uint64_t epoch, const uint8_t* key, size_t keyBytes,
+                      const uint8_t* salt, size_t saltBytes, int64_t nowMicros);
+
+    // Same, but key and salt are already the session key and salt (RTP and
+    // RTCP alike), skipping the KDF: the form RFC 7714 16 gives its test
+    // vectors in. Known-answer tests only.
+    bool setSessionKeys(uint64_t epoch, const uint8_t* key, size_t keyBytes,
+                        const uint8_t* salt, size_t saltBytes, int64_t nowMicros);
+
+    // Protection off; keys wiped, sender state forgotten
+    void clear();
+
+    bool isActive() const { return active_.load(std::memory_order_acquire); }
+
+    // Pin the AES-GCM kernels (benchmark); false if unavailable
+    bool setBackend(CryptoBackend backend);
+
+    // Encrypt the payload of an RTP packet in place and append the tag.
+    // Returns the new length, or 0 if inactive or capacity is short.
+    size_t protectRtp(uint8_t* packet, size_t headerBytes, size_t payloadBytes,
+                      size_t capacity);
+
+    // Verify and decrypt in place; on OK, length drops the tag. headerBytes
+    // is the clear RTP header (CSRCs and extension included).
+    SrtpStatus unprotectRtp(uint8_t* packet, size_t& length, size_t headerBytes,
+                            int64_t nowMicros);
+
+    // Compound RTCP packet in place; returns the new length or 0
+    size_t protectRtcp(uint8_t* packet, size_t length, size_t capacity);
+    SrtpStatus unprotectRtcp(uint8_t* packet, size_t& length, int64_t nowMicros);
+
+    // A packet from ssrc has authenticated (the reflector's forwarding gate)
+    bool isKnownSource(uint32_t ssrc) const;
+
+    SrtpStats getStats() const;
+
+private:
+    struct Keys {
+        uint64_t epoch = 0;
+        bool valid = false;
+        int64_t expiresMicros = 0;      // Previous epoch only; 0 = no expiry
+        AesGcm rtp;
+        AesGcm rtcp;
+        uint8_t rtpSalt[kSrtpMasterSaltBytes] = {};
+        uint8_t rtcpSalt[kSrtpMasterSaltBytes] = {};
+    };
+
+    // Replay state over a 48-bit (SRTP) or 31-bit (SRTCP) index
+    struct ReplayWindow {
+        bool started = false;
+        uint64_t highest = 0;
+        std::array<uint64_t, kSrtpReplayWindow / 64> seen{};   // Bit n = highest - n
+
+        bool check(uint64_t index) const;
+        void accept(uint64_t index);
+    };
+
+    struct Source {
+        uint32_t ssrc = 0;
+        bool active = false;
+        int64_t lastHeardMicros = 0;
+        uint32_t roc = 0;
+        uint16_t highestSeq = 0;
+        ReplayWindow rtpWindow;
+        ReplayWindow rtcpWindow;
+    };
+
+    bool installKeys(uint64_t epoch, const uint8_t* key, size_t keyBytes,
+                     const uint8_t* salt, size_t saltBytes, int64_t nowMicros, bool derive);
+    static void deriveKeys(Keys& keys, const uint8_t* masterKey, size_t keyBytes,
+                           const uint8_t* masterSalt);
+    static void rtpIv(const uint8_t salt[kSrtpMasterSaltBytes], uint32_t ssrc, uint32_t roc,
+                      uint16_t seq, uint8_t iv[kGcmIvBytes]);
+    static void rtcpIv(const uint8_t salt[kSrtpMasterSaltBytes], uint32_t ssrc, uint32_t index,
+                       uint8_t iv[kGcmIvBytes]);
+
+    // Try the current, then the previous epoch's keys
+    const Keys* openRtpLocked(uint8_t* packet, size_t headerBytes, size_t payloadBytes,
+                              uint32_t ssrc, uint32_t roc, uint16_t seq, int64_t nowMicros);
+
+    // Senders enter the table only once a packet from them authenticates
+    Source* findSourceLocked(uint32_t ssrc);
+    Source* addSourceLocked(uint32_t ssrc, int64_t nowMicros);
+    void expirePreviousLocked(int64_t nowMicros);
+
+    mutable std::mutex mutex_;
+    std::atomic<bool> active_{false};
+    Keys current_;
+    Keys previous_;
+    std::array<Source, kMaxSrtpSources> sources_{};
+
+    // Our send stream (under mutex_)
+    bool txStarted_ = false;
+    uint32_t txSsrc_ = 0;
+    uint32_t txRoc_ = 0;
+    uint16_t txLastSeq_ = 0;
+    uint32_t txRtcpIndex_ = 0;
+
+    // Statistics (under mutex_)
+    SrtpStats stats_{};
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_SRTP_SESSION_H
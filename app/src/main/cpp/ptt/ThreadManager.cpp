@@ -0,0 +1,326 @@
+/*
+ * Mesh Rider Wave - Native Worker Thread Manager Implementation
+ */
+
+#include "ThreadManager.h"
+#include "LatencyTracer.h"
+#include "PttLog.h"
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+#define TAG "MeshRider:PTT-Threads"
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// Affinity masks are 64 bits wide
+constexpr int kMaxManagedCpus = 64;
+
+const char* roleName(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::NETWORK:  return "network";
+        case ThreadRole::ENCODER:  return "encoder";
+        case ThreadRole::DECODER:  return "decoder";
+        case ThreadRole::RECORDER: return "recorder";
+        default:                   return "?";
+    }
+}
+
+int32_t currentTid() {
+    return static_cast<int32_t>(syscall(SYS_gettid));
+}
+
+int configuredCpus() {
+    const long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpus <= 0) {
+        return 1;
+    }
+    return cpus > kMaxManagedCpus ? kMaxManagedCpus : static_cast<int>(cpus);
+}
+
+bool setAffinity(int32_t tid, uint64_t mask) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = 0; cpu < kMaxManagedCpus; ++cpu) {
+        if (mask & (uint64_t{1} << cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return sched_setaffinity(tid, sizeof(set), &set) == 0;
+}
+
+uint64_t allCpusMask() {
+    const int cpus = configuredCpus();
+    return cpus >= kMaxManagedCpus ? ~uint64_t{0} : (uint64_t{1} << cpus) - 1;
+}
+
+// One unsigned integer from a sysfs file, 0 if absent
+uint64_t readSysfsValue(const char* path) {
+    FILE* file = fopen(path, "re");
+    if (!file) {
+        return 0;
+    }
+    unsigned long long value = 0;
+    if (fscanf(file, "%llu", &value) != 1) {
+        value = 0;
+    }
+    fclose(file);
+    return value;
+}
+
+} // namespace
+
+ThreadPolicy defaultThreadPolicy(ThreadRole role) {
+    ThreadPolicy policy;
+    switch (role) {
+        case ThreadRole::NETWORK:
+            // Packets wait in the socket buffer for this thread alone
+            policy.sched = ThreadSched::FIFO;
+            break;
+        case ThreadRole::RECORDER:
+            policy.nice = kBackgroundNice;
+            break;
+        default:
+            break;
+    }
+    return policy;
+}
+
+ThreadManager::ThreadManager() {
+    for (size_t i = 0; i < kThreadRoleCount; ++i) {
+        slots_[i].policy = defaultThreadPolicy(static_cast<ThreadRole>(i));
+    }
+}
+
+void ThreadManager::setPolicy(ThreadRole role, const ThreadPolicy& policy) {
+    if (role >= ThreadRole::COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot& s = slot(role);
+    s.policy = policy;
+    s.fifoRefusedLogged = false;
+    applyLocked(role, s);
+}
+
+ThreadPolicy ThreadManager::getPolicy(ThreadRole role) const {
+    if (role >= ThreadRole::COUNT) {
+        return ThreadPolicy{};
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slot(role).policy;
+}
+
+void ThreadManager::enterThread(ThreadRole role, const char* name) {
+    pthread_setname_np(pthread_self(), name);
+    if (role >= ThreadRole::COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot& s = slot(role);
+    s.tid = currentTid();
+    // A new thread starts from the creator's settings, not the last holder's
+    s.applied = ThreadSched::DEFAULT;
+    s.appliedNice = 0;
+    s.appliedMask = 0;
+    applyLocked(role, s);
+}
+
+void ThreadManager::leaveThread(ThreadRole role) {
+    if (role >= ThreadRole::COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot& s = slot(role);
+    if (s.tid == currentTid()) {
+        s.tid = 0;
+        s.applied = ThreadSched::DEFAULT;
+        s.appliedNice = 0;
+        s.appliedMask = 0;
+    }
+}
+
+void ThreadManager::applyLocked(ThreadRole role, Slot& s) {
+    if (s.tid == 0) {
+        return;
+    }
+    const ThreadPolicy& policy = s.policy;
+    ThreadSched applied = ThreadSched::DEFAULT;
+
+    if (policy.sched == ThreadSched::FIFO) {
+        sched_param param{};
+        param.sched_priority = policy.fifoPriority;
+        if (sched_setscheduler(s.tid, SCHED_FIFO, &param) == 0) {
+            applied = ThreadSched::FIFO;
+        } else if (!s.fifoRefusedLogged) {
+            // Normal for an app process: no RLIMIT_RTPRIO outside system builds
+            __android_log_print(ANDROID_LOG_INFO, TAG,
+                                "SCHED_FIFO refused for %s thread (%s), using nice %d",
+                                roleName(role), strerror(errno), policy.nice);
+            s.fifoRefusedLogged = true;
+        }
+    }
+
+    if (applied != ThreadSched::FIFO) {
+        if (s.applied == ThreadSched::FIFO) {
+            sched_param param{};
+            sched_setscheduler(s.tid, SCHED_OTHER, &param);
+        }
+        if (policy.sched != ThreadSched::DEFAULT) {
+            if (setpriority(PRIO_PROCESS, static_cast<id_t>(s.tid), policy.nice) == 0) {
+                s.appliedNice = policy.nice;
+                applied = ThreadSched::NICE;
+            } else {
+                __android_log_print(ANDROID_LOG_WARN, TAG, "setpriority(%d) for %s thread: %s",
+                                    policy.nice, roleName(role), strerror(errno));
+            }
+        } else if (s.appliedNice != 0) {
+            // Undo only what this manager set
+            if (setpriority(PRIO_PROCESS, static_cast<id_t>(s.tid), 0) == 0) {
+                s.appliedNice = 0;
+            }
+        }
+    }
+    s.applied = applied;
+
+    if (policy.cpuMask != 0) {
+        const uint64_t mask = policy.cpuMask & allCpusMask();
+        if (mask != 0 && setAffinity(s.tid, mask)) {
+            s.appliedMask = mask;
+        } else {
+            __android_log_print(ANDROID_LOG_WARN, TAG,
+                                "Cannot pin %s thread to 0x%" PRIx64 ": %s", roleName(role),
+                                policy.cpuMask, mask ? strerror(errno) : "no such CPU");
+        }
+    } else if (s.appliedMask != 0) {
+        if (setAffinity(s.tid, allCpusMask())) {
+            s.appliedMask = 0;
+        }
+    }
+
+    __android_log_print(ANDROID_LOG_DEBUG, TAG, "%s thread %d: %s nice=%d cpus=0x%" PRIx64,
+                        roleName(role), s.tid,
+                        applied == ThreadSched::FIFO ? "fifo" :
+                        applied == ThreadSched::NICE ? "nice" : "default",
+                        s.appliedNice, s.appliedMask);
+}
+
+void ThreadManager::recordWakeLatency(ThreadRole role, int64_t micros) {
+    if (role >= ThreadRole::COUNT) {
+        return;
+    }
+    Slot& s = slot(role);
+    const uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+    size_t bucket = 0;
+    while (bucket < kWakeLatencyLimitsUs.size() && value > kWakeLatencyLimitsUs[bucket]) {
+        ++bucket;
+    }
+    s.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    s.samples.fetch_add(1, std::memory_order_relaxed);
+    s.totalMicros.fetch_add(value, std::memory_order_relaxed);
+    if (value > kWakeLatencyBudgetUs) {
+        s.overBudget.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Single writer per role: no compare-exchange needed
+    if (value > s.maxMicros.load(std::memory_order_relaxed)) {
+        s.maxMicros.store(value, std::memory_order_relaxed);
+    }
+}
+
+size_t ThreadManager::getThreadInfo(ThreadInfo* out, size_t maxEntries) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (size_t i = 0; i < kThreadRoleCount && count < maxEntries; ++i) {
+        const Slot& s = slots_[i];
+        ThreadInfo& info = out[count++];
+        info.role = static_cast<ThreadRole>(i);
+        info.tid = s.tid;
+        info.applied = s.applied;
+        info.nice = s.appliedNice;
+        info.fifoPriority = s.applied == ThreadSched::FIFO ? s.policy.fifoPriority : 0;
+        info.cpuMask = s.appliedMask;
+        info.wakeSamples = s.samples.load(std::memory_order_relaxed);
+        info.overBudget = s.overBudget.load(std::memory_order_relaxed);
+        info.maxMicros = s.maxMicros.load(std::memory_order_relaxed);
+        info.totalMicros = s.totalMicros.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < kWakeLatencyBuckets; ++b) {
+            info.histogram[b] = s.histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+uint64_t ThreadManager::performanceCoreMask() {
+    // cpu_capacity where the kernel exports it (arm64 EAS), else max frequency
+    std::array<uint64_t, kMaxManagedCpus> rating{};
+    const int cpus = configuredCpus();
+    uint64_t lowest = 0;
+    char path[96];
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpu_capacity", cpu);
+        uint64_t value = readSysfsValue(path);
+        if (value == 0) {
+            snprintf(path, sizeof(path),
+                     "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+            value = readSysfsValue(path);
+        }
+        rating[cpu] = value;
+        if (value != 0 && (lowest == 0 || value < lowest)) {
+            lowest = value;
+        }
+    }
+    if (lowest == 0) {
+        return 0;
+    }
+
+    uint64_t fast = 0;
+    uint64_t known = 0;
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        if (rating[cpu] != 0) {
+            known |= uint64_t{1} << cpu;
+        }
+        if (rating[cpu] > lowest) {
+            fast |= uint64_t{1} << cpu;
+        }
+    }
+    return fast != 0 ? fast : known;
+}
+
+ThreadScope::ThreadScope(ThreadManager* manager, ThreadRole role, const char* name)
+    : manager_(manager), role_(role) {
+    if (manager_) {
+        manager_->enterThread(role_, name);
+    } else {
+        pthread_setname_np(pthread_self(), name);
+    }
+}
+
+ThreadScope::~ThreadScope() {
+    if (manager_) {
+        manager_->leaveThread(role_);
+    }
+}
+
+void ThreadScope::sleepFor(uint32_t ms) {
+    if (!manager_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        return;
+    }
+    const int64_t due = traceClockMicros() + static_cast<int64_t>(ms) * 1000;
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    manager_->recordWakeLatency(role_, traceClockMicros() - due);
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,170 @@
+/*
+ * Mesh Rider Wave - Native Worker Thread Manager
+ * Names, priorities, CPU affinity and wakeup latency of the pipeline threads
+ *
+ * Every worker the pipeline owns (receive loop, encoder, decoder, recorder
+ * I/O) registers on entry. Its role's policy is applied then, and again
+ * whenever the policy changes while it runs:
+ * - FIFO: SCHED_FIFO where the process may (RLIMIT_RTPRIO, system builds),
+ *   otherwise the policy's nice value
+ * - NICE: setpriority() on the thread; -16 is ANDROID_PRIORITY_AUDIO
+ * - cpuMask: sched_setaffinity() (0 leaves the thread on every core).
+ *   performanceCoreMask() picks the cores above the little cluster.
+ * Oboe's callback threads belong to AAudio and are not managed here.
+ *
+ * Wakeup latency is measured where a thread knows when it should have run:
+ * the receive loop against the kernel receive stamp of the first datagram
+ * in each batch (SO_TIMESTAMPNS), the encoder and decoder against the end
+ * of their poll sleeps. Samples go to a per-role histogram; over
+ * kWakeLatencyBudgetUs counts separately.
+ */
+
+#ifndef MESHRIDER_PTT_THREAD_MANAGER_H
+#define MESHRIDER_PTT_THREAD_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace meshrider {
+namespace ptt {
+
+enum class ThreadRole : uint8_t {
+    NETWORK,        // RtpPacketizer receive loop
+    ENCODER,        // AudioEngine capture ring -> Opus -> send
+    DECODER,        // AudioEngine jitter buffers -> mix -> playback ring
+    RECORDER,       // VoiceRecorder file I/O
+    COUNT
+};
+
+constexpr size_t kThreadRoleCount = static_cast<size_t>(ThreadRole::COUNT);
+
+enum class ThreadSched : uint8_t {
+    DEFAULT,        // Leave as created (nice 0, SCHED_OTHER)
+    NICE,
+    FIFO            // Falls back to NICE when refused
+};
+
+// Android's THREAD_PRIORITY_* values
+constexpr int kAudioNice = -16;
+constexpr int kUrgentAudioNice = -19;
+constexpr int kBackgroundNice = 10;
+
+// Below AAudio's callback threads, which run SCHED_FIFO themselves
+constexpr int kDefaultFifoPriority = 1;
+
+// Wakeup-to-process target
+constexpr uint32_t kWakeLatencyBudgetUs = 1000;
+
+// Histogram bucket upper bounds; the last bucket is everything above
+constexpr std::array<uint32_t, 6> kWakeLatencyLimitsUs = {100, 250, 500, 1000, 2000, 5000};
+constexpr size_t kWakeLatencyBuckets = kWakeLatencyLimitsUs.size() + 1;
+
+struct ThreadPolicy {
+    ThreadSched sched = ThreadSched::NICE;
+    int nice = kAudioNice;
+    int fifoPriority = kDefaultFifoPriority;
+    uint64_t cpuMask = 0;               // Bit n: CPU n; 0 = no pinning
+};
+
+// Receive loop tries SCHED_FIFO; codecs run at audio priority; file I/O in the background
+ThreadPolicy defaultThreadPolicy(ThreadRole role);
+
+struct ThreadInfo {
+    ThreadRole role;
+    int32_t tid;                        // 0 while not running
+    ThreadSched applied;                // What the kernel accepted
+    int32_t nice;
+    int32_t fifoPriority;
+    uint64_t cpuMask;                   // Pinned to, 0 = not pinned
+    uint64_t wakeSamples;
+    uint64_t overBudget;                // Above kWakeLatencyBudgetUs
+    uint64_t maxMicros;
+    uint64_t totalMicros;
+    std::array<uint64_t, kWakeLatencyBuckets> histogram;
+};
+
+/**
+ * Policies and wakeup latency for every worker role (THREAD-SAFE)
+ *
+ * Policies outlive the threads: a role restarted (packetizer rebuild,
+ * next capture) gets its policy again on entry. recordWakeLatency() is
+ * lock-free and called only by the role's own thread.
+ */
+class ThreadManager {
+public:
+    ThreadManager();
+
+    ThreadManager(const ThreadManager&) = delete;
+    ThreadManager& operator=(const ThreadManager&) = delete;
+
+    // Applies to the running thread at once, else on its next entry
+    void setPolicy(ThreadRole role, const ThreadPolicy& policy);
+    ThreadPolicy getPolicy(ThreadRole role) const;
+
+    // Calling thread: name it, register it under role, apply the policy
+    void enterThread(ThreadRole role, const char* name);
+    void leaveThread(ThreadRole role);
+
+    void recordWakeLatency(ThreadRole role, int64_t micros);
+
+    // All roles; returns the number written
+    size_t getThreadInfo(ThreadInfo* out, size_t maxEntries) const;
+
+    // Cores faster than the slowest cluster (all cores on a uniform SoC,
+    // 0 if sysfs is unreadable)
+    static uint64_t performanceCoreMask();
+
+private:
+    struct Slot {
+        ThreadPolicy policy;
+        int32_t tid = 0;
+        ThreadSched applied = ThreadSched::DEFAULT;
+        int32_t appliedNice = 0;
+        uint64_t appliedMask = 0;
+        bool fifoRefusedLogged = false;
+
+        // Written by the role's thread only
+        std::atomic<uint64_t> samples{0};
+        std::atomic<uint64_t> overBudget{0};
+        std::atomic<uint64_t> maxMicros{0};
+        std::atomic<uint64_t> totalMicros{0};
+        std::array<std::atomic<uint64_t>, kWakeLatencyBuckets> histogram{};
+    };
+
+    void applyLocked(ThreadRole role, Slot& slot);
+
+    Slot& slot(ThreadRole role) { return slots_[static_cast<size_t>(role)]; }
+    const Slot& slot(ThreadRole role) const { return slots_[static_cast<size_t>(role)]; }
+
+    mutable std::mutex mutex_;
+    std::array<Slot, kThreadRoleCount> slots_;
+};
+
+/**
+ * Registration for the lifetime of a worker loop
+ *
+ * Without a manager (host tools) the thread is still named. sleepFor()
+ * replaces a poll sleep and records how late the thread woke.
+ */
+class ThreadScope {
+public:
+    ThreadScope(ThreadManager* manager, ThreadRole role, const char* name);
+    ~ThreadScope();
+
+    ThreadScope(const ThreadScope&) = delete;
+    ThreadScope& operator=(const ThreadScope&) = delete;
+
+    void sleepFor(uint32_t ms);
+
+private:
+    ThreadManager* manager_;
+    ThreadRole role_;
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_THREAD_MANAGER_H
@@ -0,0 +1,126 @@
+/*
+ * Mesh Rider Wave - Voice Activity Detection and Transmit Gate Implementation
+ */
+
+#include "VoiceActivity.h"
+#include <algorithm>
+#include <cmath>
+
+namespace meshrider {
+namespace ptt {
+
+namespace {
+
+// Cap on the silence counter (well past any hangover)
+constexpr uint32_t kMaxSilenceMs = 1u << 30;
+
+} // namespace
+
+// ============================================================================
+// VoiceActivityDetector
+// ============================================================================
+
+bool VoiceActivityDetector::process(const int16_t* pcm, size_t samples,
+                                    uint32_t frameDurationMs, float thresholdDb) {
+    if (samples == 0) {
+        return false;
+    }
+
+    int64_t sumSquares = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        sumSquares += static_cast<int32_t>(pcm[i]) * pcm[i];
+    }
+    const double meanSquare = static_cast<double>(sumSquares) / static_cast<double>(samples);
+    const float levelDb = static_cast<float>(
+        10.0 * std::log10(meanSquare / (32768.0 * 32768.0) + 1e-10));
+    lastLevelDb_ = levelDb;
+
+    // Judge against the floor as it was before this frame
+    const bool speech = levelDb > kVadAbsoluteFloorDb &&
+                        levelDb > noiseFloorDb_ + thresholdDb;
+
+    if (levelDb < noiseFloorDb_) {
+        noiseFloorDb_ += (levelDb - noiseFloorDb_) * kVadFloorFallCoefficient;
+    } else {
+        noiseFloorDb_ = std::min(levelDb,
+            noiseFloorDb_ + kVadFloorRiseDbPerSecond * frameDurationMs / 1000.0f);
+    }
+    return speech;
+}
+
+// ============================================================================
+// TransmitGate
+// ============================================================================
+
+TransmitGate::TransmitGate() = default;
+
+void TransmitGate::configure(const DtxConfig& config) {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    pendingConfig_ = config;
+    configChanged_.store(true, std::memory_order_release);
+}
+
+DtxConfig TransmitGate::getConfig() const {
+    std::lock_guard<std::mutex> lock(configMutex_);
+    return pendingConfig_;
+}
+
+void TransmitGate::reset() {
+    talking_ = false;
+    gapPending_ = true;
+    silenceMs_ = 0;
+    sinceComfortMs_ = 0;
+}
+
+TransmitDecision TransmitGate::onFrame(const int16_t* pcm, size_t samples, int encodedBytes,
+                                       uint32_t frameDurationMs) {
+    if (configChanged_.exchange(false, std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        config_ = pendingConfig_;
+    }
+
+    // Always run the VAD so the noise floor keeps tracking while disabled
+    const bool speech = vad_.process(pcm, samples, frameDurationMs, config_.thresholdDb);
+
+    TransmitDecision decision;
+    if (!config_.enabled) {
+        decision.marker = gapPending_;
+        gapPending_ = false;
+        talking_ = true;
+        return decision;
+    }
+
+    // Opus itself found nothing worth coding: silence regardless of energy
+    const bool opusDtx = encodedBytes <= kOpusDtxFrameMaxBytes;
+    if (speech && !opusDtx) {
+        silenceMs_ = 0;
+    } else {
+        silenceMs_ = std::min(silenceMs_ + frameDurationMs, kMaxSilenceMs);
+    }
+
+    // A press always opens with hangoverMs on the air (silenceMs_ starts at 0)
+    talking_ = !opusDtx && silenceMs_ <= config_.hangoverMs;
+    if (talking_) {
+        decision.marker = gapPending_;
+        gapPending_ = false;
+        sinceComfortMs_ = 0;
+        return decision;
+    }
+
+    sinceComfortMs_ += frameDurationMs;
+    if (config_.comfortNoiseIntervalMs > 0 &&
+        sinceComfortMs_ >= config_.comfortNoiseIntervalMs) {
+        sinceComfortMs_ = 0;
+        decision.comfortNoise = true;
+        decision.marker = gapPending_;
+        gapPending_ = false;
+        return decision;
+    }
+
+    decision.send = false;
+    gapPending_ = true;
+    return decision;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,129 @@
+/*
+ * Mesh Rider Wave - Voice Activity Detection and Transmit Gate
+ * Keeps silence off the shared mesh channel
+ *
+ * Opus DTX (enabled in OpusEncoder::initialize) already shrinks silent
+ * frames to 1-2 bytes, but every one of them still costs an RTP/UDP/IP
+ * packet and a channel access. The gate decides per encoded frame whether
+ * it goes on the air:
+ *
+ * - Speech (energy VAD) is sent, plus kDefaultDtxHangoverMs after it ends so
+ *   word tails and short pauses are not clipped.
+ * - Silence past the hangover is suppressed. Opus DTX frames (<= 2 bytes) are
+ *   always silence. Optionally one comfort-noise frame goes out every
+ *   comfortNoiseIntervalMs so listeners hear the talker's background.
+ * - The first packet after suppressed frames carries the RTP marker bit
+ *   (RFC 3551 talkspurt start). Suppressed frames still advance the RTP
+ *   timestamp, so the receiver sees a timestamp jump with contiguous
+ *   sequence numbers: a gap, not loss.
+ *
+ * The VAD is a frame-energy detector against a tracked noise floor (fast
+ * fall, slow rise), cheap enough for the encoder thread at any frame size.
+ */
+
+#ifndef MESHRIDER_PTT_VOICE_ACTIVITY_H
+#define MESHRIDER_PTT_VOICE_ACTIVITY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace meshrider {
+namespace ptt {
+
+// Opus DTX output for a frame with nothing new to say (TOC byte, maybe + 1)
+constexpr int kOpusDtxFrameMaxBytes = 2;
+
+// Keep transmitting this long after the last speech frame
+constexpr uint32_t kDefaultDtxHangoverMs = 240;
+
+// Speech when frame energy exceeds the noise floor by this much
+constexpr float kDefaultVadThresholdDb = 9.0f;
+
+// Frames quieter than this are silence whatever the floor (dBFS)
+constexpr float kVadAbsoluteFloorDb = -60.0f;
+
+// Noise floor tracking: starts low, rises slowly under sustained sound so
+// speech never becomes the floor, falls quickly in pauses
+constexpr float kVadInitialFloorDb = -60.0f;
+constexpr float kVadFloorRiseDbPerSecond = 3.0f;
+constexpr float kVadFloorFallCoefficient = 0.2f;
+
+/**
+ * Gate configuration (AudioEngine::setDtxConfig)
+ */
+struct DtxConfig {
+    bool enabled = true;                    // false = send every encoded frame
+    uint32_t hangoverMs = kDefaultDtxHangoverMs;
+    uint32_t comfortNoiseIntervalMs = 0;    // 0 = send nothing during silence
+    float thresholdDb = kDefaultVadThresholdDb;
+};
+
+/**
+ * What to do with one encoded frame
+ */
+struct TransmitDecision {
+    bool send = true;
+    bool marker = false;        // First packet after a gap (or of the press)
+    bool comfortNoise = false;  // Sent during silence to refresh background
+};
+
+/**
+ * Frame-energy voice activity detector (encoder thread only)
+ */
+class VoiceActivityDetector {
+public:
+    // True if the frame holds speech
+    bool process(const int16_t* pcm, size_t samples, uint32_t frameDurationMs,
+                 float thresholdDb);
+
+    float getNoiseFloorDb() const { return noiseFloorDb_; }
+    float getLastLevelDb() const { return lastLevelDb_; }
+
+private:
+    float noiseFloorDb_ = kVadInitialFloorDb;
+    float lastLevelDb_ = kVadAbsoluteFloorDb;
+};
+
+/**
+ * Per-frame send/suppress decision (DTX policy)
+ *
+ * onFrame() and reset() run on the encoder thread; configure() may be called
+ * from any thread and takes effect on the next frame.
+ */
+class TransmitGate {
+public:
+    TransmitGate();
+
+    void configure(const DtxConfig& config);
+    DtxConfig getConfig() const;
+
+    // New capture session: the next frame starts a talkspurt
+    void reset();
+
+    // Decide for one encoded frame of frameDurationMs
+    TransmitDecision onFrame(const int16_t* pcm, size_t samples, int encodedBytes,
+                             uint32_t frameDurationMs);
+
+    bool isTalking() const { return talking_; }
+    float getNoiseFloorDb() const { return vad_.getNoiseFloorDb(); }
+
+private:
+    mutable std::mutex configMutex_;
+    DtxConfig pendingConfig_;
+    std::atomic<bool> configChanged_{false};
+
+    // Encoder thread only
+    DtxConfig config_;
+    VoiceActivityDetector vad_;
+    bool talking_ = false;
+    bool gapPending_ = true;        // Frames were suppressed since the last send
+    uint32_t silenceMs_ = 0;        // Since the last speech frame
+    uint32_t sinceComfortMs_ = 0;   // Since the last frame sent during silence
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_VOICE_ACTIVITY_H
@@ -0,0 +1,714 @@
+/*
+ * Mesh Rider Wave - Per-Talker Voice Recorder Implementation
+ */
+
+#include "VoiceRecorder.h"
+#include "AudioFormat.h"
+#include "LatencyTracer.h"
+#include "ReceiveStreams.h"
+#include "PttLog.h"
+#include "opus.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TAG "MeshRider:PTT-Recorder"
+
+namespace meshrider {
+namespace ptt {
+
+static_assert(kMaxRecordingBursts >= 2 * kMaxReceiveStreams,
+              "Every talker needs a burst slot while the previous one closes");
+static_assert(kRecordingBlockBytes % kDirectIoAlignment == 0,
+              "Full blocks must stay O_DIRECT aligned");
+
+namespace {
+
+// Ogg Opus always counts granule positions at 48 kHz (RFC 7845 4)
+constexpr uint32_t kOggOpusRate = 48000;
+
+// libopus encoder lookahead at 48 kHz; the sender's setting is not on the wire
+constexpr uint16_t kOggOpusPreSkip = 312;
+
+constexpr uint8_t kOggBeginOfStream = 0x02;
+constexpr uint8_t kOggEndOfStream = 0x04;
+constexpr size_t kOggHeaderBytes = 27;
+
+// Index lines are batched like audio: written at this size or age
+constexpr size_t kIndexFlushBytes = 4096;
+constexpr int64_t kIndexFlushMs = 5000;
+
+constexpr char kIndexHeader[] =
+    "start_unix_ms,end_unix_ms,channel,ssrc,duration_ms,packets,concealed_frames,file\n";
+
+// Ogg CRC-32: polynomial 0x04C11DB7, not reflected, zero init and final
+constexpr std::array<uint32_t, 256> makeOggCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t r = i << 24;
+        for (int bit = 0; bit < 8; ++bit) {
+            r = (r & 0x80000000u) ? (r << 1) ^ 0x04C11DB7u : r << 1;
+        }
+        table[i] = r;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> kOggCrcTable = makeOggCrcTable();
+
+uint32_t oggCrc(uint32_t crc, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        crc = (crc << 8) ^ kOggCrcTable[((crc >> 24) ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+void putLe16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void putLe32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+void putLe64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+int64_t wallClockMillis() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+uint32_t rtpTicksToOpusSamples(uint32_t ticks) {
+    return static_cast<uint32_t>(uint64_t{ticks} * kOggOpusRate / PttAudioFormat::kRtpClockRate);
+}
+
+uint32_t opusSamplesToRtpTicks(uint32_t samples) {
+    return static_cast<uint32_t>(uint64_t{samples} * PttAudioFormat::kRtpClockRate / kOggOpusRate);
+}
+
+} // namespace
+
+VoiceRecorder::~VoiceRecorder() {
+    stop();
+}
+
+// ============================================================================
+// Start / stop
+// ============================================================================
+
+bool VoiceRecorder::start(const RecordingConfig& config) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    stopLocked();
+
+    const std::string indexPath = config.directory + "/index.csv";
+    const int indexFd = open(indexPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (indexFd < 0) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG, "Cannot open %s: %s",
+            indexPath.c_str(), strerror(errno));
+        return false;
+    }
+
+    void* blocks = nullptr;
+    if (posix_memalign(&blocks, kDirectIoAlignment, kRecordingBlocks * kRecordingBlockBytes) != 0) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG, "Recording block pool allocation failed");
+        close(indexFd);
+        return false;
+    }
+
+    struct stat st;
+    indexBuffer_.clear();
+    indexBuffer_.reserve(2 * kIndexFlushBytes);
+    if (fstat(indexFd, &st) == 0 && st.st_size == 0) {
+        indexBuffer_ = kIndexHeader;
+    }
+    indexFd_ = indexFd;
+    indexDueMicros_ = 0;
+    for (BurstFile& file : files_) {
+        file = BurstFile{};
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+        config_.burstGapMs = std::max(config.burstGapMs, kMinBurstGapMs);
+        burstGapMicros_ = static_cast<int64_t>(config_.burstGapMs) * 1000;
+        blocks_ = static_cast<uint8_t*>(blocks);
+        for (size_t i = 0; i < kRecordingBlocks; ++i) {
+            freeBlocks_[i] = static_cast<int>(i);
+        }
+        freeBlockCount_ = kRecordingBlocks;
+        for (size_t i = 0; i < kMaxRecordingBursts; ++i) {
+            bursts_[i].active = false;
+            bursts_[i].slot = static_cast<uint8_t>(i);
+        }
+        queueHead_ = 0;
+        queueCount_ = 0;
+        running_ = true;
+        stopping_ = false;
+        wakeIo_ = false;
+    }
+
+    ioThread_ = std::thread([this]() { ioLoop(); });
+    enabled_.store(true, std::memory_order_release);
+
+    __android_log_print(ANDROID_LOG_INFO, TAG,
+        "Recording to %s (burst gap %u ms, sync %d, %zu x %zu KiB blocks)",
+        config_.directory.c_str(), config_.burstGapMs, static_cast<int>(config_.sync),
+        kRecordingBlocks, kRecordingBlockBytes / 1024);
+    return true;
+}
+
+void VoiceRecorder::stop() {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    stopLocked();
+}
+
+void VoiceRecorder::stopLocked() {
+    if (!ioThread_.joinable()) {
+        return;
+    }
+    enabled_.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Burst& burst : bursts_) {
+            if (burst.active) {
+                closeBurstLocked(burst);
+            }
+        }
+        stopping_ = true;
+    }
+    ioCv_.notify_one();
+    ioThread_.join();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        free(blocks_);
+        blocks_ = nullptr;
+        freeBlockCount_ = 0;
+    }
+    __android_log_print(ANDROID_LOG_INFO, TAG, "Recording stopped");
+}
+
+RecordingStats VoiceRecorder::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// ============================================================================
+// Receive side
+// ============================================================================
+
+void VoiceRecorder::onPacket(const RtpPacketInfo& info, const uint8_t* payload, size_t length) {
+    if (!enabled_.load(std::memory_order_acquire)) {
+        return;
+    }
+    const int samples = length > 0 ? opus_packet_get_nb_samples(payload, static_cast<opus_int32>(length),
+                                                                static_cast<opus_int32>(kOggOpusRate))
+                                   : OPUS_INVALID_PACKET;
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || stopping_) {
+            return;
+        }
+        if (samples <= 0) {
+            stats_.droppedPackets++;
+            return;
+        }
+
+        const int64_t now = traceClockMicros();
+        Burst* burst = findOrOpenBurstLocked(info, now);
+        if (burst->broken) {
+            burst->lastMicros = now;
+            stats_.droppedPackets++;
+        } else {
+            // Arrival order: a RED copy or reordered packet behind what is
+            // stored is already there, or too late for the file's timeline
+            const int32_t ahead = static_cast<int32_t>(info.timestamp - burst->nextTimestamp);
+            if (ahead >= 0) {
+                if (burst->packets > 0 && ahead > 0) {
+                    // Lost or DTX-suppressed frames: TOC-only packets (no
+                    // frame data) keep the granule on the sender's clock
+                    const uint8_t toc = burst->lastToc;
+                    const int fillerSamples = opus_packet_get_nb_samples(&toc, 1, kOggOpusRate);
+                    const uint32_t gap = rtpTicksToOpusSamples(static_cast<uint32_t>(ahead));
+                    const uint32_t maxFrames = static_cast<uint32_t>(
+                        uint64_t{config_.burstGapMs} * kOggOpusRate / 1000 / std::max(fillerSamples, 1));
+                    const uint32_t frames = fillerSamples > 0
+                        ? std::min(gap / static_cast<uint32_t>(fillerSamples), maxFrames) : 0;
+                    for (uint32_t i = 0; i < frames && !burst->broken; ++i) {
+                        appendPacketLocked(*burst, &toc, 1, static_cast<uint32_t>(fillerSamples));
+                        burst->concealedFrames++;
+                        stats_.concealedFrames++;
+                    }
+                }
+                appendPacketLocked(*burst, payload, length, static_cast<uint32_t>(samples));
+                if (burst->broken) {
+                    stats_.droppedPackets++;
+                } else {
+                    burst->packets++;
+                    stats_.packets++;
+                }
+                burst->lastToc = static_cast<uint8_t>(payload[0] & 0xFC);    // Code 0: one frame
+                burst->nextTimestamp = info.timestamp + opusSamplesToRtpTicks(static_cast<uint32_t>(samples));
+            }
+            burst->lastMicros = now;
+        }
+        wake = wakeIo_;
+        wakeIo_ = false;
+    }
+    if (wake) {
+        ioCv_.notify_one();
+    }
+}
+
+VoiceRecorder::Burst* VoiceRecorder::findOrOpenBurstLocked(const RtpPacketInfo& info,
+                                                           int64_t nowMicros) {
+    Burst* freeSlot = nullptr;
+    Burst* oldest = nullptr;
+    for (Burst& burst : bursts_) {
+        if (!burst.active) {
+            if (!freeSlot) {
+                freeSlot = &burst;
+            }
+            continue;
+        }
+        if (burst.channel == info.channel && burst.ssrc == info.ssrc) {
+            if (nowMicros - burst.lastMicros < burstGapMicros_) {
+                return &burst;
+            }
+            // Silence the I/O thread has not timed out yet: a new burst
+            closeBurstLocked(burst);
+            if (!freeSlot) {
+                freeSlot = &burst;
+            }
+            continue;
+        }
+        if (!oldest || burst.lastMicros < oldest->lastMicros) {
+            oldest = &burst;
+        }
+    }
+    if (!freeSlot) {
+        closeBurstLocked(*oldest);
+        freeSlot = oldest;
+    }
+
+    Burst& burst = *freeSlot;
+    burst.active = true;
+    burst.broken = false;
+    burst.channel = info.channel;
+    burst.ssrc = info.ssrc;
+    burst.serial = info.ssrc ^ (nextSerial_++ * 0x9E3779B9u);
+    burst.startMicros = nowMicros;
+    burst.lastMicros = nowMicros;
+    burst.startWallMs = wallClockMillis();
+    burst.nextTimestamp = info.timestamp;
+    burst.granule = 0;
+    burst.pageSequence = 0;
+    burst.packets = 0;
+    burst.concealedFrames = 0;
+    burst.lastToc = 0;
+    burst.segmentCount = 0;
+    burst.bodyLength = 0;
+    burst.pageSamples = 0;
+    burst.block = -1;
+    burst.blockFill = 0;
+    burst.opened = false;
+    stats_.bursts++;
+
+    // RFC 7845 5.1: identification header, alone on the first page
+    uint8_t head[19];
+    std::memcpy(head, "OpusHead", 8);
+    head[8] = 1;                                    // Version
+    head[9] = static_cast<uint8_t>(PttAudioFormat::kChannels);
+    putLe16(head + 10, kOggOpusPreSkip);
+    putLe32(head + 12, PttAudioFormat::kSampleRate);
+    putLe16(head + 16, 0);                          // Output gain
+    head[18] = 0;                                   // Mapping family: mono/stereo
+    uint8_t headLacing = sizeof(head);
+    writePageLocked(burst, kOggBeginOfStream, 0, &headLacing, 1, head, sizeof(head));
+
+    // RFC 7845 5.2: comment header; the index has the rest
+    uint8_t tags[160];
+    static constexpr char kVendor[] = "MeshRider Wave";
+    size_t n = 0;
+    std::memcpy(tags, "OpusTags", 8);
+    n += 8;
+    putLe32(tags + n, sizeof(kVendor) - 1);
+    n += 4;
+    std::memcpy(tags + n, kVendor, sizeof(kVendor) - 1);
+    n += sizeof(kVendor) - 1;
+    putLe32(tags + n, 3);
+    n += 4;
+    const auto addComment = [&](const char* format, auto value) {
+        char comment[48];
+        const int len = snprintf(comment, sizeof(comment), format, value);
+        putLe32(tags + n, static_cast<uint32_t>(len));
+        n += 4;
+        std::memcpy(tags + n, comment, static_cast<size_t>(len));
+        n += static_cast<size_t>(len);
+    };
+    addComment("MESHRIDER_CHANNEL=%" PRIu32, burst.channel);
+    addComment("MESHRIDER_SSRC=%08" PRIx32, burst.ssrc);
+    addComment("MESHRIDER_START_UNIX_MS=%" PRId64, burst.startWallMs);
+    uint8_t tagsLacing = static_cast<uint8_t>(n);
+    writePageLocked(burst, 0, 0, &tagsLacing, 1, tags, n);
+
+    // The I/O thread times the burst out
+    wakeIo_ = true;
+    return &burst;
+}
+
+void VoiceRecorder::closeBurstLocked(Burst& burst) {
+    if (!burst.broken) {
+        flushPageLocked(burst, true);
+    }
+    if (burst.opened || burst.block >= 0) {
+        handOffBlockLocked(burst, true);
+    }
+    burst.active = false;
+}
+
+void VoiceRecorder::appendPacketLocked(Burst& burst, const uint8_t* data, size_t length,
+                                       uint32_t samples) {
+    const size_t segments = length / 255 + 1;
+    // Flushed lazily, so the page being built always has a packet for EOS
+    if (burst.segmentCount > 0 &&
+        (burst.segmentCount + segments > burst.lacing.size() ||
+         burst.bodyLength + length > burst.body.size() ||
+         burst.pageSamples >= kOggPageMs * (kOggOpusRate / 1000))) {
+        flushPageLocked(burst, false);
+    }
+    if (burst.broken || length > burst.body.size()) {
+        return;
+    }
+
+    for (size_t i = 0; i + 1 < segments; ++i) {
+        burst.lacing[burst.segmentCount++] = 255;
+    }
+    burst.lacing[burst.segmentCount++] = static_cast<uint8_t>(length % 255);
+    std::memcpy(burst.body.data() + burst.bodyLength, data, length);
+    burst.bodyLength += length;
+    burst.pageSamples += samples;
+    burst.granule += samples;
+}
+
+void VoiceRecorder::flushPageLocked(Burst& burst, bool endOfStream) {
+    if (burst.segmentCount == 0 && !endOfStream) {
+        return;
+    }
+    writePageLocked(burst, endOfStream ? kOggEndOfStream : 0, burst.granule,
+                    burst.lacing.data(), burst.segmentCount, burst.body.data(), burst.bodyLength);
+    burst.segmentCount = 0;
+    burst.bodyLength = 0;
+    burst.pageSamples = 0;
+}
+
+void VoiceRecorder::writePageLocked(Burst& burst, uint8_t flags, uint64_t granule,
+                                    const uint8_t* lacing, size_t segments,
+                                    const uint8_t* body, size_t bodyLength) {
+    uint8_t header[kOggHeaderBytes];
+    std::memcpy(header, "OggS", 4);
+    header[4] = 0;                                  // Version
+    header[5] = flags;
+    putLe64(header + 6, granule);
+    putLe32(header + 14, burst.serial);
+    putLe32(header + 18, burst.pageSequence++);
+    putLe32(header + 22, 0);                        // CRC, computed with this zeroed
+    header[26] = static_cast<uint8_t>(segments);
+
+    uint32_t crc = oggCrc(0, header, sizeof(header));
+    crc = oggCrc(crc, lacing, segments);
+    crc = oggCrc(crc, body, bodyLength);
+    putLe32(header + 22, crc);
+
+    emitLocked(burst, header, sizeof(header));
+    emitLocked(burst, lacing, segments);
+    emitLocked(burst, body, bodyLength);
+}
+
+void VoiceRecorder::emitLocked(Burst& burst, const uint8_t* data, size_t length) {
+    while (length > 0 && !burst.broken) {
+        if (burst.block < 0) {
+            if (freeBlockCount_ == 0) {
+                // I/O thread is behind (slow storage): keep what is queued,
+                // drop the rest of this burst rather than block the receive thread
+                burst.broken = true;
+                __android_log_print(ANDROID_LOG_WARN, TAG,
+                    "Recording blocks exhausted; SSRC 0x%08x burst truncated", burst.ssrc);
+                return;
+            }
+            burst.block = freeBlocks_[--freeBlockCount_];
+            burst.blockFill = 0;
+        }
+        const size_t chunk = std::min(length, kRecordingBlockBytes - burst.blockFill);
+        std::memcpy(blockData(burst.block) + burst.blockFill, data, chunk);
+        burst.blockFill += chunk;
+        data += chunk;
+        length -= chunk;
+        if (burst.blockFill == kRecordingBlockBytes) {
+            handOffBlockLocked(burst, false);
+        }
+    }
+}
+
+void VoiceRecorder::handOffBlockLocked(Burst& burst, bool close) {
+    PendingWrite write;
+    write.block = burst.block;
+    write.length = burst.block >= 0 ? burst.blockFill : 0;
+    write.slot = burst.slot;
+    write.open = !burst.opened;
+    write.close = close;
+    write.channel = burst.channel;
+    write.ssrc = burst.ssrc;
+    write.startWallMs = burst.startWallMs;
+    write.endWallMs = burst.startWallMs + (burst.lastMicros - burst.startMicros) / 1000;
+    write.durationMs = burst.granule / (kOggOpusRate / 1000);
+    write.packets = burst.packets;
+    write.concealedFrames = burst.concealedFrames;
+
+    if (!queueLocked(write)) {
+        // Unreachable by sizing: every queued write owns a block or closes a burst
+        if (burst.block >= 0) {
+            freeBlocks_[freeBlockCount_++] = burst.block;
+        }
+        stats_.writeErrors++;
+    }
+    burst.opened = true;
+    burst.block = -1;
+    burst.blockFill = 0;
+    wakeIo_ = true;
+}
+
+bool VoiceRecorder::queueLocked(const PendingWrite& write) {
+    if (queueCount_ == queue_.size()) {
+        return false;
+    }
+    queue_[(queueHead_ + queueCount_) % queue_.size()] = write;
+    queueCount_++;
+    return true;
+}
+
+// ============================================================================
+// I/O thread
+// ============================================================================
+
+void VoiceRecorder::ioLoop() {
+    ThreadScope threadScope(threadManager_, ThreadRole::RECORDER, "ptt-recorder");
+
+    std::array<PendingWrite, kQueueCapacity> batch;
+    for (;;) {
+        size_t count = 0;
+        bool exiting = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                const int64_t now = traceClockMicros();
+                int64_t deadline = indexDueMicros_;
+                for (Burst& burst : bursts_) {
+                    if (!burst.active) {
+                        continue;
+                    }
+                    const int64_t due = burst.lastMicros + burstGapMicros_;
+                    if (now >= due) {
+                        closeBurstLocked(burst);
+                    } else if (deadline == 0 || due < deadline) {
+                        deadline = due;
+                    }
+                }
+                wakeIo_ = false;
+                if (queueCount_ > 0 || stopping_ || (indexDueMicros_ != 0 && now >= indexDueMicros_)) {
+                    break;
+                }
+                // Nothing open and nothing buffered: sleep until the next burst
+                if (deadline == 0) {
+                    ioCv_.wait(lock);
+                } else {
+                    ioCv_.wait_for(lock, std::chrono::microseconds(deadline - now));
+                }
+            }
+            while (queueCount_ > 0) {
+                batch[count++] = queue_[queueHead_];
+                queueHead_ = (queueHead_ + 1) % queue_.size();
+                queueCount_--;
+            }
+            exiting = stopping_;
+        }
+
+        IoTally tally;
+        for (size_t i = 0; i < count; ++i) {
+            performWrite(batch[i], tally);
+        }
+        if (exiting || indexBuffer_.size() >= kIndexFlushBytes ||
+            (indexDueMicros_ != 0 && traceClockMicros() >= indexDueMicros_)) {
+            flushIndex(tally);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < count; ++i) {
+                if (batch[i].block >= 0) {
+                    freeBlocks_[freeBlockCount_++] = batch[i].block;
+                }
+            }
+            stats_.bytesWritten += tally.bytes;
+            stats_.writes += tally.writes;
+            stats_.writeErrors += tally.errors;
+        }
+        if (exiting) {
+            break;
+        }
+    }
+
+    for (BurstFile& file : files_) {
+        if (file.fd >= 0) {
+            close(file.fd);
+            file.fd = -1;
+        }
+    }
+    if (indexFd_ >= 0) {
+        close(indexFd_);
+        indexFd_ = -1;
+    }
+}
+
+void VoiceRecorder::performWrite(const PendingWrite& write, IoTally& tally) {
+    BurstFile& file = files_[write.slot];
+    if (write.open) {
+        openBurstFile(write, tally);
+    }
+
+    if (write.block >= 0 && write.length > 0 && file.fd >= 0) {
+        uint8_t* data = blockData(write.block);
+        size_t length = write.length;
+        if (file.direct && length % kDirectIoAlignment != 0) {
+            // Tail of the burst: O_DIRECT needs whole sectors, trimmed below
+            const size_t padded = (length + kDirectIoAlignment - 1) / kDirectIoAlignment * kDirectIoAlignment;
+            std::memset(data + length, 0, padded - length);
+            length = padded;
+        }
+        if (writeAll(file.fd, data, length, file.offset, true, tally)) {
+            file.offset += write.length;
+            if (length != write.length && ftruncate(file.fd, static_cast<off_t>(file.offset)) != 0) {
+                tally.errors++;
+            }
+        } else {
+            __android_log_print(ANDROID_LOG_ERROR, TAG, "Write to %s failed: %s",
+                file.name.c_str(), strerror(errno));
+        }
+    }
+
+    if (write.close) {
+        if (file.fd >= 0) {
+            if (config_.sync != RecordingSync::NONE) {
+                fdatasync(file.fd);
+            }
+            close(file.fd);
+            file.fd = -1;
+        }
+        appendIndex(write, traceClockMicros());
+    }
+}
+
+void VoiceRecorder::openBurstFile(const PendingWrite& write, IoTally& tally) {
+    BurstFile& file = files_[write.slot];
+    if (file.fd >= 0) {
+        close(file.fd);     // Previous burst's close was never queued
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "ch%" PRIu32 "_%08" PRIx32 "_%" PRId64 ".opus",
+             write.channel, write.ssrc, write.startWallMs);
+    file.name = name;
+    file.offset = 0;
+    const std::string path = config_.directory + "/" + file.name;
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    file.direct = config_.sync == RecordingSync::DIRECT;
+    if (file.direct) {
+        flags |= O_DIRECT;
+    }
+    file.fd = open(path.c_str(), flags, 0644);
+    if (file.fd < 0 && file.direct && errno == EINVAL) {
+        // tmpfs and some FUSE mounts refuse O_DIRECT
+        __android_log_print(ANDROID_LOG_WARN, TAG, "O_DIRECT refused in %s; syncing only",
+            config_.directory.c_str());
+        file.direct = false;
+        file.fd = open(path.c_str(), flags & ~O_DIRECT, 0644);
+    }
+    if (file.fd < 0) {
+        __android_log_print(ANDROID_LOG_ERROR, TAG, "Cannot create %s: %s",
+            path.c_str(), strerror(errno));
+        tally.errors++;
+    }
+}
+
+void VoiceRecorder::appendIndex(const PendingWrite& write, int64_t nowMicros) {
+    const BurstFile& file = files_[write.slot];
+    char line[192];
+    const int len = snprintf(line, sizeof(line),
+        "%" PRId64 ",%" PRId64 ",%" PRIu32 ",%08" PRIx32 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%s\n",
+        write.startWallMs, write.endWallMs, write.channel, write.ssrc,
+        write.durationMs, write.packets, write.concealedFrames, file.name.c_str());
+    if (len > 0) {
+        indexBuffer_.append(line, std::min(static_cast<size_t>(len), sizeof(line) - 1));
+        if (indexDueMicros_ == 0) {
+            indexDueMicros_ = nowMicros + kIndexFlushMs * 1000;
+        }
+    }
+}
+
+void VoiceRecorder::flushIndex(IoTally& tally) {
+    if (!indexBuffer_.empty() && indexFd_ >= 0) {
+        const auto* data = reinterpret_cast<const uint8_t*>(indexBuffer_.data());
+        if (writeAll(indexFd_, data, indexBuffer_.size(), 0, false, tally) &&
+            config_.sync != RecordingSync::NONE) {
+            fdatasync(indexFd_);
+        }
+    }
+    indexBuffer_.clear();
+    indexDueMicros_ = 0;
+}
+
+bool VoiceRecorder::writeAll(int fd, const uint8_t* data, size_t length, uint64_t offset,
+                             bool positioned, IoTally& tally) {
+    while (length > 0) {
+        const ssize_t n = positioned
+            ? pwrite(fd, data, length, static_cast<off_t>(offset))
+            : write(fd, data, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        tally.writes++;
+        if (n <= 0) {
+            tally.errors++;
+            return false;
+        }
+        tally.bytes += static_cast<uint64_t>(n);
+        data += n;
+        offset += static_cast<uint64_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace ptt
+} // namespace meshrider
@@ -0,0 +1,237 @@
+/*
+ * Mesh Rider Wave - Per-Talker Voice Recorder
+ * Received Opus packets written as-is to one Ogg/Opus file per talker burst
+ *
+ * The tap sits after (channel, SSRC) demux, so each file holds one talker
+ * on one talkgroup - what after-action review replays. Nothing is decoded
+ * or re-encoded: the packet that arrived is the packet stored.
+ * - A burst opens on a talker's first packet and closes after burstGapMs
+ *   without one. Lost and DTX-suppressed frames inside a burst become
+ *   1-byte (TOC only) Opus packets, so granule positions stay on the
+ *   sender's timeline and players conceal across the gap.
+ * - Pages carry up to kOggPageMs of audio; page bytes fill fixed blocks of
+ *   kRecordingBlockBytes from a preallocated pool. Only full blocks (and a
+ *   burst's tail) are handed to the I/O thread, so 8 scanned channels cost
+ *   one memcpy per packet and a few large writes per minute.
+ * - The I/O thread appends one CSV line per burst to index.csv (start/end
+ *   wall time, channel, SSRC, duration, file), flushed in blocks as well.
+ *
+ * Sync policy: NONE leaves write-back to the kernel; FDATASYNC syncs each
+ * file as its burst closes; DIRECT writes blocks with O_DIRECT (bypassing
+ * the page cache) plus the same sync, falling back to FDATASYNC where the
+ * filesystem refuses O_DIRECT.
+ */
+
+#ifndef MESHRIDER_PTT_VOICE_RECORDER_H
+#define MESHRIDER_PTT_VOICE_RECORDER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "RtpPacketizer.h"
+#include "ThreadManager.h"
+
+namespace meshrider {
+namespace ptt {
+
+// Write unit; a multiple of the O_DIRECT alignment
+constexpr size_t kRecordingBlockBytes = 64 * 1024;
+constexpr size_t kDirectIoAlignment = 4096;
+
+// 2 MiB: ~10 minutes of 24 kbps audio queued before packets are dropped
+constexpr size_t kRecordingBlocks = 32;
+
+// Bursts open at once: twice kMaxReceiveStreams (talkers plus ones closing)
+constexpr size_t kMaxRecordingBursts = 16;
+
+// Audio per Ogg page; also the most a crash can lose from a page in flight
+constexpr uint32_t kOggPageMs = 1000;
+
+// Staged page body (a page is emitted early when the next packet won't fit)
+constexpr size_t kOggPageBodyBytes = 8192;
+
+constexpr uint32_t kDefaultBurstGapMs = 1500;
+constexpr uint32_t kMinBurstGapMs = 200;
+
+enum class RecordingSync : uint8_t {
+    NONE,
+    FDATASYNC,
+    DIRECT
+};
+
+struct RecordingConfig {
+    std::string directory;              // Must exist and be writable
+    RecordingSync sync = RecordingSync::NONE;
+    uint32_t burstGapMs = kDefaultBurstGapMs;
+};
+
+struct RecordingStats {
+    uint64_t bursts = 0;                // Files opened
+    uint64_t packets = 0;               // Opus packets stored
+    uint64_t concealedFrames = 0;       // TOC-only packets standing in for gaps
+    uint64_t droppedPackets = 0;        // Block pool exhausted, or not Opus
+    uint64_t bytesWritten = 0;
+    uint64_t writes = 0;                // write() calls, files and index
+    uint64_t writeErrors = 0;
+};
+
+/**
+ * Receive-path recorder (THREAD-SAFE)
+ *
+ * onPacket() runs on the receive thread: one short lock, no allocation, no
+ * system call except to wake the I/O thread when a block fills or a burst
+ * opens. Costs one atomic load while stopped.
+ */
+class VoiceRecorder {
+public:
+    VoiceRecorder() = default;
+    ~VoiceRecorder();
+
+    VoiceRecorder(const VoiceRecorder&) = delete;
+    VoiceRecorder& operator=(const VoiceRecorder&) = delete;
+
+    // Opens index.csv in the directory and starts the I/O thread; a
+    // recording in progress is stopped first. False if the directory is
+    // not writable or the block pool cannot be allocated.
+    bool start(const RecordingConfig& config);
+
+    // Closes every burst and waits for the I/O thread to write them out
+    void stop();
+
+    bool isRecording() const { return enabled_.load(std::memory_order_acquire); }
+
+    // One received Opus payload (clear, after SRTP), in arrival order
+    void onPacket(const RtpPacketInfo& info, const uint8_t* payload, size_t length);
+
+    RecordingStats getStats() const;
+
+    // Policy source for the I/O thread; takes effect from the next start()
+    void setThreadManager(ThreadManager* manager) { threadManager_ = manager; }
+
+private:
+    struct Burst {
+        bool active = false;
+        bool broken = false;            // Lost a block; rest of the burst dropped
+        uint8_t slot = 0;
+        uint32_t channel = 0;
+        uint32_t ssrc = 0;
+        uint32_t serial = 0;            // Ogg stream serial number
+        int64_t startMicros = 0;
+        int64_t lastMicros = 0;
+        int64_t startWallMs = 0;
+        uint32_t nextTimestamp = 0;     // RTP timestamp just past the last packet
+        uint64_t granule = 0;           // 48 kHz samples stored
+        uint32_t pageSequence = 0;
+        uint64_t packets = 0;
+        uint64_t concealedFrames = 0;
+        uint8_t lastToc = 0;
+        uint32_t lastPacketSamples = 0; // 48 kHz
+
+        // Page being assembled
+        std::array<uint8_t, 255> lacing{};
+        size_t segmentCount = 0;
+        std::array<uint8_t, kOggPageBodyBytes> body{};
+        size_t bodyLength = 0;
+        uint32_t pageSamples = 0;
+
+        // Block being filled; -1 before the first page
+        int block = -1;
+        size_t blockFill = 0;
+        bool opened = false;            // I/O thread has been told to create the file
+    };
+
+    // One handoff to the I/O thread, in burst order per slot
+    struct PendingWrite {
+        int block = -1;                 // -1: close only (burst lost its blocks)
+        size_t length = 0;
+        uint8_t slot = 0;
+        bool open = false;              // First write of the burst: create the file
+        bool close = false;             // Last write of the burst: sync, close, index
+        uint32_t channel = 0;
+        uint32_t ssrc = 0;
+        int64_t startWallMs = 0;
+        int64_t endWallMs = 0;
+        uint64_t durationMs = 0;
+        uint64_t packets = 0;
+        uint64_t concealedFrames = 0;
+    };
+
+    // Receive side (mutex_ held)
+    Burst* findOrOpenBurstLocked(const RtpPacketInfo& info, int64_t nowMicros);
+    void closeBurstLocked(Burst& burst);
+    void appendPacketLocked(Burst& burst, const uint8_t* data, size_t length, uint32_t samples);
+    void flushPageLocked(Burst& burst, bool endOfStream);
+    void writePageLocked(Burst& burst, uint8_t flags, uint64_t granule,
+                         const uint8_t* lacing, size_t segments,
+                         const uint8_t* body, size_t bodyLength);
+    void emitLocked(Burst& burst, const uint8_t* data, size_t length);
+    void handOffBlockLocked(Burst& burst, bool close);
+    bool queueLocked(const PendingWrite& write);
+    uint8_t* blockData(int block) const { return blocks_ + static_cast<size_t>(block) * kRecordingBlockBytes; }
+
+    // I/O thread; results are folded into stats_ once per batch
+    struct IoTally {
+        uint64_t bytes = 0;
+        uint64_t writes = 0;
+        uint64_t errors = 0;
+    };
+    void ioLoop();
+    void performWrite(const PendingWrite& write, IoTally& tally);
+    void openBurstFile(const PendingWrite& write, IoTally& tally);
+    void appendIndex(const PendingWrite& write, int64_t nowMicros);
+    void flushIndex(IoTally& tally);
+    bool writeAll(int fd, const uint8_t* data, size_t length, uint64_t offset, bool positioned,
+                  IoTally& tally);
+
+    void stopLocked();
+
+    // Start/stop (serialized by controlMutex_)
+    std::mutex controlMutex_;
+    std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable ioCv_;
+    bool running_ = false;              // Guarded by mutex_
+    bool stopping_ = false;
+    bool wakeIo_ = false;               // Receive side queued work; notify after unlocking
+    RecordingConfig config_;
+    int64_t burstGapMicros_ = 0;
+
+    std::array<Burst, kMaxRecordingBursts> bursts_{};
+    uint32_t nextSerial_ = 1;
+
+    uint8_t* blocks_ = nullptr;         // kRecordingBlocks x kRecordingBlockBytes, aligned
+    std::array<int, kRecordingBlocks> freeBlocks_{};
+    size_t freeBlockCount_ = 0;
+
+    static constexpr size_t kQueueCapacity = kRecordingBlocks + kMaxRecordingBursts;
+    std::array<PendingWrite, kQueueCapacity> queue_{};
+    size_t queueHead_ = 0;
+    size_t queueCount_ = 0;
+
+    RecordingStats stats_{};
+
+    // I/O thread only
+    ThreadManager* threadManager_ = nullptr;
+    std::thread ioThread_;
+    struct BurstFile {
+        int fd = -1;
+        bool direct = false;
+        uint64_t offset = 0;
+        std::string name;
+    };
+    std::array<BurstFile, kMaxRecordingBursts> files_{};
+    int indexFd_ = -1;
+    std::string indexBuffer_;
+    int64_t indexDueMicros_ = 0;        // 0: nothing buffered
+};
+
+} // namespace ptt
+} // namespace meshrider
+
+#endif // MESHRIDER_PTT_VOICE_RECORDER_H
@@ -10,6 +10,7 @@
  * - Post-compromise security
  * - Up to 50,000 members per group
  * - Async member addition via KeyPackages
+ * - SRTP key export per epoch for native PTT voice protection
  */
 
 package com.doodlelabs.meshriderwave.core.crypto
@@ -60,6 +61,10 @@ class MLSGroupManager @Inject constructor(
         const val HANDSHAKE_KEY_SIZE = 32
         const val NONCE_SIZE = 12
 
+        // SRTP AEAD_AES_128_GCM master key + salt (RFC 7714 Section 12)
+        const val SRTP_MASTER_KEY_SIZE = 16
+        const val SRTP_MASTER_SALT_SIZE = 12
+
         // Label prefixes for key derivation (RFC 9420 Section 8)
         private val LABEL_MLS10 = "MLS 1.0 ".toByteArray(StandardCharsets.UTF_8)
         private val LABEL_EPOCH = "epoch".toByteArray(StandardCharsets.UTF_8)
@@ -67,6 +72,7 @@ class MLSGroupManager @Inject constructor(
         private val LABEL_HANDSHAKE = "handshake".toByteArray(StandardCharsets.UTF_8)
         private val LABEL_SENDER_DATA = "sender data".toByteArray(StandardCharsets.UTF_8)
         private val LABEL_ENCRYPTION = "encryption".toByteArray(StandardCharsets.UTF_8)
+        private val LABEL_EXPORTER_SRTP = "exporter srtp".toByteArray(StandardCharsets.UTF_8)
     }
 
     private val sodium = SodiumAndroid()
@@ -737,6 +743,38 @@ class MLSGroupManager @Inject constructor(
         }
     }
 
+    /**
+     * Export SRTP master key and salt for the group's current epoch
+     *
+     * Every member derives the same material from the epoch secret and it
+     * changes with each commit, so voice is rekeyed on every membership
+     * change. Hand it to PttAudioEngine.setSrtpKey() and wipe it after.
+     */
+    suspend fun exportSrtpKeys(groupId: ByteArray): Result<SrtpKeyMaterial> = mutex.withLock {
+        try {
+            val groupIdHex = groupId.toHexString()
+            val state = _groupStates.value[groupIdHex]
+                ?: return Result.failure(IllegalStateException("Not a member of group"))
+
+            val material = hkdfExpand(
+                state.epochSecret,
+                LABEL_EXPORTER_SRTP + buildEpochContext(groupId, state.epoch),
+                SRTP_MASTER_KEY_SIZE + SRTP_MASTER_SALT_SIZE
+            )
+            val keys = SrtpKeyMaterial(
+                epoch = state.epoch,
+                masterKey = material.copyOfRange(0, SRTP_MASTER_KEY_SIZE),
+                masterSalt = material.copyOfRange(SRTP_MASTER_KEY_SIZE, material.size)
+            )
+            Arrays.fill(material, 0.toByte())
+
+            Result.success(keys)
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to export SRTP keys", e)
+            Result.failure(e)
+        }
+    }
+
     // ========== Crypto Helpers ==========
 
     private fun generateHPKEKeyPair(): CryptoManager.KeyPair {
@@ -1112,6 +1150,32 @@ data class MLSGroupState(
     override fun hashCode(): Int = 31 * groupId.contentHashCode() + epoch.hashCode()
 }
 
+/**
+ * SRTP master key and salt exported from one MLS epoch
+ */
+data class SrtpKeyMaterial(
+    val epoch: Long,
+    val masterKey: ByteArray,
+    val masterSalt: ByteArray
+) {
+    fun wipe() {
+        Arrays.fill(masterKey, 0.toByte())
+        Arrays.fill(masterSalt, 0.toByte())
+    }
+
+    override fun equals(other: Any?): Boolean {
+        if (this === other) return true
+        if (other !is SrtpKeyMaterial) return false
+        return epoch == other.epoch && masterKey.contentEquals(other.masterKey) &&
+            masterSalt.contentEquals(other.masterSalt)
+    }
+
+    override fun hashCode(): Int = 31 * epoch.hashCode() + masterKey.contentHashCode()
+
+    // Never log key bytes
+    override fun toString(): String = "SrtpKeyMaterial(epoch=$epoch)"
+}
+
 /**
  * Ratchet tree for key management (TreeKEM)
  */
@@ -0,0 +1,34 @@
+/*
+ * Mesh Rider Wave - PTT Audio DSP Settings
+ * Native gain staging around the codec (AudioDsp.h)
+ *
+ * Capture: high-pass (handling noise, wind) -> AGC (quiet and loud talkers
+ * land at the same level) -> soft limiter, before the encoder sees the
+ * frame. Playback: limiter after the mix so overlapping channels do not
+ * clip. Gain and limiter activity show up in PttTelemetry.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttAudioDsp(
+    val highPass: Boolean = true,
+    val highPassHz: Float = 100f,
+    val agc: Boolean = true,
+    /** RMS level AGC steers active speech towards */
+    val agcTargetDbfs: Float = -18f,
+    /** Most AGC will boost a quiet talker */
+    val agcMaxGainDb: Float = 18f,
+    val limiter: Boolean = true,
+    /** Soft knee starts here; output never exceeds full scale */
+    val limiterThresholdDbfs: Float = -3f
+) {
+    /** Order mirrors the direction argument of nativeSetAudioDsp */
+    enum class Direction { CAPTURE, PLAYBACK }
+
+    companion object {
+        val CAPTURE_DEFAULT = PttAudioDsp()
+
+        /** Decoded audio is already level-controlled at the talker */
+        val PLAYBACK_DEFAULT = PttAudioDsp(highPass = false, agc = false)
+    }
+}
@@ -9,6 +9,25 @@
  * - AEC (Acoustic Echo Cancellation) support
  * - Comprehensive error handling
  * - Network statistics
+ * - Batched direct ByteBuffer audio ingress/egress (no per-packet ByteArray)
+ * - One-call native telemetry snapshot (lock-free, safe to poll at 1 Hz)
+ * - Opt-in per-stage latency tracing (p50/p95/p99, ATrace, RTP extension)
+ * - Seeded network impairment (loss/burst/reorder/duplicate/delay) for lab runs
+ * - Multi-channel scan: extra talkgroups on one native receive thread, priority ducking
+ * - VAD/DTX transmit gate: silence is not sent, airtime saved in telemetry
+ * - Warm standby for fast key-up; TTFF (key-up -> first frame) in telemetry
+ * - RTCP receiver feedback drives the bitrate; per-peer link quality table
+ * - Native high-pass/AGC/limiter; 48 kHz device streams resampled natively
+ * - SRTP (AES-GCM) voice protection keyed from MLS epochs, replay-checked natively
+ * - Native floor control on the RTP socket; a grant starts capture directly
+ * - RED / delayed-duplicate transmission for lossy meshes (PttRedundancy)
+ * - Multicast <-> unicast reflector for unicast-only members (PttRelay)
+ * - Idle power policy: playback parked after silence, wakeups metered (PttPower)
+ * - Native per-talker recording of received voice to Ogg/Opus (PttRecording)
+ * - Native worker thread priority/affinity and wakeup latency (PttThreads)
+ * - Receive memory budget: streams and packet buffers reserved once natively
+ * - Native stream recovery and device routing without re-init (PttAudioRoute)
+ * - Codec profiles per talkgroup with on-device MOS per profile (PttCodecProfile)
  */
 
 package com.doodlelabs.meshriderwave.ptt
@@ -21,6 +40,8 @@ import android.os.Build
 import android.util.Log
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * PTT Audio Engine - Production-ready low latency audio
@@ -44,6 +65,25 @@ class PttAudioEngine(private val context: Context) {
         private const val DEFAULT_MULTICAST_GROUP = "239.255.0.1"
         private const val DEFAULT_PORT = 5004
 
+        // Direct buffers shared with native: records of [u16 length][payload]
+        private const val DIRECT_BUFFER_BYTES = 16 * 1024
+        private const val RECORD_HEADER_BYTES = 2
+        private const val MAX_RECORD_PAYLOAD = 1500
+
+        /** Channel id of the group passed to initialize(); scan channels use ids > 0 */
+        const val HOME_CHANNEL = 0
+
+        /** Scan channels on top of the home channel (kMaxChannels - 1 in native) */
+        const val MAX_SCAN_CHANNELS = 7
+
+        const val DEFAULT_CHANNEL_PRIORITY = 1
+
+        /** Native receive memory budget (kDefaultMemoryBudgetBytes): 8 talkers with headroom */
+        const val DEFAULT_MEMORY_BUDGET_BYTES = 512L * 1024
+
+        // Upper bound on distinct channels reported by getActiveChannels (native stream slots)
+        private const val MAX_ACTIVE_CHANNELS = 8
+
         // Load native library
         init {
             try {
@@ -84,6 +124,14 @@ class PttAudioEngine(private val context: Context) {
     private var currentPort: Int = DEFAULT_PORT
     private var unicastPeers = mutableListOf<String>()
 
+    // Registered once per initialize; native reads/writes them in place
+    private val ingressBuffer: ByteBuffer =
+        ByteBuffer.allocateDirect(DIRECT_BUFFER_BYTES).order(ByteOrder.nativeOrder())
+    private val egressBuffer: ByteBuffer =
+        ByteBuffer.allocateDirect(DIRECT_BUFFER_BYTES).order(ByteOrder.nativeOrder())
+    private val ingressLock = Any()
+    private val egressLock = Any()
+
     /**
      * Initialize the audio engine
      * @param multicastGroup Multicast group address (default: 239.255.0.1)
@@ -105,6 +153,10 @@ class PttAudioEngine(private val context: Context) {
 
         if (success) {
             _isUsingMulticast.value = nativeIsUsingMulticast()
+            synchronized(ingressLock) { ingressBuffer.clear() }
+            if (!nativeRegisterAudioBuffers(ingressBuffer, egressBuffer)) {
+                Log.w(TAG, "Direct audio buffers not registered, batch path disabled")
+            }
             Log.i(TAG, "PTT audio engine initialized successfully (multicast=${_isUsingMulticast.value})")
             
             // Start playback immediately to receive audio
@@ -139,6 +191,20 @@ class PttAudioEngine(private val context: Context) {
         return success
     }
 
+    /**
+     * Keep the microphone stream running between transmissions
+     *
+     * Key-up then skips the stream start and only resets the encoder; see
+     * [PttTelemetry.lastTtffMicros]. The mic stays open while idle (privacy
+     * indicator shown, audio HAL awake), so enable it only while the PTT
+     * screen is in use. Without it the stream is still opened once and only
+     * stopped between presses.
+     */
+    fun setWarmStandby(enable: Boolean) {
+        Log.i(TAG, "Warm standby: $enable")
+        nativeSetWarmStandby(enable)
+    }
+
     /**
      * Stop audio capture (PTT TX release)
      */
@@ -204,6 +270,29 @@ class PttAudioEngine(private val context: Context) {
         unicastPeers.add(ipAddress)
     }
 
+    /**
+     * Remove a single unicast peer
+     */
+    fun removeUnicastPeer(ipAddress: String) {
+        Log.i(TAG, "Removing unicast peer: $ipAddress")
+        nativeRemoveUnicastPeer(ipAddress)
+        unicastPeers.remove(ipAddress)
+    }
+
+    /**
+     * Drop unicast peers whose sends have failed repeatedly
+     *
+     * @param minConsecutiveFailures Failures in a row before a peer is dropped (0 = native default)
+     * @return Number of peers removed
+     */
+    fun pruneUnicastPeers(minConsecutiveFailures: Int = 0): Int {
+        val removed = nativePruneUnicastPeers(minConsecutiveFailures)
+        if (removed > 0) {
+            Log.i(TAG, "Pruned $removed unreachable unicast peers")
+        }
+        return removed
+    }
+
     /**
      * Clear all unicast peers
      */
@@ -232,15 +321,57 @@ class PttAudioEngine(private val context: Context) {
     }
 
     /**
-     * Set Opus bitrate
+     * Open capture and playback on these devices
+     *
+     * Applies to running streams at once: each affected stream is reopened
+     * natively, the transmission or playback carrying on (the new output
+     * is opened before the old one stops). Kept across re-initialize.
+     */
+    fun setAudioRoute(route: PttAudioRoute) {
+        Log.i(TAG, "Audio route: $route")
+        nativeSetAudioRoute(route.inputDeviceId, route.outputDeviceId, route.echoCancel)
+    }
+
+    /**
+     * Cap the Opus bitrate
+     * The native rate controller adapts below this ceiling as link quality changes.
      * @param bitrate Bitrate in bps (6000-24000)
      */
     fun setBitrate(bitrate: Int) {
         val clampedBitrate = bitrate.coerceIn(6000, 24000)
-        Log.i(TAG, "Setting bitrate to $clampedBitrate bps")
+        Log.i(TAG, "Setting bitrate ceiling to $clampedBitrate bps")
         nativeSetBitrate(clampedBitrate)
     }
 
+    /**
+     * Enable/disable loss- and jitter-driven encoder adaptation
+     * When disabled the encoder holds its current settings.
+     */
+    fun setAdaptiveBitrate(enable: Boolean) {
+        Log.i(TAG, "Adaptive bitrate: $enable")
+        nativeSetAdaptiveBitrate(enable)
+    }
+
+    /**
+     * Keep silence off the air (on by default)
+     *
+     * Speech is sent plus [hangoverMs] after it ends; past that, frames are
+     * withheld and the next packet opens a new talkspurt (RTP marker). Saved
+     * airtime shows up in [PttTelemetry.framesSuppressed] and friends.
+     * @param comfortNoiseIntervalMs send one background frame this often during
+     *        silence; 0 sends nothing
+     * @param thresholdDb speech margin over the tracked noise floor
+     */
+    fun setTransmitDtx(
+        enable: Boolean,
+        hangoverMs: Int = 240,
+        comfortNoiseIntervalMs: Int = 0,
+        thresholdDb: Float = 9f
+    ) {
+        Log.i(TAG, "Transmit DTX: $enable (hangover ${hangoverMs}ms, CN ${comfortNoiseIntervalMs}ms)")
+        nativeSetDtx(enable, hangoverMs, comfortNoiseIntervalMs, thresholdDb)
+    }
+
     /**
      * Release native resources
      * Following Android lifecycle best practices
@@ -327,6 +458,7 @@ class PttAudioEngine(private val context: Context) {
 
     private external fun nativeStartCapture(): Boolean
     private external fun nativeStopCapture()
+    private external fun nativeSetWarmStandby(enable: Boolean)
     private external fun nativeStartPlayback(): Boolean
     private external fun nativeStopPlayback()
     private external fun nativeIsCapturing(): Boolean
@@ -337,12 +469,122 @@ class PttAudioEngine(private val context: Context) {
     // New native methods for production
     private external fun nativeAddUnicastPeer(peerAddress: String)
     private external fun nativeClearUnicastPeers()
+    private external fun nativeRemoveUnicastPeer(peerAddress: String)
+    private external fun nativePruneUnicastPeers(minConsecutiveFailures: Int): Int
     private external fun nativeGetPacketsSent(): Int
     private external fun nativeGetPacketsReceived(): Int
     private external fun nativeIsUsingMulticast(): Boolean
     private external fun nativeSetBitrate(bitrate: Int)
+    private external fun nativeSetAdaptiveBitrate(enable: Boolean)
+    private external fun nativeSetDtx(enable: Boolean, hangoverMs: Int, comfortNoiseIntervalMs: Int, thresholdDb: Float)
     private external fun nativeEnableAEC(enable: Boolean)
 
+    // Direct ByteBuffer batch path (never takes the native engine mutex)
+    private external fun nativeRegisterAudioBuffers(ingress: ByteBuffer, egress: ByteBuffer): Boolean
+    private external fun nativeSubmitIngress(byteCount: Int): Int
+    private external fun nativeDrainEgress(): Int
+    private external fun nativeSetEgressEnabled(enabled: Boolean)
+    private external fun nativeGetEgressDropped(): Long
+
+    // Lock-free pipeline counters; fills out, returns values written (0 = not initialized)
+    private external fun nativeGetTelemetry(out: LongArray): Int
+
+    // Latency tracing; stats fills out, returns values written (0 = not initialized)
+    private external fun nativeSetLatencyTracing(enable: Boolean, atrace: Boolean, rtpExtension: Boolean)
+    private external fun nativeGetLatencyStats(out: LongArray): Int
+
+    // Lab network impairment under the packetizer (direction: 0 = TX, 1 = RX)
+    private external fun nativeSetNetworkImpairment(
+        direction: Int,
+        seed: Long,
+        lossPercent: Float,
+        burstEnterPercent: Float,
+        burstExitPercent: Float,
+        burstLossPercent: Float,
+        duplicatePercent: Float,
+        reorderPercent: Float,
+        reorderDelayMs: Int,
+        delayMs: Int,
+        jitterMs: Int,
+        jitterDistribution: Int,
+        tracePath: String?
+    ): Boolean
+    private external fun nativeGetImpairmentStats(direction: Int, out: LongArray): Int
+
+    // RTCP reports (mode: PttLinkQuality.RtcpMode ordinal); link table fills out
+    private external fun nativeSetRtcp(mode: Int, sessionBandwidthBps: Int, minIntervalMs: Int, extendedReports: Boolean)
+    private external fun nativeGetLinkQuality(out: LongArray): Int
+
+    // Redundant transmission (mode: PttRedundancy.Mode ordinal)
+    private external fun nativeSetRedundancy(mode: Int, depth: Int, maxFrameBytes: Int)
+
+    // Idle power policy (idlePlayback: PttPower.IdlePlayback ordinal)
+    private external fun nativeSetPowerConfig(idlePlayback: Int, idleAfterMs: Int)
+
+    // Recording (sync: PttRecording.Sync ordinal)
+    private external fun nativeStartRecording(directory: String, sync: Int, burstGapMs: Int): Boolean
+    private external fun nativeStopRecording()
+
+    // Worker threads (role: PttThreads.Role ordinal, sched: PttThreads.Sched ordinal)
+    private external fun nativeSetThreadPolicy(role: Int, sched: Int, nice: Int, fifoPriority: Int, cpuMask: Long)
+    private external fun nativePerformanceCoreMask(): Long
+    private external fun nativeGetThreadStats(out: LongArray): Int
+
+    // Receive memory budget in bytes
+    private external fun nativeSetMemoryBudget(bytes: Long)
+
+    // Audio route (AudioDeviceInfo ids, 0 = system default)
+    private external fun nativeSetAudioRoute(inputDeviceId: Int, outputDeviceId: Int, echoCancel: Boolean)
+
+    // Relay (role: PttRelay.Role ordinal); member table fills out
+    private external fun nativeSetRelay(
+        role: Int,
+        reflectorAddress: String?,
+        keepaliveMs: Int,
+        memberTimeoutMs: Int
+    ): Boolean
+    private external fun nativeGetRelayMembers(out: LongArray): Int
+
+    // Audio DSP (direction: PttAudioDsp.Direction ordinal)
+    private external fun nativeSetAudioDsp(
+        direction: Int,
+        highPass: Boolean,
+        highPassHz: Float,
+        agc: Boolean,
+        agcTargetDbfs: Float,
+        agcMaxGainDb: Float,
+        limiter: Boolean,
+        limiterThresholdDbfs: Float
+    ): Boolean
+
+    // SRTP keys (16/32-byte master key, 12-byte salt)
+    private external fun nativeSetSrtpKey(epoch: Long, masterKey: ByteArray, masterSalt: ByteArray): Boolean
+    private external fun nativeClearSrtp()
+
+    // Floor control (state codes: PttFloorEvent.State ordinal, -1 = failed)
+    private external fun nativeSetFloorControl(
+        enabled: Boolean,
+        requestTimeoutMs: Int,
+        retryIntervalMs: Int,
+        takenRefreshMs: Int,
+        holderTimeoutMs: Int
+    )
+    private external fun nativeRequestFloor(priority: Int, emergency: Boolean, timeoutMs: Int): Int
+    private external fun nativeReleaseFloor()
+    private external fun nativeAwaitFloorEvents(out: LongArray, timeoutMs: Int): Int
+
+    // Scan channels (joined/left on the running engine)
+    private external fun nativeJoinChannel(channelId: Int, multicastGroup: String, port: Int, priority: Int): Boolean
+    private external fun nativeLeaveChannel(channelId: Int): Boolean
+    private external fun nativeSetChannelPriority(channelId: Int, priority: Int)
+    private external fun nativeSetDuckingGain(gain: Float)
+    private external fun nativeGetActiveChannels(out: IntArray): Int
+
+    // Codec profiles (profile: PttCodecProfile ordinal); results fill out
+    private external fun nativeSetCodecProfile(channelId: Int, profile: Int): Boolean
+    private external fun nativeGetProfileResults(out: LongArray): Int
+    private external fun nativeResetProfileResults()
+
     /**
      * Enqueue received audio data from the network
      * This is called when RTP audio is received and needs to be played
@@ -364,4 +606,455 @@ class PttAudioEngine(private val context: Context) {
             nativeEnqueueAudio(data)
         }
     }
+
+    /**
+     * Stage a received payload for the next [flushIngress] (no JNI call)
+     *
+     * @param data Opus payload between position and limit; position is advanced
+     * @return false if the batch is full - flush and retry
+     */
+    fun stageIngress(data: ByteBuffer): Boolean = synchronized(ingressLock) {
+        val length = data.remaining()
+        if (length == 0 || length > MAX_RECORD_PAYLOAD) return false
+        if (ingressBuffer.remaining() < RECORD_HEADER_BYTES + length) return false
+        ingressBuffer.putShort(length.toShort())
+        ingressBuffer.put(data)
+        true
+    }
+
+    fun stageIngress(data: ByteArray, offset: Int = 0, length: Int = data.size): Boolean =
+        stageIngress(ByteBuffer.wrap(data, offset, length))
+
+    /**
+     * Hand every staged payload to native in one JNI call
+     * @return Number of packets accepted
+     */
+    fun flushIngress(): Int = synchronized(ingressLock) {
+        val bytes = ingressBuffer.position()
+        ingressBuffer.clear()
+        if (bytes == 0 || !_isPlaying.value) 0 else nativeSubmitIngress(bytes)
+    }
+
+    /**
+     * Start/stop buffering natively encoded TX frames for [drainEgress]
+     * (for Kotlin-side transports; the native RTP path is unaffected)
+     */
+    fun setEgressEnabled(enabled: Boolean) {
+        nativeSetEgressEnabled(enabled)
+    }
+
+    /**
+     * Pull encoded TX frames accumulated since the last call
+     *
+     * @param onFrame Receives a read-only view of each Opus frame, valid only during the call
+     * @return Number of frames delivered
+     */
+    fun drainEgress(onFrame: (ByteBuffer) -> Unit): Int = synchronized(egressLock) {
+        val bytes = nativeDrainEgress()
+        var frames = 0
+        var offset = 0
+        while (offset + RECORD_HEADER_BYTES <= bytes) {
+            val length = egressBuffer.getShort(offset).toInt() and 0xFFFF
+            offset += RECORD_HEADER_BYTES
+            val view = egressBuffer.duplicate()
+            view.limit(offset + length).position(offset)
+            onFrame(view.slice().asReadOnlyBuffer())
+            offset += length
+            frames++
+        }
+        frames
+    }
+
+    /** TX frames dropped because [drainEgress] was not called often enough */
+    fun getEgressDropped(): Long = nativeGetEgressDropped()
+
+    private val telemetryValues = LongArray(PttTelemetry.VALUE_COUNT)
+
+    /**
+     * Snapshot of every native pipeline stage in one JNI call
+     * Never blocks the audio threads; suitable for 1 Hz dashboard polling.
+     *
+     * @return null before initialize() or after cleanup()
+     */
+    fun getTelemetry(): PttTelemetry? = synchronized(telemetryValues) {
+        PttTelemetry.fromArray(telemetryValues, nativeGetTelemetry(telemetryValues))
+    }
+
+    private val latencyValues = LongArray(PttLatencyStats.VALUE_COUNT)
+
+    /**
+     * Enable per-frame latency tracing (off by default)
+     *
+     * @param atrace Also emit per-stage Perfetto/systrace counters (API 29+)
+     * @param rtpExtension Stamp outgoing RTP so receivers can measure
+     *        network transit and mouth-to-ear (needs synced wall clocks)
+     */
+    fun setLatencyTracing(enable: Boolean, atrace: Boolean = false, rtpExtension: Boolean = true) {
+        nativeSetLatencyTracing(enable, atrace, rtpExtension)
+    }
+
+    /**
+     * Per-stage latency percentiles over recently traced frames
+     * @return null before initialize() or after cleanup()
+     */
+    fun getLatencyStats(): PttLatencyStats? = synchronized(latencyValues) {
+        PttLatencyStats.fromArray(latencyValues, nativeGetLatencyStats(latencyValues))
+    }
+
+    /**
+     * Impair one direction of the RTP link (lab/testing only); null clears it
+     *
+     * Resets that direction's impairment counters.
+     * @return false before initialize() or if the trace cannot be read
+     */
+    fun setNetworkImpairment(
+        direction: PttNetworkImpairment.Direction,
+        impairment: PttNetworkImpairment?
+    ): Boolean {
+        val profile = impairment ?: PttNetworkImpairment()
+        val ok = nativeSetNetworkImpairment(
+            direction.ordinal,
+            profile.seed,
+            profile.lossPercent,
+            profile.burstEnterPercent,
+            profile.burstExitPercent,
+            profile.burstLossPercent,
+            profile.duplicatePercent,
+            profile.reorderPercent,
+            profile.reorderDelayMs,
+            profile.delayMs,
+            profile.jitterMs,
+            profile.jitter.ordinal,
+            profile.tracePath
+        )
+        if (ok && impairment != null) {
+            Log.w(TAG, "Network impairment on ($direction): $impairment")
+        }
+        return ok
+    }
+
+    /** Impairment counters since the direction's profile was set; null before initialize() */
+    fun getImpairmentStats(direction: PttNetworkImpairment.Direction): PttNetworkImpairment.Stats? {
+        val values = LongArray(PttNetworkImpairment.Stats.VALUE_COUNT)
+        return PttNetworkImpairment.Stats.fromArray(
+            values, nativeGetImpairmentStats(direction.ordinal, values)
+        )
+    }
+
+    /**
+     * Configure RTCP sender/receiver reports (on by default, RTP port + 1)
+     *
+     * Reports from listeners feed the adaptive bitrate and fill the link
+     * table ([getLinkQuality]). Use [PttLinkQuality.RtcpMode.MUX] where only
+     * one port is open between radios. Kept across re-initialize.
+     * @param sessionBandwidthBps sets the report interval (RTCP gets 5% of it)
+     * @param minIntervalMs floor on the interval; below 5000 for lab runs only
+     * @param extendedReports XR round trips so RTT is known for listeners too
+     */
+    fun setRtcp(
+        mode: PttLinkQuality.RtcpMode = PttLinkQuality.RtcpMode.SEPARATE_PORT,
+        sessionBandwidthBps: Int = PttLinkQuality.DEFAULT_SESSION_BANDWIDTH_BPS,
+        minIntervalMs: Int = PttLinkQuality.DEFAULT_MIN_INTERVAL_MS,
+        extendedReports: Boolean = true
+    ) {
+        Log.i(TAG, "RTCP: $mode, ${sessionBandwidthBps}bps, min ${minIntervalMs}ms, XR $extendedReports")
+        nativeSetRtcp(mode.ordinal, sessionBandwidthBps, minIntervalMs, extendedReports)
+    }
+
+    /**
+     * Send redundant copies of each frame (off by default)
+     *
+     * Every talkgroup member must run a build that splits RED packets before
+     * [PttRedundancy.Mode.RED] is turned on. Kept across re-initialize.
+     */
+    fun setRedundancy(config: PttRedundancy) {
+        Log.i(TAG, "Redundancy: ${config.mode}, depth ${config.depth}, max ${config.maxFrameBytes}B")
+        nativeSetRedundancy(config.mode.ordinal, config.depth, config.maxFrameBytes)
+    }
+
+    /**
+     * What playback does after a stretch of silence (KEEP by default)
+     *
+     * POWER_SAVING and STOP trade the first word after a pause (the stream
+     * is re-armed by that packet) for far fewer CPU wakeups while idle; see
+     * [PttTelemetry.idleWakeupsPerMinute]. Kept across re-initialize.
+     */
+    fun setPowerConfig(config: PttPower) {
+        Log.i(TAG, "Idle playback: ${config.idlePlayback} after ${config.idleAfterMs}ms")
+        nativeSetPowerConfig(config.idlePlayback.ordinal, config.idleAfterMs)
+    }
+
+    /**
+     * Record every received talker burst to [PttRecording.directory]
+     *
+     * Restarts a recording already running. Kept across re-initialize;
+     * stops with [stopRecording] or [cleanup].
+     * @return false before initialize() or if the directory is not writable
+     */
+    fun startRecording(config: PttRecording): Boolean {
+        Log.i(TAG, "Recording to ${config.directory} (sync ${config.sync})")
+        return nativeStartRecording(config.directory.absolutePath, config.sync.ordinal, config.burstGapMs)
+    }
+
+    /** Close open bursts and flush them (and the index) to storage */
+    fun stopRecording() {
+        nativeStopRecording()
+    }
+
+    /**
+     * Scheduling and CPU pinning for one native worker thread
+     *
+     * Applies at once to a running thread, else when it next starts. Kept
+     * across re-initialize and release(); see [PttThreads.defaultFor].
+     */
+    fun setThreadPolicy(role: PttThreads.Role, policy: PttThreads) {
+        Log.i(TAG, "Thread policy $role: $policy")
+        nativeSetThreadPolicy(role.ordinal, policy.sched.ordinal, policy.nice, policy.fifoPriority, policy.cpuMask)
+    }
+
+    /** CPUs above the little cluster (all on a uniform SoC); empty if unknown */
+    fun performanceCores(): Set<Int> = PttThreads.cpusFromMask(nativePerformanceCoreMask())
+
+    private val threadStatValues = LongArray(PttThreads.VALUE_COUNT)
+
+    /** Every worker role with what was applied and its wakeup latency so far */
+    fun getThreadStats(): List<PttThreads.Stats> = synchronized(threadStatValues) {
+        PttThreads.statsFromArray(threadStatValues, nativeGetThreadStats(threadStatValues))
+    }
+
+    /**
+     * Bytes the native receive side may hold: stream slots with their
+     * decoders, plus the packet buffer pool
+     *
+     * Reserved in one go by the first initialize() after construction or
+     * cleanup(); a running engine keeps what it has. Fewer bytes mean fewer
+     * simultaneous talkers (telemetry memoryStreamSlots); below one talker
+     * initialize() fails.
+     */
+    fun setMemoryBudget(bytes: Long = DEFAULT_MEMORY_BUDGET_BYTES) {
+        Log.i(TAG, "Memory budget: $bytes bytes")
+        nativeSetMemoryBudget(bytes)
+    }
+
+    /**
+     * Act as a reflector for, or a member of, a multicast <-> unicast relay
+     * (off by default)
+     *
+     * Enable REFLECTOR on a radio that reliably joins the group; MEMBER on
+     * one that cannot, pointing at it. Kept across re-initialize.
+     * @return false if a MEMBER's reflector address is not IPv4
+     */
+    fun setRelay(config: PttRelay): Boolean {
+        Log.i(TAG, "Relay: ${config.role}, reflector ${config.reflectorAddress}")
+        return nativeSetRelay(
+            config.role.ordinal, config.reflectorAddress,
+            config.keepaliveMs, config.memberTimeoutMs
+        )
+    }
+
+    private val relayMemberValues = LongArray(PttRelay.VALUE_COUNT)
+
+    /**
+     * Members a reflector currently serves
+     * @return empty before initialize() or unless REFLECTOR
+     */
+    fun getRelayMembers(): List<PttRelay.Member> = synchronized(relayMemberValues) {
+        PttRelay.membersFromArray(relayMemberValues, nativeGetRelayMembers(relayMemberValues))
+    }
+
+    private val linkQualityValues = LongArray(PttLinkQuality.VALUE_COUNT)
+
+    /**
+     * Members heard on the home talkgroup with loss, jitter and RTT
+     * @return empty before initialize() or until reports arrive
+     */
+    fun getLinkQuality(): List<PttLinkQuality> = synchronized(linkQualityValues) {
+        PttLinkQuality.fromArray(linkQualityValues, nativeGetLinkQuality(linkQualityValues))
+    }
+
+    /**
+     * Configure the native DSP stage for one direction
+     *
+     * Capture runs before the encoder (and the DTX gate); playback after the
+     * mix. Takes effect on the next frame; not kept across release().
+     * @return false before initialize()
+     */
+    fun setAudioDsp(direction: PttAudioDsp.Direction, dsp: PttAudioDsp): Boolean {
+        Log.i(TAG, "Audio DSP $direction: $dsp")
+        return nativeSetAudioDsp(
+            direction.ordinal,
+            dsp.highPass, dsp.highPassHz,
+            dsp.agc, dsp.agcTargetDbfs, dsp.agcMaxGainDb,
+            dsp.limiter, dsp.limiterThresholdDbfs
+        )
+    }
+
+    /**
+     * Protect voice and RTCP with SRTP AEAD_AES_128_GCM (or _256_ with a
+     * 32-byte key) from now on
+     *
+     * Material comes from [com.doodlelabs.meshriderwave.core.crypto.MLSGroupManager.exportSrtpKeys];
+     * call again after every commit. The previous epoch's keys stay valid
+     * natively for a few seconds so in-flight packets still play. Kept
+     * across release() and reinitialize; the arrays may be wiped once this
+     * returns.
+     * @return false for a malformed key/salt or an epoch not above the
+     *         installed one (after leaving a group, [clearSrtp] first)
+     */
+    fun setSrtpKey(epoch: Long, masterKey: ByteArray, masterSalt: ByteArray): Boolean {
+        val installed = nativeSetSrtpKey(epoch, masterKey, masterSalt)
+        Log.i(TAG, "SRTP key for epoch $epoch ${if (installed) "installed" else "refused"}")
+        return installed
+    }
+
+    /**
+     * Stop protecting; keys and per-sender replay state are wiped natively.
+     * Packets from members still protecting will not play.
+     */
+    fun clearSrtp() {
+        Log.i(TAG, "SRTP cleared")
+        nativeClearSrtp()
+    }
+
+    /**
+     * Arbitrate the floor natively (RTCP APP messages on the RTP socket)
+     *
+     * While enabled nothing is transmitted without the floor: use
+     * [requestFloor]/[releaseFloor] instead of startCapture()/stopCapture().
+     * Every member must run the same mode. Kept across re-initialize.
+     * @param requestTimeoutMs no DENY by then and the floor is ours (partition)
+     * @param holderTimeoutMs a holder silent this long is presumed gone
+     */
+    fun setNativeFloorControl(
+        enable: Boolean,
+        requestTimeoutMs: Int = PttFloorEvent.DEFAULT_REQUEST_TIMEOUT_MS,
+        retryIntervalMs: Int = PttFloorEvent.DEFAULT_RETRY_INTERVAL_MS,
+        takenRefreshMs: Int = PttFloorEvent.DEFAULT_TAKEN_REFRESH_MS,
+        holderTimeoutMs: Int = PttFloorEvent.DEFAULT_HOLDER_TIMEOUT_MS
+    ) {
+        Log.i(TAG, "Native floor control: $enable (window ${requestTimeoutMs}ms)")
+        nativeSetFloorControl(enable, requestTimeoutMs, retryIntervalMs, takenRefreshMs, holderTimeoutMs)
+    }
+
+    /**
+     * PTT press with native arbitration; on a grant capture is already
+     * running when this returns
+     *
+     * Blocks up to the request window (plus one round trip); call from a
+     * background dispatcher. A request still undecided after timeoutMs is
+     * cancelled.
+     * @param priority 0..255, a higher one preempts the holder
+     * @param emergency talk at once and revoke any holder
+     * @return the floor state, null before initialize() or if capture failed
+     */
+    fun requestFloor(
+        priority: Int = 0,
+        emergency: Boolean = false,
+        timeoutMs: Int = PttFloorEvent.DEFAULT_REQUEST_TIMEOUT_MS * 4
+    ): PttFloorEvent.State? {
+        requestAudioFocus()
+        val state = PttFloorEvent.stateOf(nativeRequestFloor(priority, emergency, timeoutMs))
+        if (state == PttFloorEvent.State.GRANTED) {
+            _isCapturing.value = true
+        } else {
+            abandonAudioFocus()
+        }
+        Log.i(TAG, "Floor request (priority $priority, emergency $emergency): $state")
+        return state
+    }
+
+    /** PTT release with native arbitration: stops capture, then frees the floor */
+    fun releaseFloor() {
+        nativeReleaseFloor()
+        _isCapturing.value = false
+        abandonAudioFocus()
+        _packetsSent.value = nativeGetPacketsSent().toLong()
+    }
+
+    private val floorEventValues = LongArray(PttFloorEvent.VALUE_COUNT)
+
+    /**
+     * Wait for floor decisions (blocking, one caller at a time)
+     *
+     * A REVOKED event has already stopped capture natively.
+     * @return empty after timeoutMs or once cleanup() runs
+     */
+    fun awaitFloorEvents(timeoutMs: Int): List<PttFloorEvent> = synchronized(floorEventValues) {
+        val events = PttFloorEvent.fromArray(floorEventValues, nativeAwaitFloorEvents(floorEventValues, timeoutMs))
+        if (events.any { it.type == PttFloorEvent.Type.REVOKED }) {
+            _isCapturing.value = nativeIsCapturing()
+        }
+        events
+    }
+
+    /**
+     * Monitor another talkgroup alongside the home channel (receive only)
+     *
+     * Served by the same native receive thread and decoder as the home channel;
+     * no engine rebuild. While a higher-priority channel is talking, lower ones
+     * are ducked (see [setDuckingGain]).
+     * @param channelId caller's talkgroup id, > 0 and unique among joined channels
+     * @param priority higher wins the mix; the home channel defaults to [DEFAULT_CHANNEL_PRIORITY]
+     * @return false before initialize(), if the id is taken, the scan list is full
+     *         ([MAX_SCAN_CHANNELS]) or the group cannot be joined
+     */
+    fun joinChannel(
+        channelId: Int,
+        multicastGroup: String,
+        port: Int = DEFAULT_PORT,
+        priority: Int = DEFAULT_CHANNEL_PRIORITY
+    ): Boolean {
+        val ok = nativeJoinChannel(channelId, multicastGroup, port, priority)
+        Log.i(TAG, "Join scan channel $channelId ($multicastGroup:$port, priority $priority): $ok")
+        return ok
+    }
+
+    /** Stop monitoring a scan channel; its talkers are cut immediately */
+    fun leaveChannel(channelId: Int): Boolean = nativeLeaveChannel(channelId)
+
+    /** Reprioritize a channel ([HOME_CHANNEL] included), 0..255 */
+    fun setChannelPriority(channelId: Int, priority: Int) {
+        nativeSetChannelPriority(channelId, priority)
+    }
+
+    /**
+     * Level of lower-priority channels while a higher one talks
+     * @param gain linear 0..1; 0 = strict priority scan (muted)
+     */
+    fun setDuckingGain(gain: Float) {
+        nativeSetDuckingGain(gain.coerceIn(0f, 1f))
+    }
+
+    /** Channels with a talker right now, for the scan indicator */
+    fun getActiveChannels(): IntArray {
+        val channels = IntArray(MAX_ACTIVE_CHANNELS)
+        return channels.copyOf(nativeGetActiveChannels(channels))
+    }
+
+    /**
+     * Codec profile of a talkgroup ([HOME_CHANNEL] or a joined scan channel)
+     *
+     * Switchable mid-call: jitter bounds apply at once (live talkers restart
+     * under them). On the home channel the encoder takes the profile's
+     * settings within a second and its Opus mode from the next key-up.
+     * Forgotten when the channel is left and on cleanup().
+     * @return false before initialize() or if the channel table is full
+     */
+    fun setCodecProfile(channelId: Int, profile: PttCodecProfile): Boolean {
+        val ok = nativeSetCodecProfile(channelId, profile.ordinal)
+        Log.i(TAG, "Codec profile $profile on channel $channelId: $ok")
+        return ok
+    }
+
+    private val profileResultValues = LongArray(PttCodecProfile.VALUE_COUNT)
+
+    /** Quality scores and transmit totals per profile since initialize() or the last reset */
+    fun getProfileResults(): List<PttCodecProfile.Results> = synchronized(profileResultValues) {
+        PttCodecProfile.resultsFromArray(profileResultValues, nativeGetProfileResults(profileResultValues))
+    }
+
+    /** Start a new A/B run */
+    fun resetProfileResults() {
+        nativeResetProfileResults()
+    }
 }
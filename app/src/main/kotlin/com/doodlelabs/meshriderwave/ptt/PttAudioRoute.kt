@@ -0,0 +1,53 @@
+/*
+ * Mesh Rider Wave - PTT Audio Route
+ * Devices the native capture and playback streams open on (AudioEngine.h)
+ *
+ * Device ids are AudioDeviceInfo.getId(); DEFAULT_DEVICE leaves the choice
+ * to the system, which moves to a headset as it connects. Either way a
+ * stream that drops (Bluetooth connect/disconnect, HAL restart) is reopened
+ * natively and restarted without ending the call; PttTelemetry.stream*
+ * shows how long each recovery took. echoCancel selects the
+ * VoiceCommunication capture preset (platform AEC), needed on speakerphone.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+import android.media.AudioDeviceInfo
+import android.media.AudioManager
+
+data class PttAudioRoute(
+    val inputDeviceId: Int = DEFAULT_DEVICE,
+    val outputDeviceId: Int = DEFAULT_DEVICE,
+    val echoCancel: Boolean = true
+) {
+    companion object {
+        const val DEFAULT_DEVICE = 0
+
+        // Outputs whose microphone is taken with them
+        private val HEADSET_TYPES = setOf(
+            AudioDeviceInfo.TYPE_BLUETOOTH_SCO,
+            AudioDeviceInfo.TYPE_WIRED_HEADSET,
+            AudioDeviceInfo.TYPE_USB_HEADSET
+        )
+
+        /**
+         * Route to the first output of [type] (AudioDeviceInfo.TYPE_*) and,
+         * for a headset, its microphone; null if no such output is attached.
+         * AEC is on for the built-in speaker only.
+         */
+        fun forDeviceType(audioManager: AudioManager, type: Int): PttAudioRoute? {
+            val output = audioManager.getDevices(AudioManager.GET_DEVICES_OUTPUTS)
+                .firstOrNull { it.type == type } ?: return null
+            val input = if (type in HEADSET_TYPES) {
+                audioManager.getDevices(AudioManager.GET_DEVICES_INPUTS).firstOrNull { it.type == type }
+            } else {
+                null
+            }
+            return PttAudioRoute(
+                inputDeviceId = input?.id ?: DEFAULT_DEVICE,
+                outputDeviceId = output.id,
+                echoCancel = type == AudioDeviceInfo.TYPE_BUILTIN_SPEAKER
+            )
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Mesh Rider Wave - PTT Codec Profiles
+ * Named codec/transport settings per talkgroup, scored on the device
+ * (CallQuality.h)
+ *
+ * A profile fixes the Opus mode, bitrate, FEC, frame size and jitter
+ * buffer bounds (DEFAULT keeps the adaptive ladder). Give every member of
+ * a talkgroup the same profile, and different talkgroups (or the same one
+ * over time) different profiles, to A/B them on a live fleet.
+ *
+ * Each talker stream heard on the talkgroup gets an ITU-T G.107 E-model
+ * score from its post-repair loss and its mouth-to-ear delay (measured
+ * while latency tracing is on, estimated otherwise); [Results] aggregate
+ * those with what this radio transmitted under the profile.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+/** Order mirrors kCodecProfiles in CallQuality.h */
+enum class PttCodecProfile {
+    /** VOIP, adaptive bitrate/FEC/frame size, 20..300 ms jitter buffer */
+    DEFAULT,
+    /** RESTRICTED_LOWDELAY at 16 kbps, 10 ms frames, no FEC, 10..120 ms */
+    LOW_DELAY,
+    /** VOIP at 12 kbps, 40 ms frames, FEC for 20% loss, 60..400 ms */
+    ROBUST,
+    /** VOIP at 8 kbps, 60 ms frames, FEC for 25% loss, 60..400 ms */
+    LOW_RATE;
+
+    data class Results(
+        val profile: PttCodecProfile,
+        /** Talker streams scored (streams under MIN_SCORED_FRAMES are skipped) */
+        val streamsScored: Long,
+        val framesScored: Long,
+        /** Concealed after FEC/RED repair */
+        val framesLost: Long,
+        /** Rebuilt from FEC */
+        val framesRecovered: Long,
+        /** Frame-weighted, 1.0 .. 4.5 (0 with nothing scored) */
+        val meanMos: Double,
+        /** Worst single stream */
+        val minMos: Double,
+        val meanRFactor: Double,
+        /** One-way, mouth to ear */
+        val meanDelayMs: Double,
+        /** Streams whose delay was traced rather than estimated */
+        val measuredStreams: Long,
+        val txSessions: Long,
+        val txFrames: Long,
+        /** Sent: frames less DTX-suppressed */
+        val txPackets: Long,
+        /** Opus payload of the sent packets */
+        val txBytes: Long,
+        /** Keyed time */
+        val txMillis: Long
+    ) {
+        val lossPct: Double
+            get() = if (framesScored > 0) 100.0 * framesLost / framesScored else 0.0
+
+        /** Payload plus IPv4/UDP/RTP headers per packet, over the keyed time */
+        val airKbps: Double
+            get() = if (txMillis > 0) {
+                8.0 * (txBytes + txPackets * PACKET_OVERHEAD_BYTES) / txMillis
+            } else {
+                0.0
+            }
+    }
+
+    companion object {
+        const val MIN_SCORED_FRAMES = 50
+        const val PACKET_OVERHEAD_BYTES = 20 + 8 + 12
+
+        const val LAYOUT_VERSION = 1L
+        const val VALUES_PER_PROFILE = 14
+        val VALUE_COUNT = 2 + values().size * VALUES_PER_PROFILE
+
+        /** Decode a filled results array; empty if native uses another layout */
+        fun resultsFromArray(values: LongArray, count: Int): List<Results> {
+            if (count < 2 || values[0] != LAYOUT_VERSION) return emptyList()
+            val profiles = PttCodecProfile.values()
+            val entries = minOf(values[1].toInt(), (count - 2) / VALUES_PER_PROFILE, profiles.size)
+            return List(entries) { n ->
+                val i = 2 + n * VALUES_PER_PROFILE
+                Results(
+                    profile = profiles[n],
+                    streamsScored = values[i],
+                    framesScored = values[i + 1],
+                    framesLost = values[i + 2],
+                    framesRecovered = values[i + 3],
+                    meanMos = values[i + 4] / 1000.0,
+                    minMos = values[i + 5] / 1000.0,
+                    meanRFactor = values[i + 6] / 1000.0,
+                    meanDelayMs = values[i + 7] / 1000.0,
+                    measuredStreams = values[i + 8],
+                    txSessions = values[i + 9],
+                    txFrames = values[i + 10],
+                    txPackets = values[i + 11],
+                    txBytes = values[i + 12],
+                    txMillis = values[i + 13]
+                )
+            }
+        }
+    }
+}
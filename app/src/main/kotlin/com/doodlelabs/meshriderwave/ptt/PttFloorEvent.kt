@@ -0,0 +1,55 @@
+/*
+ * Mesh Rider Wave - PTT Floor Event
+ * Decisions of the native floor control (FloorControl.h), as Kotlin sees them
+ *
+ * Arbitration runs on the native receive thread and gates transmission
+ * there; these events only tell the UI who is talking. A REVOKED event
+ * arrives after capture was already silenced natively.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttFloorEvent(
+    val type: Type,
+    /** Us for GRANTED, otherwise the peer that holds or took the floor */
+    val ssrc: Long,
+    val priority: Int,
+    val emergency: Boolean,
+    /** Native monotonic clock, microseconds */
+    val timeMicros: Long
+) {
+    /** Order mirrors FloorEventType in FloorControl.h */
+    enum class Type { GRANTED, DENIED, REVOKED, TAKEN, IDLE }
+
+    /** Order mirrors FloorState in FloorControl.h */
+    enum class State { IDLE, PENDING, GRANTED, TAKEN }
+
+    companion object {
+        const val VALUES_PER_EVENT = 4
+        const val MAX_EVENTS = 32
+        const val VALUE_COUNT = MAX_EVENTS * VALUES_PER_EVENT
+
+        const val DEFAULT_REQUEST_TIMEOUT_MS = 120
+        const val DEFAULT_RETRY_INTERVAL_MS = 40
+        const val DEFAULT_TAKEN_REFRESH_MS = 1000
+        const val DEFAULT_HOLDER_TIMEOUT_MS = 3000
+
+        /** Decode count events written by nativeAwaitFloorEvents */
+        fun fromArray(values: LongArray, count: Int): List<PttFloorEvent> {
+            val types = Type.values()
+            return List(minOf(count, values.size / VALUES_PER_EVENT)) { n ->
+                val i = n * VALUES_PER_EVENT
+                PttFloorEvent(
+                    type = types[values[i].toInt().coerceIn(0, types.size - 1)],
+                    ssrc = values[i + 1],
+                    priority = (values[i + 2] and 0xFF).toInt(),
+                    emergency = (values[i + 2] and 0x100) != 0L,
+                    timeMicros = values[i + 3]
+                )
+            }
+        }
+
+        /** nativeRequestFloor result; null when not initialized or capture failed */
+        fun stateOf(code: Int): State? = State.values().getOrNull(code)
+    }
+}
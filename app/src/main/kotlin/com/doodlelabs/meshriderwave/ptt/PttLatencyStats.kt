@@ -0,0 +1,70 @@
+/*
+ * Mesh Rider Wave - PTT Latency Tracing Report
+ * Decoded form of one nativeGetLatencyStats() result
+ *
+ * Percentiles cover the most recent traced frames per stage. Network
+ * transit and mouth-to-ear need the sender's RTP latency extension and
+ * synchronized wall clocks on both radios; they stay empty otherwise.
+ * Device latency (mic/speaker path outside the audio callbacks) is
+ * reported separately and should be added for acoustic mouth-to-ear.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttLatencyStats(
+    val txFrames: Long,
+    val rxFrames: Long,
+    val droppedTraces: Long,
+    val inputDeviceMicros: Long,
+    val outputDeviceMicros: Long,
+    val stages: Map<Stage, Percentiles>
+) {
+    /** Order mirrors LatencyStage in LatencyTracer.h */
+    enum class Stage {
+        CAPTURE_TO_ENCODE,
+        ENCODE_TO_SEND,
+        NETWORK_TRANSIT,
+        JITTER_BUFFER,
+        DECODE,
+        PLAYOUT_QUEUE,
+        MOUTH_TO_EAR
+    }
+
+    data class Percentiles(
+        val samples: Long,
+        val p50Micros: Long,
+        val p95Micros: Long,
+        val p99Micros: Long,
+        val maxMicros: Long
+    )
+
+    companion object {
+        const val LAYOUT_VERSION = 1L
+        private const val HEADER_VALUES = 6
+        private const val VALUES_PER_STAGE = 5
+        val VALUE_COUNT = HEADER_VALUES + Stage.values().size * VALUES_PER_STAGE
+
+        /** Decode a filled result array; null if native uses another layout */
+        fun fromArray(values: LongArray, count: Int): PttLatencyStats? {
+            if (count < VALUE_COUNT || values[0] != LAYOUT_VERSION) return null
+            val stages = Stage.values().associateWith { stage ->
+                val base = HEADER_VALUES + stage.ordinal * VALUES_PER_STAGE
+                Percentiles(
+                    samples = values[base],
+                    p50Micros = values[base + 1],
+                    p95Micros = values[base + 2],
+                    p99Micros = values[base + 3],
+                    maxMicros = values[base + 4]
+                )
+            }
+            return PttLatencyStats(
+                txFrames = values[1],
+                rxFrames = values[2],
+                droppedTraces = values[3],
+                inputDeviceMicros = values[4],
+                outputDeviceMicros = values[5],
+                stages = stages
+            )
+        }
+    }
+}
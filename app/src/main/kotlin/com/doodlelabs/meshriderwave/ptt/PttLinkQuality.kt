@@ -0,0 +1,68 @@
+/*
+ * Mesh Rider Wave - PTT Link Quality
+ * Per-peer view of the RTP session from native RTCP reports
+ *
+ * Inbound figures come from this radio's own reception statistics of each
+ * member's stream; remote figures are what that member reported receiving
+ * from us. RTT needs a completed SR or XR round trip (a few report
+ * intervals after joining). MeshNetworkManager can use this to spot bad
+ * hops before a press instead of after.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttLinkQuality(
+    val ssrc: Long,
+    /** Source of its last RTCP packet, null until one arrived */
+    val address: String?,
+    val packetsReceived: Long,
+    val cumulativeLost: Long,
+    /** Over our last report interval, 0..1 */
+    val fractionLost: Float,
+    val jitterMs: Long,
+    /** Its report about our stream; null until it sent one */
+    val remoteFractionLost: Float?,
+    val remoteJitterMs: Long?,
+    val rttMs: Long?,
+    /** Since anything was last heard from it */
+    val ageMs: Long
+) {
+    /** Order mirrors RtcpMode in RtcpSession.h */
+    enum class RtcpMode { OFF, SEPARATE_PORT, MUX }
+
+    companion object {
+        const val LAYOUT_VERSION = 1L
+        const val VALUES_PER_ENTRY = 10
+        const val MAX_ENTRIES = 32
+        const val VALUE_COUNT = 2 + MAX_ENTRIES * VALUES_PER_ENTRY
+
+        const val DEFAULT_SESSION_BANDWIDTH_BPS = 40000
+        const val DEFAULT_MIN_INTERVAL_MS = 5000
+
+        /** Decode a filled array; empty if native uses another layout */
+        fun fromArray(values: LongArray, count: Int): List<PttLinkQuality> {
+            if (count < 2 || values[0] != LAYOUT_VERSION) return emptyList()
+            val entries = minOf(values[1].toInt(), (count - 2) / VALUES_PER_ENTRY)
+            return List(entries) { n ->
+                val i = 2 + n * VALUES_PER_ENTRY
+                val hasRemote = values[i + 6] >= 0
+                PttLinkQuality(
+                    ssrc = values[i],
+                    address = values[i + 1].takeIf { it != 0L }?.let(::ipv4ToString),
+                    packetsReceived = values[i + 2],
+                    cumulativeLost = values[i + 3],
+                    fractionLost = values[i + 4] / 1e6f,
+                    jitterMs = values[i + 5],
+                    remoteFractionLost = if (hasRemote) values[i + 6] / 1e6f else null,
+                    remoteJitterMs = values[i + 7].takeIf { hasRemote },
+                    rttMs = values[i + 8].takeIf { it >= 0 },
+                    ageMs = values[i + 9]
+                )
+            }
+        }
+
+        // Native address is network order read as a little-endian int
+        private fun ipv4ToString(address: Long): String =
+            (0 until 4).joinToString(".") { ((address shr (8 * it)) and 0xFF).toString() }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Mesh Rider Wave - PTT Network Impairment Profile
+ * Seeded link model applied under the native RTP packetizer
+ *
+ * For lab tuning and instrumented tests only: the same seed gives the
+ * same per-packet loss/delay sequence on every device and in the host
+ * benchmark, so receive quality can be compared across builds. Transmit
+ * applies loss and duplication; delay, jitter and reorder are receive-side.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttNetworkImpairment(
+    val seed: Long = 1,
+    /** Loss probability outside bursts (Bernoulli when burstEnterPercent is 0) */
+    val lossPercent: Float = 0f,
+    /** Gilbert-Elliott burst model: enter/exit per packet, loss inside a burst */
+    val burstEnterPercent: Float = 0f,
+    val burstExitPercent: Float = 100f,
+    val burstLossPercent: Float = 0f,
+    val duplicatePercent: Float = 0f,
+    val reorderPercent: Float = 0f,
+    val reorderDelayMs: Int = 0,
+    val delayMs: Int = 0,
+    /** Mean of the jitter draw added to delayMs */
+    val jitterMs: Int = 0,
+    val jitter: Jitter = Jitter.UNIFORM,
+    /** Recorded "seq send_ms arrival_ms" trace; replaces the loss/delay models */
+    val tracePath: String? = null
+) {
+    /** Order mirrors ImpairmentDirection in NetworkImpairment.h */
+    enum class Direction { TRANSMIT, RECEIVE }
+
+    /** Order mirrors JitterDistribution in NetworkImpairment.h */
+    enum class Jitter { UNIFORM, NORMAL, PARETO }
+
+    data class Stats(
+        val packets: Long,
+        val dropped: Long,
+        val duplicated: Long,
+        val delayed: Long,
+        val reordered: Long,
+        /** Hold queue was full and the packet went through early */
+        val overflows: Long
+    ) {
+        companion object {
+            const val VALUE_COUNT = 6
+
+            fun fromArray(values: LongArray, count: Int): Stats? {
+                if (count < VALUE_COUNT) return null
+                return Stats(values[0], values[1], values[2], values[3], values[4], values[5])
+            }
+        }
+    }
+
+    companion object {
+        /** Typical multi-hop MeshRider link under load */
+        val MESH_MULTI_HOP = PttNetworkImpairment(
+            delayMs = 15, jitterMs = 15, jitter = Jitter.PARETO, lossPercent = 1f
+        )
+
+        /** Fading edge-of-range link: ~6% loss in short bursts */
+        val BURSTY_EDGE = PttNetworkImpairment(
+            delayMs = 10, jitterMs = 5,
+            burstEnterPercent = 3f, burstExitPercent = 30f, burstLossPercent = 80f
+        )
+
+        /** Route flaps between two paths */
+        val ROUTE_FLAP = PttNetworkImpairment(
+            delayMs = 10, jitterMs = 4, reorderPercent = 5f, reorderDelayMs = 40,
+            duplicatePercent = 1f
+        )
+    }
+}
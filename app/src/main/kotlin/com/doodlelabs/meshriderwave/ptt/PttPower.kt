@@ -0,0 +1,34 @@
+/*
+ * Mesh Rider Wave - PTT Idle Power Policy
+ * What the receive side does between talkspurts (PowerConfig in AudioEngine.h)
+ *
+ * A monitoring radio spends most of the day hearing nothing. After
+ * idleAfterMs without a packet or audio to play, the decoder stops polling
+ * and blocks until the next packet arrives; playback is either kept
+ * (lowest latency), moved to a power-saving Oboe stream whose callback
+ * wakes rarely, or stopped. The first packet re-arms the low-latency
+ * stream inside the jitter buffer's playout delay. The receive thread
+ * always sleeps until a datagram or its next timer.
+ * PttTelemetry.power* reports wakeups per minute in each mode.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttPower(
+    val idlePlayback: IdlePlayback = IdlePlayback.KEEP,
+    /** Silence before the receive side goes idle (at least MIN_IDLE_AFTER_MS) */
+    val idleAfterMs: Int = DEFAULT_IDLE_AFTER_MS
+) {
+    /** Order mirrors IdlePlayback in AudioEngine.h */
+    enum class IdlePlayback { KEEP, POWER_SAVING, STOP }
+
+    companion object {
+        const val DEFAULT_IDLE_AFTER_MS = 10000
+        const val MIN_IDLE_AFTER_MS = 1000
+
+        val DEFAULT = PttPower()
+
+        /** All-day monitoring: stop playback after 10 s of silence */
+        val MONITOR = PttPower(IdlePlayback.STOP)
+    }
+}
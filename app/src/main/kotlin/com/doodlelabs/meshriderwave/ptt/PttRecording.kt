@@ -0,0 +1,35 @@
+/*
+ * Mesh Rider Wave - PTT Voice Recording Settings
+ * Every received transmission kept for after-action review (VoiceRecorder.h)
+ *
+ * The native receive path stores each talker burst, per talkgroup, as an
+ * Ogg/Opus file holding the packets exactly as received (no decode or
+ * re-encode), named ch<channel>_<ssrc hex>_<start unix ms>.opus.
+ * index.csv in the same directory lists every burst with start/end wall
+ * time, channel, SSRC, duration and file name. Files are written in large
+ * blocks by a native I/O thread; PttTelemetry.recording* shows the cost.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+import java.io.File
+
+data class PttRecording(
+    /** Existing, writable directory (app-private storage) */
+    val directory: File,
+    val sync: Sync = Sync.NONE,
+    /** Silence that ends a talker's burst (at least MIN_BURST_GAP_MS) */
+    val burstGapMs: Int = DEFAULT_BURST_GAP_MS
+) {
+    /**
+     * Order mirrors RecordingSync in VoiceRecorder.h. FDATASYNC makes each
+     * burst durable when it closes; DIRECT also bypasses the page cache.
+     */
+    enum class Sync { NONE, FDATASYNC, DIRECT }
+
+    companion object {
+        const val DEFAULT_BURST_GAP_MS = 1500
+        const val MIN_BURST_GAP_MS = 200
+        const val INDEX_FILE = "index.csv"
+    }
+}
@@ -0,0 +1,33 @@
+/*
+ * Mesh Rider Wave - PTT Redundant Transmission Settings
+ * Loss protection beyond Opus in-band FEC (RedundancyConfig in RtpPacketizer.h)
+ *
+ * RED repeats the previous frames inside each packet (RFC 2198), so a
+ * burst of up to depth lost packets still plays exactly. DUPLICATE sends
+ * every packet a second time one frame later. Both cost airtime; enable
+ * them on meshes whose RTCP loss stays high and only when every member
+ * runs a build that understands RED. PttTelemetry.redundancy* shows how
+ * many copies the receivers actually needed.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttRedundancy(
+    val mode: Mode = Mode.OFF,
+    /** RED: previous frames carried per packet (1..MAX_DEPTH) */
+    val depth: Int = DEFAULT_DEPTH,
+    /** RED: larger frames are not repeated (bounds the overhead at high bitrate) */
+    val maxFrameBytes: Int = DEFAULT_MAX_FRAME_BYTES
+) {
+    /** Order mirrors RedundancyMode in RtpPacketizer.h */
+    enum class Mode { OFF, RED, DUPLICATE }
+
+    companion object {
+        const val DEFAULT_DEPTH = 2
+        const val MAX_DEPTH = 3
+        const val DEFAULT_MAX_FRAME_BYTES = 80
+        const val MAX_FRAME_BYTES = 160
+
+        val OFF = PttRedundancy()
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Mesh Rider Wave - PTT Multicast <-> Unicast Relay
+ * One well-connected radio carries the talkgroup to unicast-only members
+ * (RtpRelay.h)
+ *
+ * A REFLECTOR is joined to the multicast group and re-forwards received
+ * packets, still encrypted, to its members and members' packets to the
+ * group. A MEMBER (AUTO fell back to unicast) sends each packet once, to
+ * its reflector, instead of to every unicast peer. While the reflector is
+ * not answering, a member falls back to its unicast peer list.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttRelay(
+    val role: Role = Role.OFF,
+    /** MEMBER: the reflector's IPv4 address */
+    val reflectorAddress: String? = null,
+    /** MEMBER: JOIN interval (also refreshes the reflector's table) */
+    val keepaliveMs: Int = DEFAULT_KEEPALIVE_MS,
+    /** Silence after which a member, or the reflector, is considered gone */
+    val memberTimeoutMs: Int = DEFAULT_MEMBER_TIMEOUT_MS
+) {
+    /** Order mirrors RelayRole in RtpRelay.h */
+    enum class Role { OFF, REFLECTOR, MEMBER }
+
+    /** Reflector view of one member */
+    data class Member(
+        val address: String,
+        val ssrc: Long,
+        /** Datagrams it sent to the reflector */
+        val packetsIn: Long,
+        /** Datagrams forwarded to it */
+        val packetsForwarded: Long,
+        val bytesForwarded: Long,
+        val sendFailures: Long,
+        /** Since it was last heard */
+        val ageMs: Long
+    )
+
+    companion object {
+        const val DEFAULT_KEEPALIVE_MS = 1000
+        const val DEFAULT_MEMBER_TIMEOUT_MS = 5000
+
+        const val LAYOUT_VERSION = 1L
+        const val VALUES_PER_MEMBER = 7
+        const val MAX_MEMBERS = 32
+        const val VALUE_COUNT = 2 + MAX_MEMBERS * VALUES_PER_MEMBER
+
+        val OFF = PttRelay()
+
+        /** Decode a filled member array; empty if native uses another layout */
+        fun membersFromArray(values: LongArray, count: Int): List<Member> {
+            if (count < 2 || values[0] != LAYOUT_VERSION) return emptyList()
+            val entries = minOf(values[1].toInt(), (count - 2) / VALUES_PER_MEMBER)
+            return List(entries) { n ->
+                val i = 2 + n * VALUES_PER_MEMBER
+                Member(
+                    address = ipv4ToString(values[i]),
+                    ssrc = values[i + 1],
+                    packetsIn = values[i + 2],
+                    packetsForwarded = values[i + 3],
+                    bytesForwarded = values[i + 4],
+                    sendFailures = values[i + 5],
+                    ageMs = values[i + 6]
+                )
+            }
+        }
+
+        // Native address is network order read as a little-endian int
+        private fun ipv4ToString(address: Long): String =
+            (0 until 4).joinToString(".") { ((address shr (8 * it)) and 0xFF).toString() }
+    }
+}
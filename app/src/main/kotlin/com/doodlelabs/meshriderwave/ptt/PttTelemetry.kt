@@ -0,0 +1,351 @@
+/*
+ * Mesh Rider Wave - PTT Native Pipeline Telemetry
+ * Decoded form of one nativeGetTelemetry() snapshot
+ *
+ * Field order mirrors flattenTelemetry() in JniBridge.cpp. All counters are
+ * cumulative since engine initialization; dashboards difference successive
+ * snapshots (timestampMicros is the native steady clock).
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttTelemetry(
+    val timestampMicros: Long,
+
+    // Capture callback
+    val captureCallbacks: Long,
+    val captureOverruns: Long,
+    val captureDroppedSamples: Long,
+    val captureRingHighWater: Long,
+    val captureMaxCallbackMicros: Long,
+
+    // Encoder
+    val framesEncoded: Long,
+    val bytesEncoded: Long,
+    val pcmBytesEncoded: Long,
+    val encodeErrors: Long,
+    val encoderSettingsChanges: Long,
+
+    // Network send
+    val packetsSent: Long,
+    val bytesSent: Long,
+    val sendFailures: Long,
+
+    // Network receive
+    val packetsReceived: Long,
+    val bytesReceived: Long,
+    val receiveBatches: Long,
+    val poolDrops: Long,
+
+    // Jitter buffers (all talkers)
+    val jitterPacketsReceived: Long,
+    val jitterPacketsLost: Long,
+    val jitterPacketsLate: Long,
+    val jitterPacketsDiscarded: Long,
+    val framesPlayed: Long,
+    val framesConcealed: Long,
+    val framesRecovered: Long,
+    val framesStretched: Long,
+    val jitterMs: Long,
+    val targetDelayMs: Long,
+    val currentDelayMs: Long,
+    val activeTalkers: Long,
+
+    // Decoder
+    val framesDecoded: Long,
+    val fecFrames: Long,
+    val plcFrames: Long,
+    val decodeErrors: Long,
+    val chunksMixed: Long,
+    val playbackRingHighWater: Long,
+
+    // Playback callback
+    val playbackCallbacks: Long,
+    val underrunEvents: Long,
+    val underrunSamples: Long,
+    // Underruns by length: <5, <10, <20, <40, <80, >=80 ms
+    val underrunHistogram: List<Long>,
+
+    // Transmit DTX gate: encoded frames kept off the air
+    val framesSuppressed: Long,
+    /** Wire bytes not sent (payload + IP/UDP/RTP headers) */
+    val bytesSuppressed: Long,
+    val suppressedMs: Long,
+    val talkspurts: Long,
+    val comfortNoiseFrames: Long,
+
+    // Key-up: startCapture() to first encoded frame (TTFF)
+    val keyUps: Long,
+    /** Key-ups that found the capture stream running (warm standby) */
+    val warmKeyUps: Long,
+    val lastTtffMicros: Long,
+    val totalTtffMicros: Long,
+    val maxTtffMicros: Long,
+
+    // RTCP (see PttAudioEngine.getLinkQuality)
+    val rtcpReportsSent: Long,
+    /** Per report, not per destination */
+    val rtcpBytesSent: Long,
+    val rtcpReportsReceived: Long,
+    val rtcpMalformed: Long,
+
+    // Audio DSP (see PttAudioEngine.setAudioDsp)
+    /** AGC linear gain x100 on the last captured frame (100 = unity) */
+    val captureGainPercent: Long,
+    /** Samples the capture limiter touched */
+    val captureLimitedSamples: Long,
+    val playbackGainPercent: Long,
+    val playbackLimitedSamples: Long,
+    /** Rate Oboe granted; 48000 means resampled to 16 kHz natively */
+    val captureDeviceRate: Long,
+    val playbackDeviceRate: Long,
+
+    // SRTP (see PttAudioEngine.setSrtpKey)
+    /** MLS epoch of the installed key (0 also when protection is off) */
+    val srtpKeyEpoch: Long,
+    val srtpPacketsProtected: Long,
+    val srtpPacketsVerified: Long,
+    /** RTP + RTCP no installed key authenticates (wrong group, tampered) */
+    val srtpAuthFailures: Long,
+    val srtpReplayDrops: Long,
+    /** Accepted with the previous epoch's keys just after a rekey */
+    val srtpPreviousEpochPackets: Long,
+
+    // Native floor control (see PttAudioEngine.setNativeFloorControl)
+    /** PttFloorEvent.State ordinal */
+    val floorState: Long,
+    /** Us while granted, 0 when free or off */
+    val floorHolderSsrc: Long,
+    val floorRequests: Long,
+    val floorGrants: Long,
+    val floorDenials: Long,
+    val floorRevocations: Long,
+    /** Press -> grant of the latest grant */
+    val floorLastGrantMicros: Long,
+
+    // Redundant transmission (see PttAudioEngine.setRedundancy)
+    /** RED: earlier frames repeated in our packets */
+    val redundantFramesSent: Long,
+    /** RED overhead: block headers + repeated frames */
+    val redundantBytesSent: Long,
+    val duplicatesSent: Long,
+    /** RED copies received that replaced a lost packet */
+    val redundantFramesUsed: Long,
+    /** RED copies received whose frame was already there or played */
+    val redundantFramesDiscarded: Long,
+
+    // Relay (see PttAudioEngine.setRelay)
+    /** PttRelay.Role ordinal */
+    val relayRole: Long,
+    /** Reflector: unicast-only members served */
+    val relayMembers: Long,
+    /** Reflector: datagrams forwarded, per destination */
+    val relayPacketsForwarded: Long,
+    val relayBytesForwarded: Long,
+    /** Reflector: RTP already forwarded via another path */
+    val relayDuplicatesDropped: Long,
+    /** Member: 1 while sending through a live reflector */
+    val relayViaReflector: Long,
+
+    // Power (see PttAudioEngine.setPowerConfig)
+    /** 0 = active, 1 = idle (playback parked, not transmitting) */
+    val powerMode: Long,
+    val powerActiveMs: Long,
+    val powerIdleMs: Long,
+    /** Pipeline thread wakeups (receive, decoder, encoder, audio callbacks) */
+    val powerActiveWakeups: Long,
+    val powerIdleWakeups: Long,
+    val powerIdleEntries: Long,
+
+    // Recording (see PttAudioEngine.startRecording)
+    /** Ogg/Opus files opened, one per talker burst */
+    val recordingBursts: Long,
+    val recordingPackets: Long,
+    /** Not stored: storage fell behind the block pool */
+    val recordingDroppedPackets: Long,
+    val recordingBytesWritten: Long,
+    /** write() calls; compare with recordingBytesWritten for the block size */
+    val recordingWrites: Long,
+
+    // Memory (see PttAudioEngine.setMemoryBudget)
+    val memoryBudgetBytes: Long,
+    /** Packet pool plus stream arena, reserved at initialize */
+    val memoryReservedBytes: Long,
+    /** Simultaneous talkers the budget holds */
+    val memoryStreamSlots: Long,
+    /** Free pool buffers: small (parked voice) and MTU (receive batches) */
+    val memorySmallAvailable: Long,
+    val memoryMtuAvailable: Long,
+    /** Buffer requests that found their size class empty */
+    val memoryPoolExhausted: Long,
+    val memoryPacketsCompacted: Long,
+    /** Native allocations after initialize; stays 0 */
+    val memoryLateAllocations: Long,
+
+    // Streams (see PttAudioEngine.setAudioRoute)
+    /** Streams reopened after the system closed them (device change, HAL restart) */
+    val streamRecoveries: Long,
+    /** Reopen retries exhausted; that session was stopped */
+    val streamRecoveryFailures: Long,
+    val streamRouteChanges: Long,
+    /** Loss (or route request) to the stream running again */
+    val streamLastRecoveryMicros: Long,
+    val streamMaxRecoveryMicros: Long,
+    val streamTotalRecoveryMicros: Long,
+    /** Bit 0 capture, bit 1 playback: lost and not reopened yet */
+    val streamsRecovering: Long,
+    /** AudioDeviceInfo ids the streams were opened on */
+    val captureDeviceId: Long,
+    val playbackDeviceId: Long
+) {
+    val meanTtffMicros: Long
+        get() = if (keyUps > 0) totalTtffMicros / keyUps else 0
+
+    /** Share of encoded audio that never went on the air */
+    val airtimeSavedFraction: Double
+        get() = if (framesEncoded > 0) framesSuppressed.toDouble() / framesEncoded else 0.0
+
+    /** Share of received RED copies that actually stood in for a lost packet */
+    val redundancyUsedFraction: Double
+        get() = (redundantFramesUsed + redundantFramesDiscarded).let { total ->
+            if (total > 0) redundantFramesUsed.toDouble() / total else 0.0
+        }
+
+    val activeWakeupsPerMinute: Double
+        get() = if (powerActiveMs > 0) powerActiveWakeups * 60000.0 / powerActiveMs else 0.0
+
+    val idleWakeupsPerMinute: Double
+        get() = if (powerIdleMs > 0) powerIdleWakeups * 60000.0 / powerIdleMs else 0.0
+
+    val meanStreamRecoveryMicros: Long
+        get() = (streamRecoveries + streamRouteChanges).let { count ->
+            if (count > 0) streamTotalRecoveryMicros / count else 0
+        }
+
+    companion object {
+        const val LAYOUT_VERSION = 1L
+        const val UNDERRUN_BUCKETS = 6
+        const val VALUE_COUNT = 40 + UNDERRUN_BUCKETS + 5 + 5 + 4 + 6 + 6 + 7 + 5 + 6 + 6 + 5 + 8 + 9
+
+        /** Decode a filled snapshot array; null if native uses another layout */
+        fun fromArray(values: LongArray, count: Int): PttTelemetry? {
+            if (count < VALUE_COUNT || values[0] != LAYOUT_VERSION) return null
+            var i = 1
+            fun next() = values[i++]
+            return PttTelemetry(
+                timestampMicros = next(),
+                captureCallbacks = next(),
+                captureOverruns = next(),
+                captureDroppedSamples = next(),
+                captureRingHighWater = next(),
+                captureMaxCallbackMicros = next(),
+                framesEncoded = next(),
+                bytesEncoded = next(),
+                pcmBytesEncoded = next(),
+                encodeErrors = next(),
+                encoderSettingsChanges = next(),
+                packetsSent = next(),
+                bytesSent = next(),
+                sendFailures = next(),
+                packetsReceived = next(),
+                bytesReceived = next(),
+                receiveBatches = next(),
+                poolDrops = next(),
+                jitterPacketsReceived = next(),
+                jitterPacketsLost = next(),
+                jitterPacketsLate = next(),
+                jitterPacketsDiscarded = next(),
+                framesPlayed = next(),
+                framesConcealed = next(),
+                framesRecovered = next(),
+                framesStretched = next(),
+                jitterMs = next(),
+                targetDelayMs = next(),
+                currentDelayMs = next(),
+                activeTalkers = next(),
+                framesDecoded = next(),
+                fecFrames = next(),
+                plcFrames = next(),
+                decodeErrors = next(),
+                chunksMixed = next(),
+                playbackRingHighWater = next(),
+                playbackCallbacks = next(),
+                underrunEvents = next(),
+                underrunSamples = next(),
+                underrunHistogram = List(UNDERRUN_BUCKETS) { next() },
+                framesSuppressed = next(),
+                bytesSuppressed = next(),
+                suppressedMs = next(),
+                talkspurts = next(),
+                comfortNoiseFrames = next(),
+                keyUps = next(),
+                warmKeyUps = next(),
+                lastTtffMicros = next(),
+                totalTtffMicros = next(),
+                maxTtffMicros = next(),
+                rtcpReportsSent = next(),
+                rtcpBytesSent = next(),
+                rtcpReportsReceived = next(),
+                rtcpMalformed = next(),
+                captureGainPercent = next(),
+                captureLimitedSamples = next(),
+                playbackGainPercent = next(),
+                playbackLimitedSamples = next(),
+                captureDeviceRate = next(),
+                playbackDeviceRate = next(),
+                srtpKeyEpoch = next(),
+                srtpPacketsProtected = next(),
+                srtpPacketsVerified = next(),
+                srtpAuthFailures = next(),
+                srtpReplayDrops = next(),
+                srtpPreviousEpochPackets = next(),
+                floorState = next(),
+                floorHolderSsrc = next(),
+                floorRequests = next(),
+                floorGrants = next(),
+                floorDenials = next(),
+                floorRevocations = next(),
+                floorLastGrantMicros = next(),
+                redundantFramesSent = next(),
+                redundantBytesSent = next(),
+                duplicatesSent = next(),
+                redundantFramesUsed = next(),
+                redundantFramesDiscarded = next(),
+                relayRole = next(),
+                relayMembers = next(),
+                relayPacketsForwarded = next(),
+                relayBytesForwarded = next(),
+                relayDuplicatesDropped = next(),
+                relayViaReflector = next(),
+                powerMode = next(),
+                powerActiveMs = next(),
+                powerIdleMs = next(),
+                powerActiveWakeups = next(),
+                powerIdleWakeups = next(),
+                powerIdleEntries = next(),
+                recordingBursts = next(),
+                recordingPackets = next(),
+                recordingDroppedPackets = next(),
+                recordingBytesWritten = next(),
+                recordingWrites = next(),
+                memoryBudgetBytes = next(),
+                memoryReservedBytes = next(),
+                memoryStreamSlots = next(),
+                memorySmallAvailable = next(),
+                memoryMtuAvailable = next(),
+                memoryPoolExhausted = next(),
+                memoryPacketsCompacted = next(),
+                memoryLateAllocations = next(),
+                streamRecoveries = next(),
+                streamRecoveryFailures = next(),
+                streamRouteChanges = next(),
+                streamLastRecoveryMicros = next(),
+                streamMaxRecoveryMicros = next(),
+                streamTotalRecoveryMicros = next(),
+                streamsRecovering = next(),
+                captureDeviceId = next(),
+                playbackDeviceId = next()
+            )
+        }
+    }
+}
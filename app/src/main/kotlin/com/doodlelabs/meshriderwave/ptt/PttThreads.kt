@@ -0,0 +1,107 @@
+/*
+ * Mesh Rider Wave - PTT Worker Thread Policies
+ * Priority and CPU affinity of the native pipeline threads (ThreadManager.h)
+ *
+ * The receive loop asks for SCHED_FIFO and falls back to nice -16 (audio
+ * priority) where the kernel refuses, which is the normal case for an app
+ * process; the encoder and decoder run at -16, recorder file I/O in the
+ * background. Pinning is off by default: [performanceCores] gives the
+ * cores above the little cluster for a policy's [PttThreads.cpus].
+ * Oboe's callback threads are AAudio's and not covered here.
+ *
+ * [Stats] report wakeup latency per thread: socket wait from the kernel
+ * receive stamp for NETWORK, poll-sleep overshoot for ENCODER and DECODER,
+ * against the 1 ms budget.
+ */
+
+package com.doodlelabs.meshriderwave.ptt
+
+data class PttThreads(
+    val sched: Sched = Sched.NICE,
+    /** -20 (highest) .. 19; used by NICE and when FIFO is refused */
+    val nice: Int = AUDIO_NICE,
+    /** SCHED_FIFO priority 1 .. 99 */
+    val fifoPriority: Int = DEFAULT_FIFO_PRIORITY,
+    /** CPUs to pin to; empty = any */
+    val cpus: Set<Int> = emptySet()
+) {
+    /** Order mirrors ThreadRole in ThreadManager.h */
+    enum class Role { NETWORK, ENCODER, DECODER, RECORDER }
+
+    /** Order mirrors ThreadSched in ThreadManager.h */
+    enum class Sched { DEFAULT, NICE, FIFO }
+
+    data class Stats(
+        val role: Role,
+        /** Linux thread id, 0 while the thread is not running */
+        val tid: Int,
+        /** What the kernel accepted */
+        val applied: Sched,
+        val nice: Int,
+        val fifoPriority: Int,
+        /** Pinned to; empty = not pinned */
+        val cpus: Set<Int>,
+        val wakeSamples: Long,
+        /** Wakeups later than WAKE_BUDGET_US */
+        val overBudget: Long,
+        val maxWakeMicros: Long,
+        val totalWakeMicros: Long,
+        /** Counts per WAKE_LIMITS_US bucket; the last is everything above */
+        val histogram: List<Long>
+    ) {
+        val meanWakeMicros: Double
+            get() = if (wakeSamples > 0) totalWakeMicros.toDouble() / wakeSamples else 0.0
+
+        val overBudgetPct: Double
+            get() = if (wakeSamples > 0) 100.0 * overBudget / wakeSamples else 0.0
+    }
+
+    val cpuMask: Long
+        get() = cpus.filter { it in 0 until 64 }.fold(0L) { mask, cpu -> mask or (1L shl cpu) }
+
+    companion object {
+        const val AUDIO_NICE = -16
+        const val URGENT_AUDIO_NICE = -19
+        const val BACKGROUND_NICE = 10
+        const val DEFAULT_FIFO_PRIORITY = 1
+
+        const val WAKE_BUDGET_US = 1000L
+        val WAKE_LIMITS_US = listOf(100L, 250L, 500L, 1000L, 2000L, 5000L)
+
+        const val LAYOUT_VERSION = 1L
+        val VALUES_PER_THREAD = 10 + WAKE_LIMITS_US.size + 1
+        val VALUE_COUNT = 2 + Role.values().size * VALUES_PER_THREAD
+
+        /** Native defaults per role */
+        fun defaultFor(role: Role): PttThreads = when (role) {
+            Role.NETWORK -> PttThreads(Sched.FIFO)
+            Role.RECORDER -> PttThreads(nice = BACKGROUND_NICE)
+            else -> PttThreads()
+        }
+
+        fun cpusFromMask(mask: Long): Set<Int> =
+            (0 until 64).filter { mask and (1L shl it) != 0L }.toSet()
+
+        /** Decode a filled stats array; empty if native uses another layout */
+        fun statsFromArray(values: LongArray, count: Int): List<Stats> {
+            if (count < 2 || values[0] != LAYOUT_VERSION) return emptyList()
+            val entries = minOf(values[1].toInt(), (count - 2) / VALUES_PER_THREAD)
+            return List(entries) { n ->
+                val i = 2 + n * VALUES_PER_THREAD
+                Stats(
+                    role = Role.values().getOrElse(values[i].toInt()) { Role.NETWORK },
+                    tid = values[i + 1].toInt(),
+                    applied = Sched.values().getOrElse(values[i + 2].toInt()) { Sched.DEFAULT },
+                    nice = values[i + 3].toInt(),
+                    fifoPriority = values[i + 4].toInt(),
+                    cpus = cpusFromMask(values[i + 5]),
+                    wakeSamples = values[i + 6],
+                    overBudget = values[i + 7],
+                    maxWakeMicros = values[i + 8],
+                    totalWakeMicros = values[i + 9],
+                    histogram = List(WAKE_LIMITS_US.size + 1) { b -> values[i + 10 + b] }
+                )
+            }
+        }
+    }
+}
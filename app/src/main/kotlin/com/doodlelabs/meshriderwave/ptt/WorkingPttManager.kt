@@ -9,6 +9,8 @@
  * - Network health monitoring
  * - Comprehensive error handling
  * - Audio focus management
+ * - Optional native floor control: arbitration on the RTP socket, capture
+ *   started by the grant itself
  */
 
 package com.doodlelabs.meshriderwave.ptt
@@ -46,6 +48,7 @@ class WorkingPttManager(private val context: Context) {
         // Timing
         private const val SAFETY_TIMEOUT_MS = 60000L  // 60s max transmission
         private const val STATS_UPDATE_INTERVAL_MS = 1000L
+        private const val FLOOR_EVENT_WAIT_MS = 500
     }
 
     // Components
@@ -72,6 +75,10 @@ class WorkingPttManager(private val context: Context) {
     private val scope = CoroutineScope(Dispatchers.Main + SupervisorJob())
     private var safetyTimeoutJob: Job? = null
     private var statsJob: Job? = null
+    private var floorEventsJob: Job? = null
+
+    // Arbitration in the native engine instead of FloorControlProtocol
+    private var nativeFloor = false
 
     // Own identity
     var ownId: String = "unknown"
@@ -85,8 +92,14 @@ class WorkingPttManager(private val context: Context) {
     /**
      * Initialize PTT system
      * @param enableUnicastFallback Allow unicast if multicast fails
+     * @param nativeFloorControl arbitrate in the native engine (every member
+     *        of the talkgroup must use the same mode)
      */
-    fun initialize(myId: String, enableUnicastFallback: Boolean = true): Boolean {
+    fun initialize(
+        myId: String,
+        enableUnicastFallback: Boolean = true,
+        nativeFloorControl: Boolean = false
+    ): Boolean {
         Log.i(TAG, "Initializing Production PTT Manager for $myId")
 
         ownId = myId
@@ -110,15 +123,21 @@ class WorkingPttManager(private val context: Context) {
         }
 
         // Initialize floor control
-        val floorInitialized = floorControl.initialize(myId)
-        if (!floorInitialized) {
-            Log.e(TAG, "Failed to initialize floor control")
-            audioEngine.cleanup()
-            return false
-        }
+        nativeFloor = nativeFloorControl
+        audioEngine.setNativeFloorControl(nativeFloor)
+        if (nativeFloor) {
+            startFloorEvents()
+        } else {
+            val floorInitialized = floorControl.initialize(myId)
+            if (!floorInitialized) {
+                Log.e(TAG, "Failed to initialize floor control")
+                audioEngine.cleanup()
+                return false
+            }
 
-        // Setup floor control callbacks
-        setupFloorCallbacks()
+            // Setup floor control callbacks
+            setupFloorCallbacks()
+        }
 
         // Monitor network health
         scope.launch {
@@ -164,6 +183,11 @@ class WorkingPttManager(private val context: Context) {
             return true
         }
 
+        // Native: the grant has already started capture
+        if (nativeFloor) {
+            return startNativeTransmission(emergency = false)
+        }
+
         // Request floor with reliability
         val granted = floorControl.requestFloor(priority = 0)
 
@@ -206,11 +230,16 @@ class WorkingPttManager(private val context: Context) {
         safetyTimeoutJob?.cancel()
         safetyTimeoutJob = null
 
-        // Stop audio capture
-        audioEngine.stopCapture()
+        if (nativeFloor) {
+            audioEngine.releaseFloor()
+            _currentSpeaker.value = null
+        } else {
+            // Stop audio capture
+            audioEngine.stopCapture()
 
-        // Release floor
-        floorControl.releaseFloor()
+            // Release floor
+            floorControl.releaseFloor()
+        }
 
         _isTransmitting.value = false
 
@@ -228,10 +257,29 @@ class WorkingPttManager(private val context: Context) {
             stopTransmission()
         }
         
+        if (nativeFloor) {
+            return startNativeTransmission(emergency = true)
+        }
+
         // Send emergency floor request
         return floorControl.sendEmergency()
     }
 
+    private suspend fun startNativeTransmission(emergency: Boolean): Boolean {
+        val state = withContext(Dispatchers.IO) {
+            audioEngine.requestFloor(emergency = emergency)
+        }
+        if (state != PttFloorEvent.State.GRANTED) {
+            Log.w(TAG, "Native floor request: $state")
+            return false
+        }
+        _isTransmitting.value = true
+        enableSpeaker()
+        startSafetyTimeout()
+        Log.i(TAG, "PTT transmission started (native floor${if (emergency) ", emergency" else ""})")
+        return true
+    }
+
     /**
      * Get current latency
      */
@@ -249,7 +297,7 @@ class WorkingPttManager(private val context: Context) {
             packetsReceived = audioEngine.packetsReceived.value,
             latencyMs = audioEngine.latency.value,
             isUsingMulticast = audioEngine.isUsingMulticast.value,
-            activePeers = floorControl.getActivePeers().size
+            activePeers = if (nativeFloor) audioEngine.getLinkQuality().size else floorControl.getActivePeers().size
         )
     }
 
@@ -296,10 +344,13 @@ class WorkingPttManager(private val context: Context) {
         
         statsJob?.cancel()
         safetyTimeoutJob?.cancel()
+        floorEventsJob?.cancel()
         
         audioEngine.stopPlayback()
         audioEngine.cleanup()
-        floorControl.stop()
+        if (!nativeFloor) {
+            floorControl.stop()
+        }
 
         scope.cancel()
     }
@@ -337,6 +388,52 @@ class WorkingPttManager(private val context: Context) {
         }
     }
 
+    /**
+     * Follow native floor decisions (speaker display, revoke)
+     */
+    private fun startFloorEvents() {
+        floorEventsJob?.cancel()
+        floorEventsJob = scope.launch {
+            while (isActive) {
+                val events = withContext(Dispatchers.IO) {
+                    audioEngine.awaitFloorEvents(FLOOR_EVENT_WAIT_MS)
+                }
+                events.forEach(::onFloorEvent)
+            }
+        }
+    }
+
+    private fun onFloorEvent(event: PttFloorEvent) {
+        val speakerId = "ssrc:${java.lang.Long.toHexString(event.ssrc)}"
+        when (event.type) {
+            PttFloorEvent.Type.GRANTED -> {
+                _currentSpeaker.value = ownId
+            }
+            PttFloorEvent.Type.DENIED -> {
+                Log.w(TAG, "Floor denied by $speakerId")
+                _currentSpeaker.value = speakerId
+            }
+            PttFloorEvent.Type.REVOKED -> {
+                // Capture already stopped natively
+                Log.w(TAG, "Floor revoked by $speakerId${if (event.emergency) " (emergency)" else ""}")
+                safetyTimeoutJob?.cancel()
+                safetyTimeoutJob = null
+                _isTransmitting.value = false
+                _currentSpeaker.value = speakerId
+            }
+            PttFloorEvent.Type.TAKEN -> {
+                _currentSpeaker.value = speakerId
+                _isReceiving.value = true
+            }
+            PttFloorEvent.Type.IDLE -> {
+                if (!_isTransmitting.value) {
+                    _currentSpeaker.value = null
+                }
+                _isReceiving.value = false
+            }
+        }
+    }
+
     /**
      * Start safety timeout
      */